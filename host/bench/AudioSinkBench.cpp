@@ -0,0 +1,84 @@
+/************************************************************************************
+
+Filename    :   AudioSinkBench.cpp
+Content     :	Cost of the audio sink's callback, and how it holds up to clock drift
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ManualAudioBackend.h"
+
+#include <benchmark/benchmark.h>
+
+static const int SAMPLE_RATE = 48000;
+static const int FRAMES_PER_BUFFER = 240;		// 5 ms
+static const int TARGET_MS = 30;
+
+// A frame written and a callback played, range(0) channels.  The callback
+// interpolates whatever the ratio, so it costs the same at any drift.
+// Time is per output frame.
+static void BM_SinkWriteRender( benchmark::State &state )
+{
+	const int channels = (int)state.range( 0 );
+	ManualAudioBackend *backend = ManualAudioBackend::Create();
+	nv_audio_sink *sink = nv_audio_sink_create( &backend->Base, SAMPLE_RATE, channels, FRAMES_PER_BUFFER, TARGET_MS );
+	nv_audio_sink_start( sink );
+
+	std::vector<short> in( FRAMES_PER_BUFFER * channels );
+	std::vector<short> out( FRAMES_PER_BUFFER * channels );
+	for ( size_t i = 0; i < in.size(); i++ )
+	{
+		in[i] = (short)( i * 37 );
+	}
+	for ( int written = 0; written <= SAMPLE_RATE * TARGET_MS / 1000; written += FRAMES_PER_BUFFER )
+	{
+		nv_audio_sink_write( sink, &in[0], FRAMES_PER_BUFFER );
+	}
+
+	for ( auto _ : state )
+	{
+		nv_audio_sink_write( sink, &in[0], FRAMES_PER_BUFFER );
+		backend->Render( &out[0], FRAMES_PER_BUFFER );
+		benchmark::DoNotOptimize( out[0] );
+	}
+
+	nv_audio_sink_stats stats;
+	nv_audio_sink_get_stats( sink, &stats );
+	state.counters["underruns"] = stats.underruns;
+	state.SetItemsProcessed( state.iterations() * FRAMES_PER_BUFFER );
+	nv_audio_sink_destroy( sink );
+}
+BENCHMARK( BM_SinkWriteRender )->ArgName( "channels" )->Arg( 2 )->Arg( 6 );
+
+// A minute of stereo with the device clock range(0) ppm fast.  The
+// counters are what matters: up to the sink's 5000 ppm of resampling
+// there should be no underruns, past it they come back.
+static void BM_SinkDrift( benchmark::State &state )
+{
+	const int ppm = (int)state.range( 0 );
+	nv_audio_sink_stats stats = {};
+	for ( auto _ : state )
+	{
+		ManualAudioBackend *backend = ManualAudioBackend::Create();
+		nv_audio_sink *sink = nv_audio_sink_create( &backend->Base, SAMPLE_RATE, 2, FRAMES_PER_BUFFER, TARGET_MS );
+		nv_audio_sink_start( sink );
+		RunClocks( sink, backend, SAMPLE_RATE, ppm, 60 );
+		nv_audio_sink_get_stats( sink, &stats );
+		nv_audio_sink_destroy( sink );
+	}
+	state.counters["underruns"] = stats.underruns;
+	state.counters["underrun_ms"] = stats.underrun_frames * 1000.0 / SAMPLE_RATE;
+	state.counters["overruns"] = stats.overruns;
+	state.counters["ratio_ppm"] = stats.ratio_ppm;
+	state.counters["level_ms"] = stats.level * 1000.0 / SAMPLE_RATE;
+}
+BENCHMARK( BM_SinkDrift )
+	->ArgName( "device_ppm" )
+	->Arg( -10000 )->Arg( -2000 )->Arg( 0 )->Arg( 2000 )->Arg( 4000 )->Arg( 10000 )
+	->Unit( benchmark::kMillisecond );
@@ -0,0 +1,243 @@
+/************************************************************************************
+
+Filename    :   CoreBench.cpp
+Content     :	Benchmarks of the per-frame cinemacore functions
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ScreenMath.h"
+#include "PoseHistory.h"
+#include "Lerp.h"
+#include "Catalog.h"
+#include "Settings.h"
+#include "MotionCalibration.h"
+#include "StreamQualityController.h"
+
+#include <benchmark/benchmark.h>
+
+#include <math.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace VRMatterStreamTheater;
+
+static void BM_Lerp( benchmark::State &state )
+{
+	Lerp lerp;
+	lerp.Set( 0.0, 0.0, 1.0, 100.0 );
+	double t = 0.0;
+	for ( auto _ : state )
+	{
+		benchmark::DoNotOptimize( lerp.Value( t ) );
+		t += 0.001;
+	}
+}
+BENCHMARK( BM_Lerp );
+
+static void BM_PoseHistoryLookup( benchmark::State &state )
+{
+	PoseHistory history;
+	for ( int i = 0; i < PoseHistory::MAX_POSES; i++ )
+	{
+		history.Record( i * 16, Matrix4f::Translation( (float)i, 0.0f, 0.0f ) );
+	}
+	long t = 0;
+	Matrix4f pose;
+	for ( auto _ : state )
+	{
+		history.GetPoseAtTime( t, pose );
+		benchmark::DoNotOptimize( pose );
+		t = ( t + 37 ) % ( PoseHistory::MAX_POSES * 16 );
+	}
+}
+BENCHMARK( BM_PoseHistoryLookup );
+
+// the carousel positions every panel each frame
+static void BM_InterpolatePanelPose( benchmark::State &state )
+{
+	Array<PanelPose> poses;
+	for ( int i = 0; i < 7; i++ )
+	{
+		poses.PushBack( PanelPose( Quatf( Vector3f( 0.0f, 1.0f, 0.0f ), i * 0.2f ), Vector3f( i - 3.0f, 0.0f, -3.0f ), Vector4f( 1.0f ) ) );
+	}
+	float t = 0.0f;
+	for ( auto _ : state )
+	{
+		benchmark::DoNotOptimize( InterpolatePanelPose( poses, t ) );
+		t = ( t < 6.0f ) ? t + 0.01f : 0.0f;
+	}
+}
+BENCHMARK( BM_InterpolatePanelPose );
+
+static void BM_GazeCoordinatesOnScreen( benchmark::State &state )
+{
+	const Matrix4f screen = FreeScreenMatrix( Matrix4f(), 3.0f, FreeScreenScale( 1.0f, 1920, 1080 ) );
+	float yaw = 0.0f;
+	for ( auto _ : state )
+	{
+		benchmark::DoNotOptimize( GazeCoordinatesOnScreen( Matrix4f::RotationY( yaw ), screen ) );
+		yaw = ( yaw < 0.5f ) ? yaw + 0.001f : -0.5f;
+	}
+}
+BENCHMARK( BM_GazeCoordinatesOnScreen );
+
+static void BM_BoundsScreenMatrix( benchmark::State &state )
+{
+	const Bounds3f bounds( Vector3f( -2.0f, 0.0f, -5.0f ), Vector3f( 2.0f, 2.0f, -5.0f ) );
+	float aspect = 1.0f;
+	for ( auto _ : state )
+	{
+		benchmark::DoNotOptimize( BoundsScreenMatrix( bounds, aspect ) );
+		aspect = ( aspect < 3.0f ) ? aspect + 0.01f : 1.0f;
+	}
+}
+BENCHMARK( BM_BoundsScreenMatrix );
+
+static void BM_FreeScreenMatrix( benchmark::State &state )
+{
+	const Matrix4f pose = Matrix4f::RotationY( 0.3f );
+	float scale = 0.0f;
+	for ( auto _ : state )
+	{
+		benchmark::DoNotOptimize( FreeScreenMatrix( pose, 3.0f, FreeScreenScale( scale, 1920, 1080 ) ) );
+		scale = ( scale < 2.0f ) ? scale + 0.01f : 0.0f;
+	}
+}
+BENCHMARK( BM_FreeScreenMatrix );
+
+// a whole app list arriving, range(0) apps
+static void BM_CatalogUpdateApps( benchmark::State &state )
+{
+	const int count = (int)state.range( 0 );
+	Array<String> names;
+	for ( int i = 0; i < count; i++ )
+	{
+		char name[32];
+		snprintf( name, sizeof( name ), "App %d", i );
+		names.PushBack( name );
+	}
+
+	Array<AppDef *> apps;
+	bool isNew;
+	for ( auto _ : state )
+	{
+		for ( int i = 0; i < count; i++ )
+		{
+			Catalog::UpdateApp( apps, names[i], "poster.png", i, ( i & 1 ) != 0, isNew );
+		}
+		benchmark::DoNotOptimize( Catalog::ListCategory( apps, CATEGORY_LIMELIGHT ) );
+	}
+	state.SetItemsProcessed( state.iterations() * count );
+
+	for ( int i = 0; i < apps.GetSizeI(); i++ )
+	{
+		delete apps[i];
+	}
+}
+BENCHMARK( BM_CatalogUpdateApps )->Arg( 16 )->Arg( 128 );
+
+// what changing one option costs, the file is rewritten each time
+static void BM_SettingsSaveChanged( benchmark::State &state )
+{
+	char path[] = "/tmp/streamtheater_bench_settingsXXXXXX";
+	const int fd = mkstemp( path );
+	close( fd );
+	unlink( path );
+
+	Settings settings( path );
+	float values[16];
+	for ( int i = 0; i < 16; i++ )
+	{
+		char name[32];
+		snprintf( name, sizeof( name ), "Value%d", i );
+		values[i] = (float)i;
+		settings.Define( name, &values[i] );
+	}
+	settings.SaveAll();
+	settings.Load();
+
+	for ( auto _ : state )
+	{
+		values[3] += 1.0f;
+		settings.SaveChanged();
+	}
+	unlink( path );
+}
+BENCHMARK( BM_SettingsSaveChanged );
+
+// What adaptive quality adds to a 60 fps frame: an arrival, a latency, a
+// render time and the window check, with an evaluation once a second
+static void BM_StreamQualityFrame( benchmark::State &state )
+{
+	StreamQualityStats stats;
+	StreamQualityController controller;
+	controller.Reset( StreamQualityParams( 1920, 1080, 60, 0 ), 0.0 );
+	stats.Reset( 0.0 );
+	double now = 0.0;
+	for ( auto _ : state )
+	{
+		now += 1.0 / 60;
+		stats.AddFrameArrival( now );
+		stats.AddLatency( 30.0f );
+		stats.AddRenderFrame( 1.0f / 60 );
+		StreamQualitySample sample;
+		if ( stats.GetSample( now, controller.GetParams().FPS, sample ) )
+		{
+			benchmark::DoNotOptimize( controller.Evaluate( sample, now ) );
+		}
+	}
+}
+BENCHMARK( BM_StreamQualityFrame );
+
+// One calibration frame: the full search over the thumbnail the view reads
+static void BM_EstimateShift( benchmark::State &state )
+{
+	const int width = 96;
+	const int height = 54;
+	std::vector<unsigned char> previous( width * height );
+	std::vector<unsigned char> current( width * height );
+	for ( int y = 0; y < height; y++ )
+	{
+		for ( int x = 0; x < width; x++ )
+		{
+			previous[y * width + x] = (unsigned char)( 128 + 60 * sinf( 0.35f * x + 0.2f * y ) + 40 * sinf( 0.27f * y - 0.15f * x ) );
+			current[y * width + x] = (unsigned char)( 128 + 60 * sinf( 0.35f * ( x - 2 ) + 0.2f * y ) + 40 * sinf( 0.27f * y - 0.15f * ( x - 2 ) ) );
+		}
+	}
+	float shiftX, shiftY;
+	for ( auto _ : state )
+	{
+		benchmark::DoNotOptimize( GlobalMotionEstimator::EstimateShift( &previous[0], &current[0], width, height,
+				(int)state.range( 0 ), shiftX, shiftY ) );
+	}
+}
+BENCHMARK( BM_EstimateShift )->Arg( 4 )->Arg( 8 );
+
+// The solve at the end of calibration: twelve seconds of frames against
+// 200 ms of candidate latencies a millisecond apart
+static void BM_CalibrationSolve( benchmark::State &state )
+{
+	MotionCalibration calibration;
+	for ( long t = 0; t <= 12000000; t += 2000 )
+	{
+		calibration.AddPose( t, 0.3f * sinf( t * 2e-6f ), 0.1f * sinf( t * 1.3e-6f ) );
+	}
+	for ( long t = 80000; t <= 12000000; t += 16667 )
+	{
+		const float yaw = 0.3f * sinf( ( t - 80000 ) * 2e-6f ) - 0.3f * sinf( ( t - 96667 ) * 2e-6f );
+		calibration.AddFrame( t, yaw, 0.0f );
+	}
+	MotionCalibrationResult result;
+	for ( auto _ : state )
+	{
+		benchmark::DoNotOptimize( calibration.Solve( 0, 200000, 1000, result ) );
+	}
+}
+BENCHMARK( BM_CalibrationSolve )->Unit( benchmark::kMillisecond );
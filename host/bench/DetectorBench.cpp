@@ -0,0 +1,107 @@
+/************************************************************************************
+
+Filename    :   DetectorBench.cpp
+Content     :	Cost of the detectors that look at the stream's samples
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "BorderDetector.h"
+#include "ContentChangeDetector.h"
+#include "StereoLayoutDetector.h"
+#include "SyntheticFrames.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace VRMatterStreamTheater;
+
+// The sampler reads the stream back at a quarter of its size in each
+// direction, so this is what one 1080p or 4K frame costs to look at
+static const int SAMPLE_DOWNSAMPLE = 4;
+
+static std::vector<UByte> Frame( const int width, const int height )
+{
+	std::vector<UByte> rgba( width * height * 4 );
+	for ( size_t i = 0; i < rgba.size(); i++ )
+	{
+		rgba[i] = (UByte)( i * 2654435761u >> 24 );
+	}
+	return rgba;
+}
+
+// range(0) x range(1) is the stream.  A static desktop, the common case:
+// every tile hashed, none dirty.
+static void BM_ContentChangeStatic( benchmark::State &state )
+{
+	const int width = (int)state.range( 0 ) / SAMPLE_DOWNSAMPLE;
+	const int height = (int)state.range( 1 ) / SAMPLE_DOWNSAMPLE;
+	const std::vector<UByte> frame = Frame( width, height );
+	ContentChangeDetector detector;
+	detector.Update( &frame[0], width, height );
+	for ( auto _ : state )
+	{
+		benchmark::DoNotOptimize( detector.Update( &frame[0], width, height ) );
+	}
+	state.SetBytesProcessed( state.iterations() * frame.size() );
+}
+BENCHMARK( BM_ContentChangeStatic )->ArgNames( { "w", "h" } )->Args( { 1920, 1080 } )->Args( { 3840, 2160 } );
+
+// A cursor moving about, one pixel a sample
+static void BM_ContentChangeCursor( benchmark::State &state )
+{
+	const int width = (int)state.range( 0 ) / SAMPLE_DOWNSAMPLE;
+	const int height = (int)state.range( 1 ) / SAMPLE_DOWNSAMPLE;
+	std::vector<UByte> frame = Frame( width, height );
+	ContentChangeDetector detector;
+	detector.Update( &frame[0], width, height );
+	int x = 0;
+	for ( auto _ : state )
+	{
+		x = ( x + 7 ) % ( width * height );
+		frame[x * 4] ^= 0x80;
+		benchmark::DoNotOptimize( detector.Update( &frame[0], width, height ) );
+	}
+	state.SetBytesProcessed( state.iterations() * frame.size() );
+}
+BENCHMARK( BM_ContentChangeCursor )->ArgNames( { "w", "h" } )->Args( { 1920, 1080 } )->Args( { 3840, 2160 } );
+
+// The stereo layout analysis of one sample, what a worker spends every
+// half second while the layout is detected
+static void BM_StereoAnalysis( benchmark::State &state )
+{
+	const int width = (int)state.range( 0 ) / SAMPLE_DOWNSAMPLE;
+	const int height = (int)state.range( 1 ) / SAMPLE_DOWNSAMPLE;
+	const std::vector<UByte> frame = SyntheticFrames::Render( SyntheticFrames::Scene( 1 ),
+			SyntheticFrames::LAYOUT_SIDE_BY_SIDE, width, height );
+	StereoSampleAnalysis analysis;
+	for ( auto _ : state )
+	{
+		benchmark::DoNotOptimize( analysis.Analyze( &frame[0], width, height ) );
+	}
+	state.SetBytesProcessed( state.iterations() * frame.size() );
+}
+BENCHMARK( BM_StereoAnalysis )->ArgNames( { "w", "h" } )->Args( { 1920, 1080 } )->Args( { 3840, 2160 } );
+
+// Finding the picture of a letterboxed sample, what a worker spends every
+// half second while the crop is detected
+static void BM_BorderFindPicture( benchmark::State &state )
+{
+	const int width = (int)state.range( 0 ) / SAMPLE_DOWNSAMPLE;
+	const int height = (int)state.range( 1 ) / SAMPLE_DOWNSAMPLE;
+	const std::vector<UByte> frame = SyntheticFrames::Render( SyntheticFrames::Scene( 1 ),
+			SyntheticFrames::LAYOUT_MONO, width, height, 0.0f, 0.0f, 0.13f );
+	for ( auto _ : state )
+	{
+		benchmark::DoNotOptimize( BorderDetector::FindPicture( &frame[0], width, height ) );
+	}
+	state.SetBytesProcessed( state.iterations() * frame.size() );
+}
+BENCHMARK( BM_BorderFindPicture )->ArgNames( { "w", "h" } )->Args( { 1920, 1080 } )->Args( { 3840, 2160 } );
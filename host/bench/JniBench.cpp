@@ -0,0 +1,98 @@
+/************************************************************************************
+
+Filename    :   JniBench.cpp
+Content     :	What the JNI glue adds on top of decoding an Opus frame
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "FakeJni.h"
+#include "nv_opus_dec.h"
+#include "SyntheticOpus.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace SyntheticOpus;
+
+// 5.1 at 10 ms, the largest buffers the glue is handed
+static const int FRAME_MS = 10;
+
+// A whole frame through the glue, jitter buffer included, against the
+// decoder on its own.  Time is per frame.  The stand-in VM's array
+// copies are plain memcpys, so nothing here says what they cost in ART.
+static void BM_JniDecode( benchmark::State &state )
+{
+	const std::vector<Packet> packets = Encode( SURROUND_51, FRAME_MS, 1000 / FRAME_MS, false );
+	if ( packets.empty() )
+	{
+		state.SkipWithError( "encoding failed" );
+		return;
+	}
+	std::vector<FakeArray> in;
+	for ( size_t i = 0; i < packets.size(); i++ )
+	{
+		in.push_back( FakeArray( packets[i].size() ) );
+		memcpy( in.back().Bytes.data(), &packets[i][0], packets[i].size() );
+	}
+
+	FakeJni jni;
+	JNIEnv *env = jni.GetEnv();
+	FakeArray mapping( SURROUND_51.Channels );
+	memcpy( mapping.Bytes.data(), SURROUND_51.Mapping, SURROUND_51.Channels );
+	Java_com_limelight_nvstream_av_audio_OpusDecoder_init( env, NULL, SAMPLE_RATE, SamplesPerChannel( FRAME_MS ),
+			SURROUND_51.Channels, SURROUND_51.Streams, SURROUND_51.CoupledStreams, mapping.Java() );
+	FakeArray out( SamplesPerChannel( FRAME_MS ) * SURROUND_51.Channels * 2 );
+
+	size_t next = 0;
+	for ( auto _ : state )
+	{
+		if ( Java_com_limelight_nvstream_av_audio_OpusDecoder_decode( env, NULL, in[next].Java(), 0,
+				(jint)in[next].Bytes.size(), out.Java() ) <= 0 )
+		{
+			state.SkipWithError( "decode failed" );
+			break;
+		}
+		if ( ++next == in.size() )
+		{
+			next = 0;
+		}
+	}
+	Java_com_limelight_nvstream_av_audio_OpusDecoder_destroy( env, NULL );
+
+	state.SetItemsProcessed( state.iterations() );
+}
+BENCHMARK( BM_JniDecode )->Unit( benchmark::kMicrosecond );
+
+static void BM_JniDecodeDirect( benchmark::State &state )
+{
+	const std::vector<Packet> packets = Encode( SURROUND_51, FRAME_MS, 1000 / FRAME_MS, false );
+	if ( packets.empty() )
+	{
+		state.SkipWithError( "encoding failed" );
+		return;
+	}
+	const int samples = SamplesPerChannel( FRAME_MS );
+	nv_opus_decoder *decoder = nv_opus_create( SAMPLE_RATE, SURROUND_51.Channels, SURROUND_51.Streams,
+			SURROUND_51.CoupledStreams, SURROUND_51.Mapping, samples, NULL );
+	std::vector<short> pcm( samples * SURROUND_51.Channels );
+
+	size_t next = 0;
+	for ( auto _ : state )
+	{
+		benchmark::DoNotOptimize( nv_opus_decode( decoder, &packets[next][0], (int)packets[next].size(), &pcm[0] ) );
+		if ( ++next == packets.size() )
+		{
+			next = 0;
+		}
+	}
+	nv_opus_destroy( decoder );
+
+	state.SetItemsProcessed( state.iterations() );
+}
+BENCHMARK( BM_JniDecodeDirect )->Unit( benchmark::kMicrosecond );
@@ -0,0 +1,95 @@
+/************************************************************************************
+
+Filename    :   OpusBench.cpp
+Content     :	Decode time per Opus frame, stereo and 5.1, one or more streams at once
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "nv_opus_dec.h"
+#include "SyntheticOpus.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace SyntheticOpus;
+
+// one second of audio, decoded round and round
+static const int SECONDS = 1;
+
+// range(0) is the channel count, range(1) the frame in ms.  Each thread
+// decodes its own stream with its own context, the way several sessions
+// would.  Time is per frame.
+static void BM_OpusDecode( benchmark::State &state )
+{
+	const Layout &layout = ( state.range( 0 ) == 6 ) ? SURROUND_51 : STEREO;
+	const int frameMs = (int)state.range( 1 );
+	const std::vector<Packet> packets = Encode( layout, frameMs, SECONDS * 1000 / frameMs, false );
+	if ( packets.empty() )
+	{
+		state.SkipWithError( "encoding failed" );
+		return;
+	}
+
+	const int samples = SamplesPerChannel( frameMs );
+	int error = 0;
+	nv_opus_decoder *decoder = nv_opus_create( SAMPLE_RATE, layout.Channels, layout.Streams, layout.CoupledStreams,
+			layout.Mapping, samples, &error );
+	std::vector<short> pcm( samples * layout.Channels );
+
+	size_t next = 0;
+	for ( auto _ : state )
+	{
+		const Packet &packet = packets[next];
+		const int decoded = nv_opus_decode( decoder, &packet[0], (int)packet.size(), &pcm[0] );
+		if ( decoded != samples )
+		{
+			state.SkipWithError( "decode failed" );
+			break;
+		}
+		if ( ++next == packets.size() )
+		{
+			next = 0;
+		}
+	}
+	nv_opus_destroy( decoder );
+
+	state.SetItemsProcessed( state.iterations() );
+}
+BENCHMARK( BM_OpusDecode )
+	->ArgNames( { "channels", "frame_ms" } )
+	->ArgsProduct( { { 2, 6 }, { 5, 10, 20 } } )
+	->Threads( 1 )->Threads( 4 )
+	->UseRealTime()
+	->Unit( benchmark::kMicrosecond );
+
+// concealing a lost frame instead
+static void BM_OpusConceal( benchmark::State &state )
+{
+	const Layout &layout = ( state.range( 0 ) == 6 ) ? SURROUND_51 : STEREO;
+	const int frameMs = (int)state.range( 1 );
+	const std::vector<Packet> packets = Encode( layout, frameMs, 20, false );
+	const int samples = SamplesPerChannel( frameMs );
+	nv_opus_decoder *decoder = nv_opus_create( SAMPLE_RATE, layout.Channels, layout.Streams, layout.CoupledStreams,
+			layout.Mapping, samples, NULL );
+	std::vector<short> pcm( samples * layout.Channels );
+	for ( size_t i = 0; i < packets.size(); i++ )
+	{
+		nv_opus_decode( decoder, &packets[i][0], (int)packets[i].size(), &pcm[0] );
+	}
+
+	for ( auto _ : state )
+	{
+		benchmark::DoNotOptimize( nv_opus_decode_plc( decoder, &pcm[0] ) );
+	}
+	nv_opus_destroy( decoder );
+}
+BENCHMARK( BM_OpusConceal )
+	->ArgNames( { "channels", "frame_ms" } )
+	->ArgsProduct( { { 2, 6 }, { 5, 10, 20 } } )
+	->Unit( benchmark::kMicrosecond );
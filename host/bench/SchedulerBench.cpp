@@ -0,0 +1,83 @@
+/************************************************************************************
+
+Filename    :   SchedulerBench.cpp
+Content     :	Throughput of the task scheduler
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "TaskScheduler.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+class EmptyTask : public BackgroundTask
+{
+public:
+					EmptyTask() : BackgroundTask( TASK_PRIORITY_NORMAL, NULL ) {}
+	virtual void	Run() {}
+};
+
+// some tens of microseconds of arithmetic, like a small decode
+class WorkTask : public BackgroundTask
+{
+public:
+					WorkTask() : BackgroundTask( TASK_PRIORITY_NORMAL, NULL ), Sum( 0 ) {}
+	virtual void	Run()
+	{
+		unsigned int s = 1;
+		for ( int i = 0; i < 20000; i++ )
+		{
+			s = s * 1103515245 + 12345;
+		}
+		benchmark::DoNotOptimize( Sum = s );
+	}
+	unsigned int	Sum;
+};
+
+static const int TASKS_PER_ITERATION = 1000;
+
+template< class TaskType >
+void SubmitAndFinish( benchmark::State & state )
+{
+	TaskScheduler tasks;
+	tasks.Start( (int)state.range( 0 ) );
+	for ( auto _ : state )
+	{
+		for ( int i = 0; i < TASKS_PER_ITERATION; i++ )
+		{
+			tasks.Submit( new TaskType() );
+		}
+		for ( int finished = 0; finished < TASKS_PER_ITERATION; )
+		{
+			finished += tasks.RunCompletions( 1.0 );
+		}
+	}
+	state.SetItemsProcessed( state.iterations() * TASKS_PER_ITERATION );
+	tasks.Shutdown();
+}
+
+}
+
+// range(0) workers.  What the queues, locks and wakeups cost per task.
+static void BM_TaskThroughputEmpty( benchmark::State &state )
+{
+	SubmitAndFinish<EmptyTask>( state );
+}
+BENCHMARK( BM_TaskThroughputEmpty )->Arg( 1 )->Arg( 2 )->Arg( 4 )->UseRealTime();
+
+// and how well real work spreads over the workers
+static void BM_TaskThroughputWork( benchmark::State &state )
+{
+	SubmitAndFinish<WorkTask>( state );
+}
+BENCHMARK( BM_TaskThroughputWork )->Arg( 1 )->Arg( 2 )->Arg( 4 )->UseRealTime()->Unit( benchmark::kMillisecond );
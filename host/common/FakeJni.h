@@ -0,0 +1,149 @@
+/************************************************************************************
+
+Filename    :   FakeJni.h
+Content     :	A stand-in VM that owns Java arrays, to call the JNI glue from a test
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( FakeJni_h )
+#define FakeJni_h
+
+#include <jni.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// what the audio glue exports, as the Java classes declare them
+extern "C" {
+jint Java_com_limelight_nvstream_av_audio_OpusDecoder_init( JNIEnv *env, jobject clazz, int sampleRate,
+		int samplesPerChannel, int channelCount, int streams, int coupledStreams, jbyteArray mapping );
+void Java_com_limelight_nvstream_av_audio_OpusDecoder_destroy( JNIEnv *env, jobject clazz );
+jint Java_com_limelight_nvstream_av_audio_OpusDecoder_decode( JNIEnv *env, jobject clazz,
+		jbyteArray indata, jint inoff, jint inlen, jbyteArray outpcmdata );
+jboolean Java_com_limelight_binding_audio_NativeAudioSink_start( JNIEnv *env, jclass clazz, jint sampleRate,
+		jint channelCount, jint framesPerBuffer, jint targetLatencyMs );
+void Java_com_limelight_binding_audio_NativeAudioSink_stop( JNIEnv *env, jclass clazz );
+void Java_com_limelight_binding_audio_NativeAudioSink_getStats( JNIEnv *env, jclass clazz, jintArray stats );
+}
+
+// A Java array.  The element access copies in and out like ART does for
+// arrays the collector may move, the critical access hands out the array
+// itself, and the region access copies a piece of it; all are counted.
+// None of it costs what it does in ART.
+struct FakeArray
+{
+	std::vector<jbyte>	Bytes;
+	std::vector<jint>	Ints;
+	int					Copies;		// element copies handed out
+	int					CopyBacks;	// element copies written back to the array
+	int					Pins;		// critical accesses
+	int					Reads;		// region reads
+	int					Writes;		// region writes
+
+						FakeArray( const size_t bytes = 0 ) : Bytes( bytes ), Copies( 0 ), CopyBacks( 0 ), Pins( 0 ), Reads( 0 ), Writes( 0 ) {}
+
+	jbyteArray			Java() { return (jbyteArray)this; }
+	static FakeArray *	From( jarray array ) { return (FakeArray *)array; }
+};
+
+class FakeJni
+{
+public:
+	FakeJni()
+	{
+		memset( &Functions, 0, sizeof( Functions ) );
+		Functions.GetArrayLength = GetArrayLength;
+		Functions.GetByteArrayElements = GetByteArrayElements;
+		Functions.ReleaseByteArrayElements = ReleaseByteArrayElements;
+		Functions.GetPrimitiveArrayCritical = GetPrimitiveArrayCritical;
+		Functions.ReleasePrimitiveArrayCritical = ReleasePrimitiveArrayCritical;
+		Functions.SetIntArrayRegion = SetIntArrayRegion;
+		Functions.GetByteArrayRegion = GetByteArrayRegion;
+		Functions.SetByteArrayRegion = SetByteArrayRegion;
+		Env = &Functions;
+	}
+
+	JNIEnv *			GetEnv() { return &Env; }
+
+private:
+	JNINativeInterface	Functions;
+	JNIEnv				Env;
+
+	static jsize GetArrayLength( JNIEnv *, jarray array )
+	{
+		FakeArray *a = FakeArray::From( array );
+		return (jsize)( a->Ints.empty() ? a->Bytes.size() : a->Ints.size() );
+	}
+
+	static jbyte * GetByteArrayElements( JNIEnv *, jbyteArray array, jboolean *isCopy )
+	{
+		FakeArray *a = FakeArray::From( array );
+		a->Copies++;
+		jbyte *copy = (jbyte *)malloc( a->Bytes.size() + 1 );
+		memcpy( copy, a->Bytes.data(), a->Bytes.size() );
+		if ( isCopy != NULL )
+		{
+			*isCopy = JNI_TRUE;
+		}
+		return copy;
+	}
+
+	static void ReleaseByteArrayElements( JNIEnv *, jbyteArray array, jbyte *elems, jint mode )
+	{
+		FakeArray *a = FakeArray::From( array );
+		if ( mode != JNI_ABORT )
+		{
+			a->CopyBacks++;
+			memcpy( a->Bytes.data(), elems, a->Bytes.size() );
+		}
+		if ( mode != JNI_COMMIT )
+		{
+			free( elems );
+		}
+	}
+
+	static void * GetPrimitiveArrayCritical( JNIEnv *, jarray array, jboolean *isCopy )
+	{
+		FakeArray *a = FakeArray::From( array );
+		a->Pins++;
+		if ( isCopy != NULL )
+		{
+			*isCopy = JNI_FALSE;
+		}
+		return a->Bytes.data();
+	}
+
+	static void ReleasePrimitiveArrayCritical( JNIEnv *, jarray, void *, jint )
+	{
+	}
+
+	static void SetIntArrayRegion( JNIEnv *, jintArray array, jsize start, jsize len, const jint *buf )
+	{
+		FakeArray *a = FakeArray::From( array );
+		memcpy( &a->Ints[start], buf, len * sizeof( jint ) );
+	}
+
+	static void GetByteArrayRegion( JNIEnv *, jbyteArray array, jsize start, jsize len, jbyte *buf )
+	{
+		FakeArray *a = FakeArray::From( array );
+		a->Reads++;
+		memcpy( buf, &a->Bytes[start], len );
+	}
+
+	static void SetByteArrayRegion( JNIEnv *, jbyteArray array, jsize start, jsize len, const jbyte *buf )
+	{
+		FakeArray *a = FakeArray::From( array );
+		a->Writes++;
+		memcpy( &a->Bytes[start], buf, len );
+	}
+};
+
+#endif // FakeJni_h
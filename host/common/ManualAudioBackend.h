@@ -0,0 +1,96 @@
+/************************************************************************************
+
+Filename    :   ManualAudioBackend.h
+Content     :	An audio backend whose callbacks the caller makes itself
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( ManualAudioBackend_h )
+#define ManualAudioBackend_h
+
+#include "nv_audio_sink.h"
+
+#include <stdlib.h>
+#include <vector>
+
+// No thread and no clock: Render plays one callback of the sink on the
+// calling thread, so a test decides exactly how the device and the
+// decoder interleave.
+struct ManualAudioBackend
+{
+	nv_audio_backend	Base;		// first, the sink only sees this
+	nv_audio_render_fn	RenderFn;
+	void *				Context;
+	int					Channels;
+	int					FramesPerBuffer;
+	bool				Started;
+
+	static ManualAudioBackend * Create()
+	{
+		ManualAudioBackend *backend = (ManualAudioBackend *)calloc( 1, sizeof( ManualAudioBackend ) );
+		backend->Base.name = "manual";
+		backend->Base.start = Start;
+		backend->Base.stop = Stop;
+		backend->Base.destroy = Destroy;
+		return backend;
+	}
+
+	void Render( short *pcm, const int frames ) { RenderFn( Context, pcm, frames ); }
+
+private:
+	static int Start( nv_audio_backend *base, int, int channels, int framesPerBuffer, nv_audio_render_fn render, void *context )
+	{
+		ManualAudioBackend *backend = (ManualAudioBackend *)base;
+		backend->RenderFn = render;
+		backend->Context = context;
+		backend->Channels = channels;
+		backend->FramesPerBuffer = framesPerBuffer;
+		backend->Started = true;
+		return 0;
+	}
+
+	static void Stop( nv_audio_backend *base )
+	{
+		( (ManualAudioBackend *)base )->Started = false;
+	}
+
+	static void Destroy( nv_audio_backend *base )
+	{
+		free( base );
+	}
+};
+
+// Runs a sink for seconds of decoded audio, a frame of framesPerBuffer
+// written at a time, with the device clock ppm millionths off the
+// decoder's.  What is written is a ramp, so that resampling has
+// something to interpolate.
+inline void RunClocks( nv_audio_sink *sink, ManualAudioBackend *backend, const int sampleRate, const int ppm,
+		const int seconds )
+{
+	const int frames = backend->FramesPerBuffer;
+	std::vector<short> in( frames * backend->Channels );
+	std::vector<short> out( frames * backend->Channels );
+	for ( size_t i = 0; i < in.size(); i++ )
+	{
+		in[i] = (short)( i * 37 );
+	}
+
+	double owed = 0.0;
+	for ( long long written = 0; written < (long long)seconds * sampleRate; written += frames )
+	{
+		nv_audio_sink_write( sink, &in[0], frames );
+		for ( owed += frames * ( 1.0 + ppm * 1e-6 ); owed >= frames; owed -= frames )
+		{
+			backend->Render( &out[0], frames );
+		}
+	}
+}
+
+#endif // ManualAudioBackend_h
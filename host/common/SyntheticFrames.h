@@ -0,0 +1,155 @@
+/************************************************************************************
+
+Filename    :   SyntheticFrames.h
+Content     :	Made up stream samples in the layouts the detectors look for
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( SyntheticFrames_h )
+#define SyntheticFrames_h
+
+#include <math.h>
+#include <vector>
+
+namespace SyntheticFrames {
+
+// A scene is value noise over a few octaves with some hard edged boxes
+// on top, different for every seed, and defined everywhere so a view of
+// it can be taken from any position.
+class Scene
+{
+public:
+	explicit Scene( const unsigned int seed ) : Seed( seed )
+	{
+		unsigned int s = seed * 2654435761u + 1;
+		for ( int i = 0; i < NUM_BOXES; i++ )
+		{
+			Boxes[i][0] = Random( s ) * 1.2f - 0.1f;
+			Boxes[i][1] = Random( s ) * 1.2f - 0.1f;
+			Boxes[i][2] = 0.05f + Random( s ) * 0.25f;
+			Boxes[i][3] = 0.05f + Random( s ) * 0.25f;
+			Boxes[i][4] = Random( s ) * 255.0f;
+		}
+	}
+
+	// u, v are 0-1 across the scene, beyond that it carries on
+	void Color( const float u, const float v, unsigned char * rgba ) const
+	{
+		float value = 0.0f;
+		float weight = 90.0f;
+		for ( int octave = 0; octave < 4; octave++ )
+		{
+			const float cells = (float)( 4 << octave );
+			value += ( Noise( u * cells, v * cells, octave ) - 0.5f ) * weight;
+			weight *= 0.55f;
+		}
+		value += 110.0f;
+		for ( int i = 0; i < NUM_BOXES; i++ )
+		{
+			if ( u >= Boxes[i][0] && u < Boxes[i][0] + Boxes[i][2] && v >= Boxes[i][1] && v < Boxes[i][1] + Boxes[i][3] )
+			{
+				value = value * 0.3f + Boxes[i][4] * 0.7f;
+			}
+		}
+		const float r = value * ( 0.8f + 0.4f * u );
+		const float b = value * ( 1.2f - 0.4f * v );
+		rgba[0] = Clamp( r );
+		rgba[1] = Clamp( value );
+		rgba[2] = Clamp( b );
+		rgba[3] = 255;
+	}
+
+private:
+	static const int	NUM_BOXES = 12;
+	unsigned int		Seed;
+	float				Boxes[NUM_BOXES][5];
+
+	static float Random( unsigned int & s )
+	{
+		s = s * 1103515245 + 12345;
+		return ( ( s >> 8 ) & 0xffff ) / 65536.0f;
+	}
+
+	static unsigned char Clamp( const float v )
+	{
+		return (unsigned char)( v < 0.0f ? 0.0f : ( v > 255.0f ? 255.0f : v ) );
+	}
+
+	float Lattice( const int x, const int y, const int octave ) const
+	{
+		unsigned int h = (unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u ^ ( Seed + octave * 83492791u );
+		h ^= h >> 13;
+		h *= 0x5bd1e995;
+		h ^= h >> 15;
+		return ( h & 0xffff ) / 65536.0f;
+	}
+
+	float Noise( const float x, const float y, const int octave ) const
+	{
+		const float fx = floorf( x );
+		const float fy = floorf( y );
+		const int ix = (int)fx;
+		const int iy = (int)fy;
+		const float tx = x - fx;
+		const float ty = y - fy;
+		const float sx = tx * tx * ( 3.0f - 2.0f * tx );
+		const float sy = ty * ty * ( 3.0f - 2.0f * ty );
+		const float top = Lattice( ix, iy, octave ) + ( Lattice( ix + 1, iy, octave ) - Lattice( ix, iy, octave ) ) * sx;
+		const float bottom = Lattice( ix, iy + 1, octave ) + ( Lattice( ix + 1, iy + 1, octave ) - Lattice( ix, iy + 1, octave ) ) * sx;
+		return top + ( bottom - top ) * sy;
+	}
+};
+
+enum Layout
+{
+	LAYOUT_MONO,
+	LAYOUT_SIDE_BY_SIDE,
+	LAYOUT_TOP_BOTTOM
+};
+
+// A width x height RGBA sample of the scene in the layout.  Each eye of
+// a 3D layout sees the scene from disparity of its width further left or
+// right, time pans the whole scene.  Each view has bars of black at its
+// top and bottom, barHeight of its height each, as a wide movie has.
+inline std::vector<unsigned char> Render( const Scene & scene, const Layout layout, const int width, const int height,
+		const float disparity = 0.01f, const float time = 0.0f, const float barHeight = 0.0f )
+{
+	std::vector<unsigned char> rgba( width * height * 4, 0 );
+	for ( int y = 0; y < height; y++ )
+	{
+		for ( int x = 0; x < width; x++ )
+		{
+			float u = ( x + 0.5f ) / width;
+			float v = ( y + 0.5f ) / height;
+			float eye = 0.0f;
+			if ( layout == LAYOUT_SIDE_BY_SIDE )
+			{
+				eye = u < 0.5f ? -1.0f : 1.0f;
+				u = u < 0.5f ? u * 2.0f : u * 2.0f - 1.0f;
+			}
+			else if ( layout == LAYOUT_TOP_BOTTOM )
+			{
+				eye = v < 0.5f ? -1.0f : 1.0f;
+				v = v < 0.5f ? v * 2.0f : v * 2.0f - 1.0f;
+			}
+			if ( v < barHeight || v >= 1.0f - barHeight )
+			{
+				continue;
+			}
+			v = ( v - barHeight ) / ( 1.0f - barHeight * 2.0f );
+			scene.Color( u + eye * disparity * 0.5f + time, v, &rgba[( y * width + x ) * 4] );
+		}
+	}
+	return rgba;
+}
+
+} // namespace SyntheticFrames
+
+#endif // SyntheticFrames_h
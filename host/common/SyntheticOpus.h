@@ -0,0 +1,101 @@
+/************************************************************************************
+
+Filename    :   SyntheticOpus.h
+Content     :	Opus packets of generated audio, for the decoder tests and benchmarks
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( SyntheticOpus_h )
+#define SyntheticOpus_h
+
+#include <opus_multistream.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace SyntheticOpus {
+
+static const int SAMPLE_RATE = 48000;
+
+// the layouts GameStream sends
+struct Layout
+{
+	int				Channels;
+	int				Streams;
+	int				CoupledStreams;
+	unsigned char	Mapping[8];
+};
+
+static const Layout STEREO = { 2, 1, 1, { 0, 1 } };
+static const Layout SURROUND_51 = { 6, 4, 2, { 0, 4, 1, 5, 2, 3 } };
+
+typedef std::vector<unsigned char> Packet;
+
+inline int SamplesPerChannel( const int frameMs ) { return SAMPLE_RATE * frameMs / 1000; }
+
+// A tone per channel over a little noise, encoded into count packets of
+// frameMs.  With fec the encoder is pushed into SILK with in-band FEC on;
+// it still decides per packet whether the one before is worth a redundant
+// copy, and does so for a steady tone only now and then.
+inline std::vector<Packet> Encode( const Layout &layout, const int frameMs, const int count, const bool fec )
+{
+	int error = 0;
+	OpusMSEncoder *encoder = opus_multistream_encoder_create( SAMPLE_RATE, layout.Channels, layout.Streams,
+			layout.CoupledStreams, layout.Mapping, fec ? OPUS_APPLICATION_VOIP : OPUS_APPLICATION_AUDIO, &error );
+	std::vector<Packet> packets;
+	if ( encoder == NULL )
+	{
+		return packets;
+	}
+	if ( fec )
+	{
+		opus_multistream_encoder_ctl( encoder, OPUS_SET_BITRATE( 16000 * layout.Streams ) );
+		opus_multistream_encoder_ctl( encoder, OPUS_SET_SIGNAL( OPUS_SIGNAL_VOICE ) );
+		opus_multistream_encoder_ctl( encoder, OPUS_SET_INBAND_FEC( 1 ) );
+		opus_multistream_encoder_ctl( encoder, OPUS_SET_PACKET_LOSS_PERC( 20 ) );
+	}
+	else
+	{
+		opus_multistream_encoder_ctl( encoder, OPUS_SET_BITRATE( 64000 * layout.Streams ) );
+	}
+
+	const int samples = SamplesPerChannel( frameMs );
+	std::vector<short> pcm( samples * layout.Channels );
+	unsigned char data[4000];
+	unsigned int seed = 1;
+	long t = 0;
+	for ( int i = 0; i < count; i++ )
+	{
+		for ( int s = 0; s < samples; s++, t++ )
+		{
+			for ( int c = 0; c < layout.Channels; c++ )
+			{
+				seed = seed * 1103515245u + 12345u;
+				const float noise = (float)( ( seed >> 16 ) & 0x7FFF ) / 32768.0f - 0.5f;
+				const float tone = sinf( 2.0f * (float)M_PI * ( 220.0f * ( c + 1 ) ) * t / SAMPLE_RATE );
+				pcm[s * layout.Channels + c] = (short)( 8000.0f * tone + 1000.0f * noise );
+			}
+		}
+		const int length = opus_multistream_encode( encoder, &pcm[0], samples, data, sizeof( data ) );
+		if ( length < 0 )
+		{
+			packets.clear();
+			break;
+		}
+		packets.push_back( Packet( data, data + length ) );
+	}
+	opus_multistream_encoder_destroy( encoder );
+	return packets;
+}
+
+} // namespace SyntheticOpus
+
+#endif // SyntheticOpus_h
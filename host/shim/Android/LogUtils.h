@@ -0,0 +1,30 @@
+/************************************************************************************
+
+Filename    :   LogUtils.h
+Content     :	Host stand-in for the VrAppFramework's logging macros
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( LogUtils_h )
+#define LogUtils_h
+
+#include <android/log.h>
+#include <stdlib.h>
+
+#if !defined( LOG_TAG )
+#define LOG_TAG "OVR"
+#endif
+
+#define LOG( ... )					__android_log_print( ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__ )
+#define WARN( ... )					__android_log_print( ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__ )
+#define FAIL( ... )					{ __android_log_print( ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__ ); abort(); }
+#define LOG_WITH_TAG( tag, ... )	__android_log_print( ANDROID_LOG_DEBUG, tag, __VA_ARGS__ )
+
+#endif // LogUtils_h
@@ -0,0 +1,56 @@
+/************************************************************************************
+
+Filename    :   OVR_Alg.h
+Content     :	Host stand-in for the OVR kernel's small algorithms
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( OVR_Alg_h )
+#define OVR_Alg_h
+
+#include "Kernel/OVR_Types.h"
+
+#include <algorithm>
+
+namespace OVR { namespace Alg {
+
+template< typename T > inline const T Min( const T a, const T b ) { return ( a < b ) ? a : b; }
+template< typename T > inline const T Max( const T a, const T b ) { return ( b < a ) ? a : b; }
+template< typename T > inline const T Clamp( const T v, const T minVal, const T maxVal ) { return Max( minVal, Min( v, maxVal ) ); }
+template< typename T > inline const T Abs( const T v ) { return ( v >= 0 ) ? v : -v; }
+template< typename T > inline void Swap( T & a, T & b ) { T temp( a ); a = b; b = temp; }
+
+// The SDK sorts any container with an operator[] and GetSize
+template< class Array, class Less >
+void QuickSort( Array & arr, Less less )
+{
+	if ( arr.GetSize() > 1 )
+	{
+		std::sort( &arr[0], &arr[0] + arr.GetSize(), less );
+	}
+}
+
+template< class T > struct OperatorLess
+{
+	static bool Compare( const T & a, const T & b ) { return a < b; }
+};
+
+template< class Array >
+void QuickSort( Array & arr )
+{
+	if ( arr.GetSize() > 1 )
+	{
+		std::sort( &arr[0], &arr[0] + arr.GetSize() );
+	}
+}
+
+} } // namespace OVR::Alg
+
+#endif // OVR_Alg_h
@@ -0,0 +1,109 @@
+/************************************************************************************
+
+Filename    :   OVR_Array.h
+Content     :	Host stand-in for the OVR kernel's resizable array
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( OVR_Array_h )
+#define OVR_Array_h
+
+#include "Kernel/OVR_Types.h"
+
+#include <vector>
+
+namespace OVR {
+
+// The SDK's Array over a std::vector.  Indexing is checked with OVR_ASSERT
+// like the SDK's debug builds.
+template< class T >
+class Array
+{
+public:
+	typedef T	ValueType;
+
+				Array() {}
+	explicit	Array( const int size ) : Data( size ) {}
+
+	UPInt		GetSize() const { return Data.size(); }
+	int			GetSizeI() const { return (int)Data.size(); }
+	UPInt		GetCapacity() const { return Data.capacity(); }
+	void		Reserve( const UPInt capacity ) { Data.reserve( capacity ); }
+	void		Resize( const UPInt size ) { Data.resize( size ); }
+	void		Clear() { Data.clear(); }
+	void		ClearAndRelease() { std::vector<T>().swap( Data ); }
+
+	T &			operator[]( const UPInt index ) { OVR_ASSERT( index < Data.size() ); return Data[index]; }
+	const T &	operator[]( const UPInt index ) const { OVR_ASSERT( index < Data.size() ); return Data[index]; }
+	T &			At( const UPInt index ) { return (*this)[index]; }
+	const T &	At( const UPInt index ) const { return (*this)[index]; }
+	T			ValueAt( const UPInt index ) const { return (*this)[index]; }
+
+	T *			DataPtr() { return Data.empty() ? NULL : &Data[0]; }
+	const T *	DataPtr() const { return Data.empty() ? NULL : &Data[0]; }
+	T *			GetDataPtr() { return DataPtr(); }
+	const T *	GetDataPtr() const { return DataPtr(); }
+
+	T &			Front() { return (*this)[0]; }
+	const T &	Front() const { return (*this)[0]; }
+	T &			Back() { return (*this)[Data.size() - 1]; }
+	const T &	Back() const { return (*this)[Data.size() - 1]; }
+
+	void		PushBack( const T & value ) { Data.push_back( value ); }
+	T *			PushDefault() { Data.push_back( T() ); return &Data.back(); }
+	T			Pop() { OVR_ASSERT( !Data.empty() ); T value = Data.back(); Data.pop_back(); return value; }
+
+	void		Append( const Array<T> & other ) { Data.insert( Data.end(), other.Data.begin(), other.Data.end() ); }
+	void		Append( const T * other, const UPInt count ) { Data.insert( Data.end(), other, other + count ); }
+
+	void		InsertAt( const UPInt index, const T & value = T() )
+	{
+		OVR_ASSERT( index <= Data.size() );
+		Data.insert( Data.begin() + index, value );
+	}
+
+	void		RemoveAt( const UPInt index )
+	{
+		OVR_ASSERT( index < Data.size() );
+		Data.erase( Data.begin() + index );
+	}
+
+	void		RemoveMultipleAt( const UPInt index, const UPInt count )
+	{
+		OVR_ASSERT( index + count <= Data.size() );
+		Data.erase( Data.begin() + index, Data.begin() + index + count );
+	}
+
+	// moves the last element into the hole, the order isn't kept
+	void		RemoveAtUnordered( const UPInt index )
+	{
+		OVR_ASSERT( index < Data.size() );
+		if ( index + 1 < Data.size() )
+		{
+			Data[index] = Data.back();
+		}
+		Data.pop_back();
+	}
+
+private:
+	std::vector<T>	Data;
+};
+
+template< class T >
+class ArrayPOD : public Array<T>
+{
+public:
+				ArrayPOD() {}
+	explicit	ArrayPOD( const int size ) : Array<T>( size ) {}
+};
+
+} // namespace OVR
+
+#endif // OVR_Array_h
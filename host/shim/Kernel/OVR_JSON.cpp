@@ -0,0 +1,414 @@
+/************************************************************************************
+
+Filename    :   OVR_JSON.cpp
+Content     :	Host stand-in for the OVR kernel's reference counted JSON tree
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "Kernel/OVR_JSON.h"
+
+#include <ctype.h>
+#include <math.h>
+
+namespace OVR {
+
+JSON::~JSON()
+{
+	for ( size_t i = 0; i < Children.size(); i++ )
+	{
+		Children[i]->Parent = NULL;
+		Children[i]->Release();
+	}
+}
+
+JSON * JSON::GetItemByIndex( const unsigned index )
+{
+	return ( index < Children.size() ) ? Children[index] : NULL;
+}
+
+JSON * JSON::GetItemByName( const char * name )
+{
+	for ( size_t i = 0; i < Children.size(); i++ )
+	{
+		if ( Children[i]->Name == name )
+		{
+			return Children[i];
+		}
+	}
+	return NULL;
+}
+
+void JSON::AddItem( const char * name, JSON * item )
+{
+	if ( item == NULL )
+	{
+		return;
+	}
+	if ( name != NULL )
+	{
+		item->Name = name;
+	}
+	item->Parent = this;
+	Children.push_back( item );
+}
+
+void JSON::RemoveNode()
+{
+	if ( Parent == NULL )
+	{
+		return;
+	}
+	for ( size_t i = 0; i < Parent->Children.size(); i++ )
+	{
+		if ( Parent->Children[i] == this )
+		{
+			Parent->Children.erase( Parent->Children.begin() + i );
+			break;
+		}
+	}
+	Parent = NULL;
+}
+
+void JSON::ReplaceNodeWith( JSON * node )
+{
+	if ( Parent == NULL || node == NULL )
+	{
+		return;
+	}
+	for ( size_t i = 0; i < Parent->Children.size(); i++ )
+	{
+		if ( Parent->Children[i] == this )
+		{
+			Parent->Children[i] = node;
+			break;
+		}
+	}
+	node->Parent = Parent;
+	Parent = NULL;
+}
+
+//==============================
+// Printing
+
+static void PrintString( String & out, const String & s )
+{
+	out += '"';
+	for ( const char * p = s.ToCStr(); *p != '\0'; p++ )
+	{
+		switch ( *p )
+		{
+			case '"':	out += "\\\""; break;
+			case '\\':	out += "\\\\"; break;
+			case '\n':	out += "\\n"; break;
+			case '\r':	out += "\\r"; break;
+			case '\t':	out += "\\t"; break;
+			default:
+				if ( (unsigned char)*p < 0x20 )
+				{
+					char esc[8];
+					snprintf( esc, sizeof( esc ), "\\u%04x", (unsigned char)*p );
+					out += esc;
+				}
+				else
+				{
+					out += *p;
+				}
+				break;
+		}
+	}
+	out += '"';
+}
+
+static void PrintIndent( String & out, const int depth )
+{
+	for ( int i = 0; i < depth; i++ )
+	{
+		out += '\t';
+	}
+}
+
+void JSON::PrintTo( String & out, int depth, bool fmt ) const
+{
+	switch ( Type )
+	{
+		case JSON_Null:
+			out += "null";
+			break;
+		case JSON_Bool:
+			out += ( dValue != 0.0 ) ? "true" : "false";
+			break;
+		case JSON_Number:
+		{
+			char num[64];
+			if ( floor( dValue ) == dValue && fabs( dValue ) < 1.0e15 )
+			{
+				snprintf( num, sizeof( num ), "%.0f", dValue );
+			}
+			else
+			{
+				snprintf( num, sizeof( num ), "%.17g", dValue );
+			}
+			out += num;
+			break;
+		}
+		case JSON_String:
+			PrintString( out, Value );
+			break;
+		case JSON_Array:
+		case JSON_Object:
+		{
+			const bool object = ( Type == JSON_Object );
+			out += object ? '{' : '[';
+			for ( size_t i = 0; i < Children.size(); i++ )
+			{
+				if ( fmt )
+				{
+					out += '\n';
+					PrintIndent( out, depth + 1 );
+				}
+				if ( object )
+				{
+					PrintString( out, Children[i]->Name );
+					out += fmt ? ": " : ":";
+				}
+				Children[i]->PrintTo( out, depth + 1, fmt );
+				if ( i + 1 < Children.size() )
+				{
+					out += ',';
+				}
+			}
+			if ( fmt && !Children.empty() )
+			{
+				out += '\n';
+				PrintIndent( out, depth );
+			}
+			out += object ? '}' : ']';
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+char * JSON::PrintValue( int depth, bool fmt )
+{
+	String out;
+	PrintTo( out, depth, fmt );
+	return strdup( out.ToCStr() );
+}
+
+//==============================
+// Parsing
+
+static const char * SkipWhitespace( const char * p )
+{
+	while ( p != NULL && *p != '\0' && (unsigned char)*p <= ' ' )
+	{
+		p++;
+	}
+	return p;
+}
+
+static const char * ParseString( String & out, const char * p, const char ** perror )
+{
+	if ( *p != '"' )
+	{
+		*perror = "Syntax Error: Invalid String";
+		return NULL;
+	}
+	p++;
+	out.Clear();
+	while ( *p != '"' )
+	{
+		if ( *p == '\0' )
+		{
+			*perror = "Syntax Error: Unterminated String";
+			return NULL;
+		}
+		if ( *p != '\\' )
+		{
+			out += *p++;
+			continue;
+		}
+		p++;
+		switch ( *p )
+		{
+			case 'b':	out += '\b'; break;
+			case 'f':	out += '\f'; break;
+			case 'n':	out += '\n'; break;
+			case 'r':	out += '\r'; break;
+			case 't':	out += '\t'; break;
+			case 'u':
+			{
+				unsigned int ch = 0;
+				for ( int i = 1; i <= 4; i++ )
+				{
+					const char c = p[i];
+					ch <<= 4;
+					if ( c >= '0' && c <= '9' ) ch |= c - '0';
+					else if ( c >= 'a' && c <= 'f' ) ch |= c - 'a' + 10;
+					else if ( c >= 'A' && c <= 'F' ) ch |= c - 'A' + 10;
+					else
+					{
+						*perror = "Syntax Error: Invalid Escape";
+						return NULL;
+					}
+				}
+				out.AppendChar( ch );
+				p += 4;
+				break;
+			}
+			case '\0':
+				*perror = "Syntax Error: Unterminated String";
+				return NULL;
+			default:	out += *p; break;
+		}
+		p++;
+	}
+	return p + 1;
+}
+
+const char * JSON::ParseValue( JSON * item, const char * p, const char ** perror )
+{
+	p = SkipWhitespace( p );
+	if ( strncmp( p, "null", 4 ) == 0 )
+	{
+		item->Type = JSON_Null;
+		return p + 4;
+	}
+	if ( strncmp( p, "false", 5 ) == 0 )
+	{
+		item->Type = JSON_Bool;
+		item->dValue = 0.0;
+		return p + 5;
+	}
+	if ( strncmp( p, "true", 4 ) == 0 )
+	{
+		item->Type = JSON_Bool;
+		item->dValue = 1.0;
+		return p + 4;
+	}
+	if ( *p == '"' )
+	{
+		item->Type = JSON_String;
+		return ParseString( item->Value, p, perror );
+	}
+	if ( *p == '-' || isdigit( (unsigned char)*p ) )
+	{
+		char * end = NULL;
+		item->Type = JSON_Number;
+		item->dValue = strtod( p, &end );
+		return end;
+	}
+	if ( *p == '[' || *p == '{' )
+	{
+		const bool object = ( *p == '{' );
+		const char close = object ? '}' : ']';
+		item->Type = object ? JSON_Object : JSON_Array;
+		p = SkipWhitespace( p + 1 );
+		if ( *p == close )
+		{
+			return p + 1;
+		}
+		for ( ;; )
+		{
+			JSON * child = new JSON( JSON_None );
+			item->AddItem( NULL, child );
+			if ( object )
+			{
+				p = ParseString( child->Name, SkipWhitespace( p ), perror );
+				if ( p == NULL )
+				{
+					return NULL;
+				}
+				p = SkipWhitespace( p );
+				if ( *p != ':' )
+				{
+					*perror = "Syntax Error: Missing Colon";
+					return NULL;
+				}
+				p++;
+			}
+			p = ParseValue( child, p, perror );
+			if ( p == NULL )
+			{
+				return NULL;
+			}
+			p = SkipWhitespace( p );
+			if ( *p == ',' )
+			{
+				p++;
+				continue;
+			}
+			if ( *p == close )
+			{
+				return p + 1;
+			}
+			*perror = object ? "Syntax Error: Missing Object Terminator" : "Syntax Error: Missing Array Terminator";
+			return NULL;
+		}
+	}
+	*perror = "Syntax Error: Invalid syntax";
+	return NULL;
+}
+
+JSON * JSON::Parse( const char * buff, const char ** perror )
+{
+	const char * error = NULL;
+	JSON * root = new JSON( JSON_None );
+	if ( ParseValue( root, buff, &error ) == NULL )
+	{
+		root->Release();
+		if ( perror != NULL )
+		{
+			*perror = error;
+		}
+		return NULL;
+	}
+	return root;
+}
+
+JSON * JSON::Load( const char * path, const char ** perror )
+{
+	FILE * f = fopen( path, "rb" );
+	if ( f == NULL )
+	{
+		if ( perror != NULL )
+		{
+			*perror = "Could not open file";
+		}
+		return NULL;
+	}
+	String text;
+	char buffer[4096];
+	size_t read;
+	while ( ( read = fread( buffer, 1, sizeof( buffer ), f ) ) > 0 )
+	{
+		text.AppendString( buffer, (SPInt)read );
+	}
+	fclose( f );
+	return Parse( text.ToCStr(), perror );
+}
+
+bool JSON::Save( const char * path )
+{
+	FILE * f = fopen( path, "wb" );
+	if ( f == NULL )
+	{
+		return false;
+	}
+	char * text = PrintValue( 0, true );
+	const size_t length = strlen( text );
+	const bool ok = ( fwrite( text, 1, length, f ) == length );
+	free( text );
+	return ( fclose( f ) == 0 ) && ok;
+}
+
+} // namespace OVR
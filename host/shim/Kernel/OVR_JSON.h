@@ -0,0 +1,111 @@
+/************************************************************************************
+
+Filename    :   OVR_JSON.h
+Content     :	Host stand-in for the OVR kernel's reference counted JSON tree
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( OVR_JSON_h )
+#define OVR_JSON_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_String.h"
+
+#include <vector>
+
+namespace OVR {
+
+enum JSONItemType
+{
+	JSON_None	= 0,
+	JSON_Null	= 1,
+	JSON_Bool	= 2,
+	JSON_Number	= 3,
+	JSON_String	= 4,
+	JSON_Array	= 5,
+	JSON_Object	= 6
+};
+
+// Nodes start with one reference and a parent releases its children when it
+// goes away.  RemoveNode and ReplaceNodeWith only relink, like the SDK's
+// ListNode, so the caller owns whatever they unlink.
+class JSON
+{
+public:
+	JSONItemType	Type;
+	String			Name;
+	String			Value;
+	double			dValue;
+
+	static JSON *	CreateObject() { return new JSON( JSON_Object ); }
+	static JSON *	CreateArray() { return new JSON( JSON_Array ); }
+	static JSON *	CreateNull() { return new JSON( JSON_Null ); }
+	static JSON *	CreateBool( const bool b ) { JSON * j = new JSON( JSON_Bool ); j->dValue = b ? 1.0 : 0.0; return j; }
+	static JSON *	CreateNumber( const double num ) { JSON * j = new JSON( JSON_Number ); j->dValue = num; return j; }
+	static JSON *	CreateString( const char * s ) { JSON * j = new JSON( JSON_String ); j->Value = s; return j; }
+
+	static JSON *	Parse( const char * buff, const char ** perror = NULL );
+	static JSON *	Load( const char * path, const char ** perror = NULL );
+	bool			Save( const char * path );
+
+	// returns a malloc'd string the caller frees
+	char *			PrintValue( int depth, bool fmt );
+
+	void			AddRef() { RefCount++; }
+	void			Release() { if ( --RefCount == 0 ) { delete this; } }
+
+	int				GetItemCount() const { return (int)Children.size(); }
+	JSON *			GetItemByIndex( const unsigned index );
+	JSON *			GetItemByName( const char * name );
+	JSON *			GetFirstItem() { return Children.empty() ? NULL : Children.front(); }
+	JSON *			GetLastItem() { return Children.empty() ? NULL : Children.back(); }
+
+	void			AddItem( const char * name, JSON * item );
+	void			AddNullItem( const char * name ) { AddItem( name, CreateNull() ); }
+	void			AddBoolItem( const char * name, const bool b ) { AddItem( name, CreateBool( b ) ); }
+	void			AddNumberItem( const char * name, const double n ) { AddItem( name, CreateNumber( n ) ); }
+	void			AddStringItem( const char * name, const char * s ) { AddItem( name, CreateString( s ) ); }
+	void			AddArrayElement( JSON * item ) { AddItem( NULL, item ); }
+
+	bool			GetBoolValue() const { return dValue != 0.0; }
+	int				GetInt32Value() const { return (int)dValue; }
+	double			GetDoubleValue() const { return dValue; }
+	const String &	GetStringValue() const { return Value; }
+
+	void			RemoveNode();
+	void			ReplaceNodeWith( JSON * node );
+
+private:
+	int					RefCount;
+	JSON *				Parent;
+	std::vector<JSON *>	Children;
+
+	explicit		JSON( const JSONItemType type ) :
+						Type( type ),
+						dValue( 0.0 ),
+						RefCount( 1 ),
+						Parent( NULL )
+
+					{
+					}
+
+					~JSON();
+
+	void			PrintTo( String & out, int depth, bool fmt ) const;
+	static const char *	ParseValue( JSON * item, const char * p, const char ** perror );
+
+	// no copies, nodes are shared by pointer
+					JSON( const JSON & );
+	JSON &			operator=( const JSON & );
+};
+
+} // namespace OVR
+
+#endif // OVR_JSON_h
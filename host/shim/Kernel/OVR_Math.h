@@ -0,0 +1,408 @@
+/************************************************************************************
+
+Filename    :   OVR_Math.h
+Content     :	Host stand-in for the OVR kernel's vector, quaternion and matrix math
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( OVR_Math_h )
+#define OVR_Math_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_Alg.h"
+
+#include <math.h>
+#include <float.h>
+
+namespace OVR {
+
+// Matrices are row major and transform column vectors, with the
+// translation in the last column, as in the SDK.
+
+template< class T > class Math;
+
+template<> class Math<float>
+{
+public:
+	static const float	Pi;
+	static const float	MaxValue;
+	static const float	Tolerance;
+};
+
+// inline so the shim stays header only
+__attribute__( ( weak ) ) const float Math<float>::Pi = 3.14159265358979f;
+__attribute__( ( weak ) ) const float Math<float>::MaxValue = FLT_MAX;
+__attribute__( ( weak ) ) const float Math<float>::Tolerance = 0.00001f;
+
+inline float DegreeToRad( const float degrees ) { return degrees * ( Math<float>::Pi / 180.0f ); }
+inline float RadToDegree( const float rads ) { return rads * ( 180.0f / Math<float>::Pi ); }
+
+//=======================================================================================
+
+class Vector2f
+{
+public:
+	float	x, y;
+
+			Vector2f() : x( 0.0f ), y( 0.0f ) {}
+			Vector2f( const float s ) : x( s ), y( s ) {}
+			Vector2f( const float x_, const float y_ ) : x( x_ ), y( y_ ) {}
+
+	Vector2f	operator+( const Vector2f & b ) const { return Vector2f( x + b.x, y + b.y ); }
+	Vector2f	operator-( const Vector2f & b ) const { return Vector2f( x - b.x, y - b.y ); }
+	Vector2f	operator*( const float s ) const { return Vector2f( x * s, y * s ); }
+	Vector2f	operator/( const float s ) const { return Vector2f( x / s, y / s ); }
+	Vector2f	operator-() const { return Vector2f( -x, -y ); }
+	bool		operator==( const Vector2f & b ) const { return x == b.x && y == b.y; }
+	bool		operator!=( const Vector2f & b ) const { return !( *this == b ); }
+
+	float		Dot( const Vector2f & b ) const { return x * b.x + y * b.y; }
+	float		LengthSq() const { return Dot( *this ); }
+	float		Length() const { return sqrtf( LengthSq() ); }
+	Vector2f	Lerp( const Vector2f & b, const float f ) const { return *this * ( 1.0f - f ) + b * f; }
+};
+
+//=======================================================================================
+
+class Vector3f
+{
+public:
+	float	x, y, z;
+
+	static const Vector3f	ZERO;
+
+			Vector3f() : x( 0.0f ), y( 0.0f ), z( 0.0f ) {}
+	explicit Vector3f( const float s ) : x( s ), y( s ), z( s ) {}
+			Vector3f( const float x_, const float y_, const float z_ ) : x( x_ ), y( y_ ), z( z_ ) {}
+
+	Vector3f	operator+( const Vector3f & b ) const { return Vector3f( x + b.x, y + b.y, z + b.z ); }
+	Vector3f	operator-( const Vector3f & b ) const { return Vector3f( x - b.x, y - b.y, z - b.z ); }
+	Vector3f	operator*( const float s ) const { return Vector3f( x * s, y * s, z * s ); }
+	Vector3f	operator/( const float s ) const { return Vector3f( x / s, y / s, z / s ); }
+	Vector3f	operator-() const { return Vector3f( -x, -y, -z ); }
+	Vector3f &	operator+=( const Vector3f & b ) { x += b.x; y += b.y; z += b.z; return *this; }
+	Vector3f &	operator-=( const Vector3f & b ) { x -= b.x; y -= b.y; z -= b.z; return *this; }
+	Vector3f &	operator*=( const float s ) { x *= s; y *= s; z *= s; return *this; }
+	bool		operator==( const Vector3f & b ) const { return x == b.x && y == b.y && z == b.z; }
+	bool		operator!=( const Vector3f & b ) const { return !( *this == b ); }
+	float &		operator[]( const int i ) { return ( &x )[i]; }
+	const float & operator[]( const int i ) const { return ( &x )[i]; }
+
+	float		Dot( const Vector3f & b ) const { return x * b.x + y * b.y + z * b.z; }
+	Vector3f	Cross( const Vector3f & b ) const { return Vector3f( y * b.z - z * b.y, z * b.x - x * b.z, x * b.y - y * b.x ); }
+	float		LengthSq() const { return Dot( *this ); }
+	float		Length() const { return sqrtf( LengthSq() ); }
+	float		Distance( const Vector3f & b ) const { return ( *this - b ).Length(); }
+	Vector3f	Lerp( const Vector3f & b, const float f ) const { return *this * ( 1.0f - f ) + b * f; }
+
+	Vector3f	Normalized() const
+	{
+		const float l = Length();
+		return ( l > 0.0f ) ? *this / l : *this;
+	}
+
+	void		Normalize() { *this = Normalized(); }
+};
+
+__attribute__( ( weak ) ) const Vector3f Vector3f::ZERO;
+
+//=======================================================================================
+
+class Vector4f
+{
+public:
+	float	x, y, z, w;
+
+			Vector4f() : x( 0.0f ), y( 0.0f ), z( 0.0f ), w( 0.0f ) {}
+	explicit Vector4f( const float s ) : x( s ), y( s ), z( s ), w( s ) {}
+			Vector4f( const float x_, const float y_, const float z_, const float w_ ) : x( x_ ), y( y_ ), z( z_ ), w( w_ ) {}
+			Vector4f( const Vector3f & v, const float w_ ) : x( v.x ), y( v.y ), z( v.z ), w( w_ ) {}
+
+	Vector4f	operator+( const Vector4f & b ) const { return Vector4f( x + b.x, y + b.y, z + b.z, w + b.w ); }
+	Vector4f	operator-( const Vector4f & b ) const { return Vector4f( x - b.x, y - b.y, z - b.z, w - b.w ); }
+	Vector4f	operator*( const float s ) const { return Vector4f( x * s, y * s, z * s, w * s ); }
+	bool		operator==( const Vector4f & b ) const { return x == b.x && y == b.y && z == b.z && w == b.w; }
+	bool		operator!=( const Vector4f & b ) const { return !( *this == b ); }
+
+	float		Dot( const Vector4f & b ) const { return x * b.x + y * b.y + z * b.z + w * b.w; }
+	Vector4f	Lerp( const Vector4f & b, const float f ) const { return *this * ( 1.0f - f ) + b * f; }
+};
+
+//=======================================================================================
+
+class Quatf
+{
+public:
+	float	x, y, z, w;
+
+			Quatf() : x( 0.0f ), y( 0.0f ), z( 0.0f ), w( 1.0f ) {}
+			Quatf( const float x_, const float y_, const float z_, const float w_ ) : x( x_ ), y( y_ ), z( z_ ), w( w_ ) {}
+
+			// rotation of angle radians around axis
+			Quatf( const Vector3f & axis, const float angle )
+			{
+				const Vector3f unit = axis.Normalized();
+				const float s = sinf( angle * 0.5f );
+				x = unit.x * s;
+				y = unit.y * s;
+				z = unit.z * s;
+				w = cosf( angle * 0.5f );
+			}
+
+	Quatf		operator+( const Quatf & b ) const { return Quatf( x + b.x, y + b.y, z + b.z, w + b.w ); }
+	Quatf		operator*( const float s ) const { return Quatf( x * s, y * s, z * s, w * s ); }
+	Quatf		operator*( const Quatf & b ) const
+	{
+		return Quatf( w * b.x + x * b.w + y * b.z - z * b.y,
+					  w * b.y - x * b.z + y * b.w + z * b.x,
+					  w * b.z + x * b.y - y * b.x + z * b.w,
+					  w * b.w - x * b.x - y * b.y - z * b.z );
+	}
+	bool		operator==( const Quatf & b ) const { return x == b.x && y == b.y && z == b.z && w == b.w; }
+
+	float		Dot( const Quatf & b ) const { return x * b.x + y * b.y + z * b.z + w * b.w; }
+	float		Length() const { return sqrtf( Dot( *this ) ); }
+	Quatf		Normalized() const { const float l = Length(); return ( l > 0.0f ) ? *this * ( 1.0f / l ) : *this; }
+	Quatf		Inverted() const { return Quatf( -x, -y, -z, w ); }
+
+	// like the SDK, a weights this quaternion and 1 - a the other one
+	Quatf		Nlerp( const Quatf & other, const float a ) const
+	{
+		const float sign = ( Dot( other ) >= 0.0f ) ? 1.0f : -1.0f;
+		return ( *this * ( sign * a ) + other * ( 1.0f - a ) ).Normalized();
+	}
+
+	Vector3f	Rotate( const Vector3f & v ) const
+	{
+		const Quatf p = *this * Quatf( v.x, v.y, v.z, 0.0f ) * Inverted();
+		return Vector3f( p.x, p.y, p.z );
+	}
+};
+
+//=======================================================================================
+
+class Posef
+{
+public:
+	Quatf		Orientation;
+	Vector3f	Position;
+
+				Posef() {}
+				Posef( const Quatf & orientation, const Vector3f & position ) : Orientation( orientation ), Position( position ) {}
+
+	Vector3f	Transform( const Vector3f & v ) const { return Orientation.Rotate( v ) + Position; }
+};
+
+//=======================================================================================
+
+class Bounds3f
+{
+public:
+	Vector3f	b[2];
+
+				Bounds3f() { Clear(); }
+				Bounds3f( const Vector3f & mins, const Vector3f & maxs ) { b[0] = mins; b[1] = maxs; }
+
+	void		Clear()
+	{
+		b[0] = Vector3f( FLT_MAX );
+		b[1] = Vector3f( -FLT_MAX );
+	}
+
+	void		AddPoint( const Vector3f & v )
+	{
+		for ( int i = 0; i < 3; i++ )
+		{
+			b[0][i] = ( v[i] < b[0][i] ) ? v[i] : b[0][i];
+			b[1][i] = ( v[i] > b[1][i] ) ? v[i] : b[1][i];
+		}
+	}
+
+	Vector3f	GetSize() const { return b[1] - b[0]; }
+	Vector3f	GetCenter() const { return ( b[0] + b[1] ) * 0.5f; }
+};
+
+//=======================================================================================
+
+class Matrix4f
+{
+public:
+	float	M[4][4];
+
+	static const Matrix4f	IdentityValue;
+
+			Matrix4f() { SetIdentity(); }
+
+			Matrix4f( const float m11, const float m12, const float m13, const float m14,
+					  const float m21, const float m22, const float m23, const float m24,
+					  const float m31, const float m32, const float m33, const float m34,
+					  const float m41, const float m42, const float m43, const float m44 )
+			{
+				M[0][0] = m11; M[0][1] = m12; M[0][2] = m13; M[0][3] = m14;
+				M[1][0] = m21; M[1][1] = m22; M[1][2] = m23; M[1][3] = m24;
+				M[2][0] = m31; M[2][1] = m32; M[2][2] = m33; M[2][3] = m34;
+				M[3][0] = m41; M[3][1] = m42; M[3][2] = m43; M[3][3] = m44;
+			}
+
+	explicit Matrix4f( const Quatf & q )
+			{
+				const float ww = q.w * q.w, xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+				SetIdentity();
+				M[0][0] = ww + xx - yy - zz;
+				M[0][1] = 2.0f * ( q.x * q.y - q.w * q.z );
+				M[0][2] = 2.0f * ( q.x * q.z + q.w * q.y );
+				M[1][0] = 2.0f * ( q.x * q.y + q.w * q.z );
+				M[1][1] = ww - xx + yy - zz;
+				M[1][2] = 2.0f * ( q.y * q.z - q.w * q.x );
+				M[2][0] = 2.0f * ( q.x * q.z - q.w * q.y );
+				M[2][1] = 2.0f * ( q.y * q.z + q.w * q.x );
+				M[2][2] = ww - xx - yy + zz;
+			}
+
+	void		SetIdentity()
+	{
+		for ( int i = 0; i < 4; i++ )
+		{
+			for ( int j = 0; j < 4; j++ )
+			{
+				M[i][j] = ( i == j ) ? 1.0f : 0.0f;
+			}
+		}
+	}
+
+	static Matrix4f	Identity() { return Matrix4f(); }
+
+	static Matrix4f	Translation( const float x, const float y, const float z )
+	{
+		Matrix4f t;
+		t.M[0][3] = x;
+		t.M[1][3] = y;
+		t.M[2][3] = z;
+		return t;
+	}
+	static Matrix4f	Translation( const Vector3f & v ) { return Translation( v.x, v.y, v.z ); }
+
+	static Matrix4f	Scaling( const float x, const float y, const float z )
+	{
+		Matrix4f t;
+		t.M[0][0] = x;
+		t.M[1][1] = y;
+		t.M[2][2] = z;
+		return t;
+	}
+	static Matrix4f	Scaling( const Vector3f & v ) { return Scaling( v.x, v.y, v.z ); }
+	static Matrix4f	Scaling( const float s ) { return Scaling( s, s, s ); }
+
+	static Matrix4f	RotationX( const float angle )
+	{
+		const float c = cosf( angle ), s = sinf( angle );
+		return Matrix4f( 1, 0, 0, 0,  0, c, -s, 0,  0, s, c, 0,  0, 0, 0, 1 );
+	}
+	static Matrix4f	RotationY( const float angle )
+	{
+		const float c = cosf( angle ), s = sinf( angle );
+		return Matrix4f( c, 0, s, 0,  0, 1, 0, 0,  -s, 0, c, 0,  0, 0, 0, 1 );
+	}
+	static Matrix4f	RotationZ( const float angle )
+	{
+		const float c = cosf( angle ), s = sinf( angle );
+		return Matrix4f( c, -s, 0, 0,  s, c, 0, 0,  0, 0, 1, 0,  0, 0, 0, 1 );
+	}
+
+	Matrix4f	operator*( const Matrix4f & b ) const
+	{
+		Matrix4f r;
+		for ( int i = 0; i < 4; i++ )
+		{
+			for ( int j = 0; j < 4; j++ )
+			{
+				r.M[i][j] = M[i][0] * b.M[0][j] + M[i][1] * b.M[1][j] + M[i][2] * b.M[2][j] + M[i][3] * b.M[3][j];
+			}
+		}
+		return r;
+	}
+
+	Matrix4f &	operator*=( const Matrix4f & b ) { *this = *this * b; return *this; }
+
+	bool		operator==( const Matrix4f & b ) const { return memcmp( M, b.M, sizeof( M ) ) == 0; }
+
+	Vector3f	Transform( const Vector3f & v ) const
+	{
+		return Vector3f( M[0][0] * v.x + M[0][1] * v.y + M[0][2] * v.z + M[0][3],
+						 M[1][0] * v.x + M[1][1] * v.y + M[1][2] * v.z + M[1][3],
+						 M[2][0] * v.x + M[2][1] * v.y + M[2][2] * v.z + M[2][3] );
+	}
+
+	Vector4f	Transform( const Vector4f & v ) const
+	{
+		return Vector4f( M[0][0] * v.x + M[0][1] * v.y + M[0][2] * v.z + M[0][3] * v.w,
+						 M[1][0] * v.x + M[1][1] * v.y + M[1][2] * v.z + M[1][3] * v.w,
+						 M[2][0] * v.x + M[2][1] * v.y + M[2][2] * v.z + M[2][3] * v.w,
+						 M[3][0] * v.x + M[3][1] * v.y + M[3][2] * v.z + M[3][3] * v.w );
+	}
+
+	Vector3f	GetTranslation() const { return Vector3f( M[0][3], M[1][3], M[2][3] ); }
+
+	Matrix4f	Transposed() const
+	{
+		Matrix4f r;
+		for ( int i = 0; i < 4; i++ )
+		{
+			for ( int j = 0; j < 4; j++ )
+			{
+				r.M[i][j] = M[j][i];
+			}
+		}
+		return r;
+	}
+
+	// general inverse by cofactors
+	Matrix4f	Inverted() const
+	{
+		const float * m = &M[0][0];
+		float inv[16];
+
+		inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+		inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+		inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+		inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+		inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+		inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+		inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+		inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+		inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+		inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+		inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+		inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+		inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+		inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+		inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+		inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+		const float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+		Matrix4f r;
+		if ( det == 0.0f )
+		{
+			return r;
+		}
+		const float invDet = 1.0f / det;
+		for ( int i = 0; i < 16; i++ )
+		{
+			( &r.M[0][0] )[i] = inv[i] * invDet;
+		}
+		return r;
+	}
+};
+
+__attribute__( ( weak ) ) const Matrix4f Matrix4f::IdentityValue;
+
+} // namespace OVR
+
+#endif // OVR_Math_h
@@ -0,0 +1,172 @@
+/************************************************************************************
+
+Filename    :   OVR_String.h
+Content     :	Host stand-in for the OVR kernel's UTF-8 string
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( OVR_String_h )
+#define OVR_String_h
+
+#include "Kernel/OVR_Types.h"
+
+#include <string>
+#include <strings.h>
+
+namespace OVR {
+
+// The SDK's String over a std::string.  Sizes are in bytes, lengths and
+// the Substring/Remove positions in UTF-8 characters, as in the SDK.
+class String
+{
+public:
+				String() {}
+				String( const char * data ) : Data( data != NULL ? data : "" ) {}
+				String( const char * data, const UPInt size ) : Data( data, size ) {}
+				String( const String & other ) : Data( other.Data ) {}
+
+	const char *	ToCStr() const { return Data.c_str(); }
+					operator const char *() const { return Data.c_str(); }
+	UPInt			GetSize() const { return Data.size(); }
+	bool			IsEmpty() const { return Data.empty(); }
+	void			Clear() { Data.clear(); }
+
+	UPInt			GetLength() const
+	{
+		UPInt length = 0;
+		for ( UPInt i = 0; i < Data.size(); i++ )
+		{
+			length += ( ( Data[i] & 0xC0 ) != 0x80 );
+		}
+		return length;
+	}
+
+	UInt32			GetCharAt( const UPInt index ) const { return (unsigned char)Data[ByteIndex( index )]; }
+
+	void			AssignString( const char * data, const UPInt size ) { Data.assign( data, size ); }
+	void			AppendString( const char * data, const SPInt size = -1 )
+	{
+		if ( size < 0 )
+		{
+			Data.append( data );
+		}
+		else
+		{
+			Data.append( data, size );
+		}
+	}
+
+	void			AppendChar( const UInt32 ch )
+	{
+		if ( ch < 0x80 )
+		{
+			Data += (char)ch;
+		}
+		else if ( ch < 0x800 )
+		{
+			Data += (char)( 0xC0 | ( ch >> 6 ) );
+			Data += (char)( 0x80 | ( ch & 0x3F ) );
+		}
+		else
+		{
+			Data += (char)( 0xE0 | ( ch >> 12 ) );
+			Data += (char)( 0x80 | ( ( ch >> 6 ) & 0x3F ) );
+			Data += (char)( 0x80 | ( ch & 0x3F ) );
+		}
+	}
+
+	String			Substring( const UPInt start, const UPInt end ) const
+	{
+		const UPInt first = ByteIndex( start );
+		const UPInt last = ByteIndex( end );
+		return ( last > first ) ? String( Data.c_str() + first, last - first ) : String();
+	}
+
+	void			Insert( const char * data, const UPInt pos, const SPInt size = -1 )
+	{
+		Data.insert( ByteIndex( pos ), data, size < 0 ? strlen( data ) : (UPInt)size );
+	}
+
+	void			Remove( const UPInt pos, const SPInt length = 1 )
+	{
+		const UPInt first = ByteIndex( pos );
+		Data.erase( first, ByteIndex( pos + length ) - first );
+	}
+
+	// drops everything from the last dot of the file name on
+	void			StripExtension()
+	{
+		const size_t dot = Data.find_last_of( '.' );
+		const size_t slash = Data.find_last_of( "/\\" );
+		if ( dot != std::string::npos && ( slash == std::string::npos || dot > slash ) )
+		{
+			Data.erase( dot );
+		}
+	}
+
+	String			GetExtension() const
+	{
+		const size_t dot = Data.find_last_of( '.' );
+		const size_t slash = Data.find_last_of( "/\\" );
+		if ( dot != std::string::npos && ( slash == std::string::npos || dot > slash ) )
+		{
+			return String( Data.c_str() + dot );
+		}
+		return String();
+	}
+
+	static int		CompareNoCase( const char * a, const char * b ) { return strcasecmp( a, b ); }
+	int				CompareNoCase( const char * b ) const { return strcasecmp( Data.c_str(), b ); }
+	int				CompareNoCase( const String & b ) const { return strcasecmp( Data.c_str(), b.ToCStr() ); }
+
+	const char &	operator[]( const UPInt index ) const { return Data[index]; }
+
+	String &		operator=( const char * data ) { Data = ( data != NULL ? data : "" ); return *this; }
+	String &		operator=( const String & other ) { Data = other.Data; return *this; }
+	String &		operator+=( const char * data ) { Data += data; return *this; }
+	String &		operator+=( const String & other ) { Data += other.Data; return *this; }
+	String &		operator+=( const char ch ) { Data += ch; return *this; }
+
+	String			operator+( const char * data ) const { String s( *this ); s += data; return s; }
+	String			operator+( const String & other ) const { String s( *this ); s += other; return s; }
+
+	bool			operator==( const char * data ) const { return Data == data; }
+	bool			operator!=( const char * data ) const { return Data != data; }
+	bool			operator==( const String & other ) const { return Data == other.Data; }
+	bool			operator!=( const String & other ) const { return Data != other.Data; }
+	bool			operator<( const String & other ) const { return Data < other.Data; }
+	bool			operator>( const String & other ) const { return Data > other.Data; }
+
+private:
+	std::string		Data;
+
+	UPInt			ByteIndex( const UPInt charIndex ) const
+	{
+		UPInt chars = 0;
+		for ( UPInt i = 0; i < Data.size(); i++ )
+		{
+			if ( ( Data[i] & 0xC0 ) != 0x80 )
+			{
+				if ( chars == charIndex )
+				{
+					return i;
+				}
+				chars++;
+			}
+		}
+		return Data.size();
+	}
+};
+
+inline String operator+( const char * a, const String & b ) { return String( a ) + b; }
+
+} // namespace OVR
+
+#endif // OVR_String_h
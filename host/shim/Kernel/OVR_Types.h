@@ -0,0 +1,73 @@
+/************************************************************************************
+
+Filename    :   OVR_Types.h
+Content     :	Host stand-in for the OVR kernel's basic types and macros
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( OVR_Types_h )
+#define OVR_Types_h
+
+// Only what cinemacore uses of the Oculus Mobile SDK kernel, so the core
+// library builds and runs on a Linux box.  Names and behavior follow the
+// SDK; anything missing here is missing on purpose until core code needs it.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <assert.h>
+
+#define OVR_OS_LINUX
+#define OVR_CPU_X86_64
+
+#define OVR_ASSERT( p )				assert( p )
+#define OVR_UNUSED( a )				( (void)( a ) )
+#define OVR_UNUSED2( a, b )			( (void)( a ), (void)( b ) )
+#define OVR_ALLOC( s )				malloc( s )
+#define OVR_FREE( p )				free( p )
+#define OVR_ARRAY_COUNT( a )		( sizeof( a ) / sizeof( ( a )[0] ) )
+#define OVR_FORCE_INLINE			inline __attribute__( ( always_inline ) )
+
+namespace OVR {
+
+typedef size_t		UPInt;
+typedef ptrdiff_t	SPInt;
+typedef uint8_t		UByte;
+typedef int8_t		SByte;
+typedef uint8_t		UInt8;
+typedef int8_t		SInt8;
+typedef uint16_t	UInt16;
+typedef int16_t		SInt16;
+typedef uint32_t	UInt32;
+typedef int32_t		SInt32;
+typedef uint64_t	UInt64;
+typedef int64_t		SInt64;
+
+inline char * OVR_strcpy( char * dest, UPInt destsize, const char * src )
+{
+	snprintf( dest, destsize, "%s", src );
+	return dest;
+}
+
+inline char * OVR_strncpy( char * dest, UPInt destsize, const char * src, UPInt count )
+{
+	const UPInt n = ( count < destsize - 1 ) ? count : destsize - 1;
+	strncpy( dest, src, n );
+	dest[n] = '\0';
+	return dest;
+}
+
+#define OVR_sprintf snprintf
+
+} // namespace OVR
+
+#endif // OVR_Types_h
@@ -0,0 +1,80 @@
+/************************************************************************************
+
+Filename    :   log.h
+Content     :	Host stand-in for the NDK's liblog, printing to stderr
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#ifndef HOST_ANDROID_LOG_H
+#define HOST_ANDROID_LOG_H
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum android_LogPriority {
+	ANDROID_LOG_UNKNOWN = 0,
+	ANDROID_LOG_DEFAULT,
+	ANDROID_LOG_VERBOSE,
+	ANDROID_LOG_DEBUG,
+	ANDROID_LOG_INFO,
+	ANDROID_LOG_WARN,
+	ANDROID_LOG_ERROR,
+	ANDROID_LOG_FATAL,
+	ANDROID_LOG_SILENT
+} android_LogPriority;
+
+// Tests and benchmarks would drown in the app's chatter, so only warnings
+// and up are printed unless HOST_LOG_PRIORITY asks for more (3 is debug).
+static inline int host_log_enabled(int prio)
+{
+	static int threshold = -1;
+	if (threshold < 0) {
+		const char *env = getenv("HOST_LOG_PRIORITY");
+		threshold = (env != NULL) ? atoi(env) : ANDROID_LOG_WARN;
+	}
+	return prio >= threshold;
+}
+
+static inline int __android_log_write(int prio, const char *tag, const char *text)
+{
+	if (!host_log_enabled(prio))
+		return 0;
+	return fprintf(stderr, "%s: %s\n", tag, text);
+}
+
+static inline int __android_log_vprint(int prio, const char *tag, const char *fmt, va_list ap)
+{
+	char text[1024];
+	if (!host_log_enabled(prio))
+		return 0;
+	vsnprintf(text, sizeof(text), fmt, ap);
+	return __android_log_write(prio, tag, text);
+}
+
+static inline int __android_log_print(int prio, const char *tag, const char *fmt, ...)
+{
+	va_list ap;
+	int result;
+	va_start(ap, fmt);
+	result = __android_log_vprint(prio, tag, fmt, ap);
+	va_end(ap);
+	return result;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
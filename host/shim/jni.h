@@ -0,0 +1,68 @@
+/************************************************************************************
+
+Filename    :   jni.h
+Content     :	Host stand-in for the JNI header, just what the native audio glue calls
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#ifndef HOST_JNI_H
+#define HOST_JNI_H
+
+#include <stdint.h>
+
+// JNIEnv is the C flavor in C++ too, so a test harness can fill in the
+// function table and call the glue the way the VM would.  The table only
+// has the functions the glue uses, in no particular order.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int32_t		jint;
+typedef int64_t		jlong;
+typedef int8_t		jbyte;
+typedef int16_t		jshort;
+typedef uint8_t		jboolean;
+typedef jint		jsize;
+
+typedef struct _jobject *	jobject;
+typedef jobject		jclass;
+typedef jobject		jarray;
+typedef jarray		jbyteArray;
+typedef jarray		jintArray;
+
+#define JNI_FALSE	0
+#define JNI_TRUE	1
+
+#define JNI_COMMIT	1
+#define JNI_ABORT	2
+
+#define JNIEXPORT	__attribute__( ( visibility( "default" ) ) )
+#define JNICALL
+
+struct JNINativeInterface;
+typedef const struct JNINativeInterface *	JNIEnv;
+
+struct JNINativeInterface {
+	jsize	(*GetArrayLength)(JNIEnv *env, jarray array);
+	jbyte *	(*GetByteArrayElements)(JNIEnv *env, jbyteArray array, jboolean *isCopy);
+	void	(*ReleaseByteArrayElements)(JNIEnv *env, jbyteArray array, jbyte *elems, jint mode);
+	void *	(*GetPrimitiveArrayCritical)(JNIEnv *env, jarray array, jboolean *isCopy);
+	void	(*ReleasePrimitiveArrayCritical)(JNIEnv *env, jarray array, void *carray, jint mode);
+	void	(*SetIntArrayRegion)(JNIEnv *env, jintArray array, jsize start, jsize len, const jint *buf);
+	void	(*GetByteArrayRegion)(JNIEnv *env, jbyteArray array, jsize start, jsize len, jbyte *buf);
+	void	(*SetByteArrayRegion)(JNIEnv *env, jbyteArray array, jsize start, jsize len, const jbyte *buf);
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
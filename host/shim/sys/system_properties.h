@@ -0,0 +1,35 @@
+/************************************************************************************
+
+Filename    :   system_properties.h
+Content     :	Host stand-in for bionic's system properties; none are ever set
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#ifndef HOST_SYS_SYSTEM_PROPERTIES_H
+#define HOST_SYS_SYSTEM_PROPERTIES_H
+
+#define PROP_VALUE_MAX	92
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline int __system_property_get(const char *name, char *value)
+{
+	(void)name;
+	value[0] = '\0';
+	return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
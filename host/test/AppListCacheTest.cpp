@@ -0,0 +1,276 @@
+/************************************************************************************
+
+Filename    :   AppListCacheTest.cpp
+Content     :	Host tests of the app list cache, its file and the prefetch rules
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "AppListCache.h"
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+String TempPath()
+{
+	char path[] = "/tmp/streamtheater_applistsXXXXXX";
+	close( mkstemp( path ) );
+	unlink( path );
+	return String( path );
+}
+
+AppListEntry App( const int id, const char * name, const bool running = false )
+{
+	AppListEntry entry;
+	entry.Id = id;
+	entry.Name = name;
+	entry.PosterFileName = String( name ) + ".png";
+	entry.IsRunning = running;
+	return entry;
+}
+
+Array<AppListEntry> TwoApps()
+{
+	Array<AppListEntry> apps;
+	apps.PushBack( App( 1, "Steam", true ) );
+	apps.PushBack( App( 2, "Desktop" ) );
+	return apps;
+}
+
+long FileSize( const String & path )
+{
+	FILE * f = fopen( path.ToCStr(), "rb" );
+	if ( f == NULL )
+	{
+		return -1;
+	}
+	fseek( f, 0, SEEK_END );
+	const long size = ftell( f );
+	fclose( f );
+	return size;
+}
+
+}
+
+TEST( AppListCache, ListsSurviveARestart )
+{
+	const String path = TempPath();
+	{
+		AppListCache cache;
+		EXPECT_FALSE( cache.Load( path.ToCStr() ) );
+		EXPECT_FALSE( cache.IsDirty() );
+		cache.Store( "host-a", TwoApps(), 1000.0 );
+		cache.Store( "host-b", Array<AppListEntry>(), 2000.0 );
+		EXPECT_TRUE( cache.IsDirty() );
+		ASSERT_TRUE( cache.Save( path.ToCStr() ) );
+		EXPECT_FALSE( cache.IsDirty() );
+	}
+
+	AppListCache cache;
+	ASSERT_TRUE( cache.Load( path.ToCStr() ) );
+	EXPECT_EQ( 2, cache.GetNumHosts() );
+	Array<AppListEntry> apps;
+	ASSERT_TRUE( cache.Get( "HOST-A", apps ) );		// uuids match whatever the case
+	ASSERT_EQ( 2, apps.GetSizeI() );
+	EXPECT_STREQ( "Steam", apps[0].Name.ToCStr() );
+	EXPECT_STREQ( "Steam.png", apps[0].PosterFileName.ToCStr() );
+	EXPECT_EQ( 1, apps[0].Id );
+	EXPECT_TRUE( apps[0].IsRunning );
+	EXPECT_FALSE( apps[1].IsRunning );
+	EXPECT_EQ( 1000.0, cache.GetFetchTime( "host-a" ) );
+	ASSERT_TRUE( cache.Get( "host-b", apps ) );
+	EXPECT_EQ( 0, apps.GetSizeI() );
+	EXPECT_EQ( -1.0, cache.GetFetchTime( "host-c" ) );
+	EXPECT_FALSE( cache.Get( "host-c", apps ) );
+	unlink( path.ToCStr() );
+}
+
+// A fetch that brings the same list again only moves its time, and that
+// isn't worth a write
+TEST( AppListCache, WritesOnlyChanges )
+{
+	const String path = TempPath();
+	AppListCache cache;
+	cache.Store( "host-a", TwoApps(), 1000.0 );
+	ASSERT_TRUE( cache.Save( path.ToCStr() ) );
+	unlink( path.ToCStr() );
+
+	cache.Store( "host-a", TwoApps(), 1100.0 );
+	EXPECT_FALSE( cache.IsDirty() );
+	EXPECT_TRUE( cache.Save( path.ToCStr() ) );
+	EXPECT_EQ( -1, FileSize( path ) );
+
+	Array<AppListEntry> apps = TwoApps();
+	apps[1].IsRunning = true;
+	cache.Store( "host-a", apps, 1200.0 );
+	EXPECT_TRUE( cache.IsDirty() );
+	EXPECT_TRUE( cache.Save( path.ToCStr() ) );
+	EXPECT_GT( FileSize( path ), 0 );
+
+	// a write that fails leaves it to the next one
+	cache.Store( "host-b", TwoApps(), 1300.0 );
+	EXPECT_FALSE( cache.Save( "/nonexistent/applists.bin" ) );
+	EXPECT_TRUE( cache.IsDirty() );
+	unlink( path.ToCStr() );
+}
+
+TEST( AppListCache, RejectsOtherFiles )
+{
+	const String path = TempPath();
+	FILE * f = fopen( path.ToCStr(), "wb" );
+	ASSERT_TRUE( f != NULL );
+	fputs( "not an app list cache", f );
+	fclose( f );
+
+	AppListCache cache;
+	cache.Store( "host-a", TwoApps(), 1000.0 );
+	EXPECT_FALSE( cache.Load( path.ToCStr() ) );
+	EXPECT_EQ( 1, cache.GetNumHosts() );
+
+	// a cache cut short keeps what was there before too
+	{
+		AppListCache full;
+		full.Store( "host-b", TwoApps(), 1000.0 );
+		ASSERT_TRUE( full.Save( path.ToCStr() ) );
+	}
+	ASSERT_EQ( 0, truncate( path.ToCStr(), FileSize( path ) - 3 ) );
+	EXPECT_FALSE( cache.Load( path.ToCStr() ) );
+	Array<AppListEntry> apps;
+	EXPECT_TRUE( cache.Get( "host-a", apps ) );
+	EXPECT_FALSE( cache.Get( "host-b", apps ) );
+	unlink( path.ToCStr() );
+}
+
+// Past MAX_HOSTS the one used longest ago goes, and a Get counts as a use
+TEST( AppListCache, DropsTheLeastRecentlyUsed )
+{
+	AppListCache cache;
+	char uuid[32];
+	for ( int i = 0; i < AppListCache::MAX_HOSTS; i++ )
+	{
+		snprintf( uuid, sizeof( uuid ), "host-%i", i );
+		cache.Store( uuid, TwoApps(), 1000.0 + i );
+	}
+	Array<AppListEntry> apps;
+	ASSERT_TRUE( cache.Get( "host-0", apps ) );
+
+	cache.Store( "host-new", TwoApps(), 2000.0 );
+	EXPECT_EQ( (int)AppListCache::MAX_HOSTS, cache.GetNumHosts() );
+	EXPECT_TRUE( cache.Get( "host-0", apps ) );
+	EXPECT_FALSE( cache.Get( "host-1", apps ) );
+	EXPECT_TRUE( cache.Get( "host-new", apps ) );
+
+	// and the order is kept across a restart
+	const String path = TempPath();
+	ASSERT_TRUE( cache.Save( path.ToCStr() ) );
+	AppListCache loaded;
+	ASSERT_TRUE( loaded.Load( path.ToCStr() ) );
+	ASSERT_TRUE( loaded.Get( "host-2", apps ) );
+	loaded.Store( "host-newer", TwoApps(), 3000.0 );
+	EXPECT_TRUE( loaded.Get( "host-2", apps ) );
+	EXPECT_FALSE( loaded.Get( "host-3", apps ) );
+	unlink( path.ToCStr() );
+}
+
+// One prefetch at a time, of a list that's old enough, and not the same
+// host again right after a try
+TEST( AppListCache, PrefetchRules )
+{
+	AppListCache cache;
+	const double now = 10000.0;
+
+	EXPECT_FALSE( cache.IsPrefetching( now ) );
+	ASSERT_TRUE( cache.StartPrefetch( "host-a", now ) );
+	EXPECT_TRUE( cache.IsPrefetching( now ) );
+	EXPECT_FALSE( cache.StartPrefetch( "host-b", now ) );
+
+	// the answer ends it, and a fresh list isn't fetched again
+	cache.Store( "host-a", TwoApps(), now + 1.0 );
+	EXPECT_FALSE( cache.IsPrefetching( now + 1.0 ) );
+	EXPECT_FALSE( cache.StartPrefetch( "host-a", now + 2.0 ) );
+	EXPECT_TRUE( cache.StartPrefetch( "host-a", now + 2.0 + AppListCache::PREFETCH_AGE_SECONDS ) );
+	cache.PrefetchFailed( "host-a" );
+
+	// a failure waits out the retry time
+	const double later = now + 1000.0;
+	ASSERT_TRUE( cache.StartPrefetch( "host-b", later ) );
+	cache.PrefetchFailed( "host-b" );
+	EXPECT_FALSE( cache.IsPrefetching( later ) );
+	EXPECT_FALSE( cache.StartPrefetch( "host-b", later + 1.0 ) );
+	EXPECT_TRUE( cache.StartPrefetch( "host-b", later + AppListCache::PREFETCH_RETRY_SECONDS + 1.0 ) );
+
+	// one that never answers is given up on
+	const double stuck = later + AppListCache::PREFETCH_RETRY_SECONDS + 1.0;
+	EXPECT_TRUE( cache.IsPrefetching( stuck + AppListCache::PREFETCH_TIMEOUT_SECONDS ) );
+	EXPECT_FALSE( cache.IsPrefetching( stuck + AppListCache::PREFETCH_TIMEOUT_SECONDS + 1.0 ) );
+	EXPECT_TRUE( cache.StartPrefetch( "host-c", stuck + AppListCache::PREFETCH_TIMEOUT_SECONDS + 1.0 ) );
+
+	// hosts that were only tried have no list and aren't written
+	Array<AppListEntry> apps;
+	EXPECT_FALSE( cache.Get( "host-b", apps ) );
+	EXPECT_EQ( 3, cache.GetNumHosts() );
+	const String path = TempPath();
+	ASSERT_TRUE( cache.Save( path.ToCStr() ) );
+	AppListCache loaded;
+	ASSERT_TRUE( loaded.Load( path.ToCStr() ) );
+	EXPECT_EQ( 1, loaded.GetNumHosts() );
+	unlink( path.ToCStr() );
+}
+
+TEST( AppListCache, DiffsById )
+{
+	Array<AppListEntry> shown = TwoApps();
+	shown.PushBack( App( 3, "Old game" ) );
+
+	Array<AppListEntry> fresh;
+	fresh.PushBack( App( 2, "Desktop" ) );			// the same
+	fresh.PushBack( App( 1, "Steam" ) );			// stopped, and moved
+	fresh.PushBack( App( 4, "New game" ) );
+	fresh.PushBack( App( 5, "Renamed", false ) );
+	shown.PushBack( App( 5, "Before" ) );
+
+	AppListDiff diff;
+	AppListCache::Diff( shown, fresh, diff );
+	ASSERT_EQ( 3, diff.Changed.GetSizeI() );
+	EXPECT_EQ( 1, diff.Changed[0].Id );
+	EXPECT_FALSE( diff.Changed[0].IsRunning );
+	EXPECT_EQ( 4, diff.Changed[1].Id );
+	EXPECT_EQ( 5, diff.Changed[2].Id );
+	EXPECT_STREQ( "Renamed", diff.Changed[2].Name.ToCStr() );
+	ASSERT_EQ( 1, diff.Removed.GetSizeI() );
+	EXPECT_EQ( 3, diff.Removed[0] );
+
+	AppListCache::Diff( fresh, fresh, diff );
+	EXPECT_TRUE( diff.IsEmpty() );
+}
+
+TEST( AppListCache, ParsesStandInLists )
+{
+	Array<AppListEntry> apps;
+	ASSERT_TRUE( AppListCache::ParseAppList( "# a stand-in host\r\n\n12 1 Steam Big Picture\r\n7 0 Desktop", apps ) );
+	ASSERT_EQ( 2, apps.GetSizeI() );
+	EXPECT_EQ( 12, apps[0].Id );
+	EXPECT_TRUE( apps[0].IsRunning );
+	EXPECT_STREQ( "Steam Big Picture", apps[0].Name.ToCStr() );
+	EXPECT_EQ( 7, apps[1].Id );
+	EXPECT_FALSE( apps[1].IsRunning );
+	EXPECT_STREQ( "Desktop", apps[1].Name.ToCStr() );
+
+	ASSERT_TRUE( AppListCache::ParseAppList( "", apps ) );
+	EXPECT_EQ( 0, apps.GetSizeI() );
+	EXPECT_FALSE( AppListCache::ParseAppList( NULL, apps ) );
+	EXPECT_FALSE( AppListCache::ParseAppList( "12 1\n", apps ) );
+	EXPECT_FALSE( AppListCache::ParseAppList( "Steam\n", apps ) );
+}
@@ -0,0 +1,294 @@
+/************************************************************************************
+
+Filename    :   AsyncLogTest.cpp
+Content     :	Host tests of the lock-free log ring, its packing and formatting
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "AsyncLog.h"
+
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <string>
+#include <vector>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+// Logs into a file of its own and hands back the text of each record,
+// the part after the time, thread, level and category columns.
+class LogFile
+{
+public:
+	LogFile()
+	{
+		char path[] = "/tmp/streamtheater_asynclogXXXXXX";
+		close( mkstemp( path ) );
+		Path = path;
+		AsyncLog::Start( Path.c_str() );
+	}
+
+	~LogFile()
+	{
+		AsyncLog::Stop();
+		unlink( Path.c_str() );
+	}
+
+	std::vector<std::string> Stop()
+	{
+		AsyncLog::Stop();
+		return Read();
+	}
+
+	std::vector<std::string> Read() const
+	{
+		std::vector<std::string> lines;
+		FILE * f = fopen( Path.c_str(), "r" );
+		if ( f == NULL )
+		{
+			return lines;
+		}
+		char line[2048];
+		while ( fgets( line, sizeof( line ), f ) != NULL )
+		{
+			std::string text( line );
+			if ( !text.empty() && text[text.size() - 1] == '\n' )
+			{
+				text.erase( text.size() - 1 );
+			}
+			// "%10.3f %5i %c %-8s "
+			lines.push_back( text.size() > 28 ? text.substr( 28 ) : std::string() );
+		}
+		fclose( f );
+		return lines;
+	}
+
+	// the drain thread sleeps when idle, give it time to catch up
+	bool WaitForLines( const size_t count ) const
+	{
+		for ( int i = 0; i < 500; i++ )
+		{
+			if ( Read().size() >= count )
+			{
+				return true;
+			}
+			usleep( 10000 );
+		}
+		return false;
+	}
+
+private:
+	std::string	Path;
+};
+
+std::string Printed( const char * format, ... ) __attribute__( ( format( printf, 1, 2 ) ) );
+
+std::string Printed( const char * format, ... )
+{
+	char text[1024];
+	va_list args;
+	va_start( args, format );
+	vsnprintf( text, sizeof( text ), format, args );
+	va_end( args );
+	return text;
+}
+
+struct WriterParms
+{
+	int		Thread;
+	int		Count;
+};
+
+void * WriterThread( void * param )
+{
+	const WriterParms & parms = *(const WriterParms *)param;
+	for ( int i = 0; i < parms.Count; i++ )
+	{
+		AsyncLog::Write( LOG_CATEGORY_APP, LOG_LEVEL_INFO, "writer %i record %i", parms.Thread, i );
+	}
+	return NULL;
+}
+
+}
+
+// More records than the ring holds go through it in order, as long as the
+// drain keeps up
+TEST( AsyncLog, WrapsAroundTheRing )
+{
+	const int dropped = AsyncLog::GetDropped();
+	LogFile log;
+
+	const int batch = AsyncLog::NUM_RECORDS / 2;
+	int written = 0;
+	for ( int round = 0; round < 5; round++ )
+	{
+		for ( int i = 0; i < batch; i++ )
+		{
+			AsyncLog::Write( LOG_CATEGORY_APP, LOG_LEVEL_INFO, "record %i", written++ );
+		}
+		ASSERT_TRUE( log.WaitForLines( written ) );
+	}
+
+	const std::vector<std::string> lines = log.Stop();
+	ASSERT_EQ( (size_t)written, lines.size() );
+	for ( int i = 0; i < written; i++ )
+	{
+		EXPECT_EQ( Printed( "record %i", i ), lines[i] );
+	}
+	EXPECT_EQ( dropped, AsyncLog::GetDropped() );
+}
+
+// A writer never waits: what doesn't fit is counted, everything else
+// comes out, and nothing claimed is lost at Stop
+TEST( AsyncLog, DropsWhenFull )
+{
+	const int dropped = AsyncLog::GetDropped();
+	LogFile log;
+
+	const int count = AsyncLog::NUM_RECORDS * 64;
+	for ( int i = 0; i < count; i++ )
+	{
+		AsyncLog::Write( LOG_CATEGORY_APP, LOG_LEVEL_INFO, "record %i", i );
+	}
+	const std::vector<std::string> lines = log.Stop();
+	const int lost = AsyncLog::GetDropped() - dropped;
+
+	EXPECT_GT( lost, 0 );
+	EXPECT_EQ( count, (int)lines.size() + lost );
+
+	// the ones that made it are still in order
+	int last = -1;
+	for ( size_t i = 0; i < lines.size(); i++ )
+	{
+		int value = -1;
+		ASSERT_EQ( 1, sscanf( lines[i].c_str(), "record %i", &value ) );
+		EXPECT_GT( value, last );
+		last = value;
+	}
+}
+
+// Fewer records than the ring holds, so none are dropped whatever the
+// drain does, and each thread's come out in its order
+TEST( AsyncLog, TakesConcurrentWriters )
+{
+	const int dropped = AsyncLog::GetDropped();
+	LogFile log;
+
+	static const int THREADS = 4;
+	const int perThread = AsyncLog::NUM_RECORDS / THREADS - 8;
+	pthread_t threads[THREADS];
+	WriterParms parms[THREADS];
+	for ( int i = 0; i < THREADS; i++ )
+	{
+		parms[i].Thread = i;
+		parms[i].Count = perThread;
+		ASSERT_EQ( 0, pthread_create( &threads[i], NULL, WriterThread, &parms[i] ) );
+	}
+	for ( int i = 0; i < THREADS; i++ )
+	{
+		pthread_join( threads[i], NULL );
+	}
+
+	const std::vector<std::string> lines = log.Stop();
+	ASSERT_EQ( (size_t)( THREADS * perThread ), lines.size() );
+	EXPECT_EQ( dropped, AsyncLog::GetDropped() );
+
+	int next[THREADS] = {};
+	for ( size_t i = 0; i < lines.size(); i++ )
+	{
+		int thread = -1;
+		int record = -1;
+		ASSERT_EQ( 2, sscanf( lines[i].c_str(), "writer %i record %i", &thread, &record ) );
+		ASSERT_TRUE( thread >= 0 && thread < THREADS );
+		EXPECT_EQ( next[thread], record );
+		next[thread] = record + 1;
+	}
+}
+
+// Strings are copied by value, 64-bit and floating point arguments keep
+// their width, '*' takes its int
+TEST( AsyncLog, PacksStringsAndWideArguments )
+{
+	LogFile log;
+
+	char name[16];
+	strcpy( name, "theater" );
+	const long long big = -( 1LL << 40 ) - 3;
+	const unsigned long long biggest = ULLONG_MAX;
+	const size_t size = (size_t)1 << 33;
+	AsyncLog::Write( LOG_CATEGORY_SCENE, LOG_LEVEL_INFO, "%s %lld %llu %zu %.*f %c %5.1f%%", name, big, biggest, size, 3, 2.5, 'x', 99.25 );
+	strcpy( name, "changed" );		// after the write, the record has its own copy
+	AsyncLog::Write( LOG_CATEGORY_SCENE, LOG_LEVEL_INFO, "%s|%-6s|%s", (const char *)NULL, "ab", "" );
+
+	const std::vector<std::string> lines = log.Stop();
+	ASSERT_EQ( 2u, lines.size() );
+	EXPECT_EQ( Printed( "%s %lld %llu %zu %.*f %c %5.1f%%", "theater", big, biggest, size, 3, 2.5, 'x', 99.25 ), lines[0] );
+	EXPECT_EQ( "(null)|ab    |", lines[1] );
+}
+
+// A record whose arguments don't fit keeps what did and says it was cut
+TEST( AsyncLog, TruncatesAtTheRecordSize )
+{
+	LogFile log;
+
+	const std::string longText( AsyncLog::RECORD_BYTES + 44, 'x' );
+	AsyncLog::Write( LOG_CATEGORY_APP, LOG_LEVEL_INFO, "%s %i", longText.c_str(), 5 );
+	AsyncLog::Write( LOG_CATEGORY_APP, LOG_LEVEL_INFO,
+			"%lld %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld "
+			"%lld %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld %lld",
+			0LL, 1LL, 2LL, 3LL, 4LL, 5LL, 6LL, 7LL, 8LL, 9LL, 10LL, 11LL, 12LL, 13LL, 14LL, 15LL,
+			16LL, 17LL, 18LL, 19LL, 20LL, 21LL, 22LL, 23LL, 24LL, 25LL, 26LL, 27LL, 28LL, 29LL, 30LL, 31LL );
+
+	const std::vector<std::string> lines = log.Stop();
+	ASSERT_EQ( 2u, lines.size() );
+
+	// the header takes 32 of the record's bytes, the string keeps its terminator
+	const int argBytes = AsyncLog::RECORD_BYTES - 32;
+	EXPECT_EQ( longText.substr( 0, argBytes - 1 ) + "  ...", lines[0] );
+
+	std::string numbers;
+	for ( int i = 0; i < argBytes / 8; i++ )
+	{
+		numbers += Printed( "%i ", i );
+	}
+	EXPECT_EQ( numbers + " ...", lines[1] );
+}
+
+TEST( AsyncLog, ParsesLevels )
+{
+	LogLevel saved[LOG_CATEGORY_MAX];
+	for ( int i = 0; i < LOG_CATEGORY_MAX; i++ )
+	{
+		saved[i] = AsyncLog::GetLevel( (LogCategory)i );
+	}
+
+	// later entries win, "=" works like ":", unknown names and levels are skipped
+	AsyncLog::ParseLevels( "all:warn,scene:debug, native=verbose,bogus:error,menus:loud,stream:error" );
+	EXPECT_EQ( LOG_LEVEL_WARN, AsyncLog::GetLevel( LOG_CATEGORY_APP ) );
+	EXPECT_EQ( LOG_LEVEL_DEBUG, AsyncLog::GetLevel( LOG_CATEGORY_SCENE ) );
+	EXPECT_EQ( LOG_LEVEL_VERBOSE, AsyncLog::GetLevel( LOG_CATEGORY_NATIVE ) );
+	EXPECT_EQ( LOG_LEVEL_WARN, AsyncLog::GetLevel( LOG_CATEGORY_SETTINGS ) );
+	EXPECT_EQ( LOG_LEVEL_WARN, AsyncLog::GetLevel( LOG_CATEGORY_MENUS ) );
+	EXPECT_EQ( LOG_LEVEL_ERROR, AsyncLog::GetLevel( LOG_CATEGORY_STREAM ) );
+	EXPECT_TRUE( AsyncLog::IsEnabled( LOG_CATEGORY_SCENE, LOG_LEVEL_DEBUG ) );
+	EXPECT_FALSE( AsyncLog::IsEnabled( LOG_CATEGORY_APP, LOG_LEVEL_INFO ) );
+
+	for ( int i = 0; i < LOG_CATEGORY_MAX; i++ )
+	{
+		AsyncLog::SetLevel( (LogCategory)i, saved[i] );
+	}
+}
@@ -0,0 +1,318 @@
+/************************************************************************************
+
+Filename    :   AudioSinkTest.cpp
+Content     :	Host tests of the PCM ring, the audio sink and the null backend
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "nv_pcm_ring.h"
+#include "ManualAudioBackend.h"
+
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace {
+
+static const int SAMPLE_RATE = 48000;
+static const int CHANNELS = 2;
+static const int FRAMES_PER_BUFFER = 240;		// 5 ms
+static const int TARGET_MS = 30;
+
+// the producer writes a counter in uneven pieces
+struct RingProducer
+{
+	nv_pcm_ring *	Ring;
+	unsigned int	Frames;
+
+	static void * Run( void *arg )
+	{
+		RingProducer *producer = (RingProducer *)arg;
+		short pcm[97 * CHANNELS];
+		unsigned int next = 0;
+		unsigned int seed = 3;
+		while ( next < producer->Frames )
+		{
+			seed = seed * 1103515245u + 12345u;
+			int want = 1 + (int)( ( seed >> 16 ) % 97 );
+			if ( want > (int)( producer->Frames - next ) )
+			{
+				want = producer->Frames - next;
+			}
+			for ( int i = 0; i < want; i++ )
+			{
+				pcm[i * CHANNELS] = (short)( next + i );
+				pcm[i * CHANNELS + 1] = (short)~( next + i );
+			}
+			next += nv_pcm_ring_write( producer->Ring, pcm, want );
+		}
+		return NULL;
+	}
+};
+
+nv_audio_sink * CreateSink( ManualAudioBackend **backend )
+{
+	*backend = ManualAudioBackend::Create();
+	nv_audio_sink *sink = nv_audio_sink_create( &( *backend )->Base, SAMPLE_RATE, CHANNELS, FRAMES_PER_BUFFER, TARGET_MS );
+	EXPECT_EQ( 0, nv_audio_sink_start( sink ) );
+	return sink;
+}
+
+nv_audio_sink_stats Stats( const nv_audio_sink *sink )
+{
+	nv_audio_sink_stats stats;
+	nv_audio_sink_get_stats( sink, &stats );
+	return stats;
+}
+
+unsigned int ReadLe( const unsigned char *in, const int bytes )
+{
+	unsigned int value = 0;
+	for ( int i = bytes - 1; i >= 0; i-- )
+	{
+		value = ( value << 8 ) | in[i];
+	}
+	return value;
+}
+
+// counts the callbacks and renders a counter
+struct CountingRender
+{
+	int				Calls;
+	unsigned short	Next;
+
+	static void Render( void *context, short *pcm, int frames )
+	{
+		CountingRender *render = (CountingRender *)context;
+		__atomic_fetch_add( &render->Calls, 1, __ATOMIC_RELAXED );
+		for ( int i = 0; i < frames * CHANNELS; i++ )
+		{
+			pcm[i] = (short)render->Next++;
+		}
+	}
+};
+
+}
+
+TEST( PcmRing, CapacityIsAPowerOfTwo )
+{
+	nv_pcm_ring *ring = nv_pcm_ring_create( CHANNELS, 1000 );
+	ASSERT_TRUE( ring != NULL );
+	EXPECT_EQ( 1024, nv_pcm_ring_get_capacity( ring ) );
+	nv_pcm_ring_destroy( ring );
+}
+
+TEST( PcmRing, WritesStopWhenFullAndSkipsDrop )
+{
+	nv_pcm_ring *ring = nv_pcm_ring_create( CHANNELS, 64 );
+	std::vector<short> pcm( 100 * CHANNELS );
+	for ( size_t i = 0; i < pcm.size(); i++ )
+	{
+		pcm[i] = (short)i;
+	}
+	EXPECT_EQ( 64, nv_pcm_ring_write( ring, &pcm[0], 100 ) );
+	EXPECT_EQ( 0, nv_pcm_ring_write( ring, &pcm[0], 1 ) );
+	EXPECT_EQ( 64, nv_pcm_ring_get_level( ring ) );
+
+	EXPECT_EQ( 10, nv_pcm_ring_skip( ring, 10 ) );
+	std::vector<short> out( 100 * CHANNELS );
+	EXPECT_EQ( 54, nv_pcm_ring_read( ring, &out[0], 100 ) );
+	EXPECT_EQ( 10 * CHANNELS, out[0] );
+	EXPECT_EQ( 63 * CHANNELS + 1, out[53 * CHANNELS + 1] );
+	EXPECT_EQ( 0, nv_pcm_ring_get_level( ring ) );
+	EXPECT_EQ( 0, nv_pcm_ring_skip( ring, 1 ) );
+	nv_pcm_ring_destroy( ring );
+}
+
+TEST( PcmRing, FramesComeOutInOrderAcrossThreads )
+{
+	RingProducer producer = { nv_pcm_ring_create( CHANNELS, 1000 ), 200000 };
+	pthread_t thread;
+	pthread_create( &thread, NULL, RingProducer::Run, &producer );
+
+	short pcm[131 * CHANNELS];
+	unsigned int next = 0;
+	unsigned int seed = 5;
+	while ( next < producer.Frames )
+	{
+		seed = seed * 1103515245u + 12345u;
+		const int got = nv_pcm_ring_read( producer.Ring, pcm, 1 + (int)( ( seed >> 16 ) % 131 ) );
+		for ( int i = 0; i < got; i++ )
+		{
+			if ( pcm[i * CHANNELS] != (short)( next + i ) || pcm[i * CHANNELS + 1] != (short)~( next + i ) )
+			{
+				FAIL() << "frame " << next + i << " out of order";
+			}
+		}
+		next += got;
+	}
+	pthread_join( thread, NULL );
+	EXPECT_EQ( 0, nv_pcm_ring_get_level( producer.Ring ) );
+	nv_pcm_ring_destroy( producer.Ring );
+}
+
+TEST( AudioSink, PlaysNothingUntilTheTargetIsThere )
+{
+	ManualAudioBackend *backend;
+	nv_audio_sink *sink = CreateSink( &backend );
+	const int target = SAMPLE_RATE * TARGET_MS / 1000;
+	EXPECT_EQ( target, Stats( sink ).target_level );
+
+	std::vector<short> in( FRAMES_PER_BUFFER * CHANNELS, 1000 );
+	std::vector<short> out( FRAMES_PER_BUFFER * CHANNELS, -1 );
+	nv_audio_sink_write( sink, &in[0], FRAMES_PER_BUFFER );
+	backend->Render( &out[0], FRAMES_PER_BUFFER );
+	EXPECT_EQ( std::vector<short>( out.size(), 0 ), out );
+	EXPECT_EQ( 0u, Stats( sink ).underruns );
+
+	for ( int written = FRAMES_PER_BUFFER; written < target; written += FRAMES_PER_BUFFER )
+	{
+		nv_audio_sink_write( sink, &in[0], FRAMES_PER_BUFFER );
+	}
+	backend->Render( &out[0], FRAMES_PER_BUFFER );
+	EXPECT_EQ( in, out );
+	EXPECT_EQ( 0, Stats( sink ).ratio_ppm );
+	nv_audio_sink_destroy( sink );
+}
+
+TEST( AudioSink, AnUnderrunPlaysSilenceAndFillsUpAgain )
+{
+	ManualAudioBackend *backend;
+	nv_audio_sink *sink = CreateSink( &backend );
+	const int target = SAMPLE_RATE * TARGET_MS / 1000;
+
+	std::vector<short> in( FRAMES_PER_BUFFER * CHANNELS, 1000 );
+	std::vector<short> out( FRAMES_PER_BUFFER * CHANNELS );
+	for ( int written = 0; written < target; written += FRAMES_PER_BUFFER )
+	{
+		nv_audio_sink_write( sink, &in[0], FRAMES_PER_BUFFER );
+	}
+	for ( int played = 0; played <= target; played += FRAMES_PER_BUFFER )
+	{
+		backend->Render( &out[0], FRAMES_PER_BUFFER );
+	}
+	nv_audio_sink_stats stats = Stats( sink );
+	EXPECT_EQ( 1u, stats.underruns );
+	EXPECT_GT( stats.underrun_frames, 0u );
+	EXPECT_EQ( 0, out.back() );
+
+	// a frame isn't enough to play again
+	nv_audio_sink_write( sink, &in[0], FRAMES_PER_BUFFER );
+	backend->Render( &out[0], FRAMES_PER_BUFFER );
+	EXPECT_EQ( 1u, Stats( sink ).underruns );
+	EXPECT_EQ( FRAMES_PER_BUFFER, Stats( sink ).level );
+	nv_audio_sink_destroy( sink );
+}
+
+TEST( AudioSink, WritesPastTheRingAreOverruns )
+{
+	ManualAudioBackend *backend;
+	nv_audio_sink *sink = CreateSink( &backend );
+	std::vector<short> in( FRAMES_PER_BUFFER * CHANNELS );
+	int written = 0;
+	for ( int i = 0; i < 100; i++ )
+	{
+		written += nv_audio_sink_write( sink, &in[0], FRAMES_PER_BUFFER );
+	}
+	const nv_audio_sink_stats stats = Stats( sink );
+	EXPECT_GT( stats.overruns, 0u );
+	EXPECT_EQ( 100u * FRAMES_PER_BUFFER, written + stats.overrun_frames );
+	nv_audio_sink_destroy( sink );
+}
+
+// A device clock 0.2% off either way is taken up by resampling; without it
+// the ring would run dry or overflow several times a minute.
+TEST( AudioSink, ClockDriftIsAbsorbed )
+{
+	const int offsets[] = { 2000, -2000 };
+	for ( int i = 0; i < 2; i++ )
+	{
+		ManualAudioBackend *backend;
+		nv_audio_sink *sink = CreateSink( &backend );
+		RunClocks( sink, backend, SAMPLE_RATE, offsets[i], 60 );
+
+		const nv_audio_sink_stats stats = Stats( sink );
+		EXPECT_EQ( 0u, stats.underruns ) << offsets[i] << " ppm";
+		EXPECT_EQ( 0u, stats.overruns ) << offsets[i] << " ppm";
+		// the device going fast has to be fed slower, and the other way
+		EXPECT_LT( stats.ratio_ppm * offsets[i], 0 ) << offsets[i] << " ppm";
+		EXPECT_NEAR( stats.target_level, stats.level, stats.target_level / 2 ) << offsets[i] << " ppm";
+		nv_audio_sink_destroy( sink );
+	}
+}
+
+TEST( AudioSink, StartFailsWithoutTheBackend )
+{
+	EXPECT_EQ( NULL, nv_audio_sink_create( NULL, SAMPLE_RATE, CHANNELS, FRAMES_PER_BUFFER, TARGET_MS ) );
+	// the backend is taken even when the sink isn't made
+	EXPECT_EQ( NULL, nv_audio_sink_create( &ManualAudioBackend::Create()->Base, SAMPLE_RATE, 0, FRAMES_PER_BUFFER, TARGET_MS ) );
+}
+
+TEST( NullAudioBackend, WritesWhatItRendersToAWav )
+{
+	char path[] = "/tmp/streamtheater_sinkXXXXXX";
+	close( mkstemp( path ) );
+
+	// ten times faster than real time, so 50 ms are about 24000 frames
+	nv_audio_backend *backend = nv_audio_backend_null_create( path, 10.0 );
+	CountingRender render = { 0, 0 };
+	ASSERT_EQ( 0, backend->start( backend, SAMPLE_RATE, CHANNELS, FRAMES_PER_BUFFER, CountingRender::Render, &render ) );
+	usleep( 50000 );
+	backend->stop( backend );
+	const int calls = render.Calls;
+	backend->destroy( backend );
+	EXPECT_GT( calls, 10 );
+
+	FILE *wav = fopen( path, "rb" );
+	ASSERT_TRUE( wav != NULL );
+	unsigned char header[44];
+	ASSERT_EQ( sizeof( header ), fread( header, 1, sizeof( header ), wav ) );
+	EXPECT_EQ( 0, memcmp( header, "RIFF", 4 ) );
+	EXPECT_EQ( 0, memcmp( header + 8, "WAVEfmt ", 8 ) );
+	EXPECT_EQ( 0, memcmp( header + 36, "data", 4 ) );
+	EXPECT_EQ( 1u, ReadLe( header + 20, 2 ) );
+	EXPECT_EQ( (unsigned)CHANNELS, ReadLe( header + 22, 2 ) );
+	EXPECT_EQ( (unsigned)SAMPLE_RATE, ReadLe( header + 24, 4 ) );
+
+	const unsigned int dataSize = ReadLe( header + 40, 4 );
+	EXPECT_EQ( 36 + dataSize, ReadLe( header + 4, 4 ) );
+	EXPECT_EQ( (unsigned)calls * FRAMES_PER_BUFFER * CHANNELS * 2, dataSize );
+
+	std::vector<short> data( dataSize / 2 );
+	ASSERT_EQ( dataSize, fread( &data[0], 1, dataSize, wav ) );
+	EXPECT_EQ( 0, fgetc( wav ) == EOF ? 0 : 1 );
+	fclose( wav );
+	unlink( path );
+
+	for ( size_t i = 0; i < data.size(); i++ )
+	{
+		if ( data[i] != (short)i )
+		{
+			FAIL() << "sample " << i << " is " << data[i];
+		}
+	}
+}
+
+TEST( NullAudioBackend, PacesTheCallbacksByTheClock )
+{
+	nv_audio_backend *backend = nv_audio_backend_null_create( NULL, 1.0 );
+	CountingRender render = { 0, 0 };
+	ASSERT_EQ( 0, backend->start( backend, SAMPLE_RATE, CHANNELS, FRAMES_PER_BUFFER, CountingRender::Render, &render ) );
+	usleep( 200000 );
+	backend->stop( backend );
+	backend->destroy( backend );
+
+	// 40 callbacks of 5 ms, give or take a loaded machine
+	EXPECT_GE( render.Calls, 20 );
+	EXPECT_LE( render.Calls, 45 );
+}
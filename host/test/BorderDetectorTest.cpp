@@ -0,0 +1,147 @@
+/************************************************************************************
+
+Filename    :   BorderDetectorTest.cpp
+Content     :	Host tests of the letterbox and pillarbox detector
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "BorderDetector.h"
+#include "SyntheticFrames.h"
+
+#include <gtest/gtest.h>
+
+using namespace VRMatterStreamTheater;
+using namespace SyntheticFrames;
+
+namespace {
+
+// samples of a 1080p stream
+static const int WIDTH = 480;
+static const int HEIGHT = 270;
+
+// a 2.39:1 movie in a 16:9 stream
+static const float LETTERBOX = ( 1.0f - ( 16.0f / 9.0f ) / 2.39f ) / 2.0f;
+
+// blacks out columns at either side, a 4:3 picture in a 16:9 stream
+void Pillarbox( std::vector<unsigned char> & rgba, const int width, const int height, const int bar )
+{
+	for ( int y = 0; y < height; y++ )
+	{
+		for ( int x = 0; x < width; x++ )
+		{
+			if ( x < bar || x >= width - bar )
+			{
+				unsigned char * p = &rgba[( y * width + x ) * 4];
+				p[0] = p[1] = p[2] = 0;
+			}
+		}
+	}
+}
+
+}
+
+TEST( BorderDetector, FindsTheBars )
+{
+	for ( unsigned int seed = 1; seed <= 8; seed++ )
+	{
+		const std::vector<unsigned char> letterbox = Render( Scene( seed ), LAYOUT_MONO, WIDTH, HEIGHT, 0.0f, 0.0f, LETTERBOX );
+		const ContentRect picture = BorderDetector::FindPicture( &letterbox[0], WIDTH, HEIGHT );
+		EXPECT_EQ( 0.0f, picture.X0 ) << seed;
+		EXPECT_EQ( 1.0f, picture.X1 ) << seed;
+		EXPECT_NEAR( LETTERBOX, picture.Y0, 1.0f / HEIGHT ) << seed;
+		EXPECT_NEAR( 1.0f - LETTERBOX, picture.Y1, 1.0f / HEIGHT ) << seed;
+
+		std::vector<unsigned char> pillarbox = Render( Scene( seed ), LAYOUT_MONO, WIDTH, HEIGHT );
+		Pillarbox( pillarbox, WIDTH, HEIGHT, WIDTH / 8 );
+		const ContentRect pillar = BorderDetector::FindPicture( &pillarbox[0], WIDTH, HEIGHT );
+		EXPECT_EQ( 60.0f / WIDTH, pillar.X0 ) << seed;
+		EXPECT_EQ( 420.0f / WIDTH, pillar.X1 ) << seed;
+		EXPECT_EQ( 0.0f, pillar.Y0 ) << seed;
+		EXPECT_EQ( 1.0f, pillar.Y1 ) << seed;
+	}
+}
+
+// the vector loop's tail and a lone lit pixel anywhere
+TEST( BorderDetector, SeesOnePixel )
+{
+	const int width = 77;
+	const int height = 37;
+	std::vector<unsigned char> rgba( width * height * 4, 16 );
+	const int points[][2] = { { 0, 0 }, { 76, 36 }, { 72, 3 }, { 7, 20 }, { 40, 0 } };
+	for ( size_t i = 0; i < sizeof( points ) / sizeof( points[0] ); i++ )
+	{
+		const int x = points[i][0];
+		const int y = points[i][1];
+		rgba[( y * width + x ) * 4 + 1] = 60;
+		const ContentRect picture = BorderDetector::FindPicture( &rgba[0], width, height );
+		EXPECT_EQ( (float)x / width, picture.X0 ) << i;
+		EXPECT_EQ( (float)( x + 1 ) / width, picture.X1 ) << i;
+		EXPECT_EQ( (float)y / height, picture.Y0 ) << i;
+		EXPECT_EQ( (float)( y + 1 ) / height, picture.Y1 ) << i;
+		rgba[( y * width + x ) * 4 + 1] = 16;
+	}
+	EXPECT_TRUE( BorderDetector::FindPicture( &rgba[0], width, height ).IsEmpty() );
+}
+
+TEST( BorderDetector, CropsOnceSettled )
+{
+	const std::vector<unsigned char> letterbox = Render( Scene( 3 ), LAYOUT_MONO, WIDTH, HEIGHT, 0.0f, 0.0f, LETTERBOX );
+	BorderDetector detector;
+	for ( int i = 0; i < 9; i++ )
+	{
+		EXPECT_FALSE( detector.AddSample( &letterbox[0], WIDTH, HEIGHT ) );
+		EXPECT_EQ( 1.0f, detector.GetCrop().Area() );
+	}
+	EXPECT_TRUE( detector.AddSample( &letterbox[0], WIDTH, HEIGHT ) );
+	EXPECT_NEAR( LETTERBOX, detector.GetCrop().Y0, 1.0f / HEIGHT );
+	EXPECT_NEAR( 1.0f - LETTERBOX, detector.GetCrop().Y1, 1.0f / HEIGHT );
+
+	// the same picture again changes nothing
+	for ( int i = 0; i < 20; i++ )
+	{
+		EXPECT_FALSE( detector.AddSample( &letterbox[0], WIDTH, HEIGHT ) );
+	}
+
+	// a full frame opens it at once, and the next crop waits twice as long
+	const std::vector<unsigned char> full = Render( Scene( 4 ), LAYOUT_MONO, WIDTH, HEIGHT );
+	EXPECT_TRUE( detector.AddSample( &full[0], WIDTH, HEIGHT ) );
+	EXPECT_EQ( 1.0f, detector.GetCrop().Area() );
+	for ( int i = 0; i < 19; i++ )
+	{
+		EXPECT_FALSE( detector.AddSample( &letterbox[0], WIDTH, HEIGHT ) );
+	}
+	EXPECT_TRUE( detector.AddSample( &letterbox[0], WIDTH, HEIGHT ) );
+	EXPECT_LT( detector.GetCrop().Area(), 0.8f );
+
+	detector.Reset();
+	EXPECT_EQ( 1.0f, detector.GetCrop().Area() );
+}
+
+TEST( BorderDetector, LeavesAloneWhatItCantJudge )
+{
+	BorderDetector detector;
+
+	// a dark scene is a small picture, not a crop
+	EXPECT_FALSE( detector.AddPicture( ContentRect( 0.4f, 0.4f, 0.6f, 0.6f ) ) );
+
+	// thin bars aren't worth it
+	for ( int i = 0; i < 10; i++ )
+	{
+		EXPECT_FALSE( detector.AddPicture( ContentRect( 0.0f, 0.01f, 1.0f, 0.99f ) ) );
+	}
+
+	// black and too big samples have no picture
+	const std::vector<unsigned char> black( WIDTH * HEIGHT * 4, 0 );
+	EXPECT_FALSE( detector.AddSample( &black[0], WIDTH, HEIGHT ) );
+	const int wide = BorderDetector::MAX_SAMPLE_SIZE + 1;
+	const std::vector<unsigned char> wideFrame( wide * 4 * 4, 200 );
+	EXPECT_TRUE( BorderDetector::FindPicture( &wideFrame[0], wide, 4 ).IsEmpty() );
+	EXPECT_EQ( 1.0f, detector.GetCrop().Area() );
+}
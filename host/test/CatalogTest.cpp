@@ -0,0 +1,148 @@
+/************************************************************************************
+
+Filename    :   CatalogTest.cpp
+Content     :	Host tests of the host and app list bookkeeping
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "Catalog.h"
+
+#include <gtest/gtest.h>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+void DeleteAll( Array<PcDef *> &defs )
+{
+	for ( int i = 0; i < defs.GetSizeI(); i++ )
+	{
+		delete defs[i];
+	}
+	defs.Clear();
+}
+
+void DeleteAll( Array<AppDef *> &defs )
+{
+	for ( int i = 0; i < defs.GetSizeI(); i++ )
+	{
+		delete defs[i];
+	}
+	defs.Clear();
+}
+
+}
+
+TEST( Catalog, UpdatePcAddsThenUpdatesByName )
+{
+	Array<PcDef *> pcs;
+	bool isNew = false;
+
+	PcDef *pc = Catalog::UpdatePc( pcs, "Desk", "uuid-1", HostState::NOT_PAIRED, HostState::LOCAL, "", false, isNew );
+	EXPECT_TRUE( isNew );
+	ASSERT_EQ( 1, pcs.GetSizeI() );
+
+	PcDef *again = Catalog::UpdatePc( pcs, "DESK", "uuid-1", HostState::PAIRED, HostState::REMOTE, "b", true, isNew );
+	EXPECT_FALSE( isNew );
+	EXPECT_EQ( pc, again );
+	EXPECT_EQ( 1, pcs.GetSizeI() );
+	EXPECT_EQ( HostState::PAIRED, pc->PairState );
+	EXPECT_TRUE( pc->isRemote );
+	EXPECT_TRUE( pc->isRunning );
+	EXPECT_STREQ( "DESK", pc->Name.ToCStr() );
+
+	DeleteAll( pcs );
+}
+
+TEST( Catalog, RemovePcTakesTheNamedHost )
+{
+	Array<PcDef *> pcs;
+	bool isNew;
+	Catalog::UpdatePc( pcs, "A", "1", HostState::PAIRED, HostState::LOCAL, "", false, isNew );
+	PcDef *b = Catalog::UpdatePc( pcs, "B", "2", HostState::PAIRED, HostState::LOCAL, "", false, isNew );
+	Catalog::UpdatePc( pcs, "C", "3", HostState::PAIRED, HostState::LOCAL, "", false, isNew );
+
+	PcDef *removed = Catalog::RemovePc( pcs, "b" );
+	EXPECT_EQ( b, removed );
+	ASSERT_EQ( 2, pcs.GetSizeI() );
+	EXPECT_STREQ( "A", pcs[0]->Name.ToCStr() );
+	EXPECT_STREQ( "C", pcs[1]->Name.ToCStr() );
+	delete removed;
+
+	EXPECT_EQ( NULL, Catalog::RemovePc( pcs, "missing" ) );
+	EXPECT_EQ( 2, pcs.GetSizeI() );
+
+	DeleteAll( pcs );
+}
+
+TEST( Catalog, UpdateAppPrefersTheId )
+{
+	Array<AppDef *> apps;
+	bool isNew;
+	AppDef *steam = Catalog::UpdateApp( apps, "Steam", "steam.png", 1, false, isNew );
+	AppDef *desktop = Catalog::UpdateApp( apps, "Desktop", "desktop.png", 2, false, isNew );
+
+	// the id wins over a name another app has
+	AppDef *byId = Catalog::UpdateApp( apps, "Desktop", "big.png", 1, true, isNew );
+	EXPECT_FALSE( isNew );
+	EXPECT_EQ( steam, byId );
+	EXPECT_EQ( 2, desktop->Id );
+	Catalog::UpdateApp( apps, "Steam", "steam.png", 1, false, isNew );
+
+	// no id match, found by name
+	AppDef *byName = Catalog::UpdateApp( apps, "desktop", "d.png", 7, false, isNew );
+	EXPECT_FALSE( isNew );
+	EXPECT_EQ( desktop, byName );
+	EXPECT_EQ( 7, desktop->Id );
+
+	Catalog::UpdateApp( apps, "Game", "game.png", 3, false, isNew );
+	EXPECT_TRUE( isNew );
+	EXPECT_EQ( 3, apps.GetSizeI() );
+
+	DeleteAll( apps );
+}
+
+TEST( Catalog, RemoveAppMovesEveryMatch )
+{
+	Array<AppDef *> apps;
+	Array<AppDef *> removed;
+	bool isNew;
+	Catalog::UpdateApp( apps, "A", "", 1, false, isNew );
+	Catalog::UpdateApp( apps, "B", "", 2, false, isNew );
+	apps.PushBack( new AppDef() );
+	apps.Back()->Id = 1;
+
+	EXPECT_EQ( 2, Catalog::RemoveApp( apps, 1, removed ) );
+	ASSERT_EQ( 1, apps.GetSizeI() );
+	EXPECT_EQ( 2, apps[0]->Id );
+	EXPECT_EQ( 2, removed.GetSizeI() );
+	EXPECT_EQ( 0, Catalog::RemoveApp( apps, 1, removed ) );
+
+	DeleteAll( apps );
+	DeleteAll( removed );
+}
+
+TEST( Catalog, ListCategorySkipsPosterlessDefs )
+{
+	Array<AppDef *> apps;
+	bool isNew;
+	Catalog::UpdateApp( apps, "A", "", 1, false, isNew )->Poster = 5;
+	Catalog::UpdateApp( apps, "B", "", 2, false, isNew );
+	AppDef *vnc = Catalog::UpdateApp( apps, "C", "", 3, false, isNew );
+	vnc->Poster = 6;
+	vnc->Category = CATEGORY_VNC;
+
+	Array<const PcDef *> list = Catalog::ListCategory( apps, CATEGORY_LIMELIGHT );
+	ASSERT_EQ( 1, list.GetSizeI() );
+	EXPECT_EQ( 1, list[0]->Id );
+	EXPECT_EQ( 1, Catalog::ListCategory( apps, CATEGORY_VNC ).GetSizeI() );
+
+	DeleteAll( apps );
+}
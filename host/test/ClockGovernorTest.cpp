@@ -0,0 +1,205 @@
+/************************************************************************************
+
+Filename    :   ClockGovernorTest.cpp
+Content     :	Host tests of the clock level governor on synthetic telemetry
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ClockGovernor.h"
+
+#include <gtest/gtest.h>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+ClockSample Window( const float gpuMs, const float missedFraction )
+{
+	ClockSample window;
+	window.GpuMs = gpuMs;
+	window.MissedFrameFraction = missedFraction;
+	return window;
+}
+
+const ClockSample IDLE = Window( 5.0f, 0.0f );
+const ClockSample GPU_BOUND = Window( 12.0f, 0.1f );
+const ClockSample CPU_BOUND = Window( 6.0f, 0.1f );
+const ClockSample BUSY = Window( 9.0f, 0.0f );		// neither missing frames nor idle
+
+// Feeds a window a second until the levels change, returns how many it
+// took, -1 if they didn't within max
+int WindowsToChange( ClockGovernor & governor, double & now, const ClockSample & window, const int max,
+		const bool contentStatic = false )
+{
+	for ( int i = 1; i <= max; i++ )
+	{
+		now += 1.0;
+		if ( governor.Update( &window, contentStatic, false, now ) )
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+}
+
+TEST( ClockGovernor, BurstsRaiseUntilTheyRunOut )
+{
+	ClockGovernor governor;
+	governor.Reset( ClockLevels( 1, 2 ), 0.0 );
+	EXPECT_STREQ( "start", governor.GetReason() );
+
+	governor.Burst( CLOCK_BURST_SCENE_LOAD, 0.0 );
+	ASSERT_TRUE( governor.Update( NULL, false, false, 0.0 ) );
+	EXPECT_EQ( ClockLevels( 3, 2 ), governor.GetLevels() );
+	EXPECT_STREQ( "scene load", governor.GetReason() );
+	EXPECT_FALSE( governor.Update( NULL, false, false, 1.9 ) );
+	ASSERT_TRUE( governor.Update( NULL, false, false, 2.0 ) );
+	EXPECT_EQ( ClockLevels( 1, 2 ), governor.GetLevels() );
+	EXPECT_STREQ( "burst over", governor.GetReason() );
+
+	// overlapping bursts take the highest of each, starting one again extends it
+	governor.Burst( CLOCK_BURST_POSTERS, 10.0 );
+	governor.Burst( CLOCK_BURST_STREAM_START, 10.0 );
+	ASSERT_TRUE( governor.Update( NULL, false, false, 10.0 ) );
+	EXPECT_EQ( ClockLevels( 3, 3 ), governor.GetLevels() );
+	governor.Burst( CLOCK_BURST_POSTERS, 12.5 );
+	EXPECT_FALSE( governor.Update( NULL, false, false, 12.5 ) );
+	ASSERT_TRUE( governor.Update( NULL, false, false, 13.0 ) );
+	EXPECT_EQ( ClockLevels( 2, 2 ), governor.GetLevels() );
+	ASSERT_TRUE( governor.Update( NULL, false, false, 13.5 ) );
+	EXPECT_EQ( ClockLevels( 1, 2 ), governor.GetLevels() );
+
+	EXPECT_STREQ( "posters", ClockGovernor::GetBurstName( CLOCK_BURST_POSTERS ) );
+	EXPECT_STREQ( "", ClockGovernor::GetBurstName( CLOCK_BURST_COUNT ) );
+}
+
+// two bad windows raise whichever is likely short, up to the top
+TEST( ClockGovernor, MissedFramesRaiseTheBusyOne )
+{
+	ClockGovernor governor;
+	double now = 0.0;
+	governor.Reset( ClockLevels( 1, 2 ), now );
+
+	EXPECT_EQ( 2, WindowsToChange( governor, now, GPU_BOUND, 10 ) );
+	EXPECT_EQ( ClockLevels( 1, 3 ), governor.GetLevels() );
+	EXPECT_STREQ( "frames missed, gpu busy", governor.GetReason() );
+
+	// the GPU is at the top, so it's the CPU's turn even though the GPU is busy
+	EXPECT_EQ( 2, WindowsToChange( governor, now, GPU_BOUND, 10 ) );
+	EXPECT_EQ( ClockLevels( 2, 3 ), governor.GetLevels() );
+	EXPECT_STREQ( "frames missed", governor.GetReason() );
+
+	governor.Reset( ClockLevels( 1, 1 ), now );
+	EXPECT_EQ( 2, WindowsToChange( governor, now, CPU_BOUND, 10 ) );
+	EXPECT_EQ( ClockLevels( 2, 1 ), governor.GetLevels() );
+	EXPECT_EQ( 2, WindowsToChange( governor, now, CPU_BOUND, 10 ) );
+	EXPECT_EQ( 2, WindowsToChange( governor, now, CPU_BOUND, 10 ) );
+	EXPECT_EQ( ClockLevels( 3, 2 ), governor.GetLevels() );
+	EXPECT_EQ( 2, WindowsToChange( governor, now, CPU_BOUND, 10 ) );
+	EXPECT_EQ( ClockLevels( 3, 3 ), governor.GetLevels() );
+	EXPECT_EQ( -1, WindowsToChange( governor, now, CPU_BOUND, 10 ) );
+
+	// a good window in between starts the count over
+	governor.Reset( ClockLevels( 1, 1 ), now );
+	for ( int i = 0; i < 5; i++ )
+	{
+		now += 1.0;
+		EXPECT_FALSE( governor.Update( &CPU_BOUND, false, false, now ) );
+		now += 1.0;
+		EXPECT_FALSE( governor.Update( &BUSY, false, false, now ) );
+	}
+}
+
+// The GPU comes down first, one step per ten windows of headroom, and
+// three will do while the stream is static
+TEST( ClockGovernor, HeadroomLowersStepByStep )
+{
+	ClockGovernor governor;
+	double now = 0.0;
+	governor.Reset( ClockLevels( 1, 2 ), now );
+	EXPECT_EQ( -1, WindowsToChange( governor, now, BUSY, 30 ) );
+
+	EXPECT_EQ( 10, WindowsToChange( governor, now, IDLE, 20 ) );
+	EXPECT_EQ( ClockLevels( 1, 1 ), governor.GetLevels() );
+	EXPECT_STREQ( "headroom", governor.GetReason() );
+	EXPECT_EQ( 10, WindowsToChange( governor, now, IDLE, 20 ) );
+	EXPECT_EQ( ClockLevels( 1, 0 ), governor.GetLevels() );
+	EXPECT_EQ( 3, WindowsToChange( governor, now, IDLE, 20, true ) );
+	EXPECT_EQ( ClockLevels( 0, 0 ), governor.GetLevels() );
+	EXPECT_STREQ( "stream static", governor.GetReason() );
+	EXPECT_EQ( -1, WindowsToChange( governor, now, IDLE, 30, true ) );
+
+	// without a GPU timer the CPU goes first
+	governor.Reset( ClockLevels( 2, 2 ), now );
+	EXPECT_EQ( 10, WindowsToChange( governor, now, Window( -1.0f, 0.0f ), 20 ) );
+	EXPECT_EQ( ClockLevels( 1, 2 ), governor.GetLevels() );
+}
+
+// Raising again soon after lowering means the lower levels didn't hold,
+// so the next try waits twice as long
+TEST( ClockGovernor, BacksOffFailedLowering )
+{
+	ClockGovernor governor;
+	double now = 0.0;
+	governor.Reset( ClockLevels( 1, 2 ), now );
+
+	EXPECT_EQ( 10, WindowsToChange( governor, now, IDLE, 20 ) );
+	EXPECT_EQ( 2, WindowsToChange( governor, now, GPU_BOUND, 10 ) );
+	EXPECT_EQ( ClockLevels( 1, 2 ), governor.GetLevels() );
+	EXPECT_EQ( 20, WindowsToChange( governor, now, IDLE, 40 ) );
+	EXPECT_EQ( 2, WindowsToChange( governor, now, GPU_BOUND, 10 ) );
+	EXPECT_EQ( 40, WindowsToChange( governor, now, IDLE, 80 ) );
+
+	// a raise long after the lowering held doesn't count against it
+	EXPECT_EQ( -1, WindowsToChange( governor, now, BUSY, 25 ) );
+	EXPECT_EQ( 2, WindowsToChange( governor, now, GPU_BOUND, 10 ) );
+	EXPECT_EQ( 40, WindowsToChange( governor, now, IDLE, 80 ) );
+}
+
+TEST( ClockGovernor, ThrottlingCapsAndIgnoresBursts )
+{
+	ClockGovernor governor;
+	governor.Reset( ClockLevels( 1, 2 ), 0.0 );
+
+	ASSERT_TRUE( governor.Update( NULL, false, true, 1.0 ) );
+	EXPECT_EQ( ClockLevels( 1, 1 ), governor.GetLevels() );
+	EXPECT_STREQ( "throttled", governor.GetReason() );
+	governor.Burst( CLOCK_BURST_STREAM_START, 1.0 );
+	EXPECT_FALSE( governor.Update( NULL, false, true, 1.5 ) );
+
+	// the burst is still on when the throttle lifts
+	ASSERT_TRUE( governor.Update( NULL, false, false, 2.0 ) );
+	EXPECT_EQ( ClockLevels( 3, 3 ), governor.GetLevels() );
+	EXPECT_STREQ( "throttle lifted", governor.GetReason() );
+	ASSERT_TRUE( governor.Update( NULL, false, false, 4.0 ) );
+	EXPECT_EQ( ClockLevels( 1, 2 ), governor.GetLevels() );
+}
+
+// cpu_gpu.txt levels are left alone whatever happens
+TEST( ClockGovernor, PinnedLevelsNeverMove )
+{
+	ClockGovernor governor;
+	governor.Pin( ClockLevels( 2, 1 ) );
+	EXPECT_TRUE( governor.IsPinned() );
+	EXPECT_STREQ( "pinned", governor.GetReason() );
+	governor.Burst( CLOCK_BURST_SCENE_LOAD, 0.0 );
+	double now = 0.0;
+	EXPECT_EQ( -1, WindowsToChange( governor, now, GPU_BOUND, 10 ) );
+	EXPECT_EQ( -1, WindowsToChange( governor, now, IDLE, 20, true ) );
+	EXPECT_FALSE( governor.Update( NULL, false, true, now ) );
+	EXPECT_EQ( ClockLevels( 2, 1 ), governor.GetLevels() );
+
+	// a reset hands it back to the governor, clamped to the levels there are
+	governor.Reset( ClockLevels( 7, -1 ), now );
+	EXPECT_FALSE( governor.IsPinned() );
+	EXPECT_EQ( ClockLevels( ClockGovernor::MAX_LEVEL, 0 ), governor.GetLevels() );
+}
@@ -0,0 +1,175 @@
+/************************************************************************************
+
+Filename    :   ContentChangeDetectorTest.cpp
+Content     :	Host tests of the tile hashing change detector
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ContentChangeDetector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+// a 1080p stream's sample
+static const int WIDTH = 480;
+static const int HEIGHT = 270;
+
+std::vector<UByte> Desktop( const int width, const int height )
+{
+	std::vector<UByte> rgba( width * height * 4 );
+	for ( int y = 0; y < height; y++ )
+	{
+		for ( int x = 0; x < width; x++ )
+		{
+			UByte * p = &rgba[( y * width + x ) * 4];
+			p[0] = (UByte)( x * 3 + y );
+			p[1] = (UByte)( y * 5 );
+			p[2] = (UByte)( x ^ y );
+			p[3] = 255;
+		}
+	}
+	return rgba;
+}
+
+void Touch( std::vector<UByte> & rgba, const int width, const int x, const int y )
+{
+	rgba[( y * width + x ) * 4 + 1] ^= 1;
+}
+
+}
+
+TEST( ContentRect, IncludeGrowsAroundBoth )
+{
+	ContentRect r;
+	EXPECT_TRUE( r.IsEmpty() );
+	r.Include( ContentRect() );
+	EXPECT_TRUE( r.IsEmpty() );
+
+	r.Include( ContentRect( 0.25f, 0.5f, 0.5f, 0.75f ) );
+	EXPECT_EQ( 0.25f * 0.25f, r.Area() );
+	r.Include( ContentRect( 0.0f, 0.625f, 0.375f, 1.0f ) );
+	EXPECT_EQ( 0.0f, r.X0 );
+	EXPECT_EQ( 0.5f, r.Y0 );
+	EXPECT_EQ( 0.5f, r.X1 );
+	EXPECT_EQ( 1.0f, r.Y1 );
+	r.Include( ContentRect() );
+	EXPECT_EQ( 0.25f, r.Area() );
+}
+
+TEST( ContentChangeDetector, FirstSampleIsAllDirtyThenStatic )
+{
+	const std::vector<UByte> frame = Desktop( WIDTH, HEIGHT );
+	ContentChangeDetector detector;
+	ASSERT_TRUE( detector.Update( &frame[0], WIDTH, HEIGHT ) );
+	EXPECT_EQ( ContentChangeDetector::GRID_X * ContentChangeDetector::GRID_Y, detector.GetDirtyTiles() );
+	EXPECT_EQ( 1.0f, detector.GetDirtyRect().Area() );
+
+	EXPECT_FALSE( detector.Update( &frame[0], WIDTH, HEIGHT ) );
+	EXPECT_EQ( 0, detector.GetDirtyTiles() );
+	EXPECT_TRUE( detector.GetDirtyRect().IsEmpty() );
+
+	// a reset or a new size starts over
+	detector.Reset();
+	EXPECT_TRUE( detector.Update( &frame[0], WIDTH, HEIGHT ) );
+	EXPECT_EQ( 1.0f, detector.GetDirtyRect().Area() );
+	EXPECT_FALSE( detector.Update( &frame[0], WIDTH, HEIGHT ) );
+	EXPECT_TRUE( detector.Update( &frame[0], WIDTH / 2, HEIGHT ) );
+	EXPECT_EQ( 1.0f, detector.GetDirtyRect().Area() );
+}
+
+TEST( ContentChangeDetector, OnePixelDirtiesItsTile )
+{
+	std::vector<UByte> frame = Desktop( WIDTH, HEIGHT );
+	ContentChangeDetector detector;
+	detector.Update( &frame[0], WIDTH, HEIGHT );
+
+	// 480 / 16 = 30 wide tiles, 270 / 16 = 16.875 high
+	Touch( frame, WIDTH, 95, 40 );
+	ASSERT_TRUE( detector.Update( &frame[0], WIDTH, HEIGHT ) );
+	EXPECT_EQ( 1, detector.GetDirtyTiles() );
+	const ContentRect & r = detector.GetDirtyRect();
+	EXPECT_FLOAT_EQ( 90.0f / WIDTH, r.X0 );
+	EXPECT_FLOAT_EQ( 120.0f / WIDTH, r.X1 );
+	EXPECT_FLOAT_EQ( 33.0f / HEIGHT, r.Y0 );
+	EXPECT_FLOAT_EQ( 50.0f / HEIGHT, r.Y1 );
+	EXPECT_LE( r.X0 * WIDTH, 95.0f );
+	EXPECT_GT( r.X1 * WIDTH, 95.0f );
+	EXPECT_LE( r.Y0 * HEIGHT, 40.0f );
+	EXPECT_GT( r.Y1 * HEIGHT, 40.0f );
+}
+
+TEST( ContentChangeDetector, SeparateChangesAreBounded )
+{
+	std::vector<UByte> frame = Desktop( WIDTH, HEIGHT );
+	ContentChangeDetector detector;
+	detector.Update( &frame[0], WIDTH, HEIGHT );
+
+	Touch( frame, WIDTH, 10, 10 );
+	Touch( frame, WIDTH, 200, 150 );
+	ASSERT_TRUE( detector.Update( &frame[0], WIDTH, HEIGHT ) );
+	EXPECT_EQ( 2, detector.GetDirtyTiles() );
+	const ContentRect & r = detector.GetDirtyRect();
+	EXPECT_EQ( 0.0f, r.X0 );
+	EXPECT_EQ( 0.0f, r.Y0 );
+	EXPECT_FLOAT_EQ( 210.0f / WIDTH, r.X1 );
+	EXPECT_FLOAT_EQ( 151.0f / HEIGHT, r.Y1 );
+}
+
+// Sizes that neither the grid nor the four word groups divide: any
+// single pixel, the lanes' and the row tails' alike, must be seen, and
+// the rect must cover it
+TEST( ContentChangeDetector, SeesEveryPixelOfAnOddSize )
+{
+	const int width = 77;
+	const int height = 37;
+	std::vector<UByte> frame = Desktop( width, height );
+	ContentChangeDetector detector;
+	detector.Update( &frame[0], width, height );
+
+	for ( int y = 0; y < height; y++ )
+	{
+		for ( int x = 0; x < width; x++ )
+		{
+			Touch( frame, width, x, y );
+			ASSERT_TRUE( detector.Update( &frame[0], width, height ) ) << x << "," << y;
+			EXPECT_EQ( 1, detector.GetDirtyTiles() );
+			const ContentRect & r = detector.GetDirtyRect();
+			EXPECT_LE( r.X0 * width, x + 0.001f );
+			EXPECT_GE( r.X1 * width, x + 0.999f );
+			EXPECT_LE( r.Y0 * height, y + 0.001f );
+			EXPECT_GE( r.Y1 * height, y + 0.999f );
+
+			// and changing it back is a change too
+			Touch( frame, width, x, y );
+			ASSERT_TRUE( detector.Update( &frame[0], width, height ) );
+		}
+	}
+}
+
+// pixels 1 and 5 of a row go into the same lane, which hashes in order,
+// so swapping them is a change
+TEST( ContentChangeDetector, SeesPixelsSwapped )
+{
+	std::vector<UByte> frame = Desktop( WIDTH, HEIGHT );
+	ContentChangeDetector detector;
+	detector.Update( &frame[0], WIDTH, HEIGHT );
+
+	for ( int i = 0; i < 4; i++ )
+	{
+		std::swap( frame[( 5 * WIDTH + 1 ) * 4 + i], frame[( 5 * WIDTH + 5 ) * 4 + i] );
+	}
+	EXPECT_TRUE( detector.Update( &frame[0], WIDTH, HEIGHT ) );
+}
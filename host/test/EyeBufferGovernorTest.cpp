@@ -0,0 +1,241 @@
+/************************************************************************************
+
+Filename    :   EyeBufferGovernorTest.cpp
+Content     :	Host tests of the eye buffer governor, driven by frame time traces
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "EyeBufferGovernor.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <vector>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+static const float FRAME_SECONDS = 1.0f / 60.0f;
+static const EyeBufferLevel BEST( 4, 1024 );
+
+// What a scene costs the GPU at a level: MSAA and the pixel count both
+// scale it, the way they did on a Note 4.  ms is the cost at the best level.
+float SceneCost( const float ms, const EyeBufferLevel & level )
+{
+	const float msaa = level.Multisamples == 4 ? 1.0f : ( level.Multisamples == 2 ? 0.8f : 0.65f );
+	const float pixels = (float)level.Resolution * level.Resolution / ( 1024.0f * 1024.0f );
+	return ms * msaa * pixels;
+}
+
+typedef std::function<float( const EyeBufferLevel & )> CostFunction;
+
+// Plays frames at 60 Hz through the stats into the governor, the way
+// CinemaApp::UpdateEyeBuffers does, each frame costing what cost says at
+// the current level.  A frame over the vsync is shown a vsync late.
+// Returns the levels it went through.
+std::vector<EyeBufferLevel> Play( EyeBufferGovernor & governor, EyeBufferStats & stats, double & now,
+		const double seconds, const CostFunction & cost )
+{
+	std::vector<EyeBufferLevel> levels;
+	const double end = now + seconds;
+	for ( ; now < end; now += FRAME_SECONDS )
+	{
+		const float gpuMs = cost( governor.GetLevel() );
+		stats.AddFrame( gpuMs > FRAME_SECONDS * 1000.0f ? FRAME_SECONDS * 2.0f : FRAME_SECONDS, gpuMs );
+		EyeBufferSample sample;
+		if ( stats.GetSample( now, sample ) && governor.Evaluate( sample, now ) )
+		{
+			levels.push_back( governor.GetLevel() );
+		}
+	}
+	return levels;
+}
+
+std::vector<EyeBufferLevel> Play( EyeBufferGovernor & governor, EyeBufferStats & stats, double & now,
+		const double seconds, const float ms )
+{
+	return Play( governor, stats, now, seconds, [ms]( const EyeBufferLevel & level ) { return SceneCost( ms, level ); } );
+}
+
+}
+
+TEST( EyeBufferStats, SummarizesEachWindow )
+{
+	EyeBufferStats stats;
+	stats.Reset( 10.0 );
+	EyeBufferSample sample;
+	EXPECT_FALSE( stats.GetSample( 10.5, sample ) );
+
+	// 60 frames, 3 of them missed, the GPU timed for every other one
+	for ( int i = 0; i < 60; i++ )
+	{
+		stats.AddFrame( i % 20 == 0 ? 0.04f : FRAME_SECONDS, i % 2 == 0 ? 6.0f : -1.0f );
+	}
+	EXPECT_FALSE( stats.GetSample( 10.9, sample ) );
+	ASSERT_TRUE( stats.GetSample( 11.0, sample ) );
+	EXPECT_FLOAT_EQ( 6.0f, sample.GpuMs );
+	EXPECT_FLOAT_EQ( 0.05f, sample.MissedFrameFraction );
+
+	// the next window starts empty, and without a timer the GPU is unknown
+	EXPECT_FALSE( stats.GetSample( 12.5, sample ) );
+	stats.AddFrame( FRAME_SECONDS, -1.0f );
+	ASSERT_TRUE( stats.GetSample( 12.5, sample ) );
+	EXPECT_EQ( -1.0f, sample.GpuMs );
+	EXPECT_EQ( 0.0f, sample.MissedFrameFraction );
+}
+
+// A heavy theater drops MSAA before resolution, one step per two bad
+// windows after the settle time, and stops at the first level that fits
+TEST( EyeBufferGovernor, StepsDownMsaaFirst )
+{
+	EyeBufferGovernor governor;
+	EyeBufferStats stats;
+	double now = 0.0;
+	ASSERT_TRUE( governor.SetContext( 0, BEST, now ) );
+	stats.Reset( now );
+	EXPECT_EQ( EyeBufferGovernor::EYE_BUFFERS_FULL, governor.GetState() );
+
+	// 15 ms at 4x, 12 ms at 2x: one step
+	std::vector<EyeBufferLevel> levels = Play( governor, stats, now, 30.0, 15.0f );
+	ASSERT_EQ( 1u, levels.size() );
+	EXPECT_EQ( EyeBufferLevel( 2, 1024 ), levels[0] );
+	EXPECT_EQ( EyeBufferGovernor::EYE_BUFFERS_REDUCED, governor.GetState() );
+
+	// 30 ms at 4x needs all of it
+	governor = EyeBufferGovernor();
+	ASSERT_TRUE( governor.SetContext( 0, BEST, now ) );
+	stats.Reset( now );
+	levels = Play( governor, stats, now, 60.0, 30.0f );
+	ASSERT_EQ( 4u, levels.size() );
+	EXPECT_EQ( EyeBufferLevel( 2, 1024 ), levels[0] );
+	EXPECT_EQ( EyeBufferLevel( 1, 1024 ), levels[1] );
+	EXPECT_EQ( EyeBufferLevel( 1, 896 ), levels[2] );
+	EXPECT_EQ( EyeBufferLevel( 1, 768 ), levels[3] );
+	EXPECT_EQ( EyeBufferGovernor::EYE_BUFFERS_MINIMUM, governor.GetState() );
+}
+
+TEST( EyeBufferGovernor, RecoversWhenTheLoadGoes )
+{
+	EyeBufferGovernor governor;
+	EyeBufferStats stats;
+	double now = 0.0;
+	governor.SetContext( 0, BEST, now );
+	stats.Reset( now );
+	Play( governor, stats, now, 30.0, 22.0f );
+	ASSERT_EQ( EyeBufferLevel( 1, 896 ), governor.GetLevel() );
+
+	// 22 ms stops at 896, where it costs 11 ms, neither good nor bad.  At
+	// 5 ms there's room for all of it, a step per five good windows.
+	const double start = now;
+	std::vector<EyeBufferLevel> levels = Play( governor, stats, now, 9.0, 5.0f );
+	ASSERT_EQ( 1u, levels.size() );
+	EXPECT_EQ( EyeBufferLevel( 1, 1024 ), levels[0] );
+	EXPECT_EQ( EyeBufferGovernor::EYE_BUFFERS_RECOVERING, governor.GetState() );
+	levels = Play( governor, stats, now, start + 30.0 - now, 5.0f );
+	ASSERT_EQ( 2u, levels.size() );
+	EXPECT_EQ( BEST, governor.GetLevel() );
+	EXPECT_EQ( EyeBufferGovernor::EYE_BUFFERS_FULL, governor.GetState() );
+}
+
+// Stepping up into a level that doesn't fit doubles the wait before the
+// next try, so a borderline scene doesn't flap every few seconds
+TEST( EyeBufferGovernor, BacksOffFailedRecoveries )
+{
+	EyeBufferGovernor governor;
+	EyeBufferStats stats;
+	double now = 0.0;
+	governor.SetContext( 0, BEST, now );
+	stats.Reset( now );
+
+	// plenty of room at 2x, too little at 4x
+	const CostFunction borderline = []( const EyeBufferLevel & level ) { return level.Multisamples == 4 ? 14.0f : 7.0f; };
+	Play( governor, stats, now, 6.0, borderline );
+	ASSERT_EQ( EyeBufferLevel( 2, 1024 ), governor.GetLevel() );
+
+	// the changes alternate up and down, each time waiting longer
+	std::vector<double> ups;
+	const double end = now + 120.0;
+	while ( now < end )
+	{
+		const std::vector<EyeBufferLevel> levels = Play( governor, stats, now, 1.0, borderline );
+		for ( size_t i = 0; i < levels.size(); i++ )
+		{
+			if ( levels[i] == BEST )
+			{
+				ups.push_back( now );
+			}
+		}
+	}
+	ASSERT_GE( ups.size(), 3u );
+	EXPECT_GT( ups[2] - ups[1], ( ups[1] - ups[0] ) * 1.5 );
+	EXPECT_LE( ups.size(), 5u );
+}
+
+// Each view in each scene picks up where it was left, under its ceiling
+TEST( EyeBufferGovernor, RemembersEachContext )
+{
+	EyeBufferGovernor governor;
+	EyeBufferStats stats;
+	double now = 0.0;
+	governor.SetContext( 3, BEST, now );
+	stats.Reset( now );
+	Play( governor, stats, now, 30.0, 22.0f );
+	const EyeBufferLevel heavy = governor.GetLevel();
+	ASSERT_NE( BEST, heavy );
+
+	EXPECT_TRUE( governor.SetContext( 4, BEST, now ) );
+	EXPECT_EQ( BEST, governor.GetLevel() );
+	EXPECT_FALSE( governor.SetContext( 4, BEST, now ) );
+
+	EXPECT_TRUE( governor.SetContext( 3, BEST, now ) );
+	EXPECT_EQ( heavy, governor.GetLevel() );
+	EXPECT_EQ( EyeBufferGovernor::EYE_BUFFERS_REDUCED, governor.GetState() );
+
+	// a lower ceiling caps it, and the levels in between are skipped
+	EXPECT_TRUE( governor.SetContext( 4, EyeBufferLevel( 2, 1024 ), now ) );
+	EXPECT_EQ( EyeBufferLevel( 2, 1024 ), governor.GetLevel() );
+	EXPECT_EQ( EyeBufferGovernor::EYE_BUFFERS_FULL, governor.GetState() );
+	stats.Reset( now );
+	EXPECT_TRUE( Play( governor, stats, now, 30.0, 2.0f ).empty() );
+	EXPECT_EQ( EyeBufferLevel( 2, 1024 ), governor.GetLevel() );
+
+	// contexts past the table still work, they just aren't remembered
+	EXPECT_TRUE( governor.SetContext( EyeBufferGovernor::MAX_CONTEXTS, BEST, now ) );
+	EXPECT_EQ( BEST, governor.GetLevel() );
+}
+
+// without a GPU timer the missed frames alone decide
+TEST( EyeBufferGovernor, JudgesByMissedFramesWithoutATimer )
+{
+	EyeBufferGovernor governor;
+	governor.SetContext( 0, BEST, 0.0 );
+	EyeBufferSample sample;
+	sample.GpuMs = -1.0f;
+	sample.MissedFrameFraction = 0.1f;
+
+	// nothing is judged while the new buffers settle
+	EXPECT_FALSE( governor.Evaluate( sample, 1.0 ) );
+	EXPECT_FALSE( governor.Evaluate( sample, 1.5 ) );
+	EXPECT_FALSE( governor.Evaluate( sample, 3.0 ) );
+	EXPECT_TRUE( governor.Evaluate( sample, 4.0 ) );
+	EXPECT_EQ( EyeBufferLevel( 2, 1024 ), governor.GetLevel() );
+	EXPECT_STREQ( "reduced", governor.GetStateName() );
+
+	// a clean window isn't enough on its own, it takes five
+	sample.MissedFrameFraction = 0.0f;
+	for ( int i = 0; i < 4; i++ )
+	{
+		EXPECT_FALSE( governor.Evaluate( sample, 7.0 + i ) );
+	}
+	EXPECT_TRUE( governor.Evaluate( sample, 11.0 ) );
+	EXPECT_EQ( BEST, governor.GetLevel() );
+	EXPECT_STREQ( "full", governor.GetStateName() );
+}
@@ -0,0 +1,246 @@
+/************************************************************************************
+
+Filename    :   ImageWriterTest.cpp
+Content     :	Host tests of the PNG and raw frame files, read back and compared
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ImageWriter.h"
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <string>
+#include <vector>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+std::string TempPath()
+{
+	char path[] = "/tmp/streamtheater_imageXXXXXX";
+	close( mkstemp( path ) );
+	unlink( path );
+	return path;
+}
+
+std::vector<UByte> ReadFile( const std::string & path )
+{
+	std::vector<UByte> bytes;
+	FILE * f = fopen( path.c_str(), "rb" );
+	if ( f == NULL )
+	{
+		return bytes;
+	}
+	UByte buffer[4096];
+	size_t length;
+	while ( ( length = fread( buffer, 1, sizeof( buffer ), f ) ) > 0 )
+	{
+		bytes.insert( bytes.end(), buffer, buffer + length );
+	}
+	fclose( f );
+	return bytes;
+}
+
+UInt32 BigEndian( const UByte * in )
+{
+	return ( (UInt32)in[0] << 24 ) | ( (UInt32)in[1] << 16 ) | ( (UInt32)in[2] << 8 ) | in[3];
+}
+
+UInt32 LittleEndian( const UByte * in )
+{
+	return in[0] | ( (UInt32)in[1] << 8 ) | ( (UInt32)in[2] << 16 ) | ( (UInt32)in[3] << 24 );
+}
+
+// every pixel different, alpha varying too so dropping it is checked
+std::vector<UByte> TestImage( const int width, const int height )
+{
+	std::vector<UByte> rgba( width * height * 4 );
+	for ( int y = 0; y < height; y++ )
+	{
+		for ( int x = 0; x < width; x++ )
+		{
+			UByte * p = &rgba[( y * width + x ) * 4];
+			p[0] = (UByte)( x * 37 + y );
+			p[1] = (UByte)( y * 53 + x * 3 );
+			p[2] = (UByte)( 255 - x * y );
+			p[3] = (UByte)( x ^ y );
+		}
+	}
+	return rgba;
+}
+
+// top row first, whichever way the source was
+const UByte * SourceRow( const std::vector<UByte> & rgba, const int width, const int height, const int y, const bool bottomUp )
+{
+	return &rgba[( bottomUp ? height - 1 - y : y ) * width * 4];
+}
+
+// Reads back what WritePng writes: checks the signature and chunk CRCs,
+// inflates IDAT and undoes each row's filter.  Returns top down RGB.
+bool DecodePng( const std::vector<UByte> & file, int & width, int & height, std::vector<UByte> & rgb )
+{
+	static const UByte signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	if ( file.size() < 8 || memcmp( &file[0], signature, 8 ) != 0 )
+	{
+		return false;
+	}
+
+	std::vector<UByte> idat;
+	bool ended = false;
+	width = 0;
+	height = 0;
+	for ( size_t offset = 8; offset < file.size() && !ended; )
+	{
+		if ( offset + 12 > file.size() )
+		{
+			return false;
+		}
+		const UInt32 length = BigEndian( &file[offset] );
+		if ( offset + 12 + length > file.size() )
+		{
+			return false;
+		}
+		const UByte * type = &file[offset + 4];
+		const UByte * data = type + 4;
+		if ( crc32( crc32( 0L, NULL, 0 ), type, 4 + length ) != BigEndian( data + length ) )
+		{
+			return false;
+		}
+		if ( memcmp( type, "IHDR", 4 ) == 0 )
+		{
+			// 8 bit RGB, deflate, adaptive filtering, not interlaced
+			if ( length != 13 || data[8] != 8 || data[9] != 2 || data[10] != 0 || data[11] != 0 || data[12] != 0 )
+			{
+				return false;
+			}
+			width = BigEndian( data );
+			height = BigEndian( data + 4 );
+		}
+		else if ( memcmp( type, "IDAT", 4 ) == 0 )
+		{
+			idat.insert( idat.end(), data, data + length );
+		}
+		else if ( memcmp( type, "IEND", 4 ) == 0 )
+		{
+			ended = true;
+		}
+		offset += 12 + length;
+	}
+	if ( !ended || width <= 0 || height <= 0 || idat.empty() )
+	{
+		return false;
+	}
+
+	const int rowBytes = 1 + width * 3;
+	std::vector<UByte> filtered( rowBytes * height );
+	uLongf size = filtered.size();
+	if ( uncompress( &filtered[0], &size, &idat[0], idat.size() ) != Z_OK || size != filtered.size() )
+	{
+		return false;
+	}
+
+	rgb.resize( width * height * 3 );
+	for ( int y = 0; y < height; y++ )
+	{
+		const UByte * src = &filtered[y * rowBytes];
+		UByte * dst = &rgb[y * width * 3];
+		const UByte * up = ( y > 0 ) ? dst - width * 3 : NULL;
+		const UByte filter = *src++;
+		for ( int i = 0; i < width * 3; i++ )
+		{
+			const int left = ( i >= 3 ) ? dst[i - 3] : 0;
+			const int above = ( up != NULL ) ? up[i] : 0;
+			switch ( filter )
+			{
+				case 0:		dst[i] = src[i]; break;
+				case 1:		dst[i] = (UByte)( src[i] + left ); break;
+				case 2:		dst[i] = (UByte)( src[i] + above ); break;
+				default:	return false;	// the writer only uses None, Sub and Up
+			}
+		}
+	}
+	return true;
+}
+
+}
+
+TEST( ImageWriter, PngRoundTrips )
+{
+	const int width = 37;
+	const int height = 11;
+	const std::vector<UByte> rgba = TestImage( width, height );
+
+	for ( int bottomUp = 0; bottomUp < 2; bottomUp++ )
+	{
+		const std::string path = TempPath();
+		ASSERT_TRUE( ImageWriter::WritePng( path.c_str(), &rgba[0], width, height, bottomUp != 0 ) );
+
+		int decodedWidth = 0;
+		int decodedHeight = 0;
+		std::vector<UByte> rgb;
+		ASSERT_TRUE( DecodePng( ReadFile( path ), decodedWidth, decodedHeight, rgb ) );
+		unlink( path.c_str() );
+		ASSERT_EQ( width, decodedWidth );
+		ASSERT_EQ( height, decodedHeight );
+
+		for ( int y = 0; y < height; y++ )
+		{
+			const UByte * src = SourceRow( rgba, width, height, y, bottomUp != 0 );
+			for ( int x = 0; x < width; x++ )
+			{
+				ASSERT_EQ( 0, memcmp( &rgb[( y * width + x ) * 3], src + x * 4, 3 ) ) << "bottomUp " << bottomUp << " at " << x << "," << y;
+			}
+		}
+	}
+}
+
+TEST( ImageWriter, RawRoundTrips )
+{
+	const int width = 5;
+	const int height = 7;
+	const std::vector<UByte> rgba = TestImage( width, height );
+
+	for ( int bottomUp = 0; bottomUp < 2; bottomUp++ )
+	{
+		const std::string path = TempPath();
+		ASSERT_TRUE( ImageWriter::WriteRaw( path.c_str(), &rgba[0], width, height, bottomUp != 0 ) );
+		const std::vector<UByte> file = ReadFile( path );
+		unlink( path.c_str() );
+
+		ASSERT_EQ( (size_t)( ImageWriter::RAW_HEADER_SIZE + width * height * 4 ), file.size() );
+		EXPECT_EQ( 0, memcmp( &file[0], "STRW", 4 ) );
+		EXPECT_EQ( (UInt32)width, LittleEndian( &file[4] ) );
+		EXPECT_EQ( (UInt32)height, LittleEndian( &file[8] ) );
+		EXPECT_EQ( 0u, LittleEndian( &file[12] ) );
+
+		for ( int y = 0; y < height; y++ )
+		{
+			ASSERT_EQ( 0, memcmp( &file[ImageWriter::RAW_HEADER_SIZE + y * width * 4], SourceRow( rgba, width, height, y, bottomUp != 0 ), width * 4 ) )
+					<< "bottomUp " << bottomUp << " row " << y;
+		}
+	}
+}
+
+TEST( ImageWriter, RefusesEmptyImagesAndBadPaths )
+{
+	const std::vector<UByte> rgba = TestImage( 2, 2 );
+	const std::string path = TempPath();
+	EXPECT_FALSE( ImageWriter::WritePng( path.c_str(), &rgba[0], 0, 2, false ) );
+	EXPECT_FALSE( ImageWriter::WriteRaw( path.c_str(), &rgba[0], 2, 0, false ) );
+	EXPECT_NE( 0, access( path.c_str(), F_OK ) );
+
+	EXPECT_FALSE( ImageWriter::WritePng( "/nonexistent/streamtheater.png", &rgba[0], 2, 2, false ) );
+	EXPECT_FALSE( ImageWriter::WriteRaw( "/nonexistent/streamtheater.raw", &rgba[0], 2, 2, true ) );
+}
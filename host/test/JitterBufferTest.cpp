@@ -0,0 +1,393 @@
+/************************************************************************************
+
+Filename    :   JitterBufferTest.cpp
+Content     :	Host tests of the audio jitter buffer, replaying arrival traces
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "nv_audio_jitter.h"
+#include "SyntheticOpus.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace SyntheticOpus;
+
+namespace {
+
+static const int PACKETS = 2000;
+
+// SILK at 10 ms with FEC, and 5 ms frames which can only be CELT
+static const int SILK_MS = 10;
+static const int CELT_MS = 5;
+
+// the margin a consumer pulling at the device rate would use
+static const int PULL_TRIM_MARGIN = 2;
+
+// when packet i of a trace was sent is i frames in; it arrives Delay[i] later
+struct Trace
+{
+	std::vector<bool>		Lost;
+	std::vector<long long>	Delay;
+
+	Trace() : Lost( PACKETS, false ), Delay( PACKETS, 20000 ) {}
+};
+
+struct Replay
+{
+	nv_audio_jitter_stats	Stats;
+	int						MaxDepth;		// once it settled
+	int						Kinds[4];		// frames played of each NV_AUDIO_FRAME_*
+};
+
+nv_opus_decoder * CreateDecoder( const int frameMs )
+{
+	return nv_opus_create( SAMPLE_RATE, STEREO.Channels, STEREO.Streams, STEREO.CoupledStreams, STEREO.Mapping,
+			SamplesPerChannel( frameMs ), NULL );
+}
+
+// Plays a trace the way a device would: a frame every frameMs, with all
+// packets that arrived by then handed over before.
+Replay Play( const std::vector<Packet> &packets, const int frameMs, const Trace &trace )
+{
+	const long long frameUs = frameMs * 1000;
+	std::vector<int> order( packets.size() );
+	for ( size_t i = 0; i < order.size(); i++ )
+	{
+		order[i] = (int)i;
+	}
+	std::stable_sort( order.begin(), order.end(), [&]( const int a, const int b ) {
+		return a * frameUs + trace.Delay[a] < b * frameUs + trace.Delay[b];
+	} );
+
+	nv_opus_decoder *decoder = CreateDecoder( frameMs );
+	nv_audio_jitter *jitter = nv_audio_jitter_create( decoder, (int)frameUs, 1, 12, PULL_TRIM_MARGIN );
+	std::vector<short> pcm( SamplesPerChannel( frameMs ) * STEREO.Channels );
+
+	Replay replay = {};
+	const long long start = order[0] * frameUs + trace.Delay[order[0]];
+	size_t next = 0;
+	for ( size_t frame = 0; frame < packets.size(); frame++ )
+	{
+		const long long now = start + frame * frameUs;
+		for ( ; next < order.size() && order[next] * frameUs + trace.Delay[order[next]] <= now; next++ )
+		{
+			const int seq = order[next];
+			if ( !trace.Lost[seq] )
+			{
+				// sequence numbers wrap during the trace
+				nv_audio_jitter_put( jitter, (unsigned short)( seq + 60000 ), seq * frameUs + trace.Delay[seq],
+						&packets[seq][0], (int)packets[seq].size() );
+			}
+		}
+
+		int kind = -1;
+		EXPECT_EQ( SamplesPerChannel( frameMs ), nv_audio_jitter_get( jitter, &pcm[0], &kind ) );
+		replay.Kinds[kind]++;
+
+		nv_audio_jitter_stats stats;
+		nv_audio_jitter_get_stats( jitter, &stats );
+		if ( frame > 50 )
+		{
+			replay.MaxDepth = std::max( replay.MaxDepth, stats.depth );
+		}
+	}
+	nv_audio_jitter_get_stats( jitter, &replay.Stats );
+
+	nv_audio_jitter_destroy( jitter );
+	nv_opus_destroy( decoder );
+	return replay;
+}
+
+// Whether packet i really carries the one before, by decoding the FEC
+// data from a copy of the decoder state and comparing with concealment.
+std::vector<bool> CarriesFec( const std::vector<Packet> &packets, const int frameMs )
+{
+	const int samples = SamplesPerChannel( frameMs );
+	const int size = opus_decoder_get_size( STEREO.Channels );
+	OpusDecoder *decoder = opus_decoder_create( SAMPLE_RATE, STEREO.Channels, NULL );
+	OpusDecoder *copy = (OpusDecoder *)malloc( size );
+	std::vector<short> recovered( samples * STEREO.Channels );
+	std::vector<short> concealed( samples * STEREO.Channels );
+
+	std::vector<bool> fec( packets.size(), false );
+	for ( size_t i = 1; i < packets.size(); i++ )
+	{
+		// the state is position independent and may be copied
+		memcpy( copy, decoder, size );
+		EXPECT_EQ( samples, opus_decode( copy, &packets[i][0], (int)packets[i].size(), &recovered[0], samples, 1 ) );
+		memcpy( copy, decoder, size );
+		EXPECT_EQ( samples, opus_decode( copy, NULL, 0, &concealed[0], samples, 0 ) );
+		fec[i] = ( recovered != concealed );
+
+		EXPECT_EQ( samples, opus_decode( decoder, &packets[i - 1][0], (int)packets[i - 1].size(), &recovered[0], samples, 0 ) );
+	}
+	free( copy );
+	opus_decoder_destroy( decoder );
+	return fec;
+}
+
+// every tenth packet lost, never two in a row
+int LoseIsolated( Trace &trace )
+{
+	int losses = 0;
+	for ( int i = 6; i < PACKETS; i++ )
+	{
+		trace.Lost[i] = ( i % 10 == 3 );
+		losses += trace.Lost[i];
+	}
+	return losses;
+}
+
+class JitterBuffer : public ::testing::Test
+{
+protected:
+	static std::vector<Packet>	Silk;
+	static std::vector<Packet>	Celt;
+
+	static void SetUpTestCase()
+	{
+		Silk = Encode( STEREO, SILK_MS, PACKETS, true );
+		Celt = Encode( STEREO, CELT_MS, PACKETS, false );
+	}
+
+	virtual void SetUp()
+	{
+		ASSERT_EQ( PACKETS, (int)Silk.size() );
+		ASSERT_EQ( PACKETS, (int)Celt.size() );
+		srand( 7 );
+	}
+};
+
+std::vector<Packet> JitterBuffer::Silk;
+std::vector<Packet> JitterBuffer::Celt;
+
+}
+
+TEST_F( JitterBuffer, ACleanStreamIsAllDecoded )
+{
+	const Replay replay = Play( Silk, SILK_MS, Trace() );
+	EXPECT_EQ( (unsigned)PACKETS, replay.Stats.decoded );
+	EXPECT_EQ( 0u, replay.Stats.concealed );
+	EXPECT_EQ( 0u, replay.Stats.recovered );
+	EXPECT_EQ( 1, replay.Stats.target_depth );
+}
+
+TEST_F( JitterBuffer, IsolatedLossesAreRebuiltFromFec )
+{
+	Trace trace;
+	const int losses = LoseIsolated( trace );
+	const std::vector<bool> fec = CarriesFec( Silk, SILK_MS );
+	unsigned int recoverable = 0;
+	for ( int i = 0; i + 1 < PACKETS; i++ )
+	{
+		recoverable += trace.Lost[i] && fec[i + 1];
+	}
+	ASSERT_GT( recoverable, 0u );
+
+	// the first loss underruns and may be given up on; after that the
+	// next packet is always there in time
+	const Replay replay = Play( Silk, SILK_MS, trace );
+	EXPECT_LE( replay.Stats.underruns, 1u );
+	EXPECT_GE( replay.Stats.recovered + 1, recoverable );
+	EXPECT_LE( replay.Stats.recovered, recoverable );
+	EXPECT_EQ( losses - replay.Stats.recovered + replay.Stats.underruns - replay.Stats.trimmed, replay.Stats.concealed );
+}
+
+TEST_F( JitterBuffer, LossesOnCeltAreConcealed )
+{
+	Trace trace;
+	const int losses = LoseIsolated( trace );
+	const Replay replay = Play( Celt, CELT_MS, trace );
+	EXPECT_EQ( 0u, replay.Stats.recovered );
+	EXPECT_EQ( losses + replay.Stats.underruns, replay.Stats.concealed );
+}
+
+TEST_F( JitterBuffer, JitterRaisesTheTarget )
+{
+	// up to 30 ms on 10 ms frames, reordering some, and 3% lost
+	Trace trace;
+	for ( int i = 0; i < PACKETS; i++ )
+	{
+		trace.Delay[i] = 20000 + rand() % 30000;
+		trace.Lost[i] = ( rand() % 100 ) < 3;
+	}
+	const Replay replay = Play( Silk, SILK_MS, trace );
+	EXPECT_GT( replay.Stats.target_depth, 1 );
+	EXPECT_GT( replay.Stats.jitter_us, 3000 );
+	EXPECT_GT( replay.Stats.recovered, 0u );
+	EXPECT_LT( replay.Stats.underruns, (unsigned)PACKETS / 20 );
+	EXPECT_LE( replay.MaxDepth, replay.Stats.target_depth + 12 );
+}
+
+TEST_F( JitterBuffer, TheDelayComesDownAfterABurst )
+{
+	Trace trace;
+	for ( int i = 200; i < 500; i++ )
+	{
+		trace.Delay[i] += rand() % 60000;
+	}
+	const Replay replay = Play( Silk, SILK_MS, trace );
+	EXPECT_GT( replay.Stats.trimmed, 0u );
+	EXPECT_LE( replay.Stats.depth, replay.Stats.target_depth + PULL_TRIM_MARGIN );
+}
+
+// Put and get once per packet the way the JNI glue does, at its fixed
+// one frame target, with a lost packet only skipping the put.  An
+// underrun must not leave a frame of delay behind.
+TEST_F( JitterBuffer, PushPullKeepsNoExtraDelay )
+{
+	nv_opus_decoder *decoder = CreateDecoder( SILK_MS );
+	nv_audio_jitter *jitter = nv_audio_jitter_create( decoder, SILK_MS * 1000, 1, 1, 0 );
+	std::vector<short> pcm( SamplesPerChannel( SILK_MS ) * STEREO.Channels );
+
+	int kinds[4] = {};
+	int losses = 0;
+	for ( int i = 0; i < PACKETS; i++ )
+	{
+		const bool lost = ( i > 5 && i % 13 == 4 );
+		losses += lost;
+		if ( !lost )
+		{
+			ASSERT_EQ( 0, nv_audio_jitter_put( jitter, (unsigned short)i, i * SILK_MS * 1000LL, &Silk[i][0], (int)Silk[i].size() ) );
+		}
+		int kind = -1;
+		ASSERT_EQ( SamplesPerChannel( SILK_MS ), nv_audio_jitter_get( jitter, &pcm[0], &kind ) );
+		kinds[kind]++;
+
+		nv_audio_jitter_stats stats;
+		nv_audio_jitter_get_stats( jitter, &stats );
+		ASSERT_LE( stats.depth, 1 ) << "after packet " << i;
+	}
+
+	nv_audio_jitter_stats stats;
+	nv_audio_jitter_get_stats( jitter, &stats );
+	EXPECT_EQ( losses, kinds[NV_AUDIO_FRAME_CONCEALED] );
+	EXPECT_EQ( (unsigned)losses, stats.trimmed );
+	EXPECT_EQ( PACKETS - losses, kinds[NV_AUDIO_FRAME_DECODED] );
+
+	nv_audio_jitter_destroy( jitter );
+	nv_opus_destroy( decoder );
+}
+
+TEST_F( JitterBuffer, LateDuplicateAndFarAheadPackets )
+{
+	nv_opus_decoder *decoder = CreateDecoder( SILK_MS );
+	nv_audio_jitter *jitter = nv_audio_jitter_create( decoder, SILK_MS * 1000, 1, 8, 0 );
+	std::vector<short> pcm( SamplesPerChannel( SILK_MS ) * STEREO.Channels );
+	for ( int i = 0; i < 100; i++ )
+	{
+		nv_audio_jitter_put( jitter, (unsigned short)i, i * 10000LL, &Silk[i][0], (int)Silk[i].size() );
+		nv_audio_jitter_get( jitter, &pcm[0], NULL );
+	}
+
+	EXPECT_EQ( -1, nv_audio_jitter_put( jitter, 50, 0, &Silk[0][0], (int)Silk[0].size() ) );
+	EXPECT_EQ( 0, nv_audio_jitter_put( jitter, 100, 1000000, &Silk[0][0], (int)Silk[0].size() ) );
+	EXPECT_EQ( -1, nv_audio_jitter_put( jitter, 100, 1000000, &Silk[0][0], (int)Silk[0].size() ) );
+	EXPECT_EQ( 0, nv_audio_jitter_put( jitter, 600, 1000000, &Silk[1][0], (int)Silk[1].size() ) );
+	EXPECT_EQ( -1, nv_audio_jitter_put( jitter, 601, 0, NULL, 0 ) );
+
+	nv_audio_jitter_stats stats;
+	nv_audio_jitter_get_stats( jitter, &stats );
+	EXPECT_EQ( 1u, stats.late );
+	EXPECT_EQ( 1u, stats.duplicates );
+	EXPECT_EQ( 1u, stats.resyncs );
+	EXPECT_EQ( 1, stats.depth );
+
+	nv_audio_jitter_reset( jitter );
+	int kind = -1;
+	EXPECT_EQ( SamplesPerChannel( SILK_MS ), nv_audio_jitter_get( jitter, &pcm[0], &kind ) );
+	EXPECT_EQ( NV_AUDIO_FRAME_SILENCE, kind );
+
+	nv_audio_jitter_destroy( jitter );
+	nv_opus_destroy( decoder );
+}
+
+// the LBRR flag itself, not just a mode that could carry one
+TEST_F( JitterBuffer, FecIsOnlyFoundWhereTheEncoderPutIt )
+{
+	nv_opus_decoder *decoder = CreateDecoder( SILK_MS );
+	const std::vector<bool> fec = CarriesFec( Silk, SILK_MS );
+	int withFec = 0;
+	for ( int i = 1; i < PACKETS; i++ )
+	{
+		ASSERT_LT( Silk[i][0] >> 3, 12 ) << "not SILK";
+		EXPECT_EQ( fec[i], nv_opus_packet_has_fec( decoder, &Silk[i][0], (int)Silk[i].size() ) != 0 ) << "packet " << i;
+		EXPECT_FALSE( nv_opus_packet_has_fec( decoder, &Celt[i][0], (int)Celt[i].size() ) );
+		withFec += fec[i];
+	}
+	// some with and some without, or this proves nothing
+	EXPECT_GT( withFec, 0 );
+	EXPECT_LT( withFec, PACKETS - 1 );
+	EXPECT_FALSE( nv_opus_packet_has_fec( decoder, &Silk[0][0], (int)Silk[0].size() ) );
+	EXPECT_FALSE( nv_opus_packet_has_fec( decoder, NULL, 0 ) );
+	EXPECT_FALSE( nv_opus_packet_has_fec( NULL, &Silk[1][0], (int)Silk[1].size() ) );
+
+	// the same SILK mode with FEC off
+	int error = 0;
+	OpusEncoder *encoder = opus_encoder_create( SAMPLE_RATE, 2, OPUS_APPLICATION_VOIP, &error );
+	opus_encoder_ctl( encoder, OPUS_SET_BITRATE( 16000 ) );
+	opus_encoder_ctl( encoder, OPUS_SET_SIGNAL( OPUS_SIGNAL_VOICE ) );
+	opus_encoder_ctl( encoder, OPUS_SET_PACKET_LOSS_PERC( 20 ) );
+	std::vector<short> pcm( SamplesPerChannel( SILK_MS ) * 2 );
+	unsigned char data[1500];
+	for ( int i = 0; i < 50; i++ )
+	{
+		for ( size_t s = 0; s < pcm.size(); s++ )
+		{
+			pcm[s] = (short)( 8000.0f * sinf( (float)( i * pcm.size() + s ) * 0.02f ) );
+		}
+		const int length = opus_encode( encoder, &pcm[0], SamplesPerChannel( SILK_MS ), data, sizeof( data ) );
+		ASSERT_GT( length, 0 );
+		ASSERT_LT( data[0] >> 3, 12 ) << "not SILK";
+		EXPECT_FALSE( nv_opus_packet_has_fec( decoder, data, length ) );
+	}
+	opus_encoder_destroy( encoder );
+	nv_opus_destroy( decoder );
+}
+
+TEST_F( JitterBuffer, FecIsFoundInAMultistreamPacket )
+{
+	const std::vector<Packet> packets = Encode( SURROUND_51, SILK_MS, 50, true );
+	nv_opus_decoder *decoder = nv_opus_create( SAMPLE_RATE, SURROUND_51.Channels, SURROUND_51.Streams,
+			SURROUND_51.CoupledStreams, SURROUND_51.Mapping, SamplesPerChannel( SILK_MS ), NULL );
+	int withFec = 0;
+	for ( size_t i = 1; i < packets.size(); i++ )
+	{
+		withFec += nv_opus_packet_has_fec( decoder, &packets[i][0], (int)packets[i].size() ) != 0;
+	}
+	// the first streams are self-delimited; read as plain ones the frame
+	// would start a byte early and the flags come out as noise
+	EXPECT_GT( withFec, 0 );
+	nv_opus_destroy( decoder );
+}
+
+// a damaged packet is read no further than its length
+TEST_F( JitterBuffer, FecOfATruncatedPacketIsNotFound )
+{
+	const std::vector<Packet> packets = Encode( SURROUND_51, SILK_MS, 20, true );
+	nv_opus_decoder *decoder = nv_opus_create( SAMPLE_RATE, SURROUND_51.Channels, SURROUND_51.Streams,
+			SURROUND_51.CoupledStreams, SURROUND_51.Mapping, SamplesPerChannel( SILK_MS ), NULL );
+	for ( size_t i = 0; i < packets.size(); i++ )
+	{
+		for ( size_t length = 1; length < 4; length++ )
+		{
+			// copied so that reading past the end is caught
+			const std::vector<unsigned char> truncated( packets[i].begin(), packets[i].begin() + length );
+			nv_opus_packet_has_fec( decoder, &truncated[0], (int)length );
+		}
+	}
+
+	// a code 3 packet claiming more padding than there is
+	const unsigned char padded[] = { 0x03, 0x41, 0xff, 0xff, 0x10 };
+	EXPECT_FALSE( nv_opus_packet_has_fec( decoder, padded, sizeof( padded ) ) );
+	nv_opus_destroy( decoder );
+}
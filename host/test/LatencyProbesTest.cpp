@@ -0,0 +1,189 @@
+/************************************************************************************
+
+Filename    :   LatencyProbesTest.cpp
+Content     :	Host tests of the latency probe pairing, percentiles and report
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "LatencyProbes.h"
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+std::string TempPath()
+{
+	char path[] = "/tmp/streamtheater_latencyXXXXXX";
+	close( mkstemp( path ) );
+	unlink( path );
+	return path;
+}
+
+std::vector<std::string> ReadLines( const std::string & path )
+{
+	std::vector<std::string> lines;
+	FILE * f = fopen( path.c_str(), "r" );
+	if ( f == NULL )
+	{
+		return lines;
+	}
+	char line[256];
+	while ( fgets( line, sizeof( line ), f ) != NULL )
+	{
+		std::string text( line );
+		if ( !text.empty() && text[text.size() - 1] == '\n' )
+		{
+			text.erase( text.size() - 1 );
+		}
+		lines.push_back( text );
+	}
+	fclose( f );
+	return lines;
+}
+
+float OnlySample( const LatencyProbes & probes, const LatencyInterval interval )
+{
+	const LatencyHistogram & h = probes.GetHistogram( interval );
+	EXPECT_EQ( 1, h.GetCount() ) << LatencyProbes::GetIntervalName( interval );
+	return h.GetPercentile( 50.0f );
+}
+
+}
+
+TEST( LatencyProbes, PairsEachStageWithTheOneBefore )
+{
+	LatencyProbes probes;
+	probes.InputSampled( 1.000 );
+	probes.EventSent( 1.010 );
+	probes.EventSent( 1.020 );			// folded into the first, no new input either
+	probes.FrameLatched( 1.050 );
+	probes.CopyDone( 1.052 );
+	probes.FrameSubmitted( 1.060 );
+
+	EXPECT_NEAR( 10.0f, OnlySample( probes, LATENCY_INPUT_TO_SEND ), 0.01f );
+	EXPECT_NEAR( 40.0f, OnlySample( probes, LATENCY_SEND_TO_LATCH ), 0.01f );
+	EXPECT_NEAR( 2.0f, OnlySample( probes, LATENCY_LATCH_TO_COPY ), 0.01f );
+	EXPECT_NEAR( 8.0f, OnlySample( probes, LATENCY_COPY_TO_SUBMIT ), 0.01f );
+	EXPECT_DOUBLE_EQ( 1.050, probes.GetLastLatchTime() );
+
+	// each start pairs once: nothing outstanding, nothing added
+	probes.FrameSubmitted( 1.070 );
+	probes.CopyDone( 1.071 );
+	probes.FrameSubmitted( 1.072 );
+	EXPECT_EQ( 1, probes.GetHistogram( LATENCY_LATCH_TO_COPY ).GetCount() );
+	EXPECT_EQ( 1, probes.GetHistogram( LATENCY_COPY_TO_SUBMIT ).GetCount() );
+
+	// a frame with no event before it still starts the copy interval
+	probes.FrameLatched( 2.000 );
+	probes.CopyDone( 2.003 );
+	EXPECT_EQ( 1, probes.GetHistogram( LATENCY_SEND_TO_LATCH ).GetCount() );
+	EXPECT_EQ( 2, probes.GetHistogram( LATENCY_LATCH_TO_COPY ).GetCount() );
+	EXPECT_EQ( 0, probes.GetHistogram( LATENCY_END_TO_END ).GetCount() );
+}
+
+TEST( LatencyProbes, DropsStallsAndBackwardsIntervals )
+{
+	LatencyProbes probes;
+	probes.EventSent( 1.0 );
+	probes.FrameLatched( 2.5 );			// a stall, not latency
+	probes.InputSampled( 3.0 );
+	probes.EventSent( 2.9 );
+	for ( int i = 0; i < LATENCY_INTERVAL_COUNT; i++ )
+	{
+		EXPECT_EQ( 0, probes.GetHistogram( (LatencyInterval)i ).GetCount() );
+	}
+
+	// the dropped pairings don't linger
+	probes.FrameLatched( 3.0 );
+	EXPECT_EQ( 1, probes.GetHistogram( LATENCY_SEND_TO_LATCH ).GetCount() );
+
+	probes.Reset();
+	EXPECT_EQ( 0, probes.GetHistogram( LATENCY_SEND_TO_LATCH ).GetTotal() );
+	probes.CopyDone( 3.1 );
+	EXPECT_EQ( 0, probes.GetHistogram( LATENCY_LATCH_TO_COPY ).GetCount() );
+}
+
+TEST( LatencyHistogram, NearestRankPercentiles )
+{
+	LatencyHistogram h;
+	EXPECT_EQ( 0.0f, h.GetPercentile( 50.0f ) );
+
+	// added out of order, the window is sorted for each percentile
+	for ( int i = 0; i < 100; i++ )
+	{
+		h.AddSample( (float)( ( i * 37 ) % 100 + 1 ) );
+	}
+	EXPECT_EQ( 1.0f, h.GetPercentile( 0.0f ) );
+	EXPECT_EQ( 50.0f, h.GetPercentile( 50.0f ) );
+	EXPECT_EQ( 95.0f, h.GetPercentile( 95.0f ) );
+	EXPECT_EQ( 99.0f, h.GetPercentile( 99.0f ) );
+	EXPECT_EQ( 100.0f, h.GetPercentile( 100.0f ) );
+	EXPECT_EQ( 96.0f, h.GetPercentile( 95.5f ) );		// ranks round up
+
+	h.Reset();
+	h.AddSample( 7.0f );
+	EXPECT_EQ( 7.0f, h.GetPercentile( 1.0f ) );
+	EXPECT_EQ( 7.0f, h.GetPercentile( 99.0f ) );
+}
+
+TEST( LatencyHistogram, KeepsTheMostRecentWindow )
+{
+	LatencyHistogram h;
+	const int total = LatencyHistogram::MAX_SAMPLES + 88;
+	for ( int i = 1; i <= total; i++ )
+	{
+		h.AddSample( (float)i );
+	}
+	EXPECT_EQ( (int)LatencyHistogram::MAX_SAMPLES, h.GetCount() );
+	EXPECT_EQ( total, h.GetTotal() );
+
+	// 89 to 600 are left
+	EXPECT_EQ( 89.0f, h.GetPercentile( 0.0f ) );
+	EXPECT_EQ( 89.0f + 255.0f, h.GetPercentile( 50.0f ) );
+	EXPECT_EQ( (float)total, h.GetPercentile( 100.0f ) );
+}
+
+TEST( LatencyProbes, WritesAReportLinePerInterval )
+{
+	LatencyProbes probes;
+	probes.InputSampled( 1.0 );
+	probes.EventSent( 1.004 );
+	for ( int i = 1; i <= 20; i++ )
+	{
+		probes.AddEndToEnd( (float)i * 10.0f );
+	}
+
+	const std::string path = TempPath();
+	ASSERT_TRUE( probes.WriteReport( path.c_str() ) );
+	const std::vector<std::string> lines = ReadLines( path );
+	unlink( path.c_str() );
+
+	ASSERT_EQ( (size_t)( 1 + LATENCY_INTERVAL_COUNT ), lines.size() );
+	EXPECT_EQ( "# interval, samples in window, total samples, p50 ms, p95 ms, p99 ms, max ms", lines[0] );
+	EXPECT_EQ( "input->send, 1, 1, 4.00, 4.00, 4.00, 4.00", lines[1] );
+	EXPECT_EQ( "send->latch, 0, 0, 0.00, 0.00, 0.00, 0.00", lines[2] );
+	EXPECT_EQ( "latch->copy, 0, 0, 0.00, 0.00, 0.00, 0.00", lines[3] );
+	EXPECT_EQ( "copy->submit, 0, 0, 0.00, 0.00, 0.00, 0.00", lines[4] );
+	EXPECT_EQ( "click->change, 20, 20, 100.00, 190.00, 200.00, 200.00", lines[5] );
+
+	// the summary skips the empty ones
+	char summary[256];
+	probes.GetSummary( summary, sizeof( summary ) );
+	EXPECT_STREQ( "input->send 4.0/4.0/4.0\nclick->change 100.0/190.0/200.0\n", summary );
+
+	EXPECT_FALSE( probes.WriteReport( "/nonexistent/latency.csv" ) );
+}
@@ -0,0 +1,242 @@
+/************************************************************************************
+
+Filename    :   MotionCalibrationTest.cpp
+Content     :	Host tests of the image motion estimator and the calibration solver
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "MotionCalibration.h"
+
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <vector>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+// the size the view reads the movie at
+static const int WIDTH = 96;
+static const int HEIGHT = 54;
+static const int RADIUS = 8;
+
+// Smooth texture, sampled with the content moved by (dx, dy), so that
+// sub-pixel shifts are exact
+std::vector<unsigned char> Texture( const float dx, const float dy )
+{
+	std::vector<unsigned char> image( WIDTH * HEIGHT );
+	for ( int y = 0; y < HEIGHT; y++ )
+	{
+		for ( int x = 0; x < WIDTH; x++ )
+		{
+			const float u = x - dx;
+			const float v = y - dy;
+			const float value = 128.0f + 50.0f * sinf( 0.35f * u + 0.2f * v ) + 40.0f * sinf( 0.27f * v - 0.15f * u + 1.0f )
+					+ 20.0f * sinf( 0.9f * u + 0.45f * v );
+			image[y * WIDTH + x] = (unsigned char)( value < 0.0f ? 0.0f : ( value > 255.0f ? 255.0f : value ) );
+		}
+	}
+	return image;
+}
+
+// microseconds, like the pose timestamps
+static const long FRAME_US = 16667;
+static const long POSE_US = 2000;
+
+float HeadYaw( const long t ) { return 0.3f * sinf( t * 1e-6f * 2.1f ) + 0.1f * sinf( t * 1e-6f * 5.3f ); }
+float HeadPitch( const long t ) { return 0.08f * sinf( t * 1e-6f * 1.7f + 0.5f ); }
+
+// Ten seconds of head motion, and frames whose image turned gain times
+// the head's turn latency earlier
+void Record( MotionCalibration & calibration, const long latency, const float yawGain, const float pitchGain )
+{
+	for ( long t = 0; t <= 10000000; t += POSE_US )
+	{
+		calibration.AddPose( t, HeadYaw( t ), HeadPitch( t ) );
+	}
+	for ( long t = latency + FRAME_US; t <= 10000000; t += FRAME_US )
+	{
+		const long head = t - latency;
+		calibration.AddFrame( t, yawGain * ( HeadYaw( head ) - HeadYaw( head - FRAME_US ) ),
+				pitchGain * ( HeadPitch( head ) - HeadPitch( head - FRAME_US ) ) );
+	}
+}
+
+}
+
+TEST( GlobalMotionEstimator, FindsWholePixelShifts )
+{
+	const std::vector<unsigned char> previous = Texture( 0.0f, 0.0f );
+	const int shifts[][2] = { { 0, 0 }, { 3, 0 }, { 0, -2 }, { -5, 4 }, { 7, 7 } };
+	for ( size_t i = 0; i < sizeof( shifts ) / sizeof( shifts[0] ); i++ )
+	{
+		const std::vector<unsigned char> current = Texture( (float)shifts[i][0], (float)shifts[i][1] );
+		float x, y;
+		ASSERT_TRUE( GlobalMotionEstimator::EstimateShift( &previous[0], &current[0], WIDTH, HEIGHT, RADIUS, x, y ) ) << i;
+		EXPECT_NEAR( shifts[i][0], x, 0.1f ) << i;
+		EXPECT_NEAR( shifts[i][1], y, 0.1f ) << i;
+	}
+}
+
+// Each axis gets its own fit, so on diagonal texture a single estimate can
+// be half a pixel out.  Calibration averages hundreds of them, what
+// matters there is that they aren't biased.
+TEST( GlobalMotionEstimator, InterpolatesBetweenPixels )
+{
+	const std::vector<unsigned char> previous = Texture( 0.0f, 0.0f );
+	double biasX = 0.0, biasY = 0.0, squares = 0.0;
+	int count = 0;
+	for ( int j = -12; j <= 12; j++ )
+	{
+		for ( int i = -12; i <= 12; i++ )
+		{
+			const float dx = i * 0.25f;
+			const float dy = j * 0.25f;
+			const std::vector<unsigned char> current = Texture( dx, dy );
+			float x, y;
+			if ( !GlobalMotionEstimator::EstimateShift( &previous[0], &current[0], WIDTH, HEIGHT, RADIUS, x, y ) )
+			{
+				continue;
+			}
+			EXPECT_NEAR( dx, x, 0.501f );
+			EXPECT_NEAR( dy, y, 0.501f );
+			biasX += x - dx;
+			biasY += y - dy;
+			squares += ( x - dx ) * ( x - dx ) + ( y - dy ) * ( y - dy );
+			count++;
+		}
+	}
+	ASSERT_GT( count, 25 * 25 * 9 / 10 );
+	EXPECT_NEAR( 0.0, biasX / count, 0.1 );
+	EXPECT_NEAR( 0.0, biasY / count, 0.1 );
+	EXPECT_LT( sqrt( squares / count / 2 ), 0.25 );
+}
+
+TEST( GlobalMotionEstimator, RejectsWhatItCantMeasure )
+{
+	float x, y;
+
+	// a fade has nothing to match
+	const std::vector<unsigned char> flat( WIDTH * HEIGHT, 90 );
+	EXPECT_FALSE( GlobalMotionEstimator::EstimateShift( &flat[0], &flat[0], WIDTH, HEIGHT, RADIUS, x, y ) );
+
+	// as fast as the search reaches may be further still
+	const std::vector<unsigned char> previous = Texture( 0.0f, 0.0f );
+	const std::vector<unsigned char> fast = Texture( (float)RADIUS, 0.0f );
+	EXPECT_FALSE( GlobalMotionEstimator::EstimateShift( &previous[0], &fast[0], WIDTH, HEIGHT, RADIUS, x, y ) );
+
+	// a scene cut matches nothing in particular
+	std::vector<unsigned char> cut( WIDTH * HEIGHT );
+	unsigned int seed = 1;
+	for ( size_t i = 0; i < cut.size(); i++ )
+	{
+		seed = seed * 1103515245 + 12345;
+		cut[i] = (unsigned char)( seed >> 16 );
+	}
+	EXPECT_FALSE( GlobalMotionEstimator::EstimateShift( &previous[0], &cut[0], WIDTH, HEIGHT, RADIUS, x, y ) );
+
+	// and too small a frame for the search
+	EXPECT_FALSE( GlobalMotionEstimator::EstimateShift( &previous[0], &previous[0], RADIUS * 4, HEIGHT, RADIUS, x, y ) );
+}
+
+TEST( MotionCalibration, SolvesForLatencyAndGain )
+{
+	const long latencies[] = { 0, 45000, 120000 };
+	for ( size_t i = 0; i < sizeof( latencies ) / sizeof( latencies[0] ); i++ )
+	{
+		MotionCalibration calibration;
+		Record( calibration, latencies[i], 1.3f, 0.8f );
+
+		MotionCalibrationResult result;
+		ASSERT_TRUE( calibration.Solve( 0, 200000, 1000, result ) ) << latencies[i];
+		EXPECT_NEAR( latencies[i], result.Latency, 2000 );
+		EXPECT_NEAR( 1.3f, result.YawGain, 0.05f );
+		EXPECT_NEAR( 0.8f, result.PitchGain, 0.05f );
+		EXPECT_GT( result.Correlation, 0.95f );
+	}
+}
+
+// the image moves against the head, the gains are magnitudes
+TEST( MotionCalibration, IgnoresTheDirectionOfTheImage )
+{
+	MotionCalibration calibration;
+	Record( calibration, 60000, -1.0f, -1.0f );
+	MotionCalibrationResult result;
+	ASSERT_TRUE( calibration.Solve( 0, 200000, 1000, result ) );
+	EXPECT_NEAR( 60000, result.Latency, 2000 );
+	EXPECT_NEAR( 1.0f, result.YawGain, 0.05f );
+}
+
+TEST( MotionCalibration, FailsWhenTheHeadDoesntExplainTheImage )
+{
+	MotionCalibration calibration;
+	for ( long t = 0; t <= 10000000; t += POSE_US )
+	{
+		calibration.AddPose( t, HeadYaw( t ), HeadPitch( t ) );
+	}
+	unsigned int seed = 7;
+	for ( long t = FRAME_US; t <= 10000000; t += FRAME_US )
+	{
+		seed = seed * 1103515245 + 12345;
+		const float x = ( (int)( seed >> 16 & 0xff ) - 128 ) * 1e-4f;
+		seed = seed * 1103515245 + 12345;
+		const float y = ( (int)( seed >> 16 & 0xff ) - 128 ) * 1e-4f;
+		calibration.AddFrame( t, x, y );
+	}
+	MotionCalibrationResult result;
+	EXPECT_FALSE( calibration.Solve( 0, 200000, 1000, result ) );
+	EXPECT_LT( result.Correlation, 0.5f );
+}
+
+TEST( MotionCalibration, NeedsEnoughFramesAndMotion )
+{
+	MotionCalibration calibration;
+	MotionCalibrationResult result;
+	for ( long t = 0; t <= 1000000; t += POSE_US )
+	{
+		calibration.AddPose( t, HeadYaw( t ), HeadPitch( t ) );
+	}
+	for ( int i = 1; i < MotionCalibration::MIN_SAMPLES; i++ )
+	{
+		calibration.AddFrame( i * FRAME_US, 0.01f, 0.0f );
+	}
+	EXPECT_EQ( MotionCalibration::MIN_SAMPLES - 2, calibration.GetNumFrames() );
+	EXPECT_FALSE( calibration.Solve( 0, 200000, 1000, result ) );
+
+	// a head held still explains nothing
+	calibration.Reset();
+	EXPECT_EQ( 0.0f, calibration.GetHeadTravel() );
+	for ( long t = 0; t <= 10000000; t += POSE_US )
+	{
+		calibration.AddPose( t, 0.1f, 0.0f );
+	}
+	for ( long t = FRAME_US; t <= 10000000; t += FRAME_US )
+	{
+		calibration.AddFrame( t, 0.01f, 0.0f );
+	}
+	EXPECT_EQ( 0.0f, calibration.GetHeadTravel() );
+	EXPECT_FALSE( calibration.Solve( 0, 200000, 1000, result ) );
+}
+
+TEST( MotionCalibration, DropsPosesOutOfOrder )
+{
+	MotionCalibration calibration;
+	calibration.AddPose( 1000, 0.0f, 0.0f );
+	calibration.AddPose( 2000, 0.1f, 0.0f );
+	calibration.AddPose( 1500, 1.0f, 1.0f );
+	calibration.AddPose( 3000, 0.1f, -0.2f );
+	EXPECT_NEAR( 0.3f, calibration.GetHeadTravel(), 1e-6f );
+
+	// across the wrap is a short turn, not a full one
+	calibration.AddPose( 4000, (float)M_PI - 0.05f, -0.2f );
+	calibration.AddPose( 5000, -(float)M_PI + 0.05f, -0.2f );
+	EXPECT_NEAR( 0.3f + (float)M_PI - 0.15f + 0.1f, calibration.GetHeadTravel(), 1e-4f );
+}
@@ -0,0 +1,122 @@
+/************************************************************************************
+
+Filename    :   OpusDecoderTest.cpp
+Content     :	Host tests of the handle based Opus decoder
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "nv_opus_dec.h"
+#include "SyntheticOpus.h"
+
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+
+using namespace SyntheticOpus;
+
+namespace {
+
+nv_opus_decoder * Create( const Layout &layout, const int frameMs )
+{
+	int error = -1;
+	nv_opus_decoder *decoder = nv_opus_create( SAMPLE_RATE, layout.Channels, layout.Streams, layout.CoupledStreams,
+			layout.Mapping, SamplesPerChannel( frameMs ), &error );
+	EXPECT_EQ( OPUS_OK, error );
+	return decoder;
+}
+
+std::vector<short> DecodeAll( nv_opus_decoder *decoder, const std::vector<Packet> &packets )
+{
+	const int samples = nv_opus_get_samples_per_channel( decoder );
+	const int channels = nv_opus_get_channel_count( decoder );
+	std::vector<short> pcm( packets.size() * samples * channels );
+	for ( size_t i = 0; i < packets.size(); i++ )
+	{
+		EXPECT_EQ( samples, nv_opus_decode( decoder, &packets[i][0], (int)packets[i].size(), &pcm[i * samples * channels] ) );
+	}
+	return pcm;
+}
+
+struct DecodeJob
+{
+	const std::vector<Packet> *	Packets;
+	std::vector<short>			Pcm;
+};
+
+void * DecodeThread( void *arg )
+{
+	DecodeJob *job = (DecodeJob *)arg;
+	nv_opus_decoder *decoder = Create( SURROUND_51, 10 );
+	job->Pcm = DecodeAll( decoder, *job->Packets );
+	nv_opus_destroy( decoder );
+	return NULL;
+}
+
+}
+
+TEST( OpusDecoder, RejectsABadLayout )
+{
+	const unsigned char mapping[2] = { 0, 1 };
+	int error = 0;
+	EXPECT_EQ( NULL, nv_opus_create( SAMPLE_RATE, 2, 0, 1, mapping, 480, &error ) );
+	EXPECT_NE( OPUS_OK, error );
+}
+
+TEST( OpusDecoder, ResetWithoutAContextIsAnError )
+{
+	EXPECT_EQ( OPUS_BAD_ARG, nv_opus_reset( NULL ) );
+	nv_opus_destroy( NULL );
+}
+
+TEST( OpusDecoder, ResetDecodesLikeANewDecoder )
+{
+	const std::vector<Packet> packets = Encode( STEREO, 20, 25, false );
+	ASSERT_FALSE( packets.empty() );
+
+	nv_opus_decoder *decoder = Create( STEREO, 20 );
+	const std::vector<short> first = DecodeAll( decoder, packets );
+	EXPECT_EQ( OPUS_OK, nv_opus_reset( decoder ) );
+	EXPECT_EQ( first, DecodeAll( decoder, packets ) );
+	nv_opus_destroy( decoder );
+}
+
+TEST( OpusDecoder, ConcealmentFillsAFrame )
+{
+	const std::vector<Packet> packets = Encode( STEREO, 10, 10, false );
+	nv_opus_decoder *decoder = Create( STEREO, 10 );
+	DecodeAll( decoder, packets );
+	std::vector<short> pcm( SamplesPerChannel( 10 ) * 2 );
+	EXPECT_EQ( SamplesPerChannel( 10 ), nv_opus_decode_plc( decoder, &pcm[0] ) );
+	nv_opus_destroy( decoder );
+}
+
+TEST( OpusDecoder, ContextsDecodeIndependentlyOnThreads )
+{
+	const std::vector<Packet> packets = Encode( SURROUND_51, 10, 50, false );
+	ASSERT_FALSE( packets.empty() );
+
+	nv_opus_decoder *decoder = Create( SURROUND_51, 10 );
+	const std::vector<short> expected = DecodeAll( decoder, packets );
+	nv_opus_destroy( decoder );
+
+	static const int THREADS = 4;
+	DecodeJob jobs[THREADS];
+	pthread_t threads[THREADS];
+	for ( int i = 0; i < THREADS; i++ )
+	{
+		jobs[i].Packets = &packets;
+		pthread_create( &threads[i], NULL, DecodeThread, &jobs[i] );
+	}
+	for ( int i = 0; i < THREADS; i++ )
+	{
+		pthread_join( threads[i], NULL );
+		EXPECT_EQ( expected, jobs[i].Pcm );
+	}
+}
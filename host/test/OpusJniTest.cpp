@@ -0,0 +1,172 @@
+/************************************************************************************
+
+Filename    :   OpusJniTest.cpp
+Content     :	Host tests of the Opus JNI glue, called through a stand-in VM
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "FakeJni.h"
+#include "SyntheticOpus.h"
+
+#include <gtest/gtest.h>
+
+using namespace SyntheticOpus;
+
+namespace {
+
+static const int FRAME_MS = 10;
+
+class OpusJni : public ::testing::Test
+{
+protected:
+	FakeJni		Jni;
+	JNIEnv *	Env;
+	FakeArray	Pcm;
+
+	OpusJni() : Env( Jni.GetEnv() ), Pcm( SamplesPerChannel( FRAME_MS ) * STEREO.Channels * 2 ) {}
+
+	virtual void SetUp()
+	{
+		FakeArray mapping( STEREO.Channels );
+		memcpy( mapping.Bytes.data(), STEREO.Mapping, STEREO.Channels );
+		ASSERT_EQ( OPUS_OK, Java_com_limelight_nvstream_av_audio_OpusDecoder_init( Env, NULL, SAMPLE_RATE,
+				SamplesPerChannel( FRAME_MS ), STEREO.Channels, STEREO.Streams, STEREO.CoupledStreams, mapping.Java() ) );
+		EXPECT_EQ( 0, mapping.CopyBacks );
+	}
+
+	virtual void TearDown()
+	{
+		Java_com_limelight_nvstream_av_audio_OpusDecoder_destroy( Env, NULL );
+	}
+
+	jint Decode( FakeArray *in, const jint off, const jint len )
+	{
+		return Java_com_limelight_nvstream_av_audio_OpusDecoder_decode( Env, NULL, in != NULL ? in->Java() : NULL,
+				off, len, Pcm.Java() );
+	}
+};
+
+}
+
+TEST_F( OpusJni, DecodesPacketsAtAnOffset )
+{
+	const std::vector<Packet> packets = Encode( STEREO, FRAME_MS, 20, false );
+	ASSERT_FALSE( packets.empty() );
+
+	const int frameBytes = SamplesPerChannel( FRAME_MS ) * STEREO.Channels * 2;
+	int bytes = 0;
+	for ( size_t i = 0; i < packets.size(); i++ )
+	{
+		// the packet sits behind a header, as in the RTP buffer Java passes
+		FakeArray in( 12 + packets[i].size() );
+		memcpy( &in.Bytes[12], &packets[i][0], packets[i].size() );
+		const jint ret = Decode( &in, 12, (jint)packets[i].size() );
+		ASSERT_EQ( frameBytes, ret );
+		bytes += ret;
+	}
+	EXPECT_EQ( (int)packets.size() * frameBytes, bytes );
+	EXPECT_EQ( (int)packets.size(), Pcm.Writes );
+	EXPECT_EQ( 0, Pcm.Copies );
+	EXPECT_EQ( 0, Pcm.Pins );
+}
+
+// The packet is copied out and the frame copied back, nothing is pinned
+// while the decoder runs, and a lost packet reads nothing
+TEST_F( OpusJni, NeverPinsAnArray )
+{
+	const std::vector<Packet> packets = Encode( STEREO, FRAME_MS, 3, false );
+	FakeArray in( packets[0].size() );
+	memcpy( in.Bytes.data(), &packets[0][0], packets[0].size() );
+	Decode( &in, 0, (jint)in.Bytes.size() );
+	Decode( NULL, 0, 0 );
+	EXPECT_EQ( 1, in.Reads );
+	EXPECT_EQ( 0, in.Pins + in.Copies );
+	EXPECT_EQ( 2, Pcm.Writes );
+	EXPECT_EQ( 0, Pcm.Pins + Pcm.Copies );
+
+	// no Opus packet is bigger than the jitter buffer takes
+	FakeArray huge( 4096 );
+	EXPECT_EQ( -1, Decode( &huge, 0, (jint)huge.Bytes.size() ) );
+	EXPECT_EQ( 0, huge.Reads );
+}
+
+TEST_F( OpusJni, ALostPacketStillPlaysAFrame )
+{
+	const std::vector<Packet> packets = Encode( STEREO, FRAME_MS, 5, false );
+	for ( size_t i = 0; i < packets.size(); i++ )
+	{
+		FakeArray in( packets[i].size() );
+		memcpy( in.Bytes.data(), &packets[i][0], packets[i].size() );
+		Decode( &in, 0, (jint)in.Bytes.size() );
+	}
+	EXPECT_EQ( (jint)Pcm.Bytes.size(), Decode( NULL, 0, 0 ) );
+}
+
+TEST_F( OpusJni, RejectsOffsetsOutsideTheInput )
+{
+	FakeArray in( 64 );
+	EXPECT_EQ( -1, Decode( &in, -1, 10 ) );
+	EXPECT_EQ( -1, Decode( &in, 0, -1 ) );
+	EXPECT_EQ( -1, Decode( &in, 60, 10 ) );
+	EXPECT_EQ( -1, Decode( &in, 65, 0 ) );
+	EXPECT_EQ( -1, Decode( &in, 0x7fffffff, 0x7fffffff ) );
+	EXPECT_EQ( 0, in.Reads );
+	EXPECT_EQ( 0, Pcm.Writes );
+}
+
+TEST_F( OpusJni, RejectsAShortOutputBuffer )
+{
+	const std::vector<Packet> packets = Encode( STEREO, FRAME_MS, 1, false );
+	FakeArray in( packets[0].size() );
+	memcpy( in.Bytes.data(), &packets[0][0], packets[0].size() );
+
+	FakeArray shortPcm( Pcm.Bytes.size() - 2 );
+	EXPECT_EQ( -1, Java_com_limelight_nvstream_av_audio_OpusDecoder_decode( Env, NULL, in.Java(), 0,
+			(jint)in.Bytes.size(), shortPcm.Java() ) );
+	EXPECT_EQ( 0, shortPcm.Writes );
+	EXPECT_EQ( -1, Java_com_limelight_nvstream_av_audio_OpusDecoder_decode( Env, NULL, in.Java(), 0,
+			(jint)in.Bytes.size(), NULL ) );
+}
+
+// Java drops what decode returns while the native sink plays, so the
+// output array isn't written at all
+TEST_F( OpusJni, TheSinkLeavesTheJavaArrayAlone )
+{
+	const std::vector<Packet> packets = Encode( STEREO, FRAME_MS, 20, false );
+	ASSERT_EQ( JNI_TRUE, Java_com_limelight_binding_audio_NativeAudioSink_start( Env, NULL, SAMPLE_RATE,
+			STEREO.Channels, SamplesPerChannel( FRAME_MS ), 30 ) );
+	for ( size_t i = 0; i < packets.size(); i++ )
+	{
+		FakeArray in( packets[i].size() );
+		memcpy( in.Bytes.data(), &packets[i][0], packets[i].size() );
+		EXPECT_EQ( (jint)Pcm.Bytes.size(), Decode( &in, 0, (jint)in.Bytes.size() ) );
+	}
+	EXPECT_EQ( 0, Pcm.Writes + Pcm.Pins + Pcm.CopyBacks );
+	EXPECT_EQ( std::vector<jbyte>( Pcm.Bytes.size(), 0 ), Pcm.Bytes );
+
+	FakeArray stats;
+	stats.Ints.resize( 8 );
+	Java_com_limelight_binding_audio_NativeAudioSink_getStats( Env, NULL, (jintArray)stats.Java() );
+	EXPECT_GT( stats.Ints[5] + stats.Ints[0], 0 );		// queued or already played
+
+	// without it the frames go to Java again
+	Java_com_limelight_binding_audio_NativeAudioSink_stop( Env, NULL );
+	FakeArray in( packets[0].size() );
+	memcpy( in.Bytes.data(), &packets[0][0], packets[0].size() );
+	Decode( &in, 0, (jint)in.Bytes.size() );
+	EXPECT_EQ( 1, Pcm.Writes );
+}
+
+TEST( OpusJniDestroyed, DecodeWithoutADecoderFails )
+{
+	FakeJni jni;
+	FakeArray pcm( 4096 );
+	EXPECT_EQ( -1, Java_com_limelight_nvstream_av_audio_OpusDecoder_decode( jni.GetEnv(), NULL, NULL, 0, 0, pcm.Java() ) );
+}
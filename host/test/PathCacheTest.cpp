@@ -0,0 +1,245 @@
+/************************************************************************************
+
+Filename    :   PathCacheTest.cpp
+Content     :	Host tests of the directory cache, its roots and revalidation
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "PathCache.h"
+
+#include <gtest/gtest.h>
+
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+int RemoveEntry( const char * path, const struct stat *, int, struct FTW * )
+{
+	return remove( path );
+}
+
+// a scratch directory that's gone again after the test
+class TempTree
+{
+public:
+	TempTree()
+	{
+		char path[] = "/tmp/streamtheater_pathcacheXXXXXX";
+		Root = mkdtemp( path );
+	}
+
+	~TempTree()
+	{
+		nftw( Root.ToCStr(), RemoveEntry, 16, FTW_DEPTH | FTW_PHYS );
+	}
+
+	String Path( const char * relativePath ) const
+	{
+		String path = Root;
+		path.AppendString( "/" );
+		path.AppendString( relativePath );
+		return path;
+	}
+
+	void MakeDirectory( const char * relativePath ) const
+	{
+		ASSERT_EQ( 0, mkdir( Path( relativePath ).ToCStr(), 0755 ) );
+	}
+
+	void MakeFile( const char * relativePath ) const
+	{
+		FILE * f = fopen( Path( relativePath ).ToCStr(), "w" );
+		ASSERT_TRUE( f != NULL );
+		fclose( f );
+	}
+
+	// utime only raises IN_ATTRIB, which the cache doesn't watch for
+	void SetModifiedTime( const char * relativePath, const time_t time ) const
+	{
+		struct utimbuf times;
+		times.actime = time;
+		times.modtime = time;
+		ASSERT_EQ( 0, utime( Path( relativePath ).ToCStr(), &times ) );
+	}
+
+	String	Root;
+};
+
+}
+
+TEST( PathCache, ResolvesUnderTheFirstRootThatHasIt )
+{
+	TempTree tree;
+	tree.MakeDirectory( "first" );
+	tree.MakeDirectory( "second" );
+	tree.MakeDirectory( "second/Posters" );
+	tree.MakeFile( "first/movie.mp4" );
+	tree.MakeFile( "second/movie.mp4" );
+	tree.MakeFile( "second/Posters/movie.png" );
+
+	PathCache cache;
+	cache.AddRoot( tree.Path( "first/" ).ToCStr() );
+	cache.AddRoot( tree.Path( "second" ).ToCStr() );
+	EXPECT_EQ( 2, cache.GetNumRoots() );
+	EXPECT_EQ( tree.Path( "first" ), cache.GetRoot( 0 ) );
+	EXPECT_EQ( String(), cache.GetRoot( 2 ) );
+
+	String fullPath;
+	ASSERT_TRUE( cache.Resolve( "movie.mp4", fullPath ) );
+	EXPECT_EQ( tree.Path( "first/movie.mp4" ), fullPath );
+
+	ASSERT_TRUE( cache.Resolve( "Posters/movie.png", fullPath ) );
+	EXPECT_EQ( tree.Path( "second/Posters/movie.png" ), fullPath );
+
+	fullPath = "untouched";
+	EXPECT_FALSE( cache.Resolve( "missing.mp4", fullPath ) );
+	EXPECT_FALSE( cache.Resolve( "Missing/movie.png", fullPath ) );
+	EXPECT_EQ( String( "untouched" ), fullPath );
+
+	// a trailing slash asks about the directory itself
+	EXPECT_TRUE( cache.Resolve( "Posters/", fullPath ) );
+	EXPECT_FALSE( cache.Resolve( "movie.mp4/", fullPath ) );
+}
+
+TEST( PathCache, ReadsEachDirectoryOnce )
+{
+	TempTree tree;
+	tree.MakeFile( "b.MP4" );
+	tree.MakeFile( "a.mp4" );
+	tree.MakeFile( "c.png" );
+
+	PathCache cache;
+	EXPECT_TRUE( cache.FileExists( tree.Path( "a.mp4" ).ToCStr() ) );
+	EXPECT_TRUE( cache.FileExists( tree.Path( "b.MP4" ).ToCStr() ) );
+	EXPECT_FALSE( cache.FileExists( tree.Path( "d.mp4" ).ToCStr() ) );
+	EXPECT_EQ( 1, cache.GetMisses() );
+	EXPECT_EQ( 2, cache.GetHits() );
+
+	// sorted, extension matched without case
+	Array<String> names;
+	cache.ListDirectory( ( tree.Root + "/" ).ToCStr(), ".mp4", names );
+	ASSERT_EQ( 2, names.GetSizeI() );
+	EXPECT_EQ( String( "a.mp4" ), names[0] );
+	EXPECT_EQ( String( "b.MP4" ), names[1] );
+	EXPECT_EQ( 1, cache.GetMisses() );
+	EXPECT_EQ( 1, cache.GetNumDirectories() );
+}
+
+TEST( PathCache, CachesMissingDirectories )
+{
+	TempTree tree;
+	PathCache cache;
+
+	const String file = tree.Path( "Movies/movie.mp4" );
+	EXPECT_FALSE( cache.FileExists( file.ToCStr() ) );
+	EXPECT_FALSE( cache.FileExists( file.ToCStr() ) );
+	EXPECT_EQ( 1, cache.GetMisses() );
+
+	// not seen until the directory is dropped from the cache
+	tree.MakeDirectory( "Movies" );
+	tree.MakeFile( "Movies/movie.mp4" );
+	EXPECT_FALSE( cache.FileExists( file.ToCStr() ) );
+
+	// a missing directory has no watch, so the next poll notices it
+	cache.Revalidate( 2.0 );
+	EXPECT_TRUE( cache.FileExists( file.ToCStr() ) );
+	EXPECT_EQ( 2, cache.GetMisses() );
+}
+
+TEST( PathCache, InvalidatesOneDirectoryOrAll )
+{
+	TempTree tree;
+	tree.MakeDirectory( "Movies" );
+	tree.MakeDirectory( "Posters" );
+
+	PathCache cache;
+	EXPECT_FALSE( cache.FileExists( tree.Path( "Movies/movie.mp4" ).ToCStr() ) );
+	EXPECT_FALSE( cache.FileExists( tree.Path( "Posters/movie.png" ).ToCStr() ) );
+	EXPECT_EQ( 2, cache.GetNumDirectories() );
+
+	tree.MakeFile( "Movies/movie.mp4" );
+	tree.MakeFile( "Posters/movie.png" );
+
+	// trailing slash or not, it's the same directory
+	cache.Invalidate( tree.Path( "Movies/" ).ToCStr() );
+	EXPECT_EQ( 1, cache.GetNumDirectories() );
+	EXPECT_TRUE( cache.FileExists( tree.Path( "Movies/movie.mp4" ).ToCStr() ) );
+	EXPECT_FALSE( cache.FileExists( tree.Path( "Posters/movie.png" ).ToCStr() ) );
+
+	cache.Invalidate( NULL );
+	EXPECT_EQ( 0, cache.GetNumDirectories() );
+	EXPECT_TRUE( cache.FileExists( tree.Path( "Posters/movie.png" ).ToCStr() ) );
+}
+
+TEST( PathCache, StartsOverPastMaxDirectories )
+{
+	TempTree tree;
+	PathCache cache;
+
+	for ( int i = 0; i < PathCache::MAX_DIRECTORIES; i++ )
+	{
+		char name[32];
+		snprintf( name, sizeof( name ), "dir%i/file", i );
+		EXPECT_FALSE( cache.FileExists( tree.Path( name ).ToCStr() ) );
+	}
+	EXPECT_EQ( (int)PathCache::MAX_DIRECTORIES, cache.GetNumDirectories() );
+
+	EXPECT_FALSE( cache.FileExists( tree.Path( "one_more/file" ).ToCStr() ) );
+	EXPECT_EQ( 1, cache.GetNumDirectories() );
+
+	// the earlier ones are read again
+	const int misses = cache.GetMisses();
+	EXPECT_FALSE( cache.FileExists( tree.Path( "dir0/file" ).ToCStr() ) );
+	EXPECT_EQ( misses + 1, cache.GetMisses() );
+	EXPECT_EQ( 2, cache.GetNumDirectories() );
+}
+
+// Changes inotify didn't report, like the ones FUSE and sdcardfs miss,
+// are found by the slower poll of watched directories
+TEST( PathCache, PollsWatchedDirectoriesSlowly )
+{
+	const int notify = inotify_init();
+	if ( notify < 0 )
+	{
+		GTEST_SKIP() << "no inotify, every directory is polled";
+	}
+	close( notify );
+
+	TempTree tree;
+	tree.MakeDirectory( "Movies" );
+	tree.SetModifiedTime( "Movies", 1000000 );
+
+	PathCache cache;
+	const String file = tree.Path( "Movies/movie.mp4" );
+	EXPECT_FALSE( cache.FileExists( file.ToCStr() ) );
+	cache.Revalidate( 10.0 );
+	EXPECT_FALSE( cache.FileExists( file.ToCStr() ) );
+	const int misses = cache.GetMisses();
+
+	tree.SetModifiedTime( "Movies", 2000000 );
+
+	// the unwatched poll leaves it alone
+	cache.Revalidate( 12.0 );
+	cache.Revalidate( 14.0 );
+	EXPECT_FALSE( cache.FileExists( file.ToCStr() ) );
+	EXPECT_EQ( misses, cache.GetMisses() );
+
+	cache.Revalidate( 20.0 );
+	EXPECT_FALSE( cache.FileExists( file.ToCStr() ) );
+	EXPECT_EQ( misses + 1, cache.GetMisses() );
+}
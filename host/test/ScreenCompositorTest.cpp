@@ -0,0 +1,223 @@
+/************************************************************************************
+
+Filename    :   ScreenCompositorTest.cpp
+Content     :	Host tests of the copy budget shared between several screens
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ScreenCompositor.h"
+
+#include <gtest/gtest.h>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+static const double FRAME_SECONDS = 1.0 / 60.0;
+static const int PIXELS_1080P = 1920 * 1080;
+
+CompositorScreen Screen( const float gazeAngle, const int copyPixels = PIXELS_1080P, const bool canOverlay = false )
+{
+	CompositorScreen screen;
+	screen.Pending = true;
+	screen.CopyPixels = copyPixels;
+	screen.GazeAngle = gazeAngle;
+	screen.Radius = 0.3f;
+	screen.CanOverlay = canOverlay;
+	return screen;
+}
+
+// looks at screen, the others a radian or more away
+void LookAt( CompositorScreen * screens, const int count, const int screen )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		screens[i].GazeAngle = ( i == screen ) ? 0.0f : 1.0f + i;
+	}
+}
+
+}
+
+TEST( ScreenCompositor, CopiesTheFocusAndOverlaysIt )
+{
+	ScreenCompositor compositor;
+	CompositorScreen screen = Screen( 0.0f, PIXELS_1080P, true );
+	CompositorDecision decision;
+	EXPECT_EQ( 0, compositor.Plan( &screen, 1, 0.0, &decision ) );
+	EXPECT_TRUE( decision.Copy );
+	EXPECT_TRUE( decision.Overlay );
+	EXPECT_EQ( 0, compositor.GetOverlay() );
+
+	// nothing new, nothing copied, but it stays on the overlay
+	screen.Pending = false;
+	compositor.Plan( &screen, 1, FRAME_SECONDS, &decision );
+	EXPECT_FALSE( decision.Copy );
+	EXPECT_TRUE( decision.Overlay );
+	EXPECT_EQ( 1, compositor.GetCopies( 0 ) );
+
+	// even past the budget
+	compositor.SetPixelBudget( 0 );
+	screen.Pending = true;
+	screen.CanOverlay = false;
+	compositor.Plan( &screen, 1, FRAME_SECONDS * 2, &decision );
+	EXPECT_TRUE( decision.Copy );
+	EXPECT_FALSE( decision.Overlay );
+	EXPECT_EQ( -1, compositor.GetOverlay() );
+
+	EXPECT_EQ( -1, compositor.Plan( NULL, 0, FRAME_SECONDS * 3, NULL ) );
+	EXPECT_EQ( -1, compositor.GetFocus() );
+}
+
+// The gaze has to stay on another screen FOCUS_SWITCH_SECONDS before the
+// focus, and the overlay with it, moves
+TEST( ScreenCompositor, FocusFollowsTheGazeOnlyOnceItStays )
+{
+	ScreenCompositor compositor;
+	CompositorScreen screens[2] = { Screen( 0.0f, PIXELS_1080P, true ), Screen( 1.0f, PIXELS_1080P, true ) };
+	CompositorDecision decisions[2];
+	double now = 0.0;
+	EXPECT_EQ( 0, compositor.Plan( screens, 2, now, decisions ) );
+
+	// a glance across and back changes nothing
+	LookAt( screens, 2, 1 );
+	for ( int i = 0; i < 20; i++ )
+	{
+		now += FRAME_SECONDS;
+		EXPECT_EQ( 0, compositor.Plan( screens, 2, now, decisions ) );
+	}
+	LookAt( screens, 2, 0 );
+	now += FRAME_SECONDS;
+	EXPECT_EQ( 0, compositor.Plan( screens, 2, now, decisions ) );
+
+	// the dwell starts over with the next look
+	LookAt( screens, 2, 1 );
+	const double start = now + FRAME_SECONDS;
+	int focus = 0;
+	while ( focus == 0 && now < start + 1.0 )
+	{
+		now += FRAME_SECONDS;
+		focus = compositor.Plan( screens, 2, now, decisions );
+	}
+	EXPECT_EQ( 1, focus );
+	EXPECT_NEAR( 0.4, now - start, FRAME_SECONDS * 1.01 );
+	EXPECT_TRUE( decisions[1].Overlay );
+	EXPECT_FALSE( decisions[0].Overlay );
+	EXPECT_EQ( 1, compositor.GetOverlay() );
+}
+
+// The gaze is measured in screen radii, so the big screen it's inside
+// of wins over a small one whose center is a bit closer
+TEST( ScreenCompositor, JudgesTheGazeBySize )
+{
+	ScreenCompositor compositor;
+	CompositorScreen screens[2] = { Screen( 0.1f ), Screen( 0.2f ) };
+	screens[0].Radius = 0.05f;
+	screens[1].Radius = 0.6f;
+	CompositorDecision decisions[2];
+	EXPECT_EQ( 1, compositor.Plan( screens, 2, 0.0, decisions ) );
+
+	compositor.Reset();
+	screens[1].Radius = 0.0f;		// a degenerate screen never wins by dividing by zero
+	EXPECT_EQ( 0, compositor.Plan( screens, 2, 0.0, decisions ) );
+}
+
+// Small screens all fit.  With room for two 1080p copies the two aside
+// take turns, the one waiting longest goes first, and both keep 30 fps.
+TEST( ScreenCompositor, SharesTheBudgetLongestWaitingFirst )
+{
+	ScreenCompositor compositor;
+	CompositorScreen small[3] = { Screen( 0.0f, 640 * 360 ), Screen( 1.0f, 640 * 360 ), Screen( 2.0f, 640 * 360 ) };
+	CompositorDecision decisions[3];
+	double now = 0.0;
+	for ( int frame = 0; frame < 60; frame++, now += FRAME_SECONDS )
+	{
+		compositor.Plan( small, 3, now, decisions );
+	}
+	for ( int i = 0; i < 3; i++ )
+	{
+		EXPECT_EQ( 60, compositor.GetCopies( i ) ) << i;
+		EXPECT_EQ( 0, compositor.GetDeferred( i ) ) << i;
+	}
+
+	compositor.Reset();
+	compositor.SetPixelBudget( PIXELS_1080P * 2 );
+	CompositorScreen big[3] = { Screen( 0.0f ), Screen( 1.0f ), Screen( 2.0f ) };
+	compositor.Plan( big, 3, now, decisions );		// never copied, so the first frame takes all
+	for ( int frame = 1; frame < 61; frame++ )
+	{
+		now += FRAME_SECONDS;
+		compositor.Plan( big, 3, now, decisions );
+		EXPECT_TRUE( decisions[0].Copy );
+		EXPECT_NE( decisions[1].Copy, decisions[2].Copy ) << frame;
+		EXPECT_EQ( frame % 2 == 1, decisions[1].Copy ) << frame;
+	}
+	EXPECT_EQ( 61, compositor.GetCopies( 0 ) );
+	EXPECT_EQ( 31, compositor.GetCopies( 1 ) );
+	EXPECT_EQ( 31, compositor.GetCopies( 2 ) );
+	EXPECT_EQ( 30, compositor.GetDeferred( 1 ) );
+}
+
+// With no budget left the others are copied one a frame, each once it
+// has waited MAX_STALE_SECONDS, so none of them freezes
+TEST( ScreenCompositor, NothingFreezes )
+{
+	ScreenCompositor compositor;
+	compositor.SetPixelBudget( PIXELS_1080P );
+	CompositorScreen screens[4] = { Screen( 0.0f ), Screen( 1.0f ), Screen( 2.0f ), Screen( 3.0f ) };
+	CompositorDecision decisions[4];
+	double lastCopy[4] = { 0.0, 0.0, 0.0, 0.0 };
+	double longest = 0.0;
+	double now = 0.0;
+	for ( int frame = 0; frame < 120; frame++, now += FRAME_SECONDS )
+	{
+		compositor.Plan( screens, 4, now, decisions );
+		int copied = 0;
+		for ( int i = 1; i < 4; i++ )
+		{
+			if ( decisions[i].Copy )
+			{
+				copied++;
+				if ( frame > 0 && now - lastCopy[i] > longest )
+				{
+					longest = now - lastCopy[i];
+				}
+				lastCopy[i] = now;
+			}
+		}
+		EXPECT_LE( copied, 1 ) << frame;
+	}
+	EXPECT_LE( longest, 0.1 + FRAME_SECONDS * 1.01 );
+	for ( int i = 1; i < 4; i++ )
+	{
+		EXPECT_GT( compositor.GetCopies( i ), 120 / 8 ) << i;
+	}
+}
+
+// screens past MAX_SCREENS are neither copied nor looked at
+TEST( ScreenCompositor, IgnoresScreensPastTheMost )
+{
+	const int count = ScreenCompositor::MAX_SCREENS + 2;
+	CompositorScreen screens[count];
+	for ( int i = 0; i < count; i++ )
+	{
+		screens[i] = Screen( 1.0f, 64 * 64, true );
+	}
+	screens[count - 1].GazeAngle = 0.0f;
+	CompositorDecision decisions[count];
+	decisions[count - 1].Copy = true;
+
+	ScreenCompositor compositor;
+	const int focus = compositor.Plan( screens, count, 0.0, decisions );
+	EXPECT_LT( focus, (int)ScreenCompositor::MAX_SCREENS );
+	for ( int i = 0; i < count; i++ )
+	{
+		EXPECT_EQ( i < ScreenCompositor::MAX_SCREENS, decisions[i].Copy ) << i;
+	}
+}
@@ -0,0 +1,103 @@
+/************************************************************************************
+
+Filename    :   ScreenMathTest.cpp
+Content     :	Host tests of the screen placement math and the pose history
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ScreenMath.h"
+#include "PoseHistory.h"
+#include "Lerp.h"
+
+#include <gtest/gtest.h>
+
+using namespace VRMatterStreamTheater;
+
+TEST( ScreenMath, BoundsScreenMatrixFitsTheMovie )
+{
+	// a 4 x 2 screen facing +Z, a 16:9 movie is limited by the height
+	const Bounds3f bounds( Vector3f( -2.0f, 0.0f, -5.0f ), Vector3f( 2.0f, 2.0f, -5.0f ) );
+	const Matrix4f m = BoundsScreenMatrix( bounds, 16.0f / 9.0f );
+
+	const Vector3f center = m.Transform( Vector3f( 0.0f ) );
+	EXPECT_NEAR( 0.0f, center.x, 1e-5f );
+	EXPECT_NEAR( 1.0f, center.y, 1e-5f );
+	EXPECT_NEAR( -5.0f, center.z, 1e-5f );
+
+	const Vector3f corner = m.Transform( Vector3f( 1.0f, 1.0f, 0.0f ) );
+	EXPECT_NEAR( 16.0f / 9.0f, corner.x, 1e-5f );
+	EXPECT_NEAR( 2.0f, corner.y, 1e-5f );
+
+	// and a 4:1 movie by the width
+	const Vector3f wide = BoundsScreenMatrix( bounds, 4.0f ).Transform( Vector3f( 1.0f, 1.0f, 0.0f ) );
+	EXPECT_NEAR( 2.0f, wide.x, 1e-5f );
+	EXPECT_NEAR( 1.5f, wide.y, 1e-5f );
+}
+
+TEST( ScreenMath, GazeHitsTheCenterOfAScreenAhead )
+{
+	const Matrix4f view;		// at the origin, looking down -Z
+	const Matrix4f screen = FreeScreenMatrix( Matrix4f(), 3.0f, Vector3f( 1.0f ) );
+
+	const Vector2f gaze = GazeCoordinatesOnScreen( view, screen );
+	EXPECT_NEAR( 0.0f, gaze.x, 1e-4f );
+	EXPECT_NEAR( 0.0f, gaze.y, 1e-4f );
+
+	const Vector2f away = GazeCoordinatesOnScreen( Matrix4f::RotationY( (float)M_PI ), screen );
+	EXPECT_EQ( -2.0f, away.x );
+	EXPECT_EQ( -2.0f, away.y );
+}
+
+TEST( ScreenMath, InterpolatePanelPoseBlendsNeighbours )
+{
+	Array<PanelPose> poses;
+	poses.PushBack( PanelPose( Quatf(), Vector3f( 0.0f, 0.0f, 0.0f ), Vector4f( 1.0f ) ) );
+	poses.PushBack( PanelPose( Quatf(), Vector3f( 2.0f, 0.0f, 0.0f ), Vector4f( 0.0f ) ) );
+
+	const PanelPose half = InterpolatePanelPose( poses, 0.5f );
+	EXPECT_NEAR( 1.0f, half.Position.x, 1e-5f );
+	EXPECT_NEAR( 0.5f, half.Color.w, 1e-5f );
+
+	EXPECT_NEAR( 2.0f, InterpolatePanelPose( poses, 1.0f ).Position.x, 1e-5f );
+	EXPECT_EQ( 0.0f, InterpolatePanelPose( poses, 1.5f ).Color.w );
+	EXPECT_EQ( 0.0f, InterpolatePanelPose( poses, -1.0f ).Position.x );
+}
+
+TEST( PoseHistory, FindsTheFirstPoseAtOrAfterTheTime )
+{
+	PoseHistory history;
+	Matrix4f pose;
+	EXPECT_FALSE( history.GetPoseAtTime( 0, pose ) );
+
+	// wraps the ring so the oldest entries are overwritten
+	for ( int i = 0; i < PoseHistory::MAX_POSES + 10; i++ )
+	{
+		history.Record( i * 10, Matrix4f::Translation( (float)i, 0.0f, 0.0f ) );
+	}
+	EXPECT_EQ( PoseHistory::MAX_POSES, history.GetCount() );
+
+	ASSERT_TRUE( history.GetPoseAtTime( 1005, pose ) );
+	EXPECT_EQ( 101.0f, pose.M[0][3] );
+
+	ASSERT_TRUE( history.GetPoseAtTime( 0, pose ) );
+	EXPECT_EQ( 10.0f, pose.M[0][3] );		// the oldest one left
+
+	ASSERT_TRUE( history.GetPoseAtTime( 1000000, pose ) );
+	EXPECT_EQ( (float)( PoseHistory::MAX_POSES + 9 ), pose.M[0][3] );
+}
+
+TEST( Lerp, ClampsToTheEnds )
+{
+	Lerp lerp;
+	lerp.Set( 1.0, 10.0, 3.0, 20.0 );
+	EXPECT_DOUBLE_EQ( 10.0, lerp.Value( 0.0 ) );
+	EXPECT_DOUBLE_EQ( 15.0, lerp.Value( 2.0 ) );
+	EXPECT_DOUBLE_EQ( 20.0, lerp.Value( 9.0 ) );
+}
@@ -0,0 +1,204 @@
+/************************************************************************************
+
+Filename    :   SessionLogTest.cpp
+Content     :	Host tests of session recording and replay
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "SessionLog.h"
+
+#include <gtest/gtest.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+std::string TempPath()
+{
+	char path[] = "/tmp/streamtheater_sessionXXXXXX";
+	close( mkstemp( path ) );
+	return path;
+}
+
+// what the replay handed over, one line per event with the frame it came in
+class Transcript : public SessionReplayTarget
+{
+public:
+	int							Frame;
+	std::vector<std::string>	Lines;
+	SessionFrame				LastFrame;
+
+	Transcript() : Frame( 0 ) {}
+
+	void Add( const char * format, ... ) __attribute__( ( format( printf, 2, 3 ) ) )
+	{
+		char line[256];
+		const int prefix = snprintf( line, sizeof( line ), "%i ", Frame );
+		va_list args;
+		va_start( args, format );
+		vsnprintf( line + prefix, sizeof( line ) - prefix, format, args );
+		va_end( args );
+		Lines.push_back( line );
+	}
+
+	virtual void ReplayFrame( const SessionFrame & frame ) { LastFrame = frame; Add( "frame %u", frame.ButtonPressed ); }
+	virtual void ReplayCommand( const char * command ) { Add( "command %s", command ); }
+	virtual void ReplayAddPc( const String & name, const String & uuid, const int pairState, const int reachability,
+			const String & binding, const bool isRunning )
+	{
+		Add( "addPc %s %s %i %i %s %i", name.ToCStr(), uuid.ToCStr(), pairState, reachability, binding.ToCStr(), isRunning );
+	}
+	virtual void ReplayRemovePc( const String & name ) { Add( "removePc %s", name.ToCStr() ); }
+	virtual void ReplayAddApp( const String & name, const String & posterFileName, const int id, const bool isRunning )
+	{
+		Add( "addApp %s %s %i %i", name.ToCStr(), posterFileName.ToCStr(), id, isRunning );
+	}
+	virtual void ReplayRemoveApp( const int id ) { Add( "removeApp %i", id ); }
+	virtual void ReplayShowPair( const String & message ) { Add( "showPair %s", message.ToCStr() ); }
+	virtual void ReplayPairSuccess() { Add( "pairSuccess" ); }
+	virtual void ReplayShowError( const String & message ) { Add( "showError %s", message.ToCStr() ); }
+	virtual void ReplayClearError() { Add( "clearError" ); }
+	virtual void ReplayStreamFrame() { Add( "streamFrame" ); }
+};
+
+// replays the whole log, a frame at a time
+Transcript ReplayAll( SessionLog & log )
+{
+	Transcript transcript;
+	for ( ; !log.IsReplayFinished() && transcript.Frame < 1000; transcript.Frame++ )
+	{
+		log.ReplayEvents( transcript.Frame, transcript );
+	}
+	return transcript;
+}
+
+}
+
+TEST( SessionLog, ReplaysEveryEventInItsFrame )
+{
+	const std::string path = TempPath();
+	{
+		SessionLog log;
+		EXPECT_FALSE( log.IsRecording() );
+		log.RecordCommand( "dropped, not recording yet" );
+		ASSERT_TRUE( log.StartRecording( path.c_str() ) );
+		EXPECT_TRUE( log.IsRecording() );
+
+		SessionFrame frame;
+		frame.ButtonPressed = 4;
+		frame.DeltaSeconds = 0.016f;
+		frame.PredictedDisplayTimeInSeconds = 1234.5;
+		frame.Throttled = true;
+		frame.Sticks[1][0] = -0.5f;
+		frame.TouchRelative[1] = 0.25f;
+		frame.SwipeFraction = 0.75f;
+		log.SetFrame( 0 );
+		log.RecordFrame( frame );
+		log.RecordCommand( "newVideo 0x1234" );
+		log.RecordAddPc( "Desk", "uuid-1", 1, 0, "binding", true );
+
+		log.SetFrame( 2 );
+		log.RecordAddApp( "Steam", "steam.png", 7, false );
+		log.RecordRemoveApp( 7 );
+		log.RecordStreamFrame();
+		log.RecordShowPair( "1234" );
+		log.RecordPairSuccess();
+
+		log.SetFrame( 3 );
+		log.RecordShowError( "lost" );
+		log.RecordClearError();
+		log.RecordRemovePc( "Desk" );
+		log.StopRecording();
+		EXPECT_FALSE( log.IsRecording() );
+	}
+
+	SessionLog log;
+	ASSERT_TRUE( log.StartReplay( path.c_str() ) );
+	EXPECT_TRUE( log.IsReplaying() );
+	const Transcript transcript = ReplayAll( log );
+	const char * expected[] = {
+		"0 frame 4", "0 command newVideo 0x1234", "0 addPc Desk uuid-1 1 0 binding 1",
+		"2 addApp Steam steam.png 7 0", "2 removeApp 7", "2 streamFrame", "2 showPair 1234", "2 pairSuccess",
+		"3 showError lost", "3 clearError", "3 removePc Desk"
+	};
+	ASSERT_EQ( sizeof( expected ) / sizeof( expected[0] ), transcript.Lines.size() );
+	for ( size_t i = 0; i < transcript.Lines.size(); i++ )
+	{
+		EXPECT_EQ( expected[i], transcript.Lines[i] );
+	}
+
+	const SessionFrame & frame = transcript.LastFrame;
+	EXPECT_EQ( 0.016f, frame.DeltaSeconds );
+	EXPECT_EQ( 1234.5, frame.PredictedDisplayTimeInSeconds );
+	EXPECT_TRUE( frame.Throttled );
+	EXPECT_EQ( -0.5f, frame.Sticks[1][0] );
+	EXPECT_EQ( 0.25f, frame.TouchRelative[1] );
+	EXPECT_EQ( 0.75f, frame.SwipeFraction );
+
+	log.StopReplay();
+	EXPECT_FALSE( log.IsReplaying() );
+	unlink( path.c_str() );
+}
+
+// a log from another format version isn't replayed, and one cut off in
+// the middle of a record plays up to it
+TEST( SessionLog, RefusesOtherVersionsAndStopsAtATruncatedRecord )
+{
+	const std::string path = TempPath();
+	{
+		SessionLog log;
+		ASSERT_TRUE( log.StartRecording( path.c_str() ) );
+		log.RecordCommand( "first" );
+		log.RecordShowError( "second, cut off" );
+		log.StopRecording();
+	}
+	ASSERT_EQ( 0, truncate( path.c_str(), 8 + 12 + 6 + 12 + 4 ) );
+
+	SessionLog log;
+	ASSERT_TRUE( log.StartReplay( path.c_str() ) );
+	const Transcript transcript = ReplayAll( log );
+	ASSERT_EQ( 1u, transcript.Lines.size() );
+	EXPECT_EQ( "0 command first", transcript.Lines[0] );
+	EXPECT_TRUE( log.IsReplayFinished() );
+
+	FILE * f = fopen( path.c_str(), "r+b" );
+	ASSERT_TRUE( f != NULL );
+	fseek( f, 4, SEEK_SET );
+	const UInt32 version = 1;
+	fwrite( &version, sizeof( version ), 1, f );
+	fclose( f );
+	EXPECT_FALSE( log.StartReplay( path.c_str() ) );
+	EXPECT_FALSE( log.IsReplaying() );
+	EXPECT_FALSE( log.StartReplay( "/nonexistent/session.bin" ) );
+	unlink( path.c_str() );
+}
+
+TEST( SessionLog, SummarizesFrameTimes )
+{
+	Array<float> frameMs;
+	EXPECT_EQ( 0, SummarizeFrameTimes( frameMs ).Count );
+	for ( int i = 100; i >= 1; i-- )
+	{
+		frameMs.PushBack( (float)i );
+	}
+	const SessionFrameTimes times = SummarizeFrameTimes( frameMs );
+	EXPECT_EQ( 100, times.Count );
+	EXPECT_FLOAT_EQ( 50.5f, times.Mean );
+	EXPECT_EQ( 51.0f, times.P50 );
+	EXPECT_EQ( 100.0f, times.P99 );
+	EXPECT_EQ( 100.0f, times.Max );
+}
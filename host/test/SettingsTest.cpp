@@ -0,0 +1,95 @@
+/************************************************************************************
+
+Filename    :   SettingsTest.cpp
+Content     :	Host tests of the settings file
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "Settings.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+String TempPath()
+{
+	char path[] = "/tmp/streamtheater_settingsXXXXXX";
+	close( mkstemp( path ) );
+	unlink( path );
+	return String( path );
+}
+
+}
+
+TEST( Settings, ChangedValuesSurviveAReopen )
+{
+	const String path = TempPath();
+
+	int i = 1;
+	float f = 2.0f;
+	String str( "string" );
+	{
+		Settings settings( path.ToCStr() );
+		settings.Define( "int", &i );
+		settings.Define( "float", &f );
+		settings.Define( "str", &str );
+		settings.SaveAll();
+		settings.Load();
+
+		i = 5;
+		str = "changed";
+		settings.SaveChanged();
+
+		// saved again after a Load, replacing the nodes it found
+		i = 6;
+		settings.SaveChanged();
+		f = 9.0f;		// never saved
+	}
+
+	int i2 = 0;
+	float f2 = 0.0f;
+	String str2;
+	Settings settings( path.ToCStr() );
+	settings.Define( "int", &i2 );
+	settings.Define( "float", &f2 );
+	settings.Define( "str", &str2 );
+	settings.Load();
+
+	EXPECT_EQ( 6, i2 );
+	EXPECT_EQ( 2.0f, f2 );
+	EXPECT_STREQ( "changed", str2.ToCStr() );
+
+	unlink( path.ToCStr() );
+}
+
+TEST( Settings, DeleteVarDropsItFromTheFile )
+{
+	const String path = TempPath();
+
+	int i = 3;
+	{
+		Settings settings( path.ToCStr() );
+		settings.Define( "gone", &i );
+		settings.SaveAll();
+		settings.DeleteVar( "gone" );
+	}
+
+	Settings settings( path.ToCStr() );
+	int value = 0;
+	settings.Define( "gone", &value );
+	settings.Load();
+	EXPECT_EQ( 0, value );
+
+	unlink( path.ToCStr() );
+}
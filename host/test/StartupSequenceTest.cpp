@@ -0,0 +1,140 @@
+/************************************************************************************
+
+Filename    :   StartupSequenceTest.cpp
+Content     :	Host tests of the startup stage order and the first frame and interactive times
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "StartupSequence.h"
+
+#include <gtest/gtest.h>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+void Finish( StartupSequence & startup, const StartupStage stage, const double now = 0.0 )
+{
+	startup.StepDone( stage, true, false, 0.001, now );
+}
+
+}
+
+TEST( StartupSequence, IdleFramesStepTheStagesInOrder )
+{
+	StartupSequence startup;
+	startup.Begin( 1.0 );
+
+	for ( int i = 0; i < STARTUP_STAGE_COUNT; i++ )
+	{
+		const StartupStage stage = (StartupStage)i;
+		EXPECT_EQ( stage, startup.NextStage() ) << StartupSequence::GetStageName( stage );
+
+		// a step that isn't finished leaves the stage next
+		startup.StepDone( stage, false, false, 0.001, 2.0 );
+		EXPECT_FALSE( startup.IsReady( stage ) );
+		EXPECT_EQ( stage, startup.NextStage() );
+
+		Finish( startup, stage, 2.0 );
+		EXPECT_TRUE( startup.IsReady( stage ) );
+	}
+	EXPECT_EQ( STARTUP_STAGE_COUNT, startup.NextStage() );
+	EXPECT_EQ( 0, startup.GetAwaitedSteps() );
+}
+
+TEST( StartupSequence, BringsInDependenciesFirst )
+{
+	StartupSequence startup;
+	startup.Begin( 0.0 );
+
+	// the movie player needs the theaters, which need the shaders
+	EXPECT_EQ( STARTUP_SHADER_VARIANTS, startup.NextStageFor( STARTUP_MOVIE_PLAYER ) );
+	Finish( startup, STARTUP_SHADER_VARIANTS );
+	EXPECT_EQ( STARTUP_THEATERS, startup.NextStageFor( STARTUP_MOVIE_PLAYER ) );
+	EXPECT_EQ( STARTUP_THEATERS, startup.NextStageFor( STARTUP_THEATER_SELECTION ) );
+	Finish( startup, STARTUP_THEATERS );
+	EXPECT_EQ( STARTUP_THEATER_SELECTION, startup.NextStageFor( STARTUP_MOVIE_PLAYER ) );
+	Finish( startup, STARTUP_THEATER_SELECTION );
+	EXPECT_EQ( STARTUP_MOVIE_PLAYER, startup.NextStageFor( STARTUP_MOVIE_PLAYER ) );
+	Finish( startup, STARTUP_MOVIE_PLAYER );
+	EXPECT_EQ( STARTUP_STAGE_COUNT, startup.NextStageFor( STARTUP_MOVIE_PLAYER ) );
+}
+
+TEST( StartupSequence, StagesWithoutDependenciesRunAtOnce )
+{
+	StartupSequence startup;
+	startup.Begin( 0.0 );
+
+	EXPECT_EQ( STARTUP_RESUME_MENU, startup.NextStageFor( STARTUP_RESUME_MENU ) );
+	startup.StepDone( STARTUP_RESUME_MENU, true, true, 0.004, 0.5 );
+	EXPECT_TRUE( startup.IsReady( STARTUP_RESUME_MENU ) );
+	EXPECT_EQ( 1, startup.GetAwaitedSteps() );
+
+	// idle frames skip what's already ready
+	Finish( startup, STARTUP_SHADER_VARIANTS );
+	Finish( startup, STARTUP_THEATERS );
+	Finish( startup, STARTUP_THEATER_SELECTION );
+	EXPECT_EQ( STARTUP_MOVIE_PLAYER, startup.NextStage() );
+	Finish( startup, STARTUP_MOVIE_PLAYER );
+	EXPECT_EQ( STARTUP_STAGE_COUNT, startup.NextStage() );
+}
+
+TEST( StartupSequence, InteractiveOnceReadyAfterTheFirstFrame )
+{
+	StartupSequence startup;
+	startup.Begin( 10.0 );
+	EXPECT_EQ( -1.0, startup.GetTimeToFirstFrame() );
+	EXPECT_EQ( -1.0, startup.GetTimeToInteractive() );
+
+	startup.FirstFrame( 10.5 );
+	startup.FirstFrame( 11.0 );		// only the first one counts
+	EXPECT_DOUBLE_EQ( 0.5, startup.GetTimeToFirstFrame() );
+
+	for ( int i = 0; i < STARTUP_STAGE_COUNT - 1; i++ )
+	{
+		Finish( startup, (StartupStage)i, 12.0 );
+		EXPECT_FALSE( startup.IsComplete() );
+	}
+
+	// finishing a stage again changes nothing
+	Finish( startup, STARTUP_SHADER_VARIANTS, 12.5 );
+	EXPECT_FALSE( startup.IsComplete() );
+
+	startup.StepDone( STARTUP_RESUME_MENU, true, true, 0.002, 13.0 );
+	EXPECT_TRUE( startup.IsComplete() );
+	EXPECT_DOUBLE_EQ( 3.0, startup.GetTimeToInteractive() );
+	EXPECT_EQ( 1, startup.GetAwaitedSteps() );
+
+	Finish( startup, STARTUP_RESUME_MENU, 14.0 );
+	EXPECT_DOUBLE_EQ( 3.0, startup.GetTimeToInteractive() );
+}
+
+// with everything ready before the first frame, interactive is the first frame
+TEST( StartupSequence, InteractiveWaitsForTheFirstFrame )
+{
+	StartupSequence startup;
+	startup.Begin( 1.0 );
+	for ( int i = 0; i < STARTUP_STAGE_COUNT; i++ )
+	{
+		Finish( startup, (StartupStage)i, 1.5 );
+	}
+	EXPECT_FALSE( startup.IsComplete() );
+
+	startup.FirstFrame( 2.0 );
+	EXPECT_TRUE( startup.IsComplete() );
+	EXPECT_DOUBLE_EQ( 1.0, startup.GetTimeToFirstFrame() );
+	EXPECT_DOUBLE_EQ( 1.0, startup.GetTimeToInteractive() );
+}
+
+TEST( StartupSequence, NamesTheStages )
+{
+	EXPECT_STREQ( "theaters", StartupSequence::GetStageName( STARTUP_THEATERS ) );
+	EXPECT_STREQ( "none", StartupSequence::GetStageName( STARTUP_STAGE_COUNT ) );
+}
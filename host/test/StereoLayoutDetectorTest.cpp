@@ -0,0 +1,150 @@
+/************************************************************************************
+
+Filename    :   StereoLayoutDetectorTest.cpp
+Content     :	Host tests of the stereo layout detector on a labeled synthetic corpus
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "StereoLayoutDetector.h"
+#include "SyntheticFrames.h"
+
+#include <gtest/gtest.h>
+
+using namespace VRMatterStreamTheater;
+using namespace SyntheticFrames;
+
+namespace {
+
+// samples of a 1080p stream
+static const int WIDTH = 480;
+static const int HEIGHT = 270;
+
+static const StereoLayout EXPECTED[] = { STEREO_LAYOUT_MONO, STEREO_LAYOUT_SIDE_BY_SIDE, STEREO_LAYOUT_TOP_BOTTOM };
+
+StereoLayout Detect( const std::vector<unsigned char> & frame, const int width, const int height, const int samples )
+{
+	StereoLayoutDetector detector;
+	for ( int i = 0; i < samples; i++ )
+	{
+		detector.AddSample( &frame[0], width, height );
+	}
+	return detector.GetLayout();
+}
+
+}
+
+// Every scene in every layout, with and without depth and letterboxing
+TEST( StereoLayoutDetector, ClassifiesTheCorpus )
+{
+	int wrong = 0;
+	for ( unsigned int seed = 1; seed <= 24; seed++ )
+	{
+		const Scene scene( seed );
+		const float disparity = ( seed % 4 ) * 0.01f;
+		const float bars = ( seed % 3 == 0 ) ? 0.12f : 0.0f;
+		for ( int layout = LAYOUT_MONO; layout <= LAYOUT_TOP_BOTTOM; layout++ )
+		{
+			const std::vector<unsigned char> frame = Render( scene, (Layout)layout, WIDTH, HEIGHT, disparity, 0.0f, bars );
+			const StereoLayout found = Detect( frame, WIDTH, HEIGHT, 6 );
+			EXPECT_EQ( EXPECTED[layout], found ) << "seed " << seed << " layout " << layout;
+			wrong += ( found != EXPECTED[layout] );
+		}
+	}
+	EXPECT_EQ( 0, wrong );
+}
+
+// the sampler's size for 720p and 4K streams
+TEST( StereoLayoutDetector, WorksAtEverySampleSize )
+{
+	const Scene scene( 99 );
+	const int sizes[][2] = { { 320, 180 }, { 960, 540 }, { 128, 72 }, { 501, 283 } };
+	for ( size_t i = 0; i < sizeof( sizes ) / sizeof( sizes[0] ); i++ )
+	{
+		for ( int layout = LAYOUT_MONO; layout <= LAYOUT_TOP_BOTTOM; layout++ )
+		{
+			const std::vector<unsigned char> frame = Render( scene, (Layout)layout, sizes[i][0], sizes[i][1] );
+			EXPECT_EQ( EXPECTED[layout], Detect( frame, sizes[i][0], sizes[i][1], 6 ) )
+					<< sizes[i][0] << "x" << sizes[i][1] << " layout " << layout;
+		}
+	}
+}
+
+TEST( StereoLayoutDetector, NeedsSeveralSamplesToAgree )
+{
+	const std::vector<unsigned char> sbs = Render( Scene( 5 ), LAYOUT_SIDE_BY_SIDE, WIDTH, HEIGHT );
+	const std::vector<unsigned char> mono = Render( Scene( 6 ), LAYOUT_MONO, WIDTH, HEIGHT );
+
+	StereoLayoutDetector detector;
+	for ( int i = 0; i < 3; i++ )
+	{
+		detector.AddSample( &sbs[0], WIDTH, HEIGHT );
+		EXPECT_EQ( STEREO_LAYOUT_UNKNOWN, detector.GetLayout() );
+	}
+	detector.AddSample( &sbs[0], WIDTH, HEIGHT );
+	EXPECT_EQ( STEREO_LAYOUT_SIDE_BY_SIDE, detector.GetLayout() );
+
+	// a scene cut to something else doesn't switch it right away
+	detector.AddSample( &mono[0], WIDTH, HEIGHT );
+	detector.AddSample( &mono[0], WIDTH, HEIGHT );
+	EXPECT_EQ( STEREO_LAYOUT_SIDE_BY_SIDE, detector.GetLayout() );
+	for ( int i = 0; i < 10; i++ )
+	{
+		detector.AddSample( &mono[0], WIDTH, HEIGHT );
+	}
+	EXPECT_EQ( STEREO_LAYOUT_MONO, detector.GetLayout() );
+
+	detector.Reset();
+	EXPECT_EQ( STEREO_LAYOUT_UNKNOWN, detector.GetLayout() );
+	EXPECT_EQ( 0.0f, detector.GetSideBySideScore() );
+}
+
+TEST( StereoLayoutDetector, IgnoresWhatItCantJudge )
+{
+	StereoLayoutDetector detector;
+	const std::vector<unsigned char> sbs = Render( Scene( 7 ), LAYOUT_SIDE_BY_SIDE, WIDTH, HEIGHT );
+	detector.AddSample( &sbs[0], WIDTH, HEIGHT );
+	const float score = detector.GetSideBySideScore();
+
+	// black, flat, too small and too wide samples change nothing
+	const std::vector<unsigned char> black( WIDTH * HEIGHT * 4, 0 );
+	std::vector<unsigned char> grey( WIDTH * HEIGHT * 4, 128 );
+	detector.AddSample( &black[0], WIDTH, HEIGHT );
+	detector.AddSample( &grey[0], WIDTH, HEIGHT );
+	detector.AddSample( &sbs[0], 100, HEIGHT * WIDTH / 100 );
+	const int wide = StereoSampleAnalysis::MAX_SOURCE_WIDTH + 4;
+	const std::vector<unsigned char> wideFrame( wide * 80 * 4, 200 );
+	detector.AddSample( &wideFrame[0], wide, 80 );
+	EXPECT_EQ( score, detector.GetSideBySideScore() );
+
+	StereoSampleAnalysis analysis;
+	EXPECT_FALSE( analysis.Analyze( &black[0], WIDTH, HEIGHT ) );
+	EXPECT_FALSE( analysis.Analyze( &grey[0], WIDTH, HEIGHT ) );
+	EXPECT_FALSE( analysis.Analyze( &wideFrame[0], wide, 80 ) );
+}
+
+// What the GL thread gets from a worker is what it would have worked out itself
+TEST( StereoLayoutDetector, AnalysisElsewhereMatches )
+{
+	const std::vector<unsigned char> tb = Render( Scene( 8 ), LAYOUT_TOP_BOTTOM, WIDTH, HEIGHT, 0.02f );
+	StereoLayoutDetector here;
+	StereoLayoutDetector there;
+	StereoSampleAnalysis analysis;
+	for ( int i = 0; i < 4; i++ )
+	{
+		here.AddSample( &tb[0], WIDTH, HEIGHT );
+		ASSERT_TRUE( analysis.Analyze( &tb[0], WIDTH, HEIGHT ) );
+		there.AddAnalysis( analysis );
+	}
+	EXPECT_EQ( here.GetSideBySideScore(), there.GetSideBySideScore() );
+	EXPECT_EQ( here.GetTopBottomScore(), there.GetTopBottomScore() );
+	EXPECT_EQ( STEREO_LAYOUT_TOP_BOTTOM, there.GetLayout() );
+	EXPECT_GT( analysis.GetTopBottom(), 0.9f );
+	EXPECT_LT( analysis.GetSideBySide(), 0.35f );
+}
@@ -0,0 +1,276 @@
+/************************************************************************************
+
+Filename    :   StreamQualityControllerTest.cpp
+Content     :	Host tests of the adaptive quality measurements and control law
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "StreamQualityController.h"
+
+#include <gtest/gtest.h>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+StreamQualitySample BadSample()
+{
+	StreamQualitySample sample;
+	sample.LateFrameFraction = 0.2f;
+	return sample;
+}
+
+// Feeds one sample a second until the parameters change, returns the
+// time it took or -1 if they never did within limit seconds
+double RunUntilChange( StreamQualityController & controller, const StreamQualitySample & sample, double & now,
+		const double limit = 600.0 )
+{
+	const double start = now;
+	while ( now - start < limit )
+	{
+		now += StreamQualityStats::WINDOW_SECONDS;
+		if ( controller.Evaluate( sample, now ) )
+		{
+			return now - start;
+		}
+	}
+	return -1.0;
+}
+
+}
+
+TEST( StreamQualityStats, SteadyFramesAreNeitherLateNorJittery )
+{
+	StreamQualityStats stats;
+	stats.Reset( 0.0 );
+	StreamQualitySample sample;
+	for ( int i = 0; i < 60; i++ )
+	{
+		EXPECT_FALSE( stats.GetSample( i / 60.0, 60, sample ) );
+		stats.AddFrameArrival( i / 60.0 );
+		stats.AddLatency( 30.0f );
+		stats.AddRenderFrame( 1.0f / 60 );
+	}
+	ASSERT_TRUE( stats.GetSample( 1.0, 60, sample ) );
+	EXPECT_NEAR( 0.0f, sample.FrameJitterMs, 0.01f );
+	EXPECT_NEAR( 0.0f, sample.LateFrameFraction, 0.01f );
+	EXPECT_NEAR( 30.0f, sample.LatencyMs, 0.01f );
+	EXPECT_NEAR( 1000.0f / 60, sample.RenderFrameMs, 0.01f );
+
+	// and the next window starts empty
+	EXPECT_FALSE( stats.GetSample( 1.5, 60, sample ) );
+}
+
+TEST( StreamQualityStats, MissingFramesCountAsLate )
+{
+	StreamQualityStats stats;
+	stats.Reset( 0.0 );
+	StreamQualitySample sample;
+	for ( int i = 0; i < 30; i++ )
+	{
+		stats.AddFrameArrival( i / 30.0 );
+	}
+	ASSERT_TRUE( stats.GetSample( 1.0, 60, sample ) );
+	EXPECT_NEAR( 0.5f, sample.LateFrameFraction, 0.01f );
+}
+
+// Frames that arrive in pairs, every other interval half a period long
+// and the next a period and a half plus
+TEST( StreamQualityStats, UnevenFramesAreJitteryAndLate )
+{
+	StreamQualityStats stats;
+	stats.Reset( 0.0 );
+	StreamQualitySample sample;
+	stats.GetSample( 0.0, 60, sample );
+
+	const double period = 1.0 / 60;
+	double t = 0.0;
+	for ( int i = 0; i < 60; i++ )
+	{
+		stats.AddFrameArrival( t );
+		t += ( i & 1 ) ? period * 1.6 : period * 0.4;
+	}
+	ASSERT_TRUE( stats.GetSample( 1.0, 60, sample ) );
+	EXPECT_GT( sample.FrameJitterMs, 8.0f );
+	EXPECT_NEAR( 0.5f, sample.LateFrameFraction, 0.05f );
+}
+
+// A reset between windows used to forget the frame rate, so nothing
+// arriving before the next GetSample could be late
+TEST( StreamQualityStats, ResetKeepsTheExpectedPeriod )
+{
+	StreamQualityStats stats;
+	StreamQualitySample sample;
+	stats.Reset( 0.0 );
+	stats.GetSample( 0.0, 60, sample );
+	stats.Reset( 0.0 );
+
+	const double period = 1.0 / 60;
+	double t = 0.0;
+	for ( int i = 0; i < 60; i++ )
+	{
+		stats.AddFrameArrival( t );
+		t += ( i % 10 == 9 ) ? period * 1.6 : period * ( 1.0 - 0.6 / 9 );
+	}
+	ASSERT_TRUE( stats.GetSample( 1.0, 60, sample ) );
+	EXPECT_GT( sample.LateFrameFraction, 0.05f );
+}
+
+TEST( StreamQualityController, DefaultBitrateFollowsThePixelCount )
+{
+	EXPECT_EQ( 10000, StreamQualityController::DefaultBitrate( 1280, 720, 60 ) );
+	EXPECT_EQ( 5000, StreamQualityController::DefaultBitrate( 1280, 720, 30 ) );
+	EXPECT_EQ( 20000, StreamQualityController::DefaultBitrate( 1920, 1080, 60 ) );
+	EXPECT_EQ( 10000, StreamQualityController::DefaultBitrate( 1920, 1080, 30 ) );
+	EXPECT_EQ( 80000, StreamQualityController::DefaultBitrate( 3840, 2160, 60 ) );
+	EXPECT_EQ( 40000, StreamQualityController::DefaultBitrate( 3840, 2160, 30 ) );
+
+	// the width counts, not just the height
+	EXPECT_EQ( 20000, StreamQualityController::DefaultBitrate( 2560, 1080, 60 ) );
+	EXPECT_EQ( 20000, StreamQualityController::DefaultBitrate( 1920, 1200, 60 ) );
+	EXPECT_EQ( 10000, StreamQualityController::DefaultBitrate( 1440, 1080, 60 ) );
+	EXPECT_EQ( 20000, StreamQualityController::DefaultBitrate( 3440, 1440, 60 ) );
+}
+
+TEST( StreamQualityController, WaitsForTheStreamToSettle )
+{
+	StreamQualityController controller;
+	controller.Reset( StreamQualityParams( 1920, 1080, 60, 0 ), 100.0 );
+	EXPECT_EQ( 20000, controller.GetParams().Bitrate );
+
+	for ( double now = 100.0; now < 105.0; now += 1.0 )
+	{
+		EXPECT_FALSE( controller.Evaluate( BadSample(), now ) );
+	}
+	double now = 104.0;
+	EXPECT_NEAR( 2.0, RunUntilChange( controller, BadSample(), now ), 1e-9 );
+	EXPECT_EQ( StreamQualityController::QUALITY_DEGRADED, controller.GetState() );
+}
+
+TEST( StreamQualityController, StepsDownBitrateThenRateThenResolution )
+{
+	StreamQualityController controller;
+	double now = 0.0;
+	controller.Reset( StreamQualityParams( 1920, 1080, 60, 0 ), now );
+
+	const int expected[][4] =
+	{
+		{ 1920, 1080, 60, 15000 },
+		{ 1920, 1080, 60, 11250 },
+		{ 1920, 1080, 60, 10000 },		// the floor, half the default
+		{ 1920, 1080, 30, 10000 },		// kept, it fits 30 fps
+		{ 1920, 1080, 30, 7500 },
+		{ 1920, 1080, 30, 5625 },
+		{ 1920, 1080, 30, 5000 },
+		{ 1280, 720, 30, 5000 },
+		{ 1280, 720, 30, 3750 },
+		{ 1280, 720, 30, 2812 },
+		{ 1280, 720, 30, 2500 },
+	};
+	for ( size_t i = 0; i < sizeof( expected ) / sizeof( expected[0] ); i++ )
+	{
+		ASSERT_GT( RunUntilChange( controller, BadSample(), now ), 0.0 ) << "step " << i;
+		const StreamQualityParams & p = controller.GetParams();
+		EXPECT_EQ( StreamQualityParams( expected[i][0], expected[i][1], expected[i][2], expected[i][3] ), p )
+				<< "step " << i << ": " << p.Width << "x" << p.Height << " " << p.FPS << " " << p.Bitrate;
+	}
+
+	EXPECT_LT( RunUntilChange( controller, BadSample(), now ), 0.0 );
+	EXPECT_EQ( StreamQualityController::QUALITY_MINIMUM, controller.GetState() );
+}
+
+TEST( StreamQualityController, KeepsTheAspectRatioAt720p )
+{
+	StreamQualityController controller;
+	double now = 0.0;
+	controller.Reset( StreamQualityParams( 2560, 1080, 30, 5000 ), now );
+	while ( controller.GetParams().Height > 720 )
+	{
+		ASSERT_GT( RunUntilChange( controller, BadSample(), now ), 0.0 );
+	}
+	EXPECT_EQ( 1706, controller.GetParams().Width );
+
+	controller.Reset( StreamQualityParams( 1920, 1200, 30, 5000 ), now );
+	while ( controller.GetParams().Height > 720 )
+	{
+		ASSERT_GT( RunUntilChange( controller, BadSample(), now ), 0.0 );
+	}
+	EXPECT_EQ( 1152, controller.GetParams().Width );
+}
+
+TEST( StreamQualityController, RecoversToTheTargetAndNoFurther )
+{
+	StreamQualityController controller;
+	double now = 0.0;
+	const StreamQualityParams target( 1920, 1080, 60, 0 );
+	controller.Reset( target, now );
+	for ( int i = 0; i < 5; i++ )
+	{
+		ASSERT_GT( RunUntilChange( controller, BadSample(), now ), 0.0 );
+	}
+	ASSERT_EQ( 30, controller.GetParams().FPS );
+
+	// 9375, 10000, 60 fps at 10000, 12500, 15625, 19531, 20000
+	const StreamQualitySample good;
+	for ( int step = 0; step < 6; step++ )
+	{
+		// settling, then ten good windows, and nothing failed so the pace holds
+		ASSERT_NEAR( 14.0, RunUntilChange( controller, good, now ), 1e-9 ) << "step " << step;
+		EXPECT_EQ( StreamQualityController::QUALITY_RECOVERING, controller.GetState() );
+	}
+	ASSERT_NEAR( 14.0, RunUntilChange( controller, good, now ), 1e-9 );
+	EXPECT_TRUE( controller.IsAtTarget() );
+	EXPECT_EQ( StreamQualityParams( 1920, 1080, 60, 20000 ), controller.GetParams() );
+	EXPECT_LT( RunUntilChange( controller, good, now, 120.0 ), 0.0 );
+	EXPECT_EQ( StreamQualityController::QUALITY_STABLE, controller.GetState() );
+}
+
+TEST( StreamQualityController, AFailedProbeSlowsTheNextOne )
+{
+	StreamQualityController controller;
+	double now = 0.0;
+	controller.Reset( StreamQualityParams( 1920, 1080, 60, 0 ), now );
+	ASSERT_GT( RunUntilChange( controller, BadSample(), now ), 0.0 );
+
+	const StreamQualitySample good;
+	ASSERT_NEAR( 14.0, RunUntilChange( controller, good, now ), 1e-9 );
+	ASSERT_NEAR( 6.0, RunUntilChange( controller, BadSample(), now ), 1e-9 );
+	EXPECT_NEAR( 24.0, RunUntilChange( controller, good, now ), 1e-9 );
+	ASSERT_NEAR( 6.0, RunUntilChange( controller, BadSample(), now ), 1e-9 );
+	EXPECT_NEAR( 44.0, RunUntilChange( controller, good, now ), 1e-9 );
+}
+
+TEST( StreamQualityController, InBetweenWindowsChangeNothing )
+{
+	StreamQualityController controller;
+	double now = 0.0;
+	controller.Reset( StreamQualityParams( 1280, 720, 60, 0 ), now );
+	StreamQualitySample middling;
+	middling.FrameJitterMs = 6.0f;
+	EXPECT_LT( RunUntilChange( controller, middling, now ), 0.0 );
+	EXPECT_TRUE( controller.IsAtTarget() );
+}
+
+TEST( StreamQualityController, TheUsersBitrateLimitsHold )
+{
+	StreamQualityController controller;
+	controller.SetBitrateLimits( 6000, 8000 );
+	double now = 0.0;
+	controller.Reset( StreamQualityParams( 1920, 1080, 60, 0 ), now );
+	EXPECT_EQ( 8000, controller.GetParams().Bitrate );
+
+	// the 60 fps floor is above the limit already, so the rate goes first
+	ASSERT_GT( RunUntilChange( controller, BadSample(), now ), 0.0 );
+	EXPECT_EQ( StreamQualityParams( 1920, 1080, 30, 8000 ), controller.GetParams() );
+	ASSERT_GT( RunUntilChange( controller, BadSample(), now ), 0.0 );
+	EXPECT_EQ( StreamQualityParams( 1920, 1080, 30, 6000 ), controller.GetParams() );
+	ASSERT_GT( RunUntilChange( controller, BadSample(), now ), 0.0 );
+	EXPECT_EQ( StreamQualityParams( 1280, 720, 30, 6000 ), controller.GetParams() );
+}
@@ -0,0 +1,318 @@
+/************************************************************************************
+
+Filename    :   TaskSchedulerTest.cpp
+Content     :	Host tests of the work stealing task scheduler
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "TaskScheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+// What happened to the tasks of a test, from whichever thread
+struct Record
+{
+	std::atomic<int>	Runs;
+	std::atomic<int>	Finishes;
+	std::atomic<int>	Cancelled;		// finished without running
+	std::atomic<int>	Deleted;
+	std::atomic<int>	OffThreadFinishes;
+	std::mutex			OrderLock;
+	std::vector<int>	Order;			// ids in the order they ran
+	std::thread::id		MainThread;
+
+						Record() : Runs( 0 ), Finishes( 0 ), Cancelled( 0 ), Deleted( 0 ), OffThreadFinishes( 0 ),
+							MainThread( std::this_thread::get_id() ) {}
+};
+
+class CountTask : public BackgroundTask
+{
+public:
+						CountTask( Record & record, const int id, const TaskPriority priority = TASK_PRIORITY_NORMAL,
+								CancelToken * token = NULL ) :
+							BackgroundTask( priority, token ),
+							Rec( record ),
+							Id( id ),
+							Ran( false ) {}
+	virtual				~CountTask() { Rec.Deleted++; }
+
+	virtual void		Run()
+	{
+		Ran = true;
+		Rec.Runs++;
+		std::lock_guard<std::mutex> lock( Rec.OrderLock );
+		Rec.Order.push_back( Id );
+	}
+
+	virtual void		Finish()
+	{
+		Rec.Finishes++;
+		if ( !Ran )
+		{
+			EXPECT_TRUE( IsCancelled() );
+			Rec.Cancelled++;
+		}
+		if ( std::this_thread::get_id() != Rec.MainThread )
+		{
+			Rec.OffThreadFinishes++;
+		}
+	}
+
+private:
+	Record &			Rec;
+	int					Id;
+	bool				Ran;
+};
+
+// holds a worker until it's opened
+class GateTask : public BackgroundTask
+{
+public:
+						GateTask( std::atomic<bool> & open, std::atomic<bool> & entered ) :
+							BackgroundTask( TASK_PRIORITY_HIGH, NULL ),
+							Open( open ),
+							Entered( entered ) {}
+
+	virtual void		Run()
+	{
+		Entered = true;
+		while ( !Open )
+		{
+			std::this_thread::yield();
+		}
+	}
+
+private:
+	std::atomic<bool> &	Open;
+	std::atomic<bool> &	Entered;
+};
+
+void FinishAll( TaskScheduler & tasks, Record & record, const int count )
+{
+	const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::seconds( 10 );
+	while ( record.Finishes < count && std::chrono::steady_clock::now() < end )
+	{
+		if ( tasks.RunCompletions( 0.001 ) == 0 )
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void WaitFor( const std::atomic<bool> & flag )
+{
+	while ( !flag )
+	{
+		std::this_thread::yield();
+	}
+}
+
+}
+
+TEST( TaskScheduler, RunsOnWorkersAndFinishesOnTheMainThread )
+{
+	Record record;
+	{
+		TaskScheduler tasks;
+		tasks.Start( 4 );
+		ASSERT_EQ( 4, tasks.GetNumWorkers() );
+		for ( int i = 0; i < 2000; i++ )
+		{
+			tasks.Submit( new CountTask( record, i, (TaskPriority)( i % TASK_PRIORITY_COUNT ) ) );
+		}
+		FinishAll( tasks, record, 2000 );
+		EXPECT_EQ( 2000, record.Runs );
+		EXPECT_EQ( 2000, record.Finishes );
+		EXPECT_EQ( 2000, record.Deleted );
+		EXPECT_EQ( 2000, tasks.GetCompleted() );
+		EXPECT_EQ( 0, tasks.GetQueued() );
+		EXPECT_EQ( 0, record.OffThreadFinishes );
+	}
+	EXPECT_EQ( 0, record.Cancelled );
+}
+
+// The queues are taken best priority first, oldest first within one
+TEST( TaskScheduler, RunsTheBestPriorityFirst )
+{
+	Record record;
+	TaskScheduler tasks;
+	tasks.Start( 1 );
+	std::atomic<bool> open( false );
+	std::atomic<bool> entered( false );
+	tasks.Submit( new GateTask( open, entered ) );
+	WaitFor( entered );
+
+	tasks.Submit( new CountTask( record, 0, TASK_PRIORITY_PREFETCH ) );
+	tasks.Submit( new CountTask( record, 1, TASK_PRIORITY_NORMAL ) );
+	tasks.Submit( new CountTask( record, 2, TASK_PRIORITY_HIGH ) );
+	tasks.Submit( new CountTask( record, 3, TASK_PRIORITY_NORMAL ) );
+	tasks.Submit( new CountTask( record, 4, TASK_PRIORITY_HIGH ) );
+	EXPECT_EQ( 5, tasks.GetQueued() );
+	open = true;
+	FinishAll( tasks, record, 5 );
+
+	const int expected[] = { 2, 4, 1, 3, 0 };
+	ASSERT_EQ( 5u, record.Order.size() );
+	for ( int i = 0; i < 5; i++ )
+	{
+		EXPECT_EQ( expected[i], record.Order[i] ) << i;
+	}
+}
+
+// A cancelled token skips the tasks that haven't started, Finish still comes
+TEST( TaskScheduler, CancelledTasksOnlyFinish )
+{
+	Record record;
+	TaskScheduler tasks;
+	tasks.Start( 1 );
+	std::atomic<bool> open( false );
+	std::atomic<bool> entered( false );
+	tasks.Submit( new GateTask( open, entered ) );
+	WaitFor( entered );
+
+	CancelToken * token = CancelToken::Create();
+	for ( int i = 0; i < 10; i++ )
+	{
+		tasks.Submit( new CountTask( record, i, TASK_PRIORITY_NORMAL, token ) );
+	}
+	tasks.Submit( new CountTask( record, 10 ) );
+	token->Cancel();
+	token->Release();		// the tasks hold it until they're deleted
+	open = true;
+	FinishAll( tasks, record, 11 );
+
+	EXPECT_EQ( 1, record.Runs );
+	EXPECT_EQ( 10, record.Cancelled );
+	EXPECT_EQ( 11, record.Deleted );
+}
+
+// Work submitted from a worker goes on its own queue and the idle ones steal it
+TEST( TaskScheduler, IdleWorkersSteal )
+{
+	class SpawnTask : public BackgroundTask
+	{
+	public:
+		SpawnTask( TaskScheduler & tasks, Record & record ) : BackgroundTask( TASK_PRIORITY_NORMAL, NULL ), Tasks( tasks ), Rec( record ) {}
+		virtual void Run()
+		{
+			for ( int i = 0; i < 400; i++ )
+			{
+				Tasks.Submit( new CountTask( Rec, i ) );
+			}
+		}
+		TaskScheduler &	Tasks;
+		Record &		Rec;
+	};
+
+	Record record;
+	TaskScheduler tasks;
+	tasks.Start( 4 );
+	tasks.Submit( new SpawnTask( tasks, record ) );
+	FinishAll( tasks, record, 400 );
+	EXPECT_EQ( 400, record.Runs );
+	EXPECT_LE( tasks.GetSteals(), 400 );
+}
+
+// Before Start a task runs right away on the calling thread
+TEST( TaskScheduler, RunsInlineBeforeStart )
+{
+	Record record;
+	TaskScheduler tasks;
+	EXPECT_EQ( 0, tasks.GetNumWorkers() );
+	tasks.Submit( new CountTask( record, 0 ) );
+	EXPECT_EQ( 1, record.Runs );
+	EXPECT_EQ( 0, record.Finishes );
+	EXPECT_EQ( 1, tasks.RunCompletions( 1.0 ) );
+	EXPECT_EQ( 1, record.Finishes );
+}
+
+// Queued tasks are cancelled and finished by Shutdown, the running one
+// is waited for, and anything submitted later is cancelled too
+TEST( TaskScheduler, ShutdownFinishesEverything )
+{
+	Record record;
+	TaskScheduler tasks;
+	tasks.Start( 1 );
+	std::atomic<bool> open( false );
+	std::atomic<bool> entered( false );
+	tasks.Submit( new GateTask( open, entered ) );
+	WaitFor( entered );
+	for ( int i = 0; i < 10; i++ )
+	{
+		tasks.Submit( new CountTask( record, i ) );
+	}
+
+	std::thread opener( [&open]() {
+		std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+		open = true;
+	} );
+	tasks.Shutdown();
+	opener.join();
+	EXPECT_TRUE( open );
+	EXPECT_EQ( 0, tasks.GetNumWorkers() );
+	EXPECT_EQ( 10, record.Finishes );
+	EXPECT_EQ( 10, record.Cancelled );
+
+	tasks.Submit( new CountTask( record, 10 ) );
+	EXPECT_EQ( 1, tasks.RunCompletions( 1.0 ) );
+	EXPECT_EQ( 0, record.Runs );
+	EXPECT_EQ( 11, record.Cancelled );
+	EXPECT_EQ( 11, record.Deleted );
+}
+
+// Submits from other threads while Shutdown runs are either run or
+// cancelled, never lost
+TEST( TaskScheduler, SubmitRacingShutdownIsNeverLost )
+{
+	for ( int round = 0; round < 20; round++ )
+	{
+		Record record;
+		std::atomic<int> submitted( 0 );
+		{
+			TaskScheduler tasks;
+			tasks.Start( 2 );
+			std::vector<std::thread> submitters;
+			for ( int t = 0; t < 3; t++ )
+			{
+				submitters.push_back( std::thread( [&]() {
+					for ( int i = 0; i < 2000; i++ )
+					{
+						tasks.Submit( new CountTask( record, 0 ) );
+						submitted++;
+					}
+				} ) );
+			}
+			while ( submitted < 200 )
+			{
+				std::this_thread::yield();
+			}
+			tasks.Shutdown();
+			for ( size_t t = 0; t < submitters.size(); t++ )
+			{
+				submitters[t].join();
+			}
+			EXPECT_EQ( 0, tasks.GetQueued() );
+			// the destructor finishes what came in after Shutdown's last pass
+		}
+		EXPECT_EQ( submitted, record.Finishes ) << round;
+		EXPECT_EQ( submitted, record.Deleted ) << round;
+		EXPECT_EQ( submitted, record.Runs + record.Cancelled ) << round;
+	}
+}
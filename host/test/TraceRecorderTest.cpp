@@ -0,0 +1,89 @@
+/************************************************************************************
+
+Filename    :   TraceRecorderTest.cpp
+Content     :	Host tests of the per thread trace rings
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "TraceRecorder.h"
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+std::string DumpTrace()
+{
+	char path[] = "/tmp/streamtheater_traceXXXXXX";
+	close( mkstemp( path ) );
+	EXPECT_TRUE( TraceRecorder::WriteChromeTrace( path, 60.0 ) );
+
+	std::string text;
+	FILE * f = fopen( path, "r" );
+	char buffer[4096];
+	size_t count;
+	while ( f != NULL && ( count = fread( buffer, 1, sizeof( buffer ), f ) ) > 0 )
+	{
+		text.append( buffer, count );
+	}
+	if ( f != NULL )
+	{
+		fclose( f );
+	}
+	unlink( path );
+	return text;
+}
+
+int Occurrences( const std::string & text, const char * what )
+{
+	int count = 0;
+	for ( size_t at = text.find( what ); at != std::string::npos; at = text.find( what, at + 1 ) )
+	{
+		count++;
+	}
+	return count;
+}
+
+}
+
+// Threads come and go far more often than there are slots, the JNI
+// callbacks and workers among them, and each new one is still traced
+TEST( TraceRecorder, ExitedThreadsHandTheirSlotBack )
+{
+	for ( int i = 0; i < TraceRecorder::MAX_THREADS * 3; i++ )
+	{
+		std::thread( []() { TRACE_SCOPE( "TraceRecorderTest short lived" ); } ).join();
+	}
+	std::thread( []() { TRACE_SCOPE( "TraceRecorderTest last" ); } ).join();
+
+	const std::string trace = DumpTrace();
+	EXPECT_EQ( 1, Occurrences( trace, "TraceRecorderTest last" ) );
+	EXPECT_LT( Occurrences( trace, "TraceRecorderTest short lived" ), (int)TraceRecorder::MAX_THREADS );
+}
+
+// an exited thread's events stay for the dump until the slot is needed
+TEST( TraceRecorder, KeepsTheEventsOfExitedThreads )
+{
+	std::thread( []() {
+		for ( int i = 0; i < 3; i++ )
+		{
+			TRACE_SCOPE( "TraceRecorderTest exited" );
+		}
+	} ).join();
+
+	EXPECT_EQ( 3, Occurrences( DumpTrace(), "TraceRecorderTest exited" ) );
+}
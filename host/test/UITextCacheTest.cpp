@@ -0,0 +1,233 @@
+/************************************************************************************
+
+Filename    :   UITextCacheTest.cpp
+Content     :	Host tests of the laid-out text cache
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "UI/UITextCache.h"
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <new>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+// laid out like the SDK's VRMenuFontParms, padding and all
+struct FontParms
+{
+	bool	CenterHoriz;
+	bool	CenterVert;
+	bool	Billboard;
+	bool	TrackRoll;
+	bool	Outline;
+	float	ColorCenter;
+	float	AlphaCenter;
+	float	Scale;
+	float	WrapScalar;
+	bool	MultiLine;
+
+			FontParms() :
+				CenterHoriz( true ),
+				CenterVert( true ),
+				Billboard( false ),
+				TrackRoll( false ),
+				Outline( false ),
+				ColorCenter( 0.0f ),
+				AlphaCenter( 0.5f ),
+				Scale( 1.0f ),
+				WrapScalar( 1.0f ),
+				MultiLine( true )
+			{
+			}
+};
+
+static const int FONT = 0;
+
+Bounds3f Box( const float width )
+{
+	return Bounds3f( Vector3f( -width * 0.5f, -0.05f, 0.0f ), Vector3f( width * 0.5f, 0.05f, 0.0f ) );
+}
+
+}
+
+TEST( UITextCache, FindsWhatWasInserted )
+{
+	UITextCache cache;
+	const FontParms parms;
+	const UITextCache::Key key( &FONT, "Settings", parms );
+	Bounds3f bounds;
+	EXPECT_FALSE( cache.Find( key, bounds ) );
+	cache.Insert( key, Box( 0.4f ) );
+	ASSERT_TRUE( cache.Find( UITextCache::Key( &FONT, "Settings", parms ), bounds ) );
+	EXPECT_EQ( 0.4f, bounds.GetSize().x );
+	EXPECT_EQ( 1, cache.GetHits() );
+	EXPECT_EQ( 1, cache.GetMisses() );
+
+	// a second insert replaces it
+	cache.Insert( key, Box( 0.5f ) );
+	ASSERT_TRUE( cache.Find( key, bounds ) );
+	EXPECT_EQ( 0.5f, bounds.GetSize().x );
+	EXPECT_EQ( 1, cache.GetNumEntries() );
+
+	cache.ResetCounters();
+	cache.Clear();
+	EXPECT_EQ( 0, cache.GetNumEntries() );
+	EXPECT_FALSE( cache.Find( key, bounds ) );
+	EXPECT_EQ( 1, cache.GetMisses() );
+}
+
+// Any of the font parms, the font, the text or the wrap width make a
+// different layout
+TEST( UITextCache, KeysOnEverything )
+{
+	UITextCache cache;
+	const FontParms parms;
+	cache.Insert( UITextCache::Key( &FONT, "Play", parms ), Box( 0.2f ) );
+
+	FontParms multiLine = parms;
+	multiLine.MultiLine = false;
+	FontParms wrap = parms;
+	wrap.WrapScalar = 0.5f;
+	FontParms outline = parms;
+	outline.Outline = true;
+	FontParms scale = parms;
+	scale.Scale = 1.3f;
+	FontParms billboard = parms;
+	billboard.Billboard = true;
+	FontParms trackRoll = parms;
+	trackRoll.TrackRoll = true;
+	FontParms centerVert = parms;
+	centerVert.CenterVert = false;
+	FontParms alpha = parms;
+	alpha.AlphaCenter = 0.4f;
+	FontParms color = parms;
+	color.ColorCenter = 0.1f;
+	const int otherFont = 0;
+
+	Bounds3f bounds;
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, "Play", multiLine ), bounds ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, "Play", wrap ), bounds ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, "Play", outline ), bounds ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, "Play", scale ), bounds ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, "Play", billboard ), bounds ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, "Play", trackRoll ), bounds ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, "Play", centerVert ), bounds ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, "Play", alpha ), bounds ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, "Play", color ), bounds ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &otherFont, "Play", parms ), bounds ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, "Pause", parms ), bounds ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, "Play", parms, 1.0f ), bounds ) );
+	EXPECT_TRUE( cache.Find( UITextCache::Key( &FONT, "Play", parms ), bounds ) );
+}
+
+// Copies of the same parms share the entry whatever their padding holds
+TEST( UITextCache, IgnoresPadding )
+{
+	alignas( FontParms ) UByte clean[sizeof( FontParms )];
+	alignas( FontParms ) UByte dirty[sizeof( FontParms )];
+	memset( clean, 0, sizeof( clean ) );
+	memset( dirty, 0xab, sizeof( dirty ) );
+	const FontParms * parms = new ( clean ) FontParms();
+	const FontParms * copy = new ( dirty ) FontParms();
+
+	UITextCache cache;
+	cache.Insert( UITextCache::Key( &FONT, "Play", *parms ), Box( 0.2f ) );
+	Bounds3f bounds;
+	EXPECT_TRUE( cache.Find( UITextCache::Key( &FONT, "Play", *copy ), bounds ) );
+	EXPECT_EQ( 1, cache.GetHits() );
+}
+
+// The bounds and the wrapped text of one key are kept apart, asking for
+// the one that isn't there is a miss
+TEST( UITextCache, KeepsWrappedText )
+{
+	UITextCache cache;
+	const FontParms parms;
+	const UITextCache::Key key( &FONT, "No apps were found on this PC", parms, 1.0f );
+	String wrapped;
+	Bounds3f bounds;
+	EXPECT_FALSE( cache.Find( key, wrapped ) );
+	cache.Insert( key, String( "No apps were found\non this PC" ) );
+	EXPECT_FALSE( cache.Find( key, bounds ) );
+	ASSERT_TRUE( cache.Find( key, wrapped ) );
+	EXPECT_STREQ( "No apps were found\non this PC", wrapped.ToCStr() );
+
+	cache.Insert( key, Box( 1.0f ) );
+	EXPECT_TRUE( cache.Find( key, bounds ) );
+	EXPECT_TRUE( cache.Find( key, wrapped ) );
+	EXPECT_EQ( 1, cache.GetNumEntries() );
+}
+
+// Past the most entries the least recently used one goes, and a Find
+// counts as a use
+TEST( UITextCache, EvictsTheLeastRecentlyUsed )
+{
+	UITextCache cache( 4 );
+	const FontParms parms;
+	const char * texts[] = { "0:00", "0:01", "0:02", "0:03", "0:04", "0:05" };
+	for ( int i = 0; i < 4; i++ )
+	{
+		cache.Insert( UITextCache::Key( &FONT, texts[i], parms ), Box( 0.1f * i ) );
+	}
+	Bounds3f bounds;
+	ASSERT_TRUE( cache.Find( UITextCache::Key( &FONT, texts[0], parms ), bounds ) );
+
+	cache.Insert( UITextCache::Key( &FONT, texts[4], parms ), Box( 0.4f ) );
+	EXPECT_EQ( 4, cache.GetNumEntries() );
+	EXPECT_TRUE( cache.Find( UITextCache::Key( &FONT, texts[0], parms ), bounds ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, texts[1], parms ), bounds ) );
+	cache.Insert( UITextCache::Key( &FONT, texts[5], parms ), Box( 0.5f ) );
+	EXPECT_FALSE( cache.Find( UITextCache::Key( &FONT, texts[2], parms ), bounds ) );
+	EXPECT_TRUE( cache.Find( UITextCache::Key( &FONT, texts[3], parms ), bounds ) );
+	ASSERT_TRUE( cache.Find( UITextCache::Key( &FONT, texts[5], parms ), bounds ) );
+	EXPECT_EQ( 0.5f, bounds.GetSize().x );
+
+	UITextCache tiny( 0 );
+	EXPECT_EQ( 1, tiny.GetMaxEntries() );
+}
+
+// A slider scrubbed through its readouts churns the cache far past its size
+TEST( UITextCache, StaysConsistentUnderChurn )
+{
+	UITextCache cache( 16 );
+	const FontParms parms;
+	char text[16];
+	int found = 0;
+	for ( int round = 0; round < 3; round++ )
+	{
+		for ( int i = 0; i < 500; i++ )
+		{
+			snprintf( text, sizeof( text ), "%i:%02i", i / 60, i % 60 );
+			const UITextCache::Key key( &FONT, text, parms );
+			Bounds3f bounds;
+			if ( cache.Find( key, bounds ) )
+			{
+				EXPECT_EQ( 0.01f * ( i % 7 + 1 ), bounds.GetSize().x ) << text;
+				found++;
+			}
+			else
+			{
+				cache.Insert( key, Box( 0.01f * ( i % 7 + 1 ) ) );
+			}
+
+			// the last few are always there
+			const int back = i >= 4 ? i - 4 : i;
+			snprintf( text, sizeof( text ), "%i:%02i", back / 60, back % 60 );
+			EXPECT_TRUE( cache.Find( UITextCache::Key( &FONT, text, parms ), bounds ) ) << text;
+			EXPECT_LE( cache.GetNumEntries(), 16 );
+		}
+	}
+	EXPECT_EQ( 0, found );		// each readout was long gone before it came around again
+}
@@ -0,0 +1,201 @@
+/************************************************************************************
+
+Filename    :   SessionReplay.cpp
+Content     :	Plays a recorded session back on a desktop and times each frame
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+// Plays a session.bin from the headset back headless.  The recorded PC
+// and app lists go through Catalog, the list bookkeeping PcManager and
+// AppManager are built on, and the CPU time of each frame is reported
+// the way the replay on the device does.  The views, the scene and GL
+// only exist on the device and aren't driven.
+//
+//   streamtheater_replay session.bin [session_replay.txt]
+
+#include "SessionLog.h"
+#include "Catalog.h"
+
+#include <stdio.h>
+#include <time.h>
+
+using namespace VRMatterStreamTheater;
+
+namespace {
+
+double ThreadCpuSeconds()
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts );
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+class HostReplay : public SessionReplayTarget
+{
+public:
+	int					Frames;
+	int					Commands;
+	int					ButtonPresses;
+	int					StreamFrames;
+	int					Errors;
+	int					PcChanges;
+	int					AppChanges;
+
+	HostReplay() :
+		Frames( 0 ),
+		Commands( 0 ),
+		ButtonPresses( 0 ),
+		StreamFrames( 0 ),
+		Errors( 0 ),
+		PcChanges( 0 ),
+		AppChanges( 0 ),
+		ListsChanged( false )
+
+	{
+	}
+
+	~HostReplay()
+	{
+		DeleteAll( Pcs );
+		DeleteAll( Apps );
+		DeleteAll( Retired );
+	}
+
+	int					GetNumPcs() const { return Pcs.GetSizeI(); }
+	int					GetNumApps() const { return Apps.GetSizeI(); }
+
+	// the carousels list the changed categories again once a frame
+	void EndFrame()
+	{
+		if ( ListsChanged )
+		{
+			Catalog::ListCategory( Pcs, CATEGORY_LIMELIGHT );
+			Catalog::ListCategory( Apps, CATEGORY_LIMELIGHT );
+			ListsChanged = false;
+		}
+	}
+
+	virtual void ReplayFrame( const SessionFrame & frame )
+	{
+		Frames++;
+		ButtonPresses += ( frame.ButtonPressed != 0 );
+	}
+
+	virtual void ReplayCommand( const char * )
+	{
+		Commands++;
+	}
+
+	virtual void ReplayAddPc( const String & name, const String & uuid, const int pairState, const int reachability,
+			const String & binding, const bool isRunning )
+	{
+		bool isNew;
+		Catalog::UpdatePc( Pcs, name, uuid, (HostState::PairState)pairState, (HostState::Reachability)reachability, binding, isRunning, isNew );
+		PcChanges++;
+		ListsChanged = true;
+	}
+
+	virtual void ReplayRemovePc( const String & name )
+	{
+		delete Catalog::RemovePc( Pcs, name );
+		PcChanges++;
+		ListsChanged = true;
+	}
+
+	virtual void ReplayAddApp( const String & name, const String & posterFileName, const int id, const bool isRunning )
+	{
+		bool isNew;
+		Catalog::UpdateApp( Apps, name, posterFileName, id, isRunning, isNew );
+		AppChanges++;
+		ListsChanged = true;
+	}
+
+	virtual void ReplayRemoveApp( const int id )
+	{
+		Catalog::RemoveApp( Apps, id, Retired );
+		AppChanges++;
+		ListsChanged = true;
+	}
+
+	virtual void ReplayShowPair( const String & ) {}
+	virtual void ReplayPairSuccess() {}
+
+	virtual void ReplayShowError( const String & message )
+	{
+		printf( "error: %s\n", message.ToCStr() );
+		Errors++;
+	}
+
+	virtual void ReplayClearError() {}
+
+	virtual void ReplayStreamFrame()
+	{
+		StreamFrames++;
+	}
+
+private:
+	Array<PcDef *>		Pcs;
+	Array<AppDef *>		Apps;
+	Array<AppDef *>		Retired;
+	bool				ListsChanged;
+
+	template< class Def >
+	static void DeleteAll( Array<Def *> & defs )
+	{
+		for ( int i = 0; i < defs.GetSizeI(); i++ )
+		{
+			delete defs[i];
+		}
+		defs.Clear();
+	}
+};
+
+}
+
+int main( int argc, char ** argv )
+{
+	if ( argc < 2 )
+	{
+		fprintf( stderr, "usage: %s session.bin [session_replay.txt]\n", argv[0] );
+		return 2;
+	}
+
+	SessionLog log;
+	if ( !log.StartReplay( argv[1] ) )
+	{
+		fprintf( stderr, "%s isn't a session log this build can replay\n", argv[1] );
+		return 1;
+	}
+
+	HostReplay replay;
+	Array<float> frameMs;
+	for ( int frame = 0; !log.IsReplayFinished(); frame++ )
+	{
+		const double start = ThreadCpuSeconds();
+		log.ReplayEvents( frame, replay );
+		replay.EndFrame();
+		frameMs.PushBack( (float)( ( ThreadCpuSeconds() - start ) * 1000.0 ) );
+	}
+	log.StopReplay();
+
+	const SessionFrameTimes times = SummarizeFrameTimes( frameMs );
+	printf( "%i frames, %i with input, %i button presses, %i commands, %i stream frames, %i errors\n",
+			times.Count, replay.Frames, replay.ButtonPresses, replay.Commands, replay.StreamFrames, replay.Errors );
+	printf( "%i PC and %i app list changes, %i PCs and %i apps at the end\n",
+			replay.PcChanges, replay.AppChanges, replay.GetNumPcs(), replay.GetNumApps() );
+	printf( "cpu per frame: mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n", times.Mean, times.P50, times.P99, times.Max );
+
+	if ( argc > 2 && !WriteFrameTimes( argv[2], frameMs ) )
+	{
+		fprintf( stderr, "couldn't write %s\n", argv[2] );
+		return 1;
+	}
+	return 0;
+}
@@ -4,10 +4,62 @@ include $(call all-subdir-makefiles)
 
 LOCAL_PATH := $(TOP_LOCAL_PATH)
 
+# cinemacore holds the code that only needs the OVR kernel types: no GL, no
+# JNI and no app framework.  Keep it that way so it can be built and timed
+# on its own.
+include $(CLEAR_VARS)
+
+include ../../OculusSDK/cflags.mk
+
+# ndk-build STREAMTHEATER_TRACE=1 builds in the frame timeline recorder (TraceRecorder.h)
+ifeq ($(STREAMTHEATER_TRACE),1)
+LOCAL_CFLAGS	+= -DSTREAMTHEATER_TRACE
+endif
+
+# ndk-build STREAMTHEATER_LOG_LEVEL=4 compiles in every log level (AsyncLog.h)
+ifneq ($(STREAMTHEATER_LOG_LEVEL),)
+LOCAL_CFLAGS	+= -DSTREAMTHEATER_LOG_LEVEL=$(STREAMTHEATER_LOG_LEVEL)
+endif
+
+LOCAL_MODULE    := cinemacore			# generate libcinemacore.a
+LOCAL_SRC_FILES	:= 	Settings.cpp \
+					StreamQualityController.cpp \
+					MotionCalibration.cpp \
+					LatencyProbes.cpp \
+					ScreenMath.cpp \
+					PoseHistory.cpp \
+					TraceRecorder.cpp \
+					SessionLog.cpp \
+					ContentChangeDetector.cpp \
+					StereoLayoutDetector.cpp \
+					BorderDetector.cpp \
+					EyeBufferGovernor.cpp \
+					ClockGovernor.cpp \
+					PathCache.cpp \
+					AsyncLog.cpp \
+					TaskScheduler.cpp \
+					StartupSequence.cpp \
+					AppListCache.cpp \
+					ImageWriter.cpp \
+					ScreenCompositor.cpp \
+					Catalog.cpp
+
+LOCAL_STATIC_LIBRARIES += libovr
+
+include $(BUILD_STATIC_LIBRARY)
+
 include $(CLEAR_VARS)					# clean everything up to prepare for a module
 
 include ../../OculusSDK/cflags.mk
 
+ifeq ($(STREAMTHEATER_TRACE),1)
+LOCAL_CFLAGS	+= -DSTREAMTHEATER_TRACE
+endif
+
+ifneq ($(STREAMTHEATER_LOG_LEVEL),)
+LOCAL_CFLAGS	+= -DSTREAMTHEATER_LOG_LEVEL=$(STREAMTHEATER_LOG_LEVEL)
+endif
+
 LOCAL_MODULE    := cinema				# generate libcinema.so
 LOCAL_SRC_FILES	:= 	CinemaApp.cpp \
 					Native.cpp \
@@ -32,7 +84,11 @@ LOCAL_SRC_FILES	:= 	CinemaApp.cpp \
 					ResumeMovieComponent.cpp \
 					SwipeHintComponent.cpp \
 					CinemaStrings.cpp \
-					Settings.cpp \
+					GpuTimer.cpp \
+					FrameSampler.cpp \
+					ScreenCapture.cpp \
+					StreamScreen.cpp \
+					PerfHud.cpp \
 					UI/UITexture.cpp \
 					UI/UIMenu.cpp \
 					UI/UIWidget.cpp \
@@ -40,9 +96,11 @@ LOCAL_SRC_FILES	:= 	CinemaApp.cpp \
 					UI/UILabel.cpp \
 					UI/UIImage.cpp \
 					UI/UIButton.cpp \
-					UI/UITextButton.cpp
+					UI/UITextButton.cpp \
+					UI/UITextCache.cpp
 
-LOCAL_STATIC_LIBRARIES += vrappframework libovr
+LOCAL_STATIC_LIBRARIES += cinemacore vrappframework libovr
+LOCAL_LDLIBS	+= -lz						# ImageWriter
 LOCAL_SHARED_LIBRARIES += vrapi
 
 include $(BUILD_SHARED_LIBRARY)			# start building based on everything since CLEAR_VARS
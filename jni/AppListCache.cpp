@@ -0,0 +1,445 @@
+/************************************************************************************
+
+Filename    :   AppListCache.cpp
+Content     :	App lists of the paired hosts, kept across runs and diffed against fresh ones
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "AppListCache.h"
+#include "SessionLog.h"
+#include "Android/LogUtils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace VRMatterStreamTheater {
+
+// written as SessionPackets, so the cache reads back the way a session does
+static const int	CACHE_MAGIC = 0x4C415453;		// "STAL"
+static const int	CACHE_VERSION = 1;
+
+AppListCache::AppListCache() :
+	Hosts(),
+	UseCount( 0 ),
+	Dirty( false ),
+	PrefetchHost(),
+	PrefetchStart( 0.0 )
+
+{
+	pthread_mutex_init( &Lock, NULL );
+}
+
+AppListCache::~AppListCache()
+{
+	Clear();
+	pthread_mutex_destroy( &Lock );
+}
+
+void AppListCache::Clear()
+{
+	for ( int i = 0; i < Hosts.GetSizeI(); i++ )
+	{
+		delete Hosts[i];
+	}
+	Hosts.Clear();
+}
+
+int AppListCache::FindHost( const char * uuid ) const
+{
+	for ( int i = 0; i < Hosts.GetSizeI(); i++ )
+	{
+		if ( Hosts[i]->UUID.CompareNoCase( uuid ) == 0 )
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+void AppListCache::Evict()
+{
+	while ( Hosts.GetSizeI() > MAX_HOSTS )
+	{
+		int oldest = 0;
+		for ( int i = 1; i < Hosts.GetSizeI(); i++ )
+		{
+			if ( Hosts[i]->LastUsed < Hosts[oldest]->LastUsed )
+			{
+				oldest = i;
+			}
+		}
+		delete Hosts[oldest];
+		Hosts.RemoveAtUnordered( oldest );
+		Dirty = true;
+	}
+}
+
+bool AppListCache::Load( const char * path )
+{
+	FILE * f = fopen( path, "rb" );
+	if ( f == NULL )
+	{
+		return false;
+	}
+
+	SessionPacket packet;
+	char buffer[4096];
+	for ( ; ; )
+	{
+		const size_t count = fread( buffer, 1, sizeof( buffer ), f );
+		if ( count == 0 )
+		{
+			break;
+		}
+		packet.PutBytes( buffer, (int)count );
+	}
+	fclose( f );
+
+	int magic = 0;
+	int version = 0;
+	int numHosts = 0;
+	if ( !packet.GetInt( magic ) || magic != CACHE_MAGIC || !packet.GetInt( version ) || version != CACHE_VERSION ||
+			!packet.GetInt( numHosts ) || numHosts < 0 )
+	{
+		LOG( "AppListCache: %s is not an app list cache", path );
+		return false;
+	}
+
+	Array<Host *> hosts;
+	bool ok = true;
+	for ( int h = 0; h < numHosts && ok; h++ )
+	{
+		Host * host = new Host();
+		int fetchTime = 0;
+		int numApps = 0;
+		ok = packet.GetString( host->UUID ) && packet.GetInt( fetchTime ) && packet.GetInt( numApps ) && numApps >= 0;
+		for ( int a = 0; a < numApps && ok; a++ )
+		{
+			AppListEntry entry;
+			int running = 0;
+			ok = packet.GetString( entry.Name ) && packet.GetString( entry.PosterFileName ) &&
+					packet.GetInt( entry.Id ) && packet.GetInt( running );
+			entry.IsRunning = ( running != 0 );
+			host->Apps.PushBack( entry );
+		}
+		host->FetchTime = fetchTime;
+		host->LastUsed = h - numHosts;		// keeps the saved order, most recent last
+		hosts.PushBack( host );
+	}
+
+	if ( !ok )
+	{
+		LOG( "AppListCache: %s is cut short", path );
+		for ( int i = 0; i < hosts.GetSizeI(); i++ )
+		{
+			delete hosts[i];
+		}
+		return false;
+	}
+
+	pthread_mutex_lock( &Lock );
+	Clear();
+	Hosts = hosts;
+	Dirty = false;
+	Evict();
+	pthread_mutex_unlock( &Lock );
+
+	LOG( "AppListCache: %i hosts loaded", hosts.GetSizeI() );
+	return true;
+}
+
+bool AppListCache::Save( const char * path )
+{
+	SessionPacket packet;
+
+	pthread_mutex_lock( &Lock );
+	if ( !Dirty )
+	{
+		pthread_mutex_unlock( &Lock );
+		return true;
+	}
+
+	// least recently used first, so Load can keep the order.  Hosts that
+	// were only tried are left out.
+	Array<Host *> ordered;
+	for ( int i = 0; i < Hosts.GetSizeI(); i++ )
+	{
+		if ( Hosts[i]->FetchTime >= 0.0 )
+		{
+			ordered.PushBack( Hosts[i] );
+		}
+	}
+	for ( int i = 1; i < ordered.GetSizeI(); i++ )
+	{
+		Host * host = ordered[i];
+		int j = i;
+		for ( ; j > 0 && ordered[j - 1]->LastUsed > host->LastUsed; j-- )
+		{
+			ordered[j] = ordered[j - 1];
+		}
+		ordered[j] = host;
+	}
+
+	packet.PutInt( CACHE_MAGIC );
+	packet.PutInt( CACHE_VERSION );
+	packet.PutInt( ordered.GetSizeI() );
+	for ( int h = 0; h < ordered.GetSizeI(); h++ )
+	{
+		const Host & host = *ordered[h];
+		packet.PutString( host.UUID.ToCStr() );
+		packet.PutInt( (int)host.FetchTime );
+		packet.PutInt( host.Apps.GetSizeI() );
+		for ( int a = 0; a < host.Apps.GetSizeI(); a++ )
+		{
+			const AppListEntry & entry = host.Apps[a];
+			packet.PutString( entry.Name.ToCStr() );
+			packet.PutString( entry.PosterFileName.ToCStr() );
+			packet.PutInt( entry.Id );
+			packet.PutInt( entry.IsRunning ? 1 : 0 );
+		}
+	}
+	Dirty = false;
+	pthread_mutex_unlock( &Lock );
+
+	// written next to it and renamed, so a crash never leaves half a cache
+	String tempPath = path;
+	tempPath.AppendString( ".tmp" );
+	FILE * f = fopen( tempPath.ToCStr(), "wb" );
+	bool ok = ( f != NULL );
+	if ( ok )
+	{
+		ok = fwrite( packet.GetData(), 1, packet.GetSize(), f ) == (size_t)packet.GetSize();
+		ok = ( fclose( f ) == 0 ) && ok;
+	}
+	if ( ok )
+	{
+		ok = ( rename( tempPath.ToCStr(), path ) == 0 );
+	}
+
+	if ( !ok )
+	{
+		LOG( "AppListCache: couldn't write %s", path );
+		pthread_mutex_lock( &Lock );
+		Dirty = true;
+		pthread_mutex_unlock( &Lock );
+	}
+	return ok;
+}
+
+bool AppListCache::Get( const char * uuid, Array<AppListEntry> & apps )
+{
+	pthread_mutex_lock( &Lock );
+	const int index = FindHost( uuid );
+	const bool found = ( index >= 0 && Hosts[index]->FetchTime >= 0.0 );
+	if ( found )
+	{
+		apps = Hosts[index]->Apps;
+		Hosts[index]->LastUsed = ++UseCount;
+	}
+	pthread_mutex_unlock( &Lock );
+	return found;
+}
+
+void AppListCache::Store( const char * uuid, const Array<AppListEntry> & apps, const double now )
+{
+	pthread_mutex_lock( &Lock );
+	int index = FindHost( uuid );
+	if ( index < 0 )
+	{
+		Host * host = new Host();
+		host->UUID = uuid;
+		Hosts.PushBack( host );
+		index = Hosts.GetSizeI() - 1;
+		Dirty = true;
+	}
+
+	// a fetch that changed nothing only moves the time, which isn't worth a write
+	Host & host = *Hosts[index];
+	AppListDiff diff;
+	Diff( host.Apps, apps, diff );
+	Dirty = Dirty || !diff.IsEmpty();
+	host.Apps = apps;
+	host.FetchTime = now;
+	host.LastUsed = ++UseCount;
+
+	if ( PrefetchHost.CompareNoCase( uuid ) == 0 )
+	{
+		PrefetchHost.Clear();
+	}
+	Evict();
+	pthread_mutex_unlock( &Lock );
+}
+
+double AppListCache::GetFetchTime( const char * uuid ) const
+{
+	pthread_mutex_lock( &Lock );
+	const int index = FindHost( uuid );
+	const double time = ( index >= 0 ) ? Hosts[index]->FetchTime : -1.0;
+	pthread_mutex_unlock( &Lock );
+	return time;
+}
+
+int AppListCache::GetNumHosts() const
+{
+	pthread_mutex_lock( &Lock );
+	const int count = Hosts.GetSizeI();
+	pthread_mutex_unlock( &Lock );
+	return count;
+}
+
+bool AppListCache::IsDirty() const
+{
+	pthread_mutex_lock( &Lock );
+	const bool dirty = Dirty;
+	pthread_mutex_unlock( &Lock );
+	return dirty;
+}
+
+bool AppListCache::StartPrefetch( const char * uuid, const double now )
+{
+	pthread_mutex_lock( &Lock );
+	bool start = false;
+	if ( PrefetchHost.IsEmpty() || now - PrefetchStart > PREFETCH_TIMEOUT_SECONDS )
+	{
+		int index = FindHost( uuid );
+		if ( index < 0 )
+		{
+			// kept only to remember the attempt until it's fetched
+			Host * host = new Host();
+			host->UUID = uuid;
+			host->LastUsed = ++UseCount;
+			Hosts.PushBack( host );
+			Evict();
+			index = FindHost( uuid );
+		}
+		if ( index >= 0 )
+		{
+			Host & host = *Hosts[index];
+			start = ( host.FetchTime < 0.0 || now - host.FetchTime > PREFETCH_AGE_SECONDS ) &&
+					now - host.AttemptTime > PREFETCH_RETRY_SECONDS;
+		}
+		if ( start )
+		{
+			Hosts[index]->AttemptTime = now;
+			PrefetchHost = uuid;
+			PrefetchStart = now;
+		}
+	}
+	pthread_mutex_unlock( &Lock );
+	return start;
+}
+
+void AppListCache::PrefetchFailed( const char * uuid )
+{
+	pthread_mutex_lock( &Lock );
+	if ( PrefetchHost.CompareNoCase( uuid ) == 0 )
+	{
+		PrefetchHost.Clear();
+	}
+	pthread_mutex_unlock( &Lock );
+}
+
+bool AppListCache::IsPrefetching( const double now ) const
+{
+	pthread_mutex_lock( &Lock );
+	const bool prefetching = !PrefetchHost.IsEmpty() && now - PrefetchStart <= PREFETCH_TIMEOUT_SECONDS;
+	pthread_mutex_unlock( &Lock );
+	return prefetching;
+}
+
+// Lists are a few dozen apps, matching by id in place is plenty.
+void AppListCache::Diff( const Array<AppListEntry> & shown, const Array<AppListEntry> & fresh, AppListDiff & diff )
+{
+	diff.Changed.Clear();
+	diff.Removed.Clear();
+
+	for ( int i = 0; i < fresh.GetSizeI(); i++ )
+	{
+		const AppListEntry & entry = fresh[i];
+		const AppListEntry * old = NULL;
+		for ( int j = 0; j < shown.GetSizeI(); j++ )
+		{
+			if ( shown[j].Id == entry.Id )
+			{
+				old = &shown[j];
+				break;
+			}
+		}
+		if ( old == NULL || old->Name != entry.Name || old->PosterFileName != entry.PosterFileName || old->IsRunning != entry.IsRunning )
+		{
+			diff.Changed.PushBack( entry );
+		}
+	}
+
+	for ( int j = 0; j < shown.GetSizeI(); j++ )
+	{
+		bool found = false;
+		for ( int i = 0; i < fresh.GetSizeI() && !found; i++ )
+		{
+			found = ( fresh[i].Id == shown[j].Id );
+		}
+		if ( !found )
+		{
+			diff.Removed.PushBack( shown[j].Id );
+		}
+	}
+}
+
+bool AppListCache::ParseAppList( const char * text, Array<AppListEntry> & apps )
+{
+	apps.Clear();
+	if ( text == NULL )
+	{
+		return false;
+	}
+
+	const char * line = text;
+	while ( *line != '\0' )
+	{
+		const char * end = strchr( line, '\n' );
+		const int length = ( end != NULL ) ? (int)( end - line ) : (int)strlen( line );
+
+		char buffer[512];
+		const int copy = ( length < (int)sizeof( buffer ) - 1 ) ? length : (int)sizeof( buffer ) - 1;
+		memcpy( buffer, line, copy );
+		buffer[copy] = '\0';
+		if ( copy > 0 && buffer[copy - 1] == '\r' )
+		{
+			buffer[copy - 1] = '\0';
+		}
+
+		int id = 0;
+		int running = 0;
+		int nameStart = 0;
+		if ( buffer[0] != '\0' && buffer[0] != '#' )
+		{
+			if ( sscanf( buffer, "%i %i %n", &id, &running, &nameStart ) < 2 || buffer[nameStart] == '\0' )
+			{
+				LOG( "AppListCache: bad app line \"%s\"", buffer );
+				return false;
+			}
+			AppListEntry entry;
+			entry.Id = id;
+			entry.IsRunning = ( running != 0 );
+			entry.Name = buffer + nameStart;
+			apps.PushBack( entry );
+		}
+
+		if ( end == NULL )
+		{
+			break;
+		}
+		line = end + 1;
+	}
+	return true;
+}
+
+} // namespace VRMatterStreamTheater
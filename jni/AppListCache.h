@@ -0,0 +1,121 @@
+/************************************************************************************
+
+Filename    :   AppListCache.h
+Content     :	App lists of the paired hosts, kept across runs and diffed against fresh ones
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( AppListCache_h )
+#define AppListCache_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_String.h"
+
+#include <pthread.h>
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+struct AppListEntry
+{
+	String			Name;
+	String			PosterFileName;		// where the poster is, or will be once the host made it
+	int				Id;
+	bool			IsRunning;
+
+					AppListEntry() : Name(), PosterFileName(), Id( 0 ), IsRunning( false ) {}
+};
+
+// what to do to a shown list to make it the fresh one
+struct AppListDiff
+{
+	Array<AppListEntry>	Changed;		// new, renamed, moved poster or started/stopped
+	Array<int>			Removed;		// ids
+
+	bool			IsEmpty() const { return Changed.GetSizeI() == 0 && Removed.GetSizeI() == 0; }
+};
+
+//==============================================================
+// AppListCache
+// One list per host uuid, the hosts used longest ago are dropped past
+// MAX_HOSTS.  Times are wall clock seconds so an age survives a restart.
+// Every call locks, the lists arrive on the JNI and worker threads.
+//
+// A prefetch is wanted for a host whose list is older than
+// PREFETCH_AGE_SECONDS, and only one is in flight at a time so the
+// fetches stay in the background.  One that never answers is given up
+// after PREFETCH_TIMEOUT_SECONDS, a host isn't tried again within
+// PREFETCH_RETRY_SECONDS.
+class AppListCache
+{
+public:
+	static const int		MAX_HOSTS = 16;
+	static const int		PREFETCH_AGE_SECONDS = 120;
+	static const int		PREFETCH_TIMEOUT_SECONDS = 15;
+	static const int		PREFETCH_RETRY_SECONDS = 30;
+
+							AppListCache();
+							~AppListCache();
+
+	// a missing or unreadable file is an empty cache
+	bool					Load( const char * path );
+	// writes only if something changed since the last Load or Save
+	bool					Save( const char * path );
+	bool					IsDirty() const;
+
+	// false for a host that was never fetched
+	bool					Get( const char * uuid, Array<AppListEntry> & apps );
+	void					Store( const char * uuid, const Array<AppListEntry> & apps, const double now );
+	// -1 if never
+	double					GetFetchTime( const char * uuid ) const;
+	// including the ones only tried
+	int						GetNumHosts() const;
+
+	// true marks a prefetch of the host as started
+	bool					StartPrefetch( const char * uuid, const double now );
+	void					PrefetchFailed( const char * uuid );
+	bool					IsPrefetching( const double now ) const;
+
+	static void				Diff( const Array<AppListEntry> & shown, const Array<AppListEntry> & fresh, AppListDiff & diff );
+
+	// One app per line, "<id> <running 0|1> <name>".  Blank lines and
+	// ones starting with # are skipped.  Used by the stand-in hosts.
+	static bool				ParseAppList( const char * text, Array<AppListEntry> & apps );
+
+private:
+	struct Host
+	{
+		String				UUID;
+		Array<AppListEntry>	Apps;
+		double				FetchTime;		// -1 if it was only tried
+		double				AttemptTime;	// last prefetch started, not saved
+		int					LastUsed;		// UseCount when it was last stored or read
+
+							Host() : UUID(), Apps(), FetchTime( -1.0 ), AttemptTime( -1e9 ), LastUsed( 0 ) {}
+	};
+
+	mutable pthread_mutex_t	Lock;
+	Array<Host *>			Hosts;
+	int						UseCount;
+	bool					Dirty;
+
+	String					PrefetchHost;	// empty when none is in flight
+	double					PrefetchStart;
+
+	int						FindHost( const char * uuid ) const;
+	void					Clear();
+	void					Evict();
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // AppListCache_h
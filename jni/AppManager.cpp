@@ -16,6 +16,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include <sys/stat.h>
 #include <errno.h>
 #include <dirent.h>
+#include <time.h>
 
 #include "Kernel/OVR_String_Utils.h"
 #include "Kernel/OVR_JSON.h"
@@ -24,6 +25,9 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "CinemaApp.h"
 #include "PackageFiles.h"
 #include "Native.h"
+#include "TraceRecorder.h"
+#include "AsyncLog.h"
+#include "TaskScheduler.h"
 
 
 namespace VRMatterStreamTheater {
@@ -33,22 +37,132 @@ const int AppManager::PosterHeight = 344;
 
 //=======================================================================================
 
+// Reads the poster file on a worker.  Decoding stays with the upload on
+// the GL thread, LoadTextureFromBuffer does both.
+class PosterLoadTask : public BackgroundTask
+{
+public:
+						PosterLoadTask( AppManager &appMgr, PcDef *anApp, const String &posterFilename, CancelToken *token ) :
+							BackgroundTask( TASK_PRIORITY_HIGH, token ),
+							AppMgr( appMgr ),
+							App( anApp ),
+							PosterFilename( posterFilename ),
+							File( MemBufferFile::NoInit ) {}
+
+	virtual void		Run() { File.LoadFile( PosterFilename.ToCStr() ); }
+	virtual void		Finish() { AppMgr.PosterLoaded( App, PosterFilename, File, IsCancelled() ); }
+
+private:
+	AppManager &		AppMgr;
+	PcDef *				App;
+	String				PosterFilename;
+	MemBufferFile		File;
+};
+
+//=======================================================================================
+
+// Reads <uuid>.applist from the stand-in directory, the posters are the
+// <name>.png next to it.
+class StandInAppListTask : public BackgroundTask
+{
+public:
+						StandInAppListTask( AppManager &appMgr, const String &uuid, const TaskPriority priority ) :
+							BackgroundTask( priority, NULL ),
+							AppMgr( appMgr ),
+							UUID( uuid ),
+							Directory( appMgr.StandInDirectory ) {}
+
+	virtual void		Run();
+
+private:
+	AppManager &		AppMgr;
+	String				UUID;
+	String				Directory;
+};
+
+void StandInAppListTask::Run()
+{
+	MemBufferFile file( ( Directory + UUID + ".applist" ).ToCStr() );
+	String text;
+	if ( file.Length > 0 )
+	{
+		text.AppendString( (const char *)file.Buffer, file.Length );
+	}
+
+	Array<AppListEntry> apps;
+	const bool ok = AppListCache::ParseAppList( text.ToCStr(), apps );
+	for ( int i = 0; i < apps.GetSizeI(); i++ )
+	{
+		apps[i].PosterFileName = Directory + apps[i].Name + ".png";
+	}
+	AppMgr.AppListReceived( UUID, apps, ok );
+}
+
+//=======================================================================================
+
+// Writes the app lists out on a worker.  Only one is ever queued, a list
+// stored while it writes makes it go around again.
+class AppListSaveTask : public BackgroundTask
+{
+public:
+						AppListSaveTask( AppManager &appMgr ) :
+							BackgroundTask( TASK_PRIORITY_PREFETCH, NULL ),
+							AppMgr( appMgr ) {}
+
+	virtual void		Run();
+
+private:
+	AppManager &		AppMgr;
+};
+
+void AppListSaveTask::Run()
+{
+	do
+	{
+		AppMgr.AppLists.Save( AppMgr.AppListPath.ToCStr() );
+		__atomic_store_n( &AppMgr.SaveQueued, 0, __ATOMIC_RELEASE );
+	}
+	// a Store between the write and the flag saw this one queued and left it to us
+	while ( AppMgr.AppLists.IsDirty() && __atomic_exchange_n( &AppMgr.SaveQueued, 1, __ATOMIC_ACQ_REL ) == 0 );
+}
+
+//=======================================================================================
+
 AppManager::AppManager( CinemaApp &cinema ) :
 	PcManager( cinema ),
     Apps(),
     updated( false ),
     Cinema( cinema ),
-    DefaultPoster(0)
+    DefaultPoster(0),
+    PosterToken( CancelToken::Create() ),
+    PostersLoading(),
+    CurrentHost(),
+    AppListPath(),
+    StandInDirectory(),
+    StandInHosts(),
+    NextPrefetchCheck( 0.0 ),
+    ReceivedHosts(),
+    Retired(),
+    SaveQueued( 0 )
+
 {
+	pthread_mutex_init( &ReceivedLock, NULL );
 }
 
 AppManager::~AppManager()
 {
+	PosterToken->Release();
+	for ( int i = 0; i < Retired.GetSizeI(); i++ )
+	{
+		delete Retired[i];
+	}
+	pthread_mutex_destroy( &ReceivedLock );
 }
 
 void AppManager::OneTimeInit( const char * launchIntent )
 {
 	LOG( "AppManager::OneTimeInit" );
+	TRACE_SCOPE( "AppManager::OneTimeInit" );
 	const double start = vrapi_GetTimeInSeconds();
 
 	int width, height;
@@ -63,12 +177,19 @@ void AppManager::OneTimeInit( const char * launchIntent )
 
 	LoadApps();
 
+	AppListPath = Cinema.ExternalCacheDir( "applists.bin" );
+	AppLists.Load( AppListPath.ToCStr() );
+	LOG( "AppManager::OneTimeInit: %i cached app lists", AppLists.GetNumHosts() );
+
 	LOG( "AppManager::OneTimeInit: %i movies loaded, %3.1f seconds", Apps.GetSizeI(), vrapi_GetTimeInSeconds() - start );
 }
 
 void AppManager::OneTimeShutdown()
 {
 	LOG( "AppManager::OneTimeShutdown" );
+
+	// the tasks are shut down by now, a save that was cancelled is done here
+	AppLists.Save( AppListPath.ToCStr() );
 }
 
 void AppManager::LoadApps()
@@ -97,41 +218,252 @@ void AppManager::LoadApps()
 void AppManager::AddApp(const String &name, const String &posterFileName, int id, bool isRunning)
 {
 	LOG( "App %s with id %i added!", name.ToCStr(), id);
-	AppDef *anApp = NULL;
 	bool isNew = false;
+	AppDef *anApp = Catalog::UpdateApp( Apps, name, posterFileName, id, isRunning, isNew );
 
-	for(UPInt i=0; i < Apps.GetSize(); i++)
+	if( isNew ) ReadMetaData( anApp );
+
+	updated = true;
+}
+
+void AppManager::RemoveApp( int id)
+{
+	Catalog::RemoveApp( Apps, id, Retired );
+	updated = true;
+}
+
+void AppManager::SelectHost( const String &uuid )
+{
+	if ( uuid != CurrentHost )
 	{
-		if(Apps[i]->Name.CompareNoCase(name) == 0)
-			anApp = Apps[i];
+		// the old host's posters aren't wanted, and the apps can go sooner
+		CancelPosterLoads();
+		for ( int i = 0; i < Apps.GetSizeI(); i++ )
+		{
+			Retired.PushBack( Apps[i] );
+		}
+		Apps.Clear();
+		CurrentHost = uuid;
+		updated = true;
 	}
-	if(anApp == NULL)
+
+	Array<AppListEntry> cached;
+	if ( AppLists.Get( uuid.ToCStr(), cached ) )
 	{
-		anApp = new AppDef();
-		Apps.PushBack( anApp );
-		isNew = true;
+		LOG( "SelectHost: %i cached apps for %s, %.0f seconds old", cached.GetSizeI(), uuid.ToCStr(),
+				(double)time( NULL ) - AppLists.GetFetchTime( uuid.ToCStr() ) );
+		ShowAppList( cached );
 	}
 
-	anApp->Name = name;
-	anApp->Id = id;
-	anApp->PosterFileName = posterFileName;
-	anApp->isRunning = isRunning;
+	FetchAppList( uuid, TASK_PRIORITY_HIGH );
+}
 
-	if( isNew ) ReadMetaData( anApp );
+void AppManager::FetchAppList( const String &uuid, const TaskPriority priority )
+{
+	if ( IsStandInHost( uuid ) )
+	{
+		Cinema.Tasks.Submit( new StandInAppListTask( *this, uuid, priority ) );
+	}
+	else if ( priority == TASK_PRIORITY_HIGH )
+	{
+		// also keeps polling the host while the app list is open
+		Native::InitAppSelector( Cinema.app, uuid.ToCStr() );
+	}
+	else
+	{
+		Native::PrefetchAppList( Cinema.app, uuid.ToCStr() );
+	}
+}
 
-	updated = true;
+void AppManager::AppListReceived( const String &uuid, const Array<AppListEntry> &apps, const bool ok )
+{
+	if ( !ok )
+	{
+		LOG( "App list of %s failed", uuid.ToCStr() );
+		AppLists.PrefetchFailed( uuid.ToCStr() );
+		return;
+	}
+
+	AppLists.Store( uuid.ToCStr(), apps, (double)time( NULL ) );
+	if ( __atomic_exchange_n( &SaveQueued, 1, __ATOMIC_ACQ_REL ) == 0 )
+	{
+		Cinema.Tasks.Submit( new AppListSaveTask( *this ) );
+	}
+
+	pthread_mutex_lock( &ReceivedLock );
+	ReceivedHosts.PushBack( uuid );
+	pthread_mutex_unlock( &ReceivedLock );
 }
 
-void AppManager::RemoveApp( int id)
+void AppManager::ApplyAppLists()
 {
-	for(UPInt i=0; i < Apps.GetSize(); i++)
+	Array<String> hosts;
+	pthread_mutex_lock( &ReceivedLock );
+	if ( ReceivedHosts.GetSizeI() > 0 )
+	{
+		hosts = ReceivedHosts;
+		ReceivedHosts.Clear();
+	}
+	pthread_mutex_unlock( &ReceivedLock );
+
+	for ( int i = 0; i < hosts.GetSizeI(); i++ )
+	{
+		Array<AppListEntry> fresh;
+		if ( hosts[i] == CurrentHost && AppLists.Get( CurrentHost.ToCStr(), fresh ) )
+		{
+			ShowAppList( fresh );
+		}
+	}
+}
+
+bool AppManager::IsReferenced( const AppDef *app ) const
+{
+	if ( app == Cinema.GetCurrentMovie() )
+	{
+		return true;
+	}
+	for ( int i = 0; i < PostersLoading.GetSizeI(); i++ )
+	{
+		if ( PostersLoading[i] == app )
+		{
+			return true;
+		}
+	}
+	const Array<const PcDef *> &playList = Cinema.GetPlaylist();
+	for ( int i = 0; i < playList.GetSizeI(); i++ )
+	{
+		if ( playList[i] == app )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void AppManager::FreeRetiredApps()
+{
+	int freed = 0;
+	for ( int i = 0; i < Retired.GetSizeI(); i++ )
 	{
-		if(Apps[i]->Id == id )
+		AppDef *app = Retired[i];
+		if ( IsReferenced( app ) )
 		{
-			Apps.RemoveAt(i);
-			i--;
+			continue;
 		}
+		if ( app->Poster != 0 && app->Poster != DefaultPoster )
+		{
+			glDeleteTextures( 1, &app->Poster );
+		}
+		delete app;
+		Retired.RemoveAtUnordered( i );
+		i--;
+		freed++;
+	}
+	if ( freed > 0 )
+	{
+		LOG( "FreeRetiredApps: %i freed, %i still in use", freed, Retired.GetSizeI() );
+	}
+}
+
+void AppManager::ShowAppList( const Array<AppListEntry> &fresh )
+{
+	TRACE_SCOPE( "AppManager::ShowAppList" );
+
+	Array<AppListEntry> shown;
+	shown.Resize( Apps.GetSize() );
+	for ( int i = 0; i < Apps.GetSizeI(); i++ )
+	{
+		shown[i].Name = Apps[i]->Name;
+		shown[i].PosterFileName = Apps[i]->PosterFileName;
+		shown[i].Id = Apps[i]->Id;
+		shown[i].IsRunning = Apps[i]->isRunning;
+	}
+
+	AppListDiff diff;
+	AppListCache::Diff( shown, fresh, diff );
+	if ( diff.IsEmpty() )
+	{
+		return;
+	}
+	LOG( "ShowAppList: %i changed, %i removed", diff.Changed.GetSizeI(), diff.Removed.GetSizeI() );
+
+	// recorded like the single adds and removes they replace, so a session plays back the same
+	for ( int i = 0; i < diff.Removed.GetSizeI(); i++ )
+	{
+		Cinema.Session.RecordRemoveApp( diff.Removed[i] );
+		RemoveApp( diff.Removed[i] );
+	}
+
+	for ( int i = 0; i < diff.Changed.GetSizeI(); i++ )
+	{
+		const AppListEntry &entry = diff.Changed[i];
+		Cinema.Session.RecordAddApp( entry.Name.ToCStr(), entry.PosterFileName.ToCStr(), entry.Id, entry.IsRunning );
+		AddApp( entry.Name, entry.PosterFileName, entry.Id, entry.IsRunning );
+	}
+}
+
+void AppManager::PrefetchAppLists( const Array<PcDef *> &pcs )
+{
+	const double now = vrapi_GetTimeInSeconds();
+	if ( now < NextPrefetchCheck )
+	{
+		return;
+	}
+	NextPrefetchCheck = now + 1.0;
+
+	const double wallTime = (double)time( NULL );
+	if ( AppLists.IsPrefetching( wallTime ) )
+	{
+		return;
+	}
+
+	for ( int i = 0; i < pcs.GetSizeI(); i++ )
+	{
+		const PcDef *pc = pcs[i];
+		if ( pc->PairState != Native::PAIRED || ( pc->Reach != Native::LOCAL && pc->Reach != Native::REMOTE ) )
+		{
+			continue;
+		}
+		if ( AppLists.StartPrefetch( pc->UUID.ToCStr(), wallTime ) )
+		{
+			LOG( "Prefetching the app list of %s", pc->Name.ToCStr() );
+			FetchAppList( pc->UUID, TASK_PRIORITY_PREFETCH );
+			return;
+		}
+	}
+}
+
+void AppManager::LoadStandInHosts( const String &directory )
+{
+	Array<String> names;
+	Cinema.Paths.ListDirectory( directory.ToCStr(), ".applist", names );
+	if ( names.GetSizeI() == 0 )
+	{
+		return;
+	}
+
+	StandInDirectory = directory;
+	StandInDirectory.AppendString( "/" );
+	for ( int i = 0; i < names.GetSizeI(); i++ )
+	{
+		String uuid = names[i];
+		uuid.StripExtension();
+		StandInHosts.PushBack( uuid );
+		Cinema.PcMgr.AddPc( String( "Stand-in " ) + uuid, uuid, Native::PAIRED, Native::LOCAL, "", false );
 	}
+	LOG( "LoadStandInHosts: %i hosts in %s", StandInHosts.GetSizeI(), directory.ToCStr() );
+}
+
+bool AppManager::IsStandInHost( const String &uuid ) const
+{
+	for ( int i = 0; i < StandInHosts.GetSizeI(); i++ )
+	{
+		if ( StandInHosts[i] == uuid )
+		{
+			return true;
+		}
+	}
+	return false;
 }
 
 void AppManager::ReadMetaData( PcDef *anApp )
@@ -162,25 +494,75 @@ void AppManager::ReadMetaData( PcDef *anApp )
 
 void AppManager::LoadPoster( PcDef *anApp )
 {
+	TRACE_SCOPE( "AppManager::LoadPoster" );
+
+	for ( int i = 0; i < PostersLoading.GetSizeI(); i++ )
+	{
+		if ( PostersLoading[i] == anApp )
+		{
+			return;
+		}
+	}
+
+	Cinema.StartClockBurst( CLOCK_BURST_POSTERS );
+
 	String posterFilename = anApp->PosterFileName;
 	posterFilename.StripExtension();
 	posterFilename.AppendString( ".png" );
 
-	anApp->Poster = LoadTextureFromBuffer( posterFilename.ToCStr(), MemBufferFile( posterFilename.ToCStr() ),
-			TextureFlags_t( TEXTUREFLAG_NO_DEFAULT ), anApp->PosterWidth, anApp->PosterHeight );
-	LOG( "Poster loaded: %s %i %i %i", posterFilename.ToCStr(), anApp->Poster, anApp->PosterWidth, anApp->PosterHeight);
-
-	// if all else failed, then just use the default poster
+	// the default poster shows until the real one is read
 	if ( anApp->Poster == 0 )
 	{
 		anApp->Poster = DefaultPoster;
 	}
-	else
+
+	PostersLoading.PushBack( anApp );
+	Cinema.Tasks.Submit( new PosterLoadTask( *this, anApp, posterFilename, PosterToken ) );
+}
+
+void AppManager::PosterLoaded( PcDef *anApp, const String &posterFilename, const MemBuffer &buffer, const bool cancelled )
+{
+	TRACE_SCOPE( "AppManager::PosterLoaded" );
+
+	for ( int i = 0; i < PostersLoading.GetSizeI(); i++ )
 	{
-		BuildTextureMipmaps( anApp->Poster );
-		MakeTextureTrilinear( anApp->Poster );
-		MakeTextureClamped( anApp->Poster );
+		if ( PostersLoading[i] == anApp )
+		{
+			PostersLoading.RemoveAtUnordered( i );
+			break;
+		}
+	}
+
+	if ( cancelled )
+	{
+		return;
 	}
+
+	// if all else failed, then just use the default poster
+	int width = 0, height = 0;
+	const GLuint poster = ( buffer.Length > 0 ) ? LoadTextureFromBuffer( posterFilename.ToCStr(), buffer,
+			TextureFlags_t( TEXTUREFLAG_NO_DEFAULT ), width, height ) : 0;
+	LOG( "Poster loaded: %s %i %i %i", posterFilename.ToCStr(), poster, width, height );
+	if ( poster == 0 )
+	{
+		return;
+	}
+
+	BuildTextureMipmaps( poster );
+	MakeTextureTrilinear( poster );
+	MakeTextureClamped( poster );
+
+	anApp->Poster = poster;
+	anApp->PosterWidth = width;
+	anApp->PosterHeight = height;
+	updated = true;
+}
+
+void AppManager::CancelPosterLoads()
+{
+	PosterToken->Cancel();
+	PosterToken->Release();
+	PosterToken = CancelToken::Create();
 }
 
 void AppManager::LoadPosters()
@@ -196,18 +578,7 @@ void AppManager::LoadPosters()
 
 Array<const PcDef *> AppManager::GetAppList( PcCategory category ) const
 {
-	Array<const PcDef *> result;
-
-	for( UPInt i = 0; i < Apps.GetSize(); i++ )
-	{
-		LOG("App: %s Poster %i", Apps[i]->Name.ToCStr(), Apps[i]->Poster);
-		if ( Apps[ i ]->Category == category && Apps[i]->Poster != 0)
-		{
-			result.PushBack( Apps[ i ] );
-		}
-	}
-
-	return result;
+	return Catalog::ListCategory( Apps, category );
 }
 
 } // namespace VRMatterStreamTheater
@@ -20,6 +20,8 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "Kernel/OVR_Array.h"
 #include "GlTexture.h"
 #include "PcManager.h"
+#include "TaskScheduler.h"
+#include "AppListCache.h"
 
 namespace VRMatterStreamTheater {
 
@@ -38,21 +40,6 @@ enum MovieFormat
 	VT_TOP_BOTTOM_3D_FULL,		// Top & bottom are unscaled.
 };
 
-class AppDef : public PcDef
-{
-public:
-/*	String			Name;
-	int				Id;
-
-	GLuint			Poster;
-	int				PosterWidth;
-	int				PosterHeight;
-
-	PcCategory		Category;
-*/
-	AppDef() : PcDef() {}
-};
-
 class AppManager : public PcManager
 {
 public:
@@ -66,10 +53,39 @@ public:
 	void					AddApp(const String &name, const String &posterFileName, int id, bool isRunning);
 	void					RemoveApp( int id);
 
+	// drops the poster reads that haven't finished, when the app list closes
+	void					CancelPosterLoads();
+
+	// Shows the host's cached list, if there is one, and asks for the live
+	// one, which replaces it through AppListReceived.
+	void					SelectHost( const String &uuid );
+
+	// any thread, a whole list from Java or a stand-in host.  Not ok when
+	// the fetch failed.
+	void					AppListReceived( const String &uuid, const Array<AppListEntry> &apps, const bool ok );
+
+	// GL thread, every frame.  Puts the lists that came in for the
+	// selected host on the carousel.
+	void					ApplyAppLists();
+
+	// GL thread, once the carousel shows the current list.  Deletes the
+	// retired apps and their posters when nothing points at them any more.
+	void					FreeRetiredApps();
+
+	// Called every frame while the PC list is up, fetches the list of one
+	// paired and reachable host at a time when it's out of date.
+	void					PrefetchAppLists( const Array<PcDef *> &pcs );
+
+	// Every <uuid>.applist in directory becomes a paired host whose apps are
+	// read from that file, so the app list can be tried without a PC.
+	void					LoadStandInHosts( const String &directory );
+	bool					IsStandInHost( const String &uuid ) const;
+
 	Array<const PcDef *>	GetAppList( PcCategory category ) const;
 
 public:
     Array<AppDef *> 		Apps;
+    AppListCache			AppLists;
 
     static const int 		PosterWidth;
     static const int 		PosterHeight;
@@ -81,8 +97,34 @@ private:
 
     GLuint					DefaultPoster;
 
+    CancelToken *			PosterToken;
+    Array<const PcDef *>	PostersLoading;
+
+    String					CurrentHost;		// whose apps are in Apps
+    String					AppListPath;
+    String					StandInDirectory;
+    Array<String>			StandInHosts;
+    double					NextPrefetchCheck;
+
+    pthread_mutex_t			ReceivedLock;
+    Array<String>			ReceivedHosts;		// lists stored since the last ApplyAppLists
+
+    // taken off the carousel, but poster loads, the carousel or the
+    // playlist may still point at them.  See FreeRetiredApps.
+    Array<AppDef *>			Retired;
+
+    int						SaveQueued;			// an AppListSaveTask is on its way, atomic
+
     virtual void 			ReadMetaData( PcDef *app );
     virtual void 			LoadPoster( PcDef *app );
+    void					PosterLoaded( PcDef *app, const String &posterFilename, const MemBuffer &buffer, const bool cancelled );
+    void					ShowAppList( const Array<AppListEntry> &fresh );
+    void					FetchAppList( const String &uuid, const TaskPriority priority );
+    bool					IsReferenced( const AppDef *app ) const;
+
+    friend class PosterLoadTask;
+    friend class StandInAppListTask;
+    friend class AppListSaveTask;
 };
 
 } // namespace VRMatterStreamTheater
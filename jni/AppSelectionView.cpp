@@ -30,6 +30,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "CinemaStrings.h"
 #include "BitmapFont.h"
 #include "Native.h"
+#include "TraceRecorder.h"
 
 namespace VRMatterStreamTheater {
 
@@ -133,6 +134,7 @@ AppSelectionView::~AppSelectionView()
 void AppSelectionView::OneTimeInit( const char * launchIntent )
 {
 	LOG( "AppSelectionView::OneTimeInit" );
+	TRACE_SCOPE( "AppSelectionView::OneTimeInit" );
 
 	const double start = vrapi_GetTimeInSeconds();
 
@@ -204,10 +206,10 @@ void AppSelectionView::OnOpen()
 	
 	const PcDef* selectedPC = Cinema.GetCurrentPc();
 	String uuid = selectedPC->UUID;
-	Native::PairState ps = Native::GetPairState(Cinema.app, uuid.ToCStr());
-	if (ps == Native::PAIRED) {
+	if (Cinema.AppMgr.IsStandInHost(uuid) || Native::GetPairState(Cinema.app, uuid.ToCStr()) == Native::PAIRED) {
 		LOG( "Paired");
-		Native::InitAppSelector(Cinema.app, uuid.ToCStr());
+		// shows the cached list right away, the live one replaces it when it comes
+		Cinema.AppMgr.SelectHost(uuid);
 	} else {
 		LOG( "Not Paired!");
 		Native::Pair(Cinema.app, uuid.ToCStr());
@@ -229,6 +231,7 @@ void AppSelectionView::OnClose()
 	CenterRoot->SetVisible( false );
 	Menu->Close();
 	Cinema.SceneMgr.ClearMovie();
+	Cinema.AppMgr.CancelPosterLoads();
 }
 
 bool AppSelectionView::Command( const char * msg )
@@ -1283,9 +1286,7 @@ Matrix4f AppSelectionView::DrawEyeView( const int eye, const float fovDegrees )
 Matrix4f AppSelectionView::Frame( const VrFrame & vrFrame )
 {
 	// We want 4x MSAA in the lobby
-	ovrEyeBufferParms eyeBufferParms = Cinema.app->GetEyeBufferParms();
-	eyeBufferParms.multisamples = 4;
-	Cinema.app->SetEyeBufferParms( eyeBufferParms );
+	Cinema.SetEyeBufferCeiling( EyeBufferLevel( 4, 1024 ) );
 
 #if 0
 	if ( !Cinema.InLobby && Cinema.SceneMgr.ChangeSeats( vrFrame ) )
@@ -1421,6 +1422,7 @@ Matrix4f AppSelectionView::Frame( const VrFrame & vrFrame )
 		Cinema.AppMgr.updated = false;
 		Cinema.AppMgr.LoadPosters();
 		SetAppList(Cinema.AppMgr.GetAppList(CurrentCategory), NULL);
+		Cinema.AppMgr.FreeRetiredApps();
 	}
 
 	return Cinema.SceneMgr.Frame( vrFrame );
@@ -0,0 +1,626 @@
+/************************************************************************************
+
+Filename    :   AsyncLog.cpp
+Content     :	Leveled, per category logging, formatted on a background thread
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "AsyncLog.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/system_properties.h>
+#include <android/log.h>
+
+namespace VRMatterStreamTheater {
+
+static const unsigned	RECORD_MASK		= AsyncLog::NUM_RECORDS - 1;
+static const int		ARG_BYTES		= AsyncLog::RECORD_BYTES - 32;
+static const int		TEXT_BYTES		= 1024;
+static const int		IDLE_MICROSECONDS = 10000;
+static const double		PROPERTY_SECONDS = 1.0;
+static const char *		LEVEL_PROPERTY	= "debug.streamtheater.log";
+
+static const char *		CategoryNames[LOG_CATEGORY_MAX] = { "app", "scene", "native", "settings", "menus", "stream" };
+static const char *		LevelNames[] = { "error", "warn", "info", "debug", "verbose" };
+static const char		LevelLetters[] = "EWIDV";
+static const int		LevelPriorities[] = { ANDROID_LOG_ERROR, ANDROID_LOG_WARN, ANDROID_LOG_INFO, ANDROID_LOG_DEBUG, ANDROID_LOG_VERBOSE };
+
+volatile int AsyncLog::Levels[LOG_CATEGORY_MAX] =
+{
+	LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO
+};
+
+struct LogRecord
+{
+	unsigned			Sequence;		// the ring position this record is free or full for
+	unsigned char		Category;
+	unsigned char		Level;
+	unsigned char		PackedSpecs;	// conversions whose arguments made it into Args
+	unsigned char		Truncated;
+	int					ThreadId;
+	double				Time;
+	const char *		Format;
+	char				Args[ARG_BYTES];
+};
+
+// Bounded queue after Dmitry Vyukov: any thread claims a slot by moving
+// EnqueuePos, only the drain thread reads.
+static LogRecord		Ring[AsyncLog::NUM_RECORDS];
+static unsigned			EnqueuePos = 0;
+static unsigned			DequeuePos = 0;
+static int				Dropped = 0;
+static int				Started = 0;
+static int				Writers = 0;		// inside Write, so Stop can wait them out
+static int				Running = 0;
+static pthread_t		DrainThreadId;
+static FILE *			LogFile = NULL;
+
+//==============================================================
+// printf conversions
+
+enum ArgKind
+{
+	ARG_NONE,
+	ARG_INT,
+	ARG_LONG,
+	ARG_LONG_LONG,
+	ARG_SIZE,
+	ARG_DOUBLE,
+	ARG_LONG_DOUBLE,
+	ARG_POINTER,
+	ARG_STRING
+};
+
+struct FormatSpec
+{
+	const char *	Start;			// the '%'
+	int				Length;
+	int				Stars;			// '*' width and precision, each an int argument
+	ArgKind			Kind;
+	char			Conversion;
+};
+
+// p points at a '%', returns the character after the conversion
+static const char * ParseSpec( const char * p, FormatSpec & spec )
+{
+	spec.Start = p++;
+	spec.Stars = 0;
+	while ( *p != '\0' && strchr( "-+ #0'", *p ) != NULL )
+	{
+		p++;
+	}
+	for ( int part = 0; part < 2; part++ )		// width, then precision
+	{
+		if ( part == 1 )
+		{
+			if ( *p != '.' )
+			{
+				break;
+			}
+			p++;
+		}
+		if ( *p == '*' )
+		{
+			spec.Stars++;
+			p++;
+		}
+		while ( *p >= '0' && *p <= '9' )
+		{
+			p++;
+		}
+	}
+
+	int longs = 0;
+	bool size = false;
+	bool longDouble = false;
+	while ( *p != '\0' && strchr( "hlzjtL", *p ) != NULL )
+	{
+		longs += ( *p == 'l' );
+		size |= ( *p == 'z' || *p == 't' );
+		longs += ( *p == 'j' ) * 2;
+		longDouble |= ( *p == 'L' );
+		p++;
+	}
+
+	spec.Conversion = *p;
+	if ( *p == '\0' )
+	{
+		spec.Kind = ARG_NONE;
+	}
+	else if ( strchr( "diouxXc", *p ) != NULL )
+	{
+		spec.Kind = size ? ARG_SIZE : ( longs >= 2 ? ARG_LONG_LONG : ( longs == 1 ? ARG_LONG : ARG_INT ) );
+		p++;
+	}
+	else if ( strchr( "fFeEgGaA", *p ) != NULL )
+	{
+		spec.Kind = longDouble ? ARG_LONG_DOUBLE : ARG_DOUBLE;
+		p++;
+	}
+	else if ( *p == 's' )
+	{
+		spec.Kind = ARG_STRING;
+		p++;
+	}
+	else if ( *p == 'p' || *p == 'n' )
+	{
+		spec.Kind = ARG_POINTER;
+		p++;
+	}
+	else
+	{
+		spec.Kind = ARG_NONE;
+		p++;
+	}
+	spec.Length = p - spec.Start;
+	return p;
+}
+
+static int ArgSize( const ArgKind kind )
+{
+	switch ( kind )
+	{
+		case ARG_INT:			return sizeof( int );
+		case ARG_LONG:			return sizeof( long );
+		case ARG_LONG_LONG:		return sizeof( long long );
+		case ARG_SIZE:			return sizeof( size_t );
+		case ARG_DOUBLE:		return sizeof( double );
+		case ARG_LONG_DOUBLE:	return sizeof( long double );
+		case ARG_POINTER:		return sizeof( void * );
+		default:				return 0;
+	}
+}
+
+// Copies the arguments the way the format says to read them, unaligned.
+// Returns false if they didn't all fit.
+static bool PackArgs( LogRecord & record, va_list args )
+{
+	char * out = record.Args;
+	char * const end = record.Args + ARG_BYTES;
+	record.PackedSpecs = 0;
+
+	for ( const char * p = record.Format; *p != '\0'; )
+	{
+		if ( *p != '%' )
+		{
+			p++;
+			continue;
+		}
+		FormatSpec spec;
+		p = ParseSpec( p, spec );
+		if ( spec.Conversion == '%' )
+		{
+			continue;
+		}
+		if ( record.PackedSpecs == 255 || out + spec.Stars * sizeof( int ) + ArgSize( spec.Kind ) > end )
+		{
+			return false;
+		}
+
+		for ( int i = 0; i < spec.Stars; i++ )
+		{
+			const int star = va_arg( args, int );
+			memcpy( out, &star, sizeof( star ) );
+			out += sizeof( star );
+		}
+
+		switch ( spec.Kind )
+		{
+			case ARG_INT:			{ const int v = va_arg( args, int ); memcpy( out, &v, sizeof( v ) ); break; }
+			case ARG_LONG:			{ const long v = va_arg( args, long ); memcpy( out, &v, sizeof( v ) ); break; }
+			case ARG_LONG_LONG:		{ const long long v = va_arg( args, long long ); memcpy( out, &v, sizeof( v ) ); break; }
+			case ARG_SIZE:			{ const size_t v = va_arg( args, size_t ); memcpy( out, &v, sizeof( v ) ); break; }
+			case ARG_DOUBLE:		{ const double v = va_arg( args, double ); memcpy( out, &v, sizeof( v ) ); break; }
+			case ARG_LONG_DOUBLE:	{ const long double v = va_arg( args, long double ); memcpy( out, &v, sizeof( v ) ); break; }
+			case ARG_POINTER:		{ const void * v = va_arg( args, void * ); memcpy( out, &v, sizeof( v ) ); break; }
+			case ARG_STRING:
+			{
+				const char * s = va_arg( args, const char * );
+				if ( s == NULL )
+				{
+					s = "(null)";
+				}
+				const int room = end - out;
+				const int length = strlen( s );
+				if ( room < 2 )
+				{
+					return false;
+				}
+				if ( length >= room )
+				{
+					// keep what fits, the rest of the record is lost anyway
+					memcpy( out, s, room - 1 );
+					out[room - 1] = '\0';
+					record.PackedSpecs++;
+					return false;
+				}
+				memcpy( out, s, length + 1 );
+				out += length + 1;
+				break;
+			}
+			default:
+				return false;
+		}
+		out += ArgSize( spec.Kind );
+		record.PackedSpecs++;
+	}
+	return true;
+}
+
+template< typename T >
+static int FormatArg( char * out, const int size, const char * spec, const int stars, const int * star, const T value )
+{
+	switch ( stars )
+	{
+		case 0:		return snprintf( out, size, spec, value );
+		case 1:		return snprintf( out, size, spec, star[0], value );
+		default:	return snprintf( out, size, spec, star[0], star[1], value );
+	}
+}
+
+template< typename T >
+static T ReadArg( const char * & in )
+{
+	T value;
+	memcpy( &value, in, sizeof( value ) );
+	in += sizeof( value );
+	return value;
+}
+
+static void FormatRecord( const LogRecord & record, char * text, const int size )
+{
+	const char * in = record.Args;
+	int length = 0;
+	int specs = 0;
+
+	for ( const char * p = record.Format; *p != '\0' && length < size - 1; )
+	{
+		if ( *p != '%' )
+		{
+			text[length++] = *p++;
+			continue;
+		}
+		FormatSpec spec;
+		p = ParseSpec( p, spec );
+		if ( spec.Conversion == '%' )
+		{
+			text[length++] = '%';
+			continue;
+		}
+		if ( specs++ >= record.PackedSpecs )
+		{
+			break;
+		}
+
+		char specText[32];
+		const int specLength = spec.Length < (int)sizeof( specText ) ? spec.Length : (int)sizeof( specText ) - 1;
+		memcpy( specText, spec.Start, specLength );
+		specText[specLength] = '\0';
+
+		int star[2] = { 0, 0 };
+		for ( int i = 0; i < spec.Stars; i++ )
+		{
+			star[i] = ReadArg<int>( in );
+		}
+
+		char * out = text + length;
+		const int room = size - length;
+		int written = 0;
+		switch ( spec.Kind )
+		{
+			case ARG_INT:			written = FormatArg( out, room, specText, spec.Stars, star, ReadArg<int>( in ) ); break;
+			case ARG_LONG:			written = FormatArg( out, room, specText, spec.Stars, star, ReadArg<long>( in ) ); break;
+			case ARG_LONG_LONG:		written = FormatArg( out, room, specText, spec.Stars, star, ReadArg<long long>( in ) ); break;
+			case ARG_SIZE:			written = FormatArg( out, room, specText, spec.Stars, star, ReadArg<size_t>( in ) ); break;
+			case ARG_DOUBLE:		written = FormatArg( out, room, specText, spec.Stars, star, ReadArg<double>( in ) ); break;
+			case ARG_LONG_DOUBLE:	written = FormatArg( out, room, specText, spec.Stars, star, ReadArg<long double>( in ) ); break;
+			case ARG_POINTER:
+			{
+				const void * pointer = ReadArg<const void *>( in );
+				written = ( spec.Conversion == 'n' ) ? 0 : FormatArg( out, room, specText, spec.Stars, star, pointer );
+				break;
+			}
+			case ARG_STRING:
+				written = FormatArg( out, room, specText, spec.Stars, star, in );
+				in += strlen( in ) + 1;
+				break;
+			default:
+				break;
+		}
+		length += ( written < 0 ) ? 0 : ( written < room ? written : room - 1 );
+	}
+
+	if ( record.Truncated )
+	{
+		const char * more = " ...";
+		while ( *more != '\0' && length < size - 1 )
+		{
+			text[length++] = *more++;
+		}
+	}
+	text[length] = '\0';
+}
+
+//==============================================================
+// output
+
+static double LogTime()
+{
+	// same clock as vrapi_GetTimeInSeconds
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static void Emit( const int category, const int level, const int threadId, const double time, const char * text )
+{
+	char tag[32];
+	snprintf( tag, sizeof( tag ), "StreamTheater/%s", CategoryNames[category] );
+	__android_log_write( LevelPriorities[level], tag, text );
+
+	if ( LogFile != NULL )
+	{
+		fprintf( LogFile, "%10.3f %5i %c %-8s %s\n", time, threadId, LevelLetters[level], CategoryNames[category], text );
+	}
+}
+
+static int DrainRecords()
+{
+	int drained = 0;
+	for ( ; ; )
+	{
+		LogRecord & record = Ring[DequeuePos & RECORD_MASK];
+		if ( __atomic_load_n( &record.Sequence, __ATOMIC_ACQUIRE ) != DequeuePos + 1 )
+		{
+			break;
+		}
+
+		char text[TEXT_BYTES];
+		FormatRecord( record, text, sizeof( text ) );
+		Emit( record.Category, record.Level, record.ThreadId, record.Time, text );
+
+		__atomic_store_n( &record.Sequence, DequeuePos + AsyncLog::NUM_RECORDS, __ATOMIC_RELEASE );
+		DequeuePos++;
+		drained++;
+	}
+
+	if ( drained > 0 && LogFile != NULL )
+	{
+		fflush( LogFile );
+	}
+	return drained;
+}
+
+static void ReadLevelProperty( char * lastValue )
+{
+	char value[PROP_VALUE_MAX];
+	if ( __system_property_get( LEVEL_PROPERTY, value ) > 0 && strcmp( value, lastValue ) != 0 )
+	{
+		strcpy( lastValue, value );
+		AsyncLog::ParseLevels( value );
+		__android_log_print( ANDROID_LOG_INFO, "StreamTheater", "AsyncLog: %s = %s", LEVEL_PROPERTY, value );
+	}
+}
+
+static void * DrainThread( void * )
+{
+	prctl( PR_SET_NAME, (unsigned long)"AsyncLog", 0, 0, 0 );
+
+	char property[PROP_VALUE_MAX] = "";
+	double lastPropertyTime = 0.0;
+	int reportedDropped = 0;
+
+	while ( __atomic_load_n( &Running, __ATOMIC_ACQUIRE ) )
+	{
+		const int drained = DrainRecords();
+
+		const double now = LogTime();
+		if ( now - lastPropertyTime >= PROPERTY_SECONDS )
+		{
+			lastPropertyTime = now;
+			ReadLevelProperty( property );
+
+			const int dropped = AsyncLog::GetDropped();
+			if ( dropped != reportedDropped )
+			{
+				__android_log_print( ANDROID_LOG_WARN, "StreamTheater", "AsyncLog: %i records dropped, ring full", dropped - reportedDropped );
+				reportedDropped = dropped;
+			}
+		}
+
+		if ( drained == 0 )
+		{
+			usleep( IDLE_MICROSECONDS );
+		}
+	}
+
+	// Stop has waited out the writers, so every claimed record is being
+	// published or already is
+	while ( DequeuePos != __atomic_load_n( &EnqueuePos, __ATOMIC_ACQUIRE ) )
+	{
+		if ( DrainRecords() == 0 )
+		{
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+//==============================================================
+// AsyncLog
+
+void AsyncLog::Start( const char * filePath )
+{
+	if ( __atomic_load_n( &Started, __ATOMIC_ACQUIRE ) )
+	{
+		return;
+	}
+
+	for ( int i = 0; i < NUM_RECORDS; i++ )
+	{
+		Ring[i].Sequence = i;
+	}
+	EnqueuePos = 0;
+	DequeuePos = 0;
+
+	if ( filePath != NULL )
+	{
+		LogFile = fopen( filePath, "a" );
+		if ( LogFile == NULL )
+		{
+			__android_log_print( ANDROID_LOG_WARN, "StreamTheater", "AsyncLog: couldn't open %s", filePath );
+		}
+	}
+
+	__atomic_store_n( &Running, 1, __ATOMIC_RELEASE );
+	if ( pthread_create( &DrainThreadId, NULL, DrainThread, NULL ) != 0 )
+	{
+		__android_log_print( ANDROID_LOG_WARN, "StreamTheater", "AsyncLog: no drain thread, logging directly" );
+		__atomic_store_n( &Running, 0, __ATOMIC_RELEASE );
+		return;
+	}
+	__atomic_store_n( &Started, 1, __ATOMIC_RELEASE );
+}
+
+void AsyncLog::Stop()
+{
+	if ( !__atomic_load_n( &Started, __ATOMIC_ACQUIRE ) )
+	{
+		return;
+	}
+	// A writer that saw Started has its record claimed by the time it
+	// leaves, later ones see it cleared and log directly
+	__atomic_store_n( &Started, 0, __ATOMIC_SEQ_CST );
+	while ( __atomic_load_n( &Writers, __ATOMIC_SEQ_CST ) != 0 )
+	{
+		sched_yield();
+	}
+	__atomic_store_n( &Running, 0, __ATOMIC_RELEASE );
+	pthread_join( DrainThreadId, NULL );
+
+	if ( LogFile != NULL )
+	{
+		fclose( LogFile );
+		LogFile = NULL;
+	}
+}
+
+void AsyncLog::SetLevel( const LogCategory category, const LogLevel level )
+{
+	__atomic_store_n( &Levels[category], (int)level, __ATOMIC_RELAXED );
+}
+
+int AsyncLog::GetDropped()
+{
+	return __atomic_load_n( &Dropped, __ATOMIC_RELAXED );
+}
+
+void AsyncLog::ParseLevels( const char * levels )
+{
+	const char * p = levels;
+	while ( *p != '\0' )
+	{
+		const char * separator = strpbrk( p, ":=" );
+		if ( separator == NULL )
+		{
+			break;
+		}
+		const char * end = separator + strcspn( separator, ", " );
+
+		int level = -1;
+		for ( int i = 0; i <= LOG_LEVEL_VERBOSE; i++ )
+		{
+			if ( (int)strlen( LevelNames[i] ) == end - separator - 1 && strncmp( separator + 1, LevelNames[i], end - separator - 1 ) == 0 )
+			{
+				level = i;
+			}
+		}
+
+		if ( level >= 0 )
+		{
+			const int nameLength = separator - p;
+			const bool all = ( nameLength == 3 && strncmp( p, "all", 3 ) == 0 );
+			for ( int i = 0; i < LOG_CATEGORY_MAX; i++ )
+			{
+				if ( all || ( (int)strlen( CategoryNames[i] ) == nameLength && strncmp( p, CategoryNames[i], nameLength ) == 0 ) )
+				{
+					SetLevel( (LogCategory)i, (LogLevel)level );
+				}
+			}
+		}
+
+		p = end + strspn( end, ", " );
+	}
+}
+
+void AsyncLog::Write( const LogCategory category, const LogLevel level, const char * format, ... )
+{
+	va_list args;
+	va_start( args, format );
+
+	__atomic_add_fetch( &Writers, 1, __ATOMIC_SEQ_CST );
+	if ( !__atomic_load_n( &Started, __ATOMIC_SEQ_CST ) )
+	{
+		__atomic_sub_fetch( &Writers, 1, __ATOMIC_RELEASE );
+		char text[TEXT_BYTES];
+		vsnprintf( text, sizeof( text ), format, args );
+		va_end( args );
+		Emit( category, level, gettid(), LogTime(), text );
+		return;
+	}
+
+	LogRecord * record = NULL;
+	unsigned pos = __atomic_load_n( &EnqueuePos, __ATOMIC_RELAXED );
+	for ( ; ; )
+	{
+		LogRecord & slot = Ring[pos & RECORD_MASK];
+		const int diff = (int)( __atomic_load_n( &slot.Sequence, __ATOMIC_ACQUIRE ) - pos );
+		if ( diff == 0 )
+		{
+			if ( __atomic_compare_exchange_n( &EnqueuePos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+			{
+				record = &slot;
+				break;
+			}
+		}
+		else if ( diff < 0 )
+		{
+			// full, the caller must never wait on the drain thread
+			__atomic_fetch_add( &Dropped, 1, __ATOMIC_RELAXED );
+			__atomic_sub_fetch( &Writers, 1, __ATOMIC_RELEASE );
+			va_end( args );
+			return;
+		}
+		else
+		{
+			pos = __atomic_load_n( &EnqueuePos, __ATOMIC_RELAXED );
+		}
+	}
+
+	record->Category = (unsigned char)category;
+	record->Level = (unsigned char)level;
+	record->ThreadId = gettid();
+	record->Time = LogTime();
+	record->Format = format;
+	record->Truncated = !PackArgs( *record, args );
+	va_end( args );
+
+	__atomic_store_n( &record->Sequence, pos + 1, __ATOMIC_RELEASE );
+	__atomic_sub_fetch( &Writers, 1, __ATOMIC_RELEASE );
+}
+
+} // namespace VRMatterStreamTheater
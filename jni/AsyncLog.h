@@ -0,0 +1,98 @@
+/************************************************************************************
+
+Filename    :   AsyncLog.h
+Content     :	Leveled, per category logging, formatted on a background thread
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( AsyncLog_h )
+#define AsyncLog_h
+
+// Anything above this level is compiled out, arguments and all.  Release
+// builds keep info and up, ndk-build STREAMTHEATER_LOG_LEVEL=4 keeps everything.
+#if !defined( STREAMTHEATER_LOG_LEVEL )
+#if defined( NDEBUG )
+#define STREAMTHEATER_LOG_LEVEL		2
+#else
+#define STREAMTHEATER_LOG_LEVEL		4
+#endif
+#endif
+
+namespace VRMatterStreamTheater {
+
+enum LogLevel
+{
+	LOG_LEVEL_ERROR,
+	LOG_LEVEL_WARN,
+	LOG_LEVEL_INFO,
+	LOG_LEVEL_DEBUG,
+	LOG_LEVEL_VERBOSE
+};
+
+enum LogCategory
+{
+	LOG_CATEGORY_APP,
+	LOG_CATEGORY_SCENE,
+	LOG_CATEGORY_NATIVE,
+	LOG_CATEGORY_SETTINGS,
+	LOG_CATEGORY_MENUS,
+	LOG_CATEGORY_STREAM,
+	LOG_CATEGORY_MAX
+};
+
+//==============================================================
+// AsyncLog
+// Write only copies the format pointer and the raw arguments into a
+// fixed size record of a lock-free ring, strings by value.  The drain
+// thread does the formatting and hands the text to logcat, and to a file
+// if one was given.  A full ring drops the record instead of waiting.
+//
+// Levels can be raised per category while running with
+//     adb shell setprop debug.streamtheater.log scene:debug,native:verbose
+// which the drain thread rereads every second.  "all" sets every category.
+class AsyncLog
+{
+public:
+	static const int	NUM_RECORDS = 1024;		// power of two
+	static const int	RECORD_BYTES = 256;		// a record whose arguments don't fit is cut short
+
+	// until Start, and after Stop, Write formats and logs on the calling thread
+	static void			Start( const char * filePath );
+	static void			Stop();
+
+	static void			SetLevel( const LogCategory category, const LogLevel level );
+	static LogLevel		GetLevel( const LogCategory category ) { return (LogLevel)Levels[category]; }
+	static bool			IsEnabled( const LogCategory category, const LogLevel level ) { return level <= Levels[category]; }
+
+	// format must be a string literal, only the pointer is kept
+	static void			Write( const LogCategory category, const LogLevel level, const char * format, ... ) __attribute__( ( format( printf, 3, 4 ) ) );
+
+	// records lost to a full ring
+	static int			GetDropped();
+
+	// "scene:debug,all:info", unknown names are skipped
+	static void			ParseLevels( const char * levels );
+
+private:
+	static volatile int	Levels[LOG_CATEGORY_MAX];
+};
+
+} // namespace VRMatterStreamTheater
+
+#define SLOG_ENABLED( category, level )		( ( level ) <= STREAMTHEATER_LOG_LEVEL && VRMatterStreamTheater::AsyncLog::IsEnabled( category, level ) )
+
+#define SLOG( category, level, ... )		do { if ( SLOG_ENABLED( category, level ) ) { VRMatterStreamTheater::AsyncLog::Write( category, level, __VA_ARGS__ ); } } while ( 0 )
+#define SLOG_ERROR( category, ... )			SLOG( category, VRMatterStreamTheater::LOG_LEVEL_ERROR, __VA_ARGS__ )
+#define SLOG_WARN( category, ... )			SLOG( category, VRMatterStreamTheater::LOG_LEVEL_WARN, __VA_ARGS__ )
+#define SLOG_INFO( category, ... )			SLOG( category, VRMatterStreamTheater::LOG_LEVEL_INFO, __VA_ARGS__ )
+#define SLOG_DEBUG( category, ... )			SLOG( category, VRMatterStreamTheater::LOG_LEVEL_DEBUG, __VA_ARGS__ )
+#define SLOG_VERBOSE( category, ... )		SLOG( category, VRMatterStreamTheater::LOG_LEVEL_VERBOSE, __VA_ARGS__ )
+
+#endif // AsyncLog_h
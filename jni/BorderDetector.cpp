@@ -0,0 +1,178 @@
+/************************************************************************************
+
+Filename    :   BorderDetector.cpp
+Content     :	Finds the black letterbox and pillarbox bars around the picture
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "BorderDetector.h"
+#include "Kernel/OVR_Alg.h"
+
+#include <string.h>
+
+#if defined( __ARM_NEON__ ) || defined( __ARM_NEON )
+#include <arm_neon.h>
+#define BORDER_DETECT_NEON
+#endif
+
+namespace VRMatterStreamTheater {
+
+static const int	BLACK_LEVEL			= 24;		// video black is 16, leave room for compression noise
+static const float	MIN_PICTURE_AREA	= 0.2f;		// a darker frame can't show where the bars are
+static const float	MIN_CROP_AREA		= 0.95f;	// bars thinner than this aren't worth cropping
+static const float	EDGE_TOLERANCE		= 0.01f;	// edges closer than this count as the same
+static const int	SETTLE_SAMPLES		= 10;		// first crop needs this many samples in the window
+static const int	MAX_SETTLE_SAMPLES	= 160;
+
+BorderDetector::BorderDetector() :
+	Window(),
+	WindowSamples( 0 ),
+	SettleSamples( SETTLE_SAMPLES ),
+	Crop( ContentRect::Full() )
+
+{
+}
+
+void BorderDetector::Reset()
+{
+	Window = ContentRect();
+	WindowSamples = 0;
+	SettleSamples = SETTLE_SAMPLES;
+	Crop = ContentRect::Full();
+}
+
+static bool Inside( const ContentRect & inner, const ContentRect & outer, const float tolerance )
+{
+	return inner.X0 >= outer.X0 - tolerance && inner.Y0 >= outer.Y0 - tolerance &&
+			inner.X1 <= outer.X1 + tolerance && inner.Y1 <= outer.Y1 + tolerance;
+}
+
+bool BorderDetector::AddSample( const UByte * rgba, const int width, const int height )
+{
+	return AddPicture( FindPicture( rgba, width, height ) );
+}
+
+bool BorderDetector::AddPicture( const ContentRect & picture )
+{
+	if ( picture.IsEmpty() )
+	{
+		return false;
+	}
+
+	// nothing that is picture stays cropped away
+	if ( !Inside( picture, Crop, 0.0f ) )
+	{
+		Crop.Include( picture );
+		if ( Crop.Area() >= MIN_CROP_AREA )
+		{
+			Crop = ContentRect::Full();
+		}
+		Window = ContentRect();
+		WindowSamples = 0;
+		SettleSamples = Alg::Min( SettleSamples * 2, MAX_SETTLE_SAMPLES );
+		return true;
+	}
+
+	if ( picture.Area() < MIN_PICTURE_AREA )
+	{
+		return false;
+	}
+
+	Window.Include( picture );
+	WindowSamples++;
+	if ( WindowSamples < SettleSamples )
+	{
+		return false;
+	}
+
+	const ContentRect closer = ( Window.Area() < MIN_CROP_AREA ) ? Window : ContentRect::Full();
+	Window = ContentRect();
+	WindowSamples = 0;
+	if ( Inside( Crop, closer, EDGE_TOLERANCE ) )
+	{
+		return false;
+	}
+	Crop = closer;
+	return true;
+}
+
+// Marks the columns of a row with a pixel above black, and returns
+// whether there was any.  Luma * 256 of a pixel fits 16 bits.
+static bool LitRow( const UByte * rgba, const int width, UByte * columns )
+{
+	int x = 0;
+	int lit = 0;
+#if defined( BORDER_DETECT_NEON )
+	const uint8x8_t wr = vdup_n_u8( 77 );
+	const uint8x8_t wg = vdup_n_u8( 150 );
+	const uint8x8_t wb = vdup_n_u8( 29 );
+	const uint16x8_t black = vdupq_n_u16( BLACK_LEVEL * 256 );
+	uint8x8_t rowLit = vdup_n_u8( 0 );
+	for ( ; x + 8 <= width; x += 8 )
+	{
+		const uint8x8x4_t p = vld4_u8( rgba + x * 4 );
+		uint16x8_t luma = vmull_u8( p.val[0], wr );
+		luma = vmlal_u8( luma, p.val[1], wg );
+		luma = vmlal_u8( luma, p.val[2], wb );
+		const uint8x8_t above = vmovn_u16( vcgtq_u16( luma, black ) );
+		vst1_u8( columns + x, vorr_u8( vld1_u8( columns + x ), above ) );
+		rowLit = vorr_u8( rowLit, above );
+	}
+	lit = vget_lane_u64( vreinterpret_u64_u8( rowLit ), 0 ) != 0;
+#endif
+	for ( ; x < width; x++ )
+	{
+		const UByte * p = rgba + x * 4;
+		const int above = ( p[0] * 77 + p[1] * 150 + p[2] * 29 ) > BLACK_LEVEL * 256;
+		columns[x] |= above;
+		lit |= above;
+	}
+	return lit != 0;
+}
+
+ContentRect BorderDetector::FindPicture( const UByte * rgba, const int width, const int height )
+{
+	if ( width <= 0 || height <= 0 || width > MAX_SAMPLE_SIZE || height > MAX_SAMPLE_SIZE )
+	{
+		return ContentRect();
+	}
+
+	UByte columns[MAX_SAMPLE_SIZE];
+	memset( columns, 0, width );
+	int y0 = height;
+	int y1 = 0;
+	for ( int y = 0; y < height; y++ )
+	{
+		if ( LitRow( rgba + y * width * 4, width, columns ) )
+		{
+			y0 = Alg::Min( y0, y );
+			y1 = y + 1;
+		}
+	}
+	if ( y1 == 0 )
+	{
+		return ContentRect();
+	}
+
+	int x0 = 0;
+	while ( columns[x0] == 0 )
+	{
+		x0++;
+	}
+	int x1 = width;
+	while ( columns[x1 - 1] == 0 )
+	{
+		x1--;
+	}
+
+	return ContentRect( (float)x0 / width, (float)y0 / height, (float)x1 / width, (float)y1 / height );
+}
+
+} // namespace VRMatterStreamTheater
@@ -0,0 +1,64 @@
+/************************************************************************************
+
+Filename    :   BorderDetector.h
+Content     :	Finds the black letterbox and pillarbox bars around the picture
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( BorderDetector_h )
+#define BorderDetector_h
+
+#include "Kernel/OVR_Types.h"
+#include "ContentChangeDetector.h"
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+//==============================================================
+// BorderDetector
+// Finds the rows and columns of a sample with pixels above black.
+// The crop only closes in on the picture after every sample for several
+// seconds stayed inside it, so a dark scene doesn't shrink the screen.
+// Anything showing up outside the crop opens it again at once, and each
+// time that happens the crop waits twice as long before closing in.
+class BorderDetector
+{
+public:
+	static const int	MAX_SAMPLE_SIZE = 1024;		// wider or taller samples are ignored
+
+						BorderDetector();
+
+	void				Reset();
+
+	// rows are tightly packed, width * 4 bytes.  Returns true if the crop changed.
+	bool				AddSample( const UByte * rgba, const int width, const int height );
+
+	// The picture of one sample, any thread.  Rows and columns with any
+	// pixel above black are picture, the picture is everything between
+	// the outermost of them.  Empty for a black or too big sample.
+	static ContentRect	FindPicture( const UByte * rgba, const int width, const int height );
+
+	// a picture found elsewhere.  Returns true if the crop changed.
+	bool				AddPicture( const ContentRect & picture );
+
+	// the part of the stream that holds the picture, full until the bars are certain
+	const ContentRect &	GetCrop() const { return Crop; }
+
+private:
+	ContentRect			Window;			// every picture seen since the crop last changed
+	int					WindowSamples;
+	int					SettleSamples;	// samples the window needs before the crop closes in
+	ContentRect			Crop;
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // BorderDetector_h
@@ -77,34 +77,8 @@ void CarouselBrowserComponent::SetMenuObjects( const Array<VRMenuObject *> &menu
 
 PanelPose CarouselBrowserComponent::GetPosition( const float t )
 {
-	int index = ( int )floor( t );
-	float frac = t - ( float )index;
-
-	PanelPose pose;
-
-	if ( index < 0 )
-	{
-		pose = PanelPoses[ 0 ];
-	}
-	else if ( ( index == PanelPoses.GetSizeI() - 1 ) && ( fabs( frac ) <= 0.00001f ) )
-	{
-		pose = PanelPoses[ PanelPoses.GetSizeI() - 1 ];
-	}
-	else if ( index >= PanelPoses.GetSizeI() - 1 )
-	{
-		pose.Orientation = Quatf();
-		pose.Position = Vector3f( 0.0f, 0.0f, 0.0f );
-		pose.Color = Vector4f( 0.0f, 0.0f, 0.0f, 0.0f );
-	}
-	else
-	{
-		pose.Orientation = PanelPoses[ index + 1 ].Orientation.Nlerp( PanelPoses[ index ].Orientation, frac ); // NLerp has the frac inverted
-		pose.Position = PanelPoses[ index ].Position.Lerp( PanelPoses[ index + 1 ].Position, frac );
-		pose.Color = PanelPoses[ index ].Color * ( 1.0f - frac ) + PanelPoses[ index + 1 ].Color * frac;
-	}
-
+	PanelPose pose = InterpolatePanelPose( PanelPoses, t );
 	pose.Position = pose.Position * PositionScale;
-
 	return pose;
 }
 
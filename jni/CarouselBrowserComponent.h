@@ -18,6 +18,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 
 #include "VRMenu/VRMenu.h"
 #include "VRMenu/VRMenuComponent.h"
+#include "ScreenMath.h"
 
 using namespace OVR;
 
@@ -35,18 +36,6 @@ public:
 				CarouselItem() : texture( 0 ), textureWidth( 0 ), textureHeight( 0 ), userFlags( 0 ) {}
 };
 
-class PanelPose
-{
-public:
-	Quatf    	Orientation;
-	Vector3f 	Position;
-	Vector4f	Color;
-
-				PanelPose() {};
-				PanelPose( Quatf orientation, Vector3f position, Vector4f color ) :
-					Orientation( orientation ), Position( position ), Color( color ) {}
-};
-
 class CarouselItemComponent : public VRMenuComponent
 {
 public:
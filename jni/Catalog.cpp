@@ -0,0 +1,118 @@
+/************************************************************************************
+
+Filename    :   Catalog.cpp
+Content     :	The hosts and apps the carousels show, without the textures behind them
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "Catalog.h"
+
+namespace VRMatterStreamTheater {
+
+namespace Catalog {
+
+PcDef * FindPc( const Array<PcDef *> &pcs, const String &name )
+{
+	for ( int i = 0; i < pcs.GetSizeI(); i++ )
+	{
+		if ( pcs[i]->Name.CompareNoCase( name ) == 0 )
+		{
+			return pcs[i];
+		}
+	}
+	return NULL;
+}
+
+PcDef * UpdatePc( Array<PcDef *> &pcs, const String &name, const String &uuid, const HostState::PairState pairState,
+		const HostState::Reachability reachability, const String &binding, const bool isRunning, bool &isNew )
+{
+	PcDef *pc = FindPc( pcs, name );
+	isNew = ( pc == NULL );
+	if ( isNew )
+	{
+		pc = new PcDef();
+		pcs.PushBack( pc );
+	}
+
+	pc->Name = name;
+	pc->UUID = uuid;
+	pc->Binding = binding;
+	pc->isRunning = isRunning;
+	pc->isRemote = ( reachability == HostState::REMOTE );
+	pc->PairState = pairState;
+	pc->Reach = reachability;
+	return pc;
+}
+
+PcDef * RemovePc( Array<PcDef *> &pcs, const String &name )
+{
+	for ( int i = 0; i < pcs.GetSizeI(); i++ )
+	{
+		if ( pcs[i]->Name.CompareNoCase( name ) == 0 )
+		{
+			PcDef *pc = pcs[i];
+			pcs.RemoveAt( i );
+			return pc;
+		}
+	}
+	return NULL;
+}
+
+AppDef * UpdateApp( Array<AppDef *> &apps, const String &name, const String &posterFileName, const int id, const bool isRunning, bool &isNew )
+{
+	AppDef *app = NULL;
+	for ( int i = 0; i < apps.GetSizeI() && app == NULL; i++ )
+	{
+		if ( apps[i]->Id == id )
+		{
+			app = apps[i];
+		}
+	}
+	for ( int i = 0; i < apps.GetSizeI() && app == NULL; i++ )
+	{
+		if ( apps[i]->Name.CompareNoCase( name ) == 0 )
+		{
+			app = apps[i];
+		}
+	}
+
+	isNew = ( app == NULL );
+	if ( isNew )
+	{
+		app = new AppDef();
+		apps.PushBack( app );
+	}
+
+	app->Name = name;
+	app->Id = id;
+	app->PosterFileName = posterFileName;
+	app->isRunning = isRunning;
+	return app;
+}
+
+int RemoveApp( Array<AppDef *> &apps, const int id, Array<AppDef *> &removed )
+{
+	int count = 0;
+	for ( int i = 0; i < apps.GetSizeI(); i++ )
+	{
+		if ( apps[i]->Id == id )
+		{
+			removed.PushBack( apps[i] );
+			apps.RemoveAt( i );
+			i--;
+			count++;
+		}
+	}
+	return count;
+}
+
+} // namespace Catalog
+
+} // namespace VRMatterStreamTheater
@@ -0,0 +1,130 @@
+/************************************************************************************
+
+Filename    :   Catalog.h
+Content     :	The hosts and apps the carousels show, without the textures behind them
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( Catalog_h )
+#define Catalog_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_String.h"
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+// What Java reports about a host.  Native derives from this so the states
+// keep their Native:: names.
+struct HostState
+{
+	enum PairState {
+		NOT_PAIRED = 0,
+		PAIRED,
+		PIN_WRONG,
+		FAILED
+	};
+
+    enum CompState {
+		ONLINE = 0,
+		OFFLINE,
+		UNKNOWN_STATE
+    };
+
+    enum Reachability {
+    	LOCAL = 0,
+    	REMOTE,
+    	RS_OFFLINE,
+    	UNKNOWN_REACH
+    };
+};
+
+enum PcCategory {
+	CATEGORY_LIMELIGHT,
+	CATEGORY_REMOTEDESKTOP,
+	CATEGORY_VNC
+};
+
+class PcDef
+{
+public:
+	String			Name;
+	String			PosterFileName;
+	String			UUID;
+	String			Binding;
+	int				Id;
+	bool			isRunning;
+	bool			isRemote;
+	HostState::PairState	PairState;
+	HostState::Reachability	Reach;
+
+	unsigned int	Poster;			// GL texture name, 0 while there is none
+	int				PosterWidth;
+	int				PosterHeight;
+
+	PcCategory		Category;
+
+	PcDef() : Name(), PosterFileName(), UUID(), Binding(), Id( 0 ), isRunning( false ), isRemote( false ), PairState( HostState::NOT_PAIRED ), Reach( HostState::UNKNOWN_REACH ),
+			Poster( 0 ), PosterWidth( 0 ), PosterHeight( 0 ), Category( CATEGORY_LIMELIGHT ) {}
+};
+
+class AppDef : public PcDef
+{
+public:
+	AppDef() : PcDef() {}
+};
+
+//==============================================================
+// Catalog
+// The list bookkeeping of PcManager and AppManager.  Nothing here frees
+// a def: the carousels and poster loads hold on to them, the managers
+// decide when they can go.
+
+namespace Catalog
+{
+	// the host named name, case insensitive, or NULL
+	PcDef *		FindPc( const Array<PcDef *> &pcs, const String &name );
+
+	// Updates the host named name, adding it when there is none.  isNew is
+	// set when it was added.
+	PcDef *		UpdatePc( Array<PcDef *> &pcs, const String &name, const String &uuid, const HostState::PairState pairState,
+						const HostState::Reachability reachability, const String &binding, const bool isRunning, bool &isNew );
+
+	// takes the host named name off the list and returns it, NULL if there was none
+	PcDef *		RemovePc( Array<PcDef *> &pcs, const String &name );
+
+	// Updates the app with the id or, failing that, the name, adding it
+	// when there is neither.
+	AppDef *	UpdateApp( Array<AppDef *> &apps, const String &name, const String &posterFileName, const int id, const bool isRunning, bool &isNew );
+
+	// moves every app with the id to removed, returns how many there were
+	int			RemoveApp( Array<AppDef *> &apps, const int id, Array<AppDef *> &removed );
+
+	// the defs of the category that have a poster to show
+	template< class Def >
+	Array<const PcDef *>	ListCategory( const Array<Def *> &defs, const PcCategory category )
+	{
+		Array<const PcDef *> result;
+		for ( int i = 0; i < defs.GetSizeI(); i++ )
+		{
+			if ( defs[i]->Category == category && defs[i]->Poster != 0 )
+			{
+				result.PushBack( defs[i] );
+			}
+		}
+		return result;
+	}
+}
+
+} // namespace VRMatterStreamTheater
+
+#endif // Catalog_h
@@ -17,6 +17,9 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "CinemaApp.h"
 #include "Native.h"
 #include "CinemaStrings.h"
+#include "TraceRecorder.h"
+#include "AsyncLog.h"
+#include "Settings.h"
 
 #include <unistd.h>
 
@@ -24,6 +27,12 @@ of patent rights can be found in the PATENTS file in the same directory.
 
 namespace VRMatterStreamTheater {
 
+// seconds after startup before the player's submenus are built in the background
+static const double MENU_PREBUILD_DELAY = 3.0;
+
+// main thread time per frame for finishing background tasks
+static const double TASK_COMPLETION_BUDGET = 0.002;
+
 CinemaApp::CinemaApp() :
 	GuiSys( OvrGuiSys::Create() ),
 	StartTime( 0 ),
@@ -32,6 +41,16 @@ CinemaApp::CinemaApp() :
 	ModelMgr( *this ),
 	PcMgr( *this ),
 	AppMgr( *this ),
+	TextCache(),
+	Paths(),
+	Tasks(),
+	Latency(),
+	Hud( *this ),
+	CpuLevel( 0 ),
+	GpuLevel( 0 ),
+	Clocks(),
+	EyeTimer(),
+	EyeBuffers(),
 	InLobby( true ),
 	AllowDebugControls( false ),
 	ViewMgr(),
@@ -47,7 +66,19 @@ CinemaApp::CinemaApp() :
 	PlayList(),
 	ShouldResumeMovie( false ),
 	MovieFinishedPlaying( false ),
-	DelayedError( NULL )
+	DelayedError( NULL ),
+	CacheDirectory(),
+	LaunchIntent(),
+	Startup(),
+	PrebuildPlayerMenus( true ),
+	PlayerMenusPrebuilt( false ),
+	PlayerMenuPrebuildSeconds( 0.0 ),
+	EyeBufferCeiling(),
+	EyeBufferWindow(),
+	ReplayVideoQueue( 1 ),
+	ReplayFrameTimes(),
+	ReplayCpuSeconds( 0.0 ),
+	ReplayingFrame( NULL )
 
 {
 }
@@ -64,7 +95,9 @@ void CinemaApp::Configure( ovrSettings & settings )
 	settings.ModeParms.CpuLevel = 1;
 	settings.ModeParms.GpuLevel = 2;
 
-	// Allow users to specify a file to override the CPU and GPU settings
+	// Allow users to specify a file to override the CPU and GPU settings,
+	// the clock governor leaves those alone.
+	bool pinned = false;
 	String	outPath;
 	const bool validDir = app->GetStoragePaths().GetPathIfValidPermission(
 			EST_PRIMARY_EXTERNAL_STORAGE, EFT_FILES, "", W_OK | R_OK, outPath );
@@ -84,6 +117,7 @@ void CinemaApp::Configure( ovrSettings & settings )
 			{
 				settings.ModeParms.CpuLevel = cpu;
 				settings.ModeParms.GpuLevel = gpu;
+				pinned = true;
 				LOG("Overriding CPU to %d and GPU to %d!", cpu, gpu);
 			}
 			else
@@ -93,40 +127,85 @@ void CinemaApp::Configure( ovrSettings & settings )
 		}
 	}
 
+	CpuLevel = settings.ModeParms.CpuLevel;
+	GpuLevel = settings.ModeParms.GpuLevel;
+	if ( pinned )
+	{
+		Clocks.Pin( ClockLevels( CpuLevel, GpuLevel ) );
+	}
+	else
+	{
+		Clocks.Reset( ClockLevels( CpuLevel, GpuLevel ), vrapi_GetTimeInSeconds() );
+	}
+
 	// when the app is throttled, go to the platform UI and display a
 	// dismissable warning. On return to the app, force 30Hz timewarp.
 	settings.ModeParms.AllowPowerSave = true;
 
-	// Default to 2x MSAA.
+	// Start where the governor starts, UpdateEyeBuffers takes it from there.
 	settings.EyeBufferParms.colorFormat = COLOR_8888;
 	//settings.EyeBufferParms.depthFormat = DEPTH_16;
-	settings.EyeBufferParms.multisamples = 2;
+	settings.EyeBufferParms.multisamples = EyeBuffers.GetLevel().Multisamples;
+	settings.EyeBufferParms.resolution = EyeBuffers.GetLevel().Resolution;
 }
 
 void CinemaApp::OneTimeInit( const char * fromPackage, const char * launchIntentJSON, const char * launchIntentURI )
 {
 	LOG( "--------------- CinemaApp OneTimeInit ---------------");
+	TRACE_SCOPE( "CinemaApp::OneTimeInit" );
 
-	GuiSys->Init( app, &app->GetSoundMgr(), app->LoadFontForLocale(), &app->GetDebugLines() );
+	{
+		TRACE_SCOPE( "GuiSys::Init" );
+		GuiSys->Init( app, &app->GetSoundMgr(), app->LoadFontForLocale(), &app->GetDebugLines() );
+	}
 
 	StartTime = vrapi_GetTimeInSeconds();
+	Startup.Begin( StartTime );
+	LaunchIntent = launchIntentURI;
 
 	Native::OneTimeInit( app, ActivityClass );
+	CacheDirectory = Native::GetExternalCacheDirectory( app );
+	Paths.AddRoot( ExternalRetailDir( "" ) );
+	Paths.AddRoot( RetailDir( "" ) );
+	Paths.AddRoot( SDCardDir( "" ) );
+
+	// a log_to_file marker next to the session files copies the log into a file there
+	String filesPath;
+	const bool haveFilesPath = app->GetStoragePaths().GetPathIfValidPermission(
+			EST_PRIMARY_EXTERNAL_STORAGE, EFT_FILES, "", W_OK | R_OK, filesPath );
+	const bool logToFile = haveFilesPath && FileExists( filesPath + "log_to_file" );
+	AsyncLog::Start( logToFile ? ( filesPath + "streamtheater.log" ).ToCStr() : NULL );
+
+	Tasks.Start( 0 );
 	CinemaStrings::OneTimeInit( *this );
+	EyeTimer.Init();
+
+	// Only what the lobby and the PC and app carousels need.  The rest is
+	// stepped through on the frames after the first, see RunStartupStep.
 	ShaderMgr.OneTimeInit( launchIntentURI );
 	ModelMgr.OneTimeInit( launchIntentURI );
 	SceneMgr.OneTimeInit( launchIntentURI );
 	PcMgr.OneTimeInit( launchIntentURI );
 	AppMgr.OneTimeInit( launchIntentURI );
-	MoviePlayer.OneTimeInit( launchIntentURI );
-	ViewMgr.AddView( &MoviePlayer );
+	if ( haveFilesPath )
+	{
+		AppMgr.LoadStandInHosts( filesPath + "standin_hosts" );
+		SceneMgr.TestScreens = FileExists( filesPath + "test_screens" );
+
+		// the player only opens its settings when it's first shown, long after the prebuild
+		if ( FileExists( filesPath + "settings.json" ) )
+		{
+			Settings settings( ( filesPath + "settings.json" ).ToCStr() );
+			settings.Define( "PrebuildPlayerMenus", &PrebuildPlayerMenus );
+			settings.Load();
+		}
+	}
 	PcSelectionMenu.OneTimeInit( launchIntentURI );
 	ViewMgr.AddView( &PcSelectionMenu );
 	AppSelectionMenu.OneTimeInit( launchIntentURI );
 	ViewMgr.AddView( &AppSelectionMenu );
-	TheaterSelectionMenu.OneTimeInit( launchIntentURI );
-	ViewMgr.AddView( &TheaterSelectionMenu );
-	ResumeMovieMenu.OneTimeInit( launchIntentURI );
+
+	StartSession();
 
 	PcSelection( true );
 
@@ -137,7 +216,13 @@ void CinemaApp::OneTimeShutdown()
 {
 	LOG( "--------------- CinemaApp OneTimeShutdown ---------------");
 
+	Session.StopRecording();
+
+	// the managers get their last Finish calls before they shut down
+	Tasks.Shutdown();
+
 	Native::OneTimeShutdown();
+	EyeTimer.Shutdown();
 	ShaderMgr.OneTimeShutdown();
 	ModelMgr.OneTimeShutdown();
 	SceneMgr.OneTimeShutdown();
@@ -148,62 +233,64 @@ void CinemaApp::OneTimeShutdown()
 	AppSelectionMenu.OneTimeShutdown();
 	TheaterSelectionMenu.OneTimeShutdown();
 	ResumeMovieMenu.OneTimeShutdown();
+
+	LOG( "TextCache: %d hits, %d misses, %d entries", TextCache.GetHits(), TextCache.GetMisses(), TextCache.GetNumEntries() );
+	LOG( "PathCache: %d hits, %d misses, %d directories", Paths.GetHits(), Paths.GetMisses(), Paths.GetNumDirectories() );
+	LOG( "Startup: first frame %3.2f, interactive %3.2f seconds, %d steps awaited",
+			Startup.GetTimeToFirstFrame(), Startup.GetTimeToInteractive(), Startup.GetAwaitedSteps() );
+
+	AsyncLog::Stop();
 }
 
-const char * CinemaApp::RetailDir( const char *dir ) const
+// These return by value so loader threads can build paths at the same time.
+String CinemaApp::RetailDir( const char *dir ) const
 {
-	static char subDir[ 256 ];
-	StringUtils::SPrintf( subDir, "%s/%s", SDCardDir( "RetailMedia" ), dir );
+	String subDir = SDCardDir( "RetailMedia" );
+	subDir.AppendString( "/" );
+	subDir.AppendString( dir );
 	return subDir;
 }
 
-const char * CinemaApp::ExternalRetailDir( const char *dir ) const
+String CinemaApp::ExternalRetailDir( const char *dir ) const
 {
-	static char subDir[ 256 ];
-	StringUtils::SPrintf( subDir, "%s/%s", ExternalSDCardDir( "RetailMedia" ), dir );
+	String subDir = ExternalSDCardDir( "RetailMedia" );
+	subDir.AppendString( "/" );
+	subDir.AppendString( dir );
 	return subDir;
 }
 
-const char * CinemaApp::SDCardDir( const char *dir ) const
+String CinemaApp::SDCardDir( const char *dir ) const
 {
-	static char subDir[ 256 ];
-	StringUtils::SPrintf( subDir, "/sdcard/%s", dir );
+	String subDir = "/sdcard/";
+	subDir.AppendString( dir );
 	return subDir;
 }
 
-const char * CinemaApp::ExternalSDCardDir( const char *dir ) const
+String CinemaApp::ExternalSDCardDir( const char *dir ) const
 {
-	static char subDir[ 256 ];
-	StringUtils::SPrintf( subDir, "/storage/extSdCard/%s", dir );
+	String subDir = "/storage/extSdCard/";
+	subDir.AppendString( dir );
 	return subDir;
 }
 
-const char * CinemaApp::ExternalCacheDir( const char *dir ) const
+String CinemaApp::ExternalCacheDir( const char *dir ) const
 {
-	static char subDir[ 256 ];
-	StringUtils::SPrintf( subDir, "%s/%s", Native::GetExternalCacheDirectory( app ).ToCStr(), dir );
+	String subDir = CacheDirectory;
+	subDir.AppendString( "/" );
+	subDir.AppendString( dir );
 	return subDir;
 }
 
 bool CinemaApp::IsExternalSDCardDir( const char *dir ) const
 {
-	const char * sdcardDir = ExternalSDCardDir( "" );
-	const int l = strlen( sdcardDir );
-	return ( 0 == strncmp( sdcardDir, dir, l ) );
+	const String sdcardDir = ExternalSDCardDir( "" );
+	return ( 0 == strncmp( sdcardDir.ToCStr(), dir, sdcardDir.GetSize() ) );
 }
 
-bool CinemaApp::FileExists( const char *filename ) const
+// answered from the cached directory listing, see PathCache
+bool CinemaApp::FileExists( const char *filename )
 {
-	FILE *f = fopen( filename, "r" );
-	if ( !f )
-	{
-		return false;
-	}
-	else
-	{
-		fclose( f );
-		return true;
-	}
+	return Paths.FileExists( filename );
 }
 
 void CinemaApp::SetPlaylist( const Array<const PcDef *> &playList, const int nextMovie )
@@ -229,6 +316,7 @@ void CinemaApp::SetPc( const PcDef *pc )
 
 void CinemaApp::MovieLoaded( const int width, const int height, const int duration )
 {
+	AwaitStartup( STARTUP_MOVIE_PLAYER );
 	MoviePlayer.MovieLoaded( width, height, duration );
 }
 
@@ -282,6 +370,7 @@ void CinemaApp::StartMoviePlayback(int width, int height, int fps, bool hostAudi
 {
 	if ( CurrentMovie != NULL )
 	{
+		StartClockBurst( CLOCK_BURST_STREAM_START );
 		MovieFinishedPlaying = false;
 		bool remote = CurrentPc->isRemote;
 		Native::StartMovie( app, CurrentPc->UUID.ToCStr(), CurrentMovie->Name.ToCStr(), CurrentMovie->Id, CurrentPc->Binding.ToCStr(), width, height, fps, hostAudio, customBitrate, remote );
@@ -292,6 +381,7 @@ void CinemaApp::StartMoviePlayback(int width, int height, int fps, bool hostAudi
 void CinemaApp::ResumeMovieFromSavedLocation()
 {
 	LOG( "ResumeMovie");
+	AwaitStartup( STARTUP_MOVIE_PLAYER );
 	InLobby = false;
 	ShouldResumeMovie = true;
 	ViewMgr.OpenView( MoviePlayer );
@@ -300,6 +390,7 @@ void CinemaApp::ResumeMovieFromSavedLocation()
 void CinemaApp::PlayMovieFromBeginning()
 {
 	LOG( "PlayMovieFromBeginning");
+	AwaitStartup( STARTUP_MOVIE_PLAYER );
 	InLobby = false;
 	ShouldResumeMovie = false;
 	ViewMgr.OpenView( MoviePlayer );
@@ -328,6 +419,7 @@ void CinemaApp::UnableToPlayMovie()
 
 void CinemaApp::TheaterSelection()
 {
+	AwaitStartup( STARTUP_THEATER_SELECTION );
 	ViewMgr.OpenView( TheaterSelectionMenu );
 }
 
@@ -387,23 +479,112 @@ void CinemaApp::Command( const char * msg )
 	}
 }
 
-Matrix4f CinemaApp::Frame( const VrFrame & vrFrame )
+#if defined( STREAMTHEATER_TRACE )
+static const double TRACE_DUMP_SECONDS = 10.0;
+
+static void DumpTrace( App * app )
+{
+	String	outPath;
+	if ( !app->GetStoragePaths().GetPathIfValidPermission(
+			EST_PRIMARY_EXTERNAL_STORAGE, EFT_FILES, "", W_OK | R_OK, outPath ) )
+	{
+		LOG( "DumpTrace: no writable files directory" );
+		return;
+	}
+
+	outPath += "trace.json";
+	if ( TraceRecorder::WriteChromeTrace( outPath.ToCStr(), TRACE_DUMP_SECONDS ) )
+	{
+		app->CreateToast( "Trace written to %s", outPath.ToCStr() );
+	}
+}
+#endif
+
+// The head pose isn't part of a SessionFrame and stays live during a replay.
+static SessionFrame ToSessionFrame( const VrFrame & vrFrame )
+{
+	SessionFrame frame;
+	frame.DeltaSeconds = vrFrame.DeltaSeconds;
+	frame.PredictedDisplayTimeInSeconds = vrFrame.PredictedDisplayTimeInSeconds;
+	frame.Throttled = vrFrame.DeviceStatus.PowerLevelStateThrottled;
+	frame.ButtonState = vrFrame.Input.buttonState;
+	frame.ButtonPressed = vrFrame.Input.buttonPressed;
+	frame.ButtonReleased = vrFrame.Input.buttonReleased;
+	for ( int i = 0; i < 2; i++ )
+	{
+		frame.Sticks[i][0] = vrFrame.Input.sticks[i][0];
+		frame.Sticks[i][1] = vrFrame.Input.sticks[i][1];
+	}
+	frame.TouchRelative[0] = vrFrame.Input.touchRelative.x;
+	frame.TouchRelative[1] = vrFrame.Input.touchRelative.y;
+	frame.SwipeFraction = vrFrame.Input.swipeFraction;
+	return frame;
+}
+
+static void FromSessionFrame( const SessionFrame & frame, VrFrame & vrFrame )
+{
+	vrFrame.DeltaSeconds = frame.DeltaSeconds;
+	vrFrame.PredictedDisplayTimeInSeconds = frame.PredictedDisplayTimeInSeconds;
+	vrFrame.DeviceStatus.PowerLevelStateThrottled = frame.Throttled;
+	vrFrame.Input.buttonState = frame.ButtonState;
+	vrFrame.Input.buttonPressed = frame.ButtonPressed;
+	vrFrame.Input.buttonReleased = frame.ButtonReleased;
+	for ( int i = 0; i < 2; i++ )
+	{
+		vrFrame.Input.sticks[i][0] = frame.Sticks[i][0];
+		vrFrame.Input.sticks[i][1] = frame.Sticks[i][1];
+	}
+	vrFrame.Input.touchRelative.x = frame.TouchRelative[0];
+	vrFrame.Input.touchRelative.y = frame.TouchRelative[1];
+	vrFrame.Input.swipeFraction = frame.SwipeFraction;
+}
+
+Matrix4f CinemaApp::Frame( const VrFrame & liveFrame )
 {
+	TRACE_SCOPE( "CinemaApp::Frame" );
+
+	const double frameStart = vrapi_GetTimeInSeconds();
+
+	// a replay swaps in the recorded frame and delivers the recorded callbacks first
+	VrFrame vrFrame = liveFrame;
+	if ( Session.IsReplaying() )
+	{
+		ReplaySessionEvents( vrFrame );
+	}
+	else if ( Session.IsRecording() )
+	{
+		Session.SetFrame( FrameCount );
+		Session.RecordFrame( ToSessionFrame( vrFrame ) );
+	}
+
 	// Reset any VR menu submissions from previous frame.
 	GuiSys->BeginFrame();
 
 	// Process incoming messages until the queue is empty.
-	for ( ; ; )
 	{
-		const char * msg = MessageQueue.GetNextMessage();
-		if ( msg == NULL )
+		TRACE_SCOPE( "CinemaApp::Messages" );
+		for ( ; ; )
 		{
-			break;
+			const char * msg = MessageQueue.GetNextMessage();
+			if ( msg == NULL )
+			{
+				break;
+			}
+			Session.RecordCommand( msg );
+			Command( msg );
+			free( (void *)msg );
 		}
-		Command( msg );
-		free( (void *)msg );
 	}
 
+#if defined( STREAMTHEATER_TRACE )
+	// both stick clicks together write out the last few seconds of the timeline
+	const int traceButtons = BUTTON_THUMBL | BUTTON_THUMBR;
+	if ( ( vrFrame.Input.buttonPressed & traceButtons ) && ( vrFrame.Input.buttonState & traceButtons ) == traceButtons )
+	{
+		DumpTrace( app );
+	}
+#endif
+
 	if(DelayedError != NULL && !ViewMgr.ChangingViews())
 	{
 		ShowError(*DelayedError);
@@ -411,23 +592,388 @@ Matrix4f CinemaApp::Frame( const VrFrame & vrFrame )
 		DelayedError = NULL;
 	}
 
+	if ( FrameCount == 0 )
+	{
+		Startup.FirstFrame( vrapi_GetTimeInSeconds() );
+	}
+
 	FrameCount++;
 	this->vrFrame = vrFrame;
 
+	Paths.Revalidate( frameStart );
+
+	{
+		TRACE_SCOPE( "CinemaApp::TaskCompletions" );
+		Tasks.RunCompletions( TASK_COMPLETION_BUDGET );
+	}
+	AppMgr.ApplyAppLists();
+
+	// one startup step per frame once the lobby is showing, never during a view transition
+	if ( FrameCount > 1 && !Startup.IsComplete() && !ViewMgr.ChangingViews() )
+	{
+		const StartupStage stage = Startup.NextStage();
+		if ( stage != STARTUP_STAGE_COUNT )
+		{
+			RunStartupStep( stage, false );
+		}
+	}
+
 	CenterViewMatrix = ViewMgr.Frame( vrFrame );
 
+	EyeBufferSample frameSample;
+	const bool newSample = UpdateEyeBuffers( frameSample );
+	UpdateClocks( newSample ? &frameSample : NULL );
+
+	// one submenu per frame, and never while streaming, so the build doesn't cause a hitch
+	if ( PrebuildPlayerMenus && !PlayerMenusPrebuilt && Startup.IsReady( STARTUP_MOVIE_PLAYER ) && !ViewMgr.ChangingViews() &&
+			ViewMgr.GetCurrentView() != &MoviePlayer && vrapi_GetTimeInSeconds() - StartTime > MENU_PREBUILD_DELAY )
+	{
+		const double start = vrapi_GetTimeInSeconds();
+		PlayerMenusPrebuilt = !MoviePlayer.PrebuildNextMenu();
+		PlayerMenuPrebuildSeconds += vrapi_GetTimeInSeconds() - start;
+		if ( PlayerMenusPrebuilt )
+		{
+			LOG( "Player menus prebuilt: %3.3f seconds", PlayerMenuPrebuildSeconds );
+		}
+	}
+
+	Hud.Frame( vrFrame, (float)( vrapi_GetTimeInSeconds() - frameStart ) );
+
 	// update gui systems after the app frame, but before rendering anything
-	GuiSys->Frame( vrFrame, CenterViewMatrix );
+	{
+		TRACE_SCOPE( "GuiSys::Frame" );
+		GuiSys->Frame( vrFrame, CenterViewMatrix );
+	}
+
+	if ( Session.IsReplaying() )
+	{
+		ReplayCpuSeconds += vrapi_GetTimeInSeconds() - frameStart;
+	}
 
 	return CenterViewMatrix;
 }
 
+// Each step does one piece on the GL thread.  For the theaters that is the
+// upload of one of them, their files are read and the sdcard scanned in
+// between on the workers, so a step can also be a frame of waiting that
+// costs nothing.  The menus are built whole and can take longer than a
+// frame.  Returns true once the stage is ready.
+bool CinemaApp::RunStartupStep( const StartupStage stage, const bool awaited )
+{
+	TRACE_SCOPE( "CinemaApp::RunStartupStep" );
+
+	const double start = vrapi_GetTimeInSeconds();
+	bool finished = true;
+	switch ( stage )
+	{
+		case STARTUP_SHADER_VARIANTS:
+			ShaderMgr.LoadVariants();
+			break;
+
+		case STARTUP_THEATERS:
+			StartClockBurst( CLOCK_BURST_SCENE_LOAD );
+			finished = ModelMgr.LoadNextTheater( awaited );
+			break;
+
+		case STARTUP_THEATER_SELECTION:
+			TheaterSelectionMenu.OneTimeInit( LaunchIntent.ToCStr() );
+			ViewMgr.AddView( &TheaterSelectionMenu );
+			break;
+
+		case STARTUP_MOVIE_PLAYER:
+			MoviePlayer.OneTimeInit( LaunchIntent.ToCStr() );
+			ViewMgr.AddView( &MoviePlayer );
+			break;
+
+		case STARTUP_RESUME_MENU:
+			ResumeMovieMenu.OneTimeInit( LaunchIntent.ToCStr() );
+			break;
+
+		default:
+			return true;
+	}
+
+	const double now = vrapi_GetTimeInSeconds();
+	Startup.StepDone( stage, finished, awaited, now - start, now );
+	return finished;
+}
+
+// Runs whatever of the stage and its dependencies hasn't run yet, right
+// now.  Costs nothing once the stage is ready.
+void CinemaApp::AwaitStartup( const StartupStage stage )
+{
+	for ( StartupStage next = Startup.NextStageFor( stage ); next != STARTUP_STAGE_COUNT; next = Startup.NextStageFor( stage ) )
+	{
+		LOG( "Startup: waiting for %s", StartupSequence::GetStageName( next ) );
+		RunStartupStep( next, true );
+	}
+}
+
+// Each view in each scene keeps its own eye buffer level, the scenes cost
+// very different amounts to draw.
+int CinemaApp::EyeBufferContext() const
+{
+	static const int SCENE_SLOTS = EyeBufferGovernor::MAX_CONTEXTS / 8;
+
+	const View * view = ViewMgr.GetCurrentView();
+	int viewSlot = 0;
+	if ( view == &PcSelectionMenu )				viewSlot = 1;
+	else if ( view == &AppSelectionMenu )		viewSlot = 2;
+	else if ( view == &TheaterSelectionMenu )	viewSlot = 3;
+	else if ( view == &ResumeMovieMenu )		viewSlot = 4;
+
+	const ModelFile * model = SceneMgr.SceneInfo.SceneModel;
+	int sceneSlot = 0;
+	if ( ModelMgr.BoxOffice != NULL && model == ModelMgr.BoxOffice->SceneModel )
+	{
+		sceneSlot = 1;
+	}
+	else if ( ModelMgr.VoidScene != NULL && model == ModelMgr.VoidScene->SceneModel )
+	{
+		sceneSlot = 2;
+	}
+	else
+	{
+		for ( UPInt i = 0; i < ModelMgr.Theaters.GetSize(); i++ )
+		{
+			if ( model == ModelMgr.Theaters[i]->SceneModel )
+			{
+				sceneSlot = Alg::Min( 3 + (int)i, SCENE_SLOTS - 1 );
+				break;
+			}
+		}
+	}
+
+	return viewSlot * SCENE_SLOTS + sceneSlot;
+}
+
+// The eye buffers are only set again when the level changes, setting them
+// reallocates the buffers.  Returns true with the frame times of the
+// window that just finished.
+bool CinemaApp::UpdateEyeBuffers( EyeBufferSample & sample )
+{
+	const double now = vrapi_GetTimeInSeconds();
+	if ( EyeBuffers.SetContext( EyeBufferContext(), EyeBufferCeiling, now ) )
+	{
+		EyeBufferWindow.Reset( now );
+	}
+
+	EyeBufferWindow.AddFrame( vrFrame.DeltaSeconds, EyeTimer.GetLastMs() );
+	const bool newSample = EyeBufferWindow.GetSample( now, sample );
+	if ( newSample && EyeBuffers.Evaluate( sample, now ) )
+	{
+		LOG( "CinemaApp: eye buffers %s, gpu %.1f ms, %.0f%% frames missed",
+				EyeBuffers.GetStateName(), sample.GpuMs, sample.MissedFrameFraction * 100.0f );
+	}
+
+	const EyeBufferLevel & level = EyeBuffers.GetLevel();
+	ovrEyeBufferParms eyeBufferParms = app->GetEyeBufferParms();
+	if ( eyeBufferParms.multisamples != level.Multisamples || eyeBufferParms.resolution != level.Resolution )
+	{
+		LOG( "CinemaApp: eye buffers %ix MSAA at %i for context %i", level.Multisamples, level.Resolution, EyeBuffers.GetContext() );
+		eyeBufferParms.multisamples = level.Multisamples;
+		eyeBufferParms.resolution = level.Resolution;
+		app->SetEyeBufferParms( eyeBufferParms );
+	}
+	return newSample;
+}
+
+void CinemaApp::StartClockBurst( const ClockBurst burst )
+{
+	Clocks.Burst( burst, vrapi_GetTimeInSeconds() );
+}
+
+// Every change of the clock levels is logged with the reason for it.
+void CinemaApp::UpdateClocks( const EyeBufferSample * window )
+{
+	ClockSample sample;
+	if ( window != NULL )
+	{
+		sample.GpuMs = window->GpuMs;
+		sample.MissedFrameFraction = window->MissedFrameFraction;
+	}
+
+	const bool throttled = vrFrame.DeviceStatus.PowerLevelStateThrottled;
+	if ( !Clocks.Update( window != NULL ? &sample : NULL, SceneMgr.ContentStatic, throttled, vrapi_GetTimeInSeconds() ) )
+	{
+		return;
+	}
+
+	const ClockLevels & levels = Clocks.GetLevels();
+	LOG( "CinemaApp: clocks cpu %i gpu %i, %s", levels.Cpu, levels.Gpu, Clocks.GetReason() );
+
+	ovrModeParms modeParms = app->GetVrModeParms();
+	modeParms.CpuLevel = levels.Cpu;
+	modeParms.GpuLevel = levels.Gpu;
+	app->SetVrModeParms( modeParms );
+
+	CpuLevel = levels.Cpu;
+	GpuLevel = levels.Gpu;
+}
+
+// A "record_session" file in the app's files directory records this run to
+// session.bin, a "replay_session" file plays session.bin back instead of
+// live input and writes the per frame CPU times to session_replay.txt.
+void CinemaApp::StartSession()
+{
+	String	outPath;
+	if ( !app->GetStoragePaths().GetPathIfValidPermission(
+			EST_PRIMARY_EXTERNAL_STORAGE, EFT_FILES, "", W_OK | R_OK, outPath ) )
+	{
+		return;
+	}
+
+	const String sessionPath = outPath + "session.bin";
+	if ( FileExists( outPath + "replay_session" ) )
+	{
+		if ( Session.StartReplay( sessionPath.ToCStr() ) )
+		{
+			ReplayFrameTimes.Clear();
+			ReplayCpuSeconds = 0.0;
+			app->CreateToast( "Replaying session" );
+		}
+	}
+	else if ( FileExists( outPath + "record_session" ) )
+	{
+		Session.StartRecording( sessionPath.ToCStr() );
+	}
+}
+
+void CinemaApp::ReplaySessionEvents( VrFrame & frame )
+{
+	TRACE_SCOPE( "CinemaApp::ReplaySessionEvents" );
+
+	if ( FrameCount > 0 )
+	{
+		ReplayFrameTimes.PushBack( (float)( ReplayCpuSeconds * 1000.0 ) );
+	}
+	ReplayCpuSeconds = 0.0;
+
+	ReplayingFrame = &frame;
+	Session.ReplayEvents( FrameCount, *this );
+	ReplayingFrame = NULL;
+
+	if ( Session.IsReplayFinished() )
+	{
+		FinishReplay();
+	}
+}
+
+void CinemaApp::ReplayFrame( const SessionFrame & frame )
+{
+	FromSessionFrame( frame, *ReplayingFrame );
+}
+
+void CinemaApp::ReplayCommand( const char * command )
+{
+	if ( strncmp( command, "newVideo ", 9 ) == 0 )
+	{
+		// the recorded reply queue is long gone, give the scene one that lives here
+		char localCommand[64];
+		snprintf( localCommand, sizeof( localCommand ), "newVideo %p", &ReplayVideoQueue );
+		Command( localCommand );
+		free( (void *)ReplayVideoQueue.GetNextMessage() );
+	}
+	else
+	{
+		Command( command );
+	}
+}
+
+void CinemaApp::ReplayAddPc( const String & name, const String & uuid, const int pairState, const int reachability,
+		const String & binding, const bool isRunning )
+{
+	PcMgr.AddPc( name, uuid, (Native::PairState)pairState, (Native::Reachability)reachability, binding, isRunning );
+}
+
+void CinemaApp::ReplayRemovePc( const String & name )
+{
+	PcMgr.RemovePc( name );
+}
+
+void CinemaApp::ReplayAddApp( const String & name, const String & posterFileName, const int id, const bool isRunning )
+{
+	AppMgr.AddApp( name, posterFileName, id, isRunning );
+}
+
+void CinemaApp::ReplayRemoveApp( const int id )
+{
+	AppMgr.RemoveApp( id );
+}
+
+void CinemaApp::ReplayShowPair( const String & message )
+{
+	ShowPair( message );
+}
+
+void CinemaApp::ReplayPairSuccess()
+{
+	PairSuccess();
+}
+
+void CinemaApp::ReplayShowError( const String & message )
+{
+	ShowError( message );
+}
+
+void CinemaApp::ReplayClearError()
+{
+	ClearError();
+}
+
+void CinemaApp::ReplayStreamFrame()
+{
+	SceneMgr.ReplayStreamFrame = true;
+}
+
+void CinemaApp::FinishReplay()
+{
+	Session.StopReplay();
+
+	const SessionFrameTimes times = SummarizeFrameTimes( ReplayFrameTimes );
+	if ( times.Count == 0 )
+	{
+		return;
+	}
+
+	LOG( "Replay: %i frames, mean %.2f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms", times.Count, times.Mean, times.P50, times.P99, times.Max );
+	app->CreateToast( "Replay: p50 %.2f ms, p99 %.2f ms, max %.2f ms", times.P50, times.P99, times.Max );
+
+	String	outPath;
+	if ( app->GetStoragePaths().GetPathIfValidPermission(
+			EST_PRIMARY_EXTERNAL_STORAGE, EFT_FILES, "", W_OK | R_OK, outPath ) )
+	{
+		outPath += "session_replay.txt";
+		WriteFrameTimes( outPath.ToCStr(), ReplayFrameTimes );
+	}
+}
+
 Matrix4f CinemaApp::DrawEyeView( const int eye, const float fovDegrees )
 {
+	TRACE_SCOPE( eye == 0 ? "CinemaApp::DrawEyeView left" : "CinemaApp::DrawEyeView right" );
+
+	const double drawStart = vrapi_GetTimeInSeconds();
+
+	if ( eye == 0 )
+	{
+		EyeTimer.Begin();
+	}
+
 	Matrix4f mvpForEye = ViewMgr.DrawEyeView( eye, fovDegrees );
 
 	GuiSys->RenderEyeView( CenterViewMatrix, mvpForEye );
 
+	if ( eye == 1 )
+	{
+		EyeTimer.End();
+		Latency.FrameSubmitted( vrapi_GetTimeInSeconds() );
+	}
+
+	if ( Session.IsReplaying() )
+	{
+		ReplayCpuSeconds += vrapi_GetTimeInSeconds() - drawStart;
+	}
+
 	return mvpForEye;
 }
 
@@ -26,12 +26,22 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "AppSelectionView.h"
 #include "TheaterSelectionView.h"
 #include "ResumeMovieView.h"
+#include "UI/UITextCache.h"
+#include "LatencyProbes.h"
+#include "PerfHud.h"
+#include "SessionLog.h"
+#include "GpuTimer.h"
+#include "EyeBufferGovernor.h"
+#include "ClockGovernor.h"
+#include "PathCache.h"
+#include "TaskScheduler.h"
+#include "StartupSequence.h"
 
 using namespace OVR;
 
 namespace VRMatterStreamTheater {
 
-class CinemaApp : public OVR::VrAppInterface
+class CinemaApp : public OVR::VrAppInterface, public SessionReplayTarget
 {
 public:
 							CinemaApp();
@@ -54,6 +64,7 @@ public:
 
 	const PcDef *			GetCurrentMovie() const { return CurrentMovie; }
 	const PcDef *			GetCurrentPc() const { return CurrentPc; }
+	const Array<const PcDef *> & GetPlaylist() const { return PlayList; }
 	const PcDef *			GetNextMovie() const;
 	const PcDef *			GetPreviousMovie() const;
 
@@ -72,13 +83,13 @@ public:
 	bool 					AllowTheaterSelection() const;
 	bool 					IsMovieFinished() const;
 
-	const char *			RetailDir( const char *dir ) const;
-	const char *			ExternalRetailDir( const char *dir ) const;
-	const char *			SDCardDir( const char *dir ) const;
-	const char * 			ExternalSDCardDir( const char *dir ) const;
-	const char * 			ExternalCacheDir( const char *dir ) const;
+	String					RetailDir( const char *dir ) const;
+	String					ExternalRetailDir( const char *dir ) const;
+	String					SDCardDir( const char *dir ) const;
+	String		 			ExternalSDCardDir( const char *dir ) const;
+	String		 			ExternalCacheDir( const char *dir ) const;
 	bool 					IsExternalSDCardDir( const char *dir ) const;
-	bool 					FileExists( const char *filename ) const;
+	bool 					FileExists( const char *filename );
 
 	void					ShowPair( const String& msg );
 	void					PairSuccess();
@@ -87,6 +98,13 @@ public:
 
 	void					MovieScreenUpdated();
 
+	// the best eye buffers the current view wants, the governor may go lower.
+	// Views call this every frame, nothing is reallocated unless the level changes.
+	void					SetEyeBufferCeiling( const EyeBufferLevel & ceiling ) { EyeBufferCeiling = ceiling; }
+
+	// raises the clocks for work that is about to start
+	void					StartClockBurst( const ClockBurst burst );
+
 public:
 	OvrGuiSys *				GuiSys;
 	double					StartTime;
@@ -99,6 +117,20 @@ public:
 	PcManager 				PcMgr;
 	AppManager				AppMgr;
 
+	UITextCache				TextCache;
+	PathCache				Paths;			// search roots are external retail, retail, then the sdcard
+	TaskScheduler			Tasks;			// completions are finished in Frame
+	LatencyProbes			Latency;
+	PerfHud					Hud;
+	SessionLog				Session;
+
+	int						CpuLevel;		// clock levels in use, see UpdateClocks
+	int						GpuLevel;
+	ClockGovernor			Clocks;
+
+	GpuTimer				EyeTimer;		// both eyes, shown by the PerfHud
+	EyeBufferGovernor		EyeBuffers;
+
 	bool					InLobby;
 	bool					AllowDebugControls;
 
@@ -126,8 +158,55 @@ private:
 
 	OVR::String*			DelayedError;
 
+	String					CacheDirectory;	// looked up once, it's a JNI call
+
+	// what OneTimeInit left for later, see RunStartupStep
+	String					LaunchIntent;
+	StartupSequence			Startup;
+
+	// Build the movie player's submenus on idle frames once the lobby has
+	// settled, instead of on their first open.  Each build logs its time
+	// either way, and the total of the prebuild is logged when it's done.
+	bool					PrebuildPlayerMenus;	// saved as PrebuildPlayerMenus
+	bool					PlayerMenusPrebuilt;
+	double					PlayerMenuPrebuildSeconds;
+
+	EyeBufferLevel			EyeBufferCeiling;
+	EyeBufferStats			EyeBufferWindow;
+
+	// session replay, see StartSession
+	ovrMessageQueue			ReplayVideoQueue;
+	Array<float>			ReplayFrameTimes;
+	double					ReplayCpuSeconds;
+	VrFrame *				ReplayingFrame;		// the frame the recorded one goes into
+
 private:
 	void 					Command( const char * msg );
+
+	bool					UpdateEyeBuffers( EyeBufferSample & sample );
+	void					UpdateClocks( const EyeBufferSample * window );
+	int						EyeBufferContext() const;
+
+	bool					RunStartupStep( const StartupStage stage, const bool awaited );
+	void					AwaitStartup( const StartupStage stage );
+
+	void					StartSession();
+	void					ReplaySessionEvents( VrFrame & frame );
+	void					FinishReplay();
+
+	// SessionReplayTarget
+	virtual void			ReplayFrame( const SessionFrame & frame );
+	virtual void			ReplayCommand( const char * command );
+	virtual void			ReplayAddPc( const String & name, const String & uuid, const int pairState, const int reachability,
+									const String & binding, const bool isRunning );
+	virtual void			ReplayRemovePc( const String & name );
+	virtual void			ReplayAddApp( const String & name, const String & posterFileName, const int id, const bool isRunning );
+	virtual void			ReplayRemoveApp( const int id );
+	virtual void			ReplayShowPair( const String & message );
+	virtual void			ReplayPairSuccess();
+	virtual void			ReplayShowError( const String & message );
+	virtual void			ReplayClearError();
+	virtual void			ReplayStreamFrame();
 };
 
 } // namespace VRMatterStreamTheater
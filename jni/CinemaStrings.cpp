@@ -17,6 +17,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "VrLocale.h"
 #include "CinemaApp.h"
 #include "BitmapFont.h"
+#include "TraceRecorder.h"
 
 namespace VRMatterStreamTheater
 {
@@ -43,6 +44,10 @@ String CinemaStrings::Error_NoApps;
 String CinemaStrings::Error_UnableToPlayMovie;
 
 String CinemaStrings::MoviePlayer_Reorient;
+String CinemaStrings::MoviePlayer_CalibrateLook;
+String CinemaStrings::MoviePlayer_CalibrateDone;
+String CinemaStrings::MoviePlayer_CalibrateFailed;
+String CinemaStrings::MoviePlayer_CalibrateCanceled;
 
 String CinemaStrings::ButtonText_ButtonSaveApp;
 String CinemaStrings::ButtonText_ButtonSaveDefault;
@@ -62,6 +67,9 @@ String CinemaStrings::ButtonText_Button60FPS;
 String CinemaStrings::ButtonText_Button30FPS;
 String CinemaStrings::ButtonText_ButtonHostAudio;
 String CinemaStrings::ButtonText_ButtonApply;
+String CinemaStrings::ButtonText_ButtonAdaptive;
+String CinemaStrings::ButtonText_ButtonCalibrate;
+String CinemaStrings::ButtonText_ButtonPerfHud;
 String CinemaStrings::ButtonText_ButtonBitrate;
 String CinemaStrings::ButtonText_ButtonDistance;
 String CinemaStrings::ButtonText_ButtonSize;
@@ -69,6 +77,7 @@ String CinemaStrings::ButtonText_ButtonSBSOff;
 String CinemaStrings::ButtonText_ButtonSBSRift;
 String CinemaStrings::ButtonText_ButtonSBSCrop;
 String CinemaStrings::ButtonText_ButtonSBSScale;
+String CinemaStrings::ButtonText_ButtonSBSAuto;
 String CinemaStrings::ButtonText_ButtonChangeSeat;
 String CinemaStrings::ButtonText_ButtonGaze;
 String CinemaStrings::ButtonText_ButtonTrackpad;
@@ -91,6 +100,7 @@ String CinemaStrings::Error_AddPCFailed;
 void CinemaStrings::OneTimeInit( CinemaApp &cinema )
 {
 	LOG( "CinemaStrings::OneTimeInit" );
+	TRACE_SCOPE( "CinemaStrings::OneTimeInit" );
 
 	App *app = cinema.app;
 
@@ -115,6 +125,10 @@ void CinemaStrings::OneTimeInit( CinemaApp &cinema )
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/Error_UnableToPlayMovie", 	"@string/Error_UnableToPlayMovie",	Error_UnableToPlayMovie );
 
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/MoviePlayer_Reorient", 	"@string/MoviePlayer_Reorient", 	MoviePlayer_Reorient );
+	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/MoviePlayer_CalibrateLook", 	"@string/MoviePlayer_CalibrateLook", 	MoviePlayer_CalibrateLook );
+	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/MoviePlayer_CalibrateDone", 	"@string/MoviePlayer_CalibrateDone", 	MoviePlayer_CalibrateDone );
+	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/MoviePlayer_CalibrateFailed", 	"@string/MoviePlayer_CalibrateFailed", 	MoviePlayer_CalibrateFailed );
+	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/MoviePlayer_CalibrateCanceled", 	"@string/MoviePlayer_CalibrateCanceled", 	MoviePlayer_CalibrateCanceled );
 
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonSaveApp", 		"@string/ButtonText_ButtonSaveApp", 		ButtonText_ButtonSaveApp );
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonSaveDefault", 	"@string/ButtonText_ButtonSaveDefault", 	ButtonText_ButtonSaveDefault );
@@ -131,6 +145,9 @@ void CinemaStrings::OneTimeInit( CinemaApp &cinema )
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonComfortMode", "@string/ButtonText_ButtonComfortMode", 	ButtonText_ButtonComfortMode );
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonHostAudio", 	"@string/ButtonText_ButtonHostAudio", 		ButtonText_ButtonHostAudio );
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonApply", 		"@string/ButtonText_ButtonApply", 			ButtonText_ButtonApply );
+	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonAdaptive", 	"@string/ButtonText_ButtonAdaptive", 		ButtonText_ButtonAdaptive );
+	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonCalibrate", 	"@string/ButtonText_ButtonCalibrate", 		ButtonText_ButtonCalibrate );
+	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonPerfHud", 	"@string/ButtonText_ButtonPerfHud", 		ButtonText_ButtonPerfHud );
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonBitrate", 	"@string/ButtonText_ButtonBitrate", 		ButtonText_ButtonBitrate );
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_Button1080", 		"@string/ButtonText_Button1080", 			ButtonText_Button1080 );
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_Button720",	 		"@string/ButtonText_Button720",				ButtonText_Button720 );
@@ -142,6 +159,7 @@ void CinemaStrings::OneTimeInit( CinemaApp &cinema )
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonSBSRift",		"@string/ButtonText_ButtonSBSRift",			ButtonText_ButtonSBSRift );
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonSBSCrop",		"@string/ButtonText_ButtonSBSCrop",			ButtonText_ButtonSBSCrop );
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonSBSScale",	"@string/ButtonText_ButtonSBSScale",		ButtonText_ButtonSBSScale );
+	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonSBSAuto",		"@string/ButtonText_ButtonSBSAuto",			ButtonText_ButtonSBSAuto );
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonChangeSeat", 	"@string/ButtonText_ButtonChangeSeat", 		ButtonText_ButtonChangeSeat );
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonGaze",	 	"@string/ButtonText_ButtonGaze", 			ButtonText_ButtonGaze );
 	VrLocale::GetString( app->GetVrJni(), app->GetJavaObject(), "@string/ButtonText_ButtonTrackpad", 	"@string/ButtonText_ButtonTrackpad", 		ButtonText_ButtonTrackpad );
@@ -51,6 +51,10 @@ public:
 	static String	Error_UnableToPlayMovie;
 
 	static String	MoviePlayer_Reorient;
+	static String	MoviePlayer_CalibrateLook;
+	static String	MoviePlayer_CalibrateDone;
+	static String	MoviePlayer_CalibrateFailed;
+	static String	MoviePlayer_CalibrateCanceled;
 
 	static String	ButtonText_ButtonSaveApp;
 	static String	ButtonText_ButtonSaveDefault;
@@ -68,6 +72,9 @@ public:
 	static String	ButtonText_ButtonHostAudio;
 	static String	ButtonText_ButtonBitrate;
 	static String	ButtonText_ButtonApply;
+	static String	ButtonText_ButtonAdaptive;
+	static String	ButtonText_ButtonCalibrate;
+	static String	ButtonText_ButtonPerfHud;
 	static String	ButtonText_Button720;
 	static String	ButtonText_Button60FPS;
 	static String	ButtonText_ButtonDistance;
@@ -76,6 +83,7 @@ public:
 	static String	ButtonText_ButtonSBSRift;
 	static String	ButtonText_ButtonSBSCrop;
 	static String	ButtonText_ButtonSBSScale;
+	static String	ButtonText_ButtonSBSAuto;
 	static String	ButtonText_ButtonChangeSeat;
 	static String	ButtonText_ButtonGaze;
 	static String	ButtonText_ButtonTrackpad;
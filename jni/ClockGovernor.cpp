@@ -0,0 +1,233 @@
+/************************************************************************************
+
+Filename    :   ClockGovernor.cpp
+Content     :	Raises the CPU and GPU clock levels for bursts of work and lowers them when there is headroom
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ClockGovernor.h"
+
+namespace VRMatterStreamTheater {
+
+struct ClockBurstDef
+{
+	const char *	Name;
+	int				Cpu;
+	int				Gpu;
+	double			Seconds;	// from the last time it was started
+};
+
+static const ClockBurstDef BURSTS[CLOCK_BURST_COUNT] =
+{
+	{ "scene load",		3, 2, 2.0 },
+	{ "posters",		2, 0, 1.0 },
+	{ "stream start",	3, 3, 3.0 }
+};
+
+static const ClockLevels	THROTTLED_CAP( 1, 1 );
+
+// A window is bad if either of these is exceeded...
+static const float	BAD_MISSED_FRACTION		= 0.05f;
+static const float	BUSY_GPU_MS				= 11.0f;	// below where the eye buffers start to step down
+
+// ...and has headroom if both are met.
+static const float	GOOD_MISSED_FRACTION	= 0.01f;
+static const float	IDLE_GPU_MS				= 7.0f;
+
+static const int	BAD_WINDOWS_TO_RAISE		= 2;
+static const int	GOOD_WINDOWS_TO_LOWER		= 10;
+static const int	STATIC_WINDOWS_TO_LOWER		= 3;
+static const int	MAX_GOOD_WINDOWS_TO_LOWER	= 80;
+
+// raising this soon after lowering means the lower levels didn't hold
+static const double	FAILED_LOWER_SECONDS	= 20.0;
+
+static int Clamp( const int level )
+{
+	return level < 0 ? 0 : ( level > ClockGovernor::MAX_LEVEL ? ClockGovernor::MAX_LEVEL : level );
+}
+
+ClockGovernor::ClockGovernor() :
+	Steady(),
+	Current(),
+	Pinned( false ),
+	Throttled( false ),
+	BadWindows( 0 ),
+	GoodWindows( 0 ),
+	GoodWindowsNeeded( GOOD_WINDOWS_TO_LOWER ),
+	LastLowerTime( -FAILED_LOWER_SECONDS ),
+	PendingReason( NULL ),
+	Reason( "start" )
+
+{
+	for ( int i = 0; i < CLOCK_BURST_COUNT; i++ )
+	{
+		BurstEnds[i] = 0.0;
+	}
+}
+
+void ClockGovernor::Pin( const ClockLevels & levels )
+{
+	Steady = levels;
+	Current = levels;
+	Pinned = true;
+	Reason = "pinned";
+}
+
+void ClockGovernor::Reset( const ClockLevels & start, const double now )
+{
+	Steady = ClockLevels( Clamp( start.Cpu ), Clamp( start.Gpu ) );
+	Current = Steady;
+	Pinned = false;
+	Throttled = false;
+	BadWindows = 0;
+	GoodWindows = 0;
+	GoodWindowsNeeded = GOOD_WINDOWS_TO_LOWER;
+	LastLowerTime = now - FAILED_LOWER_SECONDS;
+	for ( int i = 0; i < CLOCK_BURST_COUNT; i++ )
+	{
+		BurstEnds[i] = 0.0;
+	}
+	PendingReason = NULL;
+	Reason = "start";
+}
+
+const char * ClockGovernor::GetBurstName( const ClockBurst burst )
+{
+	return ( burst >= 0 && burst < CLOCK_BURST_COUNT ) ? BURSTS[burst].Name : "";
+}
+
+void ClockGovernor::Burst( const ClockBurst burst, const double now )
+{
+	if ( burst < 0 || burst >= CLOCK_BURST_COUNT )
+	{
+		return;
+	}
+	BurstEnds[burst] = now + BURSTS[burst].Seconds;
+	PendingReason = BURSTS[burst].Name;
+}
+
+bool ClockGovernor::Update( const ClockSample * window, const bool contentStatic, const bool throttled, const double now )
+{
+	if ( Pinned )
+	{
+		return false;
+	}
+
+	if ( throttled != Throttled )
+	{
+		Throttled = throttled;
+		PendingReason = throttled ? "throttled" : "throttle lifted";
+	}
+
+	if ( window != NULL )
+	{
+		Evaluate( *window, contentStatic, now );
+	}
+
+	ClockLevels target = Steady;
+	if ( !Throttled )
+	{
+		for ( int i = 0; i < CLOCK_BURST_COUNT; i++ )
+		{
+			if ( now < BurstEnds[i] )
+			{
+				target.Cpu = target.Cpu > BURSTS[i].Cpu ? target.Cpu : BURSTS[i].Cpu;
+				target.Gpu = target.Gpu > BURSTS[i].Gpu ? target.Gpu : BURSTS[i].Gpu;
+			}
+		}
+	}
+	else
+	{
+		target.Cpu = target.Cpu < THROTTLED_CAP.Cpu ? target.Cpu : THROTTLED_CAP.Cpu;
+		target.Gpu = target.Gpu < THROTTLED_CAP.Gpu ? target.Gpu : THROTTLED_CAP.Gpu;
+	}
+
+	if ( target == Current )
+	{
+		return false;
+	}
+
+	Current = target;
+	Reason = ( PendingReason != NULL ) ? PendingReason : "burst over";
+	PendingReason = NULL;
+	return true;
+}
+
+void ClockGovernor::Evaluate( const ClockSample & window, const bool contentStatic, const double now )
+{
+	const bool gpuKnown = window.GpuMs >= 0.0f;
+	const bool bad = window.MissedFrameFraction > BAD_MISSED_FRACTION;
+	const bool good = window.MissedFrameFraction < GOOD_MISSED_FRACTION && ( !gpuKnown || window.GpuMs < IDLE_GPU_MS );
+
+	BadWindows = bad ? BadWindows + 1 : 0;
+	GoodWindows = good ? GoodWindows + 1 : 0;
+
+	if ( BadWindows >= BAD_WINDOWS_TO_RAISE )
+	{
+		BadWindows = 0;
+
+		if ( now - LastLowerTime < FAILED_LOWER_SECONDS )
+		{
+			// the lower levels didn't hold, wait longer before trying again
+			GoodWindowsNeeded *= 2;
+			if ( GoodWindowsNeeded > MAX_GOOD_WINDOWS_TO_LOWER )
+			{
+				GoodWindowsNeeded = MAX_GOOD_WINDOWS_TO_LOWER;
+			}
+		}
+
+		// a busy GPU is the likely reason, otherwise it's the CPU
+		if ( gpuKnown && window.GpuMs > BUSY_GPU_MS && Steady.Gpu < MAX_LEVEL )
+		{
+			Steady.Gpu++;
+			PendingReason = "frames missed, gpu busy";
+		}
+		else if ( Steady.Cpu < MAX_LEVEL )
+		{
+			Steady.Cpu++;
+			PendingReason = "frames missed";
+		}
+		else if ( Steady.Gpu < MAX_LEVEL )
+		{
+			Steady.Gpu++;
+			PendingReason = "frames missed";
+		}
+		return;
+	}
+
+	const int needed = contentStatic ? STATIC_WINDOWS_TO_LOWER : GoodWindowsNeeded;
+	if ( GoodWindows >= needed )
+	{
+		GoodWindows = 0;
+
+		// the GPU first when it is known to be idle, it draws the most power
+		if ( gpuKnown && Steady.Gpu > 0 )
+		{
+			Steady.Gpu--;
+		}
+		else if ( Steady.Cpu > 0 )
+		{
+			Steady.Cpu--;
+		}
+		else if ( Steady.Gpu > 0 )
+		{
+			Steady.Gpu--;
+		}
+		else
+		{
+			return;
+		}
+		LastLowerTime = now;
+		PendingReason = contentStatic ? "stream static" : "headroom";
+	}
+}
+
+} // namespace VRMatterStreamTheater
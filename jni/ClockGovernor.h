@@ -0,0 +1,105 @@
+/************************************************************************************
+
+Filename    :   ClockGovernor.h
+Content     :	Raises the CPU and GPU clock levels for bursts of work and lowers them when there is headroom
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( ClockGovernor_h )
+#define ClockGovernor_h
+
+// Only the kernel types are used here, so the governor can be driven
+// from synthetic telemetry without a device.
+#include "Kernel/OVR_Types.h"
+
+namespace VRMatterStreamTheater {
+
+// Work we know is coming, each raises the clocks for a little while
+enum ClockBurst
+{
+	CLOCK_BURST_SCENE_LOAD,		// theater model and textures
+	CLOCK_BURST_POSTERS,		// png decode and mip generation
+	CLOCK_BURST_STREAM_START,	// decoder and connection setup
+	CLOCK_BURST_COUNT
+};
+
+struct ClockLevels
+{
+	int		Cpu;
+	int		Gpu;
+
+			ClockLevels() : Cpu( 1 ), Gpu( 2 ) {}
+			ClockLevels( int cpu, int gpu ) : Cpu( cpu ), Gpu( gpu ) {}
+
+	bool	operator == ( const ClockLevels & b ) const { return Cpu == b.Cpu && Gpu == b.Gpu; }
+	bool	operator != ( const ClockLevels & b ) const { return !( *this == b ); }
+};
+
+// One measurement window, summarized
+struct ClockSample
+{
+	float	GpuMs;					// both eyes, -1 when the GPU can't be timed
+	float	MissedFrameFraction;
+
+			ClockSample() : GpuMs( -1.0f ), MissedFrameFraction( 0.0f ) {}
+};
+
+//==============================================================
+// ClockGovernor
+// Pure state machine.  The steady levels follow the telemetry: missed
+// frames raise the GPU if it is busy and the CPU otherwise, steady
+// headroom lowers them one step at a time, faster while the stream is
+// static.  Bursts raise the levels above the steady ones until they
+// run out.  While the device is throttled nothing goes above the
+// throttled cap and bursts are ignored.
+class ClockGovernor
+{
+public:
+	static const int	MAX_LEVEL = 3;
+
+						ClockGovernor();
+
+	// levels picked by hand, the governor never moves them
+	void				Pin( const ClockLevels & levels );
+	void				Reset( const ClockLevels & start, const double now );
+
+	void				Burst( const ClockBurst burst, const double now );
+
+	// window is NULL on frames that didn't finish one.  Returns true
+	// when the levels changed, GetReason says why.
+	bool				Update( const ClockSample * window, const bool contentStatic, const bool throttled, const double now );
+
+	const ClockLevels &	GetLevels() const { return Current; }
+	const char *		GetReason() const { return Reason; }
+	bool				IsPinned() const { return Pinned; }
+
+	static const char *	GetBurstName( const ClockBurst burst );
+
+private:
+	ClockLevels			Steady;			// from the telemetry alone
+	ClockLevels			Current;		// steady, raised by bursts, capped when throttled
+	double				BurstEnds[CLOCK_BURST_COUNT];
+	bool				Pinned;
+	bool				Throttled;
+
+	int					BadWindows;
+	int					GoodWindows;
+	int					GoodWindowsNeeded;	// grows each time lowering the clocks fails
+	double				LastLowerTime;
+
+	const char *		PendingReason;	// why the next change happens
+	const char *		Reason;
+
+	void				Evaluate( const ClockSample & window, const bool contentStatic, const double now );
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // ClockGovernor_h
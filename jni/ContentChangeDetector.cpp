@@ -0,0 +1,167 @@
+/************************************************************************************
+
+Filename    :   ContentChangeDetector.cpp
+Content     :	Finds which part of the stream changed between two small samples
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ContentChangeDetector.h"
+#include "Kernel/OVR_Alg.h"
+
+#if defined( __ARM_NEON__ ) || defined( __ARM_NEON )
+#include <arm_neon.h>
+#define CONTENT_HASH_NEON
+#endif
+
+namespace VRMatterStreamTheater {
+
+// FNV-1a over 32 bit words.  Each step is a bijection of the running hash,
+// so a single changed pixel always changes the lane it lands in.
+static const UInt32	HASH_BASIS	= 0x811C9DC5;
+static const UInt32	HASH_PRIME	= 0x01000193;
+
+void ContentRect::Include( const ContentRect & other )
+{
+	if ( other.IsEmpty() )
+	{
+		return;
+	}
+	if ( IsEmpty() )
+	{
+		*this = other;
+		return;
+	}
+	X0 = Alg::Min( X0, other.X0 );
+	Y0 = Alg::Min( Y0, other.Y0 );
+	X1 = Alg::Max( X1, other.X1 );
+	Y1 = Alg::Max( Y1, other.Y1 );
+}
+
+ContentChangeDetector::ContentChangeDetector() :
+	SampleWidth( 0 ),
+	SampleHeight( 0 ),
+	HaveHashes( false ),
+	DirtyRect(),
+	DirtyTiles( 0 )
+
+{
+	for ( int i = 0; i < GRID_X * GRID_Y; i++ )
+	{
+		TileHashes[i] = 0;
+	}
+}
+
+void ContentChangeDetector::Reset()
+{
+	HaveHashes = false;
+	DirtyRect = ContentRect();
+	DirtyTiles = 0;
+}
+
+// Four words at a time go into four independent lanes, the leftover
+// words at the end of each row into a fifth.  The NEON path has to give
+// exactly the same result as the plain one.
+static UInt64 HashTile( const UByte * rgba, const int stride, const int width, const int height )
+{
+	const int groups = width / 4;
+	UInt32 lanes[4] = { HASH_BASIS, HASH_BASIS, HASH_BASIS, HASH_BASIS };
+	UInt32 tail = HASH_BASIS;
+
+#if defined( CONTENT_HASH_NEON )
+	uint32x4_t vlanes = vdupq_n_u32( HASH_BASIS );
+	const uint32x4_t vprime = vdupq_n_u32( HASH_PRIME );
+#endif
+
+	for ( int y = 0; y < height; y++ )
+	{
+		const UInt32 * words = (const UInt32 *)( rgba + y * stride );
+#if defined( CONTENT_HASH_NEON )
+		for ( int g = 0; g < groups; g++ )
+		{
+			vlanes = vmulq_u32( veorq_u32( vlanes, vld1q_u32( words + g * 4 ) ), vprime );
+		}
+#else
+		for ( int g = 0; g < groups; g++ )
+		{
+			const UInt32 * w = words + g * 4;
+			lanes[0] = ( lanes[0] ^ w[0] ) * HASH_PRIME;
+			lanes[1] = ( lanes[1] ^ w[1] ) * HASH_PRIME;
+			lanes[2] = ( lanes[2] ^ w[2] ) * HASH_PRIME;
+			lanes[3] = ( lanes[3] ^ w[3] ) * HASH_PRIME;
+		}
+#endif
+		for ( int x = groups * 4; x < width; x++ )
+		{
+			tail = ( tail ^ words[x] ) * HASH_PRIME;
+		}
+	}
+
+#if defined( CONTENT_HASH_NEON )
+	vst1q_u32( lanes, vlanes );
+#endif
+
+	const UInt32 high = lanes[0] ^ ( lanes[2] * 0x9E3779B1 );
+	const UInt32 low = lanes[1] ^ ( lanes[3] * 0x85EBCA77 ) ^ ( tail * 0xC2B2AE3D );
+	return ( (UInt64)high << 32 ) | low;
+}
+
+bool ContentChangeDetector::Update( const UByte * rgba, const int width, const int height )
+{
+	if ( width != SampleWidth || height != SampleHeight )
+	{
+		SampleWidth = width;
+		SampleHeight = height;
+		HaveHashes = false;
+	}
+
+	const int stride = width * 4;
+	int minX = GRID_X;
+	int minY = GRID_Y;
+	int maxX = -1;
+	int maxY = -1;
+	DirtyTiles = 0;
+
+	for ( int ty = 0; ty < GRID_Y; ty++ )
+	{
+		const int y0 = ty * height / GRID_Y;
+		const int y1 = ( ty + 1 ) * height / GRID_Y;
+		for ( int tx = 0; tx < GRID_X; tx++ )
+		{
+			const int x0 = tx * width / GRID_X;
+			const int x1 = ( tx + 1 ) * width / GRID_X;
+			const UInt64 hash = HashTile( rgba + y0 * stride + x0 * 4, stride, x1 - x0, y1 - y0 );
+
+			UInt64 & previous = TileHashes[ty * GRID_X + tx];
+			if ( !HaveHashes || hash != previous )
+			{
+				previous = hash;
+				DirtyTiles++;
+				minX = Alg::Min( minX, tx );
+				minY = Alg::Min( minY, ty );
+				maxX = Alg::Max( maxX, tx );
+				maxY = Alg::Max( maxY, ty );
+			}
+		}
+	}
+	HaveHashes = true;
+
+	if ( DirtyTiles == 0 )
+	{
+		DirtyRect = ContentRect();
+		return false;
+	}
+
+	// snap to the sample's pixels so tiles that don't divide evenly are still covered
+	DirtyRect = ContentRect( (float)( minX * width / GRID_X ) / width, (float)( minY * height / GRID_Y ) / height,
+			(float)( ( maxX + 1 ) * width / GRID_X ) / width, (float)( ( maxY + 1 ) * height / GRID_Y ) / height );
+	return true;
+}
+
+} // namespace VRMatterStreamTheater
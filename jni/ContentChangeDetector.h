@@ -0,0 +1,78 @@
+/************************************************************************************
+
+Filename    :   ContentChangeDetector.h
+Content     :	Finds which part of the stream changed between two small samples
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( ContentChangeDetector_h )
+#define ContentChangeDetector_h
+
+#include "Kernel/OVR_Types.h"
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+//==============================================================
+// ContentRect
+// A rectangle in 0-1 texture coordinates, x1/y1 exclusive.
+struct ContentRect
+{
+						ContentRect() : X0( 0.0f ), Y0( 0.0f ), X1( 0.0f ), Y1( 0.0f ) {}
+						ContentRect( const float x0, const float y0, const float x1, const float y1 ) :
+							X0( x0 ), Y0( y0 ), X1( x1 ), Y1( y1 ) {}
+
+	static ContentRect	Full() { return ContentRect( 0.0f, 0.0f, 1.0f, 1.0f ); }
+
+	bool				IsEmpty() const { return X1 <= X0 || Y1 <= Y0; }
+	float				Area() const { return IsEmpty() ? 0.0f : ( X1 - X0 ) * ( Y1 - Y0 ); }
+	void				Include( const ContentRect & other );
+
+	float				X0;
+	float				Y0;
+	float				X1;
+	float				Y1;
+};
+
+//==============================================================
+// ContentChangeDetector
+// Splits each RGBA sample into a grid of tiles and hashes them.  Tiles
+// whose hash differs from the previous sample make up the dirty rect.
+// Nothing is allocated after construction.
+class ContentChangeDetector
+{
+public:
+	static const int	GRID_X = 16;
+	static const int	GRID_Y = 16;
+
+						ContentChangeDetector();
+
+	// forget the previous sample, the next one is reported as fully dirty
+	void				Reset();
+
+	// rows are tightly packed, width * 4 bytes.  Returns true if anything changed.
+	bool				Update( const UByte * rgba, const int width, const int height );
+
+	const ContentRect &	GetDirtyRect() const { return DirtyRect; }
+	int					GetDirtyTiles() const { return DirtyTiles; }
+
+private:
+	UInt64				TileHashes[GRID_X * GRID_Y];
+	int					SampleWidth;
+	int					SampleHeight;
+	bool				HaveHashes;
+	ContentRect			DirtyRect;
+	int					DirtyTiles;
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // ContentChangeDetector_h
@@ -0,0 +1,243 @@
+/************************************************************************************
+
+Filename    :   EyeBufferGovernor.cpp
+Content     :	Picks eye buffer MSAA and resolution from the measured GPU frame time
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "EyeBufferGovernor.h"
+
+namespace VRMatterStreamTheater {
+
+// Best first.  MSAA goes before resolution, the screen text needs the pixels.
+static const EyeBufferLevel LEVELS[] =
+{
+	EyeBufferLevel( 4, 1024 ),
+	EyeBufferLevel( 2, 1024 ),
+	EyeBufferLevel( 1, 1024 ),
+	EyeBufferLevel( 1, 896 ),
+	EyeBufferLevel( 1, 768 )
+};
+static const int	NUM_LEVELS = sizeof( LEVELS ) / sizeof( LEVELS[0] );
+
+// A window is bad if either of these is exceeded...
+static const float	BAD_GPU_MS				= 13.0f;	// the copy and timewarp need the rest of the frame
+static const float	BAD_MISSED_FRACTION		= 0.05f;
+
+// ...and only good if both are met.  The level above has to fit in the headroom.
+static const float	GOOD_GPU_MS				= 8.0f;
+static const float	GOOD_MISSED_FRACTION	= 0.01f;
+
+static const float	MISSED_FRAME_SECONDS	= 1.5f / 60.0f;
+
+static const int	BAD_WINDOWS_TO_STEP_DOWN	= 2;
+static const int	GOOD_WINDOWS_TO_STEP_UP		= 5;
+static const int	MAX_GOOD_WINDOWS_TO_STEP_UP	= 60;
+
+// new eye buffers and a new view both hitch for a moment, don't judge that
+static const double	SETTLE_SECONDS			= 2.0;
+// stepping down this soon after stepping up means the step up failed
+static const double	FAILED_PROBE_SECONDS	= 20.0;
+
+const double EyeBufferStats::WINDOW_SECONDS = 1.0;
+
+//==============================================================
+// EyeBufferStats
+
+EyeBufferStats::EyeBufferStats()
+{
+	Reset( 0.0 );
+}
+
+void EyeBufferStats::Reset( const double now )
+{
+	WindowStart = now;
+	Frames = 0;
+	MissedFrames = 0;
+	GpuCount = 0;
+	GpuSum = 0.0;
+}
+
+void EyeBufferStats::AddFrame( const float frameSeconds, const float gpuMs )
+{
+	Frames++;
+	if ( frameSeconds > MISSED_FRAME_SECONDS )
+	{
+		MissedFrames++;
+	}
+	if ( gpuMs >= 0.0f )
+	{
+		GpuCount++;
+		GpuSum += gpuMs;
+	}
+}
+
+bool EyeBufferStats::GetSample( const double now, EyeBufferSample & sample )
+{
+	if ( now - WindowStart < WINDOW_SECONDS || Frames == 0 )
+	{
+		return false;
+	}
+
+	sample = EyeBufferSample();
+	sample.GpuMs = GpuCount > 0 ? (float)( GpuSum / GpuCount ) : -1.0f;
+	sample.MissedFrameFraction = (float)MissedFrames / Frames;
+
+	Reset( now );
+	return true;
+}
+
+//==============================================================
+// EyeBufferGovernor
+
+EyeBufferGovernor::EyeBufferGovernor() :
+	Context( -1 ),
+	Ceiling( 0 ),
+	Level( 0 ),
+	State( EYE_BUFFERS_FULL ),
+	BadWindows( 0 ),
+	GoodWindows( 0 ),
+	GoodWindowsNeeded( GOOD_WINDOWS_TO_STEP_UP ),
+	LastChangeTime( 0.0 ),
+	LastChangeWasUp( false )
+
+{
+	for ( int i = 0; i < MAX_CONTEXTS; i++ )
+	{
+		ContextLevels[i] = -1;
+	}
+}
+
+int EyeBufferGovernor::GetLevelCount()
+{
+	return NUM_LEVELS;
+}
+
+const EyeBufferLevel & EyeBufferGovernor::GetLevel() const
+{
+	return LEVELS[Level];
+}
+
+bool EyeBufferGovernor::SetContext( const int context, const EyeBufferLevel & ceiling, const double now )
+{
+	// the best level that doesn't go over the ceiling
+	int ceilingLevel = NUM_LEVELS - 1;
+	for ( int i = 0; i < NUM_LEVELS; i++ )
+	{
+		if ( LEVELS[i].Multisamples <= ceiling.Multisamples && LEVELS[i].Resolution <= ceiling.Resolution )
+		{
+			ceilingLevel = i;
+			break;
+		}
+	}
+
+	if ( context == Context && ceilingLevel == Ceiling )
+	{
+		return false;
+	}
+
+	const bool remembered = context >= 0 && context < MAX_CONTEXTS && ContextLevels[context] >= 0;
+	const int level = remembered ? ContextLevels[context] : ceilingLevel;
+
+	Context = context;
+	Ceiling = ceilingLevel;
+	BadWindows = 0;
+	GoodWindows = 0;
+	GoodWindowsNeeded = GOOD_WINDOWS_TO_STEP_UP;
+	SetLevel( level > ceilingLevel ? level : ceilingLevel, now );
+	LastChangeWasUp = false;
+	State = ( Level == Ceiling ) ? EYE_BUFFERS_FULL : EYE_BUFFERS_REDUCED;
+	return true;
+}
+
+void EyeBufferGovernor::SetLevel( const int level, const double now )
+{
+	Level = level;
+	LastChangeTime = now;
+	if ( Context >= 0 && Context < MAX_CONTEXTS )
+	{
+		ContextLevels[Context] = level;
+	}
+}
+
+bool EyeBufferGovernor::Evaluate( const EyeBufferSample & sample, const double now )
+{
+	if ( now - LastChangeTime < SETTLE_SECONDS )
+	{
+		return false;
+	}
+
+	// without a GPU timer only missed frames can be judged
+	const bool gpuKnown = sample.GpuMs >= 0.0f;
+	const bool bad = sample.MissedFrameFraction > BAD_MISSED_FRACTION || ( gpuKnown && sample.GpuMs > BAD_GPU_MS );
+	const bool good = sample.MissedFrameFraction < GOOD_MISSED_FRACTION && ( !gpuKnown || sample.GpuMs < GOOD_GPU_MS );
+
+	BadWindows = bad ? BadWindows + 1 : 0;
+	GoodWindows = good ? GoodWindows + 1 : 0;
+
+	if ( BadWindows >= BAD_WINDOWS_TO_STEP_DOWN )
+	{
+		BadWindows = 0;
+
+		if ( LastChangeWasUp && now - LastChangeTime < FAILED_PROBE_SECONDS )
+		{
+			// the last recovery didn't hold, wait longer before the next one
+			GoodWindowsNeeded *= 2;
+			if ( GoodWindowsNeeded > MAX_GOOD_WINDOWS_TO_STEP_UP )
+			{
+				GoodWindowsNeeded = MAX_GOOD_WINDOWS_TO_STEP_UP;
+			}
+		}
+
+		if ( Level >= NUM_LEVELS - 1 )
+		{
+			State = EYE_BUFFERS_MINIMUM;
+			return false;
+		}
+
+		SetLevel( Level + 1, now );
+		State = ( Level == NUM_LEVELS - 1 ) ? EYE_BUFFERS_MINIMUM : EYE_BUFFERS_REDUCED;
+		LastChangeWasUp = false;
+		return true;
+	}
+
+	if ( GoodWindows >= GoodWindowsNeeded )
+	{
+		GoodWindows = 0;
+
+		if ( Level <= Ceiling )
+		{
+			State = EYE_BUFFERS_FULL;
+			GoodWindowsNeeded = GOOD_WINDOWS_TO_STEP_UP;
+			return false;
+		}
+
+		SetLevel( Level - 1, now );
+		State = ( Level == Ceiling ) ? EYE_BUFFERS_FULL : EYE_BUFFERS_RECOVERING;
+		LastChangeWasUp = true;
+		return true;
+	}
+
+	return false;
+}
+
+const char * EyeBufferGovernor::GetStateName() const
+{
+	switch ( State )
+	{
+		case EYE_BUFFERS_FULL:			return "full";
+		case EYE_BUFFERS_REDUCED:		return "reduced";
+		case EYE_BUFFERS_RECOVERING:	return "recovering";
+		case EYE_BUFFERS_MINIMUM:		return "minimum";
+	}
+	return "";
+}
+
+} // namespace VRMatterStreamTheater
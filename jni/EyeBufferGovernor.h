@@ -0,0 +1,127 @@
+/************************************************************************************
+
+Filename    :   EyeBufferGovernor.h
+Content     :	Picks eye buffer MSAA and resolution from the measured GPU frame time
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( EyeBufferGovernor_h )
+#define EyeBufferGovernor_h
+
+// Only the kernel types are used here, so the governor can be driven
+// from recorded frame time traces without a device.
+#include "Kernel/OVR_Types.h"
+
+namespace VRMatterStreamTheater {
+
+struct EyeBufferLevel
+{
+	int		Multisamples;
+	int		Resolution;		// eye buffer width and height
+
+			EyeBufferLevel() : Multisamples( 4 ), Resolution( 1024 ) {}
+			EyeBufferLevel( int multisamples, int resolution ) :
+				Multisamples( multisamples ), Resolution( resolution ) {}
+
+	bool	operator == ( const EyeBufferLevel & b ) const { return Multisamples == b.Multisamples && Resolution == b.Resolution; }
+	bool	operator != ( const EyeBufferLevel & b ) const { return !( *this == b ); }
+};
+
+// One measurement window, summarized
+struct EyeBufferSample
+{
+	float	GpuMs;					// both eyes, -1 when the GPU can't be timed
+	float	MissedFrameFraction;	// frames that took longer than one and a half vsyncs
+
+			EyeBufferSample() : GpuMs( -1.0f ), MissedFrameFraction( 0.0f ) {}
+};
+
+//==============================================================
+// EyeBufferStats
+// Accumulates per-frame measurements and produces a sample per window
+class EyeBufferStats
+{
+public:
+	static const double	WINDOW_SECONDS;
+
+						EyeBufferStats();
+
+	void				Reset( const double now );
+
+	// gpuMs is the last eye render the GPU timer has a result for, -1 for none
+	void				AddFrame( const float frameSeconds, const float gpuMs );
+
+	// returns true once per window with the summary of that window
+	bool				GetSample( const double now, EyeBufferSample & sample );
+
+private:
+	double				WindowStart;
+	int					Frames;
+	int					MissedFrames;
+	int					GpuCount;
+	double				GpuSum;
+};
+
+//==============================================================
+// EyeBufferGovernor
+// Pure control law over a fixed ladder of levels.  Drops MSAA first,
+// then resolution, and recovers in the same order, never above the
+// ceiling of the current context.  A context is a view in a scene;
+// each one remembers the level it last settled at, since the theaters
+// cost very different amounts to draw.
+class EyeBufferGovernor
+{
+public:
+	enum GovernorState
+	{
+		EYE_BUFFERS_FULL,		// at the ceiling
+		EYE_BUFFERS_REDUCED,	// stepped down and holding
+		EYE_BUFFERS_RECOVERING,	// stepped back up, watching for trouble
+		EYE_BUFFERS_MINIMUM		// nothing left to step down
+	};
+
+	static const int	MAX_CONTEXTS = 64;
+
+						EyeBufferGovernor();
+
+	// Switches to another context, starting at the level it was left at.
+	// Returns true if the context changed, the caller should restart its window.
+	bool				SetContext( const int context, const EyeBufferLevel & ceiling, const double now );
+
+	// returns true when the level changed
+	bool				Evaluate( const EyeBufferSample & sample, const double now );
+
+	const EyeBufferLevel &	GetLevel() const;
+	int					GetContext() const { return Context; }
+	GovernorState		GetState() const { return State; }
+	const char *		GetStateName() const;
+
+	static int			GetLevelCount();
+
+private:
+	int					Context;
+	int					Ceiling;		// ladder index, 0 is the best
+	int					Level;
+	GovernorState		State;
+	int					ContextLevels[MAX_CONTEXTS];	// -1 until the context has been used
+
+	int					BadWindows;
+	int					GoodWindows;
+	int					GoodWindowsNeeded;	// grows each time a recovery step fails
+
+	double				LastChangeTime;
+	bool				LastChangeWasUp;
+
+	void				SetLevel( const int level, const double now );
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // EyeBufferGovernor_h
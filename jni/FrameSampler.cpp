@@ -0,0 +1,288 @@
+/************************************************************************************
+
+Filename    :   FrameSampler.cpp
+Content     :	Non-blocking readback of a downsampled copy of the movie texture
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "FrameSampler.h"
+#include "Android/LogUtils.h"
+#include "Kernel/OVR_Alg.h"
+#include "Kernel/OVR_Math.h"
+
+namespace VRMatterStreamTheater {
+
+FrameSampler::FrameSampler() :
+	Texture( 0 ),
+	FBO( 0 ),
+	Oldest( 0 ),
+	Pending( 0 ),
+	SourceWidth( 0 ),
+	SourceHeight( 0 ),
+	Width( 0 ),
+	Height( 0 ),
+	Mapped( false )
+
+{
+	for ( int i = 0; i < NUM_BUFFERS; i++ )
+	{
+		PackBuffers[i] = 0;
+		Fences[i] = 0;
+		Tags[i] = 0.0;
+	}
+}
+
+void FrameSampler::Shutdown()
+{
+	Flush();
+	FreeTargets();
+	SourceWidth = 0;
+	SourceHeight = 0;
+	Width = 0;
+	Height = 0;
+}
+
+void FrameSampler::FreeTargets()
+{
+	if ( FBO != 0 )
+	{
+		glDeleteFramebuffers( 1, &FBO );
+		FBO = 0;
+	}
+	if ( Texture != 0 )
+	{
+		glDeleteTextures( 1, &Texture );
+		Texture = 0;
+	}
+	if ( PackBuffers[0] != 0 )
+	{
+		glDeleteBuffers( NUM_BUFFERS, PackBuffers );
+		for ( int i = 0; i < NUM_BUFFERS; i++ )
+		{
+			PackBuffers[i] = 0;
+		}
+	}
+}
+
+void FrameSampler::SetSourceSize( const int sourceWidth, const int sourceHeight )
+{
+	if ( sourceWidth == SourceWidth && sourceHeight == SourceHeight )
+	{
+		return;
+	}
+
+	Flush();
+	FreeTargets();
+
+	SourceWidth = sourceWidth;
+	SourceHeight = sourceHeight;
+	Width = ( sourceWidth > 0 ) ? Alg::Max( 1, sourceWidth / DOWNSAMPLE ) : 0;
+	Height = ( sourceHeight > 0 ) ? Alg::Max( 1, sourceHeight / DOWNSAMPLE ) : 0;
+	LOG( "FrameSampler: %ix%i samples of a %ix%i stream", Width, Height, SourceWidth, SourceHeight );
+}
+
+void FrameSampler::SetReadSize( const int width, const int height )
+{
+	if ( width == Width && height == Height )
+	{
+		return;
+	}
+
+	Flush();
+	FreeTargets();
+
+	SourceWidth = width;
+	SourceHeight = height;
+	Width = width;
+	Height = height;
+}
+
+void FrameSampler::Flush()
+{
+	if ( Mapped )
+	{
+		ReleaseResult();
+	}
+	for ( int i = 0; i < NUM_BUFFERS; i++ )
+	{
+		if ( Fences[i] != 0 )
+		{
+			glDeleteSync( Fences[i] );
+			Fences[i] = 0;
+		}
+	}
+	Oldest = 0;
+	Pending = 0;
+}
+
+void FrameSampler::CreateReadTargets()
+{
+	if ( PackBuffers[0] != 0 )
+	{
+		return;
+	}
+
+	glGenFramebuffers( 1, &FBO );
+	glGenBuffers( NUM_BUFFERS, PackBuffers );
+	for ( int i = 0; i < NUM_BUFFERS; i++ )
+	{
+		glBindBuffer( GL_PIXEL_PACK_BUFFER, PackBuffers[i] );
+		glBufferData( GL_PIXEL_PACK_BUFFER, Width * Height * 4, NULL, GL_STREAM_READ );
+	}
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+}
+
+// the buffer for the next read
+int FrameSampler::NextSlot()
+{
+	// if the GPU has fallen this far behind, the oldest sample is the one
+	// to lose; the detector compares against whatever it saw last anyway
+	if ( Pending == NUM_BUFFERS )
+	{
+		glDeleteSync( Fences[Oldest] );
+		Fences[Oldest] = 0;
+		Oldest = ( Oldest + 1 ) % NUM_BUFFERS;
+		Pending--;
+	}
+
+	return ( Oldest + Pending ) % NUM_BUFFERS;
+}
+
+void FrameSampler::Sample( const GLuint externalTexture, const GlProgram & program, const GlGeometry & quad, const double tag )
+{
+	if ( Width == 0 || Height == 0 || Mapped )
+	{
+		return;
+	}
+
+	if ( Texture == 0 )
+	{
+		glGenTextures( 1, &Texture );
+		glBindTexture( GL_TEXTURE_2D, Texture );
+		glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, Width, Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+		glBindTexture( GL_TEXTURE_2D, 0 );
+
+		CreateReadTargets();
+		glBindFramebuffer( GL_FRAMEBUFFER, FBO );
+		glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, Texture, 0 );
+		glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+	}
+
+	const int slot = NextSlot();
+
+	glBindFramebuffer( GL_FRAMEBUFFER, FBO );
+	glDisable( GL_DEPTH_TEST );
+	glDisable( GL_SCISSOR_TEST );
+	GL_InvalidateFramebuffer( INV_FBO, true, false );
+	glViewport( 0, 0, Width, Height );
+
+	glActiveTexture( GL_TEXTURE0 );
+	glBindTexture( GL_TEXTURE_EXTERNAL_OES, externalTexture );
+	glUseProgram( program.program );
+	glUniform4f( program.uColor, 1.0f / SourceWidth, 1.0f / SourceHeight, 0.0f, 0.0f );
+	glUniformMatrix4fv( program.uTexm, 1, GL_FALSE, Matrix4f::Identity().M[0] );	// always the whole stream
+	quad.Draw();
+	glBindTexture( GL_TEXTURE_EXTERNAL_OES, 0 );
+
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, PackBuffers[slot] );
+	glReadPixels( 0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, 0 );
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+	glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+
+	Fences[slot] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+	Tags[slot] = tag;
+	Pending++;
+}
+
+// The copy into the pack buffer is queued like any other GL command, so
+// it sees the level as it is now, whatever is drawn into it later.
+void FrameSampler::ReadLevel( const GLuint texture, const int level, const double tag )
+{
+	if ( Width == 0 || Height == 0 || Mapped )
+	{
+		return;
+	}
+
+	CreateReadTargets();
+	glBindFramebuffer( GL_FRAMEBUFFER, FBO );
+	glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, level );
+	if ( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+	{
+		LOG( "FrameSampler: mip level %i not readable", level );
+		glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+		return;
+	}
+
+	const int slot = NextSlot();
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, PackBuffers[slot] );
+	glReadPixels( 0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, 0 );
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+	glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+
+	Fences[slot] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+	Tags[slot] = tag;
+	Pending++;
+}
+
+const UByte * FrameSampler::MapResult( int & width, int & height, double * tag )
+{
+	if ( Pending == 0 || Mapped )
+	{
+		return NULL;
+	}
+
+	const GLenum status = glClientWaitSync( Fences[Oldest], 0, 0 );
+	if ( status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED )
+	{
+		return NULL;
+	}
+	glDeleteSync( Fences[Oldest] );
+	Fences[Oldest] = 0;
+
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, PackBuffers[Oldest] );
+	const void * pixels = glMapBufferRange( GL_PIXEL_PACK_BUFFER, 0, Width * Height * 4, GL_MAP_READ_BIT );
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+	if ( pixels == NULL )
+	{
+		LOG( "FrameSampler: couldn't map sample" );
+		Oldest = ( Oldest + 1 ) % NUM_BUFFERS;
+		Pending--;
+		return NULL;
+	}
+
+	Mapped = true;
+	width = Width;
+	height = Height;
+	if ( tag != NULL )
+	{
+		*tag = Tags[Oldest];
+	}
+	return (const UByte *)pixels;
+}
+
+void FrameSampler::ReleaseResult()
+{
+	if ( !Mapped )
+	{
+		return;
+	}
+
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, PackBuffers[Oldest] );
+	glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+
+	Mapped = false;
+	Oldest = ( Oldest + 1 ) % NUM_BUFFERS;
+	Pending--;
+}
+
+} // namespace VRMatterStreamTheater
@@ -0,0 +1,86 @@
+/************************************************************************************
+
+Filename    :   FrameSampler.h
+Content     :	Non-blocking readback of a downsampled copy of the movie texture
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( FrameSampler_h )
+#define FrameSampler_h
+
+#include "Android/GLUtils.h"
+#include "GlProgram.h"
+#include "GlGeometry.h"
+#include "Kernel/OVR_Types.h"
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+//==============================================================
+// FrameSampler
+// Draws the external movie texture into a small target with a box
+// filter and reads it back through pixel pack buffers.  A fence is
+// polled instead of waited on, so a sample normally shows up on the
+// next frame and nothing ever stalls the GPU.
+//
+// The same ring can read a level of a 2D texture as it is, for the small
+// thumbnails of the mip chain.  A sampler does one or the other.
+class FrameSampler
+{
+public:
+	static const int	DOWNSAMPLE = 4;		// each sample pixel is the average of a 4x4 block
+
+						FrameSampler();
+
+	// GL thread only
+	void				Shutdown();
+
+	// sourceWidth / height is the size of the stream, not of the mip mapped copy
+	void				SetSourceSize( const int sourceWidth, const int sourceHeight );
+
+	// the size of the texture level ReadLevel copies
+	void				SetReadSize( const int width, const int height );
+
+	// the tag comes back with the result, to tell which frame it was
+	void				Sample( const GLuint externalTexture, const GlProgram & program, const GlGeometry & quad, const double tag = 0.0 );
+	void				ReadLevel( const GLuint texture, const int level, const double tag );
+
+	// oldest finished sample, valid until ReleaseResult, NULL if nothing is ready
+	const UByte *		MapResult( int & width, int & height, double * tag = NULL );
+	void				ReleaseResult();
+
+	// drop everything in flight, after a seek or size change
+	void				Flush();
+
+private:
+	static const int	NUM_BUFFERS = 3;
+
+	GLuint				Texture;
+	GLuint				FBO;
+	GLuint				PackBuffers[NUM_BUFFERS];
+	GLsync				Fences[NUM_BUFFERS];
+	double				Tags[NUM_BUFFERS];
+	int					Oldest;
+	int					Pending;
+	int					SourceWidth;
+	int					SourceHeight;
+	int					Width;
+	int					Height;
+	bool				Mapped;
+
+	void				FreeTargets();
+	void				CreateReadTargets();
+	int					NextSlot();
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // FrameSampler_h
@@ -0,0 +1,137 @@
+/************************************************************************************
+
+Filename    :   GpuTimer.cpp
+Content     :	Non-blocking GPU timing of a span of GL commands
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "GpuTimer.h"
+#include "Android/LogUtils.h"
+
+#include <string.h>
+
+#if !defined( GL_TIME_ELAPSED_EXT )
+#define GL_TIME_ELAPSED_EXT		0x88BF
+#endif
+#if !defined( GL_GPU_DISJOINT_EXT )
+#define GL_GPU_DISJOINT_EXT		0x8FBB
+#endif
+
+namespace VRMatterStreamTheater {
+
+GpuTimer::GpuTimer() :
+	Current( 0 ),
+	Supported( false ),
+	Active( false ),
+	LastMs( -1.0f )
+
+{
+	for ( int i = 0; i < NUM_QUERIES; i++ )
+	{
+		Queries[i] = 0;
+		Pending[i] = false;
+	}
+}
+
+void GpuTimer::Init()
+{
+	const char * extensions = (const char *)glGetString( GL_EXTENSIONS );
+	Supported = ( extensions != NULL ) && ( strstr( extensions, "GL_EXT_disjoint_timer_query" ) != NULL );
+	LOG( "GpuTimer: timer queries %s", Supported ? "available" : "not available" );
+	if ( !Supported )
+	{
+		return;
+	}
+
+	glGenQueries( NUM_QUERIES, Queries );
+
+	// clear any stale disjoint flag
+	GLint disjoint = 0;
+	glGetIntegerv( GL_GPU_DISJOINT_EXT, &disjoint );
+}
+
+void GpuTimer::Shutdown()
+{
+	if ( Supported && Queries[0] != 0 )
+	{
+		glDeleteQueries( NUM_QUERIES, Queries );
+	}
+	for ( int i = 0; i < NUM_QUERIES; i++ )
+	{
+		Queries[i] = 0;
+		Pending[i] = false;
+	}
+	Supported = false;
+}
+
+void GpuTimer::PollResults()
+{
+	for ( int i = 0; i < NUM_QUERIES; i++ )
+	{
+		if ( !Pending[i] )
+		{
+			continue;
+		}
+
+		GLuint available = 0;
+		glGetQueryObjectuiv( Queries[i], GL_QUERY_RESULT_AVAILABLE, &available );
+		if ( !available )
+		{
+			continue;
+		}
+		Pending[i] = false;
+
+		GLuint nanoseconds = 0;
+		glGetQueryObjectuiv( Queries[i], GL_QUERY_RESULT, &nanoseconds );
+
+		// a frequency change or context loss makes the result meaningless
+		GLint disjoint = 0;
+		glGetIntegerv( GL_GPU_DISJOINT_EXT, &disjoint );
+		if ( !disjoint )
+		{
+			LastMs = nanoseconds * 1e-6f;
+		}
+	}
+}
+
+void GpuTimer::Begin()
+{
+	if ( !Supported )
+	{
+		return;
+	}
+
+	PollResults();
+
+	// all queries still in flight, skip timing this span
+	if ( Pending[Current] )
+	{
+		Active = false;
+		return;
+	}
+
+	glBeginQuery( GL_TIME_ELAPSED_EXT, Queries[Current] );
+	Active = true;
+}
+
+void GpuTimer::End()
+{
+	if ( !Active )
+	{
+		return;
+	}
+
+	glEndQuery( GL_TIME_ELAPSED_EXT );
+	Pending[Current] = true;
+	Current = ( Current + 1 ) % NUM_QUERIES;
+	Active = false;
+}
+
+} // namespace VRMatterStreamTheater
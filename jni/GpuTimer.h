@@ -0,0 +1,57 @@
+/************************************************************************************
+
+Filename    :   GpuTimer.h
+Content     :	Non-blocking GPU timing of a span of GL commands
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( GpuTimer_h )
+#define GpuTimer_h
+
+#include "Android/GLUtils.h"
+
+namespace VRMatterStreamTheater {
+
+//==============================================================
+// GpuTimer
+// Uses GL_EXT_disjoint_timer_query when the driver has it.  Results
+// are read a few frames later so nothing ever waits on the GPU.
+class GpuTimer
+{
+public:
+						GpuTimer();
+
+	// GL thread only
+	void				Init();
+	void				Shutdown();
+
+	void				Begin();
+	void				End();
+
+	bool				IsSupported() const { return Supported; }
+	// milliseconds, -1 until the first result comes back or when unsupported
+	float				GetLastMs() const { return LastMs; }
+
+private:
+	static const int	NUM_QUERIES = 3;
+
+	GLuint				Queries[NUM_QUERIES];
+	bool				Pending[NUM_QUERIES];
+	int					Current;
+	bool				Supported;
+	bool				Active;
+	float				LastMs;
+
+	void				PollResults();
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // GpuTimer_h
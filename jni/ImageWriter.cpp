@@ -0,0 +1,167 @@
+/************************************************************************************
+
+Filename    :   ImageWriter.cpp
+Content     :	Writes captured RGBA frames out as PNG or raw files
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ImageWriter.h"
+#include "Android/LogUtils.h"
+#include "Kernel/OVR_Array.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+namespace VRMatterStreamTheater {
+
+static void PutBigEndian( UByte * out, const UInt32 value )
+{
+	out[0] = (UByte)( value >> 24 );
+	out[1] = (UByte)( value >> 16 );
+	out[2] = (UByte)( value >> 8 );
+	out[3] = (UByte)( value );
+}
+
+static void PutLittleEndian( UByte * out, const UInt32 value )
+{
+	out[0] = (UByte)( value );
+	out[1] = (UByte)( value >> 8 );
+	out[2] = (UByte)( value >> 16 );
+	out[3] = (UByte)( value >> 24 );
+}
+
+// length, type, data, then the CRC of type and data
+static bool WriteChunk( FILE * f, const char * type, const UByte * data, const UInt32 length )
+{
+	UByte header[8];
+	PutBigEndian( header, length );
+	memcpy( header + 4, type, 4 );
+
+	uLong crc = crc32( 0L, header + 4, 4 );
+	if ( length > 0 )
+	{
+		crc = crc32( crc, data, length );
+	}
+	UByte footer[4];
+	PutBigEndian( footer, (UInt32)crc );
+
+	return fwrite( header, 1, 8, f ) == 8 &&
+			( length == 0 || fwrite( data, 1, length, f ) == length ) &&
+			fwrite( footer, 1, 4, f ) == 4;
+}
+
+static bool FinishFile( FILE * f, const char * path, const bool written )
+{
+	const bool closed = ( fclose( f ) == 0 );
+	if ( !written || !closed )
+	{
+		LOG( "ImageWriter: couldn't write %s", path );
+		remove( path );
+		return false;
+	}
+	return true;
+}
+
+bool ImageWriter::WritePng( const char * path, const UByte * rgba, const int width, const int height, const bool bottomUp )
+{
+	if ( width <= 0 || height <= 0 )
+	{
+		return false;
+	}
+
+	// a filter byte then RGB per row
+	const int rowBytes = 1 + width * 3;
+	Array<UByte> filtered;
+	filtered.Resize( rowBytes * height );
+	for ( int y = 0; y < height; y++ )
+	{
+		const UByte * src = rgba + ( bottomUp ? height - 1 - y : y ) * width * 4;
+		UByte * dst = &filtered[y * rowBytes];
+		*dst++ = 1;		// Sub, each byte minus the one a pixel to the left
+		UByte left[3] = { 0, 0, 0 };
+		for ( int x = 0; x < width; x++, src += 4, dst += 3 )
+		{
+			dst[0] = (UByte)( src[0] - left[0] );
+			dst[1] = (UByte)( src[1] - left[1] );
+			dst[2] = (UByte)( src[2] - left[2] );
+			left[0] = src[0];
+			left[1] = src[1];
+			left[2] = src[2];
+		}
+	}
+
+	uLongf compressedSize = compressBound( filtered.GetSize() );
+	Array<UByte> compressed;
+	compressed.Resize( compressedSize );
+	if ( compress2( &compressed[0], &compressedSize, &filtered[0], filtered.GetSize(), Z_BEST_SPEED ) != Z_OK )
+	{
+		LOG( "ImageWriter: couldn't compress %s", path );
+		return false;
+	}
+
+	FILE * f = fopen( path, "wb" );
+	if ( f == NULL )
+	{
+		LOG( "ImageWriter: couldn't open %s", path );
+		return false;
+	}
+
+	static const UByte signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	UByte ihdr[13];
+	PutBigEndian( ihdr, width );
+	PutBigEndian( ihdr + 4, height );
+	ihdr[8] = 8;		// bits per channel
+	ihdr[9] = 2;		// RGB
+	ihdr[10] = 0;		// deflate
+	ihdr[11] = 0;		// adaptive filtering
+	ihdr[12] = 0;		// not interlaced
+
+	const bool written = fwrite( signature, 1, sizeof( signature ), f ) == sizeof( signature ) &&
+			WriteChunk( f, "IHDR", ihdr, sizeof( ihdr ) ) &&
+			WriteChunk( f, "IDAT", &compressed[0], (UInt32)compressedSize ) &&
+			WriteChunk( f, "IEND", NULL, 0 );
+	return FinishFile( f, path, written );
+}
+
+bool ImageWriter::WriteRaw( const char * path, const UByte * rgba, const int width, const int height, const bool bottomUp )
+{
+	if ( width <= 0 || height <= 0 )
+	{
+		return false;
+	}
+
+	FILE * f = fopen( path, "wb" );
+	if ( f == NULL )
+	{
+		LOG( "ImageWriter: couldn't open %s", path );
+		return false;
+	}
+
+	UByte header[RAW_HEADER_SIZE];
+	memcpy( header, "STRW", 4 );
+	PutLittleEndian( header + 4, width );
+	PutLittleEndian( header + 8, height );
+	PutLittleEndian( header + 12, 0 );
+	bool written = fwrite( header, 1, RAW_HEADER_SIZE, f ) == RAW_HEADER_SIZE;
+
+	const size_t rowBytes = width * 4;
+	if ( !bottomUp )
+	{
+		written = written && fwrite( rgba, 1, rowBytes * height, f ) == rowBytes * height;
+	}
+	for ( int y = height - 1; bottomUp && written && y >= 0; y-- )
+	{
+		written = fwrite( rgba + y * rowBytes, 1, rowBytes, f ) == rowBytes;
+	}
+	return FinishFile( f, path, written );
+}
+
+} // namespace VRMatterStreamTheater
@@ -0,0 +1,48 @@
+/************************************************************************************
+
+Filename    :   ImageWriter.h
+Content     :	Writes captured RGBA frames out as PNG or raw files
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( ImageWriter_h )
+#define ImageWriter_h
+
+#include "Kernel/OVR_Types.h"
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+//==============================================================
+// ImageWriter
+// Pixels are tightly packed RGBA rows.  bottomUp is for rows as
+// glReadPixels returns them, the files always start at the top.
+//
+// The PNG is RGB, alpha is dropped, with the Sub filter and the fastest
+// deflate level: it runs on a worker, and desktop content compresses
+// well enough at that.
+//
+// A raw file is a RAW_HEADER_SIZE byte header, "STRW" then the width
+// and height as little endian 32 bit ints and 4 bytes for the format
+// (always 0, RGBA), followed by the rows.  A clip is a numbered run of
+// them, cheap enough to keep up with the stream.
+class ImageWriter
+{
+public:
+	static const int		RAW_HEADER_SIZE = 16;
+
+	static bool				WritePng( const char * path, const UByte * rgba, const int width, const int height, const bool bottomUp );
+	static bool				WriteRaw( const char * path, const UByte * rgba, const int width, const int height, const bool bottomUp );
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // ImageWriter_h
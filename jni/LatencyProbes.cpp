@@ -0,0 +1,304 @@
+/************************************************************************************
+
+Filename    :   LatencyProbes.cpp
+Content     :	Timestamped probes along the input to photon path
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "LatencyProbes.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+namespace VRMatterStreamTheater {
+
+// anything longer is a stall or a missed pairing, not latency
+static const double	MAX_INTERVAL_SECONDS		= 1.0;
+
+static const float	TEST_CHANGE_THRESHOLD		= 12.0f;	// luminance levels, out of 255
+static const float	TEST_STABLE_THRESHOLD		= 3.0f;
+static const int	TEST_STABLE_FRAMES			= 10;
+static const double	TEST_MIN_CLICK_SPACING		= 0.5;
+static const double	TEST_TIMEOUT_SECONDS		= 1.0;
+static const int	TEST_MAX_TRIALS				= 30;
+
+//==============================================================
+// LatencyHistogram
+
+LatencyHistogram::LatencyHistogram()
+{
+	Reset();
+}
+
+void LatencyHistogram::Reset()
+{
+	Next = 0;
+	Count = 0;
+	Total = 0;
+}
+
+void LatencyHistogram::AddSample( const float ms )
+{
+	Samples[Next] = ms;
+	Next = ( Next + 1 ) % MAX_SAMPLES;
+	if ( Count < MAX_SAMPLES )
+	{
+		Count++;
+	}
+	Total++;
+}
+
+static int CompareFloats( const void * a, const void * b )
+{
+	const float fa = *(const float *)a;
+	const float fb = *(const float *)b;
+	return ( fa < fb ) ? -1 : ( ( fa > fb ) ? 1 : 0 );
+}
+
+float LatencyHistogram::GetPercentile( const float p ) const
+{
+	if ( Count == 0 )
+	{
+		return 0.0f;
+	}
+
+	float sorted[MAX_SAMPLES];
+	memcpy( sorted, Samples, Count * sizeof( float ) );
+	qsort( sorted, Count, sizeof( float ), CompareFloats );
+
+	// nearest rank
+	int rank = (int)ceilf( p / 100.0f * Count ) - 1;
+	rank = rank < 0 ? 0 : ( rank >= Count ? Count - 1 : rank );
+	return sorted[rank];
+}
+
+//==============================================================
+// LatencyProbes
+
+LatencyProbes::LatencyProbes() :
+	InputTime( 0.0 ),
+	SentTime( 0.0 ),
+	LatchTime( 0.0 ),
+	CopyTime( 0.0 ),
+	LastLatchTime( 0.0 )
+
+{
+}
+
+void LatencyProbes::Reset()
+{
+	InputTime = 0.0;
+	SentTime = 0.0;
+	LatchTime = 0.0;
+	CopyTime = 0.0;
+	for ( int i = 0; i < LATENCY_INTERVAL_COUNT; i++ )
+	{
+		Histograms[i].Reset();
+	}
+}
+
+const char * LatencyProbes::GetIntervalName( const LatencyInterval interval )
+{
+	switch ( interval )
+	{
+		case LATENCY_INPUT_TO_SEND:		return "input->send";
+		case LATENCY_SEND_TO_LATCH:		return "send->latch";
+		case LATENCY_LATCH_TO_COPY:		return "latch->copy";
+		case LATENCY_COPY_TO_SUBMIT:	return "copy->submit";
+		case LATENCY_END_TO_END:		return "click->change";
+		default:						return "";
+	}
+}
+
+void LatencyProbes::AddInterval( const LatencyInterval interval, const double start, const double end )
+{
+	if ( start <= 0.0 || end < start || end - start > MAX_INTERVAL_SECONDS )
+	{
+		return;
+	}
+	Histograms[interval].AddSample( (float)( ( end - start ) * 1000.0 ) );
+}
+
+void LatencyProbes::InputSampled( const double time )
+{
+	InputTime = time;
+}
+
+void LatencyProbes::EventSent( const double time )
+{
+	if ( InputTime > 0.0 )
+	{
+		AddInterval( LATENCY_INPUT_TO_SEND, InputTime, time );
+		InputTime = 0.0;
+	}
+	if ( SentTime <= 0.0 )
+	{
+		SentTime = time;
+	}
+}
+
+void LatencyProbes::FrameLatched( const double time )
+{
+	if ( SentTime > 0.0 )
+	{
+		AddInterval( LATENCY_SEND_TO_LATCH, SentTime, time );
+		SentTime = 0.0;
+	}
+	LatchTime = time;
+	LastLatchTime = time;
+}
+
+void LatencyProbes::CopyDone( const double time )
+{
+	if ( LatchTime > 0.0 )
+	{
+		AddInterval( LATENCY_LATCH_TO_COPY, LatchTime, time );
+		LatchTime = 0.0;
+		CopyTime = time;
+	}
+}
+
+void LatencyProbes::FrameSubmitted( const double time )
+{
+	if ( CopyTime > 0.0 )
+	{
+		AddInterval( LATENCY_COPY_TO_SUBMIT, CopyTime, time );
+		CopyTime = 0.0;
+	}
+}
+
+void LatencyProbes::AddEndToEnd( const float ms )
+{
+	Histograms[LATENCY_END_TO_END].AddSample( ms );
+}
+
+void LatencyProbes::GetSummary( char * buffer, const int bufferSize ) const
+{
+	int used = 0;
+	buffer[0] = '\0';
+	for ( int i = 0; i < LATENCY_INTERVAL_COUNT && used < bufferSize; i++ )
+	{
+		const LatencyHistogram & h = Histograms[i];
+		if ( h.GetCount() == 0 )
+		{
+			continue;
+		}
+		used += snprintf( buffer + used, bufferSize - used, "%s %.1f/%.1f/%.1f\n", GetIntervalName( (LatencyInterval)i ),
+				h.GetPercentile( 50.0f ), h.GetPercentile( 95.0f ), h.GetPercentile( 99.0f ) );
+	}
+}
+
+bool LatencyProbes::WriteReport( const char * path ) const
+{
+	FILE * f = fopen( path, "w" );
+	if ( f == NULL )
+	{
+		return false;
+	}
+
+	fprintf( f, "# interval, samples in window, total samples, p50 ms, p95 ms, p99 ms, max ms\n" );
+	for ( int i = 0; i < LATENCY_INTERVAL_COUNT; i++ )
+	{
+		const LatencyHistogram & h = Histograms[i];
+		fprintf( f, "%s, %i, %i, %.2f, %.2f, %.2f, %.2f\n", GetIntervalName( (LatencyInterval)i ), h.GetCount(), h.GetTotal(),
+				h.GetPercentile( 50.0f ), h.GetPercentile( 95.0f ), h.GetPercentile( 99.0f ), h.GetPercentile( 100.0f ) );
+	}
+
+	fclose( f );
+	return true;
+}
+
+//==============================================================
+// LatencyTest
+
+LatencyTest::LatencyTest() :
+	State( TEST_IDLE ),
+	StateTime( 0.0 ),
+	ClickTime( 0.0 ),
+	Baseline( 0.0f ),
+	StableFrames( 0 ),
+	Trials( 0 ),
+	Misses( 0 )
+
+{
+}
+
+void LatencyTest::Start( const double now )
+{
+	State = TEST_SETTLING;
+	StateTime = now;
+	StableFrames = 0;
+	Trials = 0;
+	Misses = 0;
+}
+
+void LatencyTest::Stop()
+{
+	State = TEST_IDLE;
+}
+
+bool LatencyTest::Update( const double now, const double frameTime, const float luminance, LatencyProbes & probes )
+{
+	switch ( State )
+	{
+		case TEST_IDLE:
+			return false;
+
+		case TEST_SETTLING:
+			if ( StableFrames > 0 && fabsf( luminance - Baseline ) < TEST_STABLE_THRESHOLD )
+			{
+				StableFrames++;
+			}
+			else
+			{
+				StableFrames = 1;
+			}
+			Baseline = luminance;
+
+			if ( StableFrames >= TEST_STABLE_FRAMES && frameTime - StateTime > TEST_MIN_CLICK_SPACING )
+			{
+				State = TEST_WAITING;
+				StateTime = now;
+				ClickTime = now;
+				return true;
+			}
+			return false;
+
+		case TEST_WAITING:
+			if ( frameTime <= ClickTime )
+			{
+				// latched before the click went out
+				return false;
+			}
+			if ( fabsf( luminance - Baseline ) > TEST_CHANGE_THRESHOLD )
+			{
+				probes.AddEndToEnd( (float)( ( frameTime - ClickTime ) * 1000.0 ) );
+				Trials++;
+			}
+			else if ( frameTime - ClickTime > TEST_TIMEOUT_SECONDS )
+			{
+				Misses++;
+			}
+			else
+			{
+				return false;
+			}
+
+			StableFrames = 0;
+			StateTime = frameTime;
+			State = ( Trials + Misses >= TEST_MAX_TRIALS ) ? TEST_IDLE : TEST_SETTLING;
+			return false;
+	}
+	return false;
+}
+
+} // namespace VRMatterStreamTheater
@@ -0,0 +1,137 @@
+/************************************************************************************
+
+Filename    :   LatencyProbes.h
+Content     :	Timestamped probes along the input to photon path
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( LatencyProbes_h )
+#define LatencyProbes_h
+
+#include "Kernel/OVR_Types.h"
+
+namespace VRMatterStreamTheater {
+
+enum LatencyInterval
+{
+	LATENCY_INPUT_TO_SEND,		// input sampled in CheckInput -> first mouse/key JNI call for it
+	LATENCY_SEND_TO_LATCH,		// event sent -> next new stream frame latched (a lower bound, the frame may predate the event)
+	LATENCY_LATCH_TO_COPY,		// frame latched -> copy and mip generation submitted
+	LATENCY_COPY_TO_SUBMIT,		// copy submitted -> both eyes drawn
+	LATENCY_END_TO_END,			// latency test: injected click -> first frame showing a change
+	LATENCY_INTERVAL_COUNT
+};
+
+//==============================================================
+// LatencyHistogram
+// Rolling window of the most recent samples, in milliseconds
+class LatencyHistogram
+{
+public:
+	static const int	MAX_SAMPLES = 512;
+
+						LatencyHistogram();
+
+	void				Reset();
+	void				AddSample( const float ms );
+
+	int					GetCount() const { return Count; }
+	int					GetTotal() const { return Total; }
+	// p in 0-100, sorts a copy of the window so only call it when reporting
+	float				GetPercentile( const float p ) const;
+
+private:
+	float				Samples[MAX_SAMPLES];
+	int					Next;
+	int					Count;
+	int					Total;
+};
+
+//==============================================================
+// LatencyProbes
+// Each probe is called with vrapi_GetTimeInSeconds() at its stage.
+// Only the oldest outstanding event is followed through the pipeline,
+// later ones are folded into it until a frame arrives.
+class LatencyProbes
+{
+public:
+						LatencyProbes();
+
+	void				Reset();
+
+	void				InputSampled( const double time );
+	void				EventSent( const double time );
+	void				FrameLatched( const double time );
+	void				CopyDone( const double time );
+	void				FrameSubmitted( const double time );
+	void				AddEndToEnd( const float ms );
+
+	double				GetLastLatchTime() const { return LastLatchTime; }
+
+	const LatencyHistogram &	GetHistogram( const LatencyInterval interval ) const { return Histograms[interval]; }
+	static const char *	GetIntervalName( const LatencyInterval interval );
+
+	// one line per interval with p50/p95/p99
+	void				GetSummary( char * buffer, const int bufferSize ) const;
+	bool				WriteReport( const char * path ) const;
+
+private:
+	double				InputTime;		// 0 when there is nothing outstanding
+	double				SentTime;
+	double				LatchTime;
+	double				CopyTime;
+	double				LastLatchTime;
+
+	LatencyHistogram	Histograms[LATENCY_INTERVAL_COUNT];
+
+	void				AddInterval( const LatencyInterval interval, const double start, const double end );
+};
+
+//==============================================================
+// LatencyTest
+// Injects clicks and watches the luminance of part of the stream for
+// the change they cause.  Needs something on the host that changes the
+// picture on click, like a paint program or a test page.
+class LatencyTest
+{
+public:
+						LatencyTest();
+
+	void				Start( const double now );
+	void				Stop();
+	bool				IsRunning() const { return State != TEST_IDLE; }
+	int					GetTrials() const { return Trials; }
+	int					GetMisses() const { return Misses; }
+
+	// Call with the region's mean luminance for every new frame, stamped
+	// with the time it was latched.  Returns true when a click should be
+	// sent, right away, since now is taken as the click time.
+	bool				Update( const double now, const double frameTime, const float luminance, LatencyProbes & probes );
+
+private:
+	enum TestState
+	{
+		TEST_IDLE,
+		TEST_SETTLING,		// waiting for the picture to hold still
+		TEST_WAITING		// clicked, waiting for the change
+	};
+
+	TestState			State;
+	double				StateTime;
+	double				ClickTime;
+	float				Baseline;
+	int					StableFrames;
+	int					Trials;
+	int					Misses;
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // LatencyProbes_h
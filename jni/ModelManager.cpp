@@ -13,11 +13,15 @@ of patent rights can be found in the PATENTS file in the same directory.
 
 *************************************************************************************/
 
-#include <dirent.h>
 #include "Kernel/OVR_String_Utils.h"
 #include "ModelManager.h"
 #include "CinemaApp.h"
 #include "PackageFiles.h"
+#include "Native.h"
+#include "TaskScheduler.h"
+#include "TraceRecorder.h"
+
+#include <unistd.h>
 
 
 namespace VRMatterStreamTheater {
@@ -26,13 +30,125 @@ static const char * TheatersDirectory = "Oculus/Cinema/Theaters";
 
 //=======================================================================================
 
+// One theater on its way in.  The files are read on a worker, the scene is
+// made from them on the GL thread: the SDK parses the model and decodes its
+// textures in the same calls that upload them.
+struct TheaterLoad
+{
+	String				SceneFilename;		// as asked for, kept in the SceneDef
+	String				ScenePath;			// empty for the scenes without a model
+	String				IconPath;
+	bool				FromPackage;
+	bool				UseDynamicProgram;
+	bool				UseScreenGeometry;
+	bool				UseSeats;
+	bool				UseFreeScreen;
+	bool				UseVRScreen;
+	SceneDef **			Keep;				// VoidScene or VRScene for those two
+	MemBufferFile		Scene;
+	MemBufferFile		Icon;
+	int					Read;				// set once the files are in, atomically
+
+						TheaterLoad() :
+							SceneFilename(),
+							ScenePath(),
+							IconPath(),
+							FromPackage( false ),
+							UseDynamicProgram( false ),
+							UseScreenGeometry( false ),
+							UseSeats( true ),
+							UseFreeScreen( false ),
+							UseVRScreen( false ),
+							Keep( NULL ),
+							Scene( MemBufferFile::NoInit ),
+							Icon( MemBufferFile::NoInit ),
+							Read( 0 ) {}
+};
+
+static void ReadTheaterFile( void * package, const String & path, MemBufferFile & file )
+{
+	if ( path.IsEmpty() )
+	{
+		return;
+	}
+
+	if ( package == NULL )
+	{
+		file.LoadFile( path.ToCStr() );
+		return;
+	}
+
+	int length = 0;
+	void * buffer = NULL;
+	if ( ovr_ReadFileFromOtherApplicationPackage( package, path.ToCStr(), length, buffer ) )
+	{
+		file.Buffer = buffer;
+		file.Length = length;
+	}
+}
+
+// The apk is opened again for every read, the SDK's own handle on it is
+// used from the GL thread and can't be shared.
+static void ReadTheater( TheaterLoad & load, const String & packagePath )
+{
+	TRACE_SCOPE( "ReadTheater" );
+
+	void * package = NULL;
+	if ( load.FromPackage )
+	{
+		package = ovr_OpenOtherApplicationPackage( packagePath.ToCStr() );
+		if ( package == NULL )
+		{
+			LOG( "ReadTheater: couldn't open %s", packagePath.ToCStr() );
+		}
+	}
+
+	if ( !load.FromPackage || package != NULL )
+	{
+		ReadTheaterFile( package, load.ScenePath, load.Scene );
+		ReadTheaterFile( package, load.IconPath, load.Icon );
+	}
+
+	if ( package != NULL )
+	{
+		ovr_CloseOtherApplicationPackage( package );
+	}
+	__atomic_store_n( &load.Read, 1, __ATOMIC_RELEASE );
+}
+
+class TheaterReadTask : public BackgroundTask
+{
+public:
+						TheaterReadTask( TheaterLoad & load, const String & packagePath ) :
+							BackgroundTask( TASK_PRIORITY_NORMAL, NULL ),
+							Load( load ),
+							PackagePath( packagePath ) {}
+
+	virtual void		Run() { ReadTheater( Load, PackagePath ); }
+
+	// dropped at shutdown, nothing will come for it
+	virtual void		Finish() { if ( IsCancelled() ) { __atomic_store_n( &Load.Read, 1, __ATOMIC_RELEASE ); } }
+
+private:
+	TheaterLoad &		Load;
+	String				PackagePath;
+};
+
+//=======================================================================================
+
 ModelManager::ModelManager( CinemaApp &cinema ) :
 	Cinema( cinema ),
 	Theaters(),
 	BoxOffice( NULL ),
 	VoidScene( NULL ),
+	VRScene( NULL ),
 	LaunchIntent(),
-	DefaultSceneModel( NULL )
+	DefaultSceneModel( NULL ),
+	PackagePath(),
+	TheatersQueued( false ),
+	TheatersScanned( false ),
+	TheaterLoads(),
+	TheatersLoaded( false )
 
 {
 }
@@ -44,14 +160,16 @@ ModelManager::~ModelManager()
 void ModelManager::OneTimeInit( const char * launchIntent )
 {
 	LOG( "ModelManager::OneTimeInit" );
+	TRACE_SCOPE( "ModelManager::OneTimeInit" );
 	const double start = vrapi_GetTimeInSeconds();
 	LaunchIntent = launchIntent;
+	PackagePath = Native::GetPackageCodePath( Cinema.app );
 
 	DefaultSceneModel = new ModelFile( "default" );
 
-	LoadModels();
+	LoadLobby();
 
-	LOG( "ModelManager::OneTimeInit: %i theaters loaded, %3.1f seconds", Theaters.GetSizeI(), vrapi_GetTimeInSeconds() - start );
+	LOG( "ModelManager::OneTimeInit: %3.1f seconds", vrapi_GetTimeInSeconds() - start );
 }
 
 void ModelManager::OneTimeShutdown()
@@ -64,104 +182,146 @@ void ModelManager::OneTimeShutdown()
 	{
 		delete Theaters[ i ];
 	}
+
+	// the workers are gone by now
+	for ( int i = 0; i < TheaterLoads.GetSizeI(); i++ )
+	{
+		delete TheaterLoads[i];
+	}
+	TheaterLoads.Clear();
 }
 
-void ModelManager::LoadModels()
+// the lobby is on the first frame, nothing to wait for it on
+void ModelManager::LoadLobby()
 {
-	LOG( "ModelManager::LoadModels" );
-	const double start = vrapi_GetTimeInSeconds();
+	LOG( "ModelManager::LoadLobby" );
 
-	BoxOffice = LoadScene( "assets/scenes/stlobby.ovrscene", false, true, true );
-	BoxOffice->UseSeats = false;
+	TheaterLoad * load = NewTheaterLoad( "assets/scenes/stlobby.ovrscene", false, true, true );
+	load->UseSeats = false;
+	ReadTheater( *load, PackagePath );
+	BoxOffice = CreateTheater( *load );
 	BoxOffice->LobbyScreen = true;
+	delete load;
+}
 
-	if ( LaunchIntent.GetLength() > 0 )
+// The theaters come in after the lobby is up.  The first call queues the
+// reads of ours, later ones make a theater whenever the next one in line
+// has been read, or scan the sdcard while they wait.  The order is the
+// same as loading them all at once: ours first, then whatever is on the
+// sdcard.
+bool ModelManager::LoadNextTheater( const bool wait )
+{
+	if ( TheatersLoaded )
 	{
-		Theaters.PushBack( LoadScene( LaunchIntent.ToCStr(), true, true, false ) );
+		return true;
 	}
-	else
-	{
-		// we want our theaters to show up first
-		Theaters.PushBack( LoadScene( "assets/scenes/home_theater.ovrscene", true, false, true ) );
-
-		SceneDef* freescreenscene = LoadScene( "assets/scenes/Galaxy.ovrscene", true, false, true );
-		freescreenscene->UseFreeScreen = true;
-		Theaters.PushBack( freescreenscene );
-
-		SceneDef* freescreenscene2 = LoadScene( "assets/scenes/SubTheater.ovrscene", true, false, true );
-		freescreenscene2->UseFreeScreen = true;
-		Theaters.PushBack( freescreenscene2 );
-
-		int width = 0, height = 0;
-
-		// create void scene
-		VoidScene = new SceneDef();
-		VoidScene->SceneModel = new ModelFile( "Void" );
-		VoidScene->UseSeats = false;
-		VoidScene->UseDynamicProgram = false;
-		VoidScene->UseScreenGeometry = false;
-		VoidScene->UseFreeScreen = true;
-
-		VoidScene->IconTexture = LoadTextureFromApplicationPackage( "assets/VoidTheater.png",
-				TextureFlags_t( TEXTUREFLAG_NO_DEFAULT ), width, height );
 
-		BuildTextureMipmaps( VoidScene->IconTexture );
-		MakeTextureTrilinear( VoidScene->IconTexture );
-		MakeTextureClamped( VoidScene->IconTexture );
+	TRACE_SCOPE( "ModelManager::LoadNextTheater" );
 
-		Theaters.PushBack( VoidScene );
-
-		// create void scene
-		VRScene = new SceneDef();
-		VRScene->SceneModel = new ModelFile( "VR" );
-		VRScene->UseSeats = false;
-		VRScene->UseDynamicProgram = false;
-		VRScene->UseScreenGeometry = false;
-		VRScene->UseFreeScreen = true;
-		VRScene->UseVRScreen = true;
-
-		VRScene->IconTexture = LoadTextureFromApplicationPackage( "assets/VRTheater.png",
-				TextureFlags_t( TEXTUREFLAG_NO_DEFAULT ), width, height );
-
-		BuildTextureMipmaps( VRScene->IconTexture );
-		MakeTextureTrilinear( VRScene->IconTexture );
-		MakeTextureClamped( VRScene->IconTexture );
+	if ( !TheatersQueued )
+	{
+		TheatersQueued = true;
+		if ( LaunchIntent.GetLength() > 0 )
+		{
+			QueueTheater( NewTheaterLoad( LaunchIntent.ToCStr(), true, true, false ) );
+			TheatersScanned = true;
+		}
+		else
+		{
+			QueueBuiltInTheaters();
+		}
+	}
+	else if ( TheaterLoads.GetSizeI() > 0 && ( wait || __atomic_load_n( &TheaterLoads[0]->Read, __ATOMIC_ACQUIRE ) ) )
+	{
+		TheaterLoad * load = TheaterLoads[0];
+		while ( !__atomic_load_n( &load->Read, __ATOMIC_ACQUIRE ) )
+		{
+			usleep( 1000 );
+		}
+		Theaters.PushBack( CreateTheater( *load ) );
+		TheaterLoads.RemoveAt( 0 );
+		delete load;
+	}
+	else if ( !TheatersScanned )
+	{
+		TheatersScanned = true;
+		Array<String> scenes;
+		for ( int i = 0; i < Cinema.Paths.GetNumRoots(); i++ )
+		{
+			String directory = Cinema.Paths.GetRoot( i );
+			directory.AppendString( "/" );
+			directory.AppendString( TheatersDirectory );
+			ScanDirectoryForScenes( directory.ToCStr(), scenes );
+		}
+		for ( int i = 0; i < scenes.GetSizeI(); i++ )
+		{
+			QueueTheater( NewTheaterLoad( scenes[i].ToCStr(), true, false, false ) );
+		}
+	}
 
-		Theaters.PushBack( VRScene );
-//*/
-		// load all scenes on startup, so there isn't a delay when switching theaters
-		ScanDirectoryForScenes( Cinema.ExternalRetailDir( TheatersDirectory ), true, false, Theaters );
-		ScanDirectoryForScenes( Cinema.RetailDir( TheatersDirectory ), true, false, Theaters );
-		ScanDirectoryForScenes( Cinema.SDCardDir( TheatersDirectory ), true, false, Theaters );
+	if ( TheatersScanned && TheaterLoads.GetSizeI() == 0 )
+	{
+		TheatersLoaded = true;
+		LOG( "ModelManager::LoadNextTheater: %i theaters loaded", Theaters.GetSizeI() );
 	}
+	return TheatersLoaded;
+}
+
+void ModelManager::QueueTheater( TheaterLoad * load )
+{
+	TheaterLoads.PushBack( load );
+	Cinema.Tasks.Submit( new TheaterReadTask( *load, PackagePath ) );
+}
 
-	LOG( "ModelManager::LoadModels: %i theaters loaded, %3.1f seconds", Theaters.GetSizeI(), vrapi_GetTimeInSeconds() - start );
+// we want our theaters to show up first
+void ModelManager::QueueBuiltInTheaters()
+{
+	QueueTheater( NewTheaterLoad( "assets/scenes/home_theater.ovrscene", true, false, true ) );
+
+	TheaterLoad * galaxy = NewTheaterLoad( "assets/scenes/Galaxy.ovrscene", true, false, true );
+	galaxy->UseFreeScreen = true;
+	QueueTheater( galaxy );
+
+	TheaterLoad * sub = NewTheaterLoad( "assets/scenes/SubTheater.ovrscene", true, false, true );
+	sub->UseFreeScreen = true;
+	QueueTheater( sub );
+
+	// the void and VR scenes are only an icon
+	TheaterLoad * voidScene = new TheaterLoad();
+	voidScene->SceneFilename = "Void";
+	voidScene->IconPath = "assets/VoidTheater.png";
+	voidScene->FromPackage = true;
+	voidScene->UseSeats = false;
+	voidScene->UseFreeScreen = true;
+	voidScene->Keep = &VoidScene;
+	QueueTheater( voidScene );
+
+	TheaterLoad * vrScene = new TheaterLoad();
+	vrScene->SceneFilename = "VR";
+	vrScene->IconPath = "assets/VRTheater.png";
+	vrScene->FromPackage = true;
+	vrScene->UseSeats = false;
+	vrScene->UseFreeScreen = true;
+	vrScene->UseVRScreen = true;
+	vrScene->Keep = &VRScene;
+	QueueTheater( vrScene );
 }
 
-void ModelManager::ScanDirectoryForScenes( const char * directory, bool useDynamicProgram, bool useScreenGeometry, Array<SceneDef *> &scenes ) const
+void ModelManager::ScanDirectoryForScenes( const char * directory, Array<String> &scenes ) const
 {
-	DIR * dir = opendir( directory );
-	if ( dir != NULL )
+	Array<String> filenames;
+	Cinema.Paths.ListDirectory( directory, ".ovrscene", filenames );
+	for ( int i = 0; i < filenames.GetSizeI(); i++ )
 	{
-		struct dirent * entry;
-		while( ( entry = readdir( dir ) ) != NULL ) {
-			String filename = entry->d_name;
-			String ext = filename.GetExtension().ToLower();
-			if ( ( ext == ".ovrscene" ) )
-			{
-				String fullpath = directory;
-				fullpath.AppendString( "/" );
-				fullpath.AppendString( filename );
-				SceneDef *def = LoadScene( fullpath.ToCStr(), useDynamicProgram, useScreenGeometry, false );
-				scenes.PushBack( def );
-			}
-		}
-
-		closedir( dir );
+		String fullpath = directory;
+		fullpath.AppendString( "/" );
+		fullpath.AppendString( filenames[i] );
+		scenes.PushBack( fullpath );
 	}
 }
 
-SceneDef * ModelManager::LoadScene( const char *sceneFilename, bool useDynamicProgram, bool useScreenGeometry, bool loadFromApplicationPackage ) const
+// Works out where the scene is, the reading is left to ReadTheater.
+TheaterLoad * ModelManager::NewTheaterLoad( const char *sceneFilename, bool useDynamicProgram, bool useScreenGeometry, bool loadFromApplicationPackage ) const
 {
 	String filename;
 
@@ -179,54 +339,66 @@ SceneDef * ModelManager::LoadScene( const char *sceneFilename, bool useDynamicPr
 	{
 		filename = sceneFilename;
 	}
-	else if ( Cinema.FileExists( Cinema.ExternalRetailDir( sceneFilename ) ) )
-	{
-		filename = Cinema.ExternalRetailDir( sceneFilename );
-	}
-	else if ( Cinema.FileExists( Cinema.RetailDir( sceneFilename ) ) )
-	{
-		filename = Cinema.RetailDir( sceneFilename );
-	}
-	else
+	else if ( !Cinema.Paths.Resolve( sceneFilename, filename ) )
 	{
 		filename = Cinema.SDCardDir( sceneFilename );
 	}
 
 	LOG( "Adding scene: %s, %s", filename.ToCStr(), sceneFilename );
 
-	SceneDef *def = new SceneDef();
-	def->Filename = sceneFilename;
-	def->UseSeats = true;
-	def->UseDynamicProgram = useDynamicProgram;
-
-	MaterialParms materialParms;
-	materialParms.UseSrgbTextureFormats = Cinema.app->GetFramebufferIsSrgb();
-	// Improve the texture quality with anisotropic filtering.
-	materialParms.EnableDiffuseAniso = true;
-	// The emissive texture is used as a separate lighting texture and should not be LOD clamped.
-	materialParms.EnableEmissiveLodClamp = false;
-
-	ModelGlPrograms glPrograms = ( useDynamicProgram ) ? Cinema.ShaderMgr.DynamicPrograms : Cinema.ShaderMgr.DefaultPrograms;
+	TheaterLoad * load = new TheaterLoad();
+	load->SceneFilename = sceneFilename;
+	load->ScenePath = filename;
+	load->IconPath = StringUtils::SetFileExtensionString( filename.ToCStr(), "png" );
+	load->FromPackage = loadFromApplicationPackage;
+	load->UseDynamicProgram = useDynamicProgram;
+	load->UseScreenGeometry = useScreenGeometry;
+	return load;
+}
 
-	String iconFilename = StringUtils::SetFileExtensionString( filename.ToCStr(), "png" );
+// GL thread, once the files are read
+SceneDef * ModelManager::CreateTheater( TheaterLoad & load ) const
+{
+	TRACE_SCOPE( "ModelManager::CreateTheater" );
 
-	int textureWidth = 0, textureHeight = 0;
+	SceneDef *def = new SceneDef();
+	def->Filename = load.SceneFilename;
+	def->UseSeats = load.UseSeats;
+	def->UseDynamicProgram = load.UseDynamicProgram;
 
-	if ( loadFromApplicationPackage )
+	if ( load.ScenePath.IsEmpty() )
 	{
-		def->SceneModel = LoadModelFileFromApplicationPackage( filename.ToCStr(), glPrograms, materialParms );
-		def->IconTexture = LoadTextureFromApplicationPackage( iconFilename.ToCStr(), TextureFlags_t( TEXTUREFLAG_NO_DEFAULT ), textureWidth, textureHeight );
+		def->SceneModel = new ModelFile( load.SceneFilename.ToCStr() );
 	}
 	else
 	{
-		def->SceneModel = LoadModelFile( filename.ToCStr(), glPrograms, materialParms );
-		def->IconTexture = LoadTextureFromBuffer( iconFilename.ToCStr(), MemBufferFile( iconFilename.ToCStr() ),
-				TextureFlags_t( TEXTUREFLAG_NO_DEFAULT ), textureWidth, textureHeight );
+		MaterialParms materialParms;
+		materialParms.UseSrgbTextureFormats = Cinema.app->GetFramebufferIsSrgb();
+		// Improve the texture quality with anisotropic filtering.
+		materialParms.EnableDiffuseAniso = true;
+		// The emissive texture is used as a separate lighting texture and should not be LOD clamped.
+		materialParms.EnableEmissiveLodClamp = false;
+
+		ModelGlPrograms glPrograms = ( load.UseDynamicProgram ) ? Cinema.ShaderMgr.DynamicPrograms : Cinema.ShaderMgr.DefaultPrograms;
+
+		def->SceneModel = ( load.Scene.Length > 0 ) ? LoadModelFileFromMemory( load.ScenePath.ToCStr(),
+				load.Scene.Buffer, load.Scene.Length, glPrograms, materialParms ) : NULL;
+		if ( def->SceneModel == NULL )
+		{
+			LOG( "Couldn't read scene %s", load.ScenePath.ToCStr() );
+			def->SceneModel = new ModelFile( load.SceneFilename.ToCStr() );
+		}
 	}
+	load.Scene.FreeData();
+
+	int textureWidth = 0, textureHeight = 0;
+	def->IconTexture = ( load.Icon.Length > 0 ) ? LoadTextureFromBuffer( load.IconPath.ToCStr(), load.Icon,
+			TextureFlags_t( TEXTUREFLAG_NO_DEFAULT ), textureWidth, textureHeight ) : 0;
+	load.Icon.FreeData();
 
 	if ( def->IconTexture != 0 )
 	{
-		LOG( "Loaded external icon for theater: %s", iconFilename.ToCStr() );
+		LOG( "Loaded external icon for theater: %s", load.IconPath.ToCStr() );
 	}
 	else
 	{
@@ -249,8 +421,13 @@ SceneDef * ModelManager::LoadScene( const char *sceneFilename, bool useDynamicPr
 	MakeTextureTrilinear( def->IconTexture );
 	MakeTextureClamped( def->IconTexture );
 
-	def->UseScreenGeometry = useScreenGeometry;
-	def->UseFreeScreen = false;
+	def->UseScreenGeometry = load.UseScreenGeometry;
+	def->UseFreeScreen = load.UseFreeScreen;
+	def->UseVRScreen = load.UseVRScreen;
+	if ( load.Keep != NULL )
+	{
+		*load.Keep = def;
+	}
 
 	return def;
 }
@@ -25,6 +25,7 @@ using namespace OVR;
 namespace VRMatterStreamTheater {
 
 class CinemaApp;
+struct TheaterLoad;
 
 class SceneDef
 {
@@ -64,6 +65,12 @@ public:
 
 	bool 				Command( const char * msg );
 
+	// The theater files are read on the workers, each call makes at most
+	// one theater from them, in order.  True once they are all loaded.
+	// wait blocks until the next one has been read instead of returning.
+	bool				LoadNextTheater( const bool wait );
+	bool				AreTheatersLoaded() const { return TheatersLoaded; }
+
 	UPInt				GetTheaterCount() const { return Theaters.GetSize(); }
 	const SceneDef & 	GetTheater( UPInt index ) const;
 
@@ -80,9 +87,18 @@ public:
 	ModelFile *			DefaultSceneModel;
 
 private:
-	void 				LoadModels();
-	void 				ScanDirectoryForScenes( const char * directory, bool useDynamicProgram, bool useScreenGeometry, Array<SceneDef *> &scenes ) const;
-	SceneDef *			LoadScene( const char *filename, bool useDynamicProgram, bool useScreenGeometry, bool loadFromApplicationPackage ) const;
+	String				PackagePath;		// the apk, each read opens its own handle on it
+	bool				TheatersQueued;		// the built in ones, or the launch intent
+	bool				TheatersScanned;	// the ones on the sdcard
+	Array<TheaterLoad *>	TheaterLoads;		// being read or waiting to be made, in order
+	bool				TheatersLoaded;
+
+	void 				LoadLobby();
+	void				QueueBuiltInTheaters();
+	void				QueueTheater( TheaterLoad * load );
+	void 				ScanDirectoryForScenes( const char * directory, Array<String> &scenes ) const;
+	TheaterLoad *		NewTheaterLoad( const char *filename, bool useDynamicProgram, bool useScreenGeometry, bool loadFromApplicationPackage ) const;
+	SceneDef *			CreateTheater( TheaterLoad & load ) const;
 };
 
 } // namespace VRMatterStreamTheater
@@ -0,0 +1,304 @@
+/************************************************************************************
+
+Filename    :   MotionCalibration.cpp
+Content     :	Automatic VR screen calibration from head motion and image motion
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "MotionCalibration.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+namespace VRMatterStreamTheater {
+
+// frames with less average contrast than this can't be matched reliably
+static const float	MIN_TEXTURE				= 2.0f;
+// the best match must beat the zero shift by this fraction to count as motion
+static const float	MIN_MATCH_IMPROVEMENT	= 0.1f;
+// head motion below this between two frames is just noise
+static const float	MIN_HEAD_DELTA			= 0.0005f;
+static const float	MIN_CORRELATION			= 0.5f;
+
+//==============================================================
+// GlobalMotionEstimator
+
+float GlobalMotionEstimator::MatchCost( const unsigned char * previous, const unsigned char * current,
+		const int width, const int height, const int margin, const int dx, const int dy )
+{
+	// Only the interior is compared, so every candidate shift sees the same
+	// number of pixels and the inner loop has no bounds checks.
+	int sum = 0;
+	for ( int y = margin; y < height - margin; y++ )
+	{
+		const unsigned char * cur = current + y * width + margin;
+		const unsigned char * prev = previous + ( y - dy ) * width + margin - dx;
+		const int count = width - margin * 2;
+		for ( int x = 0; x < count; x++ )
+		{
+			sum += abs( (int)cur[x] - (int)prev[x] );
+		}
+	}
+	const int pixels = ( width - margin * 2 ) * ( height - margin * 2 );
+	return pixels > 0 ? (float)sum / pixels : 0.0f;
+}
+
+// Offset of the minimum of a symmetric V through three evenly spaced costs.
+// Absolute differences grow linearly away from the true shift, so this
+// fits them better than a parabola.
+static float SubPixelOffset( const float before, const float center, const float after )
+{
+	const float rise = ( before > after ? before : after ) - center;
+	if ( rise <= 0.0f )
+	{
+		return 0.0f;
+	}
+	const float offset = 0.5f * ( before - after ) / rise;
+	return offset < -0.5f ? -0.5f : ( offset > 0.5f ? 0.5f : offset );
+}
+
+bool GlobalMotionEstimator::EstimateShift( const unsigned char * previous, const unsigned char * current,
+		const int width, const int height, const int searchRadius, float & shiftX, float & shiftY )
+{
+	shiftX = 0.0f;
+	shiftY = 0.0f;
+
+	const int margin = searchRadius + 1;
+	if ( width <= margin * 4 || height <= margin * 4 )
+	{
+		return false;
+	}
+
+	// flat frames (fades, loading screens) match everywhere
+	float texture = 0.0f;
+	{
+		int sum = 0;
+		for ( int y = margin; y < height - margin; y++ )
+		{
+			const unsigned char * row = current + y * width;
+			for ( int x = margin; x < width - margin; x++ )
+			{
+				sum += abs( (int)row[x] - (int)row[x - 1] ) + abs( (int)row[x] - (int)row[x - width] );
+			}
+		}
+		texture = (float)sum / ( ( width - margin * 2 ) * ( height - margin * 2 ) * 2 );
+	}
+	if ( texture < MIN_TEXTURE )
+	{
+		return false;
+	}
+
+	const int size = searchRadius * 2 + 1;
+	Array<float> costs;
+	costs.Resize( size * size );
+
+	int bestX = 0;
+	int bestY = 0;
+	float bestCost = 1e10f;
+	for ( int dy = -searchRadius; dy <= searchRadius; dy++ )
+	{
+		for ( int dx = -searchRadius; dx <= searchRadius; dx++ )
+		{
+			const float cost = MatchCost( previous, current, width, height, margin, dx, dy );
+			costs[( dy + searchRadius ) * size + dx + searchRadius] = cost;
+			if ( cost < bestCost )
+			{
+				bestCost = cost;
+				bestX = dx;
+				bestY = dy;
+			}
+		}
+	}
+
+	const float zeroCost = costs[searchRadius * size + searchRadius];
+	if ( bestX == 0 && bestY == 0 )
+	{
+		// no motion is a valid answer as long as it's a clear minimum
+		return true;
+	}
+	if ( bestCost > zeroCost * ( 1.0f - MIN_MATCH_IMPROVEMENT ) )
+	{
+		return false;
+	}
+
+	// a match on the edge of the search window may be a wrapped repeat pattern or too fast to measure
+	if ( abs( bestX ) == searchRadius || abs( bestY ) == searchRadius )
+	{
+		return false;
+	}
+
+	const int center = ( bestY + searchRadius ) * size + bestX + searchRadius;
+	shiftX = bestX + SubPixelOffset( costs[center - 1], costs[center], costs[center + 1] );
+	shiftY = bestY + SubPixelOffset( costs[center - size], costs[center], costs[center + size] );
+	return true;
+}
+
+//==============================================================
+// MotionCalibration
+
+MotionCalibration::MotionCalibration() :
+	Poses(),
+	Frames(),
+	LastFrameTime( 0 ),
+	HeadTravel( 0.0f )
+
+{
+}
+
+void MotionCalibration::Reset()
+{
+	Poses.Clear();
+	Frames.Clear();
+	LastFrameTime = 0;
+	HeadTravel = 0.0f;
+}
+
+static float WrapAngle( float angle )
+{
+	if ( angle > M_PI ) angle -= 2 * M_PI;
+	if ( angle < -M_PI ) angle += 2 * M_PI;
+	return angle;
+}
+
+void MotionCalibration::AddPose( const long time, const float yaw, const float pitch )
+{
+	if ( Poses.GetSizeI() > 0 )
+	{
+		const PoseSample & last = Poses.Back();
+		if ( time <= last.Time )
+		{
+			return;
+		}
+		HeadTravel += fabsf( WrapAngle( yaw - last.Yaw ) ) + fabsf( pitch - last.Pitch );
+	}
+
+	PoseSample sample;
+	sample.Time = time;
+	sample.Yaw = yaw;
+	sample.Pitch = pitch;
+	Poses.PushBack( sample );
+}
+
+void MotionCalibration::AddFrame( const long time, const float rotationX, const float rotationY )
+{
+	if ( LastFrameTime != 0 && time > LastFrameTime )
+	{
+		FrameSample sample;
+		sample.Time = time;
+		sample.PreviousTime = LastFrameTime;
+		sample.RotationX = rotationX;
+		sample.RotationY = rotationY;
+		Frames.PushBack( sample );
+	}
+	LastFrameTime = time;
+}
+
+bool MotionCalibration::PoseAtTime( const long time, float & yaw, float & pitch ) const
+{
+	const int count = Poses.GetSizeI();
+	if ( count < 2 || time < Poses[0].Time || time > Poses[count - 1].Time )
+	{
+		return false;
+	}
+
+	// binary search for the pair around time
+	int low = 0;
+	int high = count - 1;
+	while ( high - low > 1 )
+	{
+		const int mid = ( low + high ) / 2;
+		if ( Poses[mid].Time <= time )
+		{
+			low = mid;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	const PoseSample & a = Poses[low];
+	const PoseSample & b = Poses[high];
+	const float f = ( b.Time > a.Time ) ? (float)( time - a.Time ) / ( b.Time - a.Time ) : 0.0f;
+	yaw = a.Yaw + WrapAngle( b.Yaw - a.Yaw ) * f;
+	pitch = a.Pitch + ( b.Pitch - a.Pitch ) * f;
+	return true;
+}
+
+bool MotionCalibration::Solve( const long minLatency, const long maxLatency, const long latencyStep, MotionCalibrationResult & result ) const
+{
+	result = MotionCalibrationResult();
+	if ( Frames.GetSizeI() < MIN_SAMPLES || latencyStep <= 0 )
+	{
+		return false;
+	}
+
+	float bestScore = -1.0f;
+	for ( long latency = minLatency; latency <= maxLatency; latency += latencyStep )
+	{
+		// sums for the correlation and the least squares fit of image = gain * head, per axis
+		double hxx = 0, ixx = 0, hix = 0;
+		double hyy = 0, iyy = 0, hiy = 0;
+		int samples = 0;
+
+		for ( int i = 0; i < Frames.GetSizeI(); i++ )
+		{
+			const FrameSample & frame = Frames[i];
+			float y0, p0, y1, p1;
+			if ( !PoseAtTime( frame.PreviousTime - latency, y0, p0 ) || !PoseAtTime( frame.Time - latency, y1, p1 ) )
+			{
+				continue;
+			}
+			const double headX = WrapAngle( y1 - y0 );
+			const double headY = p1 - p0;
+
+			hxx += headX * headX;
+			ixx += frame.RotationX * frame.RotationX;
+			hix += headX * frame.RotationX;
+			hyy += headY * headY;
+			iyy += frame.RotationY * frame.RotationY;
+			hiy += headY * frame.RotationY;
+			samples++;
+		}
+
+		if ( samples < MIN_SAMPLES )
+		{
+			continue;
+		}
+
+		// weight each axis by how much the head actually moved along it,
+		// since people turn far more than they nod
+		const bool useX = hxx > MIN_HEAD_DELTA * MIN_HEAD_DELTA * samples && ixx > 0.0;
+		const bool useY = hyy > MIN_HEAD_DELTA * MIN_HEAD_DELTA * samples && iyy > 0.0;
+		if ( !useX && !useY )
+		{
+			continue;
+		}
+		const float corrX = useX ? (float)( fabs( hix ) / sqrt( hxx * ixx ) ) : 0.0f;
+		const float corrY = useY ? (float)( fabs( hiy ) / sqrt( hyy * iyy ) ) : 0.0f;
+		const double weightX = useX ? hxx : 0.0;
+		const double weightY = useY ? hyy : 0.0;
+		const float score = (float)( ( corrX * weightX + corrY * weightY ) / ( weightX + weightY ) );
+
+		if ( score > bestScore )
+		{
+			bestScore = score;
+			result.Latency = latency;
+			result.YawGain = useX ? (float)fabs( hix / hxx ) : 0.0f;
+			result.PitchGain = useY ? (float)fabs( hiy / hyy ) : 0.0f;
+			result.Correlation = score;
+			result.Samples = samples;
+		}
+	}
+
+	return bestScore >= MIN_CORRELATION;
+}
+
+} // namespace VRMatterStreamTheater
@@ -0,0 +1,109 @@
+/************************************************************************************
+
+Filename    :   MotionCalibration.h
+Content     :	Automatic VR screen calibration from head motion and image motion
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( MotionCalibration_h )
+#define MotionCalibration_h
+
+// Only the kernel types are used here, so the estimator and the solver
+// can be exercised on synthetic data without a device.
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_Array.h"
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+//==============================================================
+// GlobalMotionEstimator
+// Estimates the translation of a whole image between two small
+// luminance frames by exhaustive block matching over the overlap.
+class GlobalMotionEstimator
+{
+public:
+	// returns false when the frames don't have enough texture to match,
+	// or the best match isn't clearly better than the alternatives.
+	// shiftX/Y are in pixels, positive when content moved right/up (in row order)
+	static bool		EstimateShift( const unsigned char * previous, const unsigned char * current,
+							const int width, const int height, const int searchRadius,
+							float & shiftX, float & shiftY );
+
+	// mean absolute difference of current against previous shifted by (dx, dy)
+	static float	MatchCost( const unsigned char * previous, const unsigned char * current,
+							const int width, const int height, const int margin,
+							const int dx, const int dy );
+};
+
+struct MotionCalibrationResult
+{
+	long	Latency;		// same units as the pose timestamps
+	float	YawGain;		// image rotation per head rotation at the current settings
+	float	PitchGain;
+	float	Correlation;	// 0-1, how well head motion explains image motion
+	int		Samples;
+
+			MotionCalibrationResult() : Latency( 0 ), YawGain( 0.0f ), PitchGain( 0.0f ), Correlation( 0.0f ), Samples( 0 ) {}
+};
+
+//==============================================================
+// MotionCalibration
+// Correlates the head yaw/pitch history with the measured image
+// motion of each stream frame, and solves for the delay between
+// them and the gain from head rotation to image rotation.
+class MotionCalibration
+{
+public:
+	static const int	MIN_SAMPLES = 60;
+
+						MotionCalibration();
+
+	void				Reset();
+
+	// yaw and pitch in radians, time in pose timestamp units
+	void				AddPose( const long time, const float yaw, const float pitch );
+	// image rotation in radians between the previous frame and the one with this timestamp
+	void				AddFrame( const long time, const float rotationX, const float rotationY );
+
+	int					GetNumFrames() const { return Frames.GetSizeI(); }
+	// total head rotation seen so far, used to tell the user to keep moving
+	float				GetHeadTravel() const { return HeadTravel; }
+
+	bool				Solve( const long minLatency, const long maxLatency, const long latencyStep, MotionCalibrationResult & result ) const;
+
+private:
+	struct PoseSample
+	{
+		long	Time;
+		float	Yaw;
+		float	Pitch;
+	};
+
+	struct FrameSample
+	{
+		long	Time;
+		long	PreviousTime;
+		float	RotationX;
+		float	RotationY;
+	};
+
+	Array<PoseSample>	Poses;
+	Array<FrameSample>	Frames;
+	long				LastFrameTime;
+	float				HeadTravel;
+
+	bool				PoseAtTime( const long time, float & yaw, float & pitch ) const;
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // MotionCalibration_h
@@ -24,6 +24,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "Kernel/OVR_String_Utils.h"
 
 #include "CinemaStrings.h"
+#include "TraceRecorder.h"
 
 namespace VRMatterStreamTheater
 {
@@ -57,6 +58,8 @@ MoviePlayerView::MoviePlayerView( CinemaApp &cinema ) :
 	MoveScreenMenu( NULL ),
 	MoveScreenLabel( Cinema ),
 	MoveScreenAlpha(),
+	CalibrationMenu( NULL ),
+	CalibrationLabel( Cinema ),
 	PlaybackControlsMenu( NULL ),
 	PlaybackControlsPosition( Cinema ),
 	PlaybackControlsScale( Cinema ),
@@ -109,6 +112,8 @@ MoviePlayerView::MoviePlayerView( CinemaApp &cinema ) :
 	Button30FPS( Cinema ),
 	ButtonHostAudio( Cinema ),
 	ButtonApply( Cinema ),
+	ButtonAdaptive( Cinema ),
+	AdaptiveStatus( Cinema ),
 	BitrateAdjust( Cinema ),
 	BitrateSliderBackground( Cinema ),
 	BitrateSliderIndicator( Cinema ),
@@ -121,6 +126,7 @@ MoviePlayerView::MoviePlayerView( CinemaApp &cinema ) :
 	ButtonSBSRift( Cinema ),
 	ButtonSBSCrop( Cinema ),
 	ButtonSBSScale( Cinema ),
+	ButtonSBSAuto( Cinema ),
 	ButtonChangeSeat( Cinema ),
 	ScreenDistance( Cinema ),
 	DistanceSliderBackground( Cinema ),
@@ -137,9 +143,11 @@ MoviePlayerView::MoviePlayerView( CinemaApp &cinema ) :
 	HelpMenuButton( Cinema ),
 	HelpMenu( NULL ),
 	HelpText( Cinema ),
+	ButtonPerfHud( Cinema ),
 	ExitButton( Cinema ),
 	VRModeMenuButton( Cinema ),
 	VRModeMenu( NULL ),
+	ButtonCalibrate( Cinema ),
 	LatencyScale( Cinema ),
 	LatencySliderBackground( Cinema ),
 	LatencySliderIndicator( Cinema ),
@@ -191,6 +199,11 @@ MoviePlayerView::MoviePlayerView( CinemaApp &cinema ) :
 	customBitrate(0.0),
 	bitrate(0),
 	videoSettingsUpdated(false),
+	adaptiveQuality(false),
+	QualityStats(),
+	QualityController(),
+	AdaptiveStatusParams(),
+	AdaptiveStatusState( -1 ),
 	BitrateMin(0.0),
 	BitrateMax(20000.0),
 	GazeMin(0.7),
@@ -203,7 +216,7 @@ MoviePlayerView::MoviePlayerView( CinemaApp &cinema ) :
 	VoidScreenDistanceMax(3.0),
 	VoidScreenScaleMin(-3.0),
 	VoidScreenScaleMax(4.0),
-	oldPoses(),
+	poseHistory(),
 	calibrationStage(0),
 	lastPose(),
 	trackCalibrationYaw(500),
@@ -218,6 +231,17 @@ MoviePlayerView::MoviePlayerView( CinemaApp &cinema ) :
 	VRXScaleMin( 0.0f ),
 	VRYScaleMax( 6.0f ),
 	VRYScaleMin( 0.0f ),
+	Calibrator(),
+	CalibrationPrevious(),
+	CalibrationCurrent(),
+	CalibrationWidth( 0 ),
+	CalibrationHeight( 0 ),
+	CalibrationSerial( 0 ),
+	CalibrationFrameTime( 0 ),
+	CalibrationStageTime( 0.0 ),
+	LatencyTester(),
+	LatencyThumbnail(),
+	LatencyTestSerial( 0 ),
 	gamepadButtonNames(),
 	gamepadKeyCodes(),
 	gamepadButtonSettings(),
@@ -235,6 +259,7 @@ MoviePlayerView::~MoviePlayerView()
 void MoviePlayerView::OneTimeInit( const char * launchIntent )
 {
 	LOG( "MoviePlayerView::OneTimeInit" );
+	TRACE_SCOPE( "MoviePlayerView::OneTimeInit" );
 
 	const double start = vrapi_GetTimeInSeconds();
 
@@ -308,12 +333,14 @@ void Button720Callback				( UITextButton *button, void *object ) { ( ( MoviePlay
 void Button60FPSCallback			( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->Button60FPSPressed(); }
 void Button30FPSCallback			( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->Button30FPSPressed(); }
 void HostAudioCallback				( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->HostAudioPressed(); }
+void AdaptiveCallback				( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->AdaptivePressed(); }
 void ApplyVideoCallback				( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->ApplyVideoPressed(); }
 bool Button1080IsSelectedCallback	( UITextButton *button, void *object ) { return ( ( MoviePlayerView * )object )->Button1080IsSelected(); }
 bool Button720IsSelectedCallback	( UITextButton *button, void *object ) { return ( ( MoviePlayerView * )object )->Button720IsSelected(); }
 bool Button60FPSIsSelectedCallback	( UITextButton *button, void *object ) { return ( ( MoviePlayerView * )object )->Button60FPSIsSelected(); }
 bool Button30FPSIsSelectedCallback	( UITextButton *button, void *object ) { return ( ( MoviePlayerView * )object )->Button30FPSIsSelected(); }
 bool HostAudioIsSelectedCallback	( UITextButton *button, void *object ) { return ( ( MoviePlayerView * )object )->HostAudioIsSelected(); }
+bool AdaptiveIsSelectedCallback		( UITextButton *button, void *object ) { return ( ( MoviePlayerView * )object )->AdaptiveIsSelected(); }
 bool ApplyVideoIsEnabledCallback	( UITextButton *button, void *object ) { return ( ( MoviePlayerView * )object )->ApplyVideoIsEnabled(); }
 void BitrateCallback				( SliderComponent *button, void *object, const float value ) { ( ( MoviePlayerView * )object )->BitratePressed( value ); }
 
@@ -321,6 +348,7 @@ void SBSOffCallback					( UITextButton *button, void *object ) { ( ( MoviePlayer
 void SBSRiftCallback				( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->SBSRiftPressed(); }
 void SBSCropCallback				( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->SBSCropPressed(); }
 void SBSScaleCallback				( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->SBSScalePressed(); }
+void SBSAutoCallback				( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->SBSAutoPressed(); }
 void ChangeSeatCallback				( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->ChangeSeatPressed(); }
 void DistanceCallback				( SliderComponent *button, void *object, const float value ) { ( ( MoviePlayerView * )object )->DistancePressed( value ); }
 void SizeCallback					( SliderComponent *button, void *object, const float value ) { ( ( MoviePlayerView * )object )->SizePressed( value ); }
@@ -329,10 +357,15 @@ bool SBSOffIsSelectedCallback		( UITextButton *button, void *object ) { return (
 bool SBSRiftIsSelectedCallback		( UITextButton *button, void *object ) { return ( ( MoviePlayerView * )object )->SBSRiftIsSelected(); }
 bool SBSCropIsSelectedCallback		( UITextButton *button, void *object ) { return ( ( MoviePlayerView * )object )->SBSCropIsSelected(); }
 bool SBSScaleIsSelectedCallback		( UITextButton *button, void *object ) { return ( ( MoviePlayerView * )object )->SBSScaleIsSelected(); }
+bool SBSAutoIsSelectedCallback		( UITextButton *button, void *object ) { return ( ( MoviePlayerView * )object )->SBSAutoIsSelected(); }
 
 void LatencyCallback				( SliderComponent *button, void *object, const float value ) { ( ( MoviePlayerView * )object )->LatencyPressed( value ); }
 void VRXCallback					( SliderComponent *button, void *object, const float value ) { ( ( MoviePlayerView * )object )->VRXPressed( value ); }
 void VRYCallback					( SliderComponent *button, void *object, const float value ) { ( ( MoviePlayerView * )object )->VRYPressed( value ); }
+void CalibrateCallback				( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->CalibratePressed(); }
+
+void PerfHudCallback				( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->PerfHudPressed(); }
+bool PerfHudIsSelectedCallback		( UITextButton *button, void *object ) { return ( ( MoviePlayerView * )object )->PerfHudIsSelected(); }
 
 void SpeedCallback					( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->SpeedPressed(); }
 void ComfortModeCallback			( UITextButton *button, void *object ) { ( ( MoviePlayerView * )object )->ComfortModePressed(); }
@@ -551,6 +584,14 @@ void MoviePlayerView::InitializeSettings()
 			defaultSettings->Define("CustomBitrate", &customBitrate);
 			defaultSettings->Define("MinBitrate", &BitrateMin);
 			defaultSettings->Define("MaxBitrate", &BitrateMax);
+			defaultSettings->Define("AdaptiveQuality", &adaptiveQuality);
+			defaultSettings->Define("ShowPerfHud", &Cinema.Hud.Enabled);
+			defaultSettings->Define("DetectStaticContent", &Cinema.SceneMgr.DetectStaticContent);
+			defaultSettings->Define("AutoStereoLayout", &Cinema.SceneMgr.AutoStereoLayout);
+			defaultSettings->Define("AutoCrop", &Cinema.SceneMgr.AutoCrop);
+			defaultSettings->Define("CaptureMipLevel", &Cinema.SceneMgr.Capture.MipLevel);
+			defaultSettings->Define("CapturePngClips", &Cinema.SceneMgr.Capture.PngClips);
+			defaultSettings->Define("PrebuildPlayerMenus", &Cinema.PrebuildPlayerMenus);
 
 			defaultSettings->Define("GazeScale", &gazeScaleValue);
 			defaultSettings->Define("TrackpadScale", &trackpadScaleValue);
@@ -649,6 +690,11 @@ void MoviePlayerView::InitializeSettings()
 	}
 }
 
+// layout of the submenus, in pixels
+static const int MENU_X = 200;
+static const int MENU_Y = -150;
+static const int MENU_TOP = 200;
+
 void MoviePlayerView::CreateMenu( OvrGuiSys & guiSys )
 {
 	BackgroundTintTexture.LoadTextureFromApplicationPackage( "assets/backgroundTint.png" );
@@ -718,6 +764,21 @@ void MoviePlayerView::CreateMenu( OvrGuiSys & guiSys )
     MoveScreenLabel.SetTextOffset( Vector3f( 0.0f, -24 * VRMenuObject::DEFAULT_TEXEL_SCALE, 0.0f ) );  // offset to be below gaze cursor
     MoveScreenLabel.SetVisible( false );
 
+    // ==============================================================================
+    //
+    // calibration instructions
+    //
+	CalibrationMenu = new UIMenu( Cinema );
+	CalibrationMenu->Create( "CalibrationMenu" );
+	CalibrationMenu->SetFlags( VRMenuFlags_t( VRMENU_FLAG_TRACK_GAZE ) | VRMenuFlags_t( VRMENU_FLAG_BACK_KEY_DOESNT_EXIT ) );
+
+	CalibrationLabel.AddToMenu( guiSys, CalibrationMenu, NULL );
+	CalibrationLabel.SetLocalPose( Quatf( Vector3f( 0.0f, 1.0f, 0.0f ), 0.0f ), Vector3f( 0.0f, 0.0f, -1.8f ) );
+	CalibrationLabel.GetMenuObject()->AddFlags( VRMenuObjectFlags_t( VRMENUOBJECT_DONT_HIT_ALL ) );
+	CalibrationLabel.SetFontScale( 0.5f );
+	CalibrationLabel.SetTextOffset( Vector3f( 0.0f, 48 * VRMenuObject::DEFAULT_TEXEL_SCALE, 0.0f ) );  // above the gaze cursor, the reorient message is below
+	CalibrationLabel.SetVisible( false );
+
     // ==============================================================================
     //
     // Playback controls
@@ -803,10 +864,16 @@ void MoviePlayerView::CreateMenu( OvrGuiSys & guiSys )
 	HelpMenuButton.SetLocalPosition( PixelPos( menuButtonPos, 0, 1 ) );
  	menuButtonPos += MenuButtonsStep;
 	ExitButton.SetLocalPosition( PixelPos( menuButtonPos, 0, 1 ) );
+}
 
-	const static int MENU_X = 200;
-	const static int MENU_Y = -150;
-	const static int MENU_TOP = 200;
+void MoviePlayerView::CreateSaveMenu( OvrGuiSys & guiSys )
+{
+	if ( SaveMenu != NULL )
+	{
+		return;
+	}
+
+	const double start = vrapi_GetTimeInSeconds();
 
 	SaveMenu = new UIContainer( Cinema );
 	SaveMenu->AddToMenu( guiSys, PlaybackControlsMenu, &PlaybackControlsScale );
@@ -867,6 +934,20 @@ void MoviePlayerView::CreateMenu( OvrGuiSys & guiSys )
 	TextButtonHelper(ButtonLoadSettings3, 0.5f);
 	ButtonLoadSettings3.SetOnClick( Load3Callback, this);
 
+	UpdateLoadButtonNames();
+
+	LOG( "MoviePlayerView::CreateSaveMenu: %3.3f seconds", vrapi_GetTimeInSeconds() - start );
+}
+
+void MoviePlayerView::CreateMouseMenu( OvrGuiSys & guiSys )
+{
+	if ( MouseMenu != NULL )
+	{
+		return;
+	}
+
+	const double start = vrapi_GetTimeInSeconds();
+
 	MouseMenu = new UIContainer( Cinema );
 	MouseMenu->AddToMenu( guiSys, PlaybackControlsMenu, &PlaybackControlsScale );
 	MouseMenu->SetLocalPosition( PixelPos( 0, MENU_TOP, 1 ) );
@@ -933,6 +1014,18 @@ void MoviePlayerView::CreateMenu( OvrGuiSys & guiSys )
 	SetUpSlider(guiSys, MouseMenu, GamepadSlider, GamepadSliderBackground, GamepadSliderIndicator, GamepadCurrentSetting, GamepadNewSetting, 300,  MENU_X * 2, MENU_Y * 3);
 	GamepadSlider.SetOnClick( GamepadScaleCallback, this );
 
+	LOG( "MoviePlayerView::CreateMouseMenu: %3.3f seconds", vrapi_GetTimeInSeconds() - start );
+}
+
+void MoviePlayerView::CreateStreamMenu( OvrGuiSys & guiSys )
+{
+	if ( StreamMenu != NULL )
+	{
+		return;
+	}
+
+	const double start = vrapi_GetTimeInSeconds();
+
 	StreamMenu = new UIContainer( Cinema );
 	StreamMenu->AddToMenu( guiSys, PlaybackControlsMenu, &PlaybackControlsScale );
 	StreamMenu->SetLocalPosition( PixelPos( 0, MENU_TOP, 1 ) );
@@ -980,6 +1073,21 @@ void MoviePlayerView::CreateMenu( OvrGuiSys & guiSys )
 	ButtonApply.SetOnClick( ApplyVideoCallback, this);
 	ButtonApply.SetIsEnabled( ApplyVideoIsEnabledCallback, this);
 
+	ButtonAdaptive.AddToMenu( guiSys, PlaybackControlsMenu, StreamMenu );
+	ButtonAdaptive.SetLocalPosition( PixelPos( MENU_X * 3, MENU_Y * 1, 1 ) );
+	ButtonAdaptive.SetText( CinemaStrings::ButtonText_ButtonAdaptive );
+	TextButtonHelper(ButtonAdaptive);
+	ButtonAdaptive.SetOnClick( AdaptiveCallback, this);
+	ButtonAdaptive.SetIsSelected( AdaptiveIsSelectedCallback, this);
+
+	AdaptiveStatus.AddToMenu( guiSys, PlaybackControlsMenu, StreamMenu );
+	AdaptiveStatus.SetLocalPosition( PixelPos( MENU_X * 3, MENU_Y * 3, 1 ) );
+	AdaptiveStatus.SetLocalScale( Vector3f( 1.0f ) );
+	AdaptiveStatus.SetFontScale( 0.7f );
+	AdaptiveStatus.SetColor( Vector4f( 0.0f, 0.0f, 0.0f, 1.0f ) );
+	AdaptiveStatus.SetTextColor( Vector4f( 1.0f, 1.0f, 1.0f, 1.0f ) );
+	AdaptiveStatus.SetImage( 0, SURFACE_TEXTURE_DIFFUSE, BackgroundTintTexture, 320, 120 );
+
 	BitrateAdjust.AddToMenu( guiSys, PlaybackControlsMenu, StreamMenu );
 	BitrateAdjust.SetLocalPosition( PixelPos( MENU_X * -1, MENU_Y * 2.75, 1 ) );
 	BitrateAdjust.SetText( CinemaStrings::ButtonText_ButtonBitrate );
@@ -991,6 +1099,18 @@ void MoviePlayerView::CreateMenu( OvrGuiSys & guiSys )
 	SetUpSlider(guiSys, StreamMenu, BitrateSlider, BitrateSliderBackground, BitrateSliderIndicator, BitrateCurrentSetting, BitrateNewSetting, 300, MENU_X * -1, MENU_Y * 3.5);
 	BitrateSlider.SetOnClick( BitrateCallback, this );
 
+	LOG( "MoviePlayerView::CreateStreamMenu: %3.3f seconds", vrapi_GetTimeInSeconds() - start );
+}
+
+void MoviePlayerView::CreateScreenMenu( OvrGuiSys & guiSys )
+{
+	if ( ScreenMenu != NULL )
+	{
+		return;
+	}
+
+	const double start = vrapi_GetTimeInSeconds();
+
 	ScreenMenu = new UIContainer( Cinema );
 	ScreenMenu->AddToMenu( guiSys, PlaybackControlsMenu, &PlaybackControlsScale );
 	ScreenMenu->SetLocalPosition( PixelPos( 0, MENU_TOP, 1 ) );
@@ -1024,6 +1144,13 @@ void MoviePlayerView::CreateMenu( OvrGuiSys & guiSys )
 	ButtonSBSScale.SetOnClick( SBSScaleCallback, this);
 	ButtonSBSScale.SetIsSelected( SBSScaleIsSelectedCallback, this);
 
+	ButtonSBSAuto.AddToMenu( guiSys, PlaybackControlsMenu, ScreenMenu );
+	ButtonSBSAuto.SetLocalPosition( PixelPos( MENU_X * -2, MENU_Y * 4.25, 1 ) );
+	ButtonSBSAuto.SetText( CinemaStrings::ButtonText_ButtonSBSAuto );
+	TextButtonHelper(ButtonSBSAuto);
+	ButtonSBSAuto.SetOnClick( SBSAutoCallback, this);
+	ButtonSBSAuto.SetIsSelected( SBSAutoIsSelectedCallback, this);
+
 	ButtonChangeSeat.AddToMenu( guiSys, PlaybackControlsMenu, ScreenMenu );
 	ButtonChangeSeat.SetLocalPosition( PixelPos( MENU_X * -2, MENU_Y * 1.25, 1 ) );
 	ButtonChangeSeat.SetText( CinemaStrings::ButtonText_ButtonChangeSeat );
@@ -1055,6 +1182,18 @@ void MoviePlayerView::CreateMenu( OvrGuiSys & guiSys )
 	SetUpSlider(guiSys, ScreenMenu, SizeSlider, SizeSliderBackground, SizeSliderIndicator, SizeCurrentSetting, SizeNewSetting, 800, MENU_X * 2, MENU_Y * 2.25);
 	SizeSlider.SetOnClick( SizeCallback, this );
 
+	LOG( "MoviePlayerView::CreateScreenMenu: %3.3f seconds", vrapi_GetTimeInSeconds() - start );
+}
+
+void MoviePlayerView::CreateVRModeMenu( OvrGuiSys & guiSys )
+{
+	if ( VRModeMenu != NULL )
+	{
+		return;
+	}
+
+	const double start = vrapi_GetTimeInSeconds();
+
 	VRModeMenu = new UIContainer( Cinema );
 	VRModeMenu->AddToMenu( guiSys, PlaybackControlsMenu, &PlaybackControlsScale );
 	VRModeMenu->SetLocalPosition( PixelPos( 0, MENU_TOP, 1 ) );
@@ -1093,6 +1232,24 @@ void MoviePlayerView::CreateMenu( OvrGuiSys & guiSys )
 	SetUpSlider(guiSys, VRModeMenu, VRYSlider, VRYSliderBackground, VRYSliderIndicator, VRYCurrentSetting, VRYNewSetting, 300,  MENU_X * 1, MENU_Y * 3.25);
 	VRYSlider.SetOnClick( VRYCallback, this );
 
+	ButtonCalibrate.AddToMenu( guiSys, PlaybackControlsMenu, VRModeMenu );
+	ButtonCalibrate.SetLocalPosition( PixelPos( MENU_X * 0, MENU_Y * 4.25, 1 ) );
+	ButtonCalibrate.SetText( CinemaStrings::ButtonText_ButtonCalibrate );
+	TextButtonHelper(ButtonCalibrate);
+	ButtonCalibrate.SetOnClick( CalibrateCallback, this);
+
+	LOG( "MoviePlayerView::CreateVRModeMenu: %3.3f seconds", vrapi_GetTimeInSeconds() - start );
+}
+
+void MoviePlayerView::CreateHelpMenu( OvrGuiSys & guiSys )
+{
+	if ( HelpMenu != NULL )
+	{
+		return;
+	}
+
+	const double start = vrapi_GetTimeInSeconds();
+
 	HelpMenu = new UIContainer( Cinema );
 	HelpMenu->AddToMenu( guiSys, PlaybackControlsMenu, &PlaybackControlsScale );
 	HelpMenu->SetLocalPosition( PixelPos( 0, MENU_TOP, 1 ) );
@@ -1106,21 +1263,60 @@ void MoviePlayerView::CreateMenu( OvrGuiSys & guiSys )
 	HelpText.SetTextColor( Vector4f( 1.0f, 1.0f, 1.0f, 1.0f ) );
 	HelpText.SetImage( 0, SURFACE_TEXTURE_DIFFUSE, BackgroundTintTexture, 1200, 600 );
 	HelpText.SetTextWordWrapped( CinemaStrings::HelpText, Cinema.GetGuiSys().GetDefaultFont(), HelpText.GetWorldScale().x * 2);
-//*/
+
+	ButtonPerfHud.AddToMenu( guiSys, PlaybackControlsMenu, HelpMenu );
+	ButtonPerfHud.SetLocalPosition( PixelPos( MENU_X * 0, MENU_Y * 3.5, 1 ) );
+	ButtonPerfHud.SetText( CinemaStrings::ButtonText_ButtonPerfHud );
+	TextButtonHelper(ButtonPerfHud);
+	ButtonPerfHud.SetOnClick( PerfHudCallback, this);
+	ButtonPerfHud.SetIsSelected( PerfHudIsSelectedCallback, this);
+
+	LOG( "MoviePlayerView::CreateHelpMenu: %3.3f seconds", vrapi_GetTimeInSeconds() - start );
 }
 
-void MoviePlayerView::OnOpen()
+// Builds the next submenu that hasn't been created yet.  Returns false once they all exist.
+bool MoviePlayerView::PrebuildNextMenu()
 {
-	LOG( "OnOpen" );
-	CurViewState = VIEWSTATE_OPEN;
-
-	Cinema.SceneMgr.ClearMovie();
+	OvrGuiSys & guiSys = Cinema.GetGuiSys();
+	if ( SaveMenu == NULL )
+	{
+		CreateSaveMenu( guiSys );
+	}
+	else if ( MouseMenu == NULL )
+	{
+		CreateMouseMenu( guiSys );
+	}
+	else if ( StreamMenu == NULL )
+	{
+		CreateStreamMenu( guiSys );
+	}
+	else if ( ScreenMenu == NULL )
+	{
+		CreateScreenMenu( guiSys );
+	}
+	else if ( VRModeMenu == NULL )
+	{
+		CreateVRModeMenu( guiSys );
+	}
+	else if ( HelpMenu == NULL )
+	{
+		CreateHelpMenu( guiSys );
+	}
+	else
+	{
+		return false;
+	}
 
-	RepositionScreen = false;
-	MoveScreenAlpha.Set( 0, 0, 0, 0.0f );
+	return true;
+}
 
-	InitializeGamepadMouse();
-	InitializeSettings();
+void MoviePlayerView::UpdateLoadButtonNames()
+{
+	// the save menu may be built before the settings files are opened
+	if ( SaveMenu == NULL || settings1 == NULL || settings2 == NULL || settings3 == NULL )
+	{
+		return;
+	}
 
 	String settingsText;
 	settings1->GetVal("DisplayName", &settingsText);
@@ -1175,11 +1371,28 @@ void MoviePlayerView::OnOpen()
 			ButtonLoadSettings3.SetText( settingsText );
 		}
 	}
+}
+
+void MoviePlayerView::OnOpen()
+{
+	LOG( "OnOpen" );
+	CurViewState = VIEWSTATE_OPEN;
+
+	Cinema.SceneMgr.ClearMovie();
+
+	RepositionScreen = false;
+	MoveScreenAlpha.Set( 0, 0, 0, 0.0f );
+
+	InitializeGamepadMouse();
+	InitializeSettings();
+
+	UpdateLoadButtonNames();
 
 	HideUI();
 	Cinema.SceneMgr.LightsOff( 1.5f );
 
 	Cinema.StartMoviePlayback(streamWidth, streamHeight, streamFPS, streamHostAudio, bitrate);
+	ResetAdaptiveQuality();
 
 	if ( Cinema.SceneMgr.SceneInfo.UseVRScreen )
 	{
@@ -1209,6 +1422,14 @@ void MoviePlayerView::OnClose()
 		MoveScreenMenu->Close();
 	}
 
+	if ( calibrationStage != 0 )
+	{
+		calibrationStage = 0;
+		Calibrator.Reset();
+		CalibrationLabel.SetVisible( false );
+		CalibrationMenu->Close();
+	}
+
 	Cinema.SceneMgr.ClearMovie();
 
 	if ( Cinema.SceneMgr.VoidedScene )
@@ -1364,12 +1585,7 @@ void MoviePlayerView::ShowUI()
 void MoviePlayerView::HideUI()
 {
 	LOG( "HideUI" );
-	SaveMenu->SetVisible(false);
-	MouseMenu->SetVisible(false);
-	ScreenMenu->SetVisible(false);
-	StreamMenu->SetVisible(false);
-	VRModeMenu->SetVisible(false);
-	HelpMenu->SetVisible(false);
+	HideSubMenus();
 	PlaybackControlsMenu->Close();
 
 	Cinema.GetGuiSys().GetGazeCursor().HideCursor();
@@ -1416,107 +1632,319 @@ void MoviePlayerView::CheckDebugControls( const VrFrame & vrFrame )
 			Cinema.app->CreateToast( "FreeScreenDistance:%3.1f  FreeScreenScale:%3.1f", Cinema.SceneMgr.FreeScreenDistance, Cinema.SceneMgr.FreeScreenScale );
 		}
 	}
+
+	// Left stick click runs the click latency test, right stick click dumps the latency histograms
+	if ( vrFrame.Input.buttonPressed & BUTTON_THUMBL )
+	{
+		ToggleLatencyTest();
+	}
+
+	if ( vrFrame.Input.buttonPressed & BUTTON_THUMBR )
+	{
+		DumpLatencyReport();
+	}
 }
 
-static Vector3f	MatrixOrigin( const Matrix4f & m )
+void MoviePlayerView::ToggleLatencyTest()
 {
-	return Vector3f( -m.M[0][3], -m.M[1][3], -m.M[2][3] );
+	if ( LatencyTester.IsRunning() )
+	{
+		LatencyTester.Stop();
+		DumpLatencyReport();
+		return;
+	}
+
+	LOG( "Starting latency test" );
+	LatencyTestSerial = Cinema.SceneMgr.MipMappedMovieSerial;
+	LatencyTester.Start( vrapi_GetTimeInSeconds() );
+	Cinema.app->CreateToast( "Latency test started" );
 }
 
-static Vector3f	MatrixForward( const Matrix4f & m )
+// Each new frame is read back with its latch time, the thumbnail arrives
+// a frame or so later and is judged by that time, not by when it arrived.
+void MoviePlayerView::UpdateLatencyTest()
 {
-	return Vector3f( -m.M[2][0], -m.M[2][1], -m.M[2][2] );
+	if ( !LatencyTester.IsRunning() )
+	{
+		return;
+	}
+
+	SceneManager & scene = Cinema.SceneMgr;
+	if ( scene.MipMappedMovieSerial != LatencyTestSerial )
+	{
+		LatencyTestSerial = scene.MipMappedMovieSerial;
+		scene.RequestMovieThumbnail( SceneManager::THUMBNAIL_LATENCY, 32, Cinema.Latency.GetLastLatchTime() );
+	}
+
+	int width, height;
+	double latchTime;
+	while ( LatencyTester.IsRunning() && scene.ReadMovieThumbnail( SceneManager::THUMBNAIL_LATENCY, LatencyThumbnail, width, height, latchTime ) )
+	{
+		// watch the middle of the picture, whatever reacts to the click on the host should be there
+		int sum = 0;
+		int count = 0;
+		for ( int y = height / 4; y < height * 3 / 4; y++ )
+		{
+			for ( int x = width / 4; x < width * 3 / 4; x++ )
+			{
+				sum += LatencyThumbnail[y * width + x];
+				count++;
+			}
+		}
+		const float luminance = count > 0 ? (float)sum / count : 0.0f;
+
+		if ( LatencyTester.Update( vrapi_GetTimeInSeconds(), latchTime, luminance, Cinema.Latency ) )
+		{
+			Native::MouseClick( Cinema.app, 1, true );
+			Native::MouseClick( Cinema.app, 1, false );
+		}
+
+		if ( !LatencyTester.IsRunning() )
+		{
+			LOG( "Latency test done: %i trials, %i misses", LatencyTester.GetTrials(), LatencyTester.GetMisses() );
+			DumpLatencyReport();
+		}
+	}
 }
 
-// -1 to 1 range on screenMatrix, returns -2,-2 if looking away from the screen
-Vector2f MoviePlayerView::GazeCoordinatesOnScreen( const Matrix4f & viewMatrix, const Matrix4f screenMatrix ) const
+void MoviePlayerView::DumpLatencyReport()
 {
-	// project along -Z in the viewMatrix onto the Z = 0 plane of screenMatrix
-	const Vector3f viewForward = MatrixForward( viewMatrix ).Normalized();
+	char summary[512];
+	Cinema.Latency.GetSummary( summary, sizeof( summary ) );
+	LOG( "Latency p50/p95/p99 ms:\n%s", summary );
+	Cinema.app->CreateToast( "%s", summary );
 
-	Vector3f screenForward;
-	if (1 || Cinema.SceneMgr.FreeScreenActive )
+	String	outPath;
+	if ( Cinema.app->GetStoragePaths().GetPathIfValidPermission(
+			EST_PRIMARY_EXTERNAL_STORAGE, EFT_FILES, "", W_OK | R_OK, outPath ) )
 	{
-		// MIXFE: free screen matrix is inverted compared to bounds screen matrix.  (MGH: No, everything's backwards!)
-		screenForward = -Vector3f( screenMatrix.M[0][2], screenMatrix.M[1][2], screenMatrix.M[2][2] ).Normalized();
+		outPath += "latency.txt";
+		if ( !Cinema.Latency.WriteReport( outPath.ToCStr() ) )
+		{
+			LOG( "Couldn't write %s", outPath.ToCStr() );
+		}
 	}
-	else
+}
+
+// -1 to 1 range on screenMatrix, returns -2,-2 if looking away from the screen
+Vector2f MoviePlayerView::GazeCoordinatesOnScreen( const Matrix4f & viewMatrix, const Matrix4f screenMatrix ) const
+{
+	return VRMatterStreamTheater::GazeCoordinatesOnScreen( viewMatrix, screenMatrix );
+}
+
+
+Matrix4f MoviePlayerView::InterpolatePoseAtTime( long time )
+{
+	Matrix4f pose = lastPose;
+	poseHistory.GetPoseAtTime( time, pose );
+	return pose;
+}
+
+void MoviePlayerView::RecordPose( long time, Matrix4f pose )
+{
+	poseHistory.Record( time, pose );
+}
+
+void MoviePlayerView::PerfHudPressed()
+{
+	Cinema.Hud.Enabled = !Cinema.Hud.Enabled;
+	UpdateMenus();
+}
+
+bool MoviePlayerView::PerfHudIsSelected()
+{
+	return Cinema.Hud.Enabled;
+}
+
+// Calibration records head pose and the motion of the streamed picture
+// while the user looks around, then solves for the delay between them and
+// how far the picture turns per head turn.  Timestamps are in the same
+// units as the pose history, so the result drops straight into latencyAddition.
+static const double	CALIBRATION_SECONDS			= 12.0;
+static const double	CALIBRATION_MESSAGE_SECONDS	= 4.0;
+static const long	CALIBRATION_MAX_LATENCY		= 200000;
+static const long	CALIBRATION_LATENCY_STEP	= 1000;
+static const int	CALIBRATION_THUMBNAIL_WIDTH	= 96;
+static const int	CALIBRATION_SEARCH_RADIUS	= 8;
+
+void MoviePlayerView::CalibratePressed()
+{
+	HideUI();
+	StartCalibration();
+}
+
+void MoviePlayerView::StartCalibration()
+{
+	if ( !Cinema.SceneMgr.SceneInfo.UseVRScreen )
 	{
-		screenForward = -MatrixForward( screenMatrix ).Normalized();
+		return;
 	}
 
-	const float approach = viewForward.Dot( screenForward );
-	if ( approach <= 0.1f )
+	LOG( "Starting VR screen calibration" );
+	Calibrator.Reset();
+	CalibrationPrevious.Clear();
+	CalibrationSerial = Cinema.SceneMgr.MipMappedMovieSerial;
+	CalibrationFrameTime = 0;
+	screenMotionPaused = false;
+
+	calibrationStage = 1;
+	CalibrationStageTime = vrapi_GetTimeInSeconds();
+	ShowCalibrationMessage( CinemaStrings::MoviePlayer_CalibrateLook.ToCStr() );
+}
+
+void MoviePlayerView::ShowCalibrationMessage( const char * message )
+{
+	if ( !CalibrationMenu->IsOpen() )
 	{
-		// looking away
-		return Vector2f( -2.0f, -2.0f );
+		CalibrationMenu->Open();
 	}
+	CalibrationLabel.SetText( message );
+	CalibrationLabel.SetVisible( true );
+}
 
-	const Matrix4f panelInvert = screenMatrix.Inverted();
-	const Matrix4f viewInvert = viewMatrix.Inverted();
+Vector2f MoviePlayerView::ScreenAngularSize()
+{
+	const Matrix4f screen = Cinema.SceneMgr.ScreenMatrix();
+	const Vector3f eye = Cinema.SceneMgr.Scene.CenterViewMatrix().Inverted().GetTranslation();
 
-	const Vector3f viewOrigin = viewInvert.Transform( Vector3f( 0.0f ) );
-	const Vector3f panelOrigin = MatrixOrigin( screenMatrix );
+	const Vector3f left = ( screen.Transform( Vector3f( -1.0f, 0.0f, 0.0f ) ) - eye ).Normalized();
+	const Vector3f right = ( screen.Transform( Vector3f( 1.0f, 0.0f, 0.0f ) ) - eye ).Normalized();
+	const Vector3f bottom = ( screen.Transform( Vector3f( 0.0f, -1.0f, 0.0f ) ) - eye ).Normalized();
+	const Vector3f top = ( screen.Transform( Vector3f( 0.0f, 1.0f, 0.0f ) ) - eye ).Normalized();
 
-	// Should we disallow using panels from behind?
-	const float d = panelOrigin.Dot( screenForward );
-	const float t = -( viewOrigin.Dot( screenForward ) + d ) / approach;
+	return Vector2f( acosf( Alg::Clamp( left.Dot( right ), -1.0f, 1.0f ) ),
+			acosf( Alg::Clamp( bottom.Dot( top ), -1.0f, 1.0f ) ) );
+}
 
-	const Vector3f impact = viewOrigin + viewForward * t;
-	const Vector3f localCoordinate = panelInvert.Transform( impact );
+void MoviePlayerView::UpdateCalibrationFrame()
+{
+	SceneManager & scene = Cinema.SceneMgr;
+	if ( scene.MipMappedMovieSerial != CalibrationSerial && CalibrationFrameTime != 0 )
+	{
+		CalibrationSerial = scene.MipMappedMovieSerial;
+		scene.RequestMovieThumbnail( SceneManager::THUMBNAIL_CALIBRATION, CALIBRATION_THUMBNAIL_WIDTH, (double)CalibrationFrameTime );
+	}
 
-	return Vector2f( localCoordinate.x, localCoordinate.y );
+	int width, height;
+	double frameTime;
+	while ( scene.ReadMovieThumbnail( SceneManager::THUMBNAIL_CALIBRATION, CalibrationCurrent, width, height, frameTime ) )
+	{
+		AddCalibrationFrame( (long)frameTime, width, height );
+	}
 }
 
-
-Matrix4f MoviePlayerView::InterpolatePoseAtTime( long time )
+// the thumbnail in CalibrationCurrent against the one before it
+void MoviePlayerView::AddCalibrationFrame( const long frameTime, const int width, const int height )
 {
-	OldScreenPose* before = oldPoses.GetFirst();
-	OldScreenPose* after = oldPoses.GetFirst();
-	while(after->time < time && !oldPoses.IsLast(after))
+	SceneManager & scene = Cinema.SceneMgr;
+	if ( width == CalibrationWidth && height == CalibrationHeight && CalibrationPrevious.GetSizeI() == width * height )
 	{
-		OldScreenPose* tooOld = before;
-		before = after;
-		after = oldPoses.GetNext(after);
-		if(tooOld != before) {
-			oldPoses.Remove(tooOld);
+		float shiftX, shiftY;
+		if ( GlobalMotionEstimator::EstimateShift( CalibrationPrevious.DataPtr(), CalibrationCurrent.DataPtr(),
+				width, height, CALIBRATION_SEARCH_RADIUS, shiftX, shiftY ) )
+		{
+			// 3D formats only show part of the texture on the screen
+			const float screenPixelsX = (float)width * scene.CurrentMovieWidth / scene.MovieTextureWidth;
+			const float screenPixelsY = (float)height * scene.CurrentMovieHeight / scene.MovieTextureHeight;
+			const Vector2f angles = ScreenAngularSize();
+			Calibrator.AddFrame( frameTime, shiftX / screenPixelsX * angles.x, shiftY / screenPixelsY * angles.y );
+		}
+		else
+		{
+			// don't let a bad match span two frames
+			Calibrator.AddFrame( 0, 0.0f, 0.0f );
 		}
 	}
-
-//	if(before->time == after->time)
+	else
 	{
-		return after->pose;
+		Calibrator.AddFrame( 0, 0.0f, 0.0f );
 	}
-	return ( before->pose * (time - before->time)
-			+ after->pose * (after->time - time) )
-			/ (after->time - before->time);
+
+	CalibrationPrevious = CalibrationCurrent;
+	CalibrationWidth = width;
+	CalibrationHeight = height;
 }
 
-void MoviePlayerView::RecordPose( long time, Matrix4f pose )
+void MoviePlayerView::FinishCalibration()
 {
-	OldScreenPose* p = new OldScreenPose();
-	p->time = time;
-	p->pose = pose;
-	oldPoses.PushBack(p);
+	MotionCalibrationResult result;
+	if ( !Calibrator.Solve( 0, CALIBRATION_MAX_LATENCY, CALIBRATION_LATENCY_STEP, result ) )
+	{
+		LOG( "Calibration failed: %i frames, correlation %.2f, head travel %.2f",
+				Calibrator.GetNumFrames(), result.Correlation, Calibrator.GetHeadTravel() );
+		ShowCalibrationMessage( CinemaStrings::MoviePlayer_CalibrateFailed.ToCStr() );
+		return;
+	}
+
+	// The picture should turn exactly as far as the head did, so divide out the measured gain
+	latencyAddition = (int)result.Latency;
+	if ( latencyAddition > VRLatencyMax )
+	{
+		VRLatencyMax = latencyAddition;
+	}
+	if ( result.YawGain > 0.0f )
+	{
+		vrXscale = Alg::Clamp( vrXscale / result.YawGain, VRXScaleMin, VRXScaleMax );
+	}
+	if ( result.PitchGain > 0.0f )
+	{
+		vrYscale = Alg::Clamp( vrYscale / result.PitchGain, VRYScaleMin, VRYScaleMax );
+	}
+	LOG( "Calibration: latency %i, gains %.3f %.3f, correlation %.2f over %i frames -> scale %.3f %.3f",
+			latencyAddition, result.YawGain, result.PitchGain, result.Correlation, result.Samples, vrXscale, vrYscale );
+
+	Settings * set = appSettings != NULL ? appSettings : defaultSettings;
+	if ( set != NULL )
+	{
+		Array<const char *> names;
+		names.PushBack( "VRScreenLatency" );
+		names.PushBack( "VRScreenXScale" );
+		names.PushBack( "VRScreenYScale" );
+		names.PushBack( "VRScreenLatencyMax" );
+		set->SaveOnly( names );
+	}
+	UpdateMenus();
+
+	ShowCalibrationMessage( StringUtils::Va( "%s\n%i  %.2f  %.2f", CinemaStrings::MoviePlayer_CalibrateDone.ToCStr(),
+			latencyAddition, vrXscale, vrYscale ) );
 }
 
 void MoviePlayerView::HandleCalibration( const VrFrame & vrFrame )
 {
+	const double now = vrapi_GetTimeInSeconds();
+
 	switch(calibrationStage) {
-	case -1: // TODO: Calibration was canceled, display a temporary message
-		break;
-	case 1: // Look up
-		break;
-	case 2: // Look down
-		break;
-	case 3: // Look center
+	case -1: // Finished, failed or canceled, leave the message up for a moment
+		if ( now - CalibrationStageTime > CALIBRATION_MESSAGE_SECONDS )
+		{
+			CalibrationLabel.SetVisible( false );
+			CalibrationMenu->Close();
+			calibrationStage = 0;
+		}
 		break;
-	case 4: // Look at a recognizable object
+	case 1: // Look around while the picture follows
+		if ( uiActive || screenMotionPaused )
+		{
+			LOG( "Calibration canceled" );
+			ShowCalibrationMessage( CinemaStrings::MoviePlayer_CalibrateCanceled.ToCStr() );
+			calibrationStage = -1;
+			CalibrationStageTime = now;
+			break;
+		}
+		UpdateCalibrationFrame();
+		if ( now - CalibrationStageTime > CALIBRATION_SECONDS )
+		{
+			calibrationStage = 2;
+		}
 		break;
-	case 5: // Spin in a complete circle and look at the object again
+	case 2: // Solve and save
+		FinishCalibration();
+		calibrationStage = -1;
+		CalibrationStageTime = now;
 		break;
 	default:
 		calibrationStage = -1;
+		CalibrationStageTime = now;
 		break;
 	}
 
@@ -1526,13 +1954,33 @@ void MoviePlayerView::HandleCalibration( const VrFrame & vrFrame )
 // to minimize the number of times where we have the wrong timestamp
 void MoviePlayerView::MovieScreenUpdated()
 {
-	if(Cinema.SceneMgr.SceneInfo.UseVRScreen && !uiActive && !screenMotionPaused )
+	const bool moveScreen = Cinema.SceneMgr.SceneInfo.UseVRScreen && !uiActive && !screenMotionPaused;
+	if ( !adaptiveQuality && !moveScreen )
+	{
+		return;
+	}
+
+	// in microseconds, one trip into Java for both uses below
+	//FIXME: MovieTextureTimestamp should be used here but it's broken on lollipop!
+	const long timestamp = Native::getLastFrameTimestamp( Cinema.app );
 
+	if ( adaptiveQuality )
+	{
+		QualityStats.AddFrameArrival( vrapi_GetTimeInSeconds() );
+		if ( timestamp != 0 )
+		{
+			QualityStats.AddLatency( ( Native::currentTimeStamp( Cinema.app ) - timestamp ) / 1000.0f );
+		}
+	}
+
+	if ( moveScreen )
 	{  // Move screen around according to lag delay
 		Matrix4f pose;
 
-		//FIXME: MovieTextureTimestamp should be used here but it's broken on lollipop!
-		long timestamp = Native::getLastFrameTimestamp(Cinema.app);
+		if ( calibrationStage == 1 )
+		{
+			CalibrationFrameTime = timestamp;
+		}
 		//LOG("Timestamp %lu %lu !!!!!!!!!!!! %lu", newts, currentPoseTime, currentPoseTime - newts);
 
 		if(timestamp != 0)
@@ -1576,6 +2024,10 @@ void MoviePlayerView::CheckVRInput( const VrFrame & vrFrame )
 	}
 
 	if(calibrationStage) {
+		if ( calibrationStage == 1 )
+		{
+			Calibrator.AddPose( currentPoseTime, cy, cp );
+		}
 		HandleCalibration( vrFrame );
 	}
 
@@ -1833,6 +2285,21 @@ void MoviePlayerView::DoGamepadEvent(int code, bool down)
 				screenMotionPaused = !screenMotionPaused;
 			}
 		}
+		else if(code == GPMOUSE_SCREENSHOT)
+		{
+			if(down)
+			{
+				Cinema.SceneMgr.Capture.TakeScreenshot();
+			}
+		}
+		else if(code == GPMOUSE_TOGGLE_CLIP)
+		{
+			if(down)
+			{
+				Cinema.SceneMgr.Capture.ToggleClip();
+				Cinema.app->CreateToast( Cinema.SceneMgr.Capture.IsClipRunning() ? "Recording clip" : "Clip stopped" );
+			}
+		}
 	}
 }
 
@@ -1903,6 +2370,8 @@ void MoviePlayerView::HandleGamepadMouse( const VrFrame & vrFrame )
 
 void MoviePlayerView::CheckInput( const VrFrame & vrFrame )
 {
+	Cinema.Latency.InputSampled( vrapi_GetTimeInSeconds() );
+
 	if ( Cinema.SceneMgr.SceneInfo.UseVRScreen )
 	{   // Handle VR input differently
 		CheckVRInput(vrFrame);
@@ -1983,72 +2452,65 @@ void MoviePlayerView::CheckInput( const VrFrame & vrFrame )
 	}
 }
 
-void MoviePlayerView::MouseMenuButtonPressed()
+void MoviePlayerView::HideSubMenus()
 {
+	// submenus are only created the first time they're opened
+	if ( SaveMenu != NULL ) SaveMenu->SetVisible(false);
+	if ( MouseMenu != NULL ) MouseMenu->SetVisible(false);
+	if ( StreamMenu != NULL ) StreamMenu->SetVisible(false);
+	if ( ScreenMenu != NULL ) ScreenMenu->SetVisible(false);
+	if ( VRModeMenu != NULL ) VRModeMenu->SetVisible(false);
+	if ( HelpMenu != NULL ) HelpMenu->SetVisible(false);
+}
 
-	Cinema.app->PlaySound( "touch_up" );
+void MoviePlayerView::ToggleSubMenu( UIContainer *menu )
+{
+	CreateSaveMenu( Cinema.GetGuiSys() );
 	UpdateMenus();
-	MouseMenu->SetVisible(!MouseMenu->GetVisible());
-	StreamMenu->SetVisible(false);
-	ScreenMenu->SetVisible(false);
-	VRModeMenu->SetVisible(false);
-	HelpMenu->SetVisible(false);
 
-	SaveMenu->SetVisible(MouseMenu->GetVisible());
+	const bool visible = !menu->GetVisible();
+	HideSubMenus();
+	menu->SetVisible(visible);
+
+	SaveMenu->SetVisible(visible);
 }
-void MoviePlayerView::StreamMenuButtonPressed()
+
+void MoviePlayerView::MouseMenuButtonPressed()
 {
 
 	Cinema.app->PlaySound( "touch_up" );
-	UpdateMenus();
-	MouseMenu->SetVisible(false);
-	StreamMenu->SetVisible(!StreamMenu->GetVisible());
-	ScreenMenu->SetVisible(false);
-	VRModeMenu->SetVisible(false);
-	HelpMenu->SetVisible(false);
+	CreateMouseMenu( Cinema.GetGuiSys() );
+	ToggleSubMenu( MouseMenu );
+}
+void MoviePlayerView::StreamMenuButtonPressed()
+{
 
-	SaveMenu->SetVisible(StreamMenu->GetVisible());
+	Cinema.app->PlaySound( "touch_up" );
+	CreateStreamMenu( Cinema.GetGuiSys() );
+	ToggleSubMenu( StreamMenu );
 }
 void MoviePlayerView::ScreenMenuButtonPressed()
 {
 
 	Cinema.app->PlaySound( "touch_up" );
-	UpdateMenus();
-	MouseMenu->SetVisible(false);
-	StreamMenu->SetVisible(false);
-	ScreenMenu->SetVisible(!ScreenMenu->GetVisible());
-	VRModeMenu->SetVisible(false);
-	HelpMenu->SetVisible(false);
-
-	SaveMenu->SetVisible(ScreenMenu->GetVisible());
+	CreateScreenMenu( Cinema.GetGuiSys() );
+	ToggleSubMenu( ScreenMenu );
 }
 void MoviePlayerView::VRModeMenuButtonPressed()
 {
 
 	Cinema.app->PlaySound( "touch_up" );
-	UpdateMenus();
-	MouseMenu->SetVisible(false);
-	StreamMenu->SetVisible(false);
-	ScreenMenu->SetVisible(false);
-	VRModeMenu->SetVisible(!VRModeMenu->GetVisible());
-	HelpMenu->SetVisible(false);
-
-	SaveMenu->SetVisible(VRModeMenu->GetVisible());
+	CreateVRModeMenu( Cinema.GetGuiSys() );
+	ToggleSubMenu( VRModeMenu );
 }
 void MoviePlayerView::HelpMenuButtonPressed()
 {
 
 	Cinema.app->PlaySound( "touch_up" );
-	UpdateMenus();
-	MouseMenu->SetVisible(false);
-	StreamMenu->SetVisible(false);
-	ScreenMenu->SetVisible(false);
-	VRModeMenu->SetVisible(false);
-	HelpMenu->SetVisible(!HelpMenu->GetVisible());
+	CreateHelpMenu( Cinema.GetGuiSys() );
+	ToggleSubMenu( HelpMenu );
 
 	MovieTitleLabel.SetVisible(false);
-
-	SaveMenu->SetVisible(HelpMenu->GetVisible());
 }
 void MoviePlayerView::ExitButtonPressed()
 {
@@ -2142,7 +2604,7 @@ void MoviePlayerView::ResetDefaultPressed()
 	Cinema.SceneMgr.ClearMovie();
 	UpdateMenus();
 	Cinema.StartMoviePlayback(streamWidth, streamHeight, streamFPS, streamHostAudio, bitrate);
-
+	ResetAdaptiveQuality();
 }
 void MoviePlayerView::Save1Pressed()
 {
@@ -2190,21 +2652,9 @@ void MoviePlayerView::LoadSettings(Settings* set)
 	{
 		Cinema.SceneMgr.ClearMovie();
 		Cinema.StartMoviePlayback(streamWidth, streamHeight, streamFPS, streamHostAudio, bitrate);
+		ResetAdaptiveQuality();
 	}
 
-	GazeSlider.SetExtents(GazeMax,GazeMin,2);
-	GazeSlider.SetValue(gazeScaleValue);
-	TrackpadSlider.SetExtents(TrackpadMax,TrackpadMin,2);
-	TrackpadSlider.SetValue(trackpadScaleValue);
-	GamepadSlider.SetExtents(GamepadMax,GamepadMin,2);
-	GamepadSlider.SetValue(gamepadScaleValue);
-	BitrateSlider.SetExtents(BitrateMax,BitrateMin,-1);
-	BitrateSlider.SetValue(customBitrate);
-	DistanceSlider.SetExtents(VoidScreenDistanceMax,VoidScreenDistanceMin,2);
-	DistanceSlider.SetValue(Cinema.SceneMgr.FreeScreenDistance);
-	SizeSlider.SetExtents(VoidScreenScaleMax,VoidScreenScaleMin,2);
-	SizeSlider.SetValue(Cinema.SceneMgr.FreeScreenScale);
-
 	if( Cinema.SceneMgr.CurrentMovieFormat == VT_LEFT_RIGHT_3D && oldFormat != VT_LEFT_RIGHT_3D )
 	{
 		Cinema.SceneMgr.CurrentMovieWidth /= 2;
@@ -2347,6 +2797,23 @@ void MoviePlayerView::ApplyVideoPressed()
 	Cinema.SceneMgr.ClearMovie();
 	UpdateMenus();
 	Cinema.StartMoviePlayback(streamWidth, streamHeight, streamFPS, streamHostAudio, bitrate);
+	ResetAdaptiveQuality();
+}
+void MoviePlayerView::AdaptivePressed()
+{
+	adaptiveQuality = !adaptiveQuality;
+
+	// turning it off while stepped down goes back to the user's settings
+	if ( !adaptiveQuality && !QualityController.IsAtTarget() )
+	{
+		ApplyVideoPressed();
+	}
+	else
+	{
+		ResetAdaptiveQuality();
+	}
+
+	UpdateMenus();
 }
 void MoviePlayerView::LatencyPressed(const float value)
 {
@@ -2364,40 +2831,34 @@ void MoviePlayerView::VRYPressed(const float value)
 	VRYSlider.SetValue( value );
 }
 
+// picking a mode by hand overrides the automatic layout detection
 void MoviePlayerView::SBSOffPressed()
 {
-	if(Cinema.SceneMgr.CurrentMovieFormat == VT_LEFT_RIGHT_3D)
-	{
-		Cinema.SceneMgr.CurrentMovieWidth *= 2;
-	}
-	Cinema.SceneMgr.CurrentMovieFormat = VT_2D;
+	Cinema.SceneMgr.AutoStereoLayout = false;
+	Cinema.SceneMgr.SetMovieFormat( VT_2D );
 	UpdateMenus();
 }
 void MoviePlayerView::SBSRiftPressed()
 {
-	if(Cinema.SceneMgr.CurrentMovieFormat != VT_LEFT_RIGHT_3D)
-	{
-		Cinema.SceneMgr.CurrentMovieWidth /= 2;
-	}
-	Cinema.SceneMgr.CurrentMovieFormat = VT_LEFT_RIGHT_3D;
+	Cinema.SceneMgr.AutoStereoLayout = false;
+	Cinema.SceneMgr.SetMovieFormat( VT_LEFT_RIGHT_3D );
 	UpdateMenus();
 }
 void MoviePlayerView::SBSCropPressed()
 {
-	if(Cinema.SceneMgr.CurrentMovieFormat == VT_LEFT_RIGHT_3D)
-	{
-		Cinema.SceneMgr.CurrentMovieWidth *= 2;
-	}
-	Cinema.SceneMgr.CurrentMovieFormat = VT_LEFT_RIGHT_3D_CROP;
+	Cinema.SceneMgr.AutoStereoLayout = false;
+	Cinema.SceneMgr.SetMovieFormat( VT_LEFT_RIGHT_3D_CROP );
 	UpdateMenus();
 }
 void MoviePlayerView::SBSScalePressed()
 {
-	if(Cinema.SceneMgr.CurrentMovieFormat == VT_LEFT_RIGHT_3D)
-	{
-		Cinema.SceneMgr.CurrentMovieWidth *= 2;
-	}
-	Cinema.SceneMgr.CurrentMovieFormat = VT_LEFT_RIGHT_3D_FULL;
+	Cinema.SceneMgr.AutoStereoLayout = false;
+	Cinema.SceneMgr.SetMovieFormat( VT_LEFT_RIGHT_3D_FULL );
+	UpdateMenus();
+}
+void MoviePlayerView::SBSAutoPressed()
+{
+	Cinema.SceneMgr.AutoStereoLayout = !Cinema.SceneMgr.AutoStereoLayout;
 	UpdateMenus();
 }
 bool MoviePlayerView::SBSOffIsSelected()
@@ -2416,6 +2877,10 @@ bool MoviePlayerView::SBSScaleIsSelected()
 {
 	return Cinema.SceneMgr.CurrentMovieFormat == VT_LEFT_RIGHT_3D_FULL;
 }
+bool MoviePlayerView::SBSAutoIsSelected()
+{
+	return Cinema.SceneMgr.AutoStereoLayout;
+}
 
 bool MoviePlayerView::Button1080IsSelected()
 {
@@ -2437,6 +2902,78 @@ bool MoviePlayerView::HostAudioIsSelected()
 {
 	return streamHostAudio;
 }
+bool MoviePlayerView::AdaptiveIsSelected()
+{
+	return adaptiveQuality;
+}
+
+void MoviePlayerView::ResetAdaptiveQuality()
+{
+	const double now = vrapi_GetTimeInSeconds();
+	QualityController.SetBitrateLimits( (int)BitrateMin, (int)BitrateMax );
+	QualityController.Reset( StreamQualityParams( streamWidth, streamHeight, streamFPS, bitrate ), now );
+	QualityStats.Reset( now );
+	UpdateAdaptiveStatus();
+}
+
+void MoviePlayerView::UpdateAdaptiveQuality( const VrFrame & vrFrame )
+{
+	if ( !adaptiveQuality )
+	{
+		return;
+	}
+
+	QualityStats.AddRenderFrame( vrFrame.DeltaSeconds );
+
+	const double now = vrapi_GetTimeInSeconds();
+	StreamQualitySample sample;
+	if ( !QualityStats.GetSample( now, QualityController.GetParams().FPS, sample ) )
+	{
+		return;
+	}
+
+	if ( QualityController.Evaluate( sample, now ) )
+	{
+		const StreamQualityParams & params = QualityController.GetParams();
+		LOG( "Adaptive quality %s: %dx%d %dfps %dkbps (jitter %.1fms, late %.2f, latency %.1fms, frame %.1fms)",
+				QualityController.GetStateName(), params.Width, params.Height, params.FPS, params.Bitrate,
+				sample.FrameJitterMs, sample.LateFrameFraction, sample.LatencyMs, sample.RenderFrameMs );
+
+		// the user's settings are left alone, they're the target to recover to
+		Cinema.SceneMgr.ClearMovie();
+		Cinema.StartMoviePlayback( params.Width, params.Height, params.FPS, streamHostAudio, params.Bitrate );
+		QualityStats.Reset( now );
+	}
+
+	UpdateAdaptiveStatus();
+}
+
+void MoviePlayerView::UpdateAdaptiveStatus()
+{
+	if ( StreamMenu == NULL )
+	{
+		return;
+	}
+
+	if ( !adaptiveQuality )
+	{
+		AdaptiveStatus.SetVisible( false );
+		AdaptiveStatusState = -1;
+		return;
+	}
+
+	// this runs every frame, only lay the text out again when it changes
+	const StreamQualityParams & params = QualityController.GetParams();
+	if ( AdaptiveStatusState == QualityController.GetState() && AdaptiveStatusParams == params )
+	{
+		return;
+	}
+	AdaptiveStatusParams = params;
+	AdaptiveStatusState = QualityController.GetState();
+
+	AdaptiveStatus.SetVisible( true );
+	AdaptiveStatus.SetText( StringUtils::Va( "%dp%d %dk\n%s", params.Height, params.FPS, params.Bitrate, QualityController.GetStateName() ) );
+}
 bool MoviePlayerView::ApplyVideoIsEnabled()
 {
 	return videoSettingsUpdated;
@@ -2473,52 +3010,78 @@ void MoviePlayerView::MapKeyboardPressed()
 
 void MoviePlayerView::UpdateMenus()
 {
-	ButtonGaze.UpdateButtonState();
-	ButtonTrackpad.UpdateButtonState();
-	ButtonGamepad.UpdateButtonState();
-	ButtonOff.UpdateButtonState();
-
-	Button1080.UpdateButtonState();
-	Button720.UpdateButtonState();
-	Button60FPS.UpdateButtonState();
-	Button30FPS.UpdateButtonState();
-	ButtonHostAudio.UpdateButtonState();
-	ButtonApply.UpdateButtonState();
-
-	ButtonSBSOff.UpdateButtonState();
-	ButtonSBSRift.UpdateButtonState();
-	ButtonSBSCrop.UpdateButtonState();
-	ButtonSBSScale.UpdateButtonState();
-	ButtonChangeSeat.UpdateButtonState();
-
-	ButtonSaveApp.UpdateButtonState();
-	ButtonSaveDefault.UpdateButtonState();
-	ButtonResetSettings.UpdateButtonState();
-	ButtonSaveSettings1.UpdateButtonState();
-	ButtonSaveSettings2.UpdateButtonState();
-	ButtonSaveSettings3.UpdateButtonState();
-	ButtonLoadSettings1.UpdateButtonState();
-	ButtonLoadSettings2.UpdateButtonState();
-	ButtonLoadSettings3.UpdateButtonState();
-
-	GazeSlider.SetExtents(GazeMax,GazeMin,2);
-	GazeSlider.SetValue(gazeScaleValue);
-	TrackpadSlider.SetExtents(TrackpadMax,TrackpadMin,2);
-	TrackpadSlider.SetValue(trackpadScaleValue);
-	GamepadSlider.SetExtents(GamepadMax,GamepadMin,2);
-	GamepadSlider.SetValue(gamepadScaleValue);
-	BitrateSlider.SetExtents(BitrateMax,BitrateMin,-1);
-	BitrateSlider.SetValue(customBitrate);
-	DistanceSlider.SetExtents(VoidScreenDistanceMax,VoidScreenDistanceMin,2);
-	DistanceSlider.SetValue(Cinema.SceneMgr.FreeScreenDistance);
-	SizeSlider.SetExtents(VoidScreenScaleMax,VoidScreenScaleMin,2);
-	SizeSlider.SetValue(Cinema.SceneMgr.FreeScreenScale);
-	LatencySlider.SetExtents(VRLatencyMax, VRLatencyMin, 0);
-	LatencySlider.SetValue(latencyAddition);
-	VRXSlider.SetExtents(VRXScaleMax, VRXScaleMin, 2);
-	VRXSlider.SetValue(vrXscale);
-	VRYSlider.SetExtents(VRYScaleMax, VRYScaleMin, 2);
-	VRYSlider.SetValue(vrYscale);
+	if ( MouseMenu != NULL )
+	{
+		ButtonGaze.UpdateButtonState();
+		ButtonTrackpad.UpdateButtonState();
+		ButtonGamepad.UpdateButtonState();
+		ButtonOff.UpdateButtonState();
+
+		GazeSlider.SetExtents(GazeMax,GazeMin,2);
+		GazeSlider.SetValue(gazeScaleValue);
+		TrackpadSlider.SetExtents(TrackpadMax,TrackpadMin,2);
+		TrackpadSlider.SetValue(trackpadScaleValue);
+		GamepadSlider.SetExtents(GamepadMax,GamepadMin,2);
+		GamepadSlider.SetValue(gamepadScaleValue);
+	}
+
+	if ( StreamMenu != NULL )
+	{
+		Button1080.UpdateButtonState();
+		Button720.UpdateButtonState();
+		Button60FPS.UpdateButtonState();
+		Button30FPS.UpdateButtonState();
+		ButtonHostAudio.UpdateButtonState();
+		ButtonApply.UpdateButtonState();
+		ButtonAdaptive.UpdateButtonState();
+		UpdateAdaptiveStatus();
+
+		BitrateSlider.SetExtents(BitrateMax,BitrateMin,-1);
+		BitrateSlider.SetValue(customBitrate);
+	}
+
+	if ( ScreenMenu != NULL )
+	{
+		ButtonSBSOff.UpdateButtonState();
+		ButtonSBSRift.UpdateButtonState();
+		ButtonSBSCrop.UpdateButtonState();
+		ButtonSBSScale.UpdateButtonState();
+		ButtonSBSAuto.UpdateButtonState();
+		ButtonChangeSeat.UpdateButtonState();
+
+		DistanceSlider.SetExtents(VoidScreenDistanceMax,VoidScreenDistanceMin,2);
+		DistanceSlider.SetValue(Cinema.SceneMgr.FreeScreenDistance);
+		SizeSlider.SetExtents(VoidScreenScaleMax,VoidScreenScaleMin,2);
+		SizeSlider.SetValue(Cinema.SceneMgr.FreeScreenScale);
+	}
+
+	if ( SaveMenu != NULL )
+	{
+		ButtonSaveApp.UpdateButtonState();
+		ButtonSaveDefault.UpdateButtonState();
+		ButtonResetSettings.UpdateButtonState();
+		ButtonSaveSettings1.UpdateButtonState();
+		ButtonSaveSettings2.UpdateButtonState();
+		ButtonSaveSettings3.UpdateButtonState();
+		ButtonLoadSettings1.UpdateButtonState();
+		ButtonLoadSettings2.UpdateButtonState();
+		ButtonLoadSettings3.UpdateButtonState();
+	}
+
+	if ( HelpMenu != NULL )
+	{
+		ButtonPerfHud.UpdateButtonState();
+	}
+
+	if ( VRModeMenu != NULL )
+	{
+		LatencySlider.SetExtents(VRLatencyMax, VRLatencyMin, 0);
+		LatencySlider.SetValue(latencyAddition);
+		VRXSlider.SetExtents(VRXScaleMax, VRXScaleMin, 2);
+		VRXSlider.SetValue(vrXscale);
+		VRYSlider.SetExtents(VRYScaleMax, VRYScaleMin, 2);
+		VRYSlider.SetValue(vrYscale);
+	}
 }
 
 void MoviePlayerView::UpdateUI( const VrFrame & vrFrame )
@@ -2582,9 +3145,7 @@ Matrix4f MoviePlayerView::Frame( const VrFrame & vrFrame )
 {
 	// Drop to 2x MSAA during playback, people should be focused
 	// on the high quality screen.
-	ovrEyeBufferParms eyeBufferParms = Cinema.app->GetEyeBufferParms();
-	eyeBufferParms.multisamples = 2;
-	Cinema.app->SetEyeBufferParms( eyeBufferParms );
+	Cinema.SetEyeBufferCeiling( EyeBufferLevel( 2, 1024 ) );
 
 	if ( Native::HadPlaybackError( Cinema.app ) )
 	{
@@ -2600,6 +3161,8 @@ Matrix4f MoviePlayerView::Frame( const VrFrame & vrFrame )
 	CheckInput( vrFrame );
 	CheckDebugControls( vrFrame );
 	UpdateUI( vrFrame );
+	UpdateAdaptiveQuality( vrFrame );
+	UpdateLatencyTest();
 
 	if ( Cinema.SceneMgr.FreeScreenActive && !MoveScreenMenu->IsOpen() )
 	{
@@ -2667,10 +3230,16 @@ SliderComponent::SliderComponent() :
 	Progress( 0.0f ),
 	Max(1.0),
 	Min(0.0),
+	SigFigs( 0 ),
 	Background( NULL ),
 	ScrubBar( NULL ),
 	CurrentTime( NULL ),
 	SeekTime( NULL ),
+	ScrubBarWidth( 0 ),
+	CurrentTimeValue( 0.0f ),
+	SeekTimeValue( 0.0f ),
+	CurrentTimeValid( false ),
+	SeekTimeValid( false ),
 	OnClickFunction( NULL ),
 	OnClickObject( NULL )
 
@@ -2683,6 +3252,10 @@ void SliderComponent::SetExtents( const float max, const float min, const int si
 	Min = min;
 	SigFigs = sigfigs;
 
+	// the formatting changed, so the cached readouts are stale
+	CurrentTimeValid = false;
+	SeekTimeValid = false;
+
 	SetProgress( Progress );
 }
 
@@ -2704,6 +3277,8 @@ void SliderComponent::SetWidgets( UIWidget *background, UIWidget *scrubBar, UILa
 	CurrentTime 	= currentTime;
 	SeekTime 		= seekTime;
 	ScrubBarWidth	= scrubBarWidth;
+	CurrentTimeValid = false;
+	SeekTimeValid	= false;
 
 	SeekTime->SetVisible( false );
 }
@@ -2735,6 +3310,18 @@ void SliderComponent::SetProgress( const float progress )
 
 void SliderComponent::SetText( UILabel *label, const float value )
 {
+	// The readouts are refreshed every frame while scrubbing, but the value rarely changes
+	// between frames, so only reformat when it does.  UILabel::SetText additionally skips
+	// the relayout when the formatted text comes out the same.
+	float & lastValue = ( label == CurrentTime ) ? CurrentTimeValue : SeekTimeValue;
+	bool & lastValid = ( label == CurrentTime ) ? CurrentTimeValid : SeekTimeValid;
+	if ( lastValid && lastValue == value )
+	{
+		return;
+	}
+	lastValue = value;
+	lastValid = true;
+
 	if( SigFigs == 0 )
 	{
 		label->SetText( StringUtils::Va( "%d", (int) value ) );
@@ -27,6 +27,11 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "UI/UIButton.h"
 #include "UI/UITextButton.h"
 #include "Settings.h"
+#include "StreamQualityController.h"
+#include "MotionCalibration.h"
+#include "LatencyProbes.h"
+#include "PoseHistory.h"
+#include "ScreenMath.h"
 
 #include "Kernel/OVR_List.h"
 
@@ -65,6 +70,8 @@ enum MouseMode
 #define GPMOUSE_COMFORT_LEFT 8192
 #define GPMOUSE_COMFORT_RIGHT 8193
 #define GPMOUSE_TOGGLE_VR_SCREEN_LOCK 8294
+#define GPMOUSE_SCREENSHOT 8295
+#define GPMOUSE_TOGGLE_CLIP 8296
 
 class CinemaApp;
 
@@ -124,6 +131,12 @@ private:
 	UILabel *				SeekTime;
 	int 					ScrubBarWidth;
 
+	// last value written to each readout, so unchanged values skip formatting and relayout
+	float					CurrentTimeValue;
+	float					SeekTimeValue;
+	bool					CurrentTimeValid;
+	bool					SeekTimeValid;
+
 	void 					( *OnClickFunction )( SliderComponent *button, void *object, float progress );
 	void *					OnClickObject;
 
@@ -163,6 +176,8 @@ public:
 
 	void					MovieScreenUpdated();
 
+	bool					PrebuildNextMenu();
+
 private:
 	CinemaApp &				Cinema;
 
@@ -205,6 +220,9 @@ private:
 	UILabel 				MoveScreenLabel;
 	Lerp					MoveScreenAlpha;
 
+	UIMenu *				CalibrationMenu;
+	UILabel 				CalibrationLabel;
+
 	UIMenu *				PlaybackControlsMenu;
 	UIContainer 			PlaybackControlsPosition;
 	UIContainer 			PlaybackControlsScale;
@@ -288,6 +306,8 @@ private:
 	UITextButton			Button30FPS;
 	UITextButton			ButtonHostAudio;
 	UITextButton			ButtonApply;
+	UITextButton			ButtonAdaptive;
+	UILabel					AdaptiveStatus;
 
 	UILabel					BitrateAdjust;
 	UIImage					BitrateSliderBackground;
@@ -302,6 +322,7 @@ private:
 	UITextButton			ButtonSBSRift;
 	UITextButton			ButtonSBSCrop;
 	UITextButton			ButtonSBSScale;
+	UITextButton			ButtonSBSAuto;
 	UITextButton			ButtonChangeSeat;
 
 	UILabel					ScreenDistance;
@@ -321,11 +342,13 @@ private:
 	UIButton				HelpMenuButton;
 	UIContainer *			HelpMenu;
 	UILabel					HelpText;
+	UITextButton			ButtonPerfHud;
 
 	UIButton				ExitButton;
 
 	UIButton				VRModeMenuButton;
 	UIContainer *			VRModeMenu;
+	UITextButton			ButtonCalibrate;
 
 	UILabel					LatencyScale;
 	UIImage					LatencySliderBackground;
@@ -386,6 +409,12 @@ private:
 	int						bitrate;
 	bool					videoSettingsUpdated;
 
+	bool					adaptiveQuality;
+	StreamQualityStats		QualityStats;
+	StreamQualityController	QualityController;
+	StreamQualityParams		AdaptiveStatusParams;	// what AdaptiveStatus shows
+	int						AdaptiveStatusState;	// -1 when it shows nothing
+
 	float					BitrateMin;
 	float					BitrateMax;
 	float					GazeMin;
@@ -399,11 +428,7 @@ private:
 	float					VoidScreenScaleMin;
 	float					VoidScreenScaleMax;
 
-	class OldScreenPose : public ListNode<OldScreenPose> {
-		public: long time;
-		Matrix4f pose;
-	};
-	List<OldScreenPose>		oldPoses;
+	PoseHistory				poseHistory;
 	int						calibrationStage;
 	Matrix4f				lastPose;
 	float					trackCalibrationYaw;
@@ -419,6 +444,19 @@ private:
 	float					VRYScaleMax;
 	float					VRYScaleMin;
 
+	MotionCalibration		Calibrator;
+	Array<unsigned char>	CalibrationPrevious;
+	Array<unsigned char>	CalibrationCurrent;
+	int						CalibrationWidth;
+	int						CalibrationHeight;
+	int						CalibrationSerial;		// last mip mapped frame a thumbnail was requested of
+	long					CalibrationFrameTime;	// stream timestamp of the frame being mip mapped
+	double					CalibrationStageTime;
+
+	LatencyTest				LatencyTester;
+	Array<unsigned char>	LatencyThumbnail;
+	int						LatencyTestSerial;
+
 	Array<String>			gamepadButtonNames;
 	Array<int>				gamepadKeyCodes;
 	Array<int>				gamepadButtonSettings;
@@ -430,6 +468,15 @@ private:
 	void					SetUpSlider(OvrGuiSys & guiSys, UIWidget *parent, SliderComponent& scrub, UIImage& bg,
 								UIImage& ind, UILabel& cur, UILabel& set, int slideWidth, int xoff, int yoff);
 	void 					CreateMenu( OvrGuiSys & guiSys );
+	void					CreateSaveMenu( OvrGuiSys & guiSys );
+	void					CreateMouseMenu( OvrGuiSys & guiSys );
+	void					CreateStreamMenu( OvrGuiSys & guiSys );
+	void					CreateScreenMenu( OvrGuiSys & guiSys );
+	void					CreateVRModeMenu( OvrGuiSys & guiSys );
+	void					CreateHelpMenu( OvrGuiSys & guiSys );
+	void					UpdateLoadButtonNames();
+	void					HideSubMenus();
+	void					ToggleSubMenu( UIContainer *menu );
 
 	void					BackPressed();
 	void					BackPressedDouble();
@@ -514,6 +561,10 @@ private:
 	bool			Button30FPSIsSelected();
 	friend bool		HostAudioIsSelectedCallback( UITextButton *button, void *object );
 	bool			HostAudioIsSelected();
+	friend void		AdaptiveCallback( UITextButton *button, void *object );
+	void			AdaptivePressed();
+	friend bool		AdaptiveIsSelectedCallback( UITextButton *button, void *object );
+	bool			AdaptiveIsSelected();
 	friend bool		ApplyVideoIsEnabledCallback( UITextButton *button, void *object );
 	bool			ApplyVideoIsEnabled();
 	friend void		BitrateCallback( SliderComponent *button, void *object, const float value );
@@ -525,6 +576,13 @@ private:
 	void			VRXPressed(const float value);
 	friend void		VRYCallback( SliderComponent *button, void *object, const float value );
 	void			VRYPressed(const float value);
+	friend void		CalibrateCallback( UITextButton *button, void *object );
+	void			CalibratePressed();
+
+	friend void		PerfHudCallback( UITextButton *button, void *object );
+	void			PerfHudPressed();
+	friend bool		PerfHudIsSelectedCallback( UITextButton *button, void *object );
+	bool			PerfHudIsSelected();
 
 	friend void		ChangeSeatCallback( UITextButton *button, void *object );
 	void			ChangeSeatPressed();
@@ -536,6 +594,8 @@ private:
 	void			SBSCropPressed();
 	friend void		SBSScaleCallback( UITextButton *button, void *object );
 	void			SBSScalePressed();
+	friend void		SBSAutoCallback( UITextButton *button, void *object );
+	void			SBSAutoPressed();
 	friend void		DistanceCallback( SliderComponent *button, void *object, const float value );
 	void			DistancePressed( const float value);
 	friend void		SizeCallback( SliderComponent *button, void *object, const float value );
@@ -552,6 +612,8 @@ private:
 	bool			SBSCropIsSelected();
 	friend bool		SBSScaleIsSelectedCallback( UITextButton *button, void *object );
 	bool			SBSScaleIsSelected();
+	friend bool		SBSAutoIsSelectedCallback( UITextButton *button, void *object );
+	bool			SBSAutoIsSelected();
 
 
 
@@ -572,6 +634,10 @@ private:
 	void					LoadGamepadSettings(Settings* set);
 	void					UpdateMenus();
 
+	void					ResetAdaptiveQuality();
+	void					UpdateAdaptiveQuality( const VrFrame & vrFrame );
+	void					UpdateAdaptiveStatus();
+
 	void 					UpdateUI( const VrFrame & vrFrame );
 	void 					CheckInput( const VrFrame & vrFrame );
 	void					HandleGazeMouse( const VrFrame & vrFrame, bool onscreen, const Vector2f screenCursor );
@@ -587,6 +653,16 @@ private:
 	void					RecordPose( long time, Matrix4f pose );
 	void					CheckVRInput( const VrFrame & vrFrame );
 	void					HandleCalibration( const VrFrame & vrFrame );
+	void					StartCalibration();
+	void					UpdateCalibrationFrame();
+	void					AddCalibrationFrame( const long frameTime, const int width, const int height );
+	void					FinishCalibration();
+	void					ShowCalibrationMessage( const char * message );
+	Vector2f				ScreenAngularSize();
+
+	void					ToggleLatencyTest();
+	void					UpdateLatencyTest();
+	void					DumpLatencyReport();
 };
 
 } // namespace VRMatterStreamTheater
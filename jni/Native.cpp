@@ -15,8 +15,12 @@ of patent rights can be found in the PATENTS file in the same directory.
 
 #include "CinemaApp.h"
 #include "Native.h"
+#include "TraceRecorder.h"
+#include "AsyncLog.h"
 #include "Android/JniUtils.h"
 
+#include <time.h>
+
 namespace VRMatterStreamTheater
 {
 
@@ -55,14 +59,32 @@ jobject Java_com_vrmatter_streamtheater_MainActivity_nativePrepareNewVideo( JNIE
 	return texobj;
 }
 
+// A replay delivers the recorded callbacks, the live ones would change
+// what it plays back.
+static bool IgnoredDuringReplay( CinemaApp * cinema, const char * callback )
+{
+	if ( cinema->Session.IsReplaying() )
+	{
+		LOG( "%s ignored during a session replay", callback );
+		return true;
+	}
+	return false;
+}
+
 void Java_com_vrmatter_streamtheater_MainActivity_nativeDisplayMessage( JNIEnv *jni, jclass clazz, jlong interfacePtr, jstring text, int time, bool isError ) {}
 void Java_com_vrmatter_streamtheater_MainActivity_nativeAddPc( JNIEnv *jni, jclass clazz, jlong interfacePtr, jstring name, jstring uuid, int psi, int reach, jstring binding, bool isRunning)
 {
 	CinemaApp *cinema = ( CinemaApp * )( ( (App *)interfacePtr )->GetAppInterface() );
+	if ( IgnoredDuringReplay( cinema, "nativeAddPc" ) )
+	{
+		return;
+	}
 	JavaUTFChars utfName( jni, name );
 	JavaUTFChars utfUUID( jni, uuid );
 	JavaUTFChars utfBind( jni, binding );
 
+	cinema->Session.RecordAddPc( utfName.ToStr(), utfUUID.ToStr(), psi, reach, utfBind.ToStr(), isRunning );
+
 	Native::PairState ps = (Native::PairState) psi;
 	Native::Reachability rs = (Native::Reachability) reach;
 	cinema->PcMgr.AddPc(utfName.ToStr(), utfUUID.ToStr(), ps, rs, utfBind.ToStr(), isRunning);
@@ -70,43 +92,122 @@ void Java_com_vrmatter_streamtheater_MainActivity_nativeAddPc( JNIEnv *jni, jcla
 void Java_com_vrmatter_streamtheater_MainActivity_nativeRemovePc( JNIEnv *jni, jclass clazz, jlong interfacePtr, jstring name)
 {
 	CinemaApp *cinema = ( CinemaApp * )( ( (App *)interfacePtr )->GetAppInterface() );
+	if ( IgnoredDuringReplay( cinema, "nativeRemovePc" ) )
+	{
+		return;
+	}
 	JavaUTFChars utfName( jni, name );
+	cinema->Session.RecordRemovePc( utfName.ToStr() );
 	cinema->PcMgr.RemovePc(utfName.ToStr());
 }
 void Java_com_vrmatter_streamtheater_MainActivity_nativeAddApp( JNIEnv *jni, jclass clazz, jlong interfacePtr, jstring name, jstring posterfilename, int id, bool isRunning)
 {
 	CinemaApp *cinema = ( CinemaApp * )( ( (App *)interfacePtr )->GetAppInterface() );
+	if ( IgnoredDuringReplay( cinema, "nativeAddApp" ) )
+	{
+		return;
+	}
 	JavaUTFChars utfName( jni, name );
 	JavaUTFChars utfPosterFileName( jni, posterfilename );
+	cinema->Session.RecordAddApp( utfName.ToStr(), utfPosterFileName.ToStr(), id, isRunning );
 	cinema->AppMgr.AddApp(utfName.ToStr(), utfPosterFileName.ToStr(), id, isRunning);
 }
 void Java_com_vrmatter_streamtheater_MainActivity_nativeRemoveApp( JNIEnv *jni, jclass clazz, jlong interfacePtr, int id)
 {
 	CinemaApp *cinema = ( CinemaApp * )( ( (App *)interfacePtr )->GetAppInterface() );
+	if ( IgnoredDuringReplay( cinema, "nativeRemoveApp" ) )
+	{
+		return;
+	}
+	cinema->Session.RecordRemoveApp( id );
 	cinema->AppMgr.RemoveApp( id);
 }
 
+// From the app list poller and the prefetch thread.  Only stored here, the
+// carousel picks it up on the GL thread.  No names means the fetch failed.
+void Java_com_vrmatter_streamtheater_MainActivity_nativeAppList( JNIEnv *jni, jclass clazz, jlong interfacePtr, jstring uuid,
+		jobjectArray names, jobjectArray posterFileNames, jintArray ids, jbooleanArray running )
+{
+	CinemaApp *cinema = ( CinemaApp * )( ( (App *)interfacePtr )->GetAppInterface() );
+	if ( IgnoredDuringReplay( cinema, "nativeAppList" ) )
+	{
+		return;
+	}
+	JavaUTFChars utfUUID( jni, uuid );
+
+	Array<AppListEntry> apps;
+	if ( names == NULL )
+	{
+		cinema->AppMgr.AppListReceived( utfUUID.ToStr(), apps, false );
+		return;
+	}
+
+	const jsize count = jni->GetArrayLength( names );
+	apps.Resize( count );
+	jint * idElements = jni->GetIntArrayElements( ids, NULL );
+	jboolean * runningElements = jni->GetBooleanArrayElements( running, NULL );
+	for ( jsize i = 0; i < count; i++ )
+	{
+		jstring name = (jstring)jni->GetObjectArrayElement( names, i );
+		jstring posterFileName = (jstring)jni->GetObjectArrayElement( posterFileNames, i );
+		{
+			JavaUTFChars utfName( jni, name );
+			JavaUTFChars utfPosterFileName( jni, posterFileName );
+			apps[i].Name = utfName.ToStr();
+			apps[i].PosterFileName = utfPosterFileName.ToStr();
+		}
+		apps[i].Id = idElements[i];
+		apps[i].IsRunning = runningElements[i] != JNI_FALSE;
+		jni->DeleteLocalRef( name );
+		jni->DeleteLocalRef( posterFileName );
+	}
+	jni->ReleaseIntArrayElements( ids, idElements, JNI_ABORT );
+	jni->ReleaseBooleanArrayElements( running, runningElements, JNI_ABORT );
+
+	cinema->AppMgr.AppListReceived( utfUUID.ToStr(), apps, true );
+}
+
 
 void Java_com_vrmatter_streamtheater_MainActivity_nativeShowPair( JNIEnv *jni, jclass clazz, jlong interfacePtr, jstring message )
 {
 	CinemaApp *cinema = ( CinemaApp * )( ( (App *)interfacePtr )->GetAppInterface() );
+	if ( IgnoredDuringReplay( cinema, "nativeShowPair" ) )
+	{
+		return;
+	}
 	JavaUTFChars utfMessage( jni, message );
+	cinema->Session.RecordShowPair( utfMessage.ToStr() );
 	cinema->ShowPair(utfMessage.ToStr());
 }
 void Java_com_vrmatter_streamtheater_MainActivity_nativePairSuccess( JNIEnv *jni, jclass clazz, jlong interfacePtr )
 {
 	CinemaApp *cinema = ( CinemaApp * )( ( (App *)interfacePtr )->GetAppInterface() );
+	if ( IgnoredDuringReplay( cinema, "nativePairSuccess" ) )
+	{
+		return;
+	}
+	cinema->Session.RecordPairSuccess();
 	cinema->PairSuccess();
 }
 void Java_com_vrmatter_streamtheater_MainActivity_nativeShowError( JNIEnv *jni, jclass clazz, jlong interfacePtr, jstring message )
 {
 	CinemaApp *cinema = ( CinemaApp * )( ( (App *)interfacePtr )->GetAppInterface() );
+	if ( IgnoredDuringReplay( cinema, "nativeShowError" ) )
+	{
+		return;
+	}
 	JavaUTFChars utfMessage( jni, message );
+	cinema->Session.RecordShowError( utfMessage.ToStr() );
 	cinema->ShowError(utfMessage.ToStr());
 }
 void Java_com_vrmatter_streamtheater_MainActivity_nativeClearError( JNIEnv *jni, jclass clazz, jlong interfacePtr )
 {
 	CinemaApp *cinema = ( CinemaApp * )( ( (App *)interfacePtr )->GetAppInterface() );
+	if ( IgnoredDuringReplay( cinema, "nativeClearError" ) )
+	{
+		return;
+	}
+	cinema->Session.RecordClearError();
 	cinema->ClearError();
 }
 
@@ -129,6 +230,7 @@ static jmethodID 	getPcStateMethodId = NULL;
 static jmethodID 	getPcReachabilityMethodId = NULL;
 static jmethodID	addPCbyIPMethodId = NULL;
 static jmethodID 	initAppSelectorMethodId = NULL;
+static jmethodID 	prefetchAppListMethodId = NULL;
 static jmethodID	mouseMoveMethodId = NULL;
 static jmethodID	mouseClickMethodId = NULL;
 static jmethodID	mouseScrollMethodId = NULL;
@@ -137,10 +239,22 @@ static jmethodID	startPcUpdatesMethodId = NULL;
 static jmethodID	stopAppUpdatesMethodId = NULL;
 static jmethodID	startAppUpdatesMethodId = NULL;
 static jmethodID	getLastFrameTimestampMethodId = NULL;
-static jmethodID	currentTimeStampMethodId = NULL;
 static jmethodID	closeAppMethodId = NULL;
 static jmethodID	controllerHandledByMoonlightMethodId = NULL;
 static jmethodID	sendKeyboardMethodId = NULL;
+static jmethodID	getPackageCodePathMethodId = NULL;
+
+// calls into Java, for the PerfHud.  Made from the GL thread, the workers
+// and the JNI callback threads alike, so it's only touched atomically.
+static int			JniCalls = 0;
+
+static void CountJniCall()
+{
+	__atomic_add_fetch( &JniCalls, 1, __ATOMIC_RELAXED );
+}
+
+// opens every wrapper that calls into Java, traces and counts it
+#define NATIVE_CALL( name )		TRACE_SCOPE( name ); CountJniCall()
 
 // Error checks and exits on failure
 static jmethodID GetMethodID( App *app, jclass cls, const char * name, const char * signature )
@@ -157,6 +271,7 @@ static jmethodID GetMethodID( App *app, jclass cls, const char * name, const cha
 void Native::OneTimeInit( App *app, jclass mainActivityClass )
 {
 	LOG( "Native::OneTimeInit" );
+	TRACE_SCOPE( "Native::OneTimeInit" );
 
 	const double start = vrapi_GetTimeInSeconds();
 
@@ -174,6 +289,7 @@ void Native::OneTimeInit( App *app, jclass mainActivityClass )
 	getPcReachabilityMethodId 			= GetMethodID( app, mainActivityClass, "getPcReachability", "(Ljava/lang/String;)I" );
 	addPCbyIPMethodId					= GetMethodID( app, mainActivityClass, "addPCbyIP", "(Ljava/lang/String;)I" );
 	initAppSelectorMethodId 			= GetMethodID( app, mainActivityClass, "initAppSelector", "(Ljava/lang/String;)V" );
+	prefetchAppListMethodId 			= GetMethodID( app, mainActivityClass, "prefetchAppList", "(Ljava/lang/String;)V" );
 	mouseMoveMethodId 					= GetMethodID( app, mainActivityClass, "mouseMove", "(II)V" );
 	mouseClickMethodId 					= GetMethodID( app, mainActivityClass, "mouseClick", "(IZ)V" );
 	mouseScrollMethodId 				= GetMethodID( app, mainActivityClass, "mouseScroll", "(B)V" );
@@ -182,10 +298,10 @@ void Native::OneTimeInit( App *app, jclass mainActivityClass )
 	stopAppUpdatesMethodId				= GetMethodID( app, mainActivityClass, "stopAppUpdates", "()V" );
 	startAppUpdatesMethodId				= GetMethodID( app, mainActivityClass, "startAppUpdates", "()V" );
 	getLastFrameTimestampMethodId		= GetMethodID( app, mainActivityClass, "getLastFrameTimestamp", "()J" );
-	currentTimeStampMethodId			= GetMethodID( app, mainActivityClass, "currentTimeStamp", "()J" );
 	closeAppMethodId					= GetMethodID( app, mainActivityClass, "closeApp", "(Ljava/lang/String;I)V" );
 	controllerHandledByMoonlightMethodId = GetMethodID( app, mainActivityClass, "controllerHandledByMoonlight", "(Z)V");
 	sendKeyboardMethodId				= GetMethodID( app, mainActivityClass, "sendKeyboard", "(IZ)V" );
+	getPackageCodePathMethodId			= GetMethodID( app, mainActivityClass, "getPackageCodePath", "()Ljava/lang/String;" );
 	LOG( "Native::OneTimeInit: %3.1f seconds", vrapi_GetTimeInSeconds() - start );
 }
 
@@ -196,6 +312,7 @@ void Native::OneTimeShutdown()
 
 String Native::GetExternalCacheDirectory( App *app )
 {
+	NATIVE_CALL( "Native::GetExternalCacheDirectory" );
 	jstring externalCacheDirectoryString = (jstring)app->GetVrJni()->CallObjectMethod( app->GetJavaObject(), getExternalCacheDirectoryMethodId );
 
 	const char *externalCacheDirectoryStringUTFChars = app->GetVrJni()->GetStringUTFChars( externalCacheDirectoryString, NULL );
@@ -207,8 +324,23 @@ String Native::GetExternalCacheDirectory( App *app )
 	return externalCacheDirectory;
 }
 
+String Native::GetPackageCodePath( App *app )
+{
+	NATIVE_CALL( "Native::GetPackageCodePath" );
+	jstring packageCodePathString = (jstring)app->GetVrJni()->CallObjectMethod( app->GetJavaObject(), getPackageCodePathMethodId );
+
+	const char *packageCodePathStringUTFChars = app->GetVrJni()->GetStringUTFChars( packageCodePathString, NULL );
+	String packageCodePath = packageCodePathStringUTFChars;
+
+	app->GetVrJni()->ReleaseStringUTFChars( packageCodePathString, packageCodePathStringUTFChars );
+	app->GetVrJni()->DeleteLocalRef( packageCodePathString );
+
+	return packageCodePath;
+}
+
 bool Native::CreateVideoThumbnail( App *app, const char *uuid, int appId, const char *outputFilePath, const int width, const int height )
 {
+	NATIVE_CALL( "Native::CreateVideoThumbnail" );
 	LOG( "CreateVideoThumbnail( %s, %i, %s )", uuid, appId, outputFilePath );
 
 	jstring jstrUUID = app->GetVrJni()->NewStringUTF( uuid );
@@ -224,24 +356,28 @@ bool Native::CreateVideoThumbnail( App *app, const char *uuid, int appId, const
 
 bool Native::IsPlaying( App *app )
 {
-	LOG( "IsPlaying()" );
+	NATIVE_CALL( "Native::IsPlaying" );
+	SLOG_VERBOSE( LOG_CATEGORY_NATIVE, "IsPlaying()" );
 	return app->GetVrJni()->CallBooleanMethod( app->GetJavaObject(), isPlayingMethodId );
 }
 
 bool Native::IsPlaybackFinished( App *app )
 {
+	NATIVE_CALL( "Native::IsPlaybackFinished" );
 	jboolean result = app->GetVrJni()->CallBooleanMethod( app->GetJavaObject(), isPlaybackFinishedMethodId );
 	return ( result != 0 );
 }
 
 bool Native::HadPlaybackError( App *app )
 {
+	NATIVE_CALL( "Native::HadPlaybackError" );
 	jboolean result = app->GetVrJni()->CallBooleanMethod( app->GetJavaObject(), hadPlaybackErrorMethodId );
 	return ( result != 0 );
 }
 
 void Native::StartMovie( App *app, const char * uuid, const char * appName, int id, const char * binder, int width, int height, int fps, bool hostAudio, int customBitrate, bool remote )
 {
+	NATIVE_CALL( "Native::StartMovie" );
 	LOG( "StartMovie( %s )", appName );
 
 	jstring jstrUUID = app->GetVrJni()->NewStringUTF( uuid );
@@ -257,18 +393,21 @@ void Native::StartMovie( App *app, const char * uuid, const char * appName, int
 
 void Native::StopMovie( App *app )
 {
+	NATIVE_CALL( "Native::StopMovie" );
 	LOG( "StopMovie()" );
 	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), stopMovieMethodId );
 }
 
 void Native::InitPcSelector( App *app )
 {
+	NATIVE_CALL( "Native::InitPcSelector" );
 	LOG( "InitPcSelector()" );
 	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), initPcSelectorMethodId );
 }
 
 void Native::InitAppSelector( App *app, const char* uuid)
 {
+	NATIVE_CALL( "Native::InitAppSelector" );
 	LOG( "InitAppSelector()" );
 
 	jstring jstrUUID = app->GetVrJni()->NewStringUTF( uuid );
@@ -276,8 +415,18 @@ void Native::InitAppSelector( App *app, const char* uuid)
 	app->GetVrJni()->DeleteLocalRef( jstrUUID );
 }
 
+void Native::PrefetchAppList( App *app, const char* uuid)
+{
+	NATIVE_CALL( "Native::PrefetchAppList" );
+
+	jstring jstrUUID = app->GetVrJni()->NewStringUTF( uuid );
+	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), prefetchAppListMethodId, jstrUUID );
+	app->GetVrJni()->DeleteLocalRef( jstrUUID );
+}
+
 Native::PairState Native::GetPairState( App *app, const char* uuid)
 {
+	NATIVE_CALL( "Native::GetPairState" );
 	LOG( "GetPairState(): %s", uuid );
 
 	jstring jstrUUID = app->GetVrJni()->NewStringUTF( uuid );
@@ -289,6 +438,7 @@ Native::PairState Native::GetPairState( App *app, const char* uuid)
 
 void Native::Pair( App *app, const char* uuid)
 {
+	NATIVE_CALL( "Native::Pair" );
 	LOG( "Pair(): %s", uuid );
 
 	jstring jstrUUID = app->GetVrJni()->NewStringUTF( uuid );
@@ -296,55 +446,83 @@ void Native::Pair( App *app, const char* uuid)
 	app->GetVrJni()->DeleteLocalRef( jstrUUID );
 }
 
+// Every event for the host goes through one of these, so this is where they're timed
+static void InputEventSent( App *app )
+{
+	static_cast< CinemaApp * >( app->GetAppInterface() )->Latency.EventSent( vrapi_GetTimeInSeconds() );
+}
+
 void Native::MouseMove(App *app, int deltaX, int deltaY)
 {
+	NATIVE_CALL( "Native::MouseMove" );
+	InputEventSent( app );
 	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), mouseMoveMethodId, deltaX, deltaY );
 }
 
 void Native::MouseClick(App *app, int buttonId, bool down)
 {
+	NATIVE_CALL( "Native::MouseClick" );
+	InputEventSent( app );
 	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), mouseClickMethodId, buttonId, down );
 }
 
 void Native::MouseScroll(App *app, signed char amount)
 {
+	NATIVE_CALL( "Native::MouseScroll" );
+	InputEventSent( app );
 	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), mouseScrollMethodId, amount );
 }
 
 void Native::stopPcUpdates(App *app)
 {
+	NATIVE_CALL( "Native::stopPcUpdates" );
 	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), stopPcUpdatesMethodId );
 }
 void Native::startPcUpdates(App *app)
 {
+	NATIVE_CALL( "Native::startPcUpdates" );
 	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), startPcUpdatesMethodId );
 }
 void Native::stopAppUpdates(App *app)
 {
+	NATIVE_CALL( "Native::stopAppUpdates" );
 	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), stopAppUpdatesMethodId );
 }
 void Native::startAppUpdates(App *app)
 {
+	NATIVE_CALL( "Native::startAppUpdates" );
 	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), startAppUpdatesMethodId );
 }
 void Native::closeApp(App *app, const char* uuid, int appID)
 {
+	NATIVE_CALL( "Native::closeApp" );
 	jstring jstrUUID = app->GetVrJni()->NewStringUTF( uuid );
 	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), closeAppMethodId, jstrUUID, appID );
 	app->GetVrJni()->DeleteLocalRef( jstrUUID );
 }
 
+int Native::GetJniCallCount()
+{
+	return __atomic_load_n( &JniCalls, __ATOMIC_RELAXED );
+}
+
 long Native::getLastFrameTimestamp(App *app)
 {
+	NATIVE_CALL( "Native::getLastFrameTimestamp" );
 	return app->GetVrJni()->CallLongMethod( app->GetJavaObject(), getLastFrameTimestampMethodId );
 }
+// System.nanoTime() / 1000, the clock the decoder stamps frames with, read
+// here rather than through Java since it's asked for every frame
 long Native::currentTimeStamp(App *app)
 {
-	return app->GetVrJni()->CallLongMethod( app->GetJavaObject(), currentTimeStampMethodId );
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (long)( ts.tv_sec * 1000000LL + ts.tv_nsec / 1000 );
 }
 
 int Native::addPCbyIP(App *app, const char* ip)
 {
+	NATIVE_CALL( "Native::addPCbyIP" );
 	jstring jstrIP = app->GetVrJni()->NewStringUTF( ip );
 	int result = app->GetVrJni()->CallIntMethod( app->GetJavaObject(), addPCbyIPMethodId, jstrIP );
 	app->GetVrJni()->DeleteLocalRef( jstrIP );
@@ -353,12 +531,15 @@ int Native::addPCbyIP(App *app, const char* ip)
 
 void Native::controllerHandledByMoonlight(App *app, bool handleIt)
 {
+	NATIVE_CALL( "Native::controllerHandledByMoonlight" );
 	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), controllerHandledByMoonlightMethodId, handleIt);
 }
 
 
 void Native::sendKeyboard(App *app, int keycode, bool down)
 {
+	NATIVE_CALL( "Native::sendKeyboard" );
+	InputEventSent( app );
 	app->GetVrJni()->CallVoidMethod( app->GetJavaObject(), sendKeyboardMethodId, keycode, down );
 }
 
@@ -16,17 +16,19 @@ of patent rights can be found in the PATENTS file in the same directory.
 #if !defined( Native_h )
 #define Native_h
 #include "App.h"
+#include "Catalog.h"
 
 using namespace OVR;
 
 namespace VRMatterStreamTheater {
 
-class Native {
+class Native : public HostState {
 public:
 	static void			OneTimeInit( App *app, jclass mainActivityClass );
 	static void			OneTimeShutdown();
 
 	static String		GetExternalCacheDirectory( App *app );  	// returns path to app specific writable directory
+	static String		GetPackageCodePath( App *app );				// the apk, for opening it off the GL thread
 	static bool 		CreateVideoThumbnail( App *app, const char *uuid, int appId, const char *outputFilePath, const int width, const int height );
 
 	static bool			IsPlaying( App *app );
@@ -37,28 +39,9 @@ public:
 	static void 		StartMovie( App *app, const char * uuid, const char * appName, int id, const char * binder, int width, int height, int fps, bool hostAudio, int customBitrate, bool remote );
 	static void 		StopMovie( App *app );
 
-	enum PairState {
-		NOT_PAIRED = 0,
-		PAIRED,
-		PIN_WRONG,
-		FAILED
-	};
-
-    enum CompState {
-		ONLINE = 0,
-		OFFLINE,
-		UNKNOWN_STATE
-    };
-
-    enum Reachability {
-    	LOCAL = 0,
-    	REMOTE,
-    	RS_OFFLINE,
-    	UNKNOWN_REACH
-    };
-
     static void			InitPcSelector( App *app );
     static void			InitAppSelector( App *app, const char* uuid);
+    static void			PrefetchAppList( App *app, const char* uuid);	// answers through nativeAppList
     static PairState	GetPairState( App *app, const char* uuid);
     static void			Pair( App *app, const char* uuid);
 
@@ -75,6 +58,8 @@ public:
     static long			getLastFrameTimestamp(App *app);
     static long			currentTimeStamp(App *app);
 
+    static int			GetJniCallCount();	// total calls into Java so far
+
     static int			addPCbyIP(App *app, const char* ip);
 
     static void			controllerHandledByMoonlight(App *app, bool handleIt);
@@ -0,0 +1,389 @@
+/************************************************************************************
+
+Filename    :   PathCache.cpp
+Content     :	Cached directory listings behind an ordered list of search roots
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "PathCache.h"
+#include "Android/LogUtils.h"
+#include "Kernel/OVR_Alg.h"
+
+#include <string.h>
+#include <strings.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+
+namespace VRMatterStreamTheater {
+
+static const double	WATCH_SECONDS	= 0.5;		// how often the inotify events are read
+static const double	POLL_SECONDS	= 2.0;		// how often unwatched directories are stat'ed
+static const double	WATCHED_POLL_SECONDS = 10.0;	// and watched ones, in case the watch missed something
+static const UInt32	WATCH_EVENTS	= IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+// no trailing slash, so "/sdcard/" and "/sdcard" are the same directory
+static String DirectoryKey( const char * directory )
+{
+	String key = directory;
+	while ( key.GetSize() > 1 && key.ToCStr()[key.GetSize() - 1] == '/' )
+	{
+		key = key.Substring( 0, key.GetSize() - 1 );
+	}
+	return key;
+}
+
+static void SplitPath( const String & path, String & directory, String & name )
+{
+	const char * s = path.ToCStr();
+	const char * slash = strrchr( s, '/' );
+	if ( slash == NULL )
+	{
+		directory = ".";
+		name = path;
+	}
+	else
+	{
+		directory = ( slash == s ) ? String( "/" ) : DirectoryKey( String( s, slash - s ).ToCStr() );
+		name = slash + 1;
+	}
+}
+
+static bool FindName( const Array<String> & names, const char * name )
+{
+	int low = 0;
+	int high = names.GetSizeI() - 1;
+	while ( low <= high )
+	{
+		const int mid = ( low + high ) / 2;
+		const int order = strcmp( names[mid].ToCStr(), name );
+		if ( order == 0 )
+		{
+			return true;
+		}
+		if ( order < 0 )
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid - 1;
+		}
+	}
+	return false;
+}
+
+static bool HasExtension( const String & name, const char * extension )
+{
+	const UPInt length = strlen( extension );
+	return name.GetSize() >= length && strcasecmp( name.ToCStr() + name.GetSize() - length, extension ) == 0;
+}
+
+PathCache::PathCache() :
+	Roots(),
+	Directories(),
+	Notify( -1 ),
+	LastWatchTime( 0.0 ),
+	LastPollTime( 0.0 ),
+	LastWatchedPollTime( 0.0 ),
+	Hits( 0 ),
+	Misses( 0 )
+
+{
+	pthread_mutex_init( &Lock, NULL );
+
+	Notify = inotify_init();
+	if ( Notify < 0 )
+	{
+		LOG( "PathCache: no inotify (%s), polling every directory", strerror( errno ) );
+	}
+	else
+	{
+		fcntl( Notify, F_SETFL, fcntl( Notify, F_GETFL ) | O_NONBLOCK );
+		fcntl( Notify, F_SETFD, FD_CLOEXEC );
+	}
+}
+
+PathCache::~PathCache()
+{
+	FreeDirectories();
+	if ( Notify >= 0 )
+	{
+		close( Notify );
+	}
+	pthread_mutex_destroy( &Lock );
+}
+
+void PathCache::AddRoot( const char * root )
+{
+	pthread_mutex_lock( &Lock );
+	Roots.PushBack( DirectoryKey( root ) );
+	pthread_mutex_unlock( &Lock );
+}
+
+int PathCache::GetNumRoots() const
+{
+	pthread_mutex_lock( &Lock );
+	const int numRoots = Roots.GetSizeI();
+	pthread_mutex_unlock( &Lock );
+	return numRoots;
+}
+
+String PathCache::GetRoot( const int index ) const
+{
+	pthread_mutex_lock( &Lock );
+	const String root = ( index >= 0 && index < Roots.GetSizeI() ) ? Roots[index] : String();
+	pthread_mutex_unlock( &Lock );
+	return root;
+}
+
+bool PathCache::Resolve( const char * relativePath, String & fullPath )
+{
+	pthread_mutex_lock( &Lock );
+	bool found = false;
+	for ( int i = 0; i < Roots.GetSizeI() && !found; i++ )
+	{
+		String path = Roots[i];
+		path.AppendString( "/" );
+		path.AppendString( relativePath );
+		if ( Contains( path ) )
+		{
+			fullPath = path;
+			found = true;
+		}
+	}
+	pthread_mutex_unlock( &Lock );
+	return found;
+}
+
+bool PathCache::FileExists( const char * path )
+{
+	pthread_mutex_lock( &Lock );
+	const bool exists = Contains( String( path ) );
+	pthread_mutex_unlock( &Lock );
+	return exists;
+}
+
+void PathCache::ListDirectory( const char * directory, const char * extension, Array<String> & names )
+{
+	pthread_mutex_lock( &Lock );
+	const Directory * dir = GetDirectory( DirectoryKey( directory ) );
+	for ( int i = 0; i < dir->Names.GetSizeI(); i++ )
+	{
+		if ( extension == NULL || HasExtension( dir->Names[i], extension ) )
+		{
+			names.PushBack( dir->Names[i] );
+		}
+	}
+	pthread_mutex_unlock( &Lock );
+}
+
+void PathCache::Invalidate( const char * directory )
+{
+	pthread_mutex_lock( &Lock );
+	if ( directory == NULL )
+	{
+		FreeDirectories();
+	}
+	else
+	{
+		const String key = DirectoryKey( directory );
+		for ( int i = 0; i < Directories.GetSizeI(); i++ )
+		{
+			if ( Directories[i]->Path == key )
+			{
+				FreeDirectory( i );
+				break;
+			}
+		}
+	}
+	pthread_mutex_unlock( &Lock );
+}
+
+void PathCache::Revalidate( const double now )
+{
+	pthread_mutex_lock( &Lock );
+
+	if ( Notify >= 0 && now - LastWatchTime >= WATCH_SECONDS )
+	{
+		LastWatchTime = now;
+		DrainWatches();
+	}
+
+	if ( now - LastPollTime >= POLL_SECONDS )
+	{
+		LastPollTime = now;
+		const bool pollWatched = ( now - LastWatchedPollTime >= WATCHED_POLL_SECONDS );
+		if ( pollWatched )
+		{
+			LastWatchedPollTime = now;
+		}
+		for ( int i = 0; i < Directories.GetSizeI(); i++ )
+		{
+			const Directory * dir = Directories[i];
+			if ( dir->Watch >= 0 && !pollWatched )
+			{
+				continue;
+			}
+			struct stat st;
+			const bool exists = ( stat( dir->Path.ToCStr(), &st ) == 0 && S_ISDIR( st.st_mode ) );
+			if ( exists != dir->Exists || ( exists && ( st.st_mtime != dir->ModifiedTime || st.st_mtime >= dir->ReadTime ) ) )
+			{
+				FreeDirectory( i );
+				i--;
+			}
+		}
+	}
+
+	pthread_mutex_unlock( &Lock );
+}
+
+// lock held
+bool PathCache::Contains( const String & path )
+{
+	String directory;
+	String name;
+	SplitPath( path, directory, name );
+	if ( name.IsEmpty() )
+	{
+		return GetDirectory( directory )->Exists;
+	}
+	return FindName( GetDirectory( directory )->Names, name.ToCStr() );
+}
+
+// lock held, never returns NULL
+PathCache::Directory * PathCache::GetDirectory( const String & path )
+{
+	for ( int i = 0; i < Directories.GetSizeI(); i++ )
+	{
+		if ( Directories[i]->Path == path )
+		{
+			Hits++;
+			return Directories[i];
+		}
+	}
+	Misses++;
+	return ReadDirectory( path );
+}
+
+// lock held
+PathCache::Directory * PathCache::ReadDirectory( const String & path )
+{
+	if ( Directories.GetSizeI() >= MAX_DIRECTORIES )
+	{
+		LOG( "PathCache: more than %i directories, starting over", MAX_DIRECTORIES );
+		FreeDirectories();
+	}
+
+	Directory * dir = new Directory();
+	dir->Path = path;
+	dir->Exists = false;
+	dir->ModifiedTime = 0;
+	dir->ReadTime = time( NULL );
+	dir->Watch = -1;
+
+	struct stat st;
+	if ( stat( path.ToCStr(), &st ) == 0 && S_ISDIR( st.st_mode ) )
+	{
+		dir->Exists = true;
+		dir->ModifiedTime = st.st_mtime;
+		// watch before reading, so nothing can change unseen in between
+		if ( Notify >= 0 )
+		{
+			dir->Watch = inotify_add_watch( Notify, path.ToCStr(), WATCH_EVENTS );
+		}
+
+		DIR * handle = opendir( path.ToCStr() );
+		if ( handle != NULL )
+		{
+			struct dirent * entry;
+			while ( ( entry = readdir( handle ) ) != NULL )
+			{
+				if ( strcmp( entry->d_name, "." ) != 0 && strcmp( entry->d_name, ".." ) != 0 )
+				{
+					dir->Names.PushBack( String( entry->d_name ) );
+				}
+			}
+			closedir( handle );
+		}
+		Alg::QuickSort( dir->Names );
+	}
+
+	Directories.PushBack( dir );
+	return dir;
+}
+
+// lock held
+void PathCache::FreeDirectory( const int index )
+{
+	Directory * dir = Directories[index];
+	Directories.RemoveAtUnordered( index );
+	if ( dir->Watch >= 0 )
+	{
+		bool shared = false;
+		for ( int i = 0; i < Directories.GetSizeI() && !shared; i++ )
+		{
+			shared = ( Directories[i]->Watch == dir->Watch );
+		}
+		if ( !shared )
+		{
+			inotify_rm_watch( Notify, dir->Watch );
+		}
+	}
+	delete dir;
+}
+
+// lock held
+void PathCache::FreeDirectories()
+{
+	while ( Directories.GetSizeI() > 0 )
+	{
+		FreeDirectory( Directories.GetSizeI() - 1 );
+	}
+}
+
+// lock held.  Any event drops the whole listing, it's re-read on the next lookup.
+void PathCache::DrainWatches()
+{
+	char buffer[4096] __attribute__ ( ( aligned( __alignof__( struct inotify_event ) ) ) );
+	for ( ; ; )
+	{
+		const ssize_t length = read( Notify, buffer, sizeof( buffer ) );
+		if ( length <= 0 )
+		{
+			break;
+		}
+		for ( ssize_t offset = 0; offset < length; )
+		{
+			const struct inotify_event * event = (const struct inotify_event *)( buffer + offset );
+			offset += sizeof( struct inotify_event ) + event->len;
+
+			if ( event->mask & IN_Q_OVERFLOW )
+			{
+				FreeDirectories();
+				continue;
+			}
+			// two paths to the same directory share a watch
+			for ( int i = 0; i < Directories.GetSizeI(); i++ )
+			{
+				if ( Directories[i]->Watch == event->wd )
+				{
+					FreeDirectory( i );
+					i--;
+				}
+			}
+		}
+	}
+}
+
+} // namespace VRMatterStreamTheater
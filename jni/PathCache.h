@@ -0,0 +1,105 @@
+/************************************************************************************
+
+Filename    :   PathCache.h
+Content     :	Cached directory listings behind an ordered list of search roots
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( PathCache_h )
+#define PathCache_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_String.h"
+
+#include <pthread.h>
+#include <time.h>
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+//==============================================================
+// PathCache
+// Each directory that's asked about is read once with readdir and kept
+// as a sorted list of names, so existence checks are a binary search
+// instead of an open.  Directories are watched with inotify where the
+// filesystem allows it, anything else has its mtime checked by
+// Revalidate every couple of seconds.  Watched directories get the same
+// check every few seconds more, since FUSE and sdcardfs don't report
+// every change made through the other side.  Missing directories are
+// cached too, and picked up when they appear.
+//
+// Every call takes the lock and returns copies, so loaders on other
+// threads can use the same cache as the GL thread.
+class PathCache
+{
+public:
+	static const int	MAX_DIRECTORIES = 64;
+
+						PathCache();
+						~PathCache();
+
+	// roots are searched in the order they were added
+	void				AddRoot( const char * root );
+	int					GetNumRoots() const;
+	String				GetRoot( const int index ) const;
+
+	// full path of relativePath under the first root that has it
+	bool				Resolve( const char * relativePath, String & fullPath );
+
+	// relative paths are taken from the working directory, like fopen
+	bool				FileExists( const char * path );
+
+	// names in directory ending with extension (case insensitive), or all of them for NULL
+	void				ListDirectory( const char * directory, const char * extension, Array<String> & names );
+
+	// forget a directory after writing into it, NULL forgets everything
+	void				Invalidate( const char * directory );
+
+	// drains the watch events and polls the directories that are due, cheap to call every frame
+	void				Revalidate( const double now );
+
+	int					GetHits() const { return Hits; }
+	int					GetMisses() const { return Misses; }
+	int					GetNumDirectories() const { return Directories.GetSizeI(); }
+
+private:
+	struct Directory
+	{
+		String			Path;
+		bool			Exists;
+		time_t			ModifiedTime;
+		time_t			ReadTime;			// a change in the same second as the read can't be seen by mtime
+		int				Watch;				// inotify descriptor, -1 when polled
+		Array<String>	Names;				// sorted
+	};
+
+	mutable pthread_mutex_t	Lock;
+	Array<String>		Roots;
+	Array<Directory *>	Directories;
+	int					Notify;				// inotify instance, -1 if unavailable
+	double				LastWatchTime;
+	double				LastPollTime;
+	double				LastWatchedPollTime;
+	int					Hits;
+	int					Misses;
+
+	Directory *			GetDirectory( const String & path );
+	bool				Contains( const String & path );
+	Directory *			ReadDirectory( const String & path );
+	void				FreeDirectory( const int index );
+	void				FreeDirectories();
+	void				DrainWatches();
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // PathCache_h
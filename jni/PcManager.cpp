@@ -24,6 +24,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "CinemaApp.h"
 #include "PackageFiles.h"
 #include "Native.h"
+#include "TraceRecorder.h"
 
 
 namespace VRMatterStreamTheater {
@@ -47,6 +48,7 @@ PcManager::~PcManager()
 void PcManager::OneTimeInit( const char * launchIntent )
 {
 	LOG( "PcManager::OneTimeInit" );
+	TRACE_SCOPE( "PcManager::OneTimeInit" );
 	const double start = vrapi_GetTimeInSeconds();
 
 	int width, height;
@@ -92,24 +94,8 @@ void PcManager::OneTimeShutdown()
 }
 
 void PcManager::AddPc(const String &name, const String &uuid, Native::PairState pairState, Native::Reachability reachability, const String &binding, const bool isRunning) {
-	PcDef *movie = NULL;
 	bool isNew = false;
-
-	for (UPInt i = 0; i < Movies.GetSize(); i++) {
-		if (Movies[i]->Name.CompareNoCase(name) == 0)
-			movie = Movies[i];
-	}
-	if (movie == NULL) {
-		movie = new PcDef();
-		Movies.PushBack(movie);
-		isNew = true;
-	}
-
-	movie->Name = name;
-	movie->UUID = uuid;
-	movie->Binding = binding;
-	movie->isRunning = isRunning;
-	movie->isRemote = reachability == Native::REMOTE;
+	PcDef *movie = Catalog::UpdatePc(Movies, name, uuid, pairState, reachability, binding, isRunning, isNew);
 
 	if (isNew) {
 		ReadMetaData(movie);
@@ -126,11 +112,9 @@ void PcManager::AddPc(const String &name, const String &uuid, Native::PairState
 }
 
 void PcManager::RemovePc(const String &name) {
-	for (UPInt i = 0; i < Movies.GetSize(); i++) {
-		if (Movies[i]->Name.CompareNoCase(name) == 0)
-			continue;
-		Movies.RemoveAt(i);
-		return;
+	// the carousel may still point at it
+	if (Catalog::RemovePc(Movies, name) != NULL) {
+		updated = true;
 	}
 }
 
@@ -186,19 +170,7 @@ void PcManager::ReadMetaData( PcDef *movie )
 }
 
 Array<const PcDef *> PcManager::GetPcList(PcCategory category) const {
-	Array<const PcDef *> result;
-
-	for (UPInt i = 0; i < Movies.GetSize(); i++) {
-		if (Movies[i]->Category == category) {
-			if (Movies[i]->Poster != 0) {
-				result.PushBack(Movies[i]);
-			} else {
-				LOG("Skipping PC with empty poster!");
-			}
-		}
-	}
-
-	return result;
+	return Catalog::ListCategory(Movies, category);
 }
 
 } // namespace VRMatterStreamTheater
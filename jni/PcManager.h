@@ -20,6 +20,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "Kernel/OVR_Array.h"
 #include "GlTexture.h"
 #include "Native.h"
+#include "Catalog.h"
 
 namespace VRMatterStreamTheater {
 
@@ -27,33 +28,6 @@ class CinemaApp;
 
 using namespace OVR;
 
-enum PcCategory {
-	CATEGORY_LIMELIGHT,
-	CATEGORY_REMOTEDESKTOP,
-	CATEGORY_VNC
-};
-
-class PcDef
-{
-public:
-	String			Name;
-	String			PosterFileName;
-	String			UUID;
-	String			Binding;
-	int				Id;
-	bool			isRunning;
-	bool			isRemote;
-
-	GLuint			Poster;
-	int				PosterWidth;
-	int				PosterHeight;
-
-	PcCategory		Category;
-
-	PcDef() : Name(), PosterFileName(), UUID(), Binding(), Poster( 0 ), PosterWidth( 0 ), PosterHeight( 0 ),
-			Category( CATEGORY_LIMELIGHT ) {}
-};
-
 class PcManager
 {
 public:
@@ -28,6 +28,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "CinemaStrings.h"
 #include "BitmapFont.h"
 #include "Native.h"
+#include "TraceRecorder.h"
 
 namespace VRMatterStreamTheater {
 
@@ -118,6 +119,7 @@ PcSelectionView::~PcSelectionView()
 void PcSelectionView::OneTimeInit( const char * launchIntent )
 {
 	LOG( "PcSelectionView::OneTimeInit" );
+	TRACE_SCOPE( "PcSelectionView::OneTimeInit" );
 
 	const double start = vrapi_GetTimeInSeconds();
 
@@ -1037,9 +1039,7 @@ Matrix4f PcSelectionView::DrawEyeView( const int eye, const float fovDegrees )
 Matrix4f PcSelectionView::Frame( const VrFrame & vrFrame )
 {
 	// We want 4x MSAA in the lobby
-	ovrEyeBufferParms eyeBufferParms = Cinema.app->GetEyeBufferParms();
-	eyeBufferParms.multisamples = 4;
-	Cinema.app->SetEyeBufferParms( eyeBufferParms );
+	Cinema.SetEyeBufferCeiling( EyeBufferLevel( 4, 1024 ) );
 
 #if 0
 	if ( !Cinema.InLobby && Cinema.SceneMgr.ChangeSeats( vrFrame ) )
@@ -1060,6 +1060,9 @@ Matrix4f PcSelectionView::Frame( const VrFrame & vrFrame )
 		}
 	}
 
+	// while the PC list is up, so the app list is there when one gets picked
+	Cinema.AppMgr.PrefetchAppLists( Cinema.PcMgr.Movies );
+
 	// check if they closed the menu with the back button
 	if ( !Cinema.InLobby && Menu->GetVRMenu()->IsClosedOrClosing() && !Menu->GetVRMenu()->IsOpenOrOpening() )
 	{
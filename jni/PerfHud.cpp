@@ -0,0 +1,274 @@
+/************************************************************************************
+
+Filename    :   PerfHud.cpp
+Content     :	In-headset performance overlay
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "PerfHud.h"
+#include "CinemaApp.h"
+#include "Native.h"
+
+#include <math.h>
+#include <stdio.h>
+
+namespace VRMatterStreamTheater {
+
+static const double	REFRESH_SECONDS		= 0.25;
+
+// graph layout, in texels
+static const float	BAR_WIDTH			= 5.0f;
+static const float	BAR_MAX_HEIGHT		= 80.0f;
+static const float	BAR_MAX_MS			= 33.3f;	// two frames at 60Hz fills the graph
+static const float	GRAPH_BASE			= -150.0f;
+
+//==============================================================
+// PerfRing
+
+void PerfRing::Add( const float value )
+{
+	Values[Next] = value;
+	Next = ( Next + 1 ) % MAX_VALUES;
+	if ( Count < MAX_VALUES )
+	{
+		Count++;
+	}
+}
+
+float PerfRing::GetAverage() const
+{
+	if ( Count == 0 )
+	{
+		return 0.0f;
+	}
+	float sum = 0.0f;
+	for ( int i = 0; i < Count; i++ )
+	{
+		sum += Values[i];
+	}
+	return sum / Count;
+}
+
+float PerfRing::GetMax() const
+{
+	float max = 0.0f;
+	for ( int i = 0; i < Count; i++ )
+	{
+		max = Values[i] > max ? Values[i] : max;
+	}
+	return max;
+}
+
+float PerfRing::GetStdDev() const
+{
+	if ( Count < 2 )
+	{
+		return 0.0f;
+	}
+	const float mean = GetAverage();
+	float sum = 0.0f;
+	for ( int i = 0; i < Count; i++ )
+	{
+		sum += ( Values[i] - mean ) * ( Values[i] - mean );
+	}
+	return sqrtf( sum / Count );
+}
+
+//==============================================================
+// PerfHud
+
+PerfHud::PerfHud( CinemaApp & cinema ) :
+	Enabled( false ),
+	Cinema( cinema ),
+	Menu( NULL ),
+	Panel( NULL ),
+	Text( NULL ),
+	Bars(),
+	BarTexture(),
+	FrameTimes(),
+	CpuTimes(),
+	StreamIntervals(),
+	LastStreamFrames( 0 ),
+	LastStreamTime( 0.0 ),
+	LastJniCalls( 0 ),
+	LastCopiesPerformed( 0 ),
+	LastCopiesSkipped( 0 ),
+	LastPartialCopies( 0 ),
+	FramesSinceRefresh( 0 ),
+	LastRefreshTime( 0.0 )
+
+{
+	TextBuffer[0] = '\0';
+}
+
+void PerfHud::Create( OvrGuiSys & guiSys )
+{
+	const double start = vrapi_GetTimeInSeconds();
+
+	BarTexture.LoadTextureFromApplicationPackage( "assets/backgroundTint.png" );
+
+	Menu = new UIMenu( Cinema );
+	Menu->Create( "PerfHudMenu" );
+	Menu->SetFlags( VRMenuFlags_t( VRMENU_FLAG_TRACK_GAZE ) | VRMenuFlags_t( VRMENU_FLAG_BACK_KEY_DOESNT_EXIT ) );
+
+	Panel = new UIContainer( Cinema );
+	Panel->AddToMenu( guiSys, Menu );
+	Panel->SetLocalPose( Quatf(), Vector3f( 0.0f, 0.45f, -1.6f ) );
+
+	Text = new UILabel( Cinema );
+	Text->AddToMenu( guiSys, Menu, Panel );
+	Text->GetMenuObject()->AddFlags( VRMenuObjectFlags_t( VRMENUOBJECT_DONT_HIT_ALL ) );
+	Text->SetFontScale( 0.5f );
+	Text->SetColor( Vector4f( 0.0f, 0.0f, 0.0f, 0.8f ) );
+	Text->SetTextColor( Vector4f( 1.0f, 1.0f, 1.0f, 1.0f ) );
+	Text->SetImage( 0, SURFACE_TEXTURE_DIFFUSE, BarTexture, 560, 360 );
+	Text->SetTextOffset( Vector3f( 0.0f, 60.0f, 0.0f ) * VRMenuObject::DEFAULT_TEXEL_SCALE );	// above the graph
+
+	for ( int i = 0; i < GRAPH_BARS; i++ )
+	{
+		UIImage * bar = new UIImage( Cinema );
+		bar->AddToMenu( guiSys, Menu, Panel );
+		bar->GetMenuObject()->AddFlags( VRMenuObjectFlags_t( VRMENUOBJECT_DONT_HIT_ALL ) );
+		bar->SetImage( 0, SURFACE_TEXTURE_DIFFUSE, BarTexture, BAR_WIDTH - 1.0f, 1.0f );
+		bar->SetLocalPosition( Vector3f( ( i - GRAPH_BARS / 2 ) * BAR_WIDTH, GRAPH_BASE, 1.0f ) * VRMenuObject::DEFAULT_TEXEL_SCALE );
+		Bars.PushBack( bar );
+	}
+
+	LOG( "PerfHud::Create: %3.3f seconds", vrapi_GetTimeInSeconds() - start );
+}
+
+void PerfHud::Frame( const VrFrame & vrFrame, const float cpuSeconds )
+{
+	const double now = vrapi_GetTimeInSeconds();
+
+	// cheap per-frame collection, always on so the numbers are ready when the HUD opens
+	FrameTimes.Add( vrFrame.DeltaSeconds * 1000.0f );
+	CpuTimes.Add( cpuSeconds * 1000.0f );
+	FramesSinceRefresh++;
+
+	const int streamFrames = Cinema.SceneMgr.StreamFramesLatched;
+	if ( streamFrames != LastStreamFrames )
+	{
+		if ( LastStreamTime > 0.0 )
+		{
+			StreamIntervals.Add( (float)( ( now - LastStreamTime ) * 1000.0 ) );
+		}
+		LastStreamFrames = streamFrames;
+		LastStreamTime = now;
+	}
+
+	if ( !Enabled )
+	{
+		if ( Menu != NULL && Menu->IsOpen() )
+		{
+			Menu->Close();
+		}
+		return;
+	}
+
+	if ( Menu == NULL )
+	{
+		Create( Cinema.GetGuiSys() );
+	}
+	if ( !Menu->IsOpen() )
+	{
+		Menu->Open();
+	}
+
+	if ( now - LastRefreshTime >= REFRESH_SECONDS )
+	{
+		Refresh( now );
+	}
+}
+
+void PerfHud::Refresh( const double now )
+{
+	const float elapsed = (float)( now - LastRefreshTime );
+	LastRefreshTime = now;
+
+	const SceneManager & scene = Cinema.SceneMgr;
+
+	const int jniCalls = Native::GetJniCallCount();
+	const float jniPerFrame = FramesSinceRefresh > 0 ? (float)( jniCalls - LastJniCalls ) / FramesSinceRefresh : 0.0f;
+	LastJniCalls = jniCalls;
+	FramesSinceRefresh = 0;
+
+	const float copiesPerSecond = ( scene.CopiesPerformed - LastCopiesPerformed ) / elapsed;
+	const float skippedPerSecond = ( scene.CopiesSkipped - LastCopiesSkipped ) / elapsed;
+	const float partialPerSecond = ( scene.PartialCopies - LastPartialCopies ) / elapsed;
+	LastCopiesPerformed = scene.CopiesPerformed;
+	LastCopiesSkipped = scene.CopiesSkipped;
+	LastPartialCopies = scene.PartialCopies;
+
+	const float streamInterval = StreamIntervals.GetAverage();
+	const float streamFps = ( streamInterval > 0.0f && now - LastStreamTime < 1.0 ) ? 1000.0f / streamInterval : 0.0f;
+
+	char gpuText[16];
+	if ( scene.CopyTimer.GetLastMs() >= 0.0f )
+	{
+		snprintf( gpuText, sizeof( gpuText ), "%5.2f ms", scene.CopyTimer.GetLastMs() );
+	}
+	else
+	{
+		snprintf( gpuText, sizeof( gpuText ), "  n/a" );
+	}
+
+	char eyeGpuText[16];
+	if ( Cinema.EyeTimer.GetLastMs() >= 0.0f )
+	{
+		snprintf( eyeGpuText, sizeof( eyeGpuText ), "%5.2f ms", Cinema.EyeTimer.GetLastMs() );
+	}
+	else
+	{
+		snprintf( eyeGpuText, sizeof( eyeGpuText ), "  n/a" );
+	}
+
+	snprintf( TextBuffer, sizeof( TextBuffer ),
+			"frame %5.1f ms  max %5.1f  app %4.1f ms\n"
+			"copy gpu %s  %3.0f/s  skipped %3.0f/s\n"
+			"static %s  partial %3.0f/s  crop -%2.0f%%\n"
+			"stream %4.1f fps  jitter %4.1f ms\n"
+			"jni %4.1f/frame  overlay %s  screens %i  focus %i\n"
+			"msaa %ix  res %i  eye gpu %s  %s\n"
+			"cpu %i  gpu %i  clocks %s\n"
+			"capture %i  dropped %i  %4.2f ms%s",
+			FrameTimes.GetAverage(), FrameTimes.GetMax(), CpuTimes.GetAverage(),
+			gpuText, copiesPerSecond, skippedPerSecond,
+			scene.ContentStatic ? "yes" : "no ", partialPerSecond, ( 1.0f - scene.ScreenCrop.Area() ) * 100.0f,
+			streamFps, StreamIntervals.GetStdDev(),
+			jniPerFrame, scene.OverlayActive ? "on" : "off", scene.ExtraScreens.GetSizeI() + 1, scene.Compositor.GetFocus(),
+			Cinema.app->GetEyeBufferParms().multisamples, Cinema.app->GetEyeBufferParms().resolution,
+			eyeGpuText, Cinema.EyeBuffers.GetStateName(), Cinema.CpuLevel, Cinema.GpuLevel, Cinema.Clocks.GetReason(),
+			scene.Capture.GetCaptured(), scene.Capture.GetDropped(), scene.Capture.GetAverageFrameMs(),
+			scene.Capture.IsClipRunning() ? "  rec" : "" );
+	Text->SetText( TextBuffer );
+
+	// newest frame on the right
+	const int count = FrameTimes.GetCount() < GRAPH_BARS ? FrameTimes.GetCount() : GRAPH_BARS;
+	for ( int i = 0; i < GRAPH_BARS; i++ )
+	{
+		UIImage * bar = Bars[GRAPH_BARS - 1 - i];
+		if ( i >= count )
+		{
+			bar->SetVisible( false );
+			continue;
+		}
+
+		const float ms = FrameTimes.GetRecent( i );
+		const float height = Alg::Clamp( ms / BAR_MAX_MS, 0.02f, 1.0f ) * BAR_MAX_HEIGHT;
+		bar->SetVisible( true );
+		bar->SetLocalScale( Vector3f( 1.0f, height, 1.0f ) );
+		bar->SetLocalPosition( Vector3f( ( GRAPH_BARS / 2 - 1 - i ) * BAR_WIDTH, GRAPH_BASE + height * 0.5f, 1.0f ) * VRMenuObject::DEFAULT_TEXEL_SCALE );
+		bar->SetColor( ms < 17.5f ? Vector4f( 0.2f, 0.9f, 0.2f, 1.0f ) :
+				( ms < 25.0f ? Vector4f( 0.9f, 0.9f, 0.2f, 1.0f ) : Vector4f( 0.9f, 0.2f, 0.2f, 1.0f ) ) );
+	}
+}
+
+} // namespace VRMatterStreamTheater
@@ -0,0 +1,103 @@
+/************************************************************************************
+
+Filename    :   PerfHud.h
+Content     :	In-headset performance overlay
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( PerfHud_h )
+#define PerfHud_h
+
+#include "App.h"
+#include "UI/UIMenu.h"
+#include "UI/UIContainer.h"
+#include "UI/UILabel.h"
+#include "UI/UIImage.h"
+#include "UI/UITexture.h"
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+class CinemaApp;
+
+//==============================================================
+// PerfRing
+// The last few seconds of a per-frame value
+class PerfRing
+{
+public:
+	static const int	MAX_VALUES = 128;
+
+						PerfRing() : Next( 0 ), Count( 0 ) {}
+
+	void				Add( const float value );
+	void				Clear() { Next = 0; Count = 0; }
+
+	int					GetCount() const { return Count; }
+	// 0 is the newest
+	float				GetRecent( const int age ) const { return Values[( Next - 1 - age + MAX_VALUES ) % MAX_VALUES]; }
+	float				GetAverage() const;
+	float				GetMax() const;
+	float				GetStdDev() const;
+
+private:
+	float				Values[MAX_VALUES];
+	int					Next;
+	int					Count;
+};
+
+//==============================================================
+// PerfHud
+// Collects counters every frame, but only touches the menu a few times
+// a second so it doesn't show up in the numbers it's displaying.
+class PerfHud
+{
+public:
+	static const int	GRAPH_BARS = 60;
+
+						PerfHud( CinemaApp & cinema );
+
+	// cpuSeconds is the time the app spent in its own frame
+	void				Frame( const VrFrame & vrFrame, const float cpuSeconds );
+
+	bool				Enabled;	// saved as ShowPerfHud
+
+private:
+	CinemaApp &			Cinema;
+
+	UIMenu *			Menu;
+	UIContainer *		Panel;
+	UILabel *			Text;
+	Array<UIImage *>	Bars;
+	UITexture			BarTexture;
+
+	PerfRing			FrameTimes;
+	PerfRing			CpuTimes;
+	PerfRing			StreamIntervals;
+
+	int					LastStreamFrames;
+	double				LastStreamTime;
+	int					LastJniCalls;
+	int					LastCopiesPerformed;
+	int					LastCopiesSkipped;
+	int					LastPartialCopies;
+	int					FramesSinceRefresh;
+	double				LastRefreshTime;
+
+	char				TextBuffer[512];
+
+	void				Create( OvrGuiSys & guiSys );
+	void				Refresh( const double now );
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // PerfHud_h
@@ -0,0 +1,72 @@
+/************************************************************************************
+
+Filename    :   PoseHistory.cpp
+Content     :	Recent head poses, looked up by stream timestamp
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "PoseHistory.h"
+
+namespace VRMatterStreamTheater {
+
+const int PoseHistory::MAX_POSES;
+
+PoseHistory::PoseHistory() :
+	Next( 0 ),
+	Count( 0 )
+
+{
+}
+
+void PoseHistory::Clear()
+{
+	Next = 0;
+	Count = 0;
+}
+
+void PoseHistory::Record( const long time, const Matrix4f & pose )
+{
+	Times[Next] = time;
+	Poses[Next] = pose;
+	Next = ( Next + 1 ) % MAX_POSES;
+	if ( Count < MAX_POSES )
+	{
+		Count++;
+	}
+}
+
+bool PoseHistory::GetPoseAtTime( const long time, Matrix4f & pose ) const
+{
+	if ( Count == 0 )
+	{
+		return false;
+	}
+
+	// oldest is 0, find the first entry with Times >= time
+	int low = 0;
+	int high = Count - 1;
+	while ( low < high )
+	{
+		const int mid = ( low + high ) / 2;
+		if ( Times[Index( mid )] < time )
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	pose = Poses[Index( low )];
+	return true;
+}
+
+} // namespace VRMatterStreamTheater
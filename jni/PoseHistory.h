@@ -0,0 +1,55 @@
+/************************************************************************************
+
+Filename    :   PoseHistory.h
+Content     :	Recent head poses, looked up by stream timestamp
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( PoseHistory_h )
+#define PoseHistory_h
+
+#include "Kernel/OVR_Math.h"
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+//==============================================================
+// PoseHistory
+// A fixed ring of timestamped poses.  Times only go forward, so a
+// lookup is a binary search and nothing is allocated per frame.
+class PoseHistory
+{
+public:
+	static const int	MAX_POSES = 256;	// a few seconds at 60Hz, far more than any latency setting
+
+						PoseHistory();
+
+	void				Clear();
+	void				Record( const long time, const Matrix4f & pose );
+
+	// the first pose recorded at or after time, or the newest one when time is
+	// later than all of them.  Returns false if nothing has been recorded.
+	bool				GetPoseAtTime( const long time, Matrix4f & pose ) const;
+
+	int					GetCount() const { return Count; }
+
+private:
+	long				Times[MAX_POSES];
+	Matrix4f			Poses[MAX_POSES];
+	int					Next;
+	int					Count;
+
+	int					Index( const int age ) const { return ( Next - Count + age + MAX_POSES ) % MAX_POSES; }
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // PoseHistory_h
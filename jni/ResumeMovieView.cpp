@@ -21,6 +21,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "ResumeMovieComponent.h"
 #include "PackageFiles.h"
 #include "CinemaStrings.h"
+#include "TraceRecorder.h"
 
 namespace VRMatterStreamTheater {
 
@@ -45,6 +46,7 @@ ResumeMovieView::~ResumeMovieView()
 void ResumeMovieView::OneTimeInit( const char * launchIntent )
 {
 	LOG( "ResumeMovieView::OneTimeInit" );
+	TRACE_SCOPE( "ResumeMovieView::OneTimeInit" );
 
 	const double start = vrapi_GetTimeInSeconds();
 
@@ -243,9 +245,7 @@ void ResumeMovieView::ResumeChoice( int itemNum )
 Matrix4f ResumeMovieView::Frame( const VrFrame & vrFrame )
 {
 	// We want 4x MSAA in the selection screen
-	ovrEyeBufferParms eyeBufferParms = Cinema.app->GetEyeBufferParms();
-	eyeBufferParms.multisamples = 4;
-	Cinema.app->SetEyeBufferParms( eyeBufferParms );
+	Cinema.SetEyeBufferCeiling( EyeBufferLevel( 4, 1024 ) );
 
 	if ( Menu->IsClosedOrClosing() && !Menu->IsOpenOrOpening() )
 	{
@@ -19,12 +19,101 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "Native.h"
 #include "SceneManager.h"
 #include "VRMenu/GuiSys.h"
+#include "TraceRecorder.h"
+#include "AsyncLog.h"
+#include <stdlib.h>
+#include <string.h>
 #include <sys/system_properties.h>
 
 
 namespace VRMatterStreamTheater
 {
 
+static const int	IDLE_STATIC_SAMPLES		= 30;		// about half a second of an unchanged stream
+static const int	WAKE_CHANGED_SAMPLES	= 3;		// a cursor blinks, scrolling and video keep changing
+static const float	WAKE_CHANGED_AREA		= 0.25f;	// anything bigger isn't worth a partial copy
+static const double	IDLE_REFRESH_SECONDS	= 1.0;		// full copy for changes too faint for the sample
+static const double	STEREO_SAMPLE_SECONDS	= 0.5;		// layout detection doesn't need every frame
+static const double	CROP_SAMPLE_SECONDS		= 0.5;
+
+static const int	TEST_SCREEN_WIDTH		= 640;
+static const int	TEST_SCREEN_HEIGHT		= 360;
+static const float	TEST_SCREEN_FPS			= 30.0f;
+static const float	TEST_SCREEN_GAP			= 0.1f;		// meters between them and the stream's screen
+
+//=======================================================================================
+
+// Works out the stereo layout and the picture bounds of one stream sample
+// on a worker, so the GL thread only pays for copying the sample out.
+// Finish hands the results to the detectors, unless the stream changed
+// in the meantime.
+class StreamAnalysisTask : public BackgroundTask
+{
+public:
+						StreamAnalysisTask( SceneManager & scene, UByte * pixels, const int width, const int height,
+								const bool stereo, const bool crop, CancelToken * token ) :
+							BackgroundTask( TASK_PRIORITY_NORMAL, token ),
+							Scene( scene ),
+							Pixels( pixels ),
+							Width( width ),
+							Height( height ),
+							Stereo( stereo ),
+							Crop( crop ),
+							Analysis(),
+							Analyzed( false ),
+							Picture() {}
+	virtual				~StreamAnalysisTask() { free( Pixels ); }
+
+	virtual void		Run();
+	virtual void		Finish();
+
+private:
+	SceneManager &		Scene;
+	UByte *				Pixels;
+	int					Width;
+	int					Height;
+	bool				Stereo;
+	bool				Crop;
+	StereoSampleAnalysis	Analysis;
+	bool				Analyzed;
+	ContentRect			Picture;
+};
+
+void StreamAnalysisTask::Run()
+{
+	TRACE_SCOPE( "StreamAnalysisTask::Run" );
+	if ( Stereo )
+	{
+		Analyzed = Analysis.Analyze( Pixels, Width, Height );
+	}
+	if ( Crop )
+	{
+		Picture = BorderDetector::FindPicture( Pixels, Width, Height );
+	}
+}
+
+void StreamAnalysisTask::Finish()
+{
+	if ( Scene.PendingAnalysis == this )
+	{
+		Scene.PendingAnalysis = NULL;
+	}
+	if ( IsCancelled() )
+	{
+		return;
+	}
+	if ( Analyzed )
+	{
+		Scene.StereoDetector.AddAnalysis( Analysis );
+	}
+	if ( Crop )
+	{
+		Scene.BorderDetect.AddPicture( Picture );
+	}
+}
+
+//=======================================================================================
+
 SceneManager::SceneManager( CinemaApp &cinema ) :
 	Cinema( cinema ),
 	StaticLighting(),
@@ -49,6 +138,38 @@ SceneManager::SceneManager( CinemaApp &cinema ) :
 	CurrentMipMappedMovieTexture( 0 ),
 	MipMappedMovieTextures(),
 	MipMappedMovieFBOs(),
+	MipMappedMovieSerial( 0 ),
+	StreamFramesLatched( 0 ),
+	CopiesPerformed( 0 ),
+	CopiesSkipped( 0 ),
+	OverlayActive( false ),
+	CopyTimer(),
+	PartialCopies( 0 ),
+	DetectStaticContent( true ),
+	ContentStatic( false ),
+	StreamSampler(),
+	ChangeDetector(),
+	StaticSamples( 0 ),
+	ChangedSamples( 0 ),
+	UncopiedFrame( false ),
+	LastFullCopyTime( 0.0 ),
+	AutoStereoLayout( true ),
+	StereoDetector(),
+	LastStereoSampleTime( 0.0 ),
+	AnalysisToken( CancelToken::Create() ),
+	PendingAnalysis( NULL ),
+	AutoCrop( true ),
+	BorderDetect(),
+	LastCropSampleTime( 0.0 ),
+	ScreenCrop( ContentRect::Full() ),
+	FullTextureWidth( 0 ),
+	FullTextureHeight( 0 ),
+	ThumbnailSamplers(),
+	Capture( cinema.Tasks ),
+	ExtraScreens(),
+	Compositor(),
+	OverlayScreen( 0 ),
+	TestScreens( false ),
 	ScreenVignetteTexture( 0 ),
 	ScreenVignetteSbsTexture( 0 ),
 	SceneProgramIndex( SCENE_PROGRAM_DYNAMIC_ONLY ),
@@ -62,7 +183,9 @@ SceneManager::SceneManager( CinemaApp &cinema ) :
 	SceneScreenBounds(),
 	AllowMove( false ),
 	VoidedScene( false ),
-	osLollipop( false )
+	osLollipop( false ),
+	LastStreamTimestamp( 0 ),
+	ReplayStreamFrame( false )
 
 {
 	MipMappedMovieTextures[0] = MipMappedMovieTextures[1] = MipMappedMovieTextures[2] = 0;
@@ -71,6 +194,7 @@ SceneManager::SceneManager( CinemaApp &cinema ) :
 void SceneManager::OneTimeInit( const char * launchIntent )
 {
 	LOG( "SceneManager::OneTimeInit" );
+	TRACE_SCOPE( "SceneManager::OneTimeInit" );
 
 	const double start = vrapi_GetTimeInSeconds();
 
@@ -88,6 +212,9 @@ void SceneManager::OneTimeInit( const char * launchIntent )
 		osLollipop = true;
 	}
 
+	CopyTimer.Init();
+	Capture.SetDirectory( Cinema.SDCardDir( "Pictures/StreamTheater/Captures/" ) );
+
 	LOG( "SceneManager::OneTimeInit: %3.1f seconds", vrapi_GetTimeInSeconds() - start );
 }
 
@@ -95,6 +222,10 @@ void SceneManager::OneTimeShutdown()
 {
 	LOG( "SceneManager::OneTimeShutdown" );
 
+	// the scheduler has finished every analysis by now
+	AnalysisToken->Release();
+	AnalysisToken = NULL;
+
 	// Free GL resources
 
 	UnitSquare.Free();
@@ -110,6 +241,15 @@ void SceneManager::OneTimeShutdown()
 		glDeleteTextures( 1, & ScreenVignetteSbsTexture );
 		ScreenVignetteSbsTexture = 0;
 	}
+
+	CopyTimer.Shutdown();
+	StreamSampler.Shutdown();
+	for ( int i = 0; i < THUMBNAIL_COUNT; i++ )
+	{
+		ThumbnailSamplers[i].Shutdown();
+	}
+	Capture.Shutdown();
+	RemoveScreens();
 }
 
 //=========================================================================================
@@ -161,6 +301,7 @@ static float YawForMatrix( const Matrix4f &m )
 void SceneManager::SetSceneModel( const SceneDef &sceneDef )
 {
 	LOG( "SetSceneModel %s", sceneDef.SceneModel->FileName.ToCStr() );
+	Cinema.StartClockBurst( CLOCK_BURST_SCENE_LOAD );
 
 	VoidedScene = false;
 	UseOverlay = true;
@@ -355,56 +496,20 @@ Vector2f SceneManager::GetScreenSize() const
 
 Vector3f SceneManager::GetFreeScreenScale() const
 {
-	// Scale is stored in a form that feels linear, raise to exponent to
-	// get value to apply.
-	const float applyScale = powf( 2.0f, FreeScreenScale );
-
-	// adjust size based on aspect ratio
-	float scaleX = 1.0f;
-	float scaleY = ( CurrentMovieWidth == 0 ) ? 1.0f : (float)CurrentMovieHeight / CurrentMovieWidth;
-	if ( scaleY > 0.6f )
-	{
-		scaleX *= 0.6f / scaleY;
-		scaleY = 0.6f;
-	}
-
-	return Vector3f( applyScale * scaleX, applyScale * scaleY, applyScale );
+	const int width = (int)( CurrentMovieWidth * ( ScreenCrop.X1 - ScreenCrop.X0 ) + 0.5f );
+	const int height = (int)( CurrentMovieHeight * ( ScreenCrop.Y1 - ScreenCrop.Y0 ) + 0.5f );
+	return VRMatterStreamTheater::FreeScreenScale( FreeScreenScale, width, height );
 }
 
 Matrix4f SceneManager::FreeScreenMatrix() const
 {
-	const Vector3f scale = GetFreeScreenScale();
-	return FreeScreenPose *
-			Matrix4f::Translation( 0, 0, -FreeScreenDistance * scale.z ) *
-			Matrix4f::Scaling( scale );
+	return VRMatterStreamTheater::FreeScreenMatrix( FreeScreenPose, FreeScreenDistance, GetFreeScreenScale() );
 }
 
 // Aspect is width / height
 Matrix4f SceneManager::BoundsScreenMatrix( const Bounds3f & bounds, const float movieAspect ) const
 {
-	const Vector3f size = bounds.b[1] - bounds.b[0];
-	const Vector3f center = bounds.b[0] + size * 0.5f;
-	const float	screenHeight = size.y;
-	const float screenWidth = OVR::Alg::Max( size.x, size.z );
-	float widthScale;
-	float heightScale;
-	float aspect = ( movieAspect == 0.0f ) ? 1.0f : movieAspect;
-	if ( screenWidth / screenHeight > aspect )
-	{	// screen is wider than movie, clamp size to height
-		heightScale = screenHeight * 0.5f;
-		widthScale = heightScale * aspect;
-	}
-	else
-	{	// screen is taller than movie, clamp size to width
-		widthScale = screenWidth * 0.5f;
-		heightScale = widthScale / aspect;
-	}
-
-	const float rotateAngle = ( size.x > size.z ) ? 0.0f : M_PI * 0.5f;
-
-	return	Matrix4f::Translation( center ) *
-			Matrix4f::RotationY( rotateAngle ) *
-			Matrix4f::Scaling( widthScale, heightScale, 1.0f );
+	return VRMatterStreamTheater::BoundsScreenMatrix( bounds, movieAspect );
 }
 
 Matrix4f SceneManager::ScreenMatrix() const
@@ -415,8 +520,9 @@ Matrix4f SceneManager::ScreenMatrix() const
 	}
 	else
 	{
-		return BoundsScreenMatrix( SceneScreenBounds,
-			( CurrentMovieHeight == 0 ) ? 1.0f : ( (float)CurrentMovieWidth / CurrentMovieHeight ) );
+		const float width = CurrentMovieWidth * ( ScreenCrop.X1 - ScreenCrop.X0 );
+		const float height = CurrentMovieHeight * ( ScreenCrop.Y1 - ScreenCrop.Y0 );
+		return BoundsScreenMatrix( SceneScreenBounds, ( height <= 0.0f ) ? 1.0f : ( width / height ) );
 	}
 }
 
@@ -430,6 +536,19 @@ bool SceneManager::GetUseOverlay() const
 	return UseOverlay;
 }
 
+void SceneManager::SetMovieFormat( const MovieFormat format )
+{
+	if ( format == VT_LEFT_RIGHT_3D && CurrentMovieFormat != VT_LEFT_RIGHT_3D )
+	{
+		CurrentMovieWidth /= 2;
+	}
+	if ( format != VT_LEFT_RIGHT_3D && CurrentMovieFormat == VT_LEFT_RIGHT_3D )
+	{
+		CurrentMovieWidth *= 2;
+	}
+	CurrentMovieFormat = format;
+}
+
 void SceneManager::ClearMovie()
 {
 	Native::StopMovie( Cinema.app );
@@ -444,6 +563,8 @@ void SceneManager::ClearMovie()
 
 	delete MovieTexture;
 	MovieTexture = NULL;
+
+	ResetStaticContent();
 }
 
 void SceneManager::SetFreeScreenPose( const Matrix4f & headPose )
@@ -628,7 +749,7 @@ bool SceneManager::Command( const char * msg )
 {
 	// Always include the space in MatchesHead to prevent problems
 	// with commands with matching prefixes.
-	LOG( "SceneManager::Command: %s", msg );
+	SLOG_DEBUG( LOG_CATEGORY_SCENE, "SceneManager::Command: %s", msg );
 
 	if ( MatchesHead( "newVideo ", msg ) )
 	{
@@ -689,6 +810,9 @@ bool SceneManager::Command( const char * msg )
 
 		MovieTexture->SetDefaultBufferSize(width, height);
 
+		StreamSampler.SetSourceSize( width, height );
+		ResetStaticContent();
+
 		// Disable overlay on larger movies to reduce judder
 		long numberOfPixels = MovieTextureWidth * MovieTextureHeight;
 		LOG( "Movie size: %dx%d = %d pixels", MovieTextureWidth, MovieTextureHeight, numberOfPixels );
@@ -735,35 +859,10 @@ bool SceneManager::Command( const char * msg )
 
 		//Cinema.MovieLoaded( CurrentMovieWidth, CurrentMovieHeight, MovieDuration );
 
-		// Create the texture that we will mip map from the external image
-		for ( int i = 0 ; i < 3 ; i++ )
-		{
-			if ( MipMappedMovieFBOs[i] )
-			{
-				glDeleteFramebuffers( 1, &MipMappedMovieFBOs[i] );
-			}
-			if ( MipMappedMovieTextures[i] )
-			{
-				glDeleteTextures( 1, &MipMappedMovieTextures[i] );
-			}
-			glGenTextures( 1, &MipMappedMovieTextures[i] );
-			glBindTexture( GL_TEXTURE_2D, MipMappedMovieTextures[i] );
-
-			glTexImage2D( GL_TEXTURE_2D, 0, Cinema.app->GetFramebufferIsSrgb() ? GL_SRGB8_ALPHA8 :GL_RGBA,
-					MovieTextureWidth, MovieTextureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
-
-			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
-			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
-			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
-			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-
-			glGenFramebuffers( 1, &MipMappedMovieFBOs[i] );
-			glBindFramebuffer( GL_FRAMEBUFFER, MipMappedMovieFBOs[i] );
-			glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
-					MipMappedMovieTextures[i], 0 );
-			glBindFramebuffer( GL_FRAMEBUFFER, 0 );
-		}
-		glBindTexture( GL_TEXTURE_2D, 0 );
+		FullTextureWidth = MovieTextureWidth;
+		FullTextureHeight = MovieTextureHeight;
+		ScreenCrop = ContentRect::Full();
+		CreateMovieTextures();
 
 		return true;
 	}
@@ -771,95 +870,53 @@ bool SceneManager::Command( const char * msg )
 	return false;
 }
 
-/*
- * DrawEyeView
- */
-Matrix4f SceneManager::DrawEyeView( const int eye, const float fovDegrees )
+// Create the textures that we will mip map from the external image, at
+// MovieTextureWidth x MovieTextureHeight.
+void SceneManager::CreateMovieTextures()
 {
-	// allow stereo movies to also be played in mono
-	const int stereoEye = ForceMono ? 0 : eye;
-
-	if ( SceneInfo.UseDynamicProgram )
+	for ( int i = 0 ; i < 3 ; i++ )
 	{
-		// lights fading in and out, always on if no movie loaded
-		const float cinemaLights = ( ( MovieTextureWidth > 0 ) /*&& !SceneInfo.UseFreeScreen*/ ) ?
-				(float)StaticLighting.Value( vrapi_GetTimeInSeconds() ) : 1.0f;
-
-		if ( cinemaLights <= 0.0f )
-		{
-			if ( SceneProgramIndex != SCENE_PROGRAM_DYNAMIC_ONLY )
-			{
-				// switch to dynamic-only to save GPU
-				SetSceneProgram( SCENE_PROGRAM_DYNAMIC_ONLY, SCENE_PROGRAM_ADDITIVE );
-			}
-		}
-		else if ( cinemaLights >= 1.0f )
+		if ( MipMappedMovieFBOs[i] )
 		{
-			if ( SceneProgramIndex != SCENE_PROGRAM_STATIC_ONLY )
-			{
-				// switch to static-only to save GPU
-				SetSceneProgram( SCENE_PROGRAM_STATIC_ONLY, SCENE_PROGRAM_ADDITIVE );
-			}
+			glDeleteFramebuffers( 1, &MipMappedMovieFBOs[i] );
 		}
-		else
+		if ( MipMappedMovieTextures[i] )
 		{
-			if ( SceneProgramIndex != SCENE_PROGRAM_STATIC_DYNAMIC )
-			{
-				// switch to static+dynamic lighting
-				SetSceneProgram( SCENE_PROGRAM_STATIC_DYNAMIC, SCENE_PROGRAM_ADDITIVE );
-			}
+			glDeleteTextures( 1, &MipMappedMovieTextures[i] );
 		}
+		glGenTextures( 1, &MipMappedMovieTextures[i] );
+		glBindTexture( GL_TEXTURE_2D, MipMappedMovieTextures[i] );
 
-		glUseProgram( Cinema.ShaderMgr.ScenePrograms[SceneProgramIndex].program );
-		glUniform4f( Cinema.ShaderMgr.ScenePrograms[SceneProgramIndex].uColor, 1.0f, 1.0f, 1.0f, cinemaLights );
-		glUseProgram( Cinema.ShaderMgr.ScenePrograms[SCENE_PROGRAM_ADDITIVE].program );
-		glUniform4f( Cinema.ShaderMgr.ScenePrograms[SCENE_PROGRAM_ADDITIVE].uColor, 1.0f, 1.0f, 1.0f, cinemaLights );
-
-		// Bind the mip mapped movie texture to Texture2 so it can be sampled from the vertex program for scene lighting.
-		glActiveTexture( GL_TEXTURE2 );
-		glBindTexture( GL_TEXTURE_2D, MipMappedMovieTextures[CurrentMipMappedMovieTexture] );
-	}
-
-	const bool drawScreen = ( SceneScreenSurface || SceneInfo.UseFreeScreen || SceneInfo.LobbyScreen ) && MovieTexture && ( CurrentMovieWidth > 0 );
-
-	// otherwise cracks would show overlay texture
-	glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
-	glClear( GL_COLOR_BUFFER_BIT );
-
-//	if ( !SceneInfo.UseFreeScreen )
-	{
-		Scene.DrawEyeView( eye, fovDegrees );
-	}
-
-	const Matrix4f mvp = Scene.MvpForEye( eye, fovDegrees );
-
-	// draw the screen on top
-	if ( !drawScreen )
-	{
-		Cinema.app->GetFrameParms().WarpProgram = VRAPI_FRAME_PROGRAM_SIMPLE;
-		return mvp;
-	}
+		glTexImage2D( GL_TEXTURE_2D, 0, Cinema.app->GetFramebufferIsSrgb() ? GL_SRGB8_ALPHA8 :GL_RGBA,
+				MovieTextureWidth, MovieTextureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
 
-	if ( !SceneInfo.LobbyScreen )
-	{
-		glDisable( GL_DEPTH_TEST );
-	}
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
 
-	// If we are using the free screen, we still need to draw the surface with black
-	if ( FreeScreenActive && !SceneInfo.UseFreeScreen && SceneScreenSurface )
-	{
-		const GlProgram * prog = &Cinema.ShaderMgr.ScenePrograms[0];
-		glUseProgram( prog->program );
-		glUniformMatrix4fv( prog->uMvp, 1, GL_FALSE, mvp.Transposed().M[0] );
-		SceneScreenSurface->geo.Draw();
+		glGenFramebuffers( 1, &MipMappedMovieFBOs[i] );
+		glBindFramebuffer( GL_FRAMEBUFFER, MipMappedMovieFBOs[i] );
+		glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+				MipMappedMovieTextures[i], 0 );
+		glBindFramebuffer( GL_FRAMEBUFFER, 0 );
 	}
+	glBindTexture( GL_TEXTURE_2D, 0 );
+}
 
-	const GlProgram * prog = &Cinema.ShaderMgr.MovieExternalUiProgram;
-	glUseProgram( prog->program );
-	glUniform4f( prog->uColor, 1, 1, 1, 0.0f );
-
-	glVertexAttrib4f( 2, 1.0f, 1.0f, 1.0f, 1.0f );	// no color attributes on the surface verts, so force to 1.0
+// Maps 0-1 screen texture coordinates to the cropped part of the stream.
+Matrix4f SceneManager::ScreenCropMatrix() const
+{
+	return Matrix4f(
+			ScreenCrop.X1 - ScreenCrop.X0, 0, 0, ScreenCrop.X0,
+			0, ScreenCrop.Y1 - ScreenCrop.Y0, 0, ScreenCrop.Y0,
+			0, 0, 1, 0,
+			0, 0, 0, 1 );
+}
 
+// Picks the eye's half of a 3D stream, or rotates a 2D one
+static Matrix4f MovieTexMatrix( const MovieFormat format, const int rotation, const int stereoEye )
+{
 	const Matrix4f stretchTop(
 			1, 0, 0, 0,
 			0, 0.5f, 0, 0,
@@ -912,7 +969,7 @@ Matrix4f SceneManager::DrawEyeView( const int eye, const float fovDegrees )
 
 	Matrix4f texMatrix;
 
-	switch ( CurrentMovieFormat )
+	switch ( format )
 	{
 		case VT_LEFT_RIGHT_3D_CROP:
 			texMatrix = ( stereoEye ? cropRight : cropLeft );
@@ -926,7 +983,7 @@ Matrix4f SceneManager::DrawEyeView( const int eye, const float fovDegrees )
 			texMatrix = ( stereoEye ? stretchBottom : stretchTop );
 			break;
 		default:
-			switch( MovieRotation )
+			switch( rotation )
 			{
 				case 0 :
 					texMatrix = Matrix4f::Identity();
@@ -944,12 +1001,107 @@ Matrix4f SceneManager::DrawEyeView( const int eye, const float fovDegrees )
 			break;
 	}
 
+	return texMatrix;
+}
+
+/*
+ * DrawEyeView
+ */
+Matrix4f SceneManager::DrawEyeView( const int eye, const float fovDegrees )
+{
+	// allow stereo movies to also be played in mono
+	const int stereoEye = ForceMono ? 0 : eye;
+
+	if ( SceneInfo.UseDynamicProgram )
+	{
+		// lights fading in and out, always on if no movie loaded
+		const float cinemaLights = ( ( MovieTextureWidth > 0 ) /*&& !SceneInfo.UseFreeScreen*/ ) ?
+				(float)StaticLighting.Value( vrapi_GetTimeInSeconds() ) : 1.0f;
+
+		if ( cinemaLights <= 0.0f )
+		{
+			if ( SceneProgramIndex != SCENE_PROGRAM_DYNAMIC_ONLY )
+			{
+				// switch to dynamic-only to save GPU
+				SetSceneProgram( SCENE_PROGRAM_DYNAMIC_ONLY, SCENE_PROGRAM_ADDITIVE );
+			}
+		}
+		else if ( cinemaLights >= 1.0f )
+		{
+			if ( SceneProgramIndex != SCENE_PROGRAM_STATIC_ONLY )
+			{
+				// switch to static-only to save GPU
+				SetSceneProgram( SCENE_PROGRAM_STATIC_ONLY, SCENE_PROGRAM_ADDITIVE );
+			}
+		}
+		else
+		{
+			if ( SceneProgramIndex != SCENE_PROGRAM_STATIC_DYNAMIC )
+			{
+				// switch to static+dynamic lighting
+				SetSceneProgram( SCENE_PROGRAM_STATIC_DYNAMIC, SCENE_PROGRAM_ADDITIVE );
+			}
+		}
+
+		glUseProgram( Cinema.ShaderMgr.ScenePrograms[SceneProgramIndex].program );
+		glUniform4f( Cinema.ShaderMgr.ScenePrograms[SceneProgramIndex].uColor, 1.0f, 1.0f, 1.0f, cinemaLights );
+		glUseProgram( Cinema.ShaderMgr.ScenePrograms[SCENE_PROGRAM_ADDITIVE].program );
+		glUniform4f( Cinema.ShaderMgr.ScenePrograms[SCENE_PROGRAM_ADDITIVE].uColor, 1.0f, 1.0f, 1.0f, cinemaLights );
+
+		// Bind the mip mapped movie texture to Texture2 so it can be sampled from the vertex program for scene lighting.
+		glActiveTexture( GL_TEXTURE2 );
+		glBindTexture( GL_TEXTURE_2D, MipMappedMovieTextures[CurrentMipMappedMovieTexture] );
+	}
+
+	const bool drawScreen = ( SceneScreenSurface || SceneInfo.UseFreeScreen || SceneInfo.LobbyScreen ) && MovieTexture && ( CurrentMovieWidth > 0 );
+
+	// otherwise cracks would show overlay texture
+	glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
+	glClear( GL_COLOR_BUFFER_BIT );
+
+//	if ( !SceneInfo.UseFreeScreen )
+	{
+		Scene.DrawEyeView( eye, fovDegrees );
+	}
+
+	const Matrix4f mvp = Scene.MvpForEye( eye, fovDegrees );
+
+	// draw the screen on top
+	if ( !drawScreen )
+	{
+		Cinema.app->GetFrameParms().WarpProgram = VRAPI_FRAME_PROGRAM_SIMPLE;
+		return mvp;
+	}
+
+	if ( !SceneInfo.LobbyScreen )
+	{
+		glDisable( GL_DEPTH_TEST );
+	}
+
+	// If we are using the free screen, we still need to draw the surface with black
+	if ( FreeScreenActive && !SceneInfo.UseFreeScreen && SceneScreenSurface )
+	{
+		const GlProgram * prog = &Cinema.ShaderMgr.ScenePrograms[0];
+		glUseProgram( prog->program );
+		glUniformMatrix4fv( prog->uMvp, 1, GL_FALSE, mvp.Transposed().M[0] );
+		SceneScreenSurface->geo.Draw();
+	}
+
+	const GlProgram * prog = &Cinema.ShaderMgr.MovieExternalUiProgram;
+	glUseProgram( prog->program );
+	glUniform4f( prog->uColor, 1, 1, 1, 0.0f );
+
+	glVertexAttrib4f( 2, 1.0f, 1.0f, 1.0f, 1.0f );	// no color attributes on the surface verts, so force to 1.0
+
+	const Matrix4f texMatrix = MovieTexMatrix( CurrentMovieFormat, MovieRotation, stereoEye );
+
 	//
 	// draw the movie texture
 	//
-	if ( !GetUseOverlay() || SceneInfo.LobbyScreen || ( SceneInfo.UseScreenGeometry && ( SceneScreenSurface != NULL ) ) )
+	if ( OverlayScreen != 0 || !GetUseOverlay() || SceneInfo.LobbyScreen || ( SceneInfo.UseScreenGeometry && ( SceneScreenSurface != NULL ) ) )
 	{
-		// no overlay
+		// no overlay, or another screen has it
+		OverlayActive = false;
 		Cinema.app->GetFrameParms().WarpProgram = VRAPI_FRAME_PROGRAM_SIMPLE;
 		Cinema.app->GetFrameParms().Layers[VRAPI_FRAME_LAYER_TYPE_OVERLAY].Images[eye].TexId = 0;
 
@@ -959,19 +1111,22 @@ Matrix4f SceneManager::DrawEyeView( const int eye, const float fovDegrees )
 		glActiveTexture( GL_TEXTURE1 );
 		glBindTexture( GL_TEXTURE_2D, ScreenVignetteTexture );
 
-		glUniformMatrix4fv( prog->uTexm, 1, GL_FALSE, /* not transposed */
-				texMatrix.Transposed().M[0] );
 		// The UI is always identity for now, but we may scale it later
 		glUniformMatrix4fv( prog->uTexm2, 1, GL_FALSE, /* not transposed */
 				Matrix4f::Identity().Transposed().M[0] );
 
 		if ( !SceneInfo.LobbyScreen && SceneInfo.UseScreenGeometry && ( SceneScreenSurface != NULL ) )
 		{
+			// the screen in the model has its own aspect, so it shows the whole stream
+			glUniformMatrix4fv( prog->uTexm, 1, GL_FALSE, /* not transposed */
+					texMatrix.Transposed().M[0] );
 			glUniformMatrix4fv( prog->uMvp, 1, GL_FALSE, mvp.Transposed().M[0] );
 			SceneScreenSurface->geo.Draw();
 		}
 		else
 		{
+			glUniformMatrix4fv( prog->uTexm, 1, GL_FALSE, /* not transposed */
+					( ScreenCropMatrix() * texMatrix ).Transposed().M[0] );
 			const Matrix4f screenModel = ScreenMatrix();
 			const Matrix4f screenMvp = mvp * screenModel;
 			glUniformMatrix4fv( prog->uMvp, 1, GL_FALSE, screenMvp.Transposed().M[0] );
@@ -983,6 +1138,7 @@ Matrix4f SceneManager::DrawEyeView( const int eye, const float fovDegrees )
 	else
 	{
 		// use overlay
+		OverlayActive = true;
 		const Matrix4f screenModel = ScreenMatrix();
 		const ovrMatrix4f mv = Scene.ViewMatrixForEye( eye ) * screenModel;
 
@@ -996,10 +1152,75 @@ Matrix4f SceneManager::DrawEyeView( const int eye, const float fovDegrees )
 		Cinema.app->DrawScreenMask( screenMvp, 0.0f, 0.0f );
 	}
 
+	DrawExtraScreens( eye, mvp );
+
 	// The framework will automatically draw the floating elements on top of us now.
 	return mvp;
 }
 
+// After the stream's screen, so the one that is the overlay can take the
+// overlay layer over from it.  The others are drawn from their mip
+// mapped copy, which holds its rows bottom first.
+void SceneManager::DrawExtraScreens( const int eye, const Matrix4f & mvp )
+{
+	if ( ExtraScreens.GetSizeI() == 0 )
+	{
+		return;
+	}
+
+	const int stereoEye = ForceMono ? 0 : eye;
+	const Matrix4f flipY(
+			1, 0, 0, 0,
+			0, -1, 0, 1,
+			0, 0, 1, 0,
+			0, 0, 0, 1 );
+
+	const GlProgram & prog = Cinema.ShaderMgr.MovieUiProgram;
+	for ( int i = 0; i < ExtraScreens.GetSizeI(); i++ )
+	{
+		const StreamScreen * screen = ExtraScreens[i];
+		if ( !screen->HasFrame() )
+		{
+			continue;
+		}
+
+		const Matrix4f texMatrix = MovieTexMatrix( screen->Format, 0, stereoEye );
+		const Matrix4f screenModel = screen->ModelMatrix();
+		if ( OverlayScreen == i + 1 )
+		{
+			OverlayActive = true;
+			const ovrMatrix4f mv = Scene.ViewMatrixForEye( eye ) * screenModel;
+
+			Cinema.app->GetFrameParms().WarpProgram = VRAPI_FRAME_PROGRAM_MASKED_PLANE;
+			Cinema.app->GetFrameParms().Layers[VRAPI_FRAME_LAYER_TYPE_OVERLAY].Images[eye].TexId = screen->GetTexture();
+			Cinema.app->GetFrameParms().Layers[VRAPI_FRAME_LAYER_TYPE_OVERLAY].Images[eye].TexCoordsFromTanAngles = texMatrix * ovrMatrix4f_TanAngleMatrixFromUnitSquare( &mv );
+			Cinema.app->GetFrameParms().Layers[VRAPI_FRAME_LAYER_TYPE_OVERLAY].Images[eye].HeadPose = Cinema.app->GetHeadPoseForNextWarp();
+
+			const ovrMatrix4f screenMvp = mvp * screenModel;
+			Cinema.app->DrawScreenMask( screenMvp, 0.0f, 0.0f );
+			continue;
+		}
+
+		glUseProgram( prog.program );
+		glUniform4f( prog.uColor, 1, 1, 1, 0.0f );
+		glVertexAttrib4f( 2, 1.0f, 1.0f, 1.0f, 1.0f );
+
+		glActiveTexture( GL_TEXTURE0 );
+		glBindTexture( GL_TEXTURE_2D, screen->GetTexture() );
+		glActiveTexture( GL_TEXTURE1 );
+		glBindTexture( GL_TEXTURE_2D, ScreenVignetteTexture );
+
+		glUniformMatrix4fv( prog.uTexm, 1, GL_FALSE, /* not transposed */
+				( flipY * texMatrix ).Transposed().M[0] );
+		const Matrix4f screenMvp = mvp * screenModel;
+		glUniformMatrix4fv( prog.uMvp, 1, GL_FALSE, screenMvp.Transposed().M[0] );
+		UnitSquare.Draw();
+	}
+
+	glActiveTexture( GL_TEXTURE0 );
+	glBindTexture( GL_TEXTURE_2D, 0 );
+}
+
 /*
  * Frame()
  *
@@ -1007,6 +1228,8 @@ Matrix4f SceneManager::DrawEyeView( const int eye, const float fovDegrees )
  */
 Matrix4f SceneManager::Frame( const VrFrame & vrFrame )
 {
+	TRACE_SCOPE( "SceneManager::Frame" );
+
 	// disallow player movement
     VrFrame vrFrameWithoutMove = vrFrame;
     vrFrameWithoutMove.Input.sticks[0][0] = 0.0f;
@@ -1021,31 +1244,105 @@ Matrix4f SceneManager::Frame( const VrFrame & vrFrame )
 		ClearGhostsFrames--;
 	}
 
+	Capture.Update();
+
+	// anything other than a new stream frame that asked for a copy
+	const bool forcedUpdate = FrameUpdateNeeded;
+	ContentRect copyRect = ContentRect::Full();
+
 	// Check for new movie frames
 	// latch the latest movie frame to the texture.
 	if ( MovieTexture && CurrentMovieWidth )
 	{
+		TRACE_SCOPE( "SceneManager::TextureUpdate" );
 		glActiveTexture( GL_TEXTURE0 );
 		MovieTexture->Update();
 		glBindTexture( GL_TEXTURE_EXTERNAL_OES, 0 );
-		if ( MovieTexture->nanoTimeStamp != MovieTextureTimestamp )
+		bool newFrame = false;
+		if ( Cinema.Session.IsReplaying() )
 		{
-			MovieTextureTimestamp = MovieTexture->nanoTimeStamp;
-			FrameUpdateNeeded = true;
+			// the recorded stream frames stand in for whatever the live stream delivers
+			newFrame = ReplayStreamFrame;
+			FrameUpdateNeeded = FrameUpdateNeeded || newFrame;
 		}
+		else
+		{
+			if ( MovieTexture->nanoTimeStamp != MovieTextureTimestamp )
+			{
+				MovieTextureTimestamp = MovieTexture->nanoTimeStamp;
+				FrameUpdateNeeded = true;
+				newFrame = true;
+			}
 
-		// Currently on lollipop the surface texture isn't getting the timestamp set, so always update the image
-		if(osLollipop)
+			// Currently on lollipop the surface texture isn't getting the timestamp set, so always update the image
+			if(osLollipop)
+			{
+				FrameUpdateNeeded = true;
+
+				const long streamTimestamp = Native::getLastFrameTimestamp( Cinema.app );
+				if ( streamTimestamp != LastStreamTimestamp )
+				{
+					LastStreamTimestamp = streamTimestamp;
+					newFrame = true;
+				}
+			}
+		}
+		ReplayStreamFrame = false;
+		if ( newFrame )
+		{
+			Cinema.Latency.FrameLatched( vrapi_GetTimeInSeconds() );
+			Cinema.Session.RecordStreamFrame();
+			StreamFramesLatched++;
+		}
+		ContentRect changes;
+		if ( DetectStaticContent || AutoStereoLayout || AutoCrop )
 		{
-			FrameUpdateNeeded = true;
+			SampleStream( newFrame, changes );
+		}
+		if ( DetectStaticContent )
+		{
+			FrameUpdateNeeded = UpdateStaticContent( newFrame, forcedUpdate, changes, copyRect );
+		}
+		else
+		{
+			ContentStatic = false;
+		}
+		if ( AutoStereoLayout )
+		{
+			UpdateStereoLayout();
+		}
+		if ( UpdateScreenCrop() )
+		{
+			copyRect = ContentRect::Full();
+		}
+		if ( !FrameUpdateNeeded )
+		{
+			CopiesSkipped++;
 		}
 		Cinema.MovieScreenUpdated();
 	}
 
+	if ( TestScreens && CurrentMovieWidth > 0 )
+	{
+		TestScreens = false;
+		AddTestScreens();
+	}
+
+	// the screens next to the stream share the copy budget with it
+	const bool copyStream = ( ExtraScreens.GetSizeI() > 0 ) ? PlanScreenCopies( copyRect ) : FrameUpdateNeeded;
+
 	// build the mip maps
-	if ( FrameUpdateNeeded )
+	if ( copyStream )
 	{
+		TRACE_SCOPE( "SceneManager::Copy" );
 		FrameUpdateNeeded = false;
+		CopiesPerformed++;
+		const bool partialCopy = copyRect.Area() < 1.0f;
+		if ( partialCopy )
+		{
+			PartialCopies++;
+		}
+		CopyTimer.Begin();
 		CurrentMipMappedMovieTexture = (CurrentMipMappedMovieTexture+1)%3;
 		glActiveTexture( GL_TEXTURE1 );
 		if ( CurrentMovieFormat == VT_LEFT_RIGHT_3D || CurrentMovieFormat == VT_LEFT_RIGHT_3D_CROP || CurrentMovieFormat == VT_LEFT_RIGHT_3D_FULL )
@@ -1059,8 +1356,25 @@ Matrix4f SceneManager::Frame( const VrFrame & vrFrame )
 		glActiveTexture( GL_TEXTURE0 );
 		glBindFramebuffer( GL_FRAMEBUFFER, MipMappedMovieFBOs[CurrentMipMappedMovieTexture] );
 		glDisable( GL_DEPTH_TEST );
-		glDisable( GL_SCISSOR_TEST );
-		GL_InvalidateFramebuffer( INV_FBO, true, false );
+		if ( partialCopy )
+		{
+			// the rest of the texture is already current, so keep it; one
+			// extra pixel around the rect covers the sample's filtering.
+			// copyRect is in the stream, the texture only holds the crop.
+			const float cropWidth = ScreenCrop.X1 - ScreenCrop.X0;
+			const float cropHeight = ScreenCrop.Y1 - ScreenCrop.Y0;
+			const int x0 = Alg::Max( 0, (int)floorf( ( copyRect.X0 - ScreenCrop.X0 ) / cropWidth * MovieTextureWidth ) - 1 );
+			const int y0 = Alg::Max( 0, (int)floorf( ( copyRect.Y0 - ScreenCrop.Y0 ) / cropHeight * MovieTextureHeight ) - 1 );
+			const int x1 = Alg::Min( MovieTextureWidth, (int)ceilf( ( copyRect.X1 - ScreenCrop.X0 ) / cropWidth * MovieTextureWidth ) + 1 );
+			const int y1 = Alg::Min( MovieTextureHeight, (int)ceilf( ( copyRect.Y1 - ScreenCrop.Y0 ) / cropHeight * MovieTextureHeight ) + 1 );
+			glEnable( GL_SCISSOR_TEST );
+			glScissor( x0, y0, Alg::Max( 0, x1 - x0 ), Alg::Max( 0, y1 - y0 ) );
+		}
+		else
+		{
+			glDisable( GL_SCISSOR_TEST );
+			GL_InvalidateFramebuffer( INV_FBO, true, false );
+		}
 		glViewport( 0, 0, MovieTextureWidth, MovieTextureHeight );
 		if ( Cinema.app->GetFramebufferIsSrgb() )
 		{	// we need this copied without sRGB conversion on the top level
@@ -1070,6 +1384,8 @@ Matrix4f SceneManager::Frame( const VrFrame & vrFrame )
 		{
 			glBindTexture( GL_TEXTURE_EXTERNAL_OES, MovieTexture->textureId );
 			glUseProgram( Cinema.ShaderMgr.CopyMovieProgram.program );
+			glUniformMatrix4fv( Cinema.ShaderMgr.CopyMovieProgram.uTexm, 1, GL_FALSE, /* not transposed */
+					ScreenCropMatrix().Transposed().M[0] );
 			UnitSquare.Draw();
 			glBindTexture( GL_TEXTURE_EXTERNAL_OES, 0 );
 			if ( Cinema.app->GetFramebufferIsSrgb() )
@@ -1084,18 +1400,379 @@ Matrix4f SceneManager::Frame( const VrFrame & vrFrame )
 			glClearColor( 0.2f, 0.2f, 0.2f, 0.2f );
 			glClear( GL_COLOR_BUFFER_BIT );
 		}
+		glDisable( GL_SCISSOR_TEST );
 		glBindFramebuffer( GL_FRAMEBUFFER, 0 );
 
 		// texture 2 will hold the mip mapped screen
-		glActiveTexture( GL_TEXTURE2 );
-		glBindTexture( GL_TEXTURE_2D, MipMappedMovieTextures[CurrentMipMappedMovieTexture] );
-		glGenerateMipmap( GL_TEXTURE_2D );
-		glBindTexture( GL_TEXTURE_2D, 0 );
+		{
+			TRACE_SCOPE( "SceneManager::Mipmap" );
+			glActiveTexture( GL_TEXTURE2 );
+			glBindTexture( GL_TEXTURE_2D, MipMappedMovieTextures[CurrentMipMappedMovieTexture] );
+			glGenerateMipmap( GL_TEXTURE_2D );
+			glBindTexture( GL_TEXTURE_2D, 0 );
+		}
+		MipMappedMovieSerial++;
+		CopyTimer.End();
+
+		if ( CurrentMovieWidth > 0 )
+		{
+			Capture.FrameCopied( MipMappedMovieTextures[CurrentMipMappedMovieTexture], MovieTextureWidth, MovieTextureHeight );
+		}
 
 		GL_Flush();
+		Cinema.Latency.CopyDone( vrapi_GetTimeInSeconds() );
 	}
 
+	CopyExtraScreens();
+
 	return Scene.CenterViewMatrix();
 }
 
+void SceneManager::ResetStaticContent()
+{
+	StreamSampler.Flush();
+	ChangeDetector.Reset();
+	ContentStatic = false;
+	StaticSamples = 0;
+	ChangedSamples = 0;
+	CopiedChanges[0] = CopiedChanges[1] = ContentRect::Full();
+	UncopiedFrame = false;
+	StereoDetector.Reset();
+	BorderDetect.Reset();
+
+	// an analysis of the old stream mustn't vote for the new one
+	if ( PendingAnalysis != NULL )
+	{
+		AnalysisToken->Cancel();
+		AnalysisToken->Release();
+		AnalysisToken = CancelToken::Create();
+		PendingAnalysis = NULL;
+	}
+}
+
+// Hands finished samples to the detectors and starts one for a new frame.
+// changes is everything the samples saw change since the last call.
+void SceneManager::SampleStream( const bool newFrame, ContentRect & changes )
+{
+	const double now = vrapi_GetTimeInSeconds();
+	int width = 0;
+	int height = 0;
+	for ( const UByte * pixels = StreamSampler.MapResult( width, height ); pixels != NULL; pixels = StreamSampler.MapResult( width, height ) )
+	{
+		if ( DetectStaticContent )
+		{
+			const bool changed = ChangeDetector.Update( pixels, width, height );
+			if ( changed )
+			{
+				changes.Include( ChangeDetector.GetDirtyRect() );
+				StaticSamples = 0;
+				ChangedSamples++;
+			}
+			else
+			{
+				StaticSamples++;
+				ChangedSamples = 0;
+			}
+		}
+		// one analysis at a time, a busy pool just spaces them out
+		const bool stereo = AutoStereoLayout && now - LastStereoSampleTime >= STEREO_SAMPLE_SECONDS;
+		const bool crop = AutoCrop && now - LastCropSampleTime >= CROP_SAMPLE_SECONDS;
+		if ( ( stereo || crop ) && PendingAnalysis == NULL && AnalysisToken != NULL )
+		{
+			TRACE_SCOPE( "SceneManager::AnalyzeSample" );
+			if ( stereo )
+			{
+				LastStereoSampleTime = now;
+			}
+			if ( crop )
+			{
+				LastCropSampleTime = now;
+			}
+			UByte * copy = (UByte *)malloc( width * height * 4 );
+			if ( copy != NULL )
+			{
+				memcpy( copy, pixels, width * height * 4 );
+				PendingAnalysis = new StreamAnalysisTask( *this, copy, width, height, stereo, crop, AnalysisToken );
+				Cinema.Tasks.Submit( PendingAnalysis );
+			}
+		}
+		StreamSampler.ReleaseResult();
+	}
+
+	if ( newFrame )
+	{
+		StreamSampler.Sample( MovieTexture->textureId, Cinema.ShaderMgr.SampleMovieProgram, UnitSquare );
+	}
+}
+
+// Returns true if the movie texture should be copied this frame, and the
+// part of it that needs to be.  Samples come back a frame late, so while
+// idle a changed frame is copied one frame after it arrived.
+bool SceneManager::UpdateStaticContent( const bool newFrame, const bool forced, const ContentRect & changes, ContentRect & copyRect )
+{
+	if ( newFrame )
+	{
+		UncopiedFrame = true;
+	}
+
+	bool woke = false;
+	if ( ContentStatic )
+	{
+		if ( ChangedSamples >= WAKE_CHANGED_SAMPLES || changes.Area() > WAKE_CHANGED_AREA )
+		{
+			LOG( "SceneManager: stream is changing, copying every frame" );
+			ContentStatic = false;
+			woke = true;
+		}
+	}
+	else if ( StaticSamples >= IDLE_STATIC_SAMPLES )
+	{
+		LOG( "SceneManager: stream is static, copying changes only" );
+		ContentStatic = true;
+	}
+
+	const double now = vrapi_GetTimeInSeconds();
+	copyRect = ContentRect::Full();
+	bool copy = false;
+	if ( forced || woke )
+	{
+		copy = true;
+	}
+	else if ( !ContentStatic )
+	{
+		copy = newFrame;
+	}
+	else if ( !changes.IsEmpty() )
+	{
+		// the texture being written last saw the changes of two copies ago
+		copy = true;
+		copyRect = changes;
+		copyRect.Include( CopiedChanges[0] );
+		copyRect.Include( CopiedChanges[1] );
+	}
+	else if ( UncopiedFrame && now - LastFullCopyTime > IDLE_REFRESH_SECONDS )
+	{
+		copy = true;
+	}
+
+	if ( copy )
+	{
+		const bool full = copyRect.Area() >= 1.0f;
+		CopiedChanges[1] = CopiedChanges[0];
+		CopiedChanges[0] = full ? ContentRect::Full() : changes;
+		if ( full )
+		{
+			UncopiedFrame = false;
+			LastFullCopyTime = now;
+		}
+	}
+	return copy;
+}
+
+// A side by side mode the user already picked is kept, only the
+// layout itself is switched.
+void SceneManager::UpdateStereoLayout()
+{
+	MovieFormat format = CurrentMovieFormat;
+	switch ( StereoDetector.GetLayout() )
+	{
+		case STEREO_LAYOUT_MONO:
+			format = VT_2D;
+			break;
+		case STEREO_LAYOUT_SIDE_BY_SIDE:
+			if ( CurrentMovieFormat != VT_LEFT_RIGHT_3D && CurrentMovieFormat != VT_LEFT_RIGHT_3D_CROP && CurrentMovieFormat != VT_LEFT_RIGHT_3D_FULL )
+			{
+				format = VT_LEFT_RIGHT_3D_FULL;
+			}
+			break;
+		case STEREO_LAYOUT_TOP_BOTTOM:
+			if ( CurrentMovieFormat != VT_TOP_BOTTOM_3D && CurrentMovieFormat != VT_TOP_BOTTOM_3D_FULL )
+			{
+				format = VT_TOP_BOTTOM_3D;
+			}
+			break;
+		default:
+			break;
+	}
+
+	if ( format != CurrentMovieFormat )
+	{
+		LOG( "SceneManager: stream layout changed to %i (side by side %.2f, top/bottom %.2f)",
+				format, StereoDetector.GetSideBySideScore(), StereoDetector.GetTopBottomScore() );
+		SetMovieFormat( format );
+	}
+}
+
+// Only a plain 2D picture is cropped, 3D layouts and rotated streams
+// always show the whole stream.  The copy textures are made again at
+// the cropped size, which is where the copy and mip time is saved.
+// Returns true if the crop changed and the next copy has to be full.
+bool SceneManager::UpdateScreenCrop()
+{
+	ContentRect crop = ContentRect::Full();
+	if ( AutoCrop && CurrentMovieFormat == VT_2D && MovieRotation == 0 )
+	{
+		crop = BorderDetect.GetCrop();
+	}
+
+	if ( crop.X0 == ScreenCrop.X0 && crop.Y0 == ScreenCrop.Y0 && crop.X1 == ScreenCrop.X1 && crop.Y1 == ScreenCrop.Y1 )
+	{
+		return false;
+	}
+
+	ScreenCrop = crop;
+	MovieTextureWidth = Alg::Max( 1, (int)( FullTextureWidth * ( crop.X1 - crop.X0 ) + 0.5f ) );
+	MovieTextureHeight = Alg::Max( 1, (int)( FullTextureHeight * ( crop.Y1 - crop.Y0 ) + 0.5f ) );
+	CreateMovieTextures();
+
+	// every texture is new, the next copy has to fill all of it
+	CopiedChanges[0] = CopiedChanges[1] = ContentRect::Full();
+	FrameUpdateNeeded = true;
+
+	const int fullBytes = FullTextureWidth * FullTextureHeight * 4;
+	const int copyBytes = MovieTextureWidth * MovieTextureHeight * 4;
+	LOG( "SceneManager: screen cropped to %.3f %.3f - %.3f %.3f, copies are %ix%i, %i of %i bytes saved",
+			crop.X0, crop.Y0, crop.X1, crop.Y1, MovieTextureWidth, MovieTextureHeight, fullBytes - copyBytes, fullBytes );
+	return true;
+}
+
+void SceneManager::RequestMovieThumbnail( const MovieThumbnail thumbnail, const int maxWidth, const double tag )
+{
+	if ( CurrentMovieWidth == 0 || MovieTextureWidth == 0 || MipMappedMovieTextures[CurrentMipMappedMovieTexture] == 0 )
+	{
+		return;
+	}
+
+	// pick the largest mip level that fits
+	int level = 0;
+	int width = MovieTextureWidth;
+	int height = MovieTextureHeight;
+	while ( width > maxWidth && height > 1 )
+	{
+		level++;
+		width = Alg::Max( 1, width >> 1 );
+		height = Alg::Max( 1, height >> 1 );
+	}
+
+	// a new size drops the reads in flight, they were of the old textures
+	FrameSampler & sampler = ThumbnailSamplers[thumbnail];
+	sampler.SetReadSize( width, height );
+	sampler.ReadLevel( MipMappedMovieTextures[CurrentMipMappedMovieTexture], level, tag );
+}
+
+bool SceneManager::ReadMovieThumbnail( const MovieThumbnail thumbnail, Array<unsigned char> & luma, int & width, int & height, double & tag )
+{
+	FrameSampler & sampler = ThumbnailSamplers[thumbnail];
+	const UByte * rgba = sampler.MapResult( width, height, &tag );
+	if ( rgba == NULL )
+	{
+		return false;
+	}
+
+	luma.Resize( width * height );
+	for ( int i = 0; i < width * height; i++, rgba += 4 )
+	{
+		luma[i] = (unsigned char)( ( rgba[0] * 77 + rgba[1] * 150 + rgba[2] * 29 ) >> 8 );
+	}
+	sampler.ReleaseResult();
+
+	return true;
+}
+
+bool SceneManager::AddScreen( StreamScreen * screen )
+{
+	if ( ExtraScreens.GetSizeI() + 1 >= ScreenCompositor::MAX_SCREENS )
+	{
+		LOG( "SceneManager: no room for another screen" );
+		delete screen;
+		return false;
+	}
+	ExtraScreens.PushBack( screen );
+	return true;
+}
+
+void SceneManager::RemoveScreens()
+{
+	for ( int i = 0; i < ExtraScreens.GetSizeI(); i++ )
+	{
+		ExtraScreens[i]->Shutdown();
+		delete ExtraScreens[i];
+	}
+	ExtraScreens.Clear();
+	Compositor.Reset();
+	OverlayScreen = 0;
+}
+
+// Two test patterns either side of the stream's screen, half its height,
+// facing the same way.
+void SceneManager::AddTestScreens()
+{
+	const Matrix4f screenMatrix = ScreenMatrix();
+	const Vector3f center = screenMatrix.Transform( Vector3f( 0.0f ) );
+	const Vector3f halfRight = screenMatrix.Transform( Vector3f( 1.0f, 0.0f, 0.0f ) ) - center;
+	const Vector3f halfUp = screenMatrix.Transform( Vector3f( 0.0f, 1.0f, 0.0f ) ) - center;
+	const Vector3f right = halfRight.Normalized();
+	const Vector3f up = halfUp.Normalized();
+	const Vector3f back = right.Cross( up );
+	const Quatf orientation( Matrix4f(
+			right.x, up.x, back.x, 0,
+			right.y, up.y, back.y, 0,
+			right.z, up.z, back.z, 0,
+			0, 0, 0, 1 ) );
+
+	const float height = halfUp.Length();
+	const float width = height * TEST_SCREEN_WIDTH / TEST_SCREEN_HEIGHT;
+	for ( int side = -1; side <= 1; side += 2 )
+	{
+		SyntheticFrameSource * source = new SyntheticFrameSource( TEST_SCREEN_WIDTH, TEST_SCREEN_HEIGHT, TEST_SCREEN_FPS, side > 0 ? 1 : 0 );
+		StreamScreen * screen = new StreamScreen( source, Cinema.app->GetFramebufferIsSrgb() );
+		const float offset = halfRight.Length() + TEST_SCREEN_GAP + width * 0.5f;
+		screen->Pose = Posef( orientation, center + right * ( side * offset ) );
+		screen->Size = Vector2f( width, height );
+		AddScreen( screen );
+	}
+	LOG( "SceneManager: added %i test screens", ExtraScreens.GetSizeI() );
+}
+
+// Screen 0 is the stream.  Returns true if it gets copied this frame.  If
+// it doesn't FrameUpdateNeeded stays set, which makes the next copy a
+// full one, so a deferred partial copy can't leave a texture behind.
+bool SceneManager::PlanScreenCopies( const ContentRect & copyRect )
+{
+	const double now = vrapi_GetTimeInSeconds();
+	const Matrix4f view = Scene.CenterViewMatrix();
+	const bool overlayAllowed = GetUseOverlay() && !SceneInfo.LobbyScreen;
+	const int count = Alg::Min( ExtraScreens.GetSizeI() + 1, (int)ScreenCompositor::MAX_SCREENS );
+
+	CompositorScreen screens[ScreenCompositor::MAX_SCREENS];
+	screens[0].Pending = FrameUpdateNeeded;
+	screens[0].CopyPixels = (int)( MovieTextureWidth * MovieTextureHeight * copyRect.Area() );
+	screens[0].CanOverlay = overlayAllowed && !( SceneInfo.UseScreenGeometry && ( SceneScreenSurface != NULL ) );
+	GazeAnglesToScreen( view, ScreenMatrix(), screens[0].GazeAngle, screens[0].Radius );
+
+	for ( int i = 1; i < count; i++ )
+	{
+		StreamScreen * screen = ExtraScreens[i - 1];
+		screens[i].Pending = screen->Latch( now );
+		screens[i].CopyPixels = screen->CopyPixels();
+		screens[i].CanOverlay = overlayAllowed && ( screen->HasFrame() || screens[i].Pending );
+		GazeAnglesToScreen( view, screen->ModelMatrix(), screens[i].GazeAngle, screens[i].Radius );
+	}
+
+	Compositor.Plan( screens, count, now, ScreenDecisions );
+	OverlayScreen = Compositor.GetOverlay();
+	return ScreenDecisions[0].Copy;
+}
+
+void SceneManager::CopyExtraScreens()
+{
+	for ( int i = 0; i < ExtraScreens.GetSizeI() && i + 1 < ScreenCompositor::MAX_SCREENS; i++ )
+	{
+		if ( ScreenDecisions[i + 1].Copy )
+		{
+			ExtraScreens[i]->Copy();
+		}
+	}
+}
+
 } // namespace VRMatterStreamTheater
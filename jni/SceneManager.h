@@ -21,6 +21,15 @@ of patent rights can be found in the PATENTS file in the same directory.
 
 #include "ModelView.h"
 #include "Lerp.h"
+#include "GpuTimer.h"
+#include "FrameSampler.h"
+#include "ScreenCapture.h"
+#include "ScreenCompositor.h"
+#include "StreamScreen.h"
+#include "ContentChangeDetector.h"
+#include "StereoLayoutDetector.h"
+#include "BorderDetector.h"
+#include "ScreenMath.h"
 
 using namespace OVR;
 
@@ -73,6 +82,29 @@ public:
 
 	bool				GetUseOverlay() const;
 
+	// keeps CurrentMovieWidth right for the rift side by side mode, which shows each eye at its own aspect
+	void				SetMovieFormat( const MovieFormat format );
+
+	// Screens next to the stream's, each with its own source.  Takes the
+	// screen, or deletes it and returns false when there are too many.
+	bool				AddScreen( StreamScreen * screen );
+	void				RemoveScreens();
+
+	// Small luminance copies of movie frames, read from the mip chain
+	// through a pack buffer ring so nothing waits on the GPU.  Request
+	// queues a read of the current frame at the largest level no wider than
+	// maxWidth, Read hands back the oldest finished one, normally a frame
+	// later, with the tag it was requested with.
+	enum MovieThumbnail
+	{
+		THUMBNAIL_LATENCY,
+		THUMBNAIL_CALIBRATION,
+		THUMBNAIL_COUNT
+	};
+
+	void				RequestMovieThumbnail( const MovieThumbnail thumbnail, const int maxWidth, const double tag );
+	bool				ReadMovieThumbnail( const MovieThumbnail thumbnail, Array<unsigned char> & luma, int & width, int & height, double & tag );
+
 public:
 	CinemaApp &			Cinema;
 
@@ -115,6 +147,60 @@ public:
 	int					CurrentMipMappedMovieTexture;	// 0 - 2
 	GLuint				MipMappedMovieTextures[3];
 	GLuint				MipMappedMovieFBOs[3];
+	int					MipMappedMovieSerial;	// incremented every time a new frame is mip mapped
+
+	// performance counters, shown by the PerfHud
+	int					StreamFramesLatched;
+	int					CopiesPerformed;
+	int					CopiesSkipped;
+	bool				OverlayActive;
+	GpuTimer			CopyTimer;		// movie copy and mip generation
+	int					PartialCopies;
+
+	// Every new stream frame is sampled at a quarter size.  Once nothing
+	// has changed for a while the copy and mip generation are skipped, and
+	// small changes like a cursor are only copied where they happened.
+	bool				DetectStaticContent;	// saved as DetectStaticContent
+	bool				ContentStatic;			// desktop is idle, the clock levels can come down
+	FrameSampler		StreamSampler;
+	ContentChangeDetector	ChangeDetector;
+	int					StaticSamples;			// in a row
+	int					ChangedSamples;			// in a row
+	ContentRect			CopiedChanges[2];		// changes in the last two copies, the triple buffer needs them again
+	bool				UncopiedFrame;			// a frame arrived since the last full copy
+	double				LastFullCopyTime;
+
+	// The same samples show whether the stream is side by side or top/bottom
+	// 3D.  Picking a 3D mode by hand turns this off.  A sample is analyzed
+	// on a worker, for the crop below too, one at a time.
+	bool				AutoStereoLayout;		// saved as AutoStereoLayout
+	StereoLayoutDetector	StereoDetector;
+	double				LastStereoSampleTime;
+	CancelToken *		AnalysisToken;			// cancelled when the stream changes
+	BackgroundTask *	PendingAnalysis;		// submitted, not finished yet
+
+	// Black bars around a 2D picture are cropped off the screen and left
+	// out of the copy.  MovieTextureWidth / Height shrink with the crop,
+	// FullTextureWidth / Height are the uncropped copy size.
+	bool				AutoCrop;				// saved as AutoCrop
+	BorderDetector		BorderDetect;
+	double				LastCropSampleTime;
+	ContentRect			ScreenCrop;				// in stream texture coordinates
+	int					FullTextureWidth;
+	int					FullTextureHeight;
+
+	FrameSampler		ThumbnailSamplers[THUMBNAIL_COUNT];
+
+	// screenshots and clips of the mip mapped copy, bound to gamepad buttons
+	ScreenCapture		Capture;
+
+	// The stream is screen 0 to the compositor, ExtraScreens follow it.
+	// Only one of them is the TimeWarp overlay.
+	Array<StreamScreen *>	ExtraScreens;
+	ScreenCompositor	Compositor;
+	CompositorDecision	ScreenDecisions[ScreenCompositor::MAX_SCREENS];
+	int					OverlayScreen;			// 0 is the stream, -1 none
+	bool				TestScreens;			// "test_screens" marker, synthetic screens either side of the stream
 
 	GLuint				ScreenVignetteTexture;
 	GLuint				ScreenVignetteSbsTexture;	// for side by side 3D
@@ -139,10 +225,23 @@ public:
 	bool				VoidedScene;
 
 	bool				osLollipop;
+	long				LastStreamTimestamp;	// new frame detection when the surface texture has no timestamp
+	bool				ReplayStreamFrame;		// a session replay's stream frame, the live ones are ignored then
 
 private:
 	GLuint 				BuildScreenVignetteTexture( const int horizontalTile ) const;
+	void				SampleStream( const bool newFrame, ContentRect & changes );
+	bool				UpdateStaticContent( const bool newFrame, const bool forced, const ContentRect & changes, ContentRect & copyRect );
+	void				UpdateStereoLayout();
+	bool				UpdateScreenCrop();
+	void				ResetStaticContent();
+	void				CreateMovieTextures();
+	Matrix4f			ScreenCropMatrix() const;
 	int 				BottomMipLevel( const int width, const int height ) const;
+	bool				PlanScreenCopies( const ContentRect & copyRect );
+	void				CopyExtraScreens();
+	void				DrawExtraScreens( const int eye, const Matrix4f & mvp );
+	void				AddTestScreens();
 };
 
 } // namespace VRMatterStreamTheater
@@ -0,0 +1,452 @@
+/************************************************************************************
+
+Filename    :   ScreenCapture.cpp
+Content     :	Screenshots and clips of the movie texture without stalling the GPU
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ScreenCapture.h"
+#include "ImageWriter.h"
+#include "TraceRecorder.h"
+#include "Android/LogUtils.h"
+#include "Kernel/OVR_Alg.h"
+#include "VrApi.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+namespace VRMatterStreamTheater {
+
+// every directory up to the last slash in path
+static void MakeDirectories( const String & path )
+{
+	char buffer[1024];
+	OVR_strcpy( buffer, sizeof( buffer ), path.ToCStr() );
+	for ( char * slash = strchr( buffer + 1, '/' ); slash != NULL; slash = strchr( slash + 1, '/' ) )
+	{
+		*slash = '\0';
+		if ( mkdir( buffer, 0775 ) != 0 && errno != EEXIST )
+		{
+			LOG( "ScreenCapture: couldn't create %s", buffer );
+			return;
+		}
+		*slash = '/';
+	}
+}
+
+//=======================================================================================
+
+// Writes one copied frame, on a worker.
+class CaptureWriteTask : public BackgroundTask
+{
+public:
+						CaptureWriteTask( ScreenCapture & capture, UByte * pixels, const int width, const int height,
+								const String & path, const bool png ) :
+							BackgroundTask( TASK_PRIORITY_NORMAL, NULL ),
+							Capture( capture ),
+							Pixels( pixels ),
+							Width( width ),
+							Height( height ),
+							Path( path ),
+							Png( png ),
+							Written( false ) {}
+	virtual				~CaptureWriteTask() { free( Pixels ); }
+
+	virtual void		Run();
+	virtual void		Finish();
+
+private:
+	ScreenCapture &		Capture;
+	UByte *				Pixels;
+	int					Width;
+	int					Height;
+	String				Path;
+	bool				Png;
+	bool				Written;
+};
+
+void CaptureWriteTask::Run()
+{
+	TRACE_SCOPE( "CaptureWriteTask::Run" );
+	MakeDirectories( Path );
+	Written = Png ? ImageWriter::WritePng( Path.ToCStr(), Pixels, Width, Height, true ) :
+			ImageWriter::WriteRaw( Path.ToCStr(), Pixels, Width, Height, true );
+}
+
+void CaptureWriteTask::Finish()
+{
+	Capture.Written( Width * Height * 4 );
+	if ( Written && Png && !Capture.IsClipRunning() )
+	{
+		LOG( "ScreenCapture: saved %s", Path.ToCStr() );
+	}
+}
+
+//=======================================================================================
+
+// Copies a mapped pack buffer out on a worker, so the GL thread doesn't
+// pay for a full frame memcpy.  Finish gives the buffer back.
+class CaptureCopyTask : public BackgroundTask
+{
+public:
+						CaptureCopyTask( ScreenCapture & capture, const int slot, const void * mapped ) :
+							BackgroundTask( TASK_PRIORITY_HIGH, NULL ),
+							Capture( capture ),
+							SlotIndex( slot ),
+							Mapped( mapped ),
+							Copy( NULL ) {}
+
+	virtual void		Run();
+	virtual void		Finish();
+
+private:
+	ScreenCapture &		Capture;
+	int					SlotIndex;
+	const void *		Mapped;
+	UByte *				Copy;
+};
+
+void CaptureCopyTask::Run()
+{
+	TRACE_SCOPE( "CaptureCopyTask::Run" );
+	const ScreenCapture::Slot & slot = Capture.Slots[SlotIndex];
+	const size_t bytes = slot.Width * slot.Height * 4;
+	Copy = (UByte *)malloc( bytes );
+	if ( Copy != NULL )
+	{
+		memcpy( Copy, Mapped, bytes );
+	}
+}
+
+void CaptureCopyTask::Finish()
+{
+	const ScreenCapture::Slot & slot = Capture.Slots[SlotIndex];
+	if ( Copy != NULL )
+	{
+		Capture.Tasks.Submit( new CaptureWriteTask( Capture, Copy, slot.Width, slot.Height, slot.Path, slot.Png ) );
+	}
+	else
+	{
+		Capture.Written( slot.Width * slot.Height * 4 );
+	}
+	Capture.Copied( SlotIndex, Copy != NULL );
+}
+
+//=======================================================================================
+
+ScreenCapture::ScreenCapture( TaskScheduler & tasks ) :
+	MipLevel( 0 ),
+	PngClips( false ),
+	Tasks( tasks ),
+	Directory(),
+	FBO( 0 ),
+	BufferBytes( 0 ),
+	OldestSlot( 0 ),
+	PendingReads( 0 ),
+	ScreenshotWanted( false ),
+	ClipRunning( false ),
+	ClipDirectory(),
+	ClipStart( 0.0 ),
+	ClipFrames( 0 ),
+	QueuedBytes( 0 ),
+	Captured( 0 ),
+	Dropped( 0 ),
+	RenderSeconds( 0.0 )
+
+{
+	for ( int i = 0; i < NUM_BUFFERS; i++ )
+	{
+		PackBuffers[i] = 0;
+		Slots[i].State = SLOT_FREE;
+		Slots[i].Fence = 0;
+		Slots[i].Width = 0;
+		Slots[i].Height = 0;
+		Slots[i].Png = false;
+		Slots[i].Screenshot = false;
+		Slots[i].Seconds = 0.0;
+	}
+}
+
+void ScreenCapture::Shutdown()
+{
+	if ( ClipRunning )
+	{
+		ToggleClip();
+	}
+	ScreenshotWanted = false;
+
+	// the scheduler is shut down first, so nothing is being copied any more
+	for ( int i = 0; i < NUM_BUFFERS; i++ )
+	{
+		if ( Slots[i].Fence != 0 )
+		{
+			glDeleteSync( Slots[i].Fence );
+			Slots[i].Fence = 0;
+		}
+		Slots[i].State = SLOT_FREE;
+	}
+	PendingReads = 0;
+	FreeBuffers();
+
+	if ( Captured > 0 )
+	{
+		LOG( "ScreenCapture: %i frames captured, %i dropped, %3.2f ms render thread per frame", Captured, Dropped, GetAverageFrameMs() );
+	}
+}
+
+void ScreenCapture::FreeBuffers()
+{
+	if ( FBO != 0 )
+	{
+		glDeleteFramebuffers( 1, &FBO );
+		FBO = 0;
+	}
+	if ( PackBuffers[0] != 0 )
+	{
+		glDeleteBuffers( NUM_BUFFERS, PackBuffers );
+		for ( int i = 0; i < NUM_BUFFERS; i++ )
+		{
+			PackBuffers[i] = 0;
+		}
+	}
+	BufferBytes = 0;
+}
+
+void ScreenCapture::SetDirectory( const String & directory )
+{
+	Directory = directory;
+}
+
+static String TimeStamp()
+{
+	struct timeval tv;
+	gettimeofday( &tv, NULL );
+	struct tm local;
+	localtime_r( &tv.tv_sec, &local );
+	char text[32];
+	strftime( text, sizeof( text ), "%Y%m%d_%H%M%S", &local );
+	char withMs[40];
+	OVR_sprintf( withMs, sizeof( withMs ), "%s_%03i", text, (int)( tv.tv_usec / 1000 ) );
+	return String( withMs );
+}
+
+String ScreenCapture::NextScreenshotPath() const
+{
+	return Directory + "screenshot_" + TimeStamp() + ".png";
+}
+
+void ScreenCapture::TakeScreenshot()
+{
+	ScreenshotWanted = true;
+}
+
+void ScreenCapture::ToggleClip()
+{
+	if ( ClipRunning )
+	{
+		ClipRunning = false;
+		LOG( "ScreenCapture: clip %s stopped after %i frames, %i dropped so far, %3.2f ms render thread per frame",
+				ClipDirectory.ToCStr(), ClipFrames, Dropped, GetAverageFrameMs() );
+		return;
+	}
+
+	ClipRunning = true;
+	ClipDirectory = Directory + "clip_" + TimeStamp() + "/";
+	ClipStart = vrapi_GetTimeInSeconds();
+	ClipFrames = 0;
+	LOG( "ScreenCapture: clip %s started", ClipDirectory.ToCStr() );
+}
+
+void ScreenCapture::FrameCopied( const GLuint texture, const int width, const int height )
+{
+	if ( !ScreenshotWanted && !ClipRunning )
+	{
+		return;
+	}
+	if ( !ScreenshotWanted && ClipFrames >= MAX_CLIP_FRAMES )
+	{
+		ToggleClip();
+		return;
+	}
+
+	TRACE_SCOPE( "ScreenCapture::FrameCopied" );
+	const double start = vrapi_GetTimeInSeconds();
+
+	const int level = Alg::Clamp( MipLevel, 0, 15 );
+	const int w = Alg::Max( 1, width >> level );
+	const int h = Alg::Max( 1, height >> level );
+	const int bytes = w * h * 4;
+
+	// a screenshot keeps asking until a buffer is free
+	if ( PendingReads == NUM_BUFFERS || Slots[( OldestSlot + PendingReads ) % NUM_BUFFERS].State != SLOT_FREE )
+	{
+		if ( !ScreenshotWanted )
+		{
+			Dropped++;
+		}
+		return;
+	}
+
+	if ( bytes > BufferBytes )
+	{
+		// bigger than before, only reallocated while nothing is using them
+		for ( int i = 0; i < NUM_BUFFERS; i++ )
+		{
+			if ( Slots[i].State != SLOT_FREE )
+			{
+				if ( !ScreenshotWanted )
+				{
+					Dropped++;
+				}
+				return;
+			}
+		}
+		FreeBuffers();
+	}
+
+	if ( PackBuffers[0] == 0 )
+	{
+		glGenFramebuffers( 1, &FBO );
+		glGenBuffers( NUM_BUFFERS, PackBuffers );
+		for ( int i = 0; i < NUM_BUFFERS; i++ )
+		{
+			glBindBuffer( GL_PIXEL_PACK_BUFFER, PackBuffers[i] );
+			glBufferData( GL_PIXEL_PACK_BUFFER, bytes, NULL, GL_STREAM_READ );
+		}
+		glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+		BufferBytes = bytes;
+		LOG( "ScreenCapture: %i buffers of %ix%i, mip level %i", NUM_BUFFERS, w, h, level );
+	}
+
+	glBindFramebuffer( GL_FRAMEBUFFER, FBO );
+	glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, level );
+	if ( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+	{
+		LOG( "ScreenCapture: mip level %i not readable", level );
+		glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+		ScreenshotWanted = false;
+		return;
+	}
+
+	const int index = ( OldestSlot + PendingReads ) % NUM_BUFFERS;
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, PackBuffers[index] );
+	glReadPixels( 0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, 0 );
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+	glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+
+	Slot & slot = Slots[index];
+	slot.State = SLOT_READING;
+	slot.Fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+	slot.Width = w;
+	slot.Height = h;
+	if ( ScreenshotWanted )
+	{
+		ScreenshotWanted = false;
+		slot.Path = NextScreenshotPath();
+		slot.Png = true;
+		slot.Screenshot = true;
+	}
+	else
+	{
+		char name[32];
+		OVR_sprintf( name, sizeof( name ), "%05i_%07i.%s", ClipFrames,
+				(int)( ( vrapi_GetTimeInSeconds() - ClipStart ) * 1000.0 ), PngClips ? "png" : "raw" );
+		slot.Path = ClipDirectory + name;
+		slot.Png = PngClips;
+		slot.Screenshot = false;
+		ClipFrames++;
+	}
+	PendingReads++;
+
+	slot.Seconds = vrapi_GetTimeInSeconds() - start;
+}
+
+void ScreenCapture::Update()
+{
+	while ( PendingReads > 0 )
+	{
+		Slot & slot = Slots[OldestSlot];
+		const GLenum status = glClientWaitSync( slot.Fence, 0, 0 );
+		if ( status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED )
+		{
+			return;
+		}
+
+		TRACE_SCOPE( "ScreenCapture::Map" );
+		const double start = vrapi_GetTimeInSeconds();
+		glDeleteSync( slot.Fence );
+		slot.Fence = 0;
+		const int index = OldestSlot;
+		OldestSlot = ( OldestSlot + 1 ) % NUM_BUFFERS;
+		PendingReads--;
+
+		const int bytes = slot.Width * slot.Height * 4;
+		if ( QueuedBytes + bytes > MAX_QUEUED_BYTES )
+		{
+			// the writers have fallen behind
+			slot.State = SLOT_FREE;
+			if ( slot.Screenshot )
+			{
+				ScreenshotWanted = true;
+			}
+			else
+			{
+				Dropped++;
+			}
+			continue;
+		}
+
+		glBindBuffer( GL_PIXEL_PACK_BUFFER, PackBuffers[index] );
+		const void * pixels = glMapBufferRange( GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT );
+		glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+		if ( pixels == NULL )
+		{
+			LOG( "ScreenCapture: couldn't map buffer" );
+			slot.State = SLOT_FREE;
+			Dropped++;
+			continue;
+		}
+
+		QueuedBytes += bytes;
+		slot.State = SLOT_COPYING;
+		slot.Seconds += vrapi_GetTimeInSeconds() - start;
+		Tasks.Submit( new CaptureCopyTask( *this, index, pixels ) );
+	}
+}
+
+void ScreenCapture::Copied( const int index, const bool kept )
+{
+	const double start = vrapi_GetTimeInSeconds();
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, PackBuffers[index] );
+	glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+	glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+
+	Slot & slot = Slots[index];
+	slot.State = SLOT_FREE;
+	if ( !kept )
+	{
+		Dropped++;
+		return;
+	}
+	Captured++;
+	RenderSeconds += slot.Seconds + ( vrapi_GetTimeInSeconds() - start );
+}
+
+void ScreenCapture::Written( const int bytes )
+{
+	QueuedBytes -= bytes;
+}
+
+} // namespace VRMatterStreamTheater
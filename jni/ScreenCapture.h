@@ -0,0 +1,128 @@
+/************************************************************************************
+
+Filename    :   ScreenCapture.h
+Content     :	Screenshots and clips of the movie texture without stalling the GPU
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( ScreenCapture_h )
+#define ScreenCapture_h
+
+#include "Android/GLUtils.h"
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_String.h"
+#include "TaskScheduler.h"
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+//==============================================================
+// ScreenCapture
+// Reads the mip mapped movie texture back through a ring of pixel pack
+// buffers, right after a new frame was copied into it.  The fences are
+// polled, never waited on.  A finished buffer is mapped on the GL thread
+// and copied out on a worker, the unmap happens in that task's Finish,
+// then another task writes the file.
+//
+// Copies waiting to be written are limited to MAX_QUEUED_BYTES.  A clip
+// frame that doesn't fit, or finds every buffer busy, is dropped; a
+// screenshot waits for the next frame instead.
+//
+// Screenshots are PNGs.  A clip is a directory of raw frames (see
+// ImageWriter), or PNGs with PngClips, named by frame and milliseconds
+// since the clip started: frames only come when the stream changed.
+class ScreenCapture
+{
+public:
+	static const int	NUM_BUFFERS = 4;
+	static const int	MAX_QUEUED_BYTES = 64 * 1024 * 1024;
+	static const int	MAX_CLIP_FRAMES = 60 * 60;		// a minute at the stream's best
+
+	int					MipLevel;		// saved as CaptureMipLevel, 0 is full size
+	bool				PngClips;		// saved as CapturePngClips
+
+						ScreenCapture( TaskScheduler & tasks );
+
+	// GL thread only
+	void				Shutdown();
+
+	void				SetDirectory( const String & directory );
+
+	void				TakeScreenshot();
+	void				ToggleClip();
+	bool				IsClipRunning() const { return ClipRunning; }
+
+	// GL thread, after a new frame was copied into texture and mip mapped.
+	// width / height are the texture's top level.
+	void				FrameCopied( const GLuint texture, const int width, const int height );
+
+	// GL thread, every frame
+	void				Update();
+
+	// render thread seconds spent per captured frame: issuing the read,
+	// mapping and unmapping
+	double				GetAverageFrameMs() const { return Captured > 0 ? RenderSeconds * 1000.0 / Captured : 0.0; }
+	int					GetCaptured() const { return Captured; }
+	int					GetDropped() const { return Dropped; }
+
+private:
+	enum SlotState
+	{
+		SLOT_FREE,
+		SLOT_READING,		// fence pending
+		SLOT_COPYING		// mapped, a worker is copying it out
+	};
+
+	struct Slot
+	{
+		SlotState		State;
+		GLsync			Fence;
+		int				Width;
+		int				Height;
+		String			Path;			// where it'll be written
+		bool			Png;
+		bool			Screenshot;
+		double			Seconds;		// render thread time spent on it
+	};
+
+	TaskScheduler &		Tasks;
+	String				Directory;
+
+	GLuint				FBO;
+	GLuint				PackBuffers[NUM_BUFFERS];
+	int					BufferBytes;
+	Slot				Slots[NUM_BUFFERS];
+	int					OldestSlot;		// readbacks are issued and polled in ring order
+	int					PendingReads;
+
+	bool				ScreenshotWanted;
+	bool				ClipRunning;
+	String				ClipDirectory;
+	double				ClipStart;
+	int					ClipFrames;
+
+	int					QueuedBytes;	// copies not written yet
+	int					Captured;
+	int					Dropped;
+	double				RenderSeconds;
+
+	void				FreeBuffers();
+	String				NextScreenshotPath() const;
+	void				Copied( const int slot, const bool kept );
+	void				Written( const int bytes );
+
+	friend class CaptureCopyTask;
+	friend class CaptureWriteTask;
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // ScreenCapture_h
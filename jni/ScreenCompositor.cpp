@@ -0,0 +1,168 @@
+/************************************************************************************
+
+Filename    :   ScreenCompositor.cpp
+Content     :	Shares the per frame copy and mip budget between several screens
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ScreenCompositor.h"
+
+namespace VRMatterStreamTheater {
+
+// a 1080p copy and half of another, about what fits next to the eye buffers
+static const int	DEFAULT_PIXEL_BUDGET	= 1920 * 1080 * 3 / 2;
+
+static const double	FOCUS_SWITCH_SECONDS	= 0.4;
+static const double	MAX_STALE_SECONDS		= 0.1;		// no screen drops below 10 fps
+
+ScreenCompositor::ScreenCompositor() :
+	PixelBudget( DEFAULT_PIXEL_BUDGET ),
+	Focus( -1 ),
+	Candidate( -1 ),
+	CandidateSince( 0.0 ),
+	Overlay( -1 )
+
+{
+	Reset();
+}
+
+void ScreenCompositor::Reset()
+{
+	Focus = -1;
+	Candidate = -1;
+	CandidateSince = 0.0;
+	Overlay = -1;
+	for ( int i = 0; i < MAX_SCREENS; i++ )
+	{
+		LastCopy[i] = -1e9;
+		Copies[i] = 0;
+		Deferred[i] = 0;
+	}
+}
+
+// The screen the gaze is most inside of, measured in screen radii so a big
+// screen nearby doesn't lose to the center of a small one further off.
+int ScreenCompositor::LookedAt( const CompositorScreen * screens, const int count ) const
+{
+	int best = -1;
+	float bestScore = 0.0f;
+	for ( int i = 0; i < count; i++ )
+	{
+		const float radius = screens[i].Radius > 0.001f ? screens[i].Radius : 0.001f;
+		const float score = screens[i].GazeAngle / radius;
+		if ( best < 0 || score < bestScore )
+		{
+			best = i;
+			bestScore = score;
+		}
+	}
+	return best;
+}
+
+int ScreenCompositor::Plan( const CompositorScreen * screens, const int count, const double now, CompositorDecision * decisions )
+{
+	const int numScreens = count < MAX_SCREENS ? count : MAX_SCREENS;
+	for ( int i = 0; i < count; i++ )
+	{
+		decisions[i] = CompositorDecision();
+	}
+	if ( numScreens == 0 )
+	{
+		Focus = -1;
+		Overlay = -1;
+		return Focus;
+	}
+
+	const int looked = LookedAt( screens, numScreens );
+	if ( Focus < 0 || Focus >= numScreens )
+	{
+		Focus = looked;
+		Candidate = looked;
+	}
+	else if ( looked == Focus )
+	{
+		Candidate = Focus;
+	}
+	else if ( looked != Candidate )
+	{
+		Candidate = looked;
+		CandidateSince = now;
+	}
+	else if ( now - CandidateSince >= FOCUS_SWITCH_SECONDS )
+	{
+		Focus = Candidate;
+	}
+
+	int used = 0;
+	if ( screens[Focus].Pending )
+	{
+		decisions[Focus].Copy = true;
+		used += screens[Focus].CopyPixels;
+	}
+
+	// the rest, longest waiting first
+	bool considered[MAX_SCREENS] = { false };
+	considered[Focus] = true;
+	bool overshot = false;
+	for ( ; ; )
+	{
+		int next = -1;
+		for ( int i = 0; i < numScreens; i++ )
+		{
+			if ( considered[i] || !screens[i].Pending )
+			{
+				continue;
+			}
+			if ( next < 0 || LastCopy[i] < LastCopy[next] )
+			{
+				next = i;
+			}
+		}
+		if ( next < 0 )
+		{
+			break;
+		}
+		considered[next] = true;
+
+		if ( used + screens[next].CopyPixels <= PixelBudget )
+		{
+			decisions[next].Copy = true;
+			used += screens[next].CopyPixels;
+		}
+		else if ( !overshot && now - LastCopy[next] >= MAX_STALE_SECONDS )
+		{
+			decisions[next].Copy = true;
+			used += screens[next].CopyPixels;
+			overshot = true;
+		}
+		else
+		{
+			Deferred[next]++;
+		}
+	}
+
+	for ( int i = 0; i < numScreens; i++ )
+	{
+		if ( decisions[i].Copy )
+		{
+			LastCopy[i] = now;
+			Copies[i]++;
+		}
+	}
+
+	Overlay = screens[Focus].CanOverlay ? Focus : -1;
+	if ( Overlay >= 0 )
+	{
+		decisions[Overlay].Overlay = true;
+	}
+	return Focus;
+}
+
+} // namespace VRMatterStreamTheater
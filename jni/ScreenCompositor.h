@@ -0,0 +1,93 @@
+/************************************************************************************
+
+Filename    :   ScreenCompositor.h
+Content     :	Shares the per frame copy and mip budget between several screens
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( ScreenCompositor_h )
+#define ScreenCompositor_h
+
+// Only the kernel types are used here, so the planning can be driven
+// by made up screens without a device.
+#include "Kernel/OVR_Types.h"
+
+namespace VRMatterStreamTheater {
+
+// What the compositor is told about a screen, every frame
+struct CompositorScreen
+{
+	bool	Pending;		// has a frame that wasn't copied yet
+	int		CopyPixels;		// what the copy and mips would cost, about the pixels copied
+	float	GazeAngle;		// radians between the view direction and the screen's center
+	float	Radius;			// radians from the screen's center to its corner
+	bool	CanOverlay;		// could be drawn as the TimeWarp overlay plane
+
+			CompositorScreen() : Pending( false ), CopyPixels( 0 ), GazeAngle( 0.0f ), Radius( 0.0f ), CanOverlay( false ) {}
+};
+
+struct CompositorDecision
+{
+	bool	Copy;
+	bool	Overlay;
+
+			CompositorDecision() : Copy( false ), Overlay( false ) {}
+};
+
+//==============================================================
+// ScreenCompositor
+// The screen looked at is the focus.  Its frames are always copied and
+// it gets the overlay plane when it can take it.  The others share what
+// is left of the pixel budget, the one waiting longest first.  One that
+// has waited MAX_STALE_SECONDS is copied even past the budget, one per
+// frame, so nothing freezes.
+//
+// The focus only moves once the gaze has stayed on another screen for
+// FOCUS_SWITCH_SECONDS, the overlay doesn't flip back and forth when
+// looking across the gap between two screens.
+//
+// Screens are known by their index, Reset forgets them all.
+class ScreenCompositor
+{
+public:
+	static const int	MAX_SCREENS = 4;
+
+						ScreenCompositor();
+
+	void				Reset();
+	void				SetPixelBudget( const int pixelsPerFrame ) { PixelBudget = pixelsPerFrame; }
+	int					GetPixelBudget() const { return PixelBudget; }
+
+	// Returns the focus.  decisions has count entries.
+	int					Plan( const CompositorScreen * screens, const int count, const double now, CompositorDecision * decisions );
+
+	int					GetFocus() const { return Focus; }
+	int					GetOverlay() const { return Overlay; }	// -1 if none
+
+	int					GetCopies( const int screen ) const { return Copies[screen]; }
+	int					GetDeferred( const int screen ) const { return Deferred[screen]; }
+
+private:
+	int					PixelBudget;
+	int					Focus;
+	int					Candidate;			// looked at, but not long enough yet
+	double				CandidateSince;
+	int					Overlay;
+
+	double				LastCopy[MAX_SCREENS];
+	int					Copies[MAX_SCREENS];
+	int					Deferred[MAX_SCREENS];
+
+	int					LookedAt( const CompositorScreen * screens, const int count ) const;
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // ScreenCompositor_h
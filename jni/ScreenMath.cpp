@@ -0,0 +1,159 @@
+/************************************************************************************
+
+Filename    :   ScreenMath.cpp
+Content     :	Screen placement and gaze math, kept free of GL and the app
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "ScreenMath.h"
+
+#include <math.h>
+
+namespace VRMatterStreamTheater {
+
+Matrix4f BoundsScreenMatrix( const Bounds3f & bounds, const float movieAspect )
+{
+	const Vector3f size = bounds.b[1] - bounds.b[0];
+	const Vector3f center = bounds.b[0] + size * 0.5f;
+	const float	screenHeight = size.y;
+	const float screenWidth = OVR::Alg::Max( size.x, size.z );
+	float widthScale;
+	float heightScale;
+	float aspect = ( movieAspect == 0.0f ) ? 1.0f : movieAspect;
+	if ( screenWidth / screenHeight > aspect )
+	{	// screen is wider than movie, clamp size to height
+		heightScale = screenHeight * 0.5f;
+		widthScale = heightScale * aspect;
+	}
+	else
+	{	// screen is taller than movie, clamp size to width
+		widthScale = screenWidth * 0.5f;
+		heightScale = widthScale / aspect;
+	}
+
+	const float rotateAngle = ( size.x > size.z ) ? 0.0f : M_PI * 0.5f;
+
+	return	Matrix4f::Translation( center ) *
+			Matrix4f::RotationY( rotateAngle ) *
+			Matrix4f::Scaling( widthScale, heightScale, 1.0f );
+}
+
+Vector3f FreeScreenScale( const float scale, const int movieWidth, const int movieHeight )
+{
+	// Scale is stored in a form that feels linear, raise to exponent to
+	// get value to apply.
+	const float applyScale = powf( 2.0f, scale );
+
+	// adjust size based on aspect ratio
+	float scaleX = 1.0f;
+	float scaleY = ( movieWidth == 0 ) ? 1.0f : (float)movieHeight / movieWidth;
+	if ( scaleY > 0.6f )
+	{
+		scaleX *= 0.6f / scaleY;
+		scaleY = 0.6f;
+	}
+
+	return Vector3f( applyScale * scaleX, applyScale * scaleY, applyScale );
+}
+
+Matrix4f FreeScreenMatrix( const Matrix4f & pose, const float distance, const Vector3f & scale )
+{
+	return pose *
+			Matrix4f::Translation( 0, 0, -distance * scale.z ) *
+			Matrix4f::Scaling( scale );
+}
+
+static Vector3f	MatrixOrigin( const Matrix4f & m )
+{
+	return Vector3f( -m.M[0][3], -m.M[1][3], -m.M[2][3] );
+}
+
+static Vector3f	MatrixForward( const Matrix4f & m )
+{
+	return Vector3f( -m.M[2][0], -m.M[2][1], -m.M[2][2] );
+}
+
+Vector2f GazeCoordinatesOnScreen( const Matrix4f & viewMatrix, const Matrix4f & screenMatrix )
+{
+	// project along -Z in the viewMatrix onto the Z = 0 plane of screenMatrix
+	const Vector3f viewForward = MatrixForward( viewMatrix ).Normalized();
+
+	// MIXFE: free screen matrix is inverted compared to bounds screen matrix.  (MGH: No, everything's backwards!)
+	const Vector3f screenForward = -Vector3f( screenMatrix.M[0][2], screenMatrix.M[1][2], screenMatrix.M[2][2] ).Normalized();
+
+	const float approach = viewForward.Dot( screenForward );
+	if ( approach <= 0.1f )
+	{
+		// looking away
+		return Vector2f( -2.0f, -2.0f );
+	}
+
+	const Matrix4f panelInvert = screenMatrix.Inverted();
+	const Matrix4f viewInvert = viewMatrix.Inverted();
+
+	const Vector3f viewOrigin = viewInvert.Transform( Vector3f( 0.0f ) );
+	const Vector3f panelOrigin = MatrixOrigin( screenMatrix );
+
+	// Should we disallow using panels from behind?
+	const float d = panelOrigin.Dot( screenForward );
+	const float t = -( viewOrigin.Dot( screenForward ) + d ) / approach;
+
+	const Vector3f impact = viewOrigin + viewForward * t;
+	const Vector3f localCoordinate = panelInvert.Transform( impact );
+
+	return Vector2f( localCoordinate.x, localCoordinate.y );
+}
+
+void GazeAnglesToScreen( const Matrix4f & viewMatrix, const Matrix4f & screenMatrix, float & angle, float & radius )
+{
+	const Vector3f viewOrigin = viewMatrix.Inverted().Transform( Vector3f( 0.0f ) );
+	const Vector3f viewForward = MatrixForward( viewMatrix ).Normalized();
+
+	const Vector3f center = screenMatrix.Transform( Vector3f( 0.0f ) );
+	const Vector3f corner = screenMatrix.Transform( Vector3f( 1.0f, 1.0f, 0.0f ) );
+
+	const Vector3f toCenter = center - viewOrigin;
+	const float distance = OVR::Alg::Max( 0.01f, toCenter.Length() );
+	angle = acosf( OVR::Alg::Clamp( viewForward.Dot( toCenter / distance ), -1.0f, 1.0f ) );
+	radius = atanf( ( corner - center ).Length() / distance );
+}
+
+PanelPose InterpolatePanelPose( const Array<PanelPose> & panelPoses, const float t )
+{
+	int index = ( int )floor( t );
+	float frac = t - ( float )index;
+
+	PanelPose pose;
+
+	if ( index < 0 )
+	{
+		pose = panelPoses[ 0 ];
+	}
+	else if ( ( index == panelPoses.GetSizeI() - 1 ) && ( fabs( frac ) <= 0.00001f ) )
+	{
+		pose = panelPoses[ panelPoses.GetSizeI() - 1 ];
+	}
+	else if ( index >= panelPoses.GetSizeI() - 1 )
+	{
+		pose.Orientation = Quatf();
+		pose.Position = Vector3f( 0.0f, 0.0f, 0.0f );
+		pose.Color = Vector4f( 0.0f, 0.0f, 0.0f, 0.0f );
+	}
+	else
+	{
+		pose.Orientation = panelPoses[ index + 1 ].Orientation.Nlerp( panelPoses[ index ].Orientation, frac ); // NLerp has the frac inverted
+		pose.Position = panelPoses[ index ].Position.Lerp( panelPoses[ index + 1 ].Position, frac );
+		pose.Color = panelPoses[ index ].Color * ( 1.0f - frac ) + panelPoses[ index + 1 ].Color * frac;
+	}
+
+	return pose;
+}
+
+} // namespace VRMatterStreamTheater
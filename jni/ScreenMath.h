@@ -0,0 +1,56 @@
+/************************************************************************************
+
+Filename    :   ScreenMath.h
+Content     :	Screen placement and gaze math, kept free of GL and the app
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( ScreenMath_h )
+#define ScreenMath_h
+
+#include "Kernel/OVR_Math.h"
+#include "Kernel/OVR_Array.h"
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+class PanelPose
+{
+public:
+	Quatf    	Orientation;
+	Vector3f 	Position;
+	Vector4f	Color;
+
+				PanelPose() {};
+				PanelPose( Quatf orientation, Vector3f position, Vector4f color ) :
+					Orientation( orientation ), Position( position ), Color( color ) {}
+};
+
+// Fits a unit screen into the scene's screen bounds without stretching the movie
+Matrix4f	BoundsScreenMatrix( const Bounds3f & bounds, const float movieAspect );
+
+// scale is the linear feeling value from the settings, raised to a power of two here
+Vector3f	FreeScreenScale( const float scale, const int movieWidth, const int movieHeight );
+Matrix4f	FreeScreenMatrix( const Matrix4f & pose, const float distance, const Vector3f & scale );
+
+// -1 to 1 range on screenMatrix, returns -2,-2 if looking away from the screen
+Vector2f	GazeCoordinatesOnScreen( const Matrix4f & viewMatrix, const Matrix4f & screenMatrix );
+
+// How far the view direction is from screenMatrix's center, and the center
+// to a corner of its -1 to 1 square, both in radians from the view's origin
+void		GazeAnglesToScreen( const Matrix4f & viewMatrix, const Matrix4f & screenMatrix, float & angle, float & radius );
+
+// t is a fractional index into panelPoses, past the last pose the panel fades out
+PanelPose	InterpolatePanelPose( const Array<PanelPose> & panelPoses, const float t );
+
+} // namespace VRMatterStreamTheater
+
+#endif // ScreenMath_h
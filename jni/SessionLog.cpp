@@ -0,0 +1,582 @@
+/************************************************************************************
+
+Filename    :   SessionLog.cpp
+Content     :	Binary log of everything that enters the app, for replaying a session
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "SessionLog.h"
+#include "Kernel/OVR_Alg.h"
+#include "Android/LogUtils.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace VRMatterStreamTheater {
+
+// file layout: header, then records of { type, frame, size, data }, all little endian
+static const UInt32	SESSION_MAGIC			= 0x4C535453;	// "STSL"
+static const UInt32	SESSION_VERSION			= 2;				// bump whenever a record's contents change
+static const int	HEADER_SIZE				= 8;
+static const int	RECORD_HEADER_SIZE		= 12;
+static const int	RECORDS_PER_FLUSH		= 256;			// the app can be killed without a shutdown
+
+//==============================================================
+// SessionPacket
+
+void SessionPacket::PutBytes( const void * data, const int size )
+{
+	const int offset = Data.GetSizeI();
+	Data.Resize( offset + size );
+	memcpy( Data.DataPtr() + offset, data, size );
+}
+
+void SessionPacket::PutInt( const int value )
+{
+	PutBytes( &value, sizeof( value ) );
+}
+
+void SessionPacket::PutString( const char * value )
+{
+	const int length = ( value != NULL ) ? (int)strlen( value ) : 0;
+	PutInt( length );
+	PutBytes( value, length );
+}
+
+void SessionPacket::PutFloat( const float value )
+{
+	PutBytes( &value, sizeof( value ) );
+}
+
+void SessionPacket::PutDouble( const double value )
+{
+	PutBytes( &value, sizeof( value ) );
+}
+
+bool SessionPacket::GetBytes( void * data, const int size )
+{
+	if ( ReadOffset + size > Data.GetSizeI() )
+	{
+		return false;
+	}
+	memcpy( data, Data.DataPtr() + ReadOffset, size );
+	ReadOffset += size;
+	return true;
+}
+
+bool SessionPacket::GetInt( int & value )
+{
+	return GetBytes( &value, sizeof( value ) );
+}
+
+bool SessionPacket::GetFloat( float & value )
+{
+	return GetBytes( &value, sizeof( value ) );
+}
+
+bool SessionPacket::GetDouble( double & value )
+{
+	return GetBytes( &value, sizeof( value ) );
+}
+
+bool SessionPacket::GetString( String & value )
+{
+	int length = 0;
+	if ( !GetInt( length ) || length < 0 || ReadOffset + length > Data.GetSizeI() )
+	{
+		return false;
+	}
+	value = String( (const char *)Data.DataPtr() + ReadOffset, length );
+	ReadOffset += length;
+	return true;
+}
+
+//==============================================================
+// SessionFrame
+
+SessionFrame::SessionFrame() :
+	DeltaSeconds( 0.0f ),
+	PredictedDisplayTimeInSeconds( 0.0 ),
+	Throttled( false ),
+	ButtonState( 0 ),
+	ButtonPressed( 0 ),
+	ButtonReleased( 0 ),
+	SwipeFraction( 0.0f )
+
+{
+	Sticks[0][0] = Sticks[0][1] = Sticks[1][0] = Sticks[1][1] = 0.0f;
+	TouchRelative[0] = TouchRelative[1] = 0.0f;
+}
+
+void SessionFrame::Put( SessionPacket & packet ) const
+{
+	packet.PutFloat( DeltaSeconds );
+	packet.PutDouble( PredictedDisplayTimeInSeconds );
+	packet.PutInt( Throttled );
+	packet.PutInt( (int)ButtonState );
+	packet.PutInt( (int)ButtonPressed );
+	packet.PutInt( (int)ButtonReleased );
+	packet.PutFloat( Sticks[0][0] );
+	packet.PutFloat( Sticks[0][1] );
+	packet.PutFloat( Sticks[1][0] );
+	packet.PutFloat( Sticks[1][1] );
+	packet.PutFloat( TouchRelative[0] );
+	packet.PutFloat( TouchRelative[1] );
+	packet.PutFloat( SwipeFraction );
+}
+
+bool SessionFrame::Get( SessionPacket & packet )
+{
+	SessionFrame frame;
+	int throttled = 0;
+	int buttonState = 0;
+	int buttonPressed = 0;
+	int buttonReleased = 0;
+	if ( !packet.GetFloat( frame.DeltaSeconds ) || !packet.GetDouble( frame.PredictedDisplayTimeInSeconds ) ||
+			!packet.GetInt( throttled ) || !packet.GetInt( buttonState ) || !packet.GetInt( buttonPressed ) || !packet.GetInt( buttonReleased ) ||
+			!packet.GetFloat( frame.Sticks[0][0] ) || !packet.GetFloat( frame.Sticks[0][1] ) ||
+			!packet.GetFloat( frame.Sticks[1][0] ) || !packet.GetFloat( frame.Sticks[1][1] ) ||
+			!packet.GetFloat( frame.TouchRelative[0] ) || !packet.GetFloat( frame.TouchRelative[1] ) ||
+			!packet.GetFloat( frame.SwipeFraction ) )
+	{
+		return false;
+	}
+	frame.Throttled = ( throttled != 0 );
+	frame.ButtonState = (UInt32)buttonState;
+	frame.ButtonPressed = (UInt32)buttonPressed;
+	frame.ButtonReleased = (UInt32)buttonReleased;
+	*this = frame;
+	return true;
+}
+
+static int CompareFrameTimes( const void * a, const void * b )
+{
+	const float fa = *(const float *)a;
+	const float fb = *(const float *)b;
+	return ( fa < fb ) ? -1 : ( ( fa > fb ) ? 1 : 0 );
+}
+
+SessionFrameTimes SummarizeFrameTimes( const Array<float> & frameMs )
+{
+	SessionFrameTimes times;
+	memset( &times, 0, sizeof( times ) );
+	times.Count = frameMs.GetSizeI();
+	if ( times.Count == 0 )
+	{
+		return times;
+	}
+
+	Array<float> sorted( frameMs );
+	qsort( sorted.DataPtr(), times.Count, sizeof( float ), CompareFrameTimes );
+	float total = 0.0f;
+	for ( int i = 0; i < times.Count; i++ )
+	{
+		total += sorted[i];
+	}
+
+	times.Mean = total / times.Count;
+	times.P50 = sorted[times.Count / 2];
+	times.P99 = sorted[Alg::Min( times.Count - 1, times.Count * 99 / 100 )];
+	times.Max = sorted[times.Count - 1];
+	return times;
+}
+
+bool WriteFrameTimes( const char * path, const Array<float> & frameMs )
+{
+	FILE * f = fopen( path, "w" );
+	if ( f == NULL )
+	{
+		return false;
+	}
+
+	const SessionFrameTimes times = SummarizeFrameTimes( frameMs );
+	fprintf( f, "# frames %i, mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n", times.Count, times.Mean, times.P50, times.P99, times.Max );
+	fprintf( f, "# frame, cpu ms\n" );
+	for ( int i = 0; i < frameMs.GetSizeI(); i++ )
+	{
+		fprintf( f, "%i, %.3f\n", i + 1, frameMs[i] );
+	}
+	fclose( f );
+	return true;
+}
+
+//==============================================================
+// SessionLog
+
+SessionLog::SessionLog() :
+	RecordFile( NULL ),
+	CurrentFrame( 0 ),
+	RecordsSinceFlush( 0 ),
+	Replaying( false ),
+	ReplayData(),
+	ReplayOffset( 0 )
+
+{
+	pthread_mutex_init( &RecordMutex, NULL );
+}
+
+SessionLog::~SessionLog()
+{
+	StopRecording();
+	pthread_mutex_destroy( &RecordMutex );
+}
+
+bool SessionLog::StartRecording( const char * path )
+{
+	StopRecording();
+
+	FILE * f = fopen( path, "wb" );
+	if ( f == NULL )
+	{
+		LOG( "SessionLog: couldn't create %s", path );
+		return false;
+	}
+
+	const UInt32 header[2] = { SESSION_MAGIC, SESSION_VERSION };
+	fwrite( header, sizeof( header ), 1, f );
+
+	pthread_mutex_lock( &RecordMutex );
+	__atomic_store_n( &RecordFile, f, __ATOMIC_RELEASE );
+	RecordsSinceFlush = 0;
+	pthread_mutex_unlock( &RecordMutex );
+
+	LOG( "SessionLog: recording to %s", path );
+	return true;
+}
+
+void SessionLog::StopRecording()
+{
+	pthread_mutex_lock( &RecordMutex );
+	if ( RecordFile != NULL )
+	{
+		fclose( RecordFile );
+		__atomic_store_n( &RecordFile, (FILE *)NULL, __ATOMIC_RELEASE );
+	}
+	pthread_mutex_unlock( &RecordMutex );
+}
+
+void SessionLog::SetFrame( const int frame )
+{
+	pthread_mutex_lock( &RecordMutex );
+	CurrentFrame = frame;
+	pthread_mutex_unlock( &RecordMutex );
+}
+
+void SessionLog::Record( const int type, const void * data, const int size )
+{
+	pthread_mutex_lock( &RecordMutex );
+	if ( RecordFile != NULL )
+	{
+		const UInt32 header[3] = { (UInt32)type, (UInt32)CurrentFrame, (UInt32)size };
+		fwrite( header, sizeof( header ), 1, RecordFile );
+		if ( size > 0 )
+		{
+			fwrite( data, size, 1, RecordFile );
+		}
+
+		if ( ++RecordsSinceFlush >= RECORDS_PER_FLUSH )
+		{
+			fflush( RecordFile );
+			RecordsSinceFlush = 0;
+		}
+	}
+	pthread_mutex_unlock( &RecordMutex );
+}
+
+void SessionLog::RecordFrame( const SessionFrame & frame )
+{
+	if ( IsRecording() )
+	{
+		SessionPacket packet;
+		frame.Put( packet );
+		Record( SESSION_EVENT_FRAME, packet );
+	}
+}
+
+void SessionLog::RecordCommand( const char * command )
+{
+	if ( IsRecording() )
+	{
+		Record( SESSION_EVENT_COMMAND, command, (int)strlen( command ) + 1 );
+	}
+}
+
+void SessionLog::RecordAddPc( const char * name, const char * uuid, const int pairState, const int reachability,
+		const char * binding, const bool isRunning )
+{
+	if ( IsRecording() )
+	{
+		SessionPacket packet;
+		packet.PutString( name );
+		packet.PutString( uuid );
+		packet.PutInt( pairState );
+		packet.PutInt( reachability );
+		packet.PutString( binding );
+		packet.PutInt( isRunning );
+		Record( SESSION_EVENT_ADD_PC, packet );
+	}
+}
+
+void SessionLog::RecordRemovePc( const char * name )
+{
+	if ( IsRecording() )
+	{
+		SessionPacket packet;
+		packet.PutString( name );
+		Record( SESSION_EVENT_REMOVE_PC, packet );
+	}
+}
+
+void SessionLog::RecordAddApp( const char * name, const char * posterFileName, const int id, const bool isRunning )
+{
+	if ( IsRecording() )
+	{
+		SessionPacket packet;
+		packet.PutString( name );
+		packet.PutString( posterFileName );
+		packet.PutInt( id );
+		packet.PutInt( isRunning );
+		Record( SESSION_EVENT_ADD_APP, packet );
+	}
+}
+
+void SessionLog::RecordRemoveApp( const int id )
+{
+	if ( IsRecording() )
+	{
+		SessionPacket packet;
+		packet.PutInt( id );
+		Record( SESSION_EVENT_REMOVE_APP, packet );
+	}
+}
+
+void SessionLog::RecordShowPair( const char * message )
+{
+	if ( IsRecording() )
+	{
+		SessionPacket packet;
+		packet.PutString( message );
+		Record( SESSION_EVENT_SHOW_PAIR, packet );
+	}
+}
+
+void SessionLog::RecordPairSuccess()
+{
+	Record( SESSION_EVENT_PAIR_SUCCESS, NULL, 0 );
+}
+
+void SessionLog::RecordShowError( const char * message )
+{
+	if ( IsRecording() )
+	{
+		SessionPacket packet;
+		packet.PutString( message );
+		Record( SESSION_EVENT_SHOW_ERROR, packet );
+	}
+}
+
+void SessionLog::RecordClearError()
+{
+	Record( SESSION_EVENT_CLEAR_ERROR, NULL, 0 );
+}
+
+void SessionLog::RecordStreamFrame()
+{
+	Record( SESSION_EVENT_STREAM_FRAME, NULL, 0 );
+}
+
+bool SessionLog::StartReplay( const char * path )
+{
+	StopReplay();
+
+	FILE * f = fopen( path, "rb" );
+	if ( f == NULL )
+	{
+		return false;
+	}
+
+	fseek( f, 0, SEEK_END );
+	const long fileSize = ftell( f );
+	fseek( f, 0, SEEK_SET );
+
+	UInt32 header[2] = { 0, 0 };
+	if ( fileSize < HEADER_SIZE || fread( header, sizeof( header ), 1, f ) != 1 ||
+			header[0] != SESSION_MAGIC || header[1] != SESSION_VERSION )
+	{
+		LOG( "SessionLog: %s isn't a session log from this build", path );
+		fclose( f );
+		return false;
+	}
+
+	ReplayData.Resize( fileSize - HEADER_SIZE );
+	const bool read = ReplayData.GetSizeI() == 0 || fread( ReplayData.DataPtr(), ReplayData.GetSizeI(), 1, f ) == 1;
+	fclose( f );
+	if ( !read )
+	{
+		ReplayData.Clear();
+		return false;
+	}
+
+	ReplayOffset = 0;
+	__atomic_store_n( &Replaying, true, __ATOMIC_RELEASE );
+	LOG( "SessionLog: replaying %s, %i bytes", path, ReplayData.GetSizeI() );
+	return true;
+}
+
+void SessionLog::StopReplay()
+{
+	__atomic_store_n( &Replaying, false, __ATOMIC_RELEASE );
+	ReplayData.Clear();
+	ReplayOffset = 0;
+}
+
+bool SessionLog::NextEvent( const int frame, int & type, SessionPacket & packet )
+{
+	if ( !Replaying || ReplayOffset + RECORD_HEADER_SIZE > ReplayData.GetSizeI() )
+	{
+		return false;
+	}
+
+	UInt32 header[3];
+	memcpy( header, ReplayData.DataPtr() + ReplayOffset, sizeof( header ) );
+	if ( (int)header[1] > frame )
+	{
+		return false;
+	}
+
+	const int size = (int)header[2];
+	if ( ReplayOffset + RECORD_HEADER_SIZE + size > ReplayData.GetSizeI() )
+	{
+		// truncated by a kill in the middle of a write
+		ReplayOffset = ReplayData.GetSizeI();
+		return false;
+	}
+
+	type = (int)header[0];
+	packet.Clear();
+	packet.PutBytes( ReplayData.DataPtr() + ReplayOffset + RECORD_HEADER_SIZE, size );
+	ReplayOffset += RECORD_HEADER_SIZE + size;
+	return true;
+}
+
+int SessionLog::ReplayEvents( const int frame, SessionReplayTarget & target )
+{
+	int count = 0;
+	int type;
+	SessionPacket packet;
+	while ( NextEvent( frame, type, packet ) )
+	{
+		if ( !Dispatch( type, packet, target ) )
+		{
+			LOG( "SessionLog: skipped a malformed record of type %i at frame %i", type, frame );
+			continue;
+		}
+		count++;
+	}
+	return count;
+}
+
+bool SessionLog::Dispatch( const int type, SessionPacket & packet, SessionReplayTarget & target )
+{
+	String name;
+	String text;
+	String binding;
+	int id = 0;
+	int pairState = 0;
+	int reachability = 0;
+	int isRunning = 0;
+
+	switch ( type )
+	{
+		case SESSION_EVENT_FRAME:
+		{
+			SessionFrame frame;
+			if ( !frame.Get( packet ) )
+			{
+				return false;
+			}
+			target.ReplayFrame( frame );
+			return true;
+		}
+
+		case SESSION_EVENT_COMMAND:
+			if ( packet.GetSize() == 0 )
+			{
+				return false;
+			}
+			packet.PutInt( 0 );	// make sure it's terminated
+			target.ReplayCommand( (const char *)packet.GetData() );
+			return true;
+
+		case SESSION_EVENT_ADD_PC:
+			if ( !packet.GetString( name ) || !packet.GetString( text ) || !packet.GetInt( pairState ) ||
+					!packet.GetInt( reachability ) || !packet.GetString( binding ) || !packet.GetInt( isRunning ) )
+			{
+				return false;
+			}
+			target.ReplayAddPc( name, text, pairState, reachability, binding, isRunning != 0 );
+			return true;
+
+		case SESSION_EVENT_REMOVE_PC:
+			if ( !packet.GetString( name ) )
+			{
+				return false;
+			}
+			target.ReplayRemovePc( name );
+			return true;
+
+		case SESSION_EVENT_ADD_APP:
+			if ( !packet.GetString( name ) || !packet.GetString( text ) || !packet.GetInt( id ) || !packet.GetInt( isRunning ) )
+			{
+				return false;
+			}
+			target.ReplayAddApp( name, text, id, isRunning != 0 );
+			return true;
+
+		case SESSION_EVENT_REMOVE_APP:
+			if ( !packet.GetInt( id ) )
+			{
+				return false;
+			}
+			target.ReplayRemoveApp( id );
+			return true;
+
+		case SESSION_EVENT_SHOW_PAIR:
+			if ( !packet.GetString( text ) )
+			{
+				return false;
+			}
+			target.ReplayShowPair( text );
+			return true;
+
+		case SESSION_EVENT_PAIR_SUCCESS:
+			target.ReplayPairSuccess();
+			return true;
+
+		case SESSION_EVENT_SHOW_ERROR:
+			if ( !packet.GetString( text ) )
+			{
+				return false;
+			}
+			target.ReplayShowError( text );
+			return true;
+
+		case SESSION_EVENT_CLEAR_ERROR:
+			target.ReplayClearError();
+			return true;
+
+		case SESSION_EVENT_STREAM_FRAME:
+			target.ReplayStreamFrame();
+			return true;
+	}
+	return false;
+}
+
+} // namespace VRMatterStreamTheater
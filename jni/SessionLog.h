@@ -0,0 +1,197 @@
+/************************************************************************************
+
+Filename    :   SessionLog.h
+Content     :	Binary log of everything that enters the app, for replaying a session
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( SessionLog_h )
+#define SessionLog_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_Array.h"
+#include "Kernel/OVR_String.h"
+
+#include <stdio.h>
+#include <pthread.h>
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+enum SessionEventType
+{
+	SESSION_EVENT_FRAME = 1,		// a SessionFrame
+	SESSION_EVENT_COMMAND,			// message queue text
+	SESSION_EVENT_ADD_PC,
+	SESSION_EVENT_REMOVE_PC,
+	SESSION_EVENT_ADD_APP,
+	SESSION_EVENT_REMOVE_APP,
+	SESSION_EVENT_SHOW_PAIR,
+	SESSION_EVENT_PAIR_SUCCESS,
+	SESSION_EVENT_SHOW_ERROR,
+	SESSION_EVENT_CLEAR_ERROR,
+	SESSION_EVENT_STREAM_FRAME		// a new frame arrived from the host
+};
+
+//==============================================================
+// SessionPacket
+// Numbers and strings packed back to back, read in the order they were put.
+class SessionPacket
+{
+public:
+							SessionPacket() : ReadOffset( 0 ) {}
+
+	void					Clear() { Data.Clear(); ReadOffset = 0; }
+
+	void					PutBytes( const void * data, const int size );
+	void					PutInt( const int value );
+	void					PutFloat( const float value );
+	void					PutDouble( const double value );
+	void					PutString( const char * value );
+
+	bool					GetInt( int & value );
+	bool					GetFloat( float & value );
+	bool					GetDouble( double & value );
+	bool					GetString( String & value );
+
+	const UByte *			GetData() const { return Data.DataPtr(); }
+	int						GetSize() const { return Data.GetSizeI(); }
+
+private:
+	friend class SessionLog;
+
+	Array<UByte>			Data;
+	int						ReadOffset;
+
+	bool					GetBytes( void * data, const int size );
+};
+
+//==============================================================
+// SessionFrame
+// The VrFrame fields the app reads.  They are recorded one at a time, so
+// a log doesn't depend on how the SDK lays VrFrame out.
+struct SessionFrame
+{
+	float					DeltaSeconds;
+	double					PredictedDisplayTimeInSeconds;
+	bool					Throttled;			// DeviceStatus.PowerLevelStateThrottled
+	UInt32					ButtonState;
+	UInt32					ButtonPressed;
+	UInt32					ButtonReleased;
+	float					Sticks[2][2];
+	float					TouchRelative[2];
+	float					SwipeFraction;
+
+							SessionFrame();
+
+	void					Put( SessionPacket & packet ) const;
+	bool					Get( SessionPacket & packet );
+};
+
+//==============================================================
+// SessionReplayTarget
+// Takes the recorded events of each frame, in the order they came in.
+// The app is one on the device, the host replay driver another.
+class SessionReplayTarget
+{
+public:
+	virtual					~SessionReplayTarget() {}
+
+	virtual void			ReplayFrame( const SessionFrame & frame ) = 0;
+	virtual void			ReplayCommand( const char * command ) = 0;
+	virtual void			ReplayAddPc( const String & name, const String & uuid, const int pairState, const int reachability,
+									const String & binding, const bool isRunning ) = 0;
+	virtual void			ReplayRemovePc( const String & name ) = 0;
+	virtual void			ReplayAddApp( const String & name, const String & posterFileName, const int id, const bool isRunning ) = 0;
+	virtual void			ReplayRemoveApp( const int id ) = 0;
+	virtual void			ReplayShowPair( const String & message ) = 0;
+	virtual void			ReplayPairSuccess() = 0;
+	virtual void			ReplayShowError( const String & message ) = 0;
+	virtual void			ReplayClearError() = 0;
+	virtual void			ReplayStreamFrame() = 0;
+};
+
+// the spread of a replay's per frame CPU times, in milliseconds
+struct SessionFrameTimes
+{
+	int						Count;
+	float					Mean;
+	float					P50;
+	float					P99;
+	float					Max;
+};
+
+SessionFrameTimes			SummarizeFrameTimes( const Array<float> & frameMs );
+
+// the summary, then a line per frame
+bool						WriteFrameTimes( const char * path, const Array<float> & frameMs );
+
+//==============================================================
+// SessionLog
+// Records are tagged with the app frame they arrived in, so a replay
+// can hand each frame the same input, commands and callbacks.
+class SessionLog
+{
+public:
+							SessionLog();
+							~SessionLog();
+
+	bool					StartRecording( const char * path );
+	void					StopRecording();
+	bool					IsRecording() const { return __atomic_load_n( &RecordFile, __ATOMIC_ACQUIRE ) != NULL; }
+
+	// Any thread, the JNI callbacks don't come in on the app thread.  Each
+	// does nothing unless recording.
+	void					SetFrame( const int frame );
+	void					RecordFrame( const SessionFrame & frame );
+	void					RecordCommand( const char * command );
+	void					RecordAddPc( const char * name, const char * uuid, const int pairState, const int reachability,
+									const char * binding, const bool isRunning );
+	void					RecordRemovePc( const char * name );
+	void					RecordAddApp( const char * name, const char * posterFileName, const int id, const bool isRunning );
+	void					RecordRemoveApp( const int id );
+	void					RecordShowPair( const char * message );
+	void					RecordPairSuccess();
+	void					RecordShowError( const char * message );
+	void					RecordClearError();
+	void					RecordStreamFrame();
+
+	// logs written by another version of the format are refused
+	bool					StartReplay( const char * path );
+	void					StopReplay();
+	bool					IsReplaying() const { return __atomic_load_n( &Replaying, __ATOMIC_ACQUIRE ); }		// also asked by the JNI callbacks, to drop the live ones
+	bool					IsReplayFinished() const { return ReplayOffset >= ReplayData.GetSizeI(); }
+
+	// Hands the target every record up to the given frame that it hasn't
+	// had yet, returns how many.  Records that don't parse are skipped.
+	int						ReplayEvents( const int frame, SessionReplayTarget & target );
+
+private:
+	FILE *					RecordFile;
+	pthread_mutex_t			RecordMutex;
+	int						CurrentFrame;
+	int						RecordsSinceFlush;
+
+	bool					Replaying;
+	Array<UByte>			ReplayData;
+	int						ReplayOffset;
+
+	void					Record( const int type, const void * data, const int size );
+	void					Record( const int type, const SessionPacket & packet ) { Record( type, packet.GetData(), packet.GetSize() ); }
+
+	// the next record for the given frame, false once there are no more for it
+	bool					NextEvent( const int frame, int & type, SessionPacket & packet );
+	bool					Dispatch( const int type, SessionPacket & packet, SessionReplayTarget & target );
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // SessionLog_h
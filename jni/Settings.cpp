@@ -21,19 +21,26 @@ LICENSE file in the StreamTheater/ directory.
 #include "Kernel/OVR_String.h"
 
 #include "Android/LogUtils.h"
+#include "TraceRecorder.h"
+#include "AsyncLog.h"
 
 namespace VRMatterStreamTheater {
 
 void PrintFileToLog(const char* filename)
 {
+    // reading the file back is the expensive part, so check before opening it
+    if (!SLOG_ENABLED(LOG_CATEGORY_SETTINGS, LOG_LEVEL_DEBUG))
+    {
+        return;
+    }
     std::ifstream file(filename);
     std::string str;
-    LOG("%s ----------------------", filename);
+    SLOG_DEBUG(LOG_CATEGORY_SETTINGS, "%s ----------------------", filename);
     while (std::getline(file, str))
     {
-        LOG("%s",str.c_str());
+        SLOG_DEBUG(LOG_CATEGORY_SETTINGS, "%s", str.c_str());
     }
-    LOG("END ---------------------");
+    SLOG_DEBUG(LOG_CATEGORY_SETTINGS, "END ---------------------");
 }
 
 void PrintJson(JSON* json)
@@ -45,12 +52,14 @@ void PrintJson(JSON* json)
     LOG("END------------------------");
 }
 
+const double Settings::SETTINGS_VERSION = 1.0;
+
 /*
  * Variable holder
  */
 class Settings::IVariable {
 public:
-	virtual ~IVariable() { free(name); name = NULL; if(json) json->Release(); }
+	virtual ~IVariable() { free(name); name = NULL; }
 	virtual IVariable* Clone() = 0;
 	// The three basic types of JSON values, since we don't know what type we're storing in this instance
 	// Could have template<typename T> Load(T), but this way we don't really have to save type info to json
@@ -62,7 +71,7 @@ public:
 	virtual void SaveValue() = 0;
 public:
 	char* name;
-	JSON* json;
+	JSON* json;		// the variable's node in settingsJSON, which owns it
 };
 
 
@@ -78,7 +87,7 @@ public:
 		varPtr = ptr;
 		initialValue = *ptr;
 	}
-	virtual ~Variable(){ free(name); name = NULL; if(json) json->Release(); }
+	virtual ~Variable(){ free(name); name = NULL; }
 	virtual IVariable* Clone()
 	{
 		Variable<T>* newVar = new Variable<T>();
@@ -118,7 +127,7 @@ public:
 		varPtr = ptr;
 		initialValue = strdup(*ptr);
 	}
-	virtual ~Variable() { free(name); name = NULL; free(initialValue); if(json) json->Release(); }
+	virtual ~Variable() { free(name); name = NULL; free(initialValue); }
 	virtual IVariable* Clone()
 	{
 		Variable<char*>* newVar = new Variable<char*>();
@@ -176,7 +185,7 @@ public:
 		varPtr = ptr;
 		initialValue = *ptr;
 	}
-	virtual ~Variable(){ free(name); name = NULL; if(json) json->Release(); }
+	virtual ~Variable(){ free(name); name = NULL; }
 	virtual IVariable* Clone()
 	{
 		Variable<String>* newVar = new Variable<String>();
@@ -267,6 +276,7 @@ Settings::~Settings()
 		rootSettingsJSON = NULL;
 		LOG("Done releasing!");
 	}
+	free(settingsFileName);
 }
 
 void Settings::OpenOrCreate(const char* filename)
@@ -420,6 +430,7 @@ void Settings::DeleteVar(const char* varName)
 
 void Settings::Load()
 {
+	TRACE_SCOPE( "Settings::Load" );
 	if(settingsJSON == NULL) return;
 
 	for(int i = 0; i < variables.GetSizeI(); i++)
@@ -453,6 +464,7 @@ void Settings::Load()
 
 void Settings::SaveAll()
 {
+	TRACE_SCOPE( "Settings::SaveAll" );
 	if(settingsJSON == NULL) return;
 
 	for(int i = 0; i < variables.GetSizeI(); i++)
@@ -472,6 +484,7 @@ void Settings::SaveAll()
 		else
 		{
 			varJSON->ReplaceNodeWith(var->Serialize());
+			varJSON->Release();
 		}
 	}
 	rootSettingsJSON->Save(settingsFileName);
@@ -479,6 +492,7 @@ void Settings::SaveAll()
 
 void Settings::SaveChanged()
 {
+	TRACE_SCOPE( "Settings::SaveChanged" );
 	if(settingsJSON == NULL) return;
 
 	for(int i = 0; i < variables.GetSizeI(); i++)
@@ -503,6 +517,7 @@ void Settings::SaveChanged()
 		else
 		{
 			varJSON->ReplaceNodeWith(var->Serialize());
+			varJSON->Release();
 		}
 	}
 	rootSettingsJSON->Save(settingsFileName);
@@ -511,6 +526,7 @@ void Settings::SaveChanged()
 
 void Settings::SaveOnly(const Array<const char*> &varNames)
 {
+	TRACE_SCOPE( "Settings::SaveOnly" );
 	if(settingsJSON == NULL) return;
 
 	for(int i = 0; i < variables.GetSizeI(); i++)
@@ -544,6 +560,7 @@ void Settings::SaveOnly(const Array<const char*> &varNames)
 		else
 		{
 			varJSON->ReplaceNodeWith(var->Serialize());
+			varJSON->Release();
 		}
 	}
 	rootSettingsJSON->Save(settingsFileName);
@@ -25,7 +25,7 @@ using namespace OVR;
 class Settings
 {
 public:
-	static const double SETTINGS_VERSION = 1.0;
+	static const double SETTINGS_VERSION;
 	Settings();
 	Settings(const char* filename);
 	~Settings();
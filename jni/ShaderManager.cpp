@@ -15,6 +15,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 
 #include "ShaderManager.h"
 #include "CinemaApp.h"
+#include "TraceRecorder.h"
 
 
 using namespace OVR;
@@ -29,10 +30,12 @@ static const char* copyMovieVertexShaderSrc =
 	"attribute vec4 Position;\n"
 	"attribute vec2 TexCoord;\n"
 	"varying  highp vec2 oTexCoord;\n"
+	"varying  highp vec2 oVignetteTexCoord;\n"
 	"void main()\n"
 	"{\n"
 	"   gl_Position = Position;\n"
-	"   oTexCoord = vec2( TexCoord.x, 1.0 - TexCoord.y );\n"	// need to flip Y
+	"   oVignetteTexCoord = vec2( TexCoord.x, 1.0 - TexCoord.y );\n"	// need to flip Y
+	"   oTexCoord = vec2( Texm * vec4( oVignetteTexCoord, 0, 1 ) );\n"	// screen crop
 	"}\n";
 
 static const char* copyMovieFragmentShaderSource =
@@ -40,9 +43,25 @@ static const char* copyMovieFragmentShaderSource =
 	"uniform samplerExternalOES Texture0;\n"
 	"uniform sampler2D Texture1;\n"				// edge vignette
 	"varying highp vec2 oTexCoord;\n"
+	"varying highp vec2 oVignetteTexCoord;\n"
 	"void main()\n"
 	"{\n"
-	"	gl_FragColor = texture2D( Texture0, oTexCoord ) *  texture2D( Texture1, oTexCoord );\n"
+	"	gl_FragColor = texture2D( Texture0, oTexCoord ) *  texture2D( Texture1, oVignetteTexCoord );\n"
+	"}\n";
+
+// Four bilinear taps on texel corners average a 4x4 block exactly when the
+// target is a quarter of the source size.  UniformColor.xy is one source texel.
+static const char* sampleMovieFragmentShaderSource =
+	"#extension GL_OES_EGL_image_external : require\n"
+	"uniform samplerExternalOES Texture0;\n"
+	"uniform highp vec4 UniformColor;\n"
+	"varying highp vec2 oTexCoord;\n"
+	"void main()\n"
+	"{\n"
+	"	gl_FragColor = 0.25 * ( texture2D( Texture0, oTexCoord + vec2( -UniformColor.x, -UniformColor.y ) ) +\n"
+	"							texture2D( Texture0, oTexCoord + vec2(  UniformColor.x, -UniformColor.y ) ) +\n"
+	"							texture2D( Texture0, oTexCoord + vec2( -UniformColor.x,  UniformColor.y ) ) +\n"
+	"							texture2D( Texture0, oTexCoord + vec2(  UniformColor.x,  UniformColor.y ) ) );\n"
 	"}\n";
 
 static const char* movieUiVertexShaderSrc =
@@ -74,6 +93,18 @@ const char* movieExternalUiFragmentShaderSource =
 	"	gl_FragColor = ColorBias + oColor * movieColor;\n"
 	"}\n";
 
+// the mip mapped copy of a screen, for screens that aren't the overlay
+static const char* movieUiFragmentShaderSource =
+	"uniform sampler2D Texture0;\n"
+	"uniform sampler2D Texture1;\n"	// fade / clamp texture
+	"varying highp vec2 oTexCoord;\n"
+	"varying lowp vec4	oColor;\n"
+	"void main()\n"
+	"{\n"
+	"	lowp vec4 movieColor = texture2D( Texture0, oTexCoord ) * texture2D( Texture1, oTexCoord );\n"
+	"	gl_FragColor = oColor * movieColor;\n"
+	"}\n";
+
 static const char* SceneStaticVertexShaderSrc =
 	"uniform mat4 Mvpm;\n"
 	"uniform lowp vec4 UniformColor;\n"
@@ -178,22 +209,11 @@ ShaderManager::ShaderManager( CinemaApp &cinema ) :
 void ShaderManager::OneTimeInit( const char * launchIntent )
 {
 	LOG( "ShaderManager::OneTimeInit" );
+	TRACE_SCOPE( "ShaderManager::OneTimeInit" );
 
 	const double start = vrapi_GetTimeInSeconds();
 
-	MovieExternalUiProgram 		= BuildProgram( movieUiVertexShaderSrc, movieExternalUiFragmentShaderSource );
-	CopyMovieProgram 			= BuildProgram( copyMovieVertexShaderSrc, copyMovieFragmentShaderSource );
-	UniformColorProgram			= BuildProgram( UniformColorVertexProgSrc, UniformColorFragmentProgSrc );
-
-	ScenePrograms[SCENE_PROGRAM_BLACK]			= BuildProgram( SceneStaticVertexShaderSrc, SceneBlackFragmentShaderSrc );
-	ScenePrograms[SCENE_PROGRAM_STATIC_ONLY]	= BuildProgram( SceneStaticVertexShaderSrc, SceneStaticFragmentShaderSrc );
-	ScenePrograms[SCENE_PROGRAM_STATIC_DYNAMIC]	= BuildProgram( SceneDynamicVertexShaderSrc, SceneStaticAndDynamicFragmentShaderSrc );
-	ScenePrograms[SCENE_PROGRAM_DYNAMIC_ONLY]	= BuildProgram( SceneDynamicVertexShaderSrc, SceneDynamicFragmentShaderSrc );
-	ScenePrograms[SCENE_PROGRAM_ADDITIVE]		= BuildProgram( SceneStaticVertexShaderSrc, SceneAdditiveFragmentShaderSrc );
-
-	// NOTE: make sure to load with SCENE_PROGRAM_STATIC_DYNAMIC because the textures are initially not swapped
-	DynamicPrograms = ModelGlPrograms( &ScenePrograms[ SCENE_PROGRAM_STATIC_DYNAMIC ] );
-
+	// the lobby is loaded with the default programs, the rest wait for LoadVariants
 	ProgVertexColor				= BuildProgram( VertexColorVertexShaderSrc, VertexColorFragmentShaderSrc );
 	ProgSingleTexture			= BuildProgram( SingleTextureVertexShaderSrc, SingleTextureFragmentShaderSrc );
 	ProgLightMapped				= BuildProgram( LightMappedVertexShaderSrc, LightMappedFragmentShaderSrc );
@@ -215,12 +235,39 @@ void ShaderManager::OneTimeInit( const char * launchIntent )
 	LOG( "ShaderManager::OneTimeInit: %3.1f seconds", vrapi_GetTimeInSeconds() - start );
 }
 
+// The theaters and the movie screen need these, the lobby doesn't.
+void ShaderManager::LoadVariants()
+{
+	TRACE_SCOPE( "ShaderManager::LoadVariants" );
+
+	const double start = vrapi_GetTimeInSeconds();
+
+	MovieExternalUiProgram 		= BuildProgram( movieUiVertexShaderSrc, movieExternalUiFragmentShaderSource );
+	MovieUiProgram 				= BuildProgram( movieUiVertexShaderSrc, movieUiFragmentShaderSource );
+	CopyMovieProgram 			= BuildProgram( copyMovieVertexShaderSrc, copyMovieFragmentShaderSource );
+	SampleMovieProgram			= BuildProgram( copyMovieVertexShaderSrc, sampleMovieFragmentShaderSource );
+	UniformColorProgram			= BuildProgram( UniformColorVertexProgSrc, UniformColorFragmentProgSrc );
+
+	ScenePrograms[SCENE_PROGRAM_BLACK]			= BuildProgram( SceneStaticVertexShaderSrc, SceneBlackFragmentShaderSrc );
+	ScenePrograms[SCENE_PROGRAM_STATIC_ONLY]	= BuildProgram( SceneStaticVertexShaderSrc, SceneStaticFragmentShaderSrc );
+	ScenePrograms[SCENE_PROGRAM_STATIC_DYNAMIC]	= BuildProgram( SceneDynamicVertexShaderSrc, SceneStaticAndDynamicFragmentShaderSrc );
+	ScenePrograms[SCENE_PROGRAM_DYNAMIC_ONLY]	= BuildProgram( SceneDynamicVertexShaderSrc, SceneDynamicFragmentShaderSrc );
+	ScenePrograms[SCENE_PROGRAM_ADDITIVE]		= BuildProgram( SceneStaticVertexShaderSrc, SceneAdditiveFragmentShaderSrc );
+
+	// NOTE: make sure to load with SCENE_PROGRAM_STATIC_DYNAMIC because the textures are initially not swapped
+	DynamicPrograms = ModelGlPrograms( &ScenePrograms[ SCENE_PROGRAM_STATIC_DYNAMIC ] );
+
+	LOG( "ShaderManager::LoadVariants: %3.1f seconds", vrapi_GetTimeInSeconds() - start );
+}
+
 void ShaderManager::OneTimeShutdown()
 {
 	LOG( "ShaderManager::OneTimeShutdown" );
 
 	DeleteProgram( MovieExternalUiProgram );
+	DeleteProgram( MovieUiProgram );
 	DeleteProgram( CopyMovieProgram );
+	DeleteProgram( SampleMovieProgram );
 	DeleteProgram( UniformColorProgram );
 
 	DeleteProgram( ScenePrograms[SCENE_PROGRAM_BLACK] );	
@@ -43,12 +43,17 @@ public:
 	void					OneTimeInit( const char * launchIntent );
 	void					OneTimeShutdown();
 
+	// scene and movie programs, built after the lobby is up
+	void					LoadVariants();
+
 	CinemaApp &				Cinema;
 
 	// Render the external image texture to a conventional texture to allow
 	// mipmap generation.
 	GlProgram				CopyMovieProgram;
+	GlProgram				SampleMovieProgram;		// box filtered quarter size copy for change detection
 	GlProgram				MovieExternalUiProgram;
+	GlProgram				MovieUiProgram;			// a mip mapped copy, for the screens next to the stream
 	GlProgram				UniformColorProgram;
 
 	GlProgram				ProgVertexColor;
@@ -0,0 +1,140 @@
+/************************************************************************************
+
+Filename    :   StartupSequence.cpp
+Content     :	Tracks the startup work left after the first lobby frame and what depends on what
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "StartupSequence.h"
+#include "Android/LogUtils.h"
+
+namespace VRMatterStreamTheater {
+
+#define STARTUP_BIT( stage )	( 1 << ( stage ) )
+
+struct StartupStageDef
+{
+	const char *	Name;
+	int				DependsOn;		// STARTUP_BITs
+};
+
+static const StartupStageDef STAGES[STARTUP_STAGE_COUNT] =
+{
+	{ "shader variants",	0 },
+	{ "theaters",			STARTUP_BIT( STARTUP_SHADER_VARIANTS ) },		// dynamic programs
+	{ "theater selection",	STARTUP_BIT( STARTUP_THEATERS ) },
+	{ "movie player",		STARTUP_BIT( STARTUP_SHADER_VARIANTS ) | STARTUP_BIT( STARTUP_THEATERS ) | STARTUP_BIT( STARTUP_THEATER_SELECTION ) },
+	{ "resume menu",		0 }
+};
+
+StartupSequence::StartupSequence() :
+	StartTime( 0.0 ),
+	FirstFrameTime( -1.0 ),
+	InteractiveTime( -1.0 ),
+	AwaitedSteps( 0 )
+
+{
+	for ( int i = 0; i < STARTUP_STAGE_COUNT; i++ )
+	{
+		Ready[i] = false;
+		Steps[i] = 0;
+		Seconds[i] = 0.0;
+	}
+}
+
+void StartupSequence::Begin( const double now )
+{
+	StartTime = now;
+}
+
+void StartupSequence::FirstFrame( const double now )
+{
+	if ( FirstFrameTime >= 0.0 )
+	{
+		return;
+	}
+	FirstFrameTime = now;
+	LOG( "Startup: first frame %3.2f seconds after OneTimeInit started", GetTimeToFirstFrame() );
+	CheckInteractive( now );
+}
+
+StartupStage StartupSequence::NextStage() const
+{
+	for ( int i = 0; i < STARTUP_STAGE_COUNT; i++ )
+	{
+		if ( !Ready[i] )
+		{
+			return NextStageFor( (StartupStage)i );
+		}
+	}
+	return STARTUP_STAGE_COUNT;
+}
+
+StartupStage StartupSequence::NextStageFor( const StartupStage stage ) const
+{
+	if ( Ready[stage] )
+	{
+		return STARTUP_STAGE_COUNT;
+	}
+
+	// a stage only depends on earlier ones, so this always ends
+	for ( int i = 0; i < stage; i++ )
+	{
+		if ( ( STAGES[stage].DependsOn & STARTUP_BIT( i ) ) != 0 && !Ready[i] )
+		{
+			return NextStageFor( (StartupStage)i );
+		}
+	}
+	return stage;
+}
+
+void StartupSequence::StepDone( const StartupStage stage, const bool finished, const bool awaited, const double seconds, const double now )
+{
+	Steps[stage]++;
+	Seconds[stage] += seconds;
+	if ( awaited )
+	{
+		AwaitedSteps++;
+	}
+
+	if ( finished && !Ready[stage] )
+	{
+		Ready[stage] = true;
+		LOG( "Startup: %s ready, %i steps, %3.1f ms%s", STAGES[stage].Name, Steps[stage], Seconds[stage] * 1000.0,
+				awaited ? ", awaited" : "" );
+		CheckInteractive( now );
+	}
+}
+
+void StartupSequence::CheckInteractive( const double now )
+{
+	if ( InteractiveTime >= 0.0 || FirstFrameTime < 0.0 )
+	{
+		return;
+	}
+	for ( int i = 0; i < STARTUP_STAGE_COUNT; i++ )
+	{
+		if ( !Ready[i] )
+		{
+			return;
+		}
+	}
+
+	InteractiveTime = now;
+	LOG( "Startup: interactive %3.2f seconds after OneTimeInit started, first frame at %3.2f, %i steps awaited",
+			GetTimeToInteractive(), GetTimeToFirstFrame(), AwaitedSteps );
+}
+
+const char * StartupSequence::GetStageName( const StartupStage stage )
+{
+	return ( stage >= 0 && stage < STARTUP_STAGE_COUNT ) ? STAGES[stage].Name : "none";
+}
+
+} // namespace VRMatterStreamTheater
@@ -0,0 +1,84 @@
+/************************************************************************************
+
+Filename    :   StartupSequence.h
+Content     :	Tracks the startup work left after the first lobby frame and what depends on what
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( StartupSequence_h )
+#define StartupSequence_h
+
+#include "Kernel/OVR_Types.h"
+
+namespace VRMatterStreamTheater {
+
+// Everything the lobby doesn't need, in an order where each stage only
+// depends on the ones before it
+enum StartupStage
+{
+	STARTUP_SHADER_VARIANTS,	// scene and movie programs
+	STARTUP_THEATERS,			// read on the workers, one upload per step
+	STARTUP_THEATER_SELECTION,
+	STARTUP_MOVIE_PLAYER,		// the player view and its menu
+	STARTUP_RESUME_MENU,
+	STARTUP_STAGE_COUNT
+};
+
+//==============================================================
+// StartupSequence
+// Only does the bookkeeping, the app runs the steps.  Idle frames run
+// NextStage one step at a time.  Anything about to use a stage early
+// runs NextStageFor until it returns STARTUP_STAGE_COUNT, which brings
+// in the stage's dependencies first.  Interactive is when every stage
+// is ready and the first frame has been shown.
+class StartupSequence
+{
+public:
+							StartupSequence();
+
+	void					Begin( const double now );
+	void					FirstFrame( const double now );
+
+	// the next stage to step on an idle frame, STARTUP_STAGE_COUNT when there's none
+	StartupStage			NextStage() const;
+
+	// the stage to step before 'stage' can be used, STARTUP_STAGE_COUNT once it can
+	StartupStage			NextStageFor( const StartupStage stage ) const;
+
+	// finished when the stage has nothing left, awaited when something was waiting on it
+	void					StepDone( const StartupStage stage, const bool finished, const bool awaited, const double seconds, const double now );
+
+	bool					IsReady( const StartupStage stage ) const { return Ready[stage]; }
+	bool					IsComplete() const { return InteractiveTime >= 0.0; }
+
+	// seconds from Begin, -1 until it happens
+	double					GetTimeToFirstFrame() const { return FirstFrameTime < 0.0 ? -1.0 : FirstFrameTime - StartTime; }
+	double					GetTimeToInteractive() const { return InteractiveTime < 0.0 ? -1.0 : InteractiveTime - StartTime; }
+
+	// steps that ran because something was waiting, rather than on an idle frame
+	int						GetAwaitedSteps() const { return AwaitedSteps; }
+
+	static const char *		GetStageName( const StartupStage stage );
+
+private:
+	double					StartTime;
+	double					FirstFrameTime;
+	double					InteractiveTime;
+	bool					Ready[STARTUP_STAGE_COUNT];
+	int						Steps[STARTUP_STAGE_COUNT];
+	double					Seconds[STARTUP_STAGE_COUNT];
+	int						AwaitedSteps;
+
+	void					CheckInteractive( const double now );
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // StartupSequence_h
@@ -0,0 +1,389 @@
+/************************************************************************************
+
+Filename    :   StereoLayoutDetector.cpp
+Content     :	Tells side by side and top/bottom 3D from mono by comparing halves of the stream
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "StereoLayoutDetector.h"
+#include "Kernel/OVR_Alg.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined( __ARM_NEON__ ) || defined( __ARM_NEON )
+#include <arm_neon.h>
+#define STEREO_LAYOUT_NEON
+#endif
+
+namespace VRMatterStreamTheater {
+
+static const float	MAX_DISPARITY	= 0.07f;	// of the width of one view
+static const int	BLUR_RADIUS		= 3;		// detail is the luma minus a 7x7 box average
+static const float	MIN_DETAIL		= 3.0f;		// rms, anything flatter can't be judged
+static const float	SMOOTHING		= 0.3f;		// weight of a new sample
+static const float	MATCH			= 0.6f;		// halves this alike are two views
+static const float	MATCH_MARGIN	= 0.3f;		// and must beat the other split by this much
+static const float	MISMATCH		= 0.35f;	// both splits below this is mono
+static const int	SETTLE_VOTES	= 4;		// samples in a row before the layout changes
+
+// The NEON paths below have to give exactly the same result as the
+// plain ones, so both work in integers.
+
+// Adds luma * 256 of each pixel of a row to sums.  One pixel's is at
+// most 255 * 256, so it fits the 16 bit lanes.
+static void AddLumaRow( const UByte * rgba, const int width, UInt32 * sums )
+{
+	int x = 0;
+#if defined( STEREO_LAYOUT_NEON )
+	const uint8x8_t wr = vdup_n_u8( 77 );
+	const uint8x8_t wg = vdup_n_u8( 150 );
+	const uint8x8_t wb = vdup_n_u8( 29 );
+	for ( ; x + 8 <= width; x += 8 )
+	{
+		const uint8x8x4_t p = vld4_u8( rgba + x * 4 );
+		uint16x8_t luma = vmull_u8( p.val[0], wr );
+		luma = vmlal_u8( luma, p.val[1], wg );
+		luma = vmlal_u8( luma, p.val[2], wb );
+		vst1q_u32( sums + x, vaddw_u16( vld1q_u32( sums + x ), vget_low_u16( luma ) ) );
+		vst1q_u32( sums + x + 4, vaddw_u16( vld1q_u32( sums + x + 4 ), vget_high_u16( luma ) ) );
+	}
+#endif
+	for ( ; x < width; x++ )
+	{
+		const UByte * p = rgba + x * 4;
+		sums[x] += p[0] * 77 + p[1] * 150 + p[2] * 29;
+	}
+}
+
+#if defined( STEREO_LAYOUT_NEON )
+static inline int AddLanes( const int32x4_t v )
+{
+	const int32x2_t pair = vadd_s32( vget_low_s32( v ), vget_high_s32( v ) );
+	return vget_lane_s32( vpadd_s32( pair, pair ), 0 );
+}
+#endif
+
+// Sums of a, b, a * a, b * b and a * b along a row.  Detail is at most
+// 16 * 255 either way, so a whole row of a half fits in an int.
+static void SumRow( const short * a, const short * b, const int count, int sums[5] )
+{
+	int x = 0;
+	int sumA = 0, sumB = 0, sumAA = 0, sumBB = 0, sumAB = 0;
+#if defined( STEREO_LAYOUT_NEON )
+	int32x4_t va = vdupq_n_s32( 0 );
+	int32x4_t vb = vdupq_n_s32( 0 );
+	int32x4_t vaa = vdupq_n_s32( 0 );
+	int32x4_t vbb = vdupq_n_s32( 0 );
+	int32x4_t vab = vdupq_n_s32( 0 );
+	for ( ; x + 4 <= count; x += 4 )
+	{
+		const int16x4_t la = vld1_s16( a + x );
+		const int16x4_t lb = vld1_s16( b + x );
+		va = vaddw_s16( va, la );
+		vb = vaddw_s16( vb, lb );
+		vaa = vmlal_s16( vaa, la, la );
+		vbb = vmlal_s16( vbb, lb, lb );
+		vab = vmlal_s16( vab, la, lb );
+	}
+	sumA = AddLanes( va );
+	sumB = AddLanes( vb );
+	sumAA = AddLanes( vaa );
+	sumBB = AddLanes( vbb );
+	sumAB = AddLanes( vab );
+#endif
+	for ( ; x < count; x++ )
+	{
+		sumA += a[x];
+		sumB += b[x];
+		sumAA += a[x] * a[x];
+		sumBB += b[x] * b[x];
+		sumAB += a[x] * b[x];
+	}
+	sums[0] = sumA;
+	sums[1] = sumB;
+	sums[2] = sumAA;
+	sums[3] = sumBB;
+	sums[4] = sumAB;
+}
+
+// The same sums down each column, one row at a time
+static void SumColumns( const short * a, const short * b, const int count,
+		int * sumA, int * sumB, int * sumAA, int * sumBB, int * sumAB )
+{
+	int x = 0;
+#if defined( STEREO_LAYOUT_NEON )
+	for ( ; x + 4 <= count; x += 4 )
+	{
+		const int16x4_t la = vld1_s16( a + x );
+		const int16x4_t lb = vld1_s16( b + x );
+		vst1q_s32( sumA + x, vaddw_s16( vld1q_s32( sumA + x ), la ) );
+		vst1q_s32( sumB + x, vaddw_s16( vld1q_s32( sumB + x ), lb ) );
+		vst1q_s32( sumAA + x, vmlal_s16( vld1q_s32( sumAA + x ), la, la ) );
+		vst1q_s32( sumBB + x, vmlal_s16( vld1q_s32( sumBB + x ), lb, lb ) );
+		vst1q_s32( sumAB + x, vmlal_s16( vld1q_s32( sumAB + x ), la, lb ) );
+	}
+#endif
+	for ( ; x < count; x++ )
+	{
+		sumA[x] += a[x];
+		sumB[x] += b[x];
+		sumAA[x] += a[x] * a[x];
+		sumBB[x] += b[x] * b[x];
+		sumAB[x] += a[x] * b[x];
+	}
+}
+
+//==============================================================
+// StereoSampleAnalysis
+
+StereoSampleAnalysis::StereoSampleAnalysis() :
+	SideBySide( 0.0f ),
+	TopBottom( 0.0f )
+
+{
+}
+
+bool StereoSampleAnalysis::Analyze( const UByte * rgba, const int width, const int height )
+{
+	if ( !ExtractDetail( rgba, width, height ) )
+	{
+		// a black or flat screen says nothing about the layout
+		return false;
+	}
+
+	const int halfWidth = SAMPLE_WIDTH / 2;
+	const int halfHeight = SAMPLE_HEIGHT / 2;
+	SideBySide = MatchHalves( halfWidth, 0, halfWidth, SAMPLE_HEIGHT );
+	TopBottom = MatchHalves( 0, halfHeight, SAMPLE_WIDTH, halfHeight );
+	return true;
+}
+
+// Box filters the sample down to SAMPLE_WIDTH x SAMPLE_HEIGHT luma, then
+// subtracts a blurred copy so only the detail is left.
+bool StereoSampleAnalysis::ExtractDetail( const UByte * rgba, const int width, const int height )
+{
+	if ( width < SAMPLE_WIDTH || height < SAMPLE_HEIGHT || width > MAX_SOURCE_WIDTH )
+	{
+		return false;
+	}
+
+	for ( int y = 0; y < SAMPLE_HEIGHT; y++ )
+	{
+		// down the rows of the box first, then across
+		const int y0 = y * height / SAMPLE_HEIGHT;
+		const int y1 = ( y + 1 ) * height / SAMPLE_HEIGHT;
+		memset( RowSums, 0, width * sizeof( RowSums[0] ) );
+		for ( int sy = y0; sy < y1; sy++ )
+		{
+			AddLumaRow( rgba + sy * width * 4, width, RowSums );
+		}
+		int sx = 0;
+		for ( int x = 0; x < SAMPLE_WIDTH; x++ )
+		{
+			const int x0 = sx;
+			const int x1 = ( x + 1 ) * width / SAMPLE_WIDTH;
+			UInt32 sum = 0;
+			for ( ; sx < x1; sx++ )
+			{
+				sum += RowSums[sx];
+			}
+			Luma[y * SAMPLE_WIDTH + x] = (int)( sum / ( ( x1 - x0 ) * ( y1 - y0 ) * 256 ) );
+		}
+	}
+
+	const int stride = SAMPLE_WIDTH + 1;
+	for ( int x = 0; x <= SAMPLE_WIDTH; x++ )
+	{
+		Integral[x] = 0;
+	}
+	for ( int y = 0; y < SAMPLE_HEIGHT; y++ )
+	{
+		int row = 0;
+		Integral[( y + 1 ) * stride] = 0;
+		for ( int x = 0; x < SAMPLE_WIDTH; x++ )
+		{
+			row += Luma[y * SAMPLE_WIDTH + x];
+			Integral[( y + 1 ) * stride + x + 1] = Integral[y * stride + x + 1] + row;
+		}
+	}
+
+	float energy = 0.0f;
+	for ( int y = 0; y < SAMPLE_HEIGHT; y++ )
+	{
+		const int y0 = Alg::Max( 0, y - BLUR_RADIUS );
+		const int y1 = Alg::Min( SAMPLE_HEIGHT, y + BLUR_RADIUS + 1 );
+		for ( int x = 0; x < SAMPLE_WIDTH; x++ )
+		{
+			const int x0 = Alg::Max( 0, x - BLUR_RADIUS );
+			const int x1 = Alg::Min( SAMPLE_WIDTH, x + BLUR_RADIUS + 1 );
+			const int area = ( x1 - x0 ) * ( y1 - y0 );
+			const int sum = Integral[y1 * stride + x1] - Integral[y0 * stride + x1] - Integral[y1 * stride + x0] + Integral[y0 * stride + x0];
+			const int detail = Luma[y * SAMPLE_WIDTH + x] * area - sum;
+			Detail[y * SAMPLE_WIDTH + x] = (short)( detail * 16 / area );		// 4 bits of fraction
+			energy += (float)detail * detail / ( (float)area * area );
+		}
+	}
+
+	return sqrtf( energy / ( SAMPLE_WIDTH * SAMPLE_HEIGHT ) ) >= MIN_DETAIL;
+}
+
+// Normalized cross correlation of the half at the origin with the half at
+// bx, by, for the best horizontal disparity.  Both splits search
+// horizontally, the eyes are side by side either way.
+//
+// A line running all the way across the split, like the seam between top
+// and bottom views or the edge of a letterbox bar, shows up the same in
+// both halves.  Taking out the mean of each row (side by side) or column
+// (top/bottom) removes it without touching anything that really repeats.
+// The lines next to the split are skipped too, their blur reaches across it.
+//
+// Each line's sums are exact, the mean is taken out of them afterwards:
+// sum( ( a - meanA ) * ( b - meanB ) ) = sum( a * b ) - sum( a ) * sum( b ) / n
+float StereoSampleAnalysis::MatchHalves( const int bx, const int by, const int halfWidth, const int halfHeight )
+{
+	const bool sideBySide = ( by == 0 );
+	const int maxShift = (int)( halfWidth * MAX_DISPARITY );
+	const int marginX = sideBySide ? BLUR_RADIUS : 0;
+	const int marginY = sideBySide ? 0 : BLUR_RADIUS;
+	const int y0 = marginY;
+	const int y1 = halfHeight - marginY;
+
+	float best = -1.0f;
+	for ( int shift = -maxShift; shift <= maxShift; shift++ )
+	{
+		const int x0 = Alg::Max( marginX, marginX - shift );
+		const int x1 = Alg::Min( halfWidth - marginX, halfWidth - marginX - shift );
+		const int count = x1 - x0;
+
+		double sumAA = 0.0;
+		double sumBB = 0.0;
+		double sumAB = 0.0;
+		if ( sideBySide )
+		{
+			for ( int y = y0; y < y1; y++ )
+			{
+				int sums[5];
+				SumRow( Detail + y * SAMPLE_WIDTH + x0, Detail + y * SAMPLE_WIDTH + bx + shift + x0, count, sums );
+				sumAA += sums[2] - (double)sums[0] * sums[0] / count;
+				sumBB += sums[3] - (double)sums[1] * sums[1] / count;
+				sumAB += sums[4] - (double)sums[0] * sums[1] / count;
+			}
+		}
+		else
+		{
+			for ( int x = 0; x < count; x++ )
+			{
+				ColumnA[x] = ColumnB[x] = ColumnAA[x] = ColumnBB[x] = ColumnAB[x] = 0;
+			}
+			for ( int y = y0; y < y1; y++ )
+			{
+				SumColumns( Detail + y * SAMPLE_WIDTH + x0, Detail + ( y + by ) * SAMPLE_WIDTH + bx + shift + x0, count,
+						ColumnA, ColumnB, ColumnAA, ColumnBB, ColumnAB );
+			}
+			const int lineLength = y1 - y0;
+			for ( int x = 0; x < count; x++ )
+			{
+				sumAA += ColumnAA[x] - (double)ColumnA[x] * ColumnA[x] / lineLength;
+				sumBB += ColumnBB[x] - (double)ColumnB[x] * ColumnB[x] / lineLength;
+				sumAB += ColumnAB[x] - (double)ColumnA[x] * ColumnB[x] / lineLength;
+			}
+		}
+
+		if ( sumAA <= 0.0 || sumBB <= 0.0 )
+		{
+			continue;
+		}
+		best = Alg::Max( best, (float)( sumAB / sqrt( sumAA * sumBB ) ) );
+	}
+	return best;
+}
+
+//==============================================================
+// StereoLayoutDetector
+
+StereoLayoutDetector::StereoLayoutDetector() :
+	Analysis(),
+	Samples( 0 ),
+	SideBySideScore( 0.0f ),
+	TopBottomScore( 0.0f ),
+	Candidate( STEREO_LAYOUT_UNKNOWN ),
+	CandidateVotes( 0 ),
+	Layout( STEREO_LAYOUT_UNKNOWN )
+
+{
+}
+
+void StereoLayoutDetector::Reset()
+{
+	Samples = 0;
+	SideBySideScore = 0.0f;
+	TopBottomScore = 0.0f;
+	Candidate = STEREO_LAYOUT_UNKNOWN;
+	CandidateVotes = 0;
+	Layout = STEREO_LAYOUT_UNKNOWN;
+}
+
+void StereoLayoutDetector::AddSample( const UByte * rgba, const int width, const int height )
+{
+	if ( Analysis.Analyze( rgba, width, height ) )
+	{
+		AddAnalysis( Analysis );
+	}
+}
+
+void StereoLayoutDetector::AddAnalysis( const StereoSampleAnalysis & analysis )
+{
+	const float sideBySide = analysis.GetSideBySide();
+	const float topBottom = analysis.GetTopBottom();
+	if ( Samples == 0 )
+	{
+		SideBySideScore = sideBySide;
+		TopBottomScore = topBottom;
+	}
+	else
+	{
+		SideBySideScore += ( sideBySide - SideBySideScore ) * SMOOTHING;
+		TopBottomScore += ( topBottom - TopBottomScore ) * SMOOTHING;
+	}
+	Samples++;
+
+	const StereoLayout vote = Classify();
+	if ( vote != Candidate )
+	{
+		Candidate = vote;
+		CandidateVotes = 0;
+	}
+	CandidateVotes++;
+
+	if ( Candidate != STEREO_LAYOUT_UNKNOWN && CandidateVotes >= SETTLE_VOTES )
+	{
+		Layout = Candidate;
+	}
+}
+
+StereoLayout StereoLayoutDetector::Classify() const
+{
+	if ( SideBySideScore > MATCH && SideBySideScore - TopBottomScore > MATCH_MARGIN )
+	{
+		return STEREO_LAYOUT_SIDE_BY_SIDE;
+	}
+	if ( TopBottomScore > MATCH && TopBottomScore - SideBySideScore > MATCH_MARGIN )
+	{
+		return STEREO_LAYOUT_TOP_BOTTOM;
+	}
+	if ( SideBySideScore < MISMATCH && TopBottomScore < MISMATCH )
+	{
+		return STEREO_LAYOUT_MONO;
+	}
+	return STEREO_LAYOUT_UNKNOWN;
+}
+
+} // namespace VRMatterStreamTheater
@@ -0,0 +1,110 @@
+/************************************************************************************
+
+Filename    :   StereoLayoutDetector.h
+Content     :	Tells side by side and top/bottom 3D from mono by comparing halves of the stream
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( StereoLayoutDetector_h )
+#define StereoLayoutDetector_h
+
+#include "Kernel/OVR_Types.h"
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+enum StereoLayout
+{
+	STEREO_LAYOUT_UNKNOWN,
+	STEREO_LAYOUT_MONO,
+	STEREO_LAYOUT_SIDE_BY_SIDE,
+	STEREO_LAYOUT_TOP_BOTTOM
+};
+
+//==============================================================
+// StereoSampleAnalysis
+// The expensive part of a sample.  It is shrunk to a small luma image
+// with the large scale shading removed, so a sky over a floor doesn't
+// look like a match, and the two halves are then correlated allowing a
+// few pixels of disparity.  Everything it needs is in here, so it can
+// run on a worker while the detector stays on the GL thread.
+class StereoSampleAnalysis
+{
+public:
+	static const int	SAMPLE_WIDTH = 128;
+	static const int	SAMPLE_HEIGHT = 72;
+	static const int	MAX_SOURCE_WIDTH = 4096;	// wider samples are ignored
+
+						StereoSampleAnalysis();
+
+	// rows are tightly packed, width * 4 bytes.  Returns false for a
+	// sample too small, too big or too flat to say anything.
+	bool				Analyze( const UByte * rgba, const int width, const int height );
+
+	// correlations of the last sample analyzed, -1 to 1
+	float				GetSideBySide() const { return SideBySide; }
+	float				GetTopBottom() const { return TopBottom; }
+
+private:
+	UInt32				RowSums[MAX_SOURCE_WIDTH];	// luma * 256 down the rows of one sample row
+	int					Luma[SAMPLE_WIDTH * SAMPLE_HEIGHT];
+	int					Integral[( SAMPLE_WIDTH + 1 ) * ( SAMPLE_HEIGHT + 1 )];	// summed area table for the blur
+	short				Detail[SAMPLE_WIDTH * SAMPLE_HEIGHT];
+	int					ColumnA[SAMPLE_WIDTH];		// per column sums for the top/bottom match
+	int					ColumnB[SAMPLE_WIDTH];
+	int					ColumnAA[SAMPLE_WIDTH];
+	int					ColumnBB[SAMPLE_WIDTH];
+	int					ColumnAB[SAMPLE_WIDTH];
+	float				SideBySide;
+	float				TopBottom;
+
+	bool				ExtractDetail( const UByte * rgba, const int width, const int height );
+	float				MatchHalves( const int bx, const int by, const int halfWidth, const int halfHeight );
+};
+
+//==============================================================
+// StereoLayoutDetector
+// Smooths the scores of each analyzed sample and only reports a layout
+// once several samples in a row agree on it.
+class StereoLayoutDetector
+{
+public:
+						StereoLayoutDetector();
+
+	void				Reset();
+
+	// analyzes on the calling thread, rows are tightly packed, width * 4 bytes
+	void				AddSample( const UByte * rgba, const int width, const int height );
+	// a sample analyzed elsewhere, Analyze must have returned true
+	void				AddAnalysis( const StereoSampleAnalysis & analysis );
+
+	// UNKNOWN until enough samples agree
+	StereoLayout		GetLayout() const { return Layout; }
+
+	// smoothed correlations, -1 to 1
+	float				GetSideBySideScore() const { return SideBySideScore; }
+	float				GetTopBottomScore() const { return TopBottomScore; }
+
+private:
+	StereoSampleAnalysis	Analysis;		// for AddSample
+	int					Samples;
+	float				SideBySideScore;
+	float				TopBottomScore;
+	StereoLayout		Candidate;
+	int					CandidateVotes;
+	StereoLayout		Layout;
+
+	StereoLayout		Classify() const;
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // StereoLayoutDetector_h
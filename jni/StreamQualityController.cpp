@@ -0,0 +1,361 @@
+/************************************************************************************
+
+Filename    :   StreamQualityController.cpp
+Content     :	Adaptive stream quality: measures delivery and steps stream parameters
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "StreamQualityController.h"
+
+#include <math.h>
+
+namespace VRMatterStreamTheater {
+
+// A window is bad if any of these are exceeded...
+static const float	BAD_JITTER_MS			= 8.0f;
+static const float	BAD_LATE_FRACTION		= 0.05f;
+static const float	BAD_LATENCY_MS			= 100.0f;
+static const float	BAD_RENDER_MS			= 20.0f;
+
+// ...and only good if all of these are met.  Anything in between leaves things alone.
+static const float	GOOD_JITTER_MS			= 4.0f;
+static const float	GOOD_LATE_FRACTION		= 0.01f;
+static const float	GOOD_LATENCY_MS			= 60.0f;
+static const float	GOOD_RENDER_MS			= 17.5f;
+
+static const int	BAD_WINDOWS_TO_STEP_DOWN	= 2;
+static const int	GOOD_WINDOWS_TO_STEP_UP		= 10;
+static const int	MAX_GOOD_WINDOWS_TO_STEP_UP	= 80;
+
+// every change restarts the stream, so give it time to settle before judging it
+static const double	SETTLE_SECONDS			= 5.0;
+// stepping down this soon after stepping up means the step up failed
+static const double	FAILED_PROBE_SECONDS	= 30.0;
+
+static const float	BITRATE_STEP_DOWN		= 0.75f;
+static const float	BITRATE_STEP_UP			= 1.25f;
+static const float	BITRATE_FLOOR_FRACTION	= 0.5f;
+
+const double StreamQualityStats::WINDOW_SECONDS = 1.0;
+
+//==============================================================
+// StreamQualityStats
+
+StreamQualityStats::StreamQualityStats() :
+	ExpectedPeriod( 0.0 )
+{
+	Reset( 0.0 );
+}
+
+void StreamQualityStats::Reset( const double now )
+{
+	WindowStart = now;
+	LastArrival = -1.0;
+	Intervals = 0;
+	IntervalSum = 0.0;
+	IntervalSumSq = 0.0;
+	LateIntervals = 0;
+	Frames = 0;
+	LatencyCount = 0;
+	LatencySum = 0.0;
+	RenderCount = 0;
+	RenderSum = 0.0;
+}
+
+void StreamQualityStats::AddFrameArrival( const double time )
+{
+	Frames++;
+	if ( LastArrival >= 0.0 )
+	{
+		const double interval = time - LastArrival;
+		Intervals++;
+		IntervalSum += interval;
+		IntervalSumSq += interval * interval;
+		if ( ExpectedPeriod > 0.0 && interval > ExpectedPeriod * 1.5 )
+		{
+			LateIntervals++;
+		}
+	}
+	LastArrival = time;
+}
+
+void StreamQualityStats::AddLatency( const float ms )
+{
+	LatencyCount++;
+	LatencySum += ms;
+}
+
+void StreamQualityStats::AddRenderFrame( const float seconds )
+{
+	RenderCount++;
+	RenderSum += seconds;
+}
+
+bool StreamQualityStats::GetSample( const double now, const int expectedFPS, StreamQualitySample & sample )
+{
+	ExpectedPeriod = expectedFPS > 0 ? 1.0 / expectedFPS : 0.0;
+
+	const double duration = now - WindowStart;
+	if ( duration < WINDOW_SECONDS )
+	{
+		return false;
+	}
+
+	sample = StreamQualitySample();
+
+	if ( Intervals > 1 )
+	{
+		const double mean = IntervalSum / Intervals;
+		const double variance = IntervalSumSq / Intervals - mean * mean;
+		sample.FrameJitterMs = variance > 0.0 ? (float)( sqrt( variance ) * 1000.0 ) : 0.0f;
+		sample.LateFrameFraction = (float)LateIntervals / Intervals;
+	}
+
+	// frames that never showed up count as late too
+	const double expectedFrames = duration * expectedFPS;
+	if ( expectedFrames > 0.0 )
+	{
+		const float missing = (float)( 1.0 - Frames / expectedFrames );
+		if ( missing > sample.LateFrameFraction )
+		{
+			sample.LateFrameFraction = missing;
+		}
+	}
+
+	sample.LatencyMs = LatencyCount > 0 ? (float)( LatencySum / LatencyCount ) : 0.0f;
+	sample.RenderFrameMs = RenderCount > 0 ? (float)( RenderSum / RenderCount * 1000.0 ) : 0.0f;
+
+	// keep the last arrival so the first interval of the next window is measured
+	const double lastArrival = LastArrival;
+	Reset( now );
+	LastArrival = lastArrival;
+
+	return true;
+}
+
+//==============================================================
+// StreamQualityController
+
+StreamQualityController::StreamQualityController() :
+	Target(),
+	Current(),
+	State( QUALITY_STABLE ),
+	BitrateMin( 0 ),
+	BitrateMax( 20000 ),
+	BadWindows( 0 ),
+	GoodWindows( 0 ),
+	GoodWindowsNeeded( GOOD_WINDOWS_TO_STEP_UP ),
+	LastChangeTime( 0.0 ),
+	LastChangeWasUp( false )
+
+{
+}
+
+void StreamQualityController::SetBitrateLimits( const int bitrateMin, const int bitrateMax )
+{
+	BitrateMin = bitrateMin;
+	BitrateMax = bitrateMax > bitrateMin ? bitrateMax : bitrateMin;
+}
+
+void StreamQualityController::Reset( const StreamQualityParams & target, const double now )
+{
+	Target = target;
+	if ( Target.Bitrate <= 0 )
+	{
+		Target.Bitrate = DefaultBitrate( Target.Width, Target.Height, Target.FPS );
+	}
+	Target.Bitrate = BitrateCeiling( Target );
+
+	Current = Target;
+	State = QUALITY_STABLE;
+	BadWindows = 0;
+	GoodWindows = 0;
+	GoodWindowsNeeded = GOOD_WINDOWS_TO_STEP_UP;
+	LastChangeTime = now;
+	LastChangeWasUp = false;
+}
+
+// Moonlight's defaults for each mode, picked by pixel count so ultrawide
+// and 16:10 modes land with the one they're closest to
+int StreamQualityController::DefaultBitrate( const int width, const int height, const int fps )
+{
+	const int pixels = width * height;
+	const int base = ( pixels >= 3840 * 2160 ) ? 80000 : ( ( pixels >= 1920 * 1080 ) ? 20000 : 10000 );
+	return ( fps >= 60 ) ? base : base / 2;
+}
+
+// the user's limits win over the mode's defaults
+int StreamQualityController::ClampBitrate( const int bitrate ) const
+{
+	return bitrate < BitrateMin ? BitrateMin : ( bitrate > BitrateMax ? BitrateMax : bitrate );
+}
+
+int StreamQualityController::BitrateFloor( const StreamQualityParams & p ) const
+{
+	return ClampBitrate( (int)( DefaultBitrate( p.Width, p.Height, p.FPS ) * BITRATE_FLOOR_FRACTION ) );
+}
+
+int StreamQualityController::BitrateCeiling( const StreamQualityParams & p ) const
+{
+	int ceiling = DefaultBitrate( p.Width, p.Height, p.FPS );
+	if ( p.Width == Target.Width && p.Height == Target.Height && p.FPS == Target.FPS && Target.Bitrate > 0 )
+	{
+		ceiling = Target.Bitrate;
+	}
+	return ClampBitrate( ceiling );
+}
+
+bool StreamQualityController::StepDown()
+{
+	StreamQualityParams next = Current;
+
+	const int floor = BitrateFloor( Current );
+	if ( Current.Bitrate > floor )
+	{
+		next.Bitrate = (int)( Current.Bitrate * BITRATE_STEP_DOWN );
+		if ( next.Bitrate < floor )
+		{
+			next.Bitrate = floor;
+		}
+	}
+	else if ( Current.FPS > 30 )
+	{
+		next.FPS = 30;
+	}
+	else if ( Current.Height > 720 )
+	{
+		// same aspect ratio, rounded to an even width for the decoder
+		next.Width = (int)( ( (long long)Current.Width * 720 + Current.Height ) / ( 2 * Current.Height ) * 2 );
+		next.Height = 720;
+	}
+	else
+	{
+		return false;
+	}
+
+	// a mode change keeps the bitrate if it fits the new mode
+	if ( next.FPS != Current.FPS || next.Height != Current.Height )
+	{
+		const int newFloor = BitrateFloor( next );
+		const int newCeiling = BitrateCeiling( next );
+		next.Bitrate = next.Bitrate < newFloor ? newFloor : ( next.Bitrate > newCeiling ? newCeiling : next.Bitrate );
+	}
+
+	Current = next;
+	return true;
+}
+
+bool StreamQualityController::StepUp()
+{
+	StreamQualityParams next = Current;
+
+	const int ceiling = BitrateCeiling( Current );
+	if ( Current.Bitrate < ceiling )
+	{
+		next.Bitrate = (int)( Current.Bitrate * BITRATE_STEP_UP );
+		if ( next.Bitrate > ceiling )
+		{
+			next.Bitrate = ceiling;
+		}
+	}
+	else if ( Current.FPS < Target.FPS )
+	{
+		next.FPS = Target.FPS;
+		next.Bitrate = BitrateFloor( next );
+	}
+	else if ( Current.Height < Target.Height )
+	{
+		next.Width = Target.Width;
+		next.Height = Target.Height;
+		next.Bitrate = BitrateFloor( next );
+	}
+	else
+	{
+		return false;
+	}
+
+	Current = next;
+	return true;
+}
+
+bool StreamQualityController::Evaluate( const StreamQualitySample & sample, const double now )
+{
+	if ( now - LastChangeTime < SETTLE_SECONDS )
+	{
+		return false;
+	}
+
+	const bool bad = sample.FrameJitterMs > BAD_JITTER_MS || sample.LateFrameFraction > BAD_LATE_FRACTION ||
+			sample.LatencyMs > BAD_LATENCY_MS || sample.RenderFrameMs > BAD_RENDER_MS;
+	const bool good = sample.FrameJitterMs < GOOD_JITTER_MS && sample.LateFrameFraction < GOOD_LATE_FRACTION &&
+			sample.LatencyMs < GOOD_LATENCY_MS && sample.RenderFrameMs < GOOD_RENDER_MS;
+
+	BadWindows = bad ? BadWindows + 1 : 0;
+	GoodWindows = good ? GoodWindows + 1 : 0;
+
+	if ( BadWindows >= BAD_WINDOWS_TO_STEP_DOWN )
+	{
+		BadWindows = 0;
+
+		if ( LastChangeWasUp && now - LastChangeTime < FAILED_PROBE_SECONDS )
+		{
+			// the last recovery didn't hold, wait longer before the next one
+			GoodWindowsNeeded *= 2;
+			if ( GoodWindowsNeeded > MAX_GOOD_WINDOWS_TO_STEP_UP )
+			{
+				GoodWindowsNeeded = MAX_GOOD_WINDOWS_TO_STEP_UP;
+			}
+		}
+
+		if ( !StepDown() )
+		{
+			State = QUALITY_MINIMUM;
+			return false;
+		}
+
+		State = QUALITY_DEGRADED;
+		LastChangeTime = now;
+		LastChangeWasUp = false;
+		return true;
+	}
+
+	if ( GoodWindows >= GoodWindowsNeeded )
+	{
+		GoodWindows = 0;
+
+		if ( !StepUp() )
+		{
+			State = QUALITY_STABLE;
+			GoodWindowsNeeded = GOOD_WINDOWS_TO_STEP_UP;
+			return false;
+		}
+
+		State = ( Current == Target ) ? QUALITY_STABLE : QUALITY_RECOVERING;
+		LastChangeTime = now;
+		LastChangeWasUp = true;
+		return true;
+	}
+
+	return false;
+}
+
+const char * StreamQualityController::GetStateName() const
+{
+	switch ( State )
+	{
+		case QUALITY_STABLE:		return "stable";
+		case QUALITY_DEGRADED:		return "reduced";
+		case QUALITY_RECOVERING:	return "recovering";
+		case QUALITY_MINIMUM:		return "minimum";
+	}
+	return "";
+}
+
+} // namespace VRMatterStreamTheater
@@ -0,0 +1,146 @@
+/************************************************************************************
+
+Filename    :   StreamQualityController.h
+Content     :	Adaptive stream quality: measures delivery and steps stream parameters
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( StreamQualityController_h )
+#define StreamQualityController_h
+
+// Only the kernel types are used here, so both classes can be driven
+// from recorded traces without a device.
+#include "Kernel/OVR_Types.h"
+
+namespace VRMatterStreamTheater {
+
+struct StreamQualityParams
+{
+	int		Width;
+	int		Height;
+	int		FPS;
+	int		Bitrate;	// kbps, 0 means the host's default for the mode
+
+			StreamQualityParams() : Width( 1280 ), Height( 720 ), FPS( 60 ), Bitrate( 0 ) {}
+			StreamQualityParams( int width, int height, int fps, int bitrate ) :
+				Width( width ), Height( height ), FPS( fps ), Bitrate( bitrate ) {}
+
+	bool	operator == ( const StreamQualityParams & b ) const { return Width == b.Width && Height == b.Height && FPS == b.FPS && Bitrate == b.Bitrate; }
+	bool	operator != ( const StreamQualityParams & b ) const { return !( *this == b ); }
+};
+
+// One measurement window, summarized
+struct StreamQualitySample
+{
+	float	FrameJitterMs;		// standard deviation of the frame arrival interval
+	float	LateFrameFraction;	// frames missing or arriving more than half a period late
+	float	LatencyMs;			// decode to display
+	float	RenderFrameMs;		// app frame time
+
+			StreamQualitySample() : FrameJitterMs( 0.0f ), LateFrameFraction( 0.0f ), LatencyMs( 0.0f ), RenderFrameMs( 0.0f ) {}
+};
+
+//==============================================================
+// StreamQualityStats
+// Accumulates per-frame measurements and produces a sample per window
+class StreamQualityStats
+{
+public:
+	static const double	WINDOW_SECONDS;
+
+						StreamQualityStats();
+
+	// starts a new window, the expected frame period is kept
+	void				Reset( const double now );
+
+	void				AddFrameArrival( const double time );
+	void				AddLatency( const float ms );
+	void				AddRenderFrame( const float seconds );
+
+	// returns true once per window with the summary of that window
+	bool				GetSample( const double now, const int expectedFPS, StreamQualitySample & sample );
+
+private:
+	double				WindowStart;
+	double				LastArrival;
+
+	int					Intervals;
+	double				IntervalSum;
+	double				IntervalSumSq;
+	int					LateIntervals;
+	int					Frames;
+	double				ExpectedPeriod;
+
+	int					LatencyCount;
+	double				LatencySum;
+
+	int					RenderCount;
+	double				RenderSum;
+};
+
+//==============================================================
+// StreamQualityController
+// Pure control law.  Degrades bitrate first, then frame rate, then
+// resolution, and recovers in the same order, never above the
+// parameters the user picked.
+class StreamQualityController
+{
+public:
+	enum QualityState
+	{
+		QUALITY_STABLE,
+		QUALITY_DEGRADED,	// stepped down and holding
+		QUALITY_RECOVERING,	// stepped back up, watching for trouble
+		QUALITY_MINIMUM		// nothing left to step down
+	};
+
+						StreamQualityController();
+
+	void				SetBitrateLimits( const int bitrateMin, const int bitrateMax );
+
+	// target is the user's choice and the upper bound for recovery
+	void				Reset( const StreamQualityParams & target, const double now );
+
+	// returns true when the stream parameters changed and the stream needs a restart
+	bool				Evaluate( const StreamQualitySample & sample, const double now );
+
+	const StreamQualityParams &	GetParams() const { return Current; }
+	bool				IsAtTarget() const { return Current == Target; }
+	QualityState		GetState() const { return State; }
+	const char *		GetStateName() const;
+
+	static int			DefaultBitrate( const int width, const int height, const int fps );
+
+private:
+	StreamQualityParams	Target;
+	StreamQualityParams	Current;
+	QualityState		State;
+
+	int					BitrateMin;
+	int					BitrateMax;
+
+	int					BadWindows;
+	int					GoodWindows;
+	int					GoodWindowsNeeded;	// grows each time a recovery step fails
+
+	double				LastChangeTime;
+	bool				LastChangeWasUp;
+
+	int					ClampBitrate( const int bitrate ) const;
+	int					BitrateFloor( const StreamQualityParams & p ) const;
+	int					BitrateCeiling( const StreamQualityParams & p ) const;
+
+	bool				StepDown();
+	bool				StepUp();
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // StreamQualityController_h
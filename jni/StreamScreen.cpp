@@ -0,0 +1,232 @@
+/************************************************************************************
+
+Filename    :   StreamScreen.cpp
+Content     :	A screen in the theater fed by its own frame source
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "StreamScreen.h"
+#include "TraceRecorder.h"
+#include "Android/LogUtils.h"
+#include "Kernel/OVR_Alg.h"
+
+#include <math.h>
+
+namespace VRMatterStreamTheater {
+
+static const int	PATTERN_BITS		= 16;		// blocks of the frame counter
+static const int	BAR_DIVISOR			= 32;		// the sweeping bar is this much of the width
+
+//=======================================================================================
+
+SyntheticFrameSource::SyntheticFrameSource( const int width, const int height, const float fps, const int seed ) :
+	Width( Alg::Max( PATTERN_BITS, width ) ),
+	Height( Alg::Max( 2, height ) ),
+	FrameSeconds( 1.0 / ( fps > 1.0f ? fps : 1.0f ) ),
+	Seed( seed ),
+	StartTime( -1.0 ),
+	FrameNumber( 0 ),
+	DrawnFrame( -1 ),
+	Pixels()
+
+{
+	Pixels.Resize( Width * Height * 4 );
+}
+
+bool SyntheticFrameSource::Latch( const double now )
+{
+	if ( StartTime < 0.0 )
+	{
+		StartTime = now;
+		return true;
+	}
+
+	const int frame = (int)( ( now - StartTime ) / FrameSeconds );
+	if ( frame == FrameNumber )
+	{
+		return false;
+	}
+	FrameNumber = frame;
+	return true;
+}
+
+void SyntheticFrameSource::DrawPattern()
+{
+	TRACE_SCOPE( "SyntheticFrameSource::DrawPattern" );
+
+	const double seconds = FrameNumber * FrameSeconds;
+	const int barWidth = Alg::Max( 1, Width / BAR_DIVISOR );
+	const int barX = (int)( ( seconds - floor( seconds ) ) * ( Width - barWidth ) );
+	const int blockWidth = Width / PATTERN_BITS;
+	const int blockHeight = Alg::Max( 1, Height / 12 );
+	const UByte tint = (UByte)( 64 + Seed * 97 );
+
+	for ( int y = 0; y < Height; y++ )
+	{
+		// y counts from the top, the rows are stored from the bottom
+		UByte * row = &Pixels[( Height - 1 - y ) * Width * 4];
+		for ( int x = 0; x < Width; x++ )
+		{
+			UByte * p = row + x * 4;
+			if ( y < blockHeight && x < blockWidth * PATTERN_BITS )
+			{
+				const int bit = PATTERN_BITS - 1 - x / blockWidth;
+				const UByte v = ( ( FrameNumber >> bit ) & 1 ) ? 255 : 0;
+				p[0] = p[1] = p[2] = v;
+			}
+			else if ( x >= barX && x < barX + barWidth )
+			{
+				p[0] = p[1] = p[2] = 255;
+			}
+			else
+			{
+				p[0] = (UByte)( x * 255 / Width );
+				p[1] = (UByte)( y * 255 / Height );
+				p[2] = tint;
+			}
+			p[3] = 255;
+		}
+	}
+	DrawnFrame = FrameNumber;
+}
+
+void SyntheticFrameSource::CopyTo( const GLuint texture, const GLuint fbo, const int width, const int height )
+{
+	OVR_UNUSED( fbo );
+	if ( DrawnFrame != FrameNumber )
+	{
+		DrawPattern();
+	}
+	glBindTexture( GL_TEXTURE_2D, texture );
+	glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, Alg::Min( width, Width ), Alg::Min( height, Height ),
+			GL_RGBA, GL_UNSIGNED_BYTE, &Pixels[0] );
+	glBindTexture( GL_TEXTURE_2D, 0 );
+}
+
+//=======================================================================================
+
+StreamScreen::StreamScreen( FrameSource * source, const bool srgb ) :
+	Pose(),
+	Size( 1.0f, 1.0f ),
+	Format( VT_2D ),
+	Source( source ),
+	Srgb( srgb ),
+	Pending( false ),
+	Copies( 0 ),
+	TextureWidth( 0 ),
+	TextureHeight( 0 ),
+	CurrentTexture( 0 )
+
+{
+	for ( int i = 0; i < NUM_TEXTURES; i++ )
+	{
+		Textures[i] = 0;
+		FBOs[i] = 0;
+	}
+}
+
+StreamScreen::~StreamScreen()
+{
+	delete Source;
+	Source = NULL;
+}
+
+void StreamScreen::Shutdown()
+{
+	FreeTextures();
+	Copies = 0;
+}
+
+void StreamScreen::FreeTextures()
+{
+	for ( int i = 0; i < NUM_TEXTURES; i++ )
+	{
+		if ( FBOs[i] != 0 )
+		{
+			glDeleteFramebuffers( 1, &FBOs[i] );
+			FBOs[i] = 0;
+		}
+		if ( Textures[i] != 0 )
+		{
+			glDeleteTextures( 1, &Textures[i] );
+			Textures[i] = 0;
+		}
+	}
+	TextureWidth = 0;
+	TextureHeight = 0;
+}
+
+// Same as SceneManager::CreateMovieTextures
+void StreamScreen::CreateTextures()
+{
+	FreeTextures();
+	TextureWidth = Source->GetWidth();
+	TextureHeight = Source->GetHeight();
+	LOG( "StreamScreen: %ix%i textures", TextureWidth, TextureHeight );
+
+	for ( int i = 0; i < NUM_TEXTURES; i++ )
+	{
+		glGenTextures( 1, &Textures[i] );
+		glBindTexture( GL_TEXTURE_2D, Textures[i] );
+
+		glTexImage2D( GL_TEXTURE_2D, 0, Srgb ? GL_SRGB8_ALPHA8 : GL_RGBA,
+				TextureWidth, TextureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+
+		glGenFramebuffers( 1, &FBOs[i] );
+		glBindFramebuffer( GL_FRAMEBUFFER, FBOs[i] );
+		glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, Textures[i], 0 );
+		glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+	}
+	glBindTexture( GL_TEXTURE_2D, 0 );
+}
+
+bool StreamScreen::Latch( const double now )
+{
+	if ( Source->Latch( now ) )
+	{
+		Pending = true;
+	}
+	return Pending;
+}
+
+// The textures ahead in the ring may still be read by TimeWarp, the
+// same as the stream's, so the copy always goes to the next one.
+void StreamScreen::Copy()
+{
+	TRACE_SCOPE( "StreamScreen::Copy" );
+
+	if ( TextureWidth != Source->GetWidth() || TextureHeight != Source->GetHeight() )
+	{
+		CreateTextures();
+	}
+
+	CurrentTexture = ( CurrentTexture + 1 ) % NUM_TEXTURES;
+	Source->CopyTo( Textures[CurrentTexture], FBOs[CurrentTexture], TextureWidth, TextureHeight );
+
+	glBindTexture( GL_TEXTURE_2D, Textures[CurrentTexture] );
+	glGenerateMipmap( GL_TEXTURE_2D );
+	glBindTexture( GL_TEXTURE_2D, 0 );
+
+	Pending = false;
+	Copies++;
+}
+
+Matrix4f StreamScreen::ModelMatrix() const
+{
+	return Matrix4f::Translation( Pose.Position ) * Matrix4f( Pose.Orientation ) *
+			Matrix4f::Scaling( Size.x * 0.5f, Size.y * 0.5f, 1.0f );
+}
+
+} // namespace VRMatterStreamTheater
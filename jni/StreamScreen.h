@@ -0,0 +1,136 @@
+/************************************************************************************
+
+Filename    :   StreamScreen.h
+Content     :	A screen in the theater fed by its own frame source
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( StreamScreen_h )
+#define StreamScreen_h
+
+#include "Android/GLUtils.h"
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_Math.h"
+#include "Kernel/OVR_Array.h"
+#include "AppManager.h"		// MovieFormat
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+//==============================================================
+// FrameSource
+// Where a StreamScreen's pictures come from.  Everything is called on
+// the GL thread.
+class FrameSource
+{
+public:
+	virtual				~FrameSource() {}
+
+	// Once a frame, returns true if a new picture arrived since the last call.
+	virtual bool		Latch( const double now ) = 0;
+
+	virtual int			GetWidth() const = 0;
+	virtual int			GetHeight() const = 0;
+
+	// Puts the latest picture into the top level of texture, bottom row
+	// first like the stream's copy.  fbo has texture attached.
+	virtual void		CopyTo( const GLuint texture, const GLuint fbo, const int width, const int height ) = 0;
+};
+
+//==============================================================
+// SyntheticFrameSource
+// A test pattern at a fixed frame rate, standing in for a decoder: a
+// gradient tinted by Seed, a bar sweeping across once a second and the
+// frame number in binary as 16 blocks along the top, so dropped and
+// repeated frames show in a capture.  The picture is only drawn when
+// it is copied.
+class SyntheticFrameSource : public FrameSource
+{
+public:
+						SyntheticFrameSource( const int width, const int height, const float fps, const int seed );
+
+	virtual bool		Latch( const double now );
+	virtual int			GetWidth() const { return Width; }
+	virtual int			GetHeight() const { return Height; }
+	virtual void		CopyTo( const GLuint texture, const GLuint fbo, const int width, const int height );
+
+	int					GetFrameNumber() const { return FrameNumber; }
+
+private:
+	int					Width;
+	int					Height;
+	double				FrameSeconds;
+	int					Seed;
+
+	double				StartTime;			// negative until the first Latch
+	int					FrameNumber;
+	int					DrawnFrame;			// the picture in Pixels
+	Array<UByte>		Pixels;
+
+	void				DrawPattern();
+};
+
+//==============================================================
+// StreamScreen
+// A screen with its own pose, size, format and a triple buffered, mip
+// mapped copy of its source, the same as the stream's so it can be the
+// TimeWarp overlay.  Owns the source.
+//
+// The stream itself stays in SceneManager, these are the screens next
+// to it; SceneManager's ScreenCompositor decides which get copied.
+// srgb makes the textures sRGB like the stream's when the eye buffers are.
+class StreamScreen
+{
+public:
+	static const int	NUM_TEXTURES = 3;
+
+	Posef				Pose;			// center of the screen
+	Vector2f			Size;			// meters
+	MovieFormat			Format;
+
+						StreamScreen( FrameSource * source, const bool srgb );
+						~StreamScreen();
+
+	// GL thread
+	void				Shutdown();
+
+	// GL thread, once a frame
+	bool				Latch( const double now );
+	bool				IsPending() const { return Pending; }
+	int					CopyPixels() const { return Source->GetWidth() * Source->GetHeight(); }
+	void				Copy();
+
+	bool				HasFrame() const { return Copies > 0; }
+	GLuint				GetTexture() const { return Textures[CurrentTexture]; }
+	int					GetCopies() const { return Copies; }
+
+	// the -1 to 1 unit square to the world
+	Matrix4f			ModelMatrix() const;
+
+private:
+	FrameSource *		Source;
+	bool				Srgb;
+	bool				Pending;
+	int					Copies;
+
+	int					TextureWidth;
+	int					TextureHeight;
+	int					CurrentTexture;
+	GLuint				Textures[NUM_TEXTURES];
+	GLuint				FBOs[NUM_TEXTURES];
+
+	void				CreateTextures();
+	void				FreeTextures();
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // StreamScreen_h
@@ -0,0 +1,449 @@
+/************************************************************************************
+
+Filename    :   TaskScheduler.cpp
+Content     :	Work stealing worker pool with priorities, cancellation and main thread completions
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "TaskScheduler.h"
+#include "Android/LogUtils.h"
+#include "Kernel/OVR_Alg.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+
+namespace VRMatterStreamTheater {
+
+// which worker, if any, the calling thread is
+static pthread_key_t	WorkerKey;
+static pthread_once_t	WorkerKeyOnce = PTHREAD_ONCE_INIT;
+
+static void CreateWorkerKey()
+{
+	pthread_key_create( &WorkerKey, NULL );
+}
+
+static double SchedulerTime()
+{
+	// same clock as vrapi_GetTimeInSeconds
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+//==============================================================
+// CancelToken
+
+CancelToken * CancelToken::Create()
+{
+	return new CancelToken();
+}
+
+void CancelToken::AddRef()
+{
+	__atomic_fetch_add( &RefCount, 1, __ATOMIC_RELAXED );
+}
+
+void CancelToken::Release()
+{
+	if ( __atomic_sub_fetch( &RefCount, 1, __ATOMIC_ACQ_REL ) == 0 )
+	{
+		delete this;
+	}
+}
+
+//==============================================================
+// BackgroundTask
+
+BackgroundTask::BackgroundTask( const TaskPriority priority, CancelToken * token ) :
+	Priority( priority ),
+	Token( token ),
+	Dropped( false )
+
+{
+	if ( Token != NULL )
+	{
+		Token->AddRef();
+	}
+}
+
+BackgroundTask::~BackgroundTask()
+{
+	if ( Token != NULL )
+	{
+		Token->Release();
+	}
+}
+
+bool BackgroundTask::IsCancelled() const
+{
+	return Dropped || ( Token != NULL && Token->IsCancelled() );
+}
+
+//==============================================================
+// TaskScheduler
+
+BackgroundTask * TaskScheduler::TaskQueue::PopFront()
+{
+	BackgroundTask * task = Tasks[Head++];
+	if ( Head == Tasks.GetSizeI() )
+	{
+		Tasks.Resize( 0 );
+		Head = 0;
+	}
+	else if ( Head >= 256 && Head * 2 >= Tasks.GetSizeI() )
+	{
+		const int count = GetCount();
+		for ( int i = 0; i < count; i++ )
+		{
+			Tasks[i] = Tasks[Head + i];
+		}
+		Tasks.Resize( count );
+		Head = 0;
+	}
+	return task;
+}
+
+BackgroundTask * TaskScheduler::TaskQueue::PopBack()
+{
+	BackgroundTask * task = Tasks[Tasks.GetSizeI() - 1];
+	Tasks.Resize( Tasks.GetSizeI() - 1 );
+	if ( Head == Tasks.GetSizeI() )
+	{
+		Tasks.Resize( 0 );
+		Head = 0;
+	}
+	return task;
+}
+
+TaskScheduler::TaskScheduler() :
+	NumWorkers( 0 ),
+	NumThreads( 0 ),
+	Closed( 0 ),
+	Running( 0 ),
+	Queued( 0 ),
+	NextQueue( 0 ),
+	Steals( 0 ),
+	Completed( 0 ),
+	PinToBigCores( false ),
+	Completions()
+
+{
+	for ( int i = 0; i < MAX_WORKERS; i++ )
+	{
+		pthread_mutex_init( &Queues[i].Lock, NULL );
+	}
+	pthread_mutex_init( &SleepLock, NULL );
+	pthread_cond_init( &WakeUp, NULL );
+	pthread_mutex_init( &CompletionLock, NULL );
+	CPU_ZERO( &BigCores );
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	Shutdown();
+
+	// submitted while it was shutting down
+	while ( RunCompletions( 1.0 ) > 0 )
+	{
+	}
+
+	for ( int i = 0; i < MAX_WORKERS; i++ )
+	{
+		pthread_mutex_destroy( &Queues[i].Lock );
+	}
+	pthread_mutex_destroy( &SleepLock );
+	pthread_cond_destroy( &WakeUp );
+	pthread_mutex_destroy( &CompletionLock );
+}
+
+// The big cores are the ones with the highest max frequency.  If that
+// can't be read every core counts.
+int TaskScheduler::FindBigCores( cpu_set_t & mask, bool & differ )
+{
+	const int numCores = Alg::Min( (int)sysconf( _SC_NPROCESSORS_CONF ), (int)CPU_SETSIZE );
+	int frequencies[CPU_SETSIZE];
+	int highest = 0;
+	for ( int i = 0; i < numCores; i++ )
+	{
+		char path[128];
+		snprintf( path, sizeof( path ), "/sys/devices/system/cpu/cpu%i/cpufreq/cpuinfo_max_freq", i );
+		frequencies[i] = 0;
+		FILE * f = fopen( path, "r" );
+		if ( f != NULL )
+		{
+			if ( fscanf( f, "%i", &frequencies[i] ) != 1 )
+			{
+				frequencies[i] = 0;
+			}
+			fclose( f );
+		}
+		highest = Alg::Max( highest, frequencies[i] );
+	}
+
+	CPU_ZERO( &mask );
+	int numBig = 0;
+	for ( int i = 0; i < numCores; i++ )
+	{
+		if ( frequencies[i] == highest )
+		{
+			CPU_SET( i, &mask );
+			numBig++;
+		}
+	}
+	differ = ( highest > 0 && numBig < numCores );
+	return Alg::Max( numBig, 1 );
+}
+
+void TaskScheduler::Start( const int numWorkers )
+{
+	if ( GetNumWorkers() > 0 )
+	{
+		return;
+	}
+	pthread_once( &WorkerKeyOnce, CreateWorkerKey );
+
+	const int bigCores = FindBigCores( BigCores, PinToBigCores );
+	const int wanted = ( numWorkers > 0 ) ? numWorkers : bigCores - 1;
+	const int count = Alg::Max( 1, Alg::Min( wanted, (int)MAX_WORKERS ) );
+
+	// the workers read NumWorkers, so it's set before any of them start.  A
+	// queue whose thread didn't start is still emptied by the others stealing.
+	__atomic_store_n( &NumWorkers, count, __ATOMIC_RELEASE );
+	__atomic_store_n( &Closed, 0, __ATOMIC_RELEASE );
+	__atomic_store_n( &Running, 1, __ATOMIC_RELEASE );
+	for ( int i = 0; i < count; i++ )
+	{
+		Workers[i].Scheduler = this;
+		Workers[i].Index = i;
+		if ( pthread_create( &Workers[i].Thread, NULL, WorkerThread, &Workers[i] ) != 0 )
+		{
+			LOG( "TaskScheduler: couldn't start worker %i", i );
+			break;
+		}
+		NumThreads++;
+	}
+	if ( NumThreads == 0 )
+	{
+		__atomic_store_n( &NumWorkers, 0, __ATOMIC_RELEASE );
+	}
+	LOG( "TaskScheduler: %i workers, %i big cores%s", NumThreads, bigCores, PinToBigCores ? ", pinned" : "" );
+}
+
+void TaskScheduler::Shutdown()
+{
+	const int numWorkers = GetNumWorkers();
+	if ( numWorkers == 0 )
+	{
+		return;
+	}
+
+	// A Submit checks Closed under its queue's lock, so once every lock
+	// has been taken after setting it, no more tasks get into the queues.
+	// The ones that don't are cancelled and finished instead.
+	__atomic_store_n( &Closed, 1, __ATOMIC_RELEASE );
+	for ( int i = 0; i < numWorkers; i++ )
+	{
+		pthread_mutex_lock( &Queues[i].Lock );
+		pthread_mutex_unlock( &Queues[i].Lock );
+	}
+
+	pthread_mutex_lock( &SleepLock );
+	__atomic_store_n( &Running, 0, __ATOMIC_RELEASE );
+	pthread_cond_broadcast( &WakeUp );
+	pthread_mutex_unlock( &SleepLock );
+
+	for ( int i = 0; i < NumThreads; i++ )
+	{
+		pthread_join( Workers[i].Thread, NULL );
+	}
+	NumThreads = 0;
+
+	// whatever never ran still gets its Finish
+	for ( int i = 0; i < numWorkers; i++ )
+	{
+		for ( int p = 0; p < TASK_PRIORITY_COUNT; p++ )
+		{
+			TaskQueue & tasks = Queues[i].Tasks[p];
+			while ( tasks.GetCount() > 0 )
+			{
+				BackgroundTask * task = tasks.PopFront();
+				task->Dropped = true;
+				Complete( task );
+			}
+		}
+	}
+	__atomic_store_n( &Queued, 0, __ATOMIC_RELAXED );
+	__atomic_store_n( &NumWorkers, 0, __ATOMIC_RELEASE );
+
+	while ( RunCompletions( 1.0 ) > 0 )
+	{
+	}
+	LOG( "TaskScheduler: %i tasks completed, %i stolen", Completed, GetSteals() );
+}
+
+void TaskScheduler::Submit( BackgroundTask * task )
+{
+	if ( __atomic_load_n( &Closed, __ATOMIC_ACQUIRE ) )
+	{
+		task->Dropped = true;
+		Complete( task );
+		return;
+	}
+
+	const int numWorkers = GetNumWorkers();
+	if ( numWorkers == 0 )
+	{
+		// not started, run it here so nothing is lost
+		if ( !task->IsCancelled() )
+		{
+			task->Run();
+		}
+		Complete( task );
+		return;
+	}
+
+	const Worker * self = (const Worker *)pthread_getspecific( WorkerKey );
+	const int index = ( self != NULL && self->Scheduler == this ) ? self->Index :
+			(int)( __atomic_fetch_add( &NextQueue, 1, __ATOMIC_RELAXED ) & 0x7FFFFFFF ) % numWorkers;
+
+	WorkerQueue & queue = Queues[index];
+	pthread_mutex_lock( &queue.Lock );
+	if ( __atomic_load_n( &Closed, __ATOMIC_ACQUIRE ) )
+	{
+		// Shutdown started since the check above
+		pthread_mutex_unlock( &queue.Lock );
+		task->Dropped = true;
+		Complete( task );
+		return;
+	}
+	queue.Tasks[task->GetPriority()].PushBack( task );
+	__atomic_fetch_add( &Queued, 1, __ATOMIC_RELEASE );
+	pthread_mutex_unlock( &queue.Lock );
+
+	// a worker checks Queued under SleepLock before it waits, so this can't be missed
+	pthread_mutex_lock( &SleepLock );
+	pthread_cond_signal( &WakeUp );
+	pthread_mutex_unlock( &SleepLock );
+}
+
+// Own queue from the front, then other queues from the back, one
+// priority at a time so a prefetch never runs ahead of a high task.
+BackgroundTask * TaskScheduler::TakeTask( const int worker )
+{
+	const int numWorkers = GetNumWorkers();
+	for ( int p = 0; p < TASK_PRIORITY_COUNT; p++ )
+	{
+		for ( int n = 0; n < numWorkers; n++ )
+		{
+			const int victim = ( worker + n ) % numWorkers;
+			WorkerQueue & queue = Queues[victim];
+			pthread_mutex_lock( &queue.Lock );
+			TaskQueue & tasks = queue.Tasks[p];
+			BackgroundTask * task = NULL;
+			if ( tasks.GetCount() > 0 )
+			{
+				task = ( n == 0 ) ? tasks.PopFront() : tasks.PopBack();
+			}
+			pthread_mutex_unlock( &queue.Lock );
+
+			if ( task != NULL )
+			{
+				if ( n != 0 )
+				{
+					__atomic_fetch_add( &Steals, 1, __ATOMIC_RELAXED );
+				}
+				__atomic_fetch_sub( &Queued, 1, __ATOMIC_ACQ_REL );
+				return task;
+			}
+		}
+	}
+	return NULL;
+}
+
+void TaskScheduler::Complete( BackgroundTask * task )
+{
+	pthread_mutex_lock( &CompletionLock );
+	Completions.PushBack( task );
+	pthread_mutex_unlock( &CompletionLock );
+}
+
+void * TaskScheduler::WorkerThread( void * param )
+{
+	Worker * worker = (Worker *)param;
+	TaskScheduler * scheduler = worker->Scheduler;
+	pthread_setspecific( WorkerKey, worker );
+
+	char name[16];
+	snprintf( name, sizeof( name ), "Worker%i", worker->Index );
+	prctl( PR_SET_NAME, (unsigned long)name, 0, 0, 0 );
+	if ( scheduler->PinToBigCores )
+	{
+		sched_setaffinity( gettid(), sizeof( scheduler->BigCores ), &scheduler->BigCores );
+	}
+
+	while ( __atomic_load_n( &scheduler->Running, __ATOMIC_ACQUIRE ) )
+	{
+		BackgroundTask * task = scheduler->TakeTask( worker->Index );
+		if ( task != NULL )
+		{
+			if ( !task->IsCancelled() )
+			{
+				task->Run();
+			}
+			scheduler->Complete( task );
+			continue;
+		}
+
+		pthread_mutex_lock( &scheduler->SleepLock );
+		while ( __atomic_load_n( &scheduler->Running, __ATOMIC_ACQUIRE ) && __atomic_load_n( &scheduler->Queued, __ATOMIC_ACQUIRE ) == 0 )
+		{
+			pthread_cond_wait( &scheduler->WakeUp, &scheduler->SleepLock );
+		}
+		pthread_mutex_unlock( &scheduler->SleepLock );
+	}
+	return NULL;
+}
+
+int TaskScheduler::RunCompletions( const double budgetSeconds )
+{
+	const double start = SchedulerTime();
+	int finished = 0;
+	for ( ; ; )
+	{
+		BackgroundTask * task = NULL;
+		pthread_mutex_lock( &CompletionLock );
+		if ( Completions.GetCount() > 0 )
+		{
+			task = Completions.PopFront();
+		}
+		pthread_mutex_unlock( &CompletionLock );
+
+		if ( task == NULL )
+		{
+			break;
+		}
+
+		task->Finish();
+		delete task;
+		finished++;
+		Completed++;
+
+		if ( SchedulerTime() - start >= budgetSeconds )
+		{
+			break;
+		}
+	}
+	return finished;
+}
+
+} // namespace VRMatterStreamTheater
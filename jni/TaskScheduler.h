@@ -0,0 +1,174 @@
+/************************************************************************************
+
+Filename    :   TaskScheduler.h
+Content     :	Work stealing worker pool with priorities, cancellation and main thread completions
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( TaskScheduler_h )
+#define TaskScheduler_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_Array.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+// lower runs first, across all the workers
+enum TaskPriority
+{
+	TASK_PRIORITY_HIGH,			// something on screen is waiting for it
+	TASK_PRIORITY_NORMAL,
+	TASK_PRIORITY_PREFETCH,		// might be wanted later
+	TASK_PRIORITY_COUNT
+};
+
+//==============================================================
+// CancelToken
+// Shared by the tasks started for one purpose, usually one view being
+// open.  Cancelling doesn't stop a task that is already running, it
+// skips the ones that haven't started and tells Finish not to bother.
+class CancelToken
+{
+public:
+	static CancelToken *	Create();
+
+	void					AddRef();
+	void					Release();
+
+	void					Cancel() { __atomic_store_n( &Cancelled, 1, __ATOMIC_RELEASE ); }
+	bool					IsCancelled() const { return __atomic_load_n( &Cancelled, __ATOMIC_ACQUIRE ) != 0; }
+
+private:
+	int						RefCount;
+	int						Cancelled;
+
+							CancelToken() : RefCount( 1 ), Cancelled( 0 ) {}
+};
+
+//==============================================================
+// BackgroundTask
+// Run happens on a worker, Finish on the main thread from
+// TaskScheduler::RunCompletions.  Finish is called for cancelled tasks
+// too, so whoever submitted the task can let go of anything it holds.
+// The scheduler deletes the task after Finish.
+class BackgroundTask
+{
+public:
+							BackgroundTask( const TaskPriority priority, CancelToken * token );
+	virtual					~BackgroundTask();
+
+	virtual void			Run() = 0;
+	virtual void			Finish() {}
+
+	TaskPriority			GetPriority() const { return Priority; }
+	bool					IsCancelled() const;
+
+private:
+	TaskPriority			Priority;
+	CancelToken *			Token;
+	bool					Dropped;		// still queued at shutdown
+
+	friend class TaskScheduler;
+};
+
+//==============================================================
+// TaskScheduler
+// Each worker has a queue per priority.  Submitting from a worker puts
+// the task on its own queue, anything else spreads them round robin.
+// A worker takes the oldest task of the best priority it can find,
+// from its own queue first, otherwise from the back of another's.
+class TaskScheduler
+{
+public:
+	static const int		MAX_WORKERS = 8;
+
+							TaskScheduler();
+							~TaskScheduler();
+
+	// numWorkers <= 0 uses one per big core, less one for the GL thread
+	void					Start( const int numWorkers );
+
+	// Waits for the running tasks; queued ones are cancelled and finished.
+	// Anything submitted from here on is cancelled too.
+	void					Shutdown();
+
+	// any thread, the scheduler owns the task from here on.  Before Start
+	// the task runs on the calling thread.
+	void					Submit( BackgroundTask * task );
+
+	// main thread.  Finishes tasks until the budget is used up, at least one.
+	int						RunCompletions( const double budgetSeconds );
+
+	int						GetNumWorkers() const { return __atomic_load_n( &NumWorkers, __ATOMIC_ACQUIRE ); }
+	int						GetQueued() const { return __atomic_load_n( &Queued, __ATOMIC_RELAXED ); }
+	int						GetCompleted() const { return Completed; }
+	int						GetSteals() const { return __atomic_load_n( &Steals, __ATOMIC_RELAXED ); }
+
+private:
+	// front is the oldest, taken by index so a long queue isn't shifted every time
+	struct TaskQueue
+	{
+		Array<BackgroundTask *>	Tasks;
+		int						Head;
+
+								TaskQueue() : Tasks(), Head( 0 ) {}
+
+		int						GetCount() const { return Tasks.GetSizeI() - Head; }
+		void					PushBack( BackgroundTask * task ) { Tasks.PushBack( task ); }
+		BackgroundTask *		PopFront();
+		BackgroundTask *		PopBack();
+	};
+
+	struct WorkerQueue
+	{
+		pthread_mutex_t			Lock;
+		TaskQueue				Tasks[TASK_PRIORITY_COUNT];
+	};
+
+	struct Worker
+	{
+		TaskScheduler *		Scheduler;
+		int					Index;
+		pthread_t			Thread;
+	};
+
+	WorkerQueue				Queues[MAX_WORKERS];
+	Worker					Workers[MAX_WORKERS];
+	int						NumWorkers;		// queues in use
+	int						NumThreads;		// of which have a thread
+	int						Closed;			// Shutdown has started, checked under the queue lock
+	int						Running;
+	int						Queued;
+	int						NextQueue;
+	int						Steals;
+	int						Completed;
+	cpu_set_t				BigCores;
+	bool					PinToBigCores;	// only when the cores differ
+
+	pthread_mutex_t			SleepLock;
+	pthread_cond_t			WakeUp;
+
+	pthread_mutex_t			CompletionLock;
+	TaskQueue				Completions;
+
+	static int				FindBigCores( cpu_set_t & mask, bool & differ );
+	static void *			WorkerThread( void * param );
+	BackgroundTask *		TakeTask( const int worker );
+	void					Complete( BackgroundTask * task );
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // TaskScheduler_h
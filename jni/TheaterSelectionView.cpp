@@ -25,6 +25,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 #include "PackageFiles.h"
 #include "CinemaStrings.h"
 #include "Native.h"
+#include "TraceRecorder.h"
 
 
 namespace VRMatterStreamTheater {
@@ -59,6 +60,7 @@ TheaterSelectionView::~TheaterSelectionView()
 void TheaterSelectionView::OneTimeInit( const char * launchIntent )
 {
 	LOG( "TheaterSelectionView::OneTimeInit" );
+	TRACE_SCOPE( "TheaterSelectionView::OneTimeInit" );
 
 	const double start = vrapi_GetTimeInSeconds();
 
@@ -360,9 +362,7 @@ void TheaterSelectionView::SelectPressed( void )
 Matrix4f TheaterSelectionView::Frame( const VrFrame & vrFrame )
 {
 	// We want 4x MSAA in the selection screen
-	ovrEyeBufferParms eyeBufferParms = Cinema.app->GetEyeBufferParms();
-	eyeBufferParms.multisamples = 4;
-	Cinema.app->SetEyeBufferParms( eyeBufferParms );
+	Cinema.SetEyeBufferCeiling( EyeBufferLevel( 4, 1024 ) );
 
 	if ( SelectionObject->IsHilighted() )
 	{
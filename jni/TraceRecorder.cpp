@@ -0,0 +1,228 @@
+/************************************************************************************
+
+Filename    :   TraceRecorder.cpp
+Content     :	Scoped timeline events, written out as a Chrome trace
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "TraceRecorder.h"
+
+#if defined( STREAMTHEATER_TRACE )
+
+#include "Android/LogUtils.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+
+namespace VRMatterStreamTheater {
+
+static const unsigned EVENT_MASK = TraceRecorder::EVENTS_PER_THREAD - 1;
+
+struct TraceRing
+{
+	TraceEvent		Events[TraceRecorder::EVENTS_PER_THREAD];
+	unsigned		Head;		// events ever written, only the owning thread stores it
+	int				ThreadId;
+	char			ThreadName[16];
+	bool			Exited;		// its thread is gone, a new thread may take the ring over
+};
+
+// Taking and handing back a ring and the dump lock this, recording doesn't
+static pthread_mutex_t	RingLock = PTHREAD_MUTEX_INITIALIZER;
+static TraceRing *		Rings[TraceRecorder::MAX_THREADS];
+static int				NumRings = 0;
+static int				NumUntraced = 0;
+static pthread_key_t	RingKey;
+static pthread_once_t	RingKeyOnce = PTHREAD_ONCE_INIT;
+
+// marks a thread that didn't get a ring, so it doesn't keep trying
+static TraceRing		NoRing;
+
+// the pthread key destructor, when a thread with a ring exits
+static void ReleaseRing( void * value )
+{
+	TraceRing * ring = (TraceRing *)value;
+	if ( ring == &NoRing )
+	{
+		return;
+	}
+	pthread_mutex_lock( &RingLock );
+	ring->Exited = true;
+	pthread_mutex_unlock( &RingLock );
+}
+
+static void CreateRingKey()
+{
+	// a thread's events stay for the dump after it exits, until a new
+	// thread needs the slot
+	pthread_key_create( &RingKey, ReleaseRing );
+}
+
+// the ring of an exited thread that went quiet first, NULL if none has exited
+static TraceRing * OldestExitedRing()
+{
+	TraceRing * oldest = NULL;
+	double oldestEnd = 0.0;
+	for ( int r = 0; r < NumRings; r++ )
+	{
+		TraceRing * ring = Rings[r];
+		if ( !ring->Exited )
+		{
+			continue;
+		}
+		const double end = ring->Head > 0 ? ring->Events[( ring->Head - 1 ) & EVENT_MASK].End : 0.0;
+		if ( oldest == NULL || end < oldestEnd )
+		{
+			oldest = ring;
+			oldestEnd = end;
+		}
+	}
+	return oldest;
+}
+
+static TraceRing * GetThreadRing()
+{
+	pthread_once( &RingKeyOnce, CreateRingKey );
+
+	TraceRing * ring = (TraceRing *)pthread_getspecific( RingKey );
+	if ( ring != NULL )
+	{
+		return ring;
+	}
+
+	pthread_mutex_lock( &RingLock );
+	if ( NumRings < TraceRecorder::MAX_THREADS )
+	{
+		ring = (TraceRing *)calloc( 1, sizeof( TraceRing ) );
+		Rings[NumRings++] = ring;
+	}
+	else
+	{
+		ring = OldestExitedRing();
+		if ( ring != NULL )
+		{
+			ring->Head = 0;
+			ring->Exited = false;
+		}
+	}
+	if ( ring == NULL )
+	{
+		const int untraced = ++NumUntraced;
+		pthread_mutex_unlock( &RingLock );
+		LOG( "TraceRecorder: all %i thread slots are in use, thread %i not traced (%i so far)",
+				TraceRecorder::MAX_THREADS, gettid(), untraced );
+		pthread_setspecific( RingKey, &NoRing );
+		return &NoRing;
+	}
+	ring->ThreadId = gettid();
+	prctl( PR_GET_NAME, (unsigned long)ring->ThreadName, 0, 0, 0 );
+	ring->ThreadName[sizeof( ring->ThreadName ) - 1] = '\0';
+	pthread_mutex_unlock( &RingLock );
+
+	pthread_setspecific( RingKey, ring );
+	return ring;
+}
+
+double TraceRecorder::GetTime()
+{
+	// same clock as vrapi_GetTimeInSeconds
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+void TraceRecorder::Record( const char * name, const double start, const double end )
+{
+	TraceRing * ring = GetThreadRing();
+	if ( ring == &NoRing )
+	{
+		return;
+	}
+
+	const unsigned head = ring->Head;
+	TraceEvent & event = ring->Events[head & EVENT_MASK];
+	event.Name = name;
+	event.Start = start;
+	event.End = end;
+	__atomic_store_n( &ring->Head, head + 1, __ATOMIC_RELEASE );
+}
+
+bool TraceRecorder::WriteChromeTrace( const char * path, const double seconds )
+{
+	const double now = GetTime();
+	const double since = now - seconds;
+
+	FILE * f = fopen( path, "w" );
+	if ( f == NULL )
+	{
+		LOG( "TraceRecorder: couldn't open %s", path );
+		return false;
+	}
+
+	TraceEvent * copy = (TraceEvent *)malloc( sizeof( TraceEvent ) * EVENTS_PER_THREAD );
+	int written = 0;
+
+	fprintf( f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+
+	// keeps the rings from being taken over while they're copied
+	pthread_mutex_lock( &RingLock );
+	for ( int r = 0; r < NumRings; r++ )
+	{
+		TraceRing * ring = Rings[r];
+
+		// copy, then drop anything the owner may have overwritten during the copy
+		const unsigned head = __atomic_load_n( &ring->Head, __ATOMIC_ACQUIRE );
+		const unsigned count = head < (unsigned)EVENTS_PER_THREAD ? head : (unsigned)EVENTS_PER_THREAD;
+		const unsigned first = head - count;
+		for ( unsigned i = 0; i < count; i++ )
+		{
+			copy[i] = ring->Events[( first + i ) & EVENT_MASK];
+		}
+		// the slot after headAfter may be mid-write as well
+		const unsigned headAfter = __atomic_load_n( &ring->Head, __ATOMIC_ACQUIRE );
+		const int reused = (int)( headAfter + 1 - first ) - EVENTS_PER_THREAD;
+		const unsigned overwritten = reused > 0 ? ( (unsigned)reused < count ? (unsigned)reused : count ) : 0;
+
+		fprintf( f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"%s\"}}",
+				written > 0 ? ",\n" : "", ring->ThreadId, ring->ThreadName );
+		written++;
+
+		for ( unsigned i = overwritten; i < count; i++ )
+		{
+			const TraceEvent & event = copy[i];
+			if ( event.End < since )
+			{
+				continue;
+			}
+			fprintf( f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%i,\"ts\":%.1f,\"dur\":%.1f}",
+					event.Name, ring->ThreadId, ( event.Start - since ) * 1e6, ( event.End - event.Start ) * 1e6 );
+			written++;
+		}
+	}
+
+	const int untraced = NumUntraced;
+	pthread_mutex_unlock( &RingLock );
+
+	fprintf( f, "\n]}\n" );
+	fclose( f );
+	free( copy );
+
+	LOG( "TraceRecorder: wrote %i events to %s, %i threads weren't traced", written, path, untraced );
+	return true;
+}
+
+} // namespace VRMatterStreamTheater
+
+#endif // STREAMTHEATER_TRACE
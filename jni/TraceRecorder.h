@@ -0,0 +1,78 @@
+/************************************************************************************
+
+Filename    :   TraceRecorder.h
+Content     :	Scoped timeline events, written out as a Chrome trace
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( TraceRecorder_h )
+#define TraceRecorder_h
+
+// Only built with STREAMTHEATER_TRACE=1 on the ndk-build command line.
+// Otherwise TRACE_SCOPE compiles to nothing.
+#if defined( STREAMTHEATER_TRACE )
+
+namespace VRMatterStreamTheater {
+
+struct TraceEvent
+{
+	const char *	Name;		// must be a string literal, only the pointer is kept
+	double			Start;
+	double			End;
+};
+
+//==============================================================
+// TraceRecorder
+// Every thread that records gets its own ring, written only by
+// that thread, so recording never takes a lock.  The dump copies
+// the rings and throws away anything overwritten while copying.
+//
+// A thread hands its ring back when it exits.  Its events stay for
+// the dump until all MAX_THREADS are taken, then the ring of the
+// exited thread that went quiet first goes to the new one.  A thread
+// that finds none free isn't traced, and that's logged.
+class TraceRecorder
+{
+public:
+	static const int	MAX_THREADS = 8;
+	static const int	EVENTS_PER_THREAD = 16384;	// power of two, about 10 seconds of frames
+
+	static double		GetTime();
+	static void			Record( const char * name, const double start, const double end );
+
+	// writes the events that ended in the last 'seconds' in Chrome trace event
+	// format, which loads in chrome://tracing and Perfetto
+	static bool			WriteChromeTrace( const char * path, const double seconds );
+};
+
+class TraceScope
+{
+public:
+					TraceScope( const char * name ) : Name( name ), Start( TraceRecorder::GetTime() ) {}
+					~TraceScope() { TraceRecorder::Record( Name, Start, TraceRecorder::GetTime() ); }
+
+private:
+	const char *	Name;
+	double			Start;
+};
+
+} // namespace VRMatterStreamTheater
+
+#define TRACE_CONCAT_( a, b )		a##b
+#define TRACE_CONCAT( a, b )		TRACE_CONCAT_( a, b )
+#define TRACE_SCOPE( name )			VRMatterStreamTheater::TraceScope TRACE_CONCAT( traceScope, __LINE__ )( name )
+
+#else
+
+#define TRACE_SCOPE( name )
+
+#endif // STREAMTHEATER_TRACE
+
+#endif // TraceRecorder_h
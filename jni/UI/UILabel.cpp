@@ -48,21 +48,34 @@ void UILabel::SetText( const char *text )
 {
 	VRMenuObject * object = GetMenuObject();
 	assert( object );
+	// setting the same text again would still regenerate the glyph geometry
+	if ( object->GetText() == text )
+	{
+		return;
+	}
 	object->SetText( text );
 }
 
 void UILabel::SetText( const String &text )
 {
-	VRMenuObject * object = GetMenuObject();
-	assert( object );
-	object->SetText( text.ToCStr() );
+	SetText( text.ToCStr() );
 }
 
 void UILabel::SetTextWordWrapped( char const * text, class BitmapFont const & font, float const widthInMeters )
 {
 	VRMenuObject * object = GetMenuObject();
 	assert( object );
+
+	// the wrapped text is set as is, the SDK only breaks the lines once
+	const UITextCache::Key key( &font, text, object->GetFontParms(), widthInMeters );
+	String wrapped;
+	if ( Cinema.TextCache.Find( key, wrapped ) )
+	{
+		object->SetText( wrapped.ToCStr() );
+		return;
+	}
 	object->SetTextWordWrapped( text, font, widthInMeters );
+	Cinema.TextCache.Insert( key, object->GetText() );
 }
 
 const String & UILabel::GetText() const
@@ -123,7 +136,16 @@ Bounds3f UILabel::GetTextLocalBounds( BitmapFont const & font ) const
 {
 	VRMenuObject * object = GetMenuObject();
 	assert( object );
-	return object->GetTextLocalBounds( font );
+
+	const UITextCache::Key key( &font, object->GetText(), object->GetFontParms() );
+
+	Bounds3f bounds;
+	if ( !Cinema.TextCache.Find( key, bounds ) )
+	{
+		bounds = object->GetTextLocalBounds( font );
+		Cinema.TextCache.Insert( key, bounds );
+	}
+	return bounds;
 }
 
 } // namespace VRMatterStreamTheater
@@ -131,21 +131,34 @@ void UITextButton::SetText( const char *text )
 {
 	VRMenuObject * object = GetMenuObject();
 	assert( object );
+	// setting the same text again would still regenerate the glyph geometry
+	if ( object->GetText() == text )
+	{
+		return;
+	}
 	object->SetText( text );
 }
 
 void UITextButton::SetText( const String &text )
 {
-	VRMenuObject * object = GetMenuObject();
-	assert( object );
-	object->SetText( text.ToCStr() );
+	SetText( text.ToCStr() );
 }
 
 void UITextButton::SetTextWordWrapped( char const * text, class BitmapFont const & font, float const widthInMeters )
 {
 	VRMenuObject * object = GetMenuObject();
 	assert( object );
+
+	// the wrapped text is set as is, the SDK only breaks the lines once
+	const UITextCache::Key key( &font, text, object->GetFontParms(), widthInMeters );
+	String wrapped;
+	if ( Cinema.TextCache.Find( key, wrapped ) )
+	{
+		object->SetText( wrapped.ToCStr() );
+		return;
+	}
 	object->SetTextWordWrapped( text, font, widthInMeters );
+	Cinema.TextCache.Insert( key, object->GetText() );
 }
 
 const String & UITextButton::GetText() const
@@ -206,7 +219,16 @@ Bounds3f UITextButton::GetTextLocalBounds( BitmapFont const & font ) const
 {
 	VRMenuObject * object = GetMenuObject();
 	assert( object );
-	return object->GetTextLocalBounds( font );
+
+	const UITextCache::Key key( &font, object->GetText(), object->GetFontParms() );
+
+	Bounds3f bounds;
+	if ( !Cinema.TextCache.Find( key, bounds ) )
+	{
+		bounds = object->GetTextLocalBounds( font );
+		Cinema.TextCache.Insert( key, bounds );
+	}
+	return bounds;
 }
 
 Vector4f const & UITextButton::GetSelectedColor() const
@@ -0,0 +1,253 @@
+/************************************************************************************
+
+Filename    :   UITextCache.cpp
+Content     :	Bounded cache of laid-out text, keyed by font, text and font parms
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#include "UI/UITextCache.h"
+
+namespace VRMatterStreamTheater {
+
+// FNV-1a
+static UInt32 HashBytes( UInt32 hash, const void * data, const int size )
+{
+	const UByte * bytes = (const UByte *)data;
+	for ( int i = 0; i < size; i++ )
+	{
+		hash = ( hash ^ bytes[i] ) * 16777619u;
+	}
+	return hash;
+}
+
+// -0 and 0 compare equal, so they have to hash the same
+static UInt32 HashFloat( const UInt32 hash, const float value )
+{
+	const float normalized = value + 0.0f;
+	return HashBytes( hash, &normalized, sizeof( normalized ) );
+}
+
+UITextCache::Key::Key() :
+	Font( NULL ),
+	Text(),
+	WrapWidth( -1.0f ),
+	Flags( 0 ),
+	ColorCenter( 0.0f ),
+	AlphaCenter( 0.0f ),
+	Scale( 1.0f ),
+	WrapScalar( 1.0f )
+
+{
+}
+
+UInt32 UITextCache::Key::GetHash() const
+{
+	UInt32 hash = 2166136261u;
+	hash = HashBytes( hash, &Font, sizeof( Font ) );
+	hash = HashBytes( hash, Text.ToCStr(), (int)Text.GetSize() );
+	hash = HashFloat( hash, WrapWidth );
+	hash = HashBytes( hash, &Flags, sizeof( Flags ) );
+	hash = HashFloat( hash, ColorCenter );
+	hash = HashFloat( hash, AlphaCenter );
+	hash = HashFloat( hash, Scale );
+	hash = HashFloat( hash, WrapScalar );
+	return hash;
+}
+
+bool UITextCache::Key::operator == ( const Key & other ) const
+{
+	return Font == other.Font && WrapWidth == other.WrapWidth && Flags == other.Flags &&
+			ColorCenter == other.ColorCenter && AlphaCenter == other.AlphaCenter &&
+			Scale == other.Scale && WrapScalar == other.WrapScalar && Text == other.Text;
+}
+
+UITextCache::UITextCache( const int maxEntries ) :
+	Entries(),
+	Buckets(),
+	MaxEntries( maxEntries > 0 ? maxEntries : 1 ),
+	Newest( -1 ),
+	Oldest( -1 ),
+	Hits( 0 ),
+	Misses( 0 )
+
+{
+	// a power of two at least twice the entries keeps the chains short
+	int numBuckets = 16;
+	while ( numBuckets < MaxEntries * 2 )
+	{
+		numBuckets *= 2;
+	}
+	Buckets.Resize( numBuckets );
+	Clear();
+}
+
+void UITextCache::Clear()
+{
+	Entries.Clear();
+	for ( int i = 0; i < Buckets.GetSizeI(); i++ )
+	{
+		Buckets[i] = -1;
+	}
+	Newest = -1;
+	Oldest = -1;
+}
+
+int UITextCache::FindEntry( const Key & key, const UInt32 hash ) const
+{
+	for ( int i = Buckets[hash & ( Buckets.GetSizeI() - 1 )]; i >= 0; i = Entries[i].NextInBucket )
+	{
+		if ( Entries[i].Hash == hash && Entries[i].EntryKey == key )
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+void UITextCache::Unlink( const int index )
+{
+	Entry & entry = Entries[index];
+	if ( entry.Newer >= 0 )
+	{
+		Entries[entry.Newer].Older = entry.Older;
+	}
+	else
+	{
+		Newest = entry.Older;
+	}
+	if ( entry.Older >= 0 )
+	{
+		Entries[entry.Older].Newer = entry.Newer;
+	}
+	else
+	{
+		Oldest = entry.Newer;
+	}
+	entry.Newer = -1;
+	entry.Older = -1;
+}
+
+void UITextCache::LinkNewest( const int index )
+{
+	Entry & entry = Entries[index];
+	entry.Newer = -1;
+	entry.Older = Newest;
+	if ( Newest >= 0 )
+	{
+		Entries[Newest].Newer = index;
+	}
+	Newest = index;
+	if ( Oldest < 0 )
+	{
+		Oldest = index;
+	}
+}
+
+void UITextCache::RemoveFromBucket( const int index )
+{
+	int * link = &Buckets[Entries[index].Hash & ( Buckets.GetSizeI() - 1 )];
+	while ( *link != index )
+	{
+		link = &Entries[*link].NextInBucket;
+	}
+	*link = Entries[index].NextInBucket;
+}
+
+// the entry of the key made the most recent, -1 if there is none
+int UITextCache::Lookup( const Key & key )
+{
+	const int index = FindEntry( key, key.GetHash() );
+	if ( index >= 0 && index != Newest )
+	{
+		Unlink( index );
+		LinkNewest( index );
+	}
+	return index;
+}
+
+// the key's entry, a new one or the least recently used one taken over
+int UITextCache::Store( const Key & key )
+{
+	const UInt32 hash = key.GetHash();
+	int index = FindEntry( key, hash );
+	if ( index >= 0 )
+	{
+		Unlink( index );
+		LinkNewest( index );
+		return index;
+	}
+
+	if ( Entries.GetSizeI() < MaxEntries )
+	{
+		index = Entries.GetSizeI();
+		Entries.Resize( index + 1 );
+	}
+	else
+	{
+		index = Oldest;
+		RemoveFromBucket( index );
+		Unlink( index );
+	}
+
+	Entry & entry = Entries[index];
+	entry.EntryKey = key;
+	entry.Hash = hash;
+	entry.HasBounds = false;
+	entry.HasWrapped = false;
+	entry.Wrapped.Clear();
+
+	int & bucket = Buckets[hash & ( Buckets.GetSizeI() - 1 )];
+	entry.NextInBucket = bucket;
+	bucket = index;
+	LinkNewest( index );
+	return index;
+}
+
+bool UITextCache::Find( const Key & key, Bounds3f & bounds )
+{
+	const int index = Lookup( key );
+	if ( index < 0 || !Entries[index].HasBounds )
+	{
+		Misses++;
+		return false;
+	}
+	bounds = Entries[index].Bounds;
+	Hits++;
+	return true;
+}
+
+bool UITextCache::Find( const Key & key, String & wrapped )
+{
+	const int index = Lookup( key );
+	if ( index < 0 || !Entries[index].HasWrapped )
+	{
+		Misses++;
+		return false;
+	}
+	wrapped = Entries[index].Wrapped;
+	Hits++;
+	return true;
+}
+
+void UITextCache::Insert( const Key & key, const Bounds3f & bounds )
+{
+	Entry & entry = Entries[Store( key )];
+	entry.Bounds = bounds;
+	entry.HasBounds = true;
+}
+
+void UITextCache::Insert( const Key & key, const String & wrapped )
+{
+	Entry & entry = Entries[Store( key )];
+	entry.Wrapped = wrapped;
+	entry.HasWrapped = true;
+}
+
+} // namespace VRMatterStreamTheater
@@ -0,0 +1,145 @@
+/************************************************************************************
+
+Filename    :   UITextCache.h
+Content     :	Bounded cache of laid-out text, keyed by font, text and font parms
+Created     :	10/19/2026
+Authors     :   Michael Grosse Huelsewiesche
+
+Copyright   :   Copyright 2015 VRMatter All Rights reserved.
+
+This source code is licensed under the GPL license found in the
+LICENSE file in the StreamTheater/ directory.
+
+*************************************************************************************/
+
+#if !defined( UITextCache_h )
+#define UITextCache_h
+
+#include "Kernel/OVR_Types.h"
+#include "Kernel/OVR_Math.h"
+#include "Kernel/OVR_String.h"
+#include "Kernel/OVR_Array.h"
+
+using namespace OVR;
+
+namespace VRMatterStreamTheater {
+
+//==============================================================
+// UITextCache
+// Keeps what the SDK worked out for a piece of text: its bounds, and for
+// word wrapped text the text with the line breaks put in.  The glyph
+// vertices themselves are built by the SDK's font surface every frame
+// and can't be kept from here.
+//
+// Entries are found through a hash table and kept on a list, most
+// recently used first, so a lookup and an eviction don't depend on how
+// many there are.
+//
+// Only depends on the kernel types so the lookup logic can be exercised without GL.
+class UITextCache
+{
+public:
+	static const int	DEFAULT_MAX_ENTRIES = 64;
+
+	struct Key
+	{
+		const void *	Font;
+		String			Text;
+		float			WrapWidth;		// meters, -1 for text that isn't word wrapped
+
+		// the fields of the SDK's VRMenuFontParms, each of them changes the layout
+		UInt32			Flags;			// FLAG_ bits for the bools
+		float			ColorCenter;
+		float			AlphaCenter;
+		float			Scale;
+		float			WrapScalar;
+
+		enum
+		{
+			FLAG_CENTER_HORIZ	= 1 << 0,
+			FLAG_CENTER_VERT	= 1 << 1,
+			FLAG_BILLBOARD		= 1 << 2,
+			FLAG_TRACK_ROLL		= 1 << 3,
+			FLAG_OUTLINE		= 1 << 4,
+			FLAG_MULTI_LINE		= 1 << 5
+		};
+
+						Key();
+
+		// Takes the parms field by field rather than as bytes, so two copies
+		// of the same parms find the same entry whatever is in their padding.
+		template< class FontParms >
+						Key( const void * font, const String & text, const FontParms & parms, const float wrapWidth = -1.0f ) :
+							Font( font ),
+							Text( text ),
+							WrapWidth( wrapWidth ),
+							Flags( ( parms.CenterHoriz ? FLAG_CENTER_HORIZ : 0 ) |
+									( parms.CenterVert ? FLAG_CENTER_VERT : 0 ) |
+									( parms.Billboard ? FLAG_BILLBOARD : 0 ) |
+									( parms.TrackRoll ? FLAG_TRACK_ROLL : 0 ) |
+									( parms.Outline ? FLAG_OUTLINE : 0 ) |
+									( parms.MultiLine ? FLAG_MULTI_LINE : 0 ) ),
+							ColorCenter( parms.ColorCenter ),
+							AlphaCenter( parms.AlphaCenter ),
+							Scale( parms.Scale ),
+							WrapScalar( parms.WrapScalar )
+
+		{
+		}
+
+		UInt32			GetHash() const;
+		bool			operator == ( const Key & other ) const;
+	};
+
+						UITextCache( const int maxEntries = DEFAULT_MAX_ENTRIES );
+
+	// true if the key has been laid out before
+	bool				Find( const Key & key, Bounds3f & bounds );
+	bool				Find( const Key & key, String & wrapped );
+
+	// stores the layout for the key, evicting the least recently used entry when full
+	void				Insert( const Key & key, const Bounds3f & bounds );
+	void				Insert( const Key & key, const String & wrapped );
+
+	void				Clear();
+
+	int					GetNumEntries() const { return Entries.GetSizeI(); }
+	int					GetMaxEntries() const { return MaxEntries; }
+	int					GetHits() const { return Hits; }
+	int					GetMisses() const { return Misses; }
+	void				ResetCounters() { Hits = 0; Misses = 0; }
+
+private:
+	struct Entry
+	{
+		Key				EntryKey;
+		UInt32			Hash;
+		bool			HasBounds;
+		Bounds3f		Bounds;
+		bool			HasWrapped;
+		String			Wrapped;
+
+		int				NextInBucket;	// -1 ends the chain
+		int				Newer;			// the list by use, -1 ends it
+		int				Older;
+	};
+
+	Array<Entry>		Entries;		// grows to MaxEntries, then the oldest is reused
+	Array<int>			Buckets;		// first entry of each chain, -1 if none
+	int					MaxEntries;
+	int					Newest;
+	int					Oldest;
+	int					Hits;
+	int					Misses;
+
+	int					FindEntry( const Key & key, const UInt32 hash ) const;
+	int					Lookup( const Key & key );
+	int					Store( const Key & key );
+	void				Unlink( const int index );
+	void				LinkNewest( const int index );
+	void				RemoveFromBucket( const int index );
+};
+
+} // namespace VRMatterStreamTheater
+
+#endif // UITextCache_h
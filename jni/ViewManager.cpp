@@ -15,6 +15,7 @@ of patent rights can be found in the PATENTS file in the same directory.
 
 #include "ViewManager.h"
 #include "App.h"
+#include "TraceRecorder.h"
 
 namespace VRMatterStreamTheater {
 
@@ -112,6 +113,8 @@ Matrix4f ViewManager::DrawEyeView( const int eye, const float fovDegrees )
 
 Matrix4f ViewManager::Frame( const VrFrame & vrFrame )
 {
+	TRACE_SCOPE( "ViewManager::Frame" );
+
 	if ( ( NextView != NULL ) && ( CurrentView != NULL ) && !ClosedCurrent )
 	{
 		LOG( "OnClose: %s", CurrentView->name );
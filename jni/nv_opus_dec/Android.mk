@@ -7,8 +7,10 @@ LOCAL_PATH := $(MY_LOCAL_PATH)
 
 include $(CLEAR_VARS)
 LOCAL_MODULE    := nv_opus_dec
-LOCAL_SRC_FILES := nv_opus_dec.c nv_opus_dec_jni.c
+LOCAL_SRC_FILES := nv_opus_dec.c nv_audio_jitter.c nv_pcm_ring.c nv_audio_sink.c \
+	nv_audio_backend_null.c nv_audio_backend_opensles.c nv_opus_dec_jni.c
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/libopus/inc
+LOCAL_LDLIBS := -llog -lOpenSLES
 
 # Link to libopus library
 LOCAL_STATIC_LIBRARIES := libopus
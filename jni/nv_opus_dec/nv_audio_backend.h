@@ -0,0 +1,43 @@
+// An audio output that pulls interleaved 16 bit PCM from a render
+// callback on its own thread. A backend embeds nv_audio_backend as its
+// first member and fills in the functions.
+#ifndef NV_AUDIO_BACKEND_H
+#define NV_AUDIO_BACKEND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// fills frames frames of pcmdata; called on the backend's audio thread
+typedef void (*nv_audio_render_fn)(void* context, short* pcmdata, int frames);
+
+typedef struct nv_audio_backend nv_audio_backend;
+struct nv_audio_backend {
+	const char* name;
+
+	// returns 0, or -1 if the output couldn't be opened
+	int (*start)(nv_audio_backend* backend, int sampleRate, int channels, int framesPerBuffer,
+				 nv_audio_render_fn render, void* context);
+
+	// render is not called any more once this returns
+	void (*stop)(nv_audio_backend* backend);
+
+	void (*destroy)(nv_audio_backend* backend);
+};
+
+// Calls render from a thread of its own, paced by the clock times
+// clockScale, so 1.001 is a device running 0.1% fast. A clockScale of 0
+// doesn't wait at all, for benchmarks. If wavPath is non-NULL everything
+// rendered is written there as a WAV file.
+nv_audio_backend* nv_audio_backend_null_create(const char* wavPath, double clockScale);
+
+#ifdef __ANDROID__
+// OpenSL ES buffer queue on the default output
+nv_audio_backend* nv_audio_backend_opensles_create(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "nv_audio_backend.h"
+
+// Plays into nothing, or a WAV file, at a clock of its own. This is how
+// the sink runs on a desktop for tests and benchmarks.
+typedef struct null_backend {
+	nv_audio_backend base;
+	char* wavPath;
+	double clockScale;
+
+	FILE* wav;
+	unsigned int wavFrames;
+	pthread_t thread;
+	int running;
+	int sampleRate;
+	int channels;
+	int framesPerBuffer;
+	nv_audio_render_fn render;
+	void* context;
+	short* buffer;
+} null_backend;
+
+#define WAV_HEADER_SIZE		44
+
+static void put_le(unsigned char* out, unsigned int value, int bytes) {
+	int i;
+	for (i = 0; i < bytes; i++) {
+		out[i] = (unsigned char)(value >> (8 * i));
+	}
+}
+
+// the sizes are patched when the file is closed
+static void write_wav_header(null_backend* backend) {
+	const unsigned int dataSize = backend->wavFrames * backend->channels * 2;
+	unsigned char header[WAV_HEADER_SIZE];
+
+	memcpy(header, "RIFF", 4);
+	put_le(header + 4, 36 + dataSize, 4);
+	memcpy(header + 8, "WAVEfmt ", 8);
+	put_le(header + 16, 16, 4);
+	put_le(header + 20, 1, 2);
+	put_le(header + 22, backend->channels, 2);
+	put_le(header + 24, backend->sampleRate, 4);
+	put_le(header + 28, backend->sampleRate * backend->channels * 2, 4);
+	put_le(header + 32, backend->channels * 2, 2);
+	put_le(header + 34, 16, 2);
+	memcpy(header + 36, "data", 4);
+	put_le(header + 40, dataSize, 4);
+
+	fseek(backend->wav, 0, SEEK_SET);
+	fwrite(header, 1, WAV_HEADER_SIZE, backend->wav);
+}
+
+static void* null_thread(void* param) {
+	null_backend* backend = (null_backend*)param;
+	const long long periodNs = backend->clockScale > 0.0 ?
+		(long long)(1e9 * backend->framesPerBuffer / (backend->sampleRate * backend->clockScale)) : 0;
+	struct timespec next;
+
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	while (__atomic_load_n(&backend->running, __ATOMIC_ACQUIRE)) {
+		backend->render(backend->context, backend->buffer, backend->framesPerBuffer);
+
+		if (backend->wav != NULL) {
+			fwrite(backend->buffer, backend->channels * sizeof(short), backend->framesPerBuffer, backend->wav);
+			backend->wavFrames += backend->framesPerBuffer;
+		}
+
+		if (periodNs > 0) {
+			next.tv_nsec += periodNs;
+			while (next.tv_nsec >= 1000000000) {
+				next.tv_nsec -= 1000000000;
+				next.tv_sec++;
+			}
+			while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) != 0) {
+			}
+		}
+	}
+	return NULL;
+}
+
+static int null_start(nv_audio_backend* base, int sampleRate, int channels, int framesPerBuffer,
+					  nv_audio_render_fn render, void* context) {
+	null_backend* backend = (null_backend*)base;
+
+	backend->sampleRate = sampleRate;
+	backend->channels = channels;
+	backend->framesPerBuffer = framesPerBuffer;
+	backend->render = render;
+	backend->context = context;
+	backend->buffer = (short*)malloc(framesPerBuffer * channels * sizeof(short));
+	if (backend->buffer == NULL) {
+		return -1;
+	}
+
+	if (backend->wavPath != NULL) {
+		backend->wav = fopen(backend->wavPath, "wb");
+		if (backend->wav == NULL) {
+			free(backend->buffer);
+			backend->buffer = NULL;
+			return -1;
+		}
+		backend->wavFrames = 0;
+		write_wav_header(backend);
+	}
+
+	backend->running = 1;
+	if (pthread_create(&backend->thread, NULL, null_thread, backend) != 0) {
+		backend->running = 0;
+		if (backend->wav != NULL) {
+			fclose(backend->wav);
+			backend->wav = NULL;
+		}
+		free(backend->buffer);
+		backend->buffer = NULL;
+		return -1;
+	}
+	return 0;
+}
+
+static void null_stop(nv_audio_backend* base) {
+	null_backend* backend = (null_backend*)base;
+
+	if (!backend->running) {
+		return;
+	}
+	__atomic_store_n(&backend->running, 0, __ATOMIC_RELEASE);
+	pthread_join(backend->thread, NULL);
+
+	if (backend->wav != NULL) {
+		write_wav_header(backend);
+		fclose(backend->wav);
+		backend->wav = NULL;
+	}
+	free(backend->buffer);
+	backend->buffer = NULL;
+}
+
+static void null_destroy(nv_audio_backend* base) {
+	null_backend* backend = (null_backend*)base;
+
+	null_stop(base);
+	free(backend->wavPath);
+	free(backend);
+}
+
+nv_audio_backend* nv_audio_backend_null_create(const char* wavPath, double clockScale) {
+	null_backend* backend = (null_backend*)calloc(1, sizeof(*backend));
+	if (backend == NULL) {
+		return NULL;
+	}
+	if (wavPath != NULL) {
+		backend->wavPath = strdup(wavPath);
+		if (backend->wavPath == NULL) {
+			free(backend);
+			return NULL;
+		}
+	}
+
+	backend->base.name = "null";
+	backend->base.start = null_start;
+	backend->base.stop = null_stop;
+	backend->base.destroy = null_destroy;
+	backend->clockScale = clockScale;
+	return &backend->base;
+}
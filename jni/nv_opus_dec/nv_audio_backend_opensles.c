@@ -0,0 +1,177 @@
+#include <stdlib.h>
+#include <string.h>
+#include <SLES/OpenSLES.h>
+#include <SLES/OpenSLES_Android.h>
+#include "nv_audio_backend.h"
+
+// An OpenSL ES player on an Android buffer queue. Each time a buffer
+// finishes the queue calls back on the audio thread, which renders the
+// next one and enqueues it, so BUFFER_COUNT buffers are all the output
+// latency there is on top of the sink's.
+#define BUFFER_COUNT	2
+
+typedef struct opensles_backend {
+	nv_audio_backend base;
+
+	SLObjectItf engineObject;
+	SLEngineItf engine;
+	SLObjectItf outputMixObject;
+	SLObjectItf playerObject;
+	SLPlayItf play;
+	SLAndroidSimpleBufferQueueItf queue;
+
+	int channels;
+	int framesPerBuffer;
+	nv_audio_render_fn render;
+	void* context;
+	short* buffers;
+	int nextBuffer;
+} opensles_backend;
+
+static SLuint32 channel_mask(int channels) {
+	switch (channels) {
+	case 1:
+		return SL_SPEAKER_FRONT_CENTER;
+	case 2:
+		return SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT;
+	case 4:
+		return SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT |
+			SL_SPEAKER_BACK_LEFT | SL_SPEAKER_BACK_RIGHT;
+	case 6:
+		return SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT | SL_SPEAKER_FRONT_CENTER |
+			SL_SPEAKER_LOW_FREQUENCY | SL_SPEAKER_BACK_LEFT | SL_SPEAKER_BACK_RIGHT;
+	default:
+		return 0;
+	}
+}
+
+static void enqueue_next(opensles_backend* backend) {
+	const int samples = backend->framesPerBuffer * backend->channels;
+	short* buffer = backend->buffers + backend->nextBuffer * samples;
+
+	backend->render(backend->context, buffer, backend->framesPerBuffer);
+	(*backend->queue)->Enqueue(backend->queue, buffer, samples * sizeof(short));
+	backend->nextBuffer = (backend->nextBuffer + 1) % BUFFER_COUNT;
+}
+
+static void queue_callback(SLAndroidSimpleBufferQueueItf queue, void* context) {
+	enqueue_next((opensles_backend*)context);
+}
+
+static void destroy_objects(opensles_backend* backend) {
+	if (backend->playerObject != NULL) {
+		(*backend->playerObject)->Destroy(backend->playerObject);
+		backend->playerObject = NULL;
+		backend->play = NULL;
+		backend->queue = NULL;
+	}
+	if (backend->outputMixObject != NULL) {
+		(*backend->outputMixObject)->Destroy(backend->outputMixObject);
+		backend->outputMixObject = NULL;
+	}
+	if (backend->engineObject != NULL) {
+		(*backend->engineObject)->Destroy(backend->engineObject);
+		backend->engineObject = NULL;
+		backend->engine = NULL;
+	}
+	free(backend->buffers);
+	backend->buffers = NULL;
+}
+
+static int opensles_start(nv_audio_backend* base, int sampleRate, int channels, int framesPerBuffer,
+						  nv_audio_render_fn render, void* context) {
+	opensles_backend* backend = (opensles_backend*)base;
+	SLDataLocator_AndroidSimpleBufferQueue queueLocator = { SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, BUFFER_COUNT };
+	SLDataFormat_PCM format;
+	SLDataSource source = { &queueLocator, &format };
+	SLDataLocator_OutputMix mixLocator = { SL_DATALOCATOR_OUTPUTMIX, NULL };
+	SLDataSink sink = { &mixLocator, NULL };
+	const SLInterfaceID ids[1] = { SL_IID_ANDROIDSIMPLEBUFFERQUEUE };
+	const SLboolean required[1] = { SL_BOOLEAN_TRUE };
+	int i;
+
+	if (channel_mask(channels) == 0) {
+		return -1;
+	}
+
+	backend->channels = channels;
+	backend->framesPerBuffer = framesPerBuffer;
+	backend->render = render;
+	backend->context = context;
+	backend->nextBuffer = 0;
+	backend->buffers = (short*)malloc(BUFFER_COUNT * framesPerBuffer * channels * sizeof(short));
+	if (backend->buffers == NULL) {
+		return -1;
+	}
+
+	format.formatType = SL_DATAFORMAT_PCM;
+	format.numChannels = channels;
+	format.samplesPerSec = sampleRate * 1000;		// milliHertz
+	format.bitsPerSample = SL_PCMSAMPLEFORMAT_FIXED_16;
+	format.containerSize = SL_PCMSAMPLEFORMAT_FIXED_16;
+	format.channelMask = channel_mask(channels);
+	format.endianness = SL_BYTEORDER_LITTLEENDIAN;
+
+	if (slCreateEngine(&backend->engineObject, 0, NULL, 0, NULL, NULL) != SL_RESULT_SUCCESS ||
+		(*backend->engineObject)->Realize(backend->engineObject, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS ||
+		(*backend->engineObject)->GetInterface(backend->engineObject, SL_IID_ENGINE, &backend->engine) != SL_RESULT_SUCCESS) {
+		destroy_objects(backend);
+		return -1;
+	}
+
+	if ((*backend->engine)->CreateOutputMix(backend->engine, &backend->outputMixObject, 0, NULL, NULL) != SL_RESULT_SUCCESS ||
+		(*backend->outputMixObject)->Realize(backend->outputMixObject, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS) {
+		destroy_objects(backend);
+		return -1;
+	}
+
+	if ((*backend->engine)->CreateAudioPlayer(backend->engine, &backend->playerObject, &source, &sink,
+											  1, ids, required) != SL_RESULT_SUCCESS ||
+		(*backend->playerObject)->Realize(backend->playerObject, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS ||
+		(*backend->playerObject)->GetInterface(backend->playerObject, SL_IID_PLAY, &backend->play) != SL_RESULT_SUCCESS ||
+		(*backend->playerObject)->GetInterface(backend->playerObject, SL_IID_ANDROIDSIMPLEBUFFERQUEUE,
+											   &backend->queue) != SL_RESULT_SUCCESS ||
+		(*backend->queue)->RegisterCallback(backend->queue, queue_callback, backend) != SL_RESULT_SUCCESS) {
+		destroy_objects(backend);
+		return -1;
+	}
+
+	// the queue only calls back for buffers it was given, so prime it
+	for (i = 0; i < BUFFER_COUNT; i++) {
+		enqueue_next(backend);
+	}
+
+	if ((*backend->play)->SetPlayState(backend->play, SL_PLAYSTATE_PLAYING) != SL_RESULT_SUCCESS) {
+		destroy_objects(backend);
+		return -1;
+	}
+	return 0;
+}
+
+static void opensles_stop(nv_audio_backend* base) {
+	opensles_backend* backend = (opensles_backend*)base;
+
+	// destroying the player waits for a callback in progress
+	if (backend->play != NULL) {
+		(*backend->play)->SetPlayState(backend->play, SL_PLAYSTATE_STOPPED);
+	}
+	destroy_objects(backend);
+}
+
+static void opensles_destroy(nv_audio_backend* base) {
+	opensles_stop(base);
+	free(base);
+}
+
+nv_audio_backend* nv_audio_backend_opensles_create(void) {
+	opensles_backend* backend = (opensles_backend*)calloc(1, sizeof(*backend));
+	if (backend == NULL) {
+		return NULL;
+	}
+
+	backend->base.name = "opensles";
+	backend->base.start = opensles_start;
+	backend->base.stop = opensles_stop;
+	backend->base.destroy = opensles_destroy;
+	return &backend->base;
+}
@@ -0,0 +1,281 @@
+#include <stdlib.h>
+#include <string.h>
+#include "nv_audio_jitter.h"
+
+// RFC 3550 smooths the jitter by 1/16 per packet, kept here times 16
+#define JITTER_SHIFT		4
+
+// frames of depth per frame of jitter, on top of the one frame that
+// lets a lost packet be rebuilt from the next one's FEC data
+#define DEPTH_PER_JITTER	3
+
+typedef struct jitter_slot {
+	int present;
+	unsigned short seq;
+	int len;
+	unsigned char data[NV_AUDIO_JITTER_MAX_PACKET];
+} jitter_slot;
+
+struct nv_audio_jitter {
+	nv_opus_decoder* decoder;
+	int frameUs;
+	int minDepth;
+	int maxDepth;
+	int trimMargin;
+
+	jitter_slot slots[NV_AUDIO_JITTER_SLOTS];
+	int started;				// a packet came since the reset
+	int playing;				// filled up to the target once
+	unsigned short nextSeq;		// the next one to play
+	unsigned short endSeq;		// one past the newest received
+	int holds;					// underruns in a row
+
+	int haveArrival;
+	unsigned short lastSeq;
+	long long lastArrivalUs;
+	long long jitter16;
+
+	nv_audio_jitter_stats stats;
+};
+
+static int seq_diff(unsigned short a, unsigned short b) {
+	return (short)(a - b);
+}
+
+static jitter_slot* slot_for(nv_audio_jitter* jb, unsigned short seq) {
+	jitter_slot* slot = &jb->slots[seq % NV_AUDIO_JITTER_SLOTS];
+	return (slot->present && slot->seq == seq) ? slot : NULL;
+}
+
+static void clear_slots(nv_audio_jitter* jb) {
+	int i;
+	for (i = 0; i < NV_AUDIO_JITTER_SLOTS; i++) {
+		jb->slots[i].present = 0;
+	}
+}
+
+nv_audio_jitter* nv_audio_jitter_create(nv_opus_decoder* decoder, int frameUs, int minDepth, int maxDepth,
+									   int trimMargin) {
+	nv_audio_jitter* jb;
+
+	if (decoder == NULL || frameUs <= 0) {
+		return NULL;
+	}
+
+	jb = (nv_audio_jitter*)calloc(1, sizeof(*jb));
+	if (jb == NULL) {
+		return NULL;
+	}
+
+	jb->decoder = decoder;
+	jb->frameUs = frameUs;
+	jb->maxDepth = maxDepth < 1 ? 1 :
+		(maxDepth > NV_AUDIO_JITTER_SLOTS / 2 ? NV_AUDIO_JITTER_SLOTS / 2 : maxDepth);
+	jb->minDepth = minDepth < 0 ? 0 : (minDepth > jb->maxDepth ? jb->maxDepth : minDepth);
+	jb->trimMargin = trimMargin < 0 ? 0 : trimMargin;
+	return jb;
+}
+
+void nv_audio_jitter_destroy(nv_audio_jitter* jb) {
+	free(jb);
+}
+
+void nv_audio_jitter_reset(nv_audio_jitter* jb) {
+	clear_slots(jb);
+	jb->started = 0;
+	jb->playing = 0;
+	jb->holds = 0;
+	jb->haveArrival = 0;
+	jb->jitter16 = 0;
+	memset(&jb->stats, 0, sizeof(jb->stats));
+}
+
+static void update_jitter(nv_audio_jitter* jb, unsigned short seq, long long arrivalUs) {
+	int frames;
+	long long d;
+
+	if (!jb->haveArrival) {
+		jb->haveArrival = 1;
+		jb->lastSeq = seq;
+		jb->lastArrivalUs = arrivalUs;
+		return;
+	}
+
+	// only packets newer than the last one say anything about the spacing
+	frames = seq_diff(seq, jb->lastSeq);
+	if (frames <= 0) {
+		return;
+	}
+
+	d = (arrivalUs - jb->lastArrivalUs) - (long long)frames * jb->frameUs;
+	if (d < 0) {
+		d = -d;
+	}
+	jb->jitter16 += d - ((jb->jitter16 + (1 << (JITTER_SHIFT - 1))) >> JITTER_SHIFT);
+	jb->lastSeq = seq;
+	jb->lastArrivalUs = arrivalUs;
+}
+
+static int target_depth(const nv_audio_jitter* jb) {
+	const long long jitterUs = jb->jitter16 >> JITTER_SHIFT;
+	int depth = 1 + (int)((DEPTH_PER_JITTER * jitterUs + jb->frameUs - 1) / jb->frameUs);
+
+	if (depth < jb->minDepth) {
+		depth = jb->minDepth;
+	}
+	if (depth > jb->maxDepth) {
+		depth = jb->maxDepth;
+	}
+	return depth;
+}
+
+int nv_audio_jitter_put(nv_audio_jitter* jb, unsigned short seq, long long arrivalUs,
+						const unsigned char* data, int len) {
+	jitter_slot* slot;
+
+	if (data == NULL || len <= 0 || len > NV_AUDIO_JITTER_MAX_PACKET) {
+		return -1;
+	}
+
+	if (!jb->started) {
+		jb->started = 1;
+		jb->nextSeq = seq;
+		jb->endSeq = seq;
+	}
+	else if (seq_diff(seq, jb->nextSeq) < 0) {
+		update_jitter(jb, seq, arrivalUs);
+		jb->stats.late++;
+		return -1;
+	}
+	else if (seq_diff(seq, jb->nextSeq) >= NV_AUDIO_JITTER_SLOTS) {
+		// too far ahead to keep what is here, start over from this one
+		clear_slots(jb);
+		jb->nextSeq = seq;
+		jb->endSeq = seq;
+		jb->playing = 0;
+		jb->holds = 0;
+		jb->stats.resyncs++;
+	}
+
+	if (slot_for(jb, seq) != NULL) {
+		jb->stats.duplicates++;
+		return -1;
+	}
+
+	slot = &jb->slots[seq % NV_AUDIO_JITTER_SLOTS];
+	slot->present = 1;
+	slot->seq = seq;
+	slot->len = len;
+	memcpy(slot->data, data, len);
+
+	if (seq_diff(seq, jb->endSeq) >= 0) {
+		jb->endSeq = seq + 1;
+	}
+	jb->stats.received++;
+	update_jitter(jb, seq, arrivalUs);
+	return 0;
+}
+
+static void advance(nv_audio_jitter* jb) {
+	jitter_slot* slot = slot_for(jb, jb->nextSeq);
+	if (slot != NULL) {
+		slot->present = 0;
+	}
+	jb->nextSeq++;
+	if (seq_diff(jb->endSeq, jb->nextSeq) < 0) {
+		jb->endSeq = jb->nextSeq;
+	}
+}
+
+static int conceal(nv_audio_jitter* jb, short* pcmdata, int* kind) {
+	jb->stats.concealed++;
+	*kind = NV_AUDIO_FRAME_CONCEALED;
+	return nv_opus_decode_plc(jb->decoder, pcmdata);
+}
+
+int nv_audio_jitter_get(nv_audio_jitter* jb, short* pcmdata, int* kind) {
+	const int samples = nv_opus_get_samples_per_channel(jb->decoder);
+	const int target = target_depth(jb);
+	int depth = jb->started ? seq_diff(jb->endSeq, jb->nextSeq) : 0;
+	int ignored;
+	jitter_slot* slot;
+	jitter_slot* next;
+	int ret;
+
+	if (kind == NULL) {
+		kind = &ignored;
+	}
+
+	if (!jb->playing) {
+		if (!jb->started || depth < target || depth == 0) {
+			memset(pcmdata, 0, samples * nv_opus_get_channel_count(jb->decoder) * sizeof(short));
+			jb->stats.silent++;
+			*kind = NV_AUDIO_FRAME_SILENCE;
+			return samples;
+		}
+		jb->playing = 1;
+	}
+
+	// too far behind: the oldest is still decoded, opus needs the history.
+	// One that is still missing after an underrun was concealed already
+	// and is given up on instead of rebuilt a frame late.
+	if (depth > target + jb->trimMargin) {
+		slot = slot_for(jb, jb->nextSeq);
+		if (slot != NULL) {
+			nv_opus_decode(jb->decoder, slot->data, slot->len, pcmdata);
+		}
+		if (slot != NULL || jb->holds > 0) {
+			jb->stats.trimmed++;
+			jb->holds = 0;
+			advance(jb);
+			depth--;
+		}
+	}
+
+	slot = slot_for(jb, jb->nextSeq);
+	if (slot != NULL) {
+		jb->holds = 0;
+		ret = nv_opus_decode(jb->decoder, slot->data, slot->len, pcmdata);
+		advance(jb);
+		if (ret < 0) {
+			return conceal(jb, pcmdata, kind);
+		}
+		jb->stats.decoded++;
+		*kind = NV_AUDIO_FRAME_DECODED;
+		return ret;
+	}
+
+	if (depth <= 0) {
+		// nothing here at all; wait for it a frame longer, unless the
+		// stream has stopped and it is time to fill up again
+		jb->stats.underruns++;
+		if (++jb->holds > jb->maxDepth) {
+			jb->playing = 0;
+			jb->holds = 0;
+		}
+		return conceal(jb, pcmdata, kind);
+	}
+
+	// lost, or so late that later packets passed it
+	jb->holds = 0;
+	next = slot_for(jb, (unsigned short)(jb->nextSeq + 1));
+	if (next != NULL && nv_opus_packet_has_fec(jb->decoder, next->data, next->len)) {
+		ret = nv_opus_decode_fec(jb->decoder, next->data, next->len, pcmdata);
+		advance(jb);
+		if (ret < 0) {
+			return conceal(jb, pcmdata, kind);
+		}
+		jb->stats.recovered++;
+		*kind = NV_AUDIO_FRAME_RECOVERED;
+		return ret;
+	}
+	advance(jb);
+	return conceal(jb, pcmdata, kind);
+}
+
+void nv_audio_jitter_get_stats(const nv_audio_jitter* jb, nv_audio_jitter_stats* stats) {
+	*stats = jb->stats;
+	stats->depth = jb->started ? seq_diff(jb->endSeq, jb->nextSeq) : 0;
+	stats->target_depth = target_depth(jb);
+	stats->jitter_us = (int)(jb->jitter16 >> JITTER_SHIFT);
+}
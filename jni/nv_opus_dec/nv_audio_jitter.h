@@ -0,0 +1,79 @@
+// Receive side of the audio stream. Packets go in as they arrive, with
+// their sequence number and arrival time, and frames come out one at a
+// time at the playout rate.
+//
+// How many frames are held back follows the inter-arrival jitter (the
+// RFC 3550 estimate). That only absorbs the jitter if frames are taken
+// out on a playout clock; a caller that gets one frame per packet put is
+// paced by the arrivals and gains nothing from a deeper target. A packet that is missing when its turn comes is
+// rebuilt from the FEC data of the packet after it if that one is here
+// already, and concealed by opus otherwise. If nothing has arrived at all
+// the frame is concealed and the missing packet gets another turn, which
+// adds a frame of delay; a delay past the target is trimmed again.
+//
+// A jitter buffer must not be used from more than one thread at a time.
+#ifndef NV_AUDIO_JITTER_H
+#define NV_AUDIO_JITTER_H
+
+#include "nv_opus_dec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NV_AUDIO_JITTER_SLOTS		32		// packets it can hold
+#define NV_AUDIO_JITTER_MAX_PACKET	1500
+
+// what nv_audio_jitter_get played
+#define NV_AUDIO_FRAME_SILENCE		0		// still filling up
+#define NV_AUDIO_FRAME_DECODED		1
+#define NV_AUDIO_FRAME_RECOVERED	2		// rebuilt from FEC data
+#define NV_AUDIO_FRAME_CONCEALED	3		// packet loss concealment
+
+typedef struct nv_audio_jitter_stats {
+	unsigned int received;
+	unsigned int late;			// arrived after their turn, dropped
+	unsigned int duplicates;
+	unsigned int resyncs;		// the sequence jumped too far, started over
+	unsigned int decoded;
+	unsigned int recovered;
+	unsigned int concealed;		// includes the underruns
+	unsigned int underruns;		// nothing had arrived, each one is a frame of delay
+	unsigned int trimmed;		// decoded and thrown away to bring the delay down
+	unsigned int silent;
+	int depth;					// frames held now
+	int target_depth;
+	int jitter_us;
+} nv_audio_jitter_stats;
+
+typedef struct nv_audio_jitter nv_audio_jitter;
+
+// frameUs is the duration of one packet. The target depth is kept between
+// minDepth and maxDepth frames, maxDepth at most NV_AUDIO_JITTER_SLOTS / 2.
+// The delay is trimmed once it is more than trimMargin frames past the
+// target; a caller that puts one packet before every get must pass 0, as
+// the depth it builds up otherwise never goes away.
+// The decoder stays the caller's.
+nv_audio_jitter* nv_audio_jitter_create(nv_opus_decoder* decoder, int frameUs, int minDepth, int maxDepth,
+										int trimMargin);
+void nv_audio_jitter_destroy(nv_audio_jitter* jb);
+
+// forgets all packets and the jitter estimate, e.g. after a reconnect
+void nv_audio_jitter_reset(nv_audio_jitter* jb);
+
+// returns 0 if the packet was kept, -1 if it was late, a duplicate or too big
+int nv_audio_jitter_put(nv_audio_jitter* jb, unsigned short seq, long long arrivalUs,
+						const unsigned char* data, int len);
+
+// plays the next frame into pcmdata, samples per channel * channels shorts
+// returns the number of samples per channel, or a negative opus error;
+// kind is set to one of NV_AUDIO_FRAME_* if it is non-NULL
+int nv_audio_jitter_get(nv_audio_jitter* jb, short* pcmdata, int* kind);
+
+void nv_audio_jitter_get_stats(const nv_audio_jitter* jb, nv_audio_jitter_stats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,247 @@
+#include <stdlib.h>
+#include <string.h>
+#include "nv_audio_sink.h"
+#include "nv_pcm_ring.h"
+
+#define MAX_DRIFT_PPM		5000		// 0.5%, a pitch change nobody hears
+#define DRIFT_GAIN_PPM		20000		// per relative level error, so 25% off is the most
+#define LEVEL_SMOOTHING		0.02f		// per callback, about a second at 200 callbacks/s
+#define SKIP_FACTOR			3			// past this many times the target the excess is skipped
+#define RING_FACTOR			4			// ring size in target latencies
+
+struct nv_audio_sink {
+	nv_audio_backend* backend;
+	nv_pcm_ring* ring;
+	int sampleRate;
+	int channels;
+	int framesPerBuffer;
+	int targetLevel;
+	int running;
+
+	// audio thread only. input holds the frames the resampler still needs,
+	// position is the next output's place between input[0] and input[1].
+	int priming;
+	float averageLevel;
+	double position;
+	short* input;
+	int inputFrames;
+	int inputCapacity;
+
+	// the stats; overruns come from both sides
+	unsigned int callbacks;
+	unsigned int underruns;
+	unsigned int underrunFrames;
+	unsigned int overruns;
+	unsigned int overrunFrames;
+	int ratioPpm;
+};
+
+nv_audio_sink* nv_audio_sink_create(nv_audio_backend* backend, int sampleRate, int channels,
+									int framesPerBuffer, int targetLatencyMs) {
+	nv_audio_sink* sink;
+	int capacity;
+
+	if (backend == NULL) {
+		return NULL;
+	}
+	if (sampleRate <= 0 || channels <= 0 || framesPerBuffer <= 0 ||
+		(sink = (nv_audio_sink*)calloc(1, sizeof(*sink))) == NULL) {
+		backend->destroy(backend);
+		return NULL;
+	}
+
+	sink->backend = backend;
+	sink->sampleRate = sampleRate;
+	sink->channels = channels;
+	sink->framesPerBuffer = framesPerBuffer;
+	sink->targetLevel = (int)((long long)targetLatencyMs * sampleRate / 1000);
+	if (sink->targetLevel < framesPerBuffer) {
+		sink->targetLevel = framesPerBuffer;
+	}
+
+	// a callback at the fastest ratio reads a little more than a buffer, plus
+	// the two frames it interpolates between
+	sink->inputCapacity = framesPerBuffer + framesPerBuffer * MAX_DRIFT_PPM / 1000000 + 4;
+	sink->input = (short*)malloc(sink->inputCapacity * channels * sizeof(short));
+
+	capacity = sink->targetLevel * RING_FACTOR;
+	if (capacity < sink->targetLevel + 8 * framesPerBuffer) {
+		capacity = sink->targetLevel + 8 * framesPerBuffer;
+	}
+	sink->ring = nv_pcm_ring_create(channels, capacity);
+
+	if (sink->input == NULL || sink->ring == NULL) {
+		nv_audio_sink_destroy(sink);
+		return NULL;
+	}
+	return sink;
+}
+
+void nv_audio_sink_destroy(nv_audio_sink* sink) {
+	if (sink == NULL) {
+		return;
+	}
+	nv_audio_sink_stop(sink);
+	sink->backend->destroy(sink->backend);
+	nv_pcm_ring_destroy(sink->ring);
+	free(sink->input);
+	free(sink);
+}
+
+static void count_overrun(nv_audio_sink* sink, int frames) {
+	__atomic_fetch_add(&sink->overruns, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&sink->overrunFrames, frames, __ATOMIC_RELAXED);
+}
+
+// plays what is left without resampling, then silence, and fills up again
+static void underrun(nv_audio_sink* sink, short* pcmdata, int frames) {
+	const int channels = sink->channels;
+	int have = sink->inputFrames < frames ? sink->inputFrames : frames;
+
+	memcpy(pcmdata, sink->input, have * channels * sizeof(short));
+	have += nv_pcm_ring_read(sink->ring, pcmdata + have * channels, frames - have);
+	memset(pcmdata + have * channels, 0, (frames - have) * channels * sizeof(short));
+
+	sink->inputFrames = 0;
+	sink->position = 0.0;
+	sink->priming = 1;
+	__atomic_store_n(&sink->underruns, sink->underruns + 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&sink->underrunFrames, sink->underrunFrames + (frames - have), __ATOMIC_RELAXED);
+}
+
+// Linear interpolation at ratio input frames per output frame
+static void resample(nv_audio_sink* sink, short* pcmdata, int frames, double ratio) {
+	const int channels = sink->channels;
+	const double last = sink->position + (frames - 1) * ratio;
+	const int needed = (int)last + 2;
+	double end;
+	int consumed;
+	int k;
+	int c;
+
+	if (needed > sink->inputFrames) {
+		const int want = needed - sink->inputFrames;
+		const int got = nv_pcm_ring_read(sink->ring, sink->input + sink->inputFrames * channels, want);
+		sink->inputFrames += got;
+		if (got < want) {
+			underrun(sink, pcmdata, frames);
+			return;
+		}
+	}
+
+	for (k = 0; k < frames; k++) {
+		const double p = sink->position + k * ratio;
+		const int i = (int)p;
+		const float t = (float)(p - i);
+		const short* a = sink->input + i * channels;
+		const short* b = a + channels;
+		for (c = 0; c < channels; c++) {
+			pcmdata[k * channels + c] = (short)(a[c] + (b[c] - a[c]) * t);
+		}
+	}
+
+	// keep what the next output still falls between
+	end = sink->position + frames * ratio;
+	consumed = (int)end;
+	if (consumed > sink->inputFrames) {
+		consumed = sink->inputFrames;
+	}
+	sink->inputFrames -= consumed;
+	memmove(sink->input, sink->input + consumed * channels, sink->inputFrames * channels * sizeof(short));
+	sink->position = end - consumed;
+}
+
+static void render(void* context, short* pcmdata, int frames) {
+	nv_audio_sink* sink = (nv_audio_sink*)context;
+	const int target = sink->targetLevel;
+	int level = nv_pcm_ring_get_level(sink->ring);
+	float error;
+	int ppm;
+
+	__atomic_store_n(&sink->callbacks, sink->callbacks + 1, __ATOMIC_RELAXED);
+
+	if (sink->priming) {
+		if (level < target) {
+			memset(pcmdata, 0, frames * sink->channels * sizeof(short));
+			return;
+		}
+		sink->priming = 0;
+		sink->averageLevel = (float)level;
+	}
+
+	if (level > target * SKIP_FACTOR) {
+		const int skipped = nv_pcm_ring_skip(sink->ring, level - target);
+		count_overrun(sink, skipped);
+		level -= skipped;
+		sink->averageLevel = (float)level;
+	}
+
+	sink->averageLevel += (level - sink->averageLevel) * LEVEL_SMOOTHING;
+	error = (sink->averageLevel - target) / target;
+	ppm = (int)(error * DRIFT_GAIN_PPM);
+	if (ppm > MAX_DRIFT_PPM) {
+		ppm = MAX_DRIFT_PPM;
+	}
+	if (ppm < -MAX_DRIFT_PPM) {
+		ppm = -MAX_DRIFT_PPM;
+	}
+	__atomic_store_n(&sink->ratioPpm, ppm, __ATOMIC_RELAXED);
+
+	// in buffer sized pieces, the input only has room for one
+	while (frames > 0) {
+		const int chunk = frames < sink->framesPerBuffer ? frames : sink->framesPerBuffer;
+		resample(sink, pcmdata, chunk, 1.0 + ppm * 1e-6);
+		if (sink->priming) {
+			memset(pcmdata + chunk * sink->channels, 0, (frames - chunk) * sink->channels * sizeof(short));
+			return;
+		}
+		pcmdata += chunk * sink->channels;
+		frames -= chunk;
+	}
+}
+
+int nv_audio_sink_start(nv_audio_sink* sink) {
+	if (sink->running) {
+		return 0;
+	}
+
+	// the audio thread isn't running, so this side can act as the consumer
+	nv_pcm_ring_skip(sink->ring, nv_pcm_ring_get_level(sink->ring));
+	sink->priming = 1;
+	sink->inputFrames = 0;
+	sink->position = 0.0;
+
+	if (sink->backend->start(sink->backend, sink->sampleRate, sink->channels, sink->framesPerBuffer,
+							 render, sink) != 0) {
+		return -1;
+	}
+	sink->running = 1;
+	return 0;
+}
+
+void nv_audio_sink_stop(nv_audio_sink* sink) {
+	if (!sink->running) {
+		return;
+	}
+	sink->backend->stop(sink->backend);
+	sink->running = 0;
+}
+
+int nv_audio_sink_write(nv_audio_sink* sink, const short* pcmdata, int frames) {
+	const int written = nv_pcm_ring_write(sink->ring, pcmdata, frames);
+	if (written < frames) {
+		count_overrun(sink, frames - written);
+	}
+	return written;
+}
+
+void nv_audio_sink_get_stats(const nv_audio_sink* sink, nv_audio_sink_stats* stats) {
+	stats->callbacks = __atomic_load_n(&sink->callbacks, __ATOMIC_RELAXED);
+	stats->underruns = __atomic_load_n(&sink->underruns, __ATOMIC_RELAXED);
+	stats->underrun_frames = __atomic_load_n(&sink->underrunFrames, __ATOMIC_RELAXED);
+	stats->overruns = __atomic_load_n(&sink->overruns, __ATOMIC_RELAXED);
+	stats->overrun_frames = __atomic_load_n(&sink->overrunFrames, __ATOMIC_RELAXED);
+	stats->level = nv_pcm_ring_get_level(sink->ring);
+	stats->target_level = sink->targetLevel;
+	stats->ratio_ppm = __atomic_load_n(&sink->ratioPpm, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,52 @@
+// Decoded frames go into a lock-free ring on the decode thread, and an
+// audio backend's callback takes them out.
+//
+// The callback starts once the ring holds the target latency, and fills
+// up to it again after an underrun. The ring level is averaged over the
+// callbacks; when it wanders off the target, because the device clock
+// and the host's are a little apart, the frames are resampled up to
+// MAX_DRIFT faster or slower to bring it back. Way past the target the
+// excess is skipped instead.
+#ifndef NV_AUDIO_SINK_H
+#define NV_AUDIO_SINK_H
+
+#include "nv_audio_backend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct nv_audio_sink_stats {
+	unsigned int callbacks;
+	unsigned int underruns;			// callbacks that ran dry
+	unsigned int underrun_frames;	// silence played for them
+	unsigned int overruns;			// writes that didn't fit, or were skipped
+	unsigned int overrun_frames;
+	int level;						// frames in the ring
+	int target_level;
+	int ratio_ppm;					// input frames read per output frame, minus one, in millionths
+} nv_audio_sink_stats;
+
+typedef struct nv_audio_sink nv_audio_sink;
+
+// Takes the backend, also when it fails. framesPerBuffer is the backend's
+// callback size, usually the decoder's frame size.
+nv_audio_sink* nv_audio_sink_create(nv_audio_backend* backend, int sampleRate, int channels,
+									int framesPerBuffer, int targetLatencyMs);
+void nv_audio_sink_destroy(nv_audio_sink* sink);
+
+// returns 0, or -1 if the backend couldn't start
+int nv_audio_sink_start(nv_audio_sink* sink);
+void nv_audio_sink_stop(nv_audio_sink* sink);
+
+// decode thread only; returns the number of frames that fit
+int nv_audio_sink_write(nv_audio_sink* sink, const short* pcmdata, int frames);
+
+// any thread
+void nv_audio_sink_get_stats(const nv_audio_sink* sink, nv_audio_sink_stats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,41 +2,222 @@
 #include <opus_multistream.h>
 #include "nv_opus_dec.h"
 
-OpusMSDecoder* decoder;
+struct nv_opus_decoder {
+	OpusMSDecoder* decoder;
+	int channelCount;
+	int streams;
+	int samplesPerChannel;
+};
 
-// This function must be called before
-// any other decoding functions
-int nv_opus_init(int sampleRate, int channelCount, int streams,
-				 int coupledStreams, const unsigned char *mapping) {
+nv_opus_decoder* nv_opus_create(int sampleRate, int channelCount, int streams,
+								int coupledStreams, const unsigned char *mapping,
+								int samplesPerChannel, int *error) {
+	nv_opus_decoder* ctx;
 	int err;
-	decoder = opus_multistream_decoder_create(
+
+	ctx = (nv_opus_decoder*)calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		if (error != NULL) {
+			*error = OPUS_ALLOC_FAIL;
+		}
+		return NULL;
+	}
+
+	ctx->decoder = opus_multistream_decoder_create(
 			sampleRate,
 			channelCount,
 			streams,
 			coupledStreams,
 			mapping,
 			&err);
-	return err;
+	if (error != NULL) {
+		*error = err;
+	}
+	if (ctx->decoder == NULL) {
+		free(ctx);
+		return NULL;
+	}
+
+	ctx->channelCount = channelCount;
+	ctx->streams = streams;
+	ctx->samplesPerChannel = samplesPerChannel;
+	return ctx;
 }
 
-// This function must be called after
-// decoding is finished
-void nv_opus_destroy(void) {
-	if (decoder != NULL) {
-		opus_multistream_decoder_destroy(decoder);
+void nv_opus_destroy(nv_opus_decoder* ctx) {
+	if (ctx == NULL) {
+		return;
 	}
+	if (ctx->decoder != NULL) {
+		opus_multistream_decoder_destroy(ctx->decoder);
+	}
+	free(ctx);
 }
 
-// packets must be decoded in order
-// a packet loss must call this function with NULL indata and 0 inlen
-// returns the number of decoded samples
-int nv_opus_decode(unsigned char* indata, int inlen, short* outpcmdata, int framesize) {
-	int err;
+int nv_opus_reset(nv_opus_decoder* ctx) {
+	if (ctx == NULL) {
+		return OPUS_BAD_ARG;
+	}
+	return opus_multistream_decoder_ctl(ctx->decoder, OPUS_RESET_STATE);
+}
 
+int nv_opus_decode(nv_opus_decoder* ctx, const unsigned char* indata, int inlen, short* outpcmdata) {
 	// Decoding to 16-bit PCM with FEC off
-	// Maximum length assuming 48KHz sample rate
-	err = opus_multistream_decode(decoder, indata, inlen,
-		outpcmdata, framesize, 0);
+	return opus_multistream_decode(ctx->decoder, indata, inlen,
+		outpcmdata, ctx->samplesPerChannel, 0);
+}
+
+int nv_opus_decode_plc(nv_opus_decoder* ctx, short* outpcmdata) {
+	// A NULL packet makes opus extrapolate from the previous frames
+	return opus_multistream_decode(ctx->decoder, NULL, 0,
+		outpcmdata, ctx->samplesPerChannel, 0);
+}
+
+int nv_opus_decode_fec(nv_opus_decoder* ctx, const unsigned char* nextdata, int nextlen, short* outpcmdata) {
+	// decode_fec = 1 decodes the redundant copy of the previous frame. The
+	// frame size has to be exactly the lost duration.
+	return opus_multistream_decode(ctx->decoder, nextdata, nextlen,
+		outpcmdata, ctx->samplesPerChannel, 1);
+}
+
+// a frame length as RFC 6716 3.2.1 codes it, returns the bytes it took
+static int parse_size(const unsigned char* data, int len, int* size) {
+	if (len < 1) {
+		return -1;
+	}
+	if (data[0] < 252) {
+		*size = data[0];
+		return 1;
+	}
+	if (len < 2) {
+		return -1;
+	}
+	*size = 4 * data[1] + data[0];
+	return 2;
+}
+
+// Finds the first frame of an opus packet (RFC 6716 3.2). All but the
+// last stream of a multistream packet are self-delimiting (appendix B),
+// which puts one more length in front of the frames.
+static int first_frame(const unsigned char* data, int len, int selfDelimited,
+					   const unsigned char** frame, int* size) {
+	int count = 1;
+	int cbr = 1;
+	int padding = 0;
+	int n, p, i, skipped;
+	const int code = data[0] & 0x3;
+
+	data++;
+	len--;
+	*size = -1;
+
+	if (code == 1) {
+		count = 2;
+	}
+	else if (code == 2) {
+		count = 2;
+		cbr = 0;
+		if ((n = parse_size(data, len, size)) < 0) {
+			return -1;
+		}
+		data += n;
+		len -= n;
+	}
+	else if (code == 3) {
+		if (len < 1) {
+			return -1;
+		}
+		count = data[0] & 0x3f;
+		cbr = !(data[0] & 0x80);
+		p = data[0] & 0x40;
+		data++;
+		len--;
+		if (count == 0) {
+			return -1;
+		}
+		while (p) {
+			if (len < 1) {
+				return -1;
+			}
+			p = data[0] == 255;
+			padding += p ? 254 : data[0];
+			data++;
+			len--;
+		}
+		len -= padding;
+		if (!cbr) {
+			// lengths of all frames but the last, the first one is ours
+			for (i = 0; i < count - 1; i++) {
+				if ((n = parse_size(data, len, &skipped)) < 0) {
+					return -1;
+				}
+				if (i == 0) {
+					*size = skipped;
+				}
+				data += n;
+				len -= n;
+			}
+		}
+	}
+
+	if (selfDelimited) {
+		// the length of the last frame, which is every frame if they're CBR
+		if ((n = parse_size(data, len, &skipped)) < 0) {
+			return -1;
+		}
+		data += n;
+		len -= n;
+		if (cbr || count == 1) {
+			*size = skipped;
+		}
+	}
+	else if (cbr) {
+		*size = len / count;
+	}
+	else if (count == 1) {
+		*size = len;
+	}
+
+	if (len < 0 || *size < 0 || *size > len) {
+		return -1;
+	}
+	*frame = data;
+	return 0;
+}
+
+int nv_opus_packet_has_fec(const nv_opus_decoder* ctx, const unsigned char* data, int len) {
+	const unsigned char* frame;
+	int size, silkFrames, lbrr;
+
+	// the first stream's TOC byte leads a multistream packet. Configs 0-11
+	// are SILK only and 12-15 hybrid; a CELT only frame has no SILK layer
+	// and so never any FEC data.
+	if (ctx == NULL || data == NULL || len < 1 || (data[0] >> 3) >= 16) {
+		return 0;
+	}
+	if (first_frame(data, len, ctx->streams > 1, &frame, &size) < 0 || size == 0) {
+		return 0;
+	}
+
+	// The SILK layer starts with a VAD flag per 20 ms SILK frame and then
+	// the LBRR flag, for the mid channel and then the side, each coded as
+	// a single raw bit at the top of the first byte (as libopus'
+	// opus_packet_has_lbrr reads them).
+	silkFrames = opus_packet_get_samples_per_frame(data, 48000) / 960;
+	if (silkFrames < 1) {
+		silkFrames = 1;
+	}
+	lbrr = (frame[0] >> (7 - silkFrames)) & 0x1;
+	if (opus_packet_get_nb_channels(data) == 2) {
+		lbrr = lbrr || ((frame[0] >> (6 - 2 * silkFrames)) & 0x1);
+	}
+	return lbrr;
+}
+
+int nv_opus_get_channel_count(const nv_opus_decoder* ctx) {
+	return ctx->channelCount;
+}
 
-	return err;
+int nv_opus_get_samples_per_channel(const nv_opus_decoder* ctx) {
+	return ctx->samplesPerChannel;
 }
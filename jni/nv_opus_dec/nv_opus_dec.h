@@ -1,4 +1,50 @@
-int nv_opus_init(int sampleRate, int channelCount, int streams,
-                 int coupledStreams, const unsigned char *mapping);
-void nv_opus_destroy(void);
-int nv_opus_decode(unsigned char* indata, int inlen, short* outpcmdata, int framesize);
+#ifndef NV_OPUS_DEC_H
+#define NV_OPUS_DEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Decoder state lives in an nv_opus_decoder owned by the caller, so any
+// number of streams can be decoded at once (one context per stream).
+// A single context must not be used from more than one thread at a time.
+typedef struct nv_opus_decoder nv_opus_decoder;
+
+// Returns NULL on failure, with the opus error code in *error if it is non-NULL.
+// samplesPerChannel is the frame size handed to every decode call
+nv_opus_decoder* nv_opus_create(int sampleRate, int channelCount, int streams,
+                                int coupledStreams, const unsigned char *mapping,
+                                int samplesPerChannel, int *error);
+void nv_opus_destroy(nv_opus_decoder* ctx);
+
+// Returns the decoder to its freshly created state, e.g. after a reconnect.
+// OPUS_BAD_ARG without a context.
+int nv_opus_reset(nv_opus_decoder* ctx);
+
+// packets must be decoded in order
+// returns the number of decoded samples per channel, or a negative opus error
+int nv_opus_decode(nv_opus_decoder* ctx, const unsigned char* indata, int inlen, short* outpcmdata);
+
+// conceals one lost packet (packet loss concealment)
+// returns the number of samples per channel generated
+int nv_opus_decode_plc(nv_opus_decoder* ctx, short* outpcmdata);
+
+// rebuilds the lost packet before nextdata from the redundant copy the
+// encoder put into nextdata (forward error correction); nextdata itself
+// still has to be decoded afterwards
+// returns the number of samples per channel generated
+int nv_opus_decode_fec(nv_opus_decoder* ctx, const unsigned char* nextdata, int nextlen, short* outpcmdata);
+
+// non-zero if the encoder put FEC data for the packet before into this
+// one, going by the LBRR flag of its first stream. Only the SILK and
+// hybrid modes can carry any, a CELT only stream has none.
+int nv_opus_packet_has_fec(const nv_opus_decoder* ctx, const unsigned char* data, int len);
+
+int nv_opus_get_channel_count(const nv_opus_decoder* ctx);
+int nv_opus_get_samples_per_channel(const nv_opus_decoder* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,10 +1,94 @@
 #include "nv_opus_dec.h"
+#include "nv_audio_jitter.h"
+#include "nv_audio_sink.h"
 
 #include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
 #include <jni.h>
+#include <android/log.h>
 
-static int SamplesPerChannel;
-static int ChannelCount;
+// The Java side only ever has one decoder, so the JNI glue keeps a single
+// context. All of the decoder state itself lives in that context.
+static nv_opus_decoder* Decoder;
+
+// Every decode call hands one sequence number to the jitter buffer, with
+// or without its packet, and takes one frame back out. That is paced by
+// the packets arriving, not by a playout clock, so the buffer can't
+// absorb any jitter here and its target is held at one frame: a packet
+// is played as soon as it is put, and a lost one is concealed. Smoothing
+// out the arrival is left to the AudioTrack's or the native sink's
+// buffering; the jitter estimate is only logged. Nothing but a trim takes
+// back the frame an underrun adds, so anything past the target is
+// trimmed right away.
+static nv_audio_jitter* Jitter;
+static unsigned short NextSeq;
+
+#define JITTER_DEPTH		1
+#define JITTER_TRIM_MARGIN	0
+
+// Packets are copied out of the Java array and frames decoded into
+// DecodePcm, so no Java array is ever pinned and the collector never
+// waits on a decode. Opus packets are a few hundred bytes.
+static unsigned char InputPacket[NV_AUDIO_JITTER_MAX_PACKET];
+static short* DecodePcm;
+
+// When the Java renderer starts the native sink, every decoded frame goes
+// into its ring and is played from the audio callback, not through an
+// AudioTrack. Java then drops what decode hands back, so the Java array
+// isn't touched at all. The lock is only held to hand a frame to the sink
+// and to swap the sink, never while the OpenSL objects are created or
+// destroyed; the decode thread is the sink's only writer.
+static nv_audio_sink* Sink;
+static pthread_mutex_t SinkLock = PTHREAD_MUTEX_INITIALIZER;
+
+static long long now_us(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void destroy_decoder(void) {
+	nv_audio_jitter_stats stats;
+
+	if (Jitter != NULL) {
+		nv_audio_jitter_get_stats(Jitter, &stats);
+		__android_log_print(ANDROID_LOG_INFO, "nv_opus_dec",
+			"audio: %u received, %u late, %u decoded, %u recovered by FEC, %u concealed (%u underruns), %u trimmed, jitter %i us",
+			stats.received, stats.late, stats.decoded, stats.recovered, stats.concealed,
+			stats.underruns, stats.trimmed, stats.jitter_us);
+		nv_audio_jitter_destroy(Jitter);
+		Jitter = NULL;
+	}
+	nv_opus_destroy(Decoder);
+	Decoder = NULL;
+	free(DecodePcm);
+	DecodePcm = NULL;
+}
+
+// Whether the sink takes the frame is decided once, under the lock, so
+// a start or stop in between can't lose it: it goes either to the sink or
+// back to Java. Returns non-zero if the sink took it.
+static int write_to_sink(const short* pcm, int frames) {
+	int written;
+
+	pthread_mutex_lock(&SinkLock);
+	written = Sink != NULL;
+	if (written) {
+		nv_audio_sink_write(Sink, pcm, frames);
+	}
+	pthread_mutex_unlock(&SinkLock);
+	return written;
+}
+
+// a NULL input is a lost packet
+static int decode_next(const unsigned char* input, int inlen, short* pcm) {
+	if (input != NULL) {
+		nv_audio_jitter_put(Jitter, NextSeq, now_us(), input, inlen);
+	}
+	NextSeq++;
+	return nv_audio_jitter_get(Jitter, pcm, NULL);
+}
 
 // This function must be called before
 // any other decoding functions
@@ -15,13 +99,25 @@ Java_com_limelight_nvstream_av_audio_OpusDecoder_init(JNIEnv *env, jobject this,
 	jbyte* jni_mapping_data;
 	jint ret;
 
-	SamplesPerChannel = samplesPerChannel;
-	ChannelCount = channelCount;
+	// a reconnect may init again without destroying first
+	destroy_decoder();
 
 	jni_mapping_data = (*env)->GetByteArrayElements(env, mapping, 0);
-	ret =  nv_opus_init(sampleRate, channelCount, streams, coupledStreams, jni_mapping_data);
+	Decoder = nv_opus_create(sampleRate, channelCount, streams, coupledStreams,
+							 (const unsigned char*)jni_mapping_data, samplesPerChannel, &ret);
 	(*env)->ReleaseByteArrayElements(env, mapping, jni_mapping_data, JNI_ABORT);
 
+	if (Decoder != NULL) {
+		Jitter = nv_audio_jitter_create(Decoder, (int)((long long)samplesPerChannel * 1000000 / sampleRate),
+										JITTER_DEPTH, JITTER_DEPTH, JITTER_TRIM_MARGIN);
+		DecodePcm = (short*)malloc(samplesPerChannel * channelCount * sizeof(short));
+		if (Jitter == NULL || DecodePcm == NULL) {
+			destroy_decoder();
+			return -1;
+		}
+		NextSeq = 0;
+	}
+
 	return ret;
 }
 
@@ -29,12 +125,12 @@ Java_com_limelight_nvstream_av_audio_OpusDecoder_init(JNIEnv *env, jobject this,
 // decoding is finished
 JNIEXPORT void JNICALL
 Java_com_limelight_nvstream_av_audio_OpusDecoder_destroy(JNIEnv *env, jobject this) {
-	nv_opus_destroy();
+	destroy_decoder();
 }
 
 // packets must be decoded in order
 // a packet loss must call this function with NULL indata and 0 inlen
-// returns the number of decoded bytes
+// returns the number of decoded bytes, which may be a frame behind the input
 JNIEXPORT jint JNICALL
 Java_com_limelight_nvstream_av_audio_OpusDecoder_decode(
 	JNIEnv *env, jobject this, // JNI parameters
@@ -42,28 +138,126 @@ Java_com_limelight_nvstream_av_audio_OpusDecoder_decode(
 	jbyteArray outpcmdata) // Output parameter
 {
 	jint ret;
-	jbyte* jni_input_data;
-	jbyte* jni_pcm_data;
+	jint bytes;
 
-	jni_pcm_data = (*env)->GetByteArrayElements(env, outpcmdata, 0);
-	if (indata != NULL) {
-		jni_input_data = (*env)->GetByteArrayElements(env, indata, 0);
+	if (Decoder == NULL || outpcmdata == NULL) {
+		return -1;
+	}
 
-		ret = nv_opus_decode(&jni_input_data[inoff], inlen, (jshort*)jni_pcm_data, SamplesPerChannel);
+	// Java hands the offsets straight through; nothing out of range may
+	// reach the array accesses
+	if ((*env)->GetArrayLength(env, outpcmdata) <
+			nv_opus_get_samples_per_channel(Decoder) * nv_opus_get_channel_count(Decoder) * 2) {
+		return -1;
+	}
+	if (indata != NULL && (inoff < 0 || inlen < 0 || inlen > NV_AUDIO_JITTER_MAX_PACKET ||
+			inoff > (*env)->GetArrayLength(env, indata) - inlen)) {
+		return -1;
+	}
 
-		// The input data isn't changed so it can be safely aborted
-		(*env)->ReleaseByteArrayElements(env, indata, jni_input_data, JNI_ABORT);
+	if (indata != NULL) {
+		(*env)->GetByteArrayRegion(env, indata, inoff, inlen, (jbyte*)InputPacket);
+		ret = decode_next(InputPacket, inlen, DecodePcm);
 	}
 	else {
-		ret = nv_opus_decode(NULL, 0, (jshort*)jni_pcm_data, SamplesPerChannel);
+		ret = decode_next(NULL, 0, DecodePcm);
+	}
+	if (ret <= 0) {
+		return ret;
 	}
 
 	// Convert samples (2 bytes) per channel to total bytes returned
-	if (ret > 0) {
-		ret *= ChannelCount * 2;
+	bytes = ret * nv_opus_get_channel_count(Decoder) * 2;
+	if (!write_to_sink(DecodePcm, ret)) {
+		(*env)->SetByteArrayRegion(env, outpcmdata, 0, bytes, (const jbyte*)DecodePcm);
 	}
+	return bytes;
+}
 
-	(*env)->ReleaseByteArrayElements(env, outpcmdata, jni_pcm_data, 0);
+// the sink must already be out of Sink, so no decode can reach it
+static void destroy_sink(nv_audio_sink* sink) {
+	nv_audio_sink_stats stats;
 
-	return ret;
+	if (sink != NULL) {
+		nv_audio_sink_get_stats(sink, &stats);
+		__android_log_print(ANDROID_LOG_INFO, "nv_opus_dec",
+			"audio sink: %u callbacks, %u underruns (%u frames), %u overruns (%u frames), level %i of %i, ratio %+i ppm",
+			stats.callbacks, stats.underruns, stats.underrun_frames, stats.overruns, stats.overrun_frames,
+			stats.level, stats.target_level, stats.ratio_ppm);
+		nv_audio_sink_destroy(sink);
+	}
+}
+
+static nv_audio_sink* swap_sink(nv_audio_sink* sink) {
+	nv_audio_sink* old;
+
+	pthread_mutex_lock(&SinkLock);
+	old = Sink;
+	Sink = sink;
+	pthread_mutex_unlock(&SinkLock);
+	return old;
+}
+
+static nv_audio_backend* create_backend(void) {
+#ifdef __ANDROID__
+	return nv_audio_backend_opensles_create();
+#else
+	// off the device the frames are paced by the clock and dropped
+	return nv_audio_backend_null_create(NULL, 1.0);
+#endif
+}
+
+// Starts playing decoded frames from a native audio callback. Returns
+// false if the output couldn't be opened, and the caller plays the
+// frames it is handed itself.
+JNIEXPORT jboolean JNICALL
+Java_com_limelight_binding_audio_NativeAudioSink_start(JNIEnv *env, jclass clazz, jint sampleRate,
+													   jint channelCount, jint framesPerBuffer,
+													   jint targetLatencyMs) {
+	nv_audio_sink* sink;
+
+	sink = nv_audio_sink_create(create_backend(), sampleRate, channelCount,
+								framesPerBuffer, targetLatencyMs);
+	if (sink != NULL && nv_audio_sink_start(sink) != 0) {
+		nv_audio_sink_destroy(sink);
+		sink = NULL;
+	}
+
+	destroy_sink(swap_sink(sink));
+
+	return sink != NULL ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_limelight_binding_audio_NativeAudioSink_stop(JNIEnv *env, jclass clazz) {
+	destroy_sink(swap_sink(NULL));
+}
+
+// callbacks, underruns, underrun frames, overruns, overrun frames,
+// level, target level and ratio in ppm, as far as stats is long
+JNIEXPORT void JNICALL
+Java_com_limelight_binding_audio_NativeAudioSink_getStats(JNIEnv *env, jclass clazz, jintArray stats) {
+	nv_audio_sink_stats current;
+	jint values[8];
+	jsize count;
+
+	pthread_mutex_lock(&SinkLock);
+	if (Sink == NULL) {
+		pthread_mutex_unlock(&SinkLock);
+		return;
+	}
+	nv_audio_sink_get_stats(Sink, &current);
+	pthread_mutex_unlock(&SinkLock);
+
+	values[0] = current.callbacks;
+	values[1] = current.underruns;
+	values[2] = current.underrun_frames;
+	values[3] = current.overruns;
+	values[4] = current.overrun_frames;
+	values[5] = current.level;
+	values[6] = current.target_level;
+	values[7] = current.ratio_ppm;
+
+	count = (*env)->GetArrayLength(env, stats);
+	(*env)->SetIntArrayRegion(env, stats, 0, count < 8 ? count : 8, values);
 }
@@ -0,0 +1,128 @@
+#include <stdlib.h>
+#include <string.h>
+#include "nv_pcm_ring.h"
+
+// The positions count frames and only ever grow, wrapping around with
+// unsigned arithmetic. Each is stored by one side only: the release
+// store publishes the frames, the other side's acquire load sees them.
+struct nv_pcm_ring {
+	short* samples;
+	int channels;
+	unsigned int capacity;
+	unsigned int mask;
+	unsigned int writePos;
+	char pad[64];			// keep the two positions off one cache line
+	unsigned int readPos;
+};
+
+nv_pcm_ring* nv_pcm_ring_create(int channels, int capacityFrames) {
+	nv_pcm_ring* ring;
+	unsigned int capacity = 1;
+
+	if (channels <= 0 || capacityFrames <= 0) {
+		return NULL;
+	}
+	while (capacity < (unsigned int)capacityFrames) {
+		capacity <<= 1;
+	}
+
+	ring = (nv_pcm_ring*)calloc(1, sizeof(*ring));
+	if (ring == NULL) {
+		return NULL;
+	}
+	ring->samples = (short*)calloc(capacity * channels, sizeof(short));
+	if (ring->samples == NULL) {
+		free(ring);
+		return NULL;
+	}
+	ring->channels = channels;
+	ring->capacity = capacity;
+	ring->mask = capacity - 1;
+	return ring;
+}
+
+void nv_pcm_ring_destroy(nv_pcm_ring* ring) {
+	if (ring == NULL) {
+		return;
+	}
+	free(ring->samples);
+	free(ring);
+}
+
+int nv_pcm_ring_get_capacity(const nv_pcm_ring* ring) {
+	return (int)ring->capacity;
+}
+
+int nv_pcm_ring_get_level(const nv_pcm_ring* ring) {
+	const unsigned int writePos = __atomic_load_n(&ring->writePos, __ATOMIC_ACQUIRE);
+	const unsigned int readPos = __atomic_load_n(&ring->readPos, __ATOMIC_ACQUIRE);
+	return (int)(writePos - readPos);
+}
+
+int nv_pcm_ring_write(nv_pcm_ring* ring, const short* pcm, int frames) {
+	const unsigned int writePos = ring->writePos;
+	const unsigned int readPos = __atomic_load_n(&ring->readPos, __ATOMIC_ACQUIRE);
+	const unsigned int space = ring->capacity - (writePos - readPos);
+	unsigned int start;
+	unsigned int first;
+
+	if (frames <= 0) {
+		return 0;
+	}
+	if ((unsigned int)frames > space) {
+		frames = (int)space;
+	}
+
+	// at most two pieces, the second one from the start of the buffer
+	start = writePos & ring->mask;
+	first = ring->capacity - start;
+	if (first > (unsigned int)frames) {
+		first = frames;
+	}
+	memcpy(ring->samples + start * ring->channels, pcm, first * ring->channels * sizeof(short));
+	memcpy(ring->samples, pcm + first * ring->channels, (frames - first) * ring->channels * sizeof(short));
+
+	__atomic_store_n(&ring->writePos, writePos + frames, __ATOMIC_RELEASE);
+	return frames;
+}
+
+int nv_pcm_ring_read(nv_pcm_ring* ring, short* pcm, int frames) {
+	const unsigned int readPos = ring->readPos;
+	const unsigned int writePos = __atomic_load_n(&ring->writePos, __ATOMIC_ACQUIRE);
+	const unsigned int level = writePos - readPos;
+	unsigned int start;
+	unsigned int first;
+
+	if (frames <= 0) {
+		return 0;
+	}
+	if ((unsigned int)frames > level) {
+		frames = (int)level;
+	}
+
+	start = readPos & ring->mask;
+	first = ring->capacity - start;
+	if (first > (unsigned int)frames) {
+		first = frames;
+	}
+	memcpy(pcm, ring->samples + start * ring->channels, first * ring->channels * sizeof(short));
+	memcpy(pcm + first * ring->channels, ring->samples, (frames - first) * ring->channels * sizeof(short));
+
+	__atomic_store_n(&ring->readPos, readPos + frames, __ATOMIC_RELEASE);
+	return frames;
+}
+
+int nv_pcm_ring_skip(nv_pcm_ring* ring, int frames) {
+	const unsigned int readPos = ring->readPos;
+	const unsigned int writePos = __atomic_load_n(&ring->writePos, __ATOMIC_ACQUIRE);
+	const unsigned int level = writePos - readPos;
+
+	if (frames <= 0) {
+		return 0;
+	}
+	if ((unsigned int)frames > level) {
+		frames = (int)level;
+	}
+	__atomic_store_n(&ring->readPos, readPos + frames, __ATOMIC_RELEASE);
+	return frames;
+}
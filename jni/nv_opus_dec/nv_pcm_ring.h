@@ -0,0 +1,34 @@
+// Single producer, single consumer ring of interleaved 16 bit PCM. The
+// producer only writes and the consumer only reads and skips; neither
+// takes a lock, so the consumer can be an audio callback.
+#ifndef NV_PCM_RING_H
+#define NV_PCM_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct nv_pcm_ring nv_pcm_ring;
+
+// the capacity is rounded up to a power of two frames
+nv_pcm_ring* nv_pcm_ring_create(int channels, int capacityFrames);
+void nv_pcm_ring_destroy(nv_pcm_ring* ring);
+
+int nv_pcm_ring_get_capacity(const nv_pcm_ring* ring);
+
+// producer: returns the number of frames written, fewer if it filled up
+int nv_pcm_ring_write(nv_pcm_ring* ring, const short* pcm, int frames);
+
+// consumer: returns the number of frames read or skipped, fewer if it ran dry
+int nv_pcm_ring_read(nv_pcm_ring* ring, short* pcm, int frames);
+int nv_pcm_ring_skip(nv_pcm_ring* ring, int frames);
+
+// frames waiting to be read; exact on the consumer side, a lower bound
+// of what can be written on the producer side
+int nv_pcm_ring_get_level(const nv_pcm_ring* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
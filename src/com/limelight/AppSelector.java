@@ -242,83 +242,39 @@ public class AppSelector {
         return runningAppId;
     }
 
+    public static File posterFileFor(NvApp app) {
+        return new File(Environment.getExternalStoragePublicDirectory(Environment.DIRECTORY_PICTURES), "StreamTheater/" + app.getAppName() + ".png");
+    }
+
+    // The native side keeps the last list of every host and works out
+    // what changed, so the whole list goes over every time.
+    public static void sendAppList(MainActivity activity, String uuid, List<NvApp> apps) {
+        String[] names = new String[apps.size()];
+        String[] posterFileNames = new String[apps.size()];
+        int[] ids = new int[apps.size()];
+        boolean[] running = new boolean[apps.size()];
+        for (int i = 0; i < apps.size(); i++) {
+            NvApp app = apps.get(i);
+            names[i] = app.getAppName();
+            posterFileNames[i] = posterFileFor(app).getAbsolutePath();
+            ids[i] = app.getAppId();
+            running[i] = app.getIsRunning();
+        }
+        MainActivity.nativeAppList(activity.getAppPtr(), uuid, names, posterFileNames, ids, running);
+    }
+
     private void updateAppList(final List<NvApp> newAppList) {
-		boolean updated = false;
 		appList = newAppList;
-		// First handle app updates and additions
 		for (NvApp app : appList) {
-		    boolean foundExistingApp = false;
-		
-		    // Try to update an existing app in the list first
-		    for (int i = 0; i < appList.size(); i++) {
-		        NvApp existingApp = appList.get(i);
-		        if (existingApp.getAppId() == app.getAppId()) {
-		            // Found the app; update its properties
-		            if (existingApp.getIsRunning() != app.getIsRunning()) {
-		                existingApp.setIsRunning(app.getIsRunning());
-		                updated = true;
-		            }
-		            if (!existingApp.getAppName().equals(app.getAppName())) {
-		                existingApp.setAppName(app.getAppName());
-		                updated = true;
-		            }
-		
-		            foundExistingApp = true;
-		            break;
-		        }
-		    }
-		
-		    if (!foundExistingApp) {
-		        // This app must be new
-		    	appList.add(app);
-		        updated = true;
-		    }
-		    String fileName;		    
-		    File posterFile;
-		    posterFile = new File(Environment.getExternalStoragePublicDirectory(Environment.DIRECTORY_PICTURES), "StreamTheater/" + app.getAppName() + ".png");
-		    fileName = posterFile.getAbsolutePath();
-		    LimeLog.info("Trying to load " + fileName );
+		    File posterFile = posterFileFor(app);
+		    LimeLog.info("Trying to load " + posterFile.getAbsolutePath() );
 		    if(!posterFile.exists())
 		    {
 		    	LimeLog.info("Not found, creating!");
-		    	activity.createVideoThumbnail(computer.uuid.toString(), app.getAppId(), fileName, 228, 344);
+		    	activity.createVideoThumbnail(computer.uuid.toString(), app.getAppId(), posterFile.getAbsolutePath(), 228, 344);
 		    }
-		    
-		    MainActivity.nativeAddApp(activity.getAppPtr(), app.getAppName(), fileName, app.getAppId(), app.getIsRunning());
-		}
-		
-		// Next handle app removals
-		int i = 0;
-		while (i < appList.size()) {
-		    boolean foundExistingApp = false;
-		    NvApp existingApp = appList.get(i);
-		
-		    // Check if this app is in the latest list
-		    for (NvApp app : appList) {
-		        if (existingApp.getAppId() == app.getAppId()) {
-		            foundExistingApp = true;
-		            break;
-		        }
-		    }
-		
-		    // This app was removed in the latest app list
-		    if (!foundExistingApp) {
-		    	appList.remove(existingApp);
-		    	MainActivity.nativeRemoveApp(activity.getAppPtr(), existingApp.getAppId());
-		        updated = true;
-		
-		        // Check this same index again because the item at i+1 is now at i after
-		        // the removal
-		        continue;
-		    }
-		
-		    // Move on to the next item
-		    i++;
-		}
-		
-		if (updated) {
-		    
 		}
+		sendAppList(activity, uuidString, appList);
     }
     
     public void closeApp(int appID)
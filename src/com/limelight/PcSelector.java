@@ -4,11 +4,17 @@ import com.vrmatter.streamtheater.R;
 import com.vrmatter.streamtheater.MainActivity;
 
 import java.io.FileNotFoundException;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.io.StringReader;
 import java.net.InetAddress;
 import java.net.UnknownHostException;
 import java.util.ArrayList;
 import java.util.List;
 import java.util.UUID;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.ThreadFactory;
 
 import com.limelight.binding.PlatformBinding;
 import com.limelight.binding.crypto.AndroidCryptoProvider;
@@ -18,6 +24,7 @@ import com.limelight.nvstream.http.ComputerDetails;
 import com.limelight.nvstream.http.NvApp;
 import com.limelight.nvstream.http.NvHTTP;
 import com.limelight.nvstream.http.PairingManager;
+import com.limelight.utils.CacheHelper;
 import com.limelight.utils.ServerHelper;
 
 import android.app.Service;
@@ -25,6 +32,7 @@ import android.content.ComponentName;
 import android.content.Intent;
 import android.content.ServiceConnection;
 import android.os.IBinder;
+import android.os.Process;
 import android.preference.PreferenceManager;
 
 public class PcSelector {
@@ -33,6 +41,18 @@ public class PcSelector {
 
     private ComputerManagerService.ComputerManagerBinder managerBinder;
     private boolean freezeUpdates, runningPolling;
+    // one background thread for all the app list prefetches, they queue on it
+    private final ExecutorService prefetchExecutor = Executors.newSingleThreadExecutor(new ThreadFactory() {
+        public Thread newThread(final Runnable r) {
+            return new Thread("App list prefetch") {
+                @Override
+                public void run() {
+                    Process.setThreadPriority(Process.THREAD_PRIORITY_BACKGROUND);
+                    r.run();
+                }
+            };
+        }
+    });
     private final ServiceConnection serviceConnection = new ServiceConnection() {
         public void onServiceConnected(ComponentName className, IBinder binder) {
             final ComputerManagerService.ComputerManagerBinder localBinder =
@@ -173,6 +193,42 @@ public class PcSelector {
         return RS_UNKNOWN;
     }
 
+    // Fetches a host's app list for the native cache while the PC list is
+    // up.  The native side asks for one at a time, they run on
+    // prefetchExecutor.
+    public void prefetchAppList(final String compUUID)
+    {
+        final ComputerDetails computer = findByUUID(compUUID);
+        if (computer == null || managerBinder == null || computer.state != ComputerDetails.State.ONLINE) {
+            MainActivity.nativeAppList(activity.getAppPtr(), compUUID, null, null, null, null);
+            return;
+        }
+
+        prefetchExecutor.execute(new Runnable() {
+            public void run() {
+                try {
+                    NvHTTP http = new NvHTTP(ServerHelper.getCurrentAddressFromComputer(computer),
+                            managerBinder.getUniqueId(), null, PlatformBinding.getCryptoProvider(activity));
+                    String rawAppList = http.getAppListRaw();
+                    List<NvApp> list = NvHTTP.getAppListByReader(new StringReader(rawAppList));
+
+                    // the same cache the app list poller fills
+                    OutputStream cacheOut = CacheHelper.openCacheFileForOutput(activity.getCacheDir(), "applist", compUUID);
+                    try {
+                        CacheHelper.writeStringToOutputStream(cacheOut, rawAppList);
+                    } finally {
+                        cacheOut.close();
+                    }
+
+                    AppSelector.sendAppList(activity, compUUID, list);
+                } catch (Exception e) {
+                    LimeLog.warning("App list prefetch failed for " + compUUID + ": " + e);
+                    MainActivity.nativeAppList(activity.getAppPtr(), compUUID, null, null, null, null);
+                }
+            }
+        });
+    }
+
     public void pairWithUUID(final String compUUID)
     {
 		doPair(findByUUID(compUUID));
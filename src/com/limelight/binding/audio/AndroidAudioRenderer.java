@@ -9,7 +9,11 @@ import com.limelight.nvstream.av.audio.AudioRenderer;
 
 public class AndroidAudioRenderer implements AudioRenderer {
 
+    // Frames buffered ahead of the native audio callback
+    private static final int TARGET_LATENCY_MS = 30;
+
     private AudioTrack track;
+    private boolean nativeSink;
 
     @Override
     public boolean streamInitialized(int channelCount, int channelMask, int samplesPerFrame, int sampleRate) {
@@ -36,6 +40,15 @@ public class AndroidAudioRenderer implements AudioRenderer {
             return false;
         }
 
+        // The native sink takes the frames from the decoder directly. If it
+        // can't open the output, fall back to an AudioTrack.
+        if (NativeAudioSink.start(sampleRate, channelCount, samplesPerFrame / channelCount, TARGET_LATENCY_MS)) {
+            nativeSink = true;
+            LimeLog.info("Audio playing through the native sink");
+            return true;
+        }
+        LimeLog.warning("Native audio sink unavailable, using an AudioTrack");
+
         // We're not supposed to request less than the minimum
         // buffer size for our buffer, but it appears that we can
         // do this on many devices and it lowers audio latency.
@@ -85,11 +98,24 @@ public class AndroidAudioRenderer implements AudioRenderer {
 
     @Override
     public void playDecodedAudio(byte[] audioData, int offset, int length) {
+        // The native sink already has this frame
+        if (nativeSink) {
+            return;
+        }
         track.write(audioData, offset, length);
     }
 
     @Override
     public void streamClosing() {
+        if (nativeSink) {
+            int[] stats = new int[NativeAudioSink.STAT_COUNT];
+            NativeAudioSink.getStats(stats);
+            NativeAudioSink.stop();
+            nativeSink = false;
+            LimeLog.info("Audio sink: "+stats[NativeAudioSink.STAT_UNDERRUNS]+" underruns, "+
+                    stats[NativeAudioSink.STAT_OVERRUNS]+" overruns, drift "+
+                    stats[NativeAudioSink.STAT_RATIO_PPM]+" ppm");
+        }
         if (track != null) {
             track.release();
         }
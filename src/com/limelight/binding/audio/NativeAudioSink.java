@@ -0,0 +1,25 @@
+package com.limelight.binding.audio;
+
+// Plays the decoded audio from a native OpenSL ES callback. Once started,
+// the Opus decoder's JNI glue hands each frame straight to it, so nothing
+// has to be written to an AudioTrack.
+public class NativeAudioSink {
+    static {
+        System.loadLibrary("nv_opus_dec");
+    }
+
+    public static final int STAT_CALLBACKS = 0;
+    public static final int STAT_UNDERRUNS = 1;
+    public static final int STAT_UNDERRUN_FRAMES = 2;
+    public static final int STAT_OVERRUNS = 3;
+    public static final int STAT_OVERRUN_FRAMES = 4;
+    public static final int STAT_LEVEL = 5;
+    public static final int STAT_TARGET_LEVEL = 6;
+    public static final int STAT_RATIO_PPM = 7;
+    public static final int STAT_COUNT = 8;
+
+    // Returns false if the output couldn't be opened
+    public static native boolean start(int sampleRate, int channelCount, int framesPerBuffer, int targetLatencyMs);
+    public static native void stop();
+    public static native void getStats(int[] stats);
+}
@@ -63,6 +63,8 @@ public class MainActivity extends VrActivity implements SurfaceHolder.Callback,
 	public static native void nativeRemovePc(long appPtr, String name );
 	public static native void nativeAddApp(long appPtr, String name, String posterFileName, int id, boolean isRunning );
 	public static native void nativeRemoveApp(long appPtr, int id );
+	// a host's whole app list, null arrays when fetching it failed
+	public static native void nativeAppList(long appPtr, String uuid, String[] names, String[] posterFileNames, int[] ids, boolean[] running );
 	public static native void nativeShowPair(long appPtr, String message );
 	public static native void nativePairSuccess(long appPtr );
 	public static native void nativeShowError(long appPtr, String message );
@@ -507,6 +509,16 @@ public class MainActivity extends VrActivity implements SurfaceHolder.Callback,
 		return pcSelector.addPCbyIP(IP);
 	}
 	
+	public void prefetchAppList(final String computerUUID)
+	{
+		if(pcSelector == null)
+		{
+			nativeAppList(getAppPtr(), computerUUID, null, null, null, null);
+			return;
+		}
+		pcSelector.prefetchAppList(computerUUID);
+	}
+	
 	public void startPcUpdates()
 	{
 		pcSelector.startComputerUpdates();
@@ -560,11 +572,6 @@ public class MainActivity extends VrActivity implements SurfaceHolder.Callback,
 		return 0;
 	}
 	
-	public long currentTimeStamp()
-	{
-		return System.nanoTime() / 1000;
-	}
-	
 	public void closeApp(final String compUUID, int appID)
 	{
 		try 